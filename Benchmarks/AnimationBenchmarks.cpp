@@ -0,0 +1,79 @@
+#include "Benchmark.h"
+#include "Datasets.h"
+#include "../Engine/JobSystem.h"
+
+// Skeletal animation over deep skeletons. The argument is the bone count;
+// bones form chains of CHAIN_LENGTH, so hierarchy depth grows with it.
+
+namespace
+{
+    const int CHAIN_LENGTH = 64;
+    const int KEY_COUNT = 240;
+    const float DURATION = 10.0f;
+
+    // Sample times spread over the clip so the key search sees every position
+    float SampleTime(int frame)
+    {
+        return static_cast<float>(frame % 600) * (1.0f / 60.0f);
+    }
+
+    BenchmarkRegistration s_evaluate("Animation/Evaluate", { 64, 512, 4096 }, [](BenchmarkContext& context)
+    {
+        std::vector<Bone> skeleton = Datasets::CreateSkeleton(static_cast<int>(context.GetArgument()), CHAIN_LENGTH);
+        Animation animation;
+        Datasets::CreateAnimation(skeleton, KEY_COUNT, DURATION, animation);
+
+        std::vector<XMMATRIX> boneTransforms;
+        int frame = 0;
+
+        context.Measure([&]()
+        {
+            animation.EvaluateAnimation(SampleTime(frame++), skeleton, boneTransforms);
+            DoNotOptimize(boneTransforms.data());
+        });
+
+        context.SetItemsPerIteration(skeleton.size());
+    });
+
+    BenchmarkRegistration s_evaluateParallel("Animation/EvaluateParallel", { 64, 512, 4096 }, [](BenchmarkContext& context)
+    {
+        std::vector<Bone> skeleton = Datasets::CreateSkeleton(static_cast<int>(context.GetArgument()), CHAIN_LENGTH);
+        Animation animation;
+        Datasets::CreateAnimation(skeleton, KEY_COUNT, DURATION, animation);
+
+        JobSystem jobSystem;
+        jobSystem.Initialize();
+        ParallelForFunction parallelFor = jobSystem.GetParallelForFunction(32);
+
+        std::vector<XMMATRIX> boneTransforms;
+        int frame = 0;
+
+        context.Measure([&]()
+        {
+            animation.EvaluateAnimation(SampleTime(frame++), skeleton, boneTransforms, parallelFor);
+            DoNotOptimize(boneTransforms.data());
+        });
+
+        context.SetItemsPerIteration(skeleton.size());
+        context.SetCounter("workers", jobSystem.GetWorkerCount());
+        jobSystem.Shutdown();
+    });
+
+    // Hierarchy composition; the argument is the depth of a single chain
+    BenchmarkRegistration s_hierarchy("Animation/SkeletonHierarchy", { 64, 512, 4096 }, [](BenchmarkContext& context)
+    {
+        int boneCount = static_cast<int>(context.GetArgument());
+        Skeleton skeleton;
+        skeleton.Initialize(Datasets::CreateSkeleton(boneCount, boneCount));
+
+        std::vector<XMMATRIX> boneTransforms;
+
+        context.Measure([&]()
+        {
+            skeleton.CalculateBoneTransforms(boneTransforms);
+            DoNotOptimize(boneTransforms.data());
+        });
+
+        context.SetItemsPerIteration(static_cast<uint64_t>(boneCount));
+    });
+}
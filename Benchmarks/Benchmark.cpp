@@ -0,0 +1,354 @@
+#include "Benchmark.h"
+#include <iostream>
+#include <fstream>
+#include <sstream>
+#include <iomanip>
+#include <algorithm>
+#include <chrono>
+
+namespace
+{
+    std::vector<BenchmarkDefinition>& GetDefinitions()
+    {
+        // Function-local so registration from any translation unit's statics is safe
+        static std::vector<BenchmarkDefinition> definitions;
+        return definitions;
+    }
+
+    double ElapsedNs(std::chrono::steady_clock::time_point start, std::chrono::steady_clock::time_point end)
+    {
+        return std::chrono::duration<double, std::nano>(end - start).count();
+    }
+
+    std::string FormatTime(double nanoseconds)
+    {
+        std::ostringstream stream;
+        stream << std::fixed << std::setprecision(2);
+        if (nanoseconds >= 1e9)
+            stream << nanoseconds / 1e9 << " s";
+        else if (nanoseconds >= 1e6)
+            stream << nanoseconds / 1e6 << " ms";
+        else if (nanoseconds >= 1e3)
+            stream << nanoseconds / 1e3 << " us";
+        else
+            stream << nanoseconds << " ns";
+        return stream.str();
+    }
+
+    void WriteJsonString(std::ofstream& file, const std::string& text)
+    {
+        file << '"';
+        for (char c : text)
+        {
+            if (c == '"' || c == '\\')
+            {
+                file << '\\';
+            }
+            file << c;
+        }
+        file << '"';
+    }
+
+    // Counters are written as a single CSV field: name=value;name=value
+    std::string FormatCounters(const std::map<std::string, double>& counters)
+    {
+        std::ostringstream stream;
+        stream << std::setprecision(10);
+        bool first = true;
+        for (const auto& counter : counters)
+        {
+            stream << (first ? "" : ";") << counter.first << "=" << counter.second;
+            first = false;
+        }
+        return stream.str();
+    }
+}
+
+std::string BenchmarkResult::GetKey() const
+{
+    return name + "/" + std::to_string(argument);
+}
+
+BenchmarkContext::BenchmarkContext(int64_t argument, const BenchmarkSettings& settings)
+    : m_argument(argument)
+    , m_settings(settings)
+    , m_itemsPerIteration(0)
+    , m_iterations(0)
+{
+}
+
+void BenchmarkContext::Measure(const std::function<void()>& body)
+{
+    // Warm-up, also used to size the batches
+    auto start = std::chrono::steady_clock::now();
+    body();
+    double firstCallNs = std::max(ElapsedNs(start, std::chrono::steady_clock::now()), 1.0);
+
+    uint64_t batch = static_cast<uint64_t>(m_settings.minSampleSeconds * 1e9 / firstCallNs) + 1;
+
+    m_sampleNs.clear();
+    for (int sample = 0; sample < m_settings.samples; ++sample)
+    {
+        // Grow the batch until the sample is long enough; the warm-up estimate
+        // is often pessimistic because of cold caches
+        while (true)
+        {
+            start = std::chrono::steady_clock::now();
+            for (uint64_t i = 0; i < batch; ++i)
+            {
+                body();
+            }
+            double elapsedNs = ElapsedNs(start, std::chrono::steady_clock::now());
+            m_iterations += batch;
+
+            if (elapsedNs >= m_settings.minSampleSeconds * 1e9 * 0.5 || batch >= (1ull << 40))
+            {
+                m_sampleNs.push_back(elapsedNs / static_cast<double>(batch));
+                break;
+            }
+
+            batch *= 2;
+        }
+    }
+}
+
+void BenchmarkContext::Measure(const std::function<void()>& setup, const std::function<void()>& body)
+{
+    setup();
+    body();
+
+    m_sampleNs.clear();
+    for (int sample = 0; sample < m_settings.samples; ++sample)
+    {
+        // Average over as many individually timed calls as fit in the sample
+        double totalNs = 0.0;
+        uint64_t calls = 0;
+        do
+        {
+            setup();
+            auto start = std::chrono::steady_clock::now();
+            body();
+            totalNs += ElapsedNs(start, std::chrono::steady_clock::now());
+            calls++;
+        }
+        while (totalNs < m_settings.minSampleSeconds * 1e9);
+
+        m_iterations += calls;
+        m_sampleNs.push_back(totalNs / static_cast<double>(calls));
+    }
+}
+
+BenchmarkResult BenchmarkContext::GetResult(const std::string& name) const
+{
+    BenchmarkResult result;
+    result.name = name;
+    result.argument = m_argument;
+    result.iterations = m_iterations;
+    result.counters = m_counters;
+
+    if (m_sampleNs.empty())
+    {
+        return result;
+    }
+
+    std::vector<double> sorted = m_sampleNs;
+    std::sort(sorted.begin(), sorted.end());
+
+    double sum = 0.0;
+    for (double value : sorted)
+    {
+        sum += value;
+    }
+
+    size_t middle = sorted.size() / 2;
+    result.minNs = sorted.front();
+    result.maxNs = sorted.back();
+    result.meanNs = sum / static_cast<double>(sorted.size());
+    result.medianNs = sorted.size() % 2 ? sorted[middle] : 0.5 * (sorted[middle - 1] + sorted[middle]);
+
+    if (m_itemsPerIteration > 0 && result.medianNs > 0.0)
+    {
+        result.itemsPerSecond = static_cast<double>(m_itemsPerIteration) * 1e9 / result.medianNs;
+    }
+
+    return result;
+}
+
+namespace BenchmarkRegistry
+{
+    void Register(const std::string& name, const std::vector<int64_t>& arguments, BenchmarkFunction function)
+    {
+        BenchmarkDefinition definition;
+        definition.name = name;
+        definition.arguments = arguments.empty() ? std::vector<int64_t>(1, 0) : arguments;
+        definition.function = function;
+        GetDefinitions().push_back(definition);
+    }
+
+    const std::vector<BenchmarkDefinition>& GetBenchmarks()
+    {
+        return GetDefinitions();
+    }
+}
+
+namespace BenchmarkReport
+{
+    bool WriteJSON(const std::string& filepath, const std::vector<BenchmarkResult>& results,
+                   const std::map<std::string, std::string>& metadata)
+    {
+        std::ofstream file(filepath);
+        if (!file.is_open())
+        {
+            std::cerr << "BenchmarkReport: Failed to open " << filepath << std::endl;
+            return false;
+        }
+
+        file << std::setprecision(10);
+        file << "{\n  \"context\": {";
+        bool first = true;
+        for (const auto& entry : metadata)
+        {
+            file << (first ? "\n    " : ",\n    ");
+            WriteJsonString(file, entry.first);
+            file << ": ";
+            WriteJsonString(file, entry.second);
+            first = false;
+        }
+        file << "\n  },\n  \"benchmarks\": [";
+
+        for (size_t i = 0; i < results.size(); ++i)
+        {
+            const BenchmarkResult& result = results[i];
+            file << (i > 0 ? ",\n" : "\n");
+            file << "    {\n";
+            file << "      \"name\": ";
+            WriteJsonString(file, result.name);
+            file << ",\n";
+            file << "      \"argument\": " << result.argument << ",\n";
+            file << "      \"iterations\": " << result.iterations << ",\n";
+            file << "      \"min_ns\": " << result.minNs << ",\n";
+            file << "      \"median_ns\": " << result.medianNs << ",\n";
+            file << "      \"mean_ns\": " << result.meanNs << ",\n";
+            file << "      \"max_ns\": " << result.maxNs << ",\n";
+            file << "      \"items_per_second\": " << result.itemsPerSecond << ",\n";
+            file << "      \"counters\": {";
+
+            bool firstCounter = true;
+            for (const auto& counter : result.counters)
+            {
+                file << (firstCounter ? " " : ", ");
+                WriteJsonString(file, counter.first);
+                file << ": " << counter.second;
+                firstCounter = false;
+            }
+            file << (result.counters.empty() ? "}\n" : " }\n");
+            file << "    }";
+        }
+        file << "\n  ]\n}\n";
+
+        return file.good();
+    }
+
+    bool WriteCSV(const std::string& filepath, const std::vector<BenchmarkResult>& results)
+    {
+        std::ofstream file(filepath);
+        if (!file.is_open())
+        {
+            std::cerr << "BenchmarkReport: Failed to open " << filepath << std::endl;
+            return false;
+        }
+
+        file << std::setprecision(10);
+        file << "name,argument,iterations,min_ns,median_ns,mean_ns,max_ns,items_per_second,counters\n";
+        for (const BenchmarkResult& result : results)
+        {
+            file << result.name << "," << result.argument << "," << result.iterations << ","
+                 << result.minNs << "," << result.medianNs << "," << result.meanNs << "," << result.maxNs << ","
+                 << result.itemsPerSecond << "," << FormatCounters(result.counters) << "\n";
+        }
+
+        return file.good();
+    }
+
+    bool ReadCSV(const std::string& filepath, std::vector<BenchmarkResult>& results)
+    {
+        std::ifstream file(filepath);
+        if (!file.is_open())
+        {
+            std::cerr << "BenchmarkReport: Failed to open " << filepath << std::endl;
+            return false;
+        }
+
+        results.clear();
+
+        std::string line;
+        std::getline(file, line); // Header
+        while (std::getline(file, line))
+        {
+            std::vector<std::string> fields;
+            std::istringstream stream(line);
+            std::string field;
+            while (std::getline(stream, field, ','))
+            {
+                fields.push_back(field);
+            }
+
+            if (fields.size() < 8)
+                continue;
+
+            BenchmarkResult result;
+            result.name = fields[0];
+            result.argument = std::stoll(fields[1]);
+            result.iterations = std::stoull(fields[2]);
+            result.minNs = std::stod(fields[3]);
+            result.medianNs = std::stod(fields[4]);
+            result.meanNs = std::stod(fields[5]);
+            result.maxNs = std::stod(fields[6]);
+            result.itemsPerSecond = std::stod(fields[7]);
+
+            if (fields.size() > 8)
+            {
+                std::istringstream counters(fields[8]);
+                std::string counter;
+                while (std::getline(counters, counter, ';'))
+                {
+                    size_t separator = counter.find('=');
+                    if (separator != std::string::npos)
+                    {
+                        result.counters[counter.substr(0, separator)] = std::stod(counter.substr(separator + 1));
+                    }
+                }
+            }
+
+            results.push_back(result);
+        }
+
+        return true;
+    }
+
+    void PrintResult(const BenchmarkResult& result, const BenchmarkResult* baseline)
+    {
+        std::ostringstream line;
+        line << std::left << std::setw(48) << result.GetKey()
+             << std::right << std::setw(12) << FormatTime(result.medianNs)
+             << "  (min " << FormatTime(result.minNs) << ")";
+
+        if (result.itemsPerSecond > 0.0)
+        {
+            line << "  " << std::fixed << std::setprecision(2) << result.itemsPerSecond / 1e6 << " M items/s";
+        }
+
+        if (baseline && baseline->medianNs > 0.0)
+        {
+            double change = (result.medianNs / baseline->medianNs - 1.0) * 100.0;
+            line << "  " << std::showpos << std::fixed << std::setprecision(1) << change << "%" << std::noshowpos;
+        }
+
+        for (const auto& counter : result.counters)
+        {
+            line << "  " << counter.first << "=" << std::defaultfloat << std::setprecision(6) << counter.second;
+        }
+
+        std::cout << line.str() << std::endl;
+    }
+}
@@ -0,0 +1,146 @@
+#pragma once
+
+#include <string>
+#include <vector>
+#include <map>
+#include <functional>
+#include <cstdint>
+
+#if defined(_MSC_VER)
+#include <intrin.h>
+#endif
+
+// Small self-contained benchmark harness for the CPU side of the engine.
+//
+// Benchmarks register themselves at static initialization with a list of
+// arguments (problem sizes); each argument is run as a separate case. The
+// benchmark function builds its dataset, then calls BenchmarkContext::Measure
+// with the code to time. Results go to the console and, for comparing
+// commits, to JSON and CSV files (see BenchmarkReport).
+
+struct BenchmarkSettings
+{
+    int samples;                 // Timed samples per case
+    double minSampleSeconds;     // Each sample repeats the body at least this long
+    int64_t maxArgument;         // Larger arguments are skipped (0 = no limit)
+
+    BenchmarkSettings()
+        : samples(10)
+        , minSampleSeconds(0.02)
+        , maxArgument(0)
+    {
+    }
+};
+
+struct BenchmarkResult
+{
+    std::string name;
+    int64_t argument;
+    uint64_t iterations;         // Timed calls of the body over all samples
+
+    // Time per call of the body, over the samples
+    double minNs;
+    double medianNs;
+    double meanNs;
+    double maxNs;
+
+    double itemsPerSecond;       // From the median; 0 unless items were set
+    std::map<std::string, double> counters;
+
+    BenchmarkResult()
+        : argument(0)
+        , iterations(0)
+        , minNs(0.0)
+        , medianNs(0.0)
+        , meanNs(0.0)
+        , maxNs(0.0)
+        , itemsPerSecond(0.0)
+    {
+    }
+
+    // "Name/argument", the key used to match results across runs
+    std::string GetKey() const;
+};
+
+class BenchmarkContext
+{
+public:
+    BenchmarkContext(int64_t argument, const BenchmarkSettings& settings);
+
+    int64_t GetArgument() const { return m_argument; }
+
+    // Work items per call of the body (triangles, nodes, jobs...)
+    void SetItemsPerIteration(uint64_t items) { m_itemsPerIteration = items; }
+
+    // Extra values reported with the result (sizes, hit rates, ...)
+    void SetCounter(const std::string& name, double value) { m_counters[name] = value; }
+
+    // Times body. After one untimed warm-up call, every sample repeats body
+    // until it has run for at least minSampleSeconds. With a setup function
+    // each call is timed on its own and setup runs untimed before it, for
+    // bodies that consume their input (builds, in-place processing).
+    void Measure(const std::function<void()>& body);
+    void Measure(const std::function<void()>& setup, const std::function<void()>& body);
+
+    bool HasMeasured() const { return m_iterations > 0; }
+    BenchmarkResult GetResult(const std::string& name) const;
+
+private:
+    int64_t m_argument;
+    BenchmarkSettings m_settings;
+    uint64_t m_itemsPerIteration;
+    uint64_t m_iterations;
+    std::vector<double> m_sampleNs;    // Per call
+    std::map<std::string, double> m_counters;
+};
+
+typedef std::function<void(BenchmarkContext& context)> BenchmarkFunction;
+
+struct BenchmarkDefinition
+{
+    std::string name;
+    std::vector<int64_t> arguments;
+    BenchmarkFunction function;
+};
+
+namespace BenchmarkRegistry
+{
+    void Register(const std::string& name, const std::vector<int64_t>& arguments, BenchmarkFunction function);
+    const std::vector<BenchmarkDefinition>& GetBenchmarks();
+}
+
+// Registers a benchmark from a namespace-scope static:
+//   static BenchmarkRegistration s_cullBoxes("Culling/FrustumBoxes", { 1000, 1000000 }, [](BenchmarkContext& context) { ... });
+struct BenchmarkRegistration
+{
+    BenchmarkRegistration(const std::string& name, const std::vector<int64_t>& arguments, BenchmarkFunction function)
+    {
+        BenchmarkRegistry::Register(name, arguments, function);
+    }
+};
+
+// Keeps the compiler from discarding a computed value
+template<typename T>
+inline void DoNotOptimize(const T& value)
+{
+#if defined(_MSC_VER)
+    static volatile const void* sink;
+    sink = &value;
+    _ReadWriteBarrier();
+#else
+    asm volatile("" : : "r,m"(value) : "memory");
+#endif
+}
+
+namespace BenchmarkReport
+{
+    // Machine-readable output. The CSV has one row per case and can be read
+    // back with ReadCSV to compare against another run.
+    bool WriteJSON(const std::string& filepath, const std::vector<BenchmarkResult>& results,
+                   const std::map<std::string, std::string>& metadata);
+    bool WriteCSV(const std::string& filepath, const std::vector<BenchmarkResult>& results);
+    bool ReadCSV(const std::string& filepath, std::vector<BenchmarkResult>& results);
+
+    // Console line for one result; with a baseline the median change is appended
+    void PrintResult(const BenchmarkResult& result, const BenchmarkResult* baseline);
+}
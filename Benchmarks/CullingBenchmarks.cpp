@@ -0,0 +1,268 @@
+#include "Benchmark.h"
+#include "Datasets.h"
+#include "../Graphics/FrustumCulling.h"
+#include "../Graphics/BoundingVolumeHierarchy.h"
+#include "../Graphics/OcclusionCulling.h"
+#include "../Engine/Camera.h"
+
+// Visibility: brute-force frustum culling, the BVH and the software occlusion
+// buffer. Boxes fill a cube around the camera, so roughly a sixth of them is
+// inside the frustum. The BVH is also measured for picking rays and overlap
+// queries, QUERIES_PER_ITERATION of them per iteration.
+
+namespace
+{
+    const float WORLD_HALF_SIZE = 500.0f;
+    const float FAR_PLANE = 1000.0f;
+    const uint32_t BOX_SEED = 1234;
+    const int QUERIES_PER_ITERATION = 256;
+
+    BenchmarkRegistration s_frustumBoxes("Culling/FrustumBoxes", { 1000, 100000, 1000000 }, [](BenchmarkContext& context)
+    {
+        CullingBoxes boxes;
+        Datasets::CreateCullingBoxes(static_cast<size_t>(context.GetArgument()), WORLD_HALF_SIZE, BOX_SEED, boxes);
+        Frustum frustum = Frustum::FromViewProjection(Datasets::CreateViewProjection(FAR_PLANE));
+
+        std::vector<uint32_t> visible;
+        visible.reserve(boxes.Size());
+
+        context.Measure([&]()
+        {
+            visible.clear();
+            FrustumCulling::CullBoxes(frustum, boxes, visible);
+            DoNotOptimize(visible.data());
+        });
+
+        context.SetItemsPerIteration(boxes.Size());
+        context.SetCounter("visible", static_cast<double>(visible.size()));
+    });
+
+    void CreateProxies(size_t count, BoundingVolumeHierarchy& bvh, std::vector<XMFLOAT3>& mins, std::vector<XMFLOAT3>& maxs)
+    {
+        Datasets::CreateBoxes(count, WORLD_HALF_SIZE, 0.5f, 2.0f, BOX_SEED, mins, maxs);
+        for (size_t i = 0; i < count; ++i)
+        {
+            bvh.CreateProxy(mins[i], maxs[i], nullptr);
+        }
+    }
+
+    BenchmarkRegistration s_bvhBuild("Culling/BVHBuild", { 1000, 100000, 1000000 }, [](BenchmarkContext& context)
+    {
+        BoundingVolumeHierarchy bvh;
+        std::vector<XMFLOAT3> mins;
+        std::vector<XMFLOAT3> maxs;
+        CreateProxies(static_cast<size_t>(context.GetArgument()), bvh, mins, maxs);
+
+        context.Measure([&]()
+        {
+            bvh.Build();
+        });
+
+        context.SetItemsPerIteration(static_cast<uint64_t>(context.GetArgument()));
+        context.SetCounter("nodes", bvh.GetStats().nodeCount);
+        context.SetCounter("maxDepth", bvh.GetStats().maxDepth);
+        context.SetCounter("sahCost", bvh.ComputeSAHCost());
+    });
+
+    // 1% of the proxies move a little every frame, then the tree is refit
+    BenchmarkRegistration s_bvhRefit("Culling/BVHRefit", { 1000, 100000, 1000000 }, [](BenchmarkContext& context)
+    {
+        size_t count = static_cast<size_t>(context.GetArgument());
+        BoundingVolumeHierarchy bvh;
+        std::vector<XMFLOAT3> mins;
+        std::vector<XMFLOAT3> maxs;
+        CreateProxies(count, bvh, mins, maxs);
+        bvh.Build();
+
+        size_t movingCount = count / 100 > 0 ? count / 100 : 1;
+        size_t stride = count / movingCount;
+        int frame = 0;
+
+        context.Measure([&]()
+        {
+            float offset = (frame++ & 1) ? 0.25f : -0.25f;
+            for (size_t i = 0; i < movingCount; ++i)
+            {
+                size_t proxy = i * stride;
+                mins[proxy].x += offset;
+                maxs[proxy].x += offset;
+                bvh.UpdateProxy(static_cast<int>(proxy), mins[proxy], maxs[proxy]);
+            }
+            bvh.Refit();
+        });
+
+        context.SetItemsPerIteration(movingCount);
+        context.SetCounter("refitNodes", bvh.GetStats().refitNodes);
+    });
+
+    BenchmarkRegistration s_bvhQuery("Culling/BVHQueryFrustum", { 1000, 100000, 1000000 }, [](BenchmarkContext& context)
+    {
+        BoundingVolumeHierarchy bvh;
+        std::vector<XMFLOAT3> mins;
+        std::vector<XMFLOAT3> maxs;
+        CreateProxies(static_cast<size_t>(context.GetArgument()), bvh, mins, maxs);
+        bvh.Build();
+
+        Frustum frustum = Frustum::FromViewProjection(Datasets::CreateViewProjection(FAR_PLANE));
+        std::vector<int> visible;
+
+        context.Measure([&]()
+        {
+            visible.clear();
+            bvh.QueryFrustum(frustum, visible);
+            DoNotOptimize(visible.data());
+        });
+
+        context.SetItemsPerIteration(static_cast<uint64_t>(context.GetArgument()));
+        context.SetCounter("visible", static_cast<double>(visible.size()));
+        context.SetCounter("nodesVisited", bvh.GetStats().nodesVisited);
+    });
+
+    // Picking: rays through random pixels of a 1280x720 view from the
+    // center of the boxes, through Camera::Pick and ScreenPointToRay
+    BenchmarkRegistration s_bvhRayCast("Culling/BVHRayCast", { 1000, 100000, 1000000 }, [](BenchmarkContext& context)
+    {
+        BoundingVolumeHierarchy bvh;
+        std::vector<XMFLOAT3> mins;
+        std::vector<XMFLOAT3> maxs;
+        CreateProxies(static_cast<size_t>(context.GetArgument()), bvh, mins, maxs);
+        bvh.Build();
+
+        Camera camera;
+        camera.SetCameraMode(CameraMode::FirstPerson);
+        camera.SetPosition(0.0f, 0.0f, 0.0f);
+        camera.Initialize(1280.0f, 720.0f);
+
+        Datasets::Random random(BOX_SEED);
+        std::vector<XMFLOAT2> pixels(QUERIES_PER_ITERATION);
+        for (XMFLOAT2& pixel : pixels)
+        {
+            pixel = XMFLOAT2(random.NextFloat(0.0f, 1280.0f), random.NextFloat(0.0f, 720.0f));
+        }
+
+        int hits = 0;
+        int nodesVisited = 0;
+        context.Measure([&]()
+        {
+            hits = 0;
+            nodesVisited = 0;
+            for (const XMFLOAT2& pixel : pixels)
+            {
+                BVHRayHit hit;
+                hits += camera.Pick(bvh, pixel.x, pixel.y, hit) ? 1 : 0;
+                nodesVisited += bvh.GetStats().nodesVisited;
+                DoNotOptimize(hit.distance);
+            }
+        });
+
+        context.SetItemsPerIteration(pixels.size());
+        context.SetCounter("hits", hits);
+        context.SetCounter("nodesVisitedPerRay", static_cast<double>(nodesVisited) / pixels.size());
+    });
+
+    // Boxes of 1 to 40 units at random places in the world, as physics
+    // broad phase and area queries ask
+    BenchmarkRegistration s_bvhOverlap("Culling/BVHQueryOverlap", { 1000, 100000, 1000000 }, [](BenchmarkContext& context)
+    {
+        BoundingVolumeHierarchy bvh;
+        std::vector<XMFLOAT3> mins;
+        std::vector<XMFLOAT3> maxs;
+        CreateProxies(static_cast<size_t>(context.GetArgument()), bvh, mins, maxs);
+        bvh.Build();
+
+        std::vector<XMFLOAT3> queryMins;
+        std::vector<XMFLOAT3> queryMaxs;
+        Datasets::CreateBoxes(QUERIES_PER_ITERATION, WORLD_HALF_SIZE, 0.5f, 20.0f, BOX_SEED + 1, queryMins, queryMaxs);
+
+        std::vector<int> results;
+        int nodesVisited = 0;
+        context.Measure([&]()
+        {
+            results.clear();
+            nodesVisited = 0;
+            for (size_t i = 0; i < queryMins.size(); ++i)
+            {
+                bvh.QueryOverlap(queryMins[i], queryMaxs[i], results);
+                nodesVisited += bvh.GetStats().nodesVisited;
+            }
+            DoNotOptimize(results.data());
+        });
+
+        context.SetItemsPerIteration(queryMins.size());
+        context.SetCounter("results", static_cast<double>(results.size()));
+        context.SetCounter("nodesVisitedPerQuery", static_cast<double>(nodesVisited) / queryMins.size());
+    });
+
+    // A row of walls in front of the camera; the argument is the wall count
+    std::vector<OccluderMesh> CreateWalls(int count)
+    {
+        std::vector<OccluderMesh> walls;
+        float width = 120.0f / static_cast<float>(count);
+        for (int i = 0; i < count; ++i)
+        {
+            float x = -60.0f + width * static_cast<float>(i);
+            walls.push_back(OcclusionCuller::CreateBoxOccluder(XMFLOAT3(x, -20.0f, 30.0f),
+                                                               XMFLOAT3(x + width * 0.8f, 20.0f, 31.0f)));
+        }
+        return walls;
+    }
+
+    BenchmarkRegistration s_occlusionRaster("Occlusion/RasterOccluders", { 16, 64, 256 }, [](BenchmarkContext& context)
+    {
+        std::vector<OccluderMesh> walls = CreateWalls(static_cast<int>(context.GetArgument()));
+        XMMATRIX viewProjection = Datasets::CreateViewProjection(FAR_PLANE);
+        XMMATRIX identity = XMMatrixIdentity();
+
+        OcclusionCuller culler;
+        culler.Initialize();
+
+        context.Measure([&]()
+        {
+            culler.BeginFrame(viewProjection);
+            for (const OccluderMesh& wall : walls)
+            {
+                culler.RenderOccluder(wall, identity);
+            }
+            culler.FinalizeOccluders();
+            DoNotOptimize(culler.GetDepth(0, 0));
+        });
+
+        context.SetItemsPerIteration(walls.size() * walls[0].GetTriangleCount());
+        context.SetCounter("rasterizedTriangles", culler.GetStats().rasterizedTriangles);
+    });
+
+    // Occludee tests on the frustum-visible part of the argument's box count
+    BenchmarkRegistration s_occlusionTest("Occlusion/FilterVisible", { 10000, 100000, 1000000 }, [](BenchmarkContext& context)
+    {
+        CullingBoxes boxes;
+        Datasets::CreateCullingBoxes(static_cast<size_t>(context.GetArgument()), WORLD_HALF_SIZE, BOX_SEED, boxes);
+
+        XMMATRIX viewProjection = Datasets::CreateViewProjection(FAR_PLANE);
+        std::vector<uint32_t> candidates;
+        FrustumCulling::CullBoxes(Frustum::FromViewProjection(viewProjection), boxes, candidates);
+
+        OcclusionCuller culler;
+        culler.Initialize();
+        culler.BeginFrame(viewProjection);
+        for (const OccluderMesh& wall : CreateWalls(64))
+        {
+            culler.RenderOccluder(wall, XMMatrixIdentity());
+        }
+        culler.FinalizeOccluders();
+
+        std::vector<uint32_t> visible;
+        visible.reserve(candidates.size());
+
+        context.Measure([&]()
+        {
+            visible.clear();
+            culler.FilterVisible(boxes, candidates, visible);
+            DoNotOptimize(visible.data());
+        });
+
+        context.SetItemsPerIteration(candidates.size());
+        context.SetCounter("candidates", static_cast<double>(candidates.size()));
+        context.SetCounter("visible", static_cast<double>(visible.size()));
+        context.SetCounter("occludedFraction", culler.GetStats().GetOccludedFraction());
+    });
+}
@@ -0,0 +1,334 @@
+#include "Datasets.h"
+#include <sstream>
+#include <iomanip>
+#include <cmath>
+#include <algorithm>
+
+namespace
+{
+    float GridHeight(int x, int z)
+    {
+        return 0.25f * std::sin(static_cast<float>(x) * 0.37f) * std::cos(static_cast<float>(z) * 0.23f);
+    }
+
+    // Shared grid: (gridSize + 1)^2 vertices, two triangles per quad
+    void AppendGridIndices(int gridSize, std::vector<unsigned int>& indices)
+    {
+        unsigned int rowLength = static_cast<unsigned int>(gridSize + 1);
+        for (int z = 0; z < gridSize; ++z)
+        {
+            for (int x = 0; x < gridSize; ++x)
+            {
+                unsigned int i0 = static_cast<unsigned int>(z) * rowLength + static_cast<unsigned int>(x);
+                unsigned int i1 = i0 + 1;
+                unsigned int i2 = i0 + rowLength;
+                unsigned int i3 = i2 + 1;
+
+                indices.push_back(i0);
+                indices.push_back(i2);
+                indices.push_back(i1);
+
+                indices.push_back(i1);
+                indices.push_back(i2);
+                indices.push_back(i3);
+            }
+        }
+    }
+}
+
+namespace Datasets
+{
+    uint32_t Random::NextUInt()
+    {
+        m_state ^= m_state << 13;
+        m_state ^= m_state >> 17;
+        m_state ^= m_state << 5;
+        return m_state;
+    }
+
+    float Random::NextFloat()
+    {
+        return static_cast<float>(NextUInt() >> 8) * (1.0f / 16777216.0f);
+    }
+
+    float Random::NextFloat(float minValue, float maxValue)
+    {
+        return minValue + (maxValue - minValue) * NextFloat();
+    }
+
+    void CreateGridMesh(int gridSize, bool unsharedVertices,
+                        std::vector<Vertex>& vertices, std::vector<unsigned int>& indices)
+    {
+        vertices.clear();
+        indices.clear();
+
+        std::vector<Vertex> gridVertices;
+        gridVertices.reserve(static_cast<size_t>(gridSize + 1) * (gridSize + 1));
+
+        float invSize = 1.0f / static_cast<float>(gridSize);
+        for (int z = 0; z <= gridSize; ++z)
+        {
+            for (int x = 0; x <= gridSize; ++x)
+            {
+                Vertex vertex;
+                vertex.position = XMFLOAT3(static_cast<float>(x), GridHeight(x, z), static_cast<float>(z));
+                vertex.texCoord = XMFLOAT2(static_cast<float>(x) * invSize, static_cast<float>(z) * invSize);
+                gridVertices.push_back(vertex);
+            }
+        }
+
+        std::vector<unsigned int> gridIndices;
+        gridIndices.reserve(static_cast<size_t>(gridSize) * gridSize * 6);
+        AppendGridIndices(gridSize, gridIndices);
+
+        if (!unsharedVertices)
+        {
+            vertices = std::move(gridVertices);
+            indices = std::move(gridIndices);
+            return;
+        }
+
+        vertices.reserve(gridIndices.size());
+        indices.reserve(gridIndices.size());
+        for (unsigned int index : gridIndices)
+        {
+            indices.push_back(static_cast<unsigned int>(vertices.size()));
+            vertices.push_back(gridVertices[index]);
+        }
+    }
+
+    std::string CreateXFile(int meshCount, int gridSize, int boneCount, int keyCount)
+    {
+        std::ostringstream file;
+        file << std::fixed << std::setprecision(6);
+        file << "xof 0303txt 0032\n";
+        file << "template Vector {\n <3d82ab5e-62da-11cf-ab39-0020af71e433>\n FLOAT x;\n FLOAT y;\n FLOAT z;\n}\n\n";
+
+        std::vector<Vertex> vertices;
+        std::vector<unsigned int> indices;
+        CreateGridMesh(gridSize, false, vertices, indices);
+
+        for (int mesh = 0; mesh < meshCount; ++mesh)
+        {
+            bool inFrame = (mesh == 0);
+            if (inFrame)
+            {
+                file << "Frame Root {\n";
+                file << " FrameTransformMatrix {\n  1.0,0.0,0.0,0.0,0.0,1.0,0.0,0.0,0.0,0.0,1.0,0.0,0.0,0.0,0.0,1.0;;\n }\n";
+            }
+
+            file << "Mesh Grid" << mesh << " {\n";
+
+            file << " " << vertices.size() << ";\n";
+            for (size_t i = 0; i < vertices.size(); ++i)
+            {
+                const XMFLOAT3& p = vertices[i].position;
+                file << " " << p.x << ";" << p.y + static_cast<float>(mesh) << ";" << p.z << ";"
+                     << (i + 1 < vertices.size() ? ",\n" : ";\n");
+            }
+
+            size_t faceCount = indices.size() / 3;
+            file << " " << faceCount << ";\n";
+            for (size_t i = 0; i < faceCount; ++i)
+            {
+                file << " 3;" << indices[i * 3] << "," << indices[i * 3 + 1] << "," << indices[i * 3 + 2] << ";"
+                     << (i + 1 < faceCount ? ",\n" : ";\n");
+            }
+
+            file << " MeshNormals {\n  " << vertices.size() << ";\n";
+            for (size_t i = 0; i < vertices.size(); ++i)
+            {
+                file << "  0.000000;1.000000;0.000000;" << (i + 1 < vertices.size() ? ",\n" : ";\n");
+            }
+            file << "  " << faceCount << ";\n";
+            for (size_t i = 0; i < faceCount; ++i)
+            {
+                file << "  3;" << indices[i * 3] << "," << indices[i * 3 + 1] << "," << indices[i * 3 + 2] << ";"
+                     << (i + 1 < faceCount ? ",\n" : ";\n");
+            }
+            file << " }\n";
+
+            file << " MeshTextureCoords {\n  " << vertices.size() << ";\n";
+            for (size_t i = 0; i < vertices.size(); ++i)
+            {
+                const XMFLOAT2& uv = vertices[i].texCoord;
+                file << "  " << uv.x << ";" << uv.y << ";" << (i + 1 < vertices.size() ? ",\n" : ";\n");
+            }
+            file << " }\n";
+
+            file << " MeshMaterialList {\n  1;\n  " << faceCount << ";\n";
+            for (size_t i = 0; i < faceCount; ++i)
+            {
+                file << "  0" << (i + 1 < faceCount ? ",\n" : ";\n");
+            }
+            file << "  Material Grid" << mesh << "Material {\n";
+            file << "   0.800000;0.800000;0.800000;1.000000;;\n   32.000000;\n";
+            file << "   1.000000;1.000000;1.000000;;\n   0.000000;0.000000;0.000000;;\n";
+            file << "   TextureFilename {\n    \"grid.png\";\n   }\n  }\n";
+            file << " }\n";
+
+            file << "}\n";
+
+            if (inFrame)
+            {
+                file << "}\n";
+            }
+        }
+
+        if (boneCount > 0 && keyCount > 0)
+        {
+            file << "AnimationSet Benchmark {\n";
+            for (int bone = 0; bone < boneCount; ++bone)
+            {
+                file << " Animation Bone" << bone << " {\n";
+
+                // Rotation keys (w, x, y, z), then position keys
+                file << "  AnimationKey {\n   0;\n   " << keyCount << ";\n";
+                for (int key = 0; key < keyCount; ++key)
+                {
+                    float angle = 0.1f * static_cast<float>(key + bone);
+                    file << "   " << key * 160 << ";4;" << std::cos(angle * 0.5f) << ",0.000000,"
+                         << std::sin(angle * 0.5f) << ",0.000000;;" << (key + 1 < keyCount ? ",\n" : ";\n");
+                }
+                file << "  }\n";
+
+                file << "  AnimationKey {\n   2;\n   " << keyCount << ";\n";
+                for (int key = 0; key < keyCount; ++key)
+                {
+                    file << "   " << key * 160 << ";3;0.000000," << 0.01f * static_cast<float>(key)
+                         << ",1.000000;;" << (key + 1 < keyCount ? ",\n" : ";\n");
+                }
+                file << "  }\n";
+
+                file << " }\n";
+            }
+            file << "}\n";
+        }
+
+        return file.str();
+    }
+
+    std::vector<Bone> CreateSkeleton(int boneCount, int chainLength)
+    {
+        std::vector<Bone> skeleton(static_cast<size_t>(boneCount));
+        for (int i = 0; i < boneCount; ++i)
+        {
+            Bone& bone = skeleton[i];
+            bone.name = "Bone" + std::to_string(i);
+            bone.parentIndex = (chainLength > 1 && i % chainLength != 0) ? i - 1 : -1;
+            bone.bindMatrix = XMMatrixTranslation(0.0f, 0.1f, 0.0f);
+            bone.currentMatrix = bone.bindMatrix;
+
+            if (bone.parentIndex >= 0)
+            {
+                skeleton[bone.parentIndex].childrenIndices.push_back(i);
+            }
+        }
+
+        return skeleton;
+    }
+
+    void CreateAnimation(const std::vector<Bone>& skeleton, int keyCount, float duration, Animation& animation)
+    {
+        animation.Shutdown();
+        animation.Initialize("Benchmark", duration, 25.0f);
+
+        float keySpacing = keyCount > 1 ? duration / static_cast<float>(keyCount - 1) : 0.0f;
+        for (size_t bone = 0; bone < skeleton.size(); ++bone)
+        {
+            AnimationChannel channel;
+            channel.boneName = skeleton[bone].name;
+            channel.boneIndex = static_cast<int>(bone);
+
+            for (int key = 0; key < keyCount; ++key)
+            {
+                float time = keySpacing * static_cast<float>(key);
+                float angle = 0.2f * static_cast<float>(key) + 0.01f * static_cast<float>(bone);
+
+                channel.positionKeys.push_back(AnimationKey<XMVECTOR>(time, XMVectorSet(0.0f, 0.1f, 0.01f * key, 0.0f)));
+                channel.rotationKeys.push_back(AnimationKey<XMVECTOR>(time, XMQuaternionRotationRollPitchYaw(angle, 0.5f * angle, 0.0f)));
+                channel.scaleKeys.push_back(AnimationKey<XMVECTOR>(time, XMVectorSet(1.0f, 1.0f, 1.0f, 0.0f)));
+            }
+
+            animation.AddChannel(channel);
+        }
+    }
+
+    void CreateBoxes(size_t count, float worldHalfSize, float minExtent, float maxExtent, uint32_t seed,
+                     std::vector<XMFLOAT3>& mins, std::vector<XMFLOAT3>& maxs)
+    {
+        Random random(seed);
+        mins.resize(count);
+        maxs.resize(count);
+
+        for (size_t i = 0; i < count; ++i)
+        {
+            XMFLOAT3 center(random.NextFloat(-worldHalfSize, worldHalfSize),
+                            random.NextFloat(-worldHalfSize, worldHalfSize),
+                            random.NextFloat(-worldHalfSize, worldHalfSize));
+            XMFLOAT3 extents(random.NextFloat(minExtent, maxExtent),
+                             random.NextFloat(minExtent, maxExtent),
+                             random.NextFloat(minExtent, maxExtent));
+
+            mins[i] = XMFLOAT3(center.x - extents.x, center.y - extents.y, center.z - extents.z);
+            maxs[i] = XMFLOAT3(center.x + extents.x, center.y + extents.y, center.z + extents.z);
+        }
+    }
+
+    void CreateCullingBoxes(size_t count, float worldHalfSize, uint32_t seed, CullingBoxes& boxes)
+    {
+        std::vector<XMFLOAT3> mins;
+        std::vector<XMFLOAT3> maxs;
+        CreateBoxes(count, worldHalfSize, 0.5f, 2.0f, seed, mins, maxs);
+
+        boxes.Clear();
+        boxes.Reserve(count);
+        for (size_t i = 0; i < count; ++i)
+        {
+            boxes.AddMinMax(mins[i], maxs[i]);
+        }
+    }
+
+    XMMATRIX CreateViewProjection(float farPlane)
+    {
+        XMMATRIX view = XMMatrixLookAtLH(XMVectorSet(0.0f, 0.0f, 0.0f, 1.0f),
+                                         XMVectorSet(0.0f, 0.0f, 1.0f, 1.0f),
+                                         XMVectorSet(0.0f, 1.0f, 0.0f, 0.0f));
+        XMMATRIX projection = XMMatrixPerspectiveFovLH(XM_PI / 3.0f, 16.0f / 9.0f, 0.1f, farPlane);
+        return XMMatrixMultiply(view, projection);
+    }
+
+    PostProcessImage CreateImage(int width, int height, int lightCount, uint32_t seed)
+    {
+        Random random(seed);
+        PostProcessImage image(width, height);
+
+        for (int y = 0; y < height; ++y)
+        {
+            for (int x = 0; x < width; ++x)
+            {
+                float u = static_cast<float>(x) / width;
+                float v = static_cast<float>(y) / height;
+                float noise = random.NextFloat(-0.05f, 0.05f);
+                image.At(x, y) = XMFLOAT4(0.2f + 0.5f * u + noise, 0.3f + 0.4f * v + noise, 0.5f - 0.3f * u * v + noise, 1.0f);
+            }
+        }
+
+        for (int i = 0; i < lightCount; ++i)
+        {
+            int lightX = static_cast<int>(random.NextFloat() * width);
+            int lightY = static_cast<int>(random.NextFloat() * height);
+            float energy = random.NextFloat(2.0f, 8.0f);
+
+            for (int y = std::max(lightY - 1, 0); y <= std::min(lightY + 1, height - 1); ++y)
+            {
+                for (int x = std::max(lightX - 1, 0); x <= std::min(lightX + 1, width - 1); ++x)
+                {
+                    image.At(x, y) = XMFLOAT4(energy, energy, energy * 0.8f, 1.0f);
+                }
+            }
+        }
+
+        return image;
+    }
+}
@@ -0,0 +1,61 @@
+#pragma once
+
+#include <DirectXMath.h>
+#include <string>
+#include <vector>
+#include <cstdint>
+#include "../Resources/Vertex.h"
+#include "../Graphics/Animation.h"
+#include "../Graphics/FrustumCulling.h"
+#include "../Graphics/PostProcessKernels.h"
+
+using namespace DirectX;
+
+// Generated benchmark inputs. Every generator is deterministic for a given
+// seed, so results of different commits are measured on identical data.
+namespace Datasets
+{
+    // Small xorshift generator; std::mt19937 distributions differ between
+    // standard libraries, which would change the data across platforms
+    class Random
+    {
+    public:
+        explicit Random(uint32_t seed) : m_state(seed ? seed : 0x9e3779b9u) {}
+
+        uint32_t NextUInt();
+        float NextFloat();                          // [0, 1)
+        float NextFloat(float minValue, float maxValue);
+
+    private:
+        uint32_t m_state;
+    };
+
+    // Wavy grid of gridSize x gridSize quads in the XZ plane. With
+    // unsharedVertices every triangle gets its own three vertices, the
+    // layout exporters often produce and WeldVertices undoes.
+    void CreateGridMesh(int gridSize, bool unsharedVertices,
+                        std::vector<Vertex>& vertices, std::vector<unsigned int>& indices);
+
+    // Text .x file with meshCount grid meshes (each with normals, texture
+    // coordinates and a material), the first one nested in a frame, and an
+    // animation set with keyCount keys on each of boneCount bones
+    std::string CreateXFile(int meshCount, int gridSize, int boneCount, int keyCount);
+
+    // Skeleton of boneCount bones in chains of chainLength (deep hierarchies
+    // like tails, ropes or spines), and an animation with a channel per bone
+    std::vector<Bone> CreateSkeleton(int boneCount, int chainLength);
+    void CreateAnimation(const std::vector<Bone>& skeleton, int keyCount, float duration, Animation& animation);
+
+    // count boxes scattered through a cube of the given half size, with
+    // extents between minExtent and maxExtent
+    void CreateBoxes(size_t count, float worldHalfSize, float minExtent, float maxExtent, uint32_t seed,
+                     std::vector<XMFLOAT3>& mins, std::vector<XMFLOAT3>& maxs);
+    void CreateCullingBoxes(size_t count, float worldHalfSize, uint32_t seed, CullingBoxes& boxes);
+
+    // Camera at the origin looking down +Z with a 60 degree field of view
+    XMMATRIX CreateViewProjection(float farPlane);
+
+    // Scene-like HDR image: smooth gradients with noise and lightCount
+    // small lights well above 1, so bloom has highlights to extract
+    PostProcessImage CreateImage(int width, int height, int lightCount, uint32_t seed);
+}
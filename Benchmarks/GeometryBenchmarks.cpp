@@ -0,0 +1,90 @@
+#include "Benchmark.h"
+#include "Datasets.h"
+#include "../Graphics/XFileParser.h"
+#include "../Resources/MeshProcessing.h"
+
+// Model loading on the CPU: .x parsing and the mesh post-processing that
+// ModelLoader runs on every mesh. The argument is the grid size per mesh.
+
+namespace
+{
+    const int XFILE_MESH_COUNT = 4;
+    const int XFILE_BONE_COUNT = 64;
+    const int XFILE_KEY_COUNT = 120;
+
+    BenchmarkRegistration s_parseXFile("Geometry/ParseXFile", { 32, 128, 256 }, [](BenchmarkContext& context)
+    {
+        int gridSize = static_cast<int>(context.GetArgument());
+        std::string content = Datasets::CreateXFile(XFILE_MESH_COUNT, gridSize, XFILE_BONE_COUNT, XFILE_KEY_COUNT);
+
+        XFileParser parser;
+        parser.SetLoadAnimations(true);
+        XFileScene scene;
+        size_t triangles = 0;
+
+        context.Measure([&]()
+        {
+            scene.Clear();
+            parser.Parse(content, scene);
+            DoNotOptimize(scene.meshes.size());
+        });
+
+        for (const XMeshData& mesh : scene.meshes)
+        {
+            triangles += mesh.indices.size() / 3;
+        }
+
+        context.SetItemsPerIteration(content.size());
+        context.SetCounter("bytes", static_cast<double>(content.size()));
+        context.SetCounter("meshes", static_cast<double>(scene.meshes.size()));
+        context.SetCounter("triangles", static_cast<double>(triangles));
+        context.SetCounter("channels", scene.animationSets.empty() ? 0.0 : static_cast<double>(scene.animationSets[0].channels.size()));
+    });
+
+    BenchmarkRegistration s_calculateNormals("Geometry/CalculateNormals", { 64, 256, 1024 }, [](BenchmarkContext& context)
+    {
+        std::vector<Vertex> vertices;
+        std::vector<unsigned int> indices;
+        Datasets::CreateGridMesh(static_cast<int>(context.GetArgument()), false, vertices, indices);
+
+        context.Measure([&]()
+        {
+            MeshProcessing::CalculateNormals(vertices, indices);
+            DoNotOptimize(vertices.data());
+        });
+
+        context.SetItemsPerIteration(indices.size() / 3);
+        context.SetCounter("vertices", static_cast<double>(vertices.size()));
+    });
+
+    BenchmarkRegistration s_weldVertices("Geometry/WeldVertices", { 64, 256, 1024 }, [](BenchmarkContext& context)
+    {
+        std::vector<Vertex> sourceVertices;
+        std::vector<unsigned int> sourceIndices;
+        Datasets::CreateGridMesh(static_cast<int>(context.GetArgument()), true, sourceVertices, sourceIndices);
+
+        std::vector<Vertex> vertices;
+        std::vector<unsigned int> indices;
+        LinearArena scratch(MemorySubsystem::Loading);
+
+        // Welding is in place, so every call starts from a fresh copy; the
+        // lookup table comes from a scratch arena like in ModelLoader
+        context.Measure(
+            [&]()
+            {
+                vertices = sourceVertices;
+                indices = sourceIndices;
+                scratch.Reset();
+            },
+            [&]()
+            {
+                MeshProcessing::WeldVertices(vertices, indices, &scratch);
+                DoNotOptimize(vertices.data());
+            });
+
+        context.SetItemsPerIteration(sourceVertices.size());
+        context.SetCounter("scratchBytes", static_cast<double>(scratch.GetUsedBytes()));
+        context.SetCounter("inputVertices", static_cast<double>(sourceVertices.size()));
+        context.SetCounter("weldedVertices", static_cast<double>(vertices.size()));
+    });
+}
@@ -0,0 +1,126 @@
+#include "Benchmark.h"
+#include "../Engine/JobSystem.h"
+#include <atomic>
+
+// Scheduling overhead of the job system with near-empty jobs. The argument
+// is the job count per iteration.
+
+namespace
+{
+    // Tiny amount of work so the jobs are not free
+    void SpinWork(std::atomic<uint64_t>& sink, uint64_t seed)
+    {
+        uint64_t value = seed;
+        for (int i = 0; i < 16; ++i)
+        {
+            value = value * 6364136223846793005ull + 1442695040888963407ull;
+        }
+        sink.fetch_add(value & 1, std::memory_order_relaxed);
+    }
+
+    // Spawning from the calling thread, then waiting on one counter
+    BenchmarkRegistration s_fanOut("JobSystem/FanOut", { 1, 64, 4096 }, [](BenchmarkContext& context)
+    {
+        JobSystem jobSystem;
+        jobSystem.Initialize();
+
+        size_t jobCount = static_cast<size_t>(context.GetArgument());
+        std::atomic<uint64_t> sink(0);
+
+        context.Measure([&]()
+        {
+            JobCounter counter;
+            for (size_t i = 0; i < jobCount; ++i)
+            {
+                jobSystem.Run([&sink, i]() { SpinWork(sink, i); }, &counter);
+            }
+            jobSystem.Wait(counter);
+        });
+
+        context.SetItemsPerIteration(jobCount);
+        context.SetCounter("workers", jobSystem.GetWorkerCount());
+        jobSystem.Shutdown();
+    });
+
+    // Recursive fork-join: every job splits in two until the leaves hold one unit
+    void ForkJoin(JobSystem& jobSystem, size_t begin, size_t end, std::atomic<uint64_t>& sink)
+    {
+        if (end - begin <= 1)
+        {
+            SpinWork(sink, begin);
+            return;
+        }
+
+        size_t middle = begin + (end - begin) / 2;
+        JobCounter counter;
+        jobSystem.Run([&jobSystem, begin, middle, &sink]() { ForkJoin(jobSystem, begin, middle, sink); }, &counter);
+        ForkJoin(jobSystem, middle, end, sink);
+        jobSystem.Wait(counter);
+    }
+
+    BenchmarkRegistration s_forkJoin("JobSystem/ForkJoin", { 64, 4096, 65536 }, [](BenchmarkContext& context)
+    {
+        JobSystem jobSystem;
+        jobSystem.Initialize();
+
+        size_t leafCount = static_cast<size_t>(context.GetArgument());
+        std::atomic<uint64_t> sink(0);
+
+        context.Measure([&]()
+        {
+            JobCounter counter;
+            jobSystem.Run([&]() { ForkJoin(jobSystem, 0, leafCount, sink); }, &counter);
+            jobSystem.Wait(counter);
+        });
+
+        context.SetItemsPerIteration(leafCount);
+        jobSystem.Shutdown();
+    });
+
+    // Dependency chain: each job is released by the previous one
+    BenchmarkRegistration s_chain("JobSystem/DependencyChain", { 16, 256 }, [](BenchmarkContext& context)
+    {
+        JobSystem jobSystem;
+        jobSystem.Initialize();
+
+        size_t length = static_cast<size_t>(context.GetArgument());
+        std::atomic<uint64_t> sink(0);
+
+        context.Measure([&]()
+        {
+            std::vector<JobCounter> counters(length);
+            jobSystem.Run([&sink]() { SpinWork(sink, 0); }, &counters[0]);
+            for (size_t i = 1; i < length; ++i)
+            {
+                jobSystem.RunAfter(counters[i - 1], [&sink, i]() { SpinWork(sink, i); }, &counters[i]);
+            }
+            jobSystem.Wait(counters[length - 1]);
+        });
+
+        context.SetItemsPerIteration(length);
+        jobSystem.Shutdown();
+    });
+
+    BenchmarkRegistration s_parallelFor("JobSystem/ParallelFor", { 1000, 100000, 1000000 }, [](BenchmarkContext& context)
+    {
+        JobSystem jobSystem;
+        jobSystem.Initialize();
+
+        std::vector<float> values(static_cast<size_t>(context.GetArgument()), 1.0f);
+
+        context.Measure([&]()
+        {
+            jobSystem.ParallelFor(values.size(), 1024, [&values](size_t begin, size_t end)
+            {
+                for (size_t i = begin; i < end; ++i)
+                {
+                    values[i] = values[i] * 0.5f + 0.5f;
+                }
+            });
+            DoNotOptimize(values.data());
+        });
+
+        context.SetItemsPerIteration(values.size());
+        jobSystem.Shutdown();
+    });
+}
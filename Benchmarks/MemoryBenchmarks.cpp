@@ -0,0 +1,119 @@
+#include "Benchmark.h"
+#include "../Engine/Memory.h"
+#include <memory>
+
+// Allocator costs against the general-purpose heap. The argument is the
+// allocation count per iteration.
+
+namespace
+{
+    const size_t SMALL_ALLOCATION = 48;
+
+    BenchmarkRegistration s_heap("Memory/HeapSmall", { 1000, 100000 }, [](BenchmarkContext& context)
+    {
+        size_t count = static_cast<size_t>(context.GetArgument());
+        std::vector<void*> pointers(count);
+
+        context.Measure([&]()
+        {
+            for (size_t i = 0; i < count; ++i)
+            {
+                pointers[i] = ::operator new(SMALL_ALLOCATION);
+            }
+            for (size_t i = 0; i < count; ++i)
+            {
+                ::operator delete(pointers[i]);
+            }
+        });
+
+        context.SetItemsPerIteration(count);
+    });
+
+    // Allocate, then free everything with one Reset
+    BenchmarkRegistration s_arena("Memory/ArenaSmall", { 1000, 100000 }, [](BenchmarkContext& context)
+    {
+        size_t count = static_cast<size_t>(context.GetArgument());
+        LinearArena arena(MemorySubsystem::General);
+
+        context.Measure([&]()
+        {
+            for (size_t i = 0; i < count; ++i)
+            {
+                DoNotOptimize(arena.Allocate(SMALL_ALLOCATION));
+            }
+            arena.Reset();
+        });
+
+        context.SetItemsPerIteration(count);
+        context.SetCounter("blocks", static_cast<double>(arena.GetBlockCount()));
+    });
+
+    BenchmarkRegistration s_pool("Memory/PoolSmall", { 1000, 100000 }, [](BenchmarkContext& context)
+    {
+        size_t count = static_cast<size_t>(context.GetArgument());
+        PoolAllocator pool(SMALL_ALLOCATION, 16, MemorySubsystem::General, 1024);
+        std::vector<void*> pointers(count);
+
+        context.Measure([&]()
+        {
+            for (size_t i = 0; i < count; ++i)
+            {
+                pointers[i] = pool.Allocate();
+            }
+            for (size_t i = 0; i < count; ++i)
+            {
+                pool.Free(pointers[i]);
+            }
+        });
+
+        context.SetItemsPerIteration(count);
+        context.SetCounter("pages", static_cast<double>(pool.GetPageCount()));
+    });
+
+    // shared_ptr creation as ModelLoader does it for meshes and materials
+    struct PayloadObject
+    {
+        float data[16];
+    };
+
+    BenchmarkRegistration s_makeShared("Memory/MakeShared", { 1000 }, [](BenchmarkContext& context)
+    {
+        size_t count = static_cast<size_t>(context.GetArgument());
+        std::vector<std::shared_ptr<PayloadObject>> objects(count);
+
+        context.Measure([&]()
+        {
+            for (size_t i = 0; i < count; ++i)
+            {
+                objects[i] = std::make_shared<PayloadObject>();
+            }
+            for (size_t i = 0; i < count; ++i)
+            {
+                objects[i].reset();
+            }
+        });
+
+        context.SetItemsPerIteration(count);
+    });
+
+    BenchmarkRegistration s_allocateShared("Memory/AllocateSharedPooled", { 1000 }, [](BenchmarkContext& context)
+    {
+        size_t count = static_cast<size_t>(context.GetArgument());
+        std::vector<std::shared_ptr<PayloadObject>> objects(count);
+        PooledAllocator<PayloadObject, MemorySubsystem::General> allocator;
+
+        context.Measure([&]()
+        {
+            for (size_t i = 0; i < count; ++i)
+            {
+                objects[i] = std::allocate_shared<PayloadObject>(allocator);
+            }
+            for (size_t i = 0; i < count; ++i)
+            {
+                objects[i].reset();
+            }
+        });
+
+        context.SetItemsPerIteration(count);
+    });
+}
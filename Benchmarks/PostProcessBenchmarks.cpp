@@ -0,0 +1,265 @@
+#include "Benchmark.h"
+#include "Datasets.h"
+#include "../Graphics/PostProcessFusion.h"
+#include "../Graphics/AutoExposure.h"
+#include "../Engine/JobSystem.h"
+#include <algorithm>
+#include <cmath>
+
+// CPU reference passes of the blur and bloom effects and of the
+// auto-exposure histogram. The argument is the vertical resolution (16:9).
+// The timings are of the reference code; the fetch counters model the GPU
+// cost of the same passes per output pixel.
+
+namespace
+{
+    const int LIGHT_COUNT = 32;
+    const uint32_t SEED = 7;
+
+    // The previous blur sampled a 9x9 grid at full resolution
+    const double BRUTE_FORCE_BLUR_FETCHES = 81.0;
+
+    // Frame traffic of one fullscreen RGBA8 pass: a read and a write per pixel
+    const double PASS_BYTES_PER_PIXEL = 8.0;
+
+    const std::vector<PostProcessEffect> PER_PIXEL_CHAIN =
+    {
+        PostProcessEffect::ColorCorrection, PostProcessEffect::Sepia, PostProcessEffect::Grayscale,
+        PostProcessEffect::ToneMapping, PostProcessEffect::Vignette
+    };
+
+    PostProcessParams CreatePerPixelParams()
+    {
+        PostProcessParams params;
+        params.intensity = 0.5f;
+        params.contrast = 1.1f;
+        params.saturation = 0.8f;
+        params.colorTint = XMFLOAT3(1.0f, 0.95f, 0.9f);
+        params.exposure = 1.5f;
+        return params;
+    }
+
+    int GetWidth(int height)
+    {
+        return height * 16 / 9;
+    }
+
+    float GetMaxDifference(const PostProcessImage& a, const PostProcessImage& b)
+    {
+        float difference = 0.0f;
+        for (size_t i = 0; i < a.pixels.size(); ++i)
+        {
+            difference = std::max(difference, std::fabs(a.pixels[i].x - b.pixels[i].x));
+            difference = std::max(difference, std::fabs(a.pixels[i].y - b.pixels[i].y));
+            difference = std::max(difference, std::fabs(a.pixels[i].z - b.pixels[i].z));
+        }
+        return difference;
+    }
+
+    // One texel fetch per kernel texel, both directions at full resolution
+    BenchmarkRegistration s_blurDiscrete("PostProcess/BlurDiscrete", { 180, 360 }, [](BenchmarkContext& context)
+    {
+        int height = static_cast<int>(context.GetArgument());
+        PostProcessImage source = Datasets::CreateImage(GetWidth(height), height, LIGHT_COUNT, SEED);
+        PostProcessImage horizontal(source.width, source.height);
+        PostProcessImage destination(source.width, source.height);
+
+        PostProcessParams params;
+        float sigma = PostProcessKernels::GetBlurSigma(params);
+        GaussianKernel kernel = PostProcessKernels::ComputeGaussianKernel(sigma, PostProcessKernels::GetBlurRadius(sigma));
+
+        context.Measure([&]()
+        {
+            PostProcessKernels::BlurPassDiscrete(source, horizontal, kernel, true);
+            PostProcessKernels::BlurPassDiscrete(horizontal, destination, kernel, false);
+            DoNotOptimize(destination.pixels.data());
+        });
+
+        context.SetItemsPerIteration(source.pixels.size());
+        context.SetCounter("fetchesPerPixel", 2.0 * (2 * kernel.weights.size() - 1));
+        context.SetCounter("bruteForceFetchesPerPixel", BRUTE_FORCE_BLUR_FETCHES);
+    });
+
+    // The Blur effect: merged taps, horizontal pass at half resolution.
+    // linearError checks the merged kernel against the discrete one on a
+    // full-resolution pass, where both must agree.
+    BenchmarkRegistration s_gaussianBlur("PostProcess/GaussianBlur", { 180, 360 }, [](BenchmarkContext& context)
+    {
+        int height = static_cast<int>(context.GetArgument());
+        PostProcessImage source = Datasets::CreateImage(GetWidth(height), height, LIGHT_COUNT, SEED);
+        PostProcessImage destination(source.width, source.height);
+        PostProcessParams params;
+
+        context.Measure([&]()
+        {
+            PostProcessKernels::GaussianBlur(source, destination, params);
+            DoNotOptimize(destination.pixels.data());
+        });
+
+        float sigma = PostProcessKernels::GetBlurSigma(params);
+        GaussianKernel kernel = PostProcessKernels::ComputeGaussianKernel(sigma, PostProcessKernels::GetBlurRadius(sigma));
+        PostProcessImage discrete(source.width, source.height);
+        PostProcessImage linear(source.width, source.height);
+        PostProcessKernels::BlurPassDiscrete(source, discrete, kernel, true);
+        PostProcessKernels::BlurPass(source, linear, PostProcessKernels::ComputeLinearKernel(kernel),
+                                     1.0f / source.width, 0.0f);
+
+        double pixels = static_cast<double>(source.pixels.size());
+        context.SetItemsPerIteration(source.pixels.size());
+        context.SetCounter("fetchesPerPixel", PostProcessKernels::GetGaussianBlurFetches(source.width, source.height, params) / pixels);
+        context.SetCounter("bruteForceFetchesPerPixel", BRUTE_FORCE_BLUR_FETCHES);
+        context.SetCounter("linearError", GetMaxDifference(discrete, linear));
+    });
+
+    BenchmarkRegistration s_bloom("PostProcess/Bloom", { 180, 360 }, [](BenchmarkContext& context)
+    {
+        int height = static_cast<int>(context.GetArgument());
+        PostProcessImage source = Datasets::CreateImage(GetWidth(height), height, LIGHT_COUNT, SEED);
+        PostProcessImage destination(source.width, source.height);
+        PostProcessParams params;
+
+        context.Measure([&]()
+        {
+            PostProcessKernels::Bloom(source, destination, params);
+            DoNotOptimize(destination.pixels.data());
+        });
+
+        double pixels = static_cast<double>(source.pixels.size());
+        context.SetItemsPerIteration(source.pixels.size());
+        context.SetCounter("mips", PostProcessKernels::GetBloomMipCount(source.width, source.height));
+        context.SetCounter("fetchesPerPixel", PostProcessKernels::GetBloomFetches(source.width, source.height) / pixels);
+    });
+
+    // Per-pixel effects as separate passes, the layout before fusion
+    BenchmarkRegistration s_perPixelSeparate("PostProcess/PerPixelSeparate", { 180, 360 }, [](BenchmarkContext& context)
+    {
+        int height = static_cast<int>(context.GetArgument());
+        PostProcessImage source = Datasets::CreateImage(GetWidth(height), height, LIGHT_COUNT, SEED);
+        PostProcessImage images[2] = { source, source };
+        PostProcessParams params = CreatePerPixelParams();
+
+        context.Measure([&]()
+        {
+            const PostProcessImage* input = &source;
+            for (size_t i = 0; i < PER_PIXEL_CHAIN.size(); ++i)
+            {
+                PostProcessImage& output = images[i % 2];
+                PostProcessFusion::ApplyReference(*input, output, { PER_PIXEL_CHAIN[i] }, params);
+                input = &output;
+            }
+            DoNotOptimize(input->pixels.data());
+        });
+
+        context.SetItemsPerIteration(source.pixels.size());
+        context.SetCounter("passes", static_cast<double>(PER_PIXEL_CHAIN.size()));
+        context.SetCounter("bytesPerPixel", PASS_BYTES_PER_PIXEL * PER_PIXEL_CHAIN.size());
+    });
+
+    // The same chain as one fused pass; Tests/PostProcessFusionTests.cpp
+    // checks it matches the separate passes
+    BenchmarkRegistration s_perPixelFused("PostProcess/PerPixelFused", { 180, 360 }, [](BenchmarkContext& context)
+    {
+        int height = static_cast<int>(context.GetArgument());
+        PostProcessImage source = Datasets::CreateImage(GetWidth(height), height, LIGHT_COUNT, SEED);
+        PostProcessImage destination(source.width, source.height);
+        PostProcessParams params = CreatePerPixelParams();
+
+        context.Measure([&]()
+        {
+            PostProcessFusion::ApplyReference(source, destination, PER_PIXEL_CHAIN, params);
+            DoNotOptimize(destination.pixels.data());
+        });
+
+        context.SetItemsPerIteration(source.pixels.size());
+        context.SetCounter("passes", 1.0);
+        context.SetCounter("bytesPerPixel", PASS_BYTES_PER_PIXEL);
+    });
+
+    uint32_t GetBinMismatches(const LuminanceHistogram& a, const LuminanceHistogram& b)
+    {
+        uint32_t mismatches = 0;
+        for (int i = 0; i < LUMINANCE_HISTOGRAM_BINS; ++i)
+        {
+            mismatches += a.bins[i] != b.bins[i] ? 1 : 0;
+        }
+        return mismatches;
+    }
+
+    // Histogram, average and adaptation of one frame; the tiled versions are
+    // compared with this one and must count every bin the same
+    void RunHistogram(BenchmarkContext& context, JobSystem* jobSystem, bool tiled)
+    {
+        int height = static_cast<int>(context.GetArgument());
+        PostProcessImage source = Datasets::CreateImage(GetWidth(height), height, LIGHT_COUNT, SEED);
+        PostProcessParams params;
+        ParallelForFunction parallelFor = jobSystem ? jobSystem->GetParallelForFunction(1) : ParallelForFunction();
+
+        LuminanceHistogram histogram;
+        float adapted = 1.0f;
+
+        context.Measure([&]()
+        {
+            if (tiled)
+            {
+                AutoExposure::BuildHistogramTiled(source, params, histogram, parallelFor);
+            }
+            else
+            {
+                AutoExposure::BuildHistogram(source, params, histogram);
+            }
+            adapted = AutoExposure::Adapt(adapted, AutoExposure::GetAverageLuminance(histogram, params), 1.0f / 60.0f, params);
+            DoNotOptimize(adapted);
+        });
+
+        LuminanceHistogram reference;
+        AutoExposure::BuildHistogram(source, params, reference);
+        float average = AutoExposure::GetAverageLuminance(reference, params);
+
+        context.SetItemsPerIteration(source.pixels.size());
+        context.SetCounter("averageLuminance", average);
+        context.SetCounter("exposure", AutoExposure::GetExposure(average, params));
+        context.SetCounter("binMismatches", GetBinMismatches(reference, histogram));
+    }
+
+    BenchmarkRegistration s_histogram("AutoExposure/Histogram", { 360, 1080 }, [](BenchmarkContext& context)
+    {
+        RunHistogram(context, nullptr, false);
+    });
+
+    BenchmarkRegistration s_histogramTiled("AutoExposure/HistogramTiled", { 360, 1080 }, [](BenchmarkContext& context)
+    {
+        RunHistogram(context, nullptr, true);
+    });
+
+    BenchmarkRegistration s_histogramParallel("AutoExposure/HistogramParallel", { 360, 1080 }, [](BenchmarkContext& context)
+    {
+        JobSystem jobSystem;
+        jobSystem.Initialize();
+        RunHistogram(context, &jobSystem, true);
+        jobSystem.Shutdown();
+    });
+
+    // Frames at 60 Hz for the adapted luminance to cover 90% of a jump of
+    // the measured luminance from 1 to 10
+    BenchmarkRegistration s_adaptation("AutoExposure/Adaptation", { 1 }, [](BenchmarkContext& context)
+    {
+        PostProcessParams params;
+        const float deltaTime = 1.0f / 60.0f;
+        int frames = 0;
+
+        context.Measure([&]()
+        {
+            float adapted = 1.0f;
+            frames = 0;
+            while (adapted < 9.1f)
+            {
+                adapted = AutoExposure::Adapt(adapted, 10.0f, deltaTime, params);
+                ++frames;
+            }
+            DoNotOptimize(adapted);
+        });
+
+        context.SetCounter("framesTo90Percent", frames);
+        context.SetCounter("secondsTo90Percent", frames * deltaTime);
+    });
+}
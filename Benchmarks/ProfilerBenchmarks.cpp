@@ -0,0 +1,48 @@
+#include "Benchmark.h"
+#include "../Engine/Profiler.h"
+
+// Cost of instrumentation. The argument is the zone count per iteration;
+// ProfileZone is used directly so the numbers do not depend on
+// ENGINE_ENABLE_PROFILER.
+
+namespace
+{
+    void RunZones(BenchmarkContext& context, bool capture)
+    {
+        int zoneCount = static_cast<int>(context.GetArgument());
+        if (capture)
+        {
+            Profiler::StartCapture();
+        }
+
+        ProfilerThreadBuffer* buffer = Profiler::GetThreadBuffer();
+        uint64_t savedIndex = buffer->writeIndex.load(std::memory_order_relaxed);
+
+        context.Measure([&]()
+        {
+            for (int i = 0; i < zoneCount; ++i)
+            {
+                ProfileZone zone("BenchmarkZone");
+            }
+        });
+
+        // Keep the benchmark zones out of later captures
+        buffer->writeIndex.store(savedIndex, std::memory_order_relaxed);
+        if (capture)
+        {
+            Profiler::StopCapture();
+        }
+
+        context.SetItemsPerIteration(static_cast<uint64_t>(zoneCount));
+    }
+
+    BenchmarkRegistration s_zoneIdle("Profiler/ZoneNotCapturing", { 1000 }, [](BenchmarkContext& context)
+    {
+        RunZones(context, false);
+    });
+
+    BenchmarkRegistration s_zoneCapturing("Profiler/ZoneCapturing", { 1000 }, [](BenchmarkContext& context)
+    {
+        RunZones(context, true);
+    });
+}
@@ -0,0 +1,75 @@
+#include "Benchmark.h"
+#include "../Graphics/PostProcessChain.h"
+
+// Building and compiling the post-process render graph for typical effect
+// chains. The argument is the vertical resolution (16:9). Counters report the
+// transient texture memory with and without aliasing.
+
+namespace
+{
+    const double MEGABYTE = 1024.0 * 1024.0;
+
+    void CompileChain(BenchmarkContext& context, const std::vector<PostProcessEffect>& effects,
+                      RenderGraphFormat format = RenderGraphFormat::RGBA8, bool autoExposure = false)
+    {
+        int height = static_cast<int>(context.GetArgument());
+        RenderGraphTextureDesc desc(height * 16 / 9, height, format);
+        RenderGraphTextureDesc outputDesc(desc.width, desc.height, RenderGraphFormat::RGBA8);
+
+        RenderGraph graph;
+
+        context.Measure([&]()
+        {
+            graph.Clear();
+            RenderGraphResource scene = graph.ImportTexture("Scene", desc);
+            RenderGraphResource output = graph.ImportTexture("Output", outputDesc);
+            graph.MarkOutput(output);
+
+            PostProcessChainOptions options;
+            if (autoExposure)
+            {
+                options.exposure = graph.ImportTexture("Adapted Luminance", RenderGraphTextureDesc(1, 1, RenderGraphFormat::R32F));
+            }
+
+            PostProcessChain::Build(graph, effects, scene, output, desc, options);
+            graph.Compile();
+            DoNotOptimize(graph.GetSchedule().data());
+        });
+
+        const RenderGraphStats& stats = graph.GetStats();
+        context.SetItemsPerIteration(stats.passCount);
+        context.SetCounter("passes", stats.passCount);
+        context.SetCounter("transients", stats.transientCount);
+        context.SetCounter("physical", stats.physicalCount);
+        context.SetCounter("transientMB", stats.transientBytes / MEGABYTE);
+        context.SetCounter("peakTransientMB", stats.peakTransientBytes / MEGABYTE);
+        context.SetCounter("peakLiveMB", stats.peakLiveBytes / MEGABYTE);
+    }
+
+    BenchmarkRegistration s_grayscaleVignette("RenderGraph/GrayscaleVignette", { 720, 1080 }, [](BenchmarkContext& context)
+    {
+        CompileChain(context, { PostProcessEffect::Grayscale, PostProcessEffect::Vignette });
+    });
+
+    BenchmarkRegistration s_bloomToneMapping("RenderGraph/BloomToneMappingVignette", { 720, 1080 }, [](BenchmarkContext& context)
+    {
+        CompileChain(context, { PostProcessEffect::Bloom, PostProcessEffect::ToneMapping, PostProcessEffect::Vignette });
+    });
+
+    // The same chain in HDR with auto-exposure: one more pass for the
+    // histogram, and R11G11B10F intermediates the size of RGBA8 ones
+    BenchmarkRegistration s_hdrAutoExposure("RenderGraph/HdrAutoExposure", { 720, 1080 }, [](BenchmarkContext& context)
+    {
+        CompileChain(context, { PostProcessEffect::Bloom, PostProcessEffect::ToneMapping, PostProcessEffect::Vignette },
+                     RenderGraphFormat::R11G11B10F, true);
+    });
+
+    // Every implemented effect; full-resolution intermediates still fit in
+    // two physical textures, plus the blur half-resolution target and the
+    // bloom pyramid
+    BenchmarkRegistration s_longChain("RenderGraph/LongChain", { 720, 1080, 2160 }, [](BenchmarkContext& context)
+    {
+        CompileChain(context, { PostProcessEffect::Grayscale, PostProcessEffect::Blur, PostProcessEffect::Bloom,
+                                PostProcessEffect::GaussianBlur, PostProcessEffect::ToneMapping, PostProcessEffect::Vignette });
+    });
+}
@@ -0,0 +1,250 @@
+#include "Benchmark.h"
+#include "Datasets.h"
+#include "../Graphics/DrawBatching.h"
+#include "../Graphics/RenderCommandList.h"
+#include "../Graphics/SliceRecorder.h"
+
+// The CPU side of RenderQueue: batching the frame's draws, then recording the
+// sorted batches, the work ParallelCommandRecorder spreads over threads.
+//
+// "BuildBatches" merges draws of a scene with DRAW_KINDS mesh and material
+// pairs; the counters show the draw calls falling from one per submitted
+// draw to one per batch. "RecordUnbatched" records one draw per item, in
+// submission order, with a material change wherever it differs from the
+// previous draw; "RecordBatched" builds the batches and records them. The
+// two times are the CPU cost of a frame's draws without and with batching,
+// up to the device: the driver's cost per draw call and per material change
+// comes on top and scales with the draws and materialChanges counters. The
+// argument is the draw count.
+//
+// "Immediate" records every batch on the calling thread; "Slices" runs the
+// SliceRecorder of ParallelCommandRecorder, whose threads each record a
+// contiguous slice into their own RenderCommandList, and walks the lists in
+// slice order, as the CommandLists mode does. Both record through
+// RenderCommandList::RecordBatches, the loop the recorder uses. The argument
+// is the thread count. Deferred contexts need a device and are not measured
+// here; their recording loop is the same per batch.
+
+namespace
+{
+    const size_t BATCH_COUNT = 20000;
+    const size_t BATCHES_PER_MATERIAL = 8;
+
+    const uint32_t DRAW_MESHES = 64;
+    const uint32_t DRAW_MATERIALS = 8;
+    const uint32_t DRAW_KINDS = DRAW_MESHES * DRAW_MATERIALS;
+
+    // Meshes and materials are recorded and batched by pointer, never
+    // dereferenced; handles provides distinct addresses for them
+    std::vector<DrawBatch> CreateBatches(std::vector<char>& handles)
+    {
+        size_t materialCount = (BATCH_COUNT + BATCHES_PER_MATERIAL - 1) / BATCHES_PER_MATERIAL;
+        handles.assign(BATCH_COUNT + materialCount, 0);
+
+        std::vector<DrawBatch> batches(BATCH_COUNT);
+        uint32_t firstInstance = 0;
+        for (size_t i = 0; i < BATCH_COUNT; ++i)
+        {
+            batches[i].mesh = reinterpret_cast<Mesh*>(&handles[i]);
+            batches[i].material = reinterpret_cast<Material*>(&handles[BATCH_COUNT + i / BATCHES_PER_MATERIAL]);
+            batches[i].firstInstance = firstInstance;
+            batches[i].instanceCount = 1 + static_cast<uint32_t>(i % 4);
+            firstInstance += batches[i].instanceCount;
+        }
+        return batches;
+    }
+
+    // Draws of DRAW_KINDS mesh and material pairs in scene order, which
+    // interleaves them
+    std::vector<DrawItem> CreateDrawItems(size_t count, std::vector<char>& handles)
+    {
+        handles.assign(DRAW_MESHES + DRAW_MATERIALS, 0);
+        Datasets::Random random(51);
+
+        std::vector<DrawItem> items(count);
+        for (size_t i = 0; i < count; ++i)
+        {
+            uint32_t kind = random.NextUInt() % DRAW_KINDS;
+            items[i].mesh = reinterpret_cast<Mesh*>(&handles[kind % DRAW_MESHES]);
+            items[i].material = reinterpret_cast<Material*>(&handles[DRAW_MESHES + kind / DRAW_MESHES]);
+            XMStoreFloat4x4(&items[i].world, XMMatrixTranslation(static_cast<float>(i), 0.0f, 0.0f));
+        }
+        return items;
+    }
+
+    // Device-free stand-in for Execute: reads every command in submission order
+    uint64_t WalkCommands(const RenderCommandList& commandList)
+    {
+        uint64_t instances = 0;
+        for (const RenderCommand& command : commandList.GetCommands())
+        {
+            instances += command.instanceCount;
+        }
+        return instances;
+    }
+
+    int CountMaterialChanges(const RenderCommandList& commandList)
+    {
+        int changes = 0;
+        for (const RenderCommand& command : commandList.GetCommands())
+        {
+            changes += (command.type == RenderCommandType::SetMaterial) ? 1 : 0;
+        }
+        return changes;
+    }
+
+    BenchmarkRegistration s_buildBatches("RenderQueue/BuildBatches", { 1000, 10000, 100000 }, [](BenchmarkContext& context)
+    {
+        std::vector<char> handles;
+        std::vector<DrawItem> items = CreateDrawItems(static_cast<size_t>(context.GetArgument()), handles);
+        std::vector<DrawBatch> batches;
+        std::vector<InstanceData> instanceData;
+        DrawBatcher batcher;
+
+        context.Measure([&]()
+        {
+            batcher.Build(items, batches, instanceData);
+            DoNotOptimize(instanceData.data());
+        });
+
+        // One draw call per batch instead of one per item, and one material
+        // change per material instead of one per change of material in
+        // submission order
+        int unbatchedMaterialChanges = 0;
+        for (size_t i = 0; i < items.size(); ++i)
+        {
+            unbatchedMaterialChanges += (i == 0 || items[i].material != items[i - 1].material) ? 1 : 0;
+        }
+        int materialChanges = 0;
+        for (size_t i = 0; i < batches.size(); ++i)
+        {
+            materialChanges += (i == 0 || batches[i].material != batches[i - 1].material) ? 1 : 0;
+        }
+
+        context.SetItemsPerIteration(items.size());
+        context.SetCounter("unbatchedDraws", static_cast<double>(items.size()));
+        context.SetCounter("draws", static_cast<double>(batches.size()));
+        context.SetCounter("unbatchedMaterialChanges", unbatchedMaterialChanges);
+        context.SetCounter("materialChanges", materialChanges);
+    });
+
+    BenchmarkRegistration s_recordUnbatched("RenderQueue/RecordUnbatched", { 1000, 10000, 100000 }, [](BenchmarkContext& context)
+    {
+        std::vector<char> handles;
+        std::vector<DrawItem> items = CreateDrawItems(static_cast<size_t>(context.GetArgument()), handles);
+        std::vector<InstanceData> instanceData(items.size());
+        RenderCommandList commandList;
+
+        context.Measure([&]()
+        {
+            commandList.Reset();
+            commandList.SetFrameBuffer(nullptr);
+
+            // Each draw carries its own world matrix
+            Material* currentMaterial = nullptr;
+            for (size_t i = 0; i < items.size(); ++i)
+            {
+                const DrawItem& item = items[i];
+                instanceData[i].world = item.world;
+                if (item.material != currentMaterial)
+                {
+                    commandList.SetMaterial(item.material);
+                    currentMaterial = item.material;
+                }
+                commandList.DrawInstanced(item.mesh, nullptr, sizeof(InstanceData), static_cast<uint32_t>(i), 1);
+            }
+            DoNotOptimize(WalkCommands(commandList));
+        });
+
+        context.SetItemsPerIteration(items.size());
+        context.SetCounter("draws", commandList.GetDrawCount());
+        context.SetCounter("materialChanges", CountMaterialChanges(commandList));
+        context.SetCounter("commands", commandList.GetCommandCount());
+    });
+
+    BenchmarkRegistration s_recordBatched("RenderQueue/RecordBatched", { 1000, 10000, 100000 }, [](BenchmarkContext& context)
+    {
+        std::vector<char> handles;
+        std::vector<DrawItem> items = CreateDrawItems(static_cast<size_t>(context.GetArgument()), handles);
+        std::vector<DrawBatch> batches;
+        std::vector<InstanceData> instanceData;
+        DrawBatcher batcher;
+        RenderCommandList commandList;
+
+        context.Measure([&]()
+        {
+            batcher.Build(items, batches, instanceData);
+            commandList.RecordBatches(batches, 0, batches.size(), nullptr, sizeof(InstanceData), nullptr);
+            DoNotOptimize(WalkCommands(commandList));
+        });
+
+        context.SetItemsPerIteration(items.size());
+        context.SetCounter("draws", commandList.GetDrawCount());
+        context.SetCounter("materialChanges", CountMaterialChanges(commandList));
+        context.SetCounter("commands", commandList.GetCommandCount());
+    });
+
+    BenchmarkRegistration s_recordImmediate("RenderQueue/RecordImmediate", { 1 }, [](BenchmarkContext& context)
+    {
+        std::vector<char> handles;
+        std::vector<DrawBatch> batches = CreateBatches(handles);
+        RenderCommandList commandList;
+
+        context.Measure([&]()
+        {
+            commandList.RecordBatches(batches, 0, batches.size(), nullptr, sizeof(InstanceData), nullptr);
+            DoNotOptimize(WalkCommands(commandList));
+        });
+
+        context.SetItemsPerIteration(batches.size());
+        context.SetCounter("threads", 1.0);
+        context.SetCounter("draws", commandList.GetDrawCount());
+        context.SetCounter("commands", commandList.GetCommandCount());
+    });
+
+    BenchmarkRegistration s_recordSlices("RenderQueue/RecordSlices", { 1, 2, 4, 8 }, [](BenchmarkContext& context)
+    {
+        // The calling thread records a slice too
+        int threadCount = static_cast<int>(context.GetArgument());
+        SliceRecorder sliceRecorder;
+        sliceRecorder.Initialize(threadCount - 1);
+
+        std::vector<char> handles;
+        std::vector<DrawBatch> batches = CreateBatches(handles);
+        std::vector<RenderCommandList> commandLists(threadCount);
+
+        // What ParallelCommandRecorder does per slice in the CommandLists mode
+        SliceRecorder::RecordFunction recordFunction = [&](int sliceIndex, size_t firstBatch, size_t batchCount)
+        {
+            commandLists[sliceIndex].RecordBatches(batches, firstBatch, firstBatch + batchCount,
+                                                   nullptr, sizeof(InstanceData), nullptr);
+        };
+
+        int sliceCount = 0;
+        context.Measure([&]()
+        {
+            sliceCount = sliceRecorder.Record(batches.size(), recordFunction);
+
+            uint64_t instances = 0;
+            for (int i = 0; i < sliceCount; ++i)
+            {
+                instances += WalkCommands(commandLists[i]);
+            }
+            DoNotOptimize(instances);
+        });
+
+        int draws = 0;
+        int commands = 0;
+        for (int i = 0; i < sliceCount; ++i)
+        {
+            draws += commandLists[i].GetDrawCount();
+            commands += commandLists[i].GetCommandCount();
+        }
+
+        context.SetItemsPerIteration(batches.size());
+        context.SetCounter("threads", static_cast<double>(sliceCount));
+        context.SetCounter("draws", draws);
+        context.SetCounter("commands", commands);
+        sliceRecorder.Shutdown();
+    });
+}
@@ -0,0 +1,158 @@
+#include "Benchmark.h"
+#include "Datasets.h"
+#include "../Engine/SceneGraph.h"
+#include "../Engine/JobSystem.h"
+#include "../Graphics/TransformKernels.h"
+#include <cstring>
+
+// Transform propagation and per-object constant generation. The argument is
+// the node / object count.
+
+namespace
+{
+    // Balanced forest: 64 roots, every node gets up to 8 children
+    void CreateScene(size_t nodeCount, SceneGraph& scene, std::vector<SceneNodeHandle>& nodes)
+    {
+        Datasets::Random random(99);
+        nodes.clear();
+        nodes.reserve(nodeCount);
+
+        for (size_t i = 0; i < nodeCount; ++i)
+        {
+            SceneNodeHandle parent = i < 64 ? INVALID_SCENE_NODE : nodes[(i - 64) / 8];
+            SceneNodeHandle node = scene.CreateNode(parent);
+            scene.SetLocalPosition(node, XMFLOAT3(random.NextFloat(-10.0f, 10.0f), random.NextFloat(-10.0f, 10.0f), random.NextFloat(-10.0f, 10.0f)));
+            scene.SetLocalRotation(node, random.NextFloat(0.0f, XM_2PI), random.NextFloat(0.0f, XM_2PI), 0.0f);
+            scene.SetLocalBounds(node, XMFLOAT3(0.0f, 0.0f, 0.0f), XMFLOAT3(1.0f, 1.0f, 1.0f));
+            nodes.push_back(node);
+        }
+
+        scene.UpdateTransforms();
+    }
+
+    // Moves changePercent of the nodes, spread evenly, then updates
+    void RunSceneUpdate(BenchmarkContext& context, size_t changePercent, JobSystem* jobSystem)
+    {
+        SceneGraph scene;
+        std::vector<SceneNodeHandle> nodes;
+        CreateScene(static_cast<size_t>(context.GetArgument()), scene, nodes);
+
+        if (jobSystem)
+        {
+            scene.SetParallelForFunction(jobSystem->GetParallelForFunction(256));
+        }
+
+        size_t changedCount = nodes.size() * changePercent / 100;
+        changedCount = changedCount > 0 ? changedCount : 1;
+        size_t stride = nodes.size() / changedCount;
+        int frame = 0;
+
+        context.Measure([&]()
+        {
+            float angle = static_cast<float>(frame++) * 0.01f;
+            for (size_t i = 0; i < changedCount; ++i)
+            {
+                scene.SetLocalRotation(nodes[i * stride], angle, 0.0f, 0.0f);
+            }
+            scene.UpdateTransforms();
+            DoNotOptimize(scene.GetWorldMatrices().data());
+        });
+
+        context.SetItemsPerIteration(nodes.size());
+        context.SetCounter("updatedNodes", scene.GetStats().updatedNodes);
+        context.SetCounter("levels", scene.GetStats().levelCount);
+    }
+
+    BenchmarkRegistration s_sceneUpdateSparse("SceneGraph/Update1Percent", { 10000, 100000 }, [](BenchmarkContext& context)
+    {
+        RunSceneUpdate(context, 1, nullptr);
+    });
+
+    BenchmarkRegistration s_sceneUpdateAll("SceneGraph/UpdateAll", { 10000, 100000 }, [](BenchmarkContext& context)
+    {
+        RunSceneUpdate(context, 100, nullptr);
+    });
+
+    BenchmarkRegistration s_sceneUpdateParallel("SceneGraph/UpdateAllParallel", { 10000, 100000 }, [](BenchmarkContext& context)
+    {
+        JobSystem jobSystem;
+        jobSystem.Initialize();
+        RunSceneUpdate(context, 100, &jobSystem);
+        jobSystem.Shutdown();
+    });
+
+    void CreateWorldMatrices(size_t count, std::vector<XMFLOAT4X4>& worldMatrices)
+    {
+        Datasets::Random random(7);
+        worldMatrices.resize(count);
+        for (size_t i = 0; i < count; ++i)
+        {
+            XMMATRIX world = XMMatrixRotationRollPitchYaw(random.NextFloat(0.0f, XM_2PI), random.NextFloat(0.0f, XM_2PI), 0.0f) *
+                             XMMatrixTranslation(random.NextFloat(-100.0f, 100.0f), random.NextFloat(-100.0f, 100.0f), random.NextFloat(-100.0f, 100.0f));
+            XMStoreFloat4x4(&worldMatrices[i], world);
+        }
+    }
+
+    // The per-draw constant buffer of the old Renderer::RenderTriangle
+    struct LegacyConstantBuffer
+    {
+        XMMATRIX world;
+        XMMATRIX view;
+        XMMATRIX projection;
+    };
+
+    // What the renderer does now: every object's transposed world * view *
+    // projection in one pass, then a 64-byte copy into the mapped constant
+    // buffer per draw. The mapped buffer is a stand-in that stays in cache.
+    BenchmarkRegistration s_worldViewProjection("Transforms/WorldViewProjection", { 1000, 10000, 100000 }, [](BenchmarkContext& context)
+    {
+        std::vector<XMFLOAT4X4> worldMatrices;
+        CreateWorldMatrices(static_cast<size_t>(context.GetArgument()), worldMatrices);
+        std::vector<XMFLOAT4X4> constants(worldMatrices.size());
+        XMMATRIX viewProjection = Datasets::CreateViewProjection(1000.0f);
+        XMFLOAT4X4 mapped;
+
+        context.Measure([&]()
+        {
+            TransformKernels::ComputeWorldViewProjection(worldMatrices.data(), worldMatrices.size(), viewProjection, constants.data());
+            for (const XMFLOAT4X4& objectConstants : constants)
+            {
+                memcpy(&mapped, &objectConstants, sizeof(XMFLOAT4X4));
+                DoNotOptimize(mapped);
+            }
+        });
+
+        context.SetItemsPerIteration(worldMatrices.size());
+        context.SetCounter("uploadBytesPerObject", sizeof(XMFLOAT4X4));
+    });
+
+    // Reference: the constant fill of the old RenderTriangle, which wrote
+    // the transposed world, view and projection (192 bytes) into the mapped
+    // buffer on every draw and left the multiplies to the vertex shader
+    BenchmarkRegistration s_legacyConstants("Transforms/LegacyPerDrawConstants", { 1000, 10000, 100000 }, [](BenchmarkContext& context)
+    {
+        std::vector<XMFLOAT4X4> worldMatrices;
+        CreateWorldMatrices(static_cast<size_t>(context.GetArgument()), worldMatrices);
+
+        XMMATRIX viewMatrix = XMMatrixLookAtLH(XMVectorSet(0.0f, 0.0f, 0.0f, 1.0f),
+                                               XMVectorSet(0.0f, 0.0f, 1.0f, 1.0f),
+                                               XMVectorSet(0.0f, 1.0f, 0.0f, 0.0f));
+        XMMATRIX projectionMatrix = XMMatrixPerspectiveFovLH(XM_PI / 3.0f, 16.0f / 9.0f, 0.1f, 1000.0f);
+        LegacyConstantBuffer mapped;
+
+        context.Measure([&]()
+        {
+            for (const XMFLOAT4X4& world : worldMatrices)
+            {
+                XMMATRIX worldMatrix = XMLoadFloat4x4(&world);
+                mapped.world = XMMatrixTranspose(worldMatrix);
+                mapped.view = XMMatrixTranspose(viewMatrix);
+                mapped.projection = XMMatrixTranspose(projectionMatrix);
+                DoNotOptimize(mapped);
+            }
+        });
+
+        context.SetItemsPerIteration(worldMatrices.size());
+        context.SetCounter("uploadBytesPerObject", sizeof(LegacyConstantBuffer));
+    });
+}
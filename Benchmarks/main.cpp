@@ -0,0 +1,175 @@
+#include "Benchmark.h"
+#include <iostream>
+#include <string>
+#include <vector>
+#include <map>
+#include <ctime>
+#include <thread>
+#include <algorithm>
+#include <cstdlib>
+
+// Benchmark runner.
+//
+//   benchmarks [--filter text] [--json file] [--csv file] [--baseline file.csv]
+//              [--samples n] [--min-time seconds] [--max-argument n] [--quick]
+//              [--label text] [--list]
+//
+// --filter keeps cases whose "Name/argument" key contains the text.
+// --baseline prints the median change against a CSV written by an earlier run.
+// --quick runs 3 short samples and skips arguments above 100000.
+
+namespace
+{
+    void PrintUsage()
+    {
+        std::cout << "Usage: benchmarks [--filter text] [--json file] [--csv file] [--baseline file.csv]\n"
+                  << "                  [--samples n] [--min-time seconds] [--max-argument n] [--quick]\n"
+                  << "                  [--label text] [--list]" << std::endl;
+    }
+
+    std::string GetCompiler()
+    {
+#if defined(__clang__)
+        return "clang " __clang_version__;
+#elif defined(__GNUC__)
+        return "gcc " __VERSION__;
+#elif defined(_MSC_VER)
+        return "msvc " + std::to_string(_MSC_VER);
+#else
+        return "unknown";
+#endif
+    }
+
+    std::string GetTimestamp()
+    {
+        std::time_t now = std::time(nullptr);
+        char buffer[32] = {};
+        std::strftime(buffer, sizeof(buffer), "%Y-%m-%dT%H:%M:%SZ", std::gmtime(&now));
+        return buffer;
+    }
+}
+
+int main(int argc, char* argv[])
+{
+    BenchmarkSettings settings;
+    std::string filter;
+    std::string jsonPath;
+    std::string csvPath;
+    std::string baselinePath;
+    std::string label;
+    bool listOnly = false;
+
+    for (int i = 1; i < argc; ++i)
+    {
+        std::string argument = argv[i];
+        bool hasValue = i + 1 < argc;
+
+        if (argument == "--filter" && hasValue)
+            filter = argv[++i];
+        else if (argument == "--json" && hasValue)
+            jsonPath = argv[++i];
+        else if (argument == "--csv" && hasValue)
+            csvPath = argv[++i];
+        else if (argument == "--baseline" && hasValue)
+            baselinePath = argv[++i];
+        else if (argument == "--label" && hasValue)
+            label = argv[++i];
+        else if (argument == "--samples" && hasValue)
+            settings.samples = std::max(1, std::atoi(argv[++i]));
+        else if (argument == "--min-time" && hasValue)
+            settings.minSampleSeconds = std::atof(argv[++i]);
+        else if (argument == "--max-argument" && hasValue)
+            settings.maxArgument = std::atoll(argv[++i]);
+        else if (argument == "--quick")
+        {
+            settings.samples = 3;
+            settings.minSampleSeconds = 0.005;
+            settings.maxArgument = 100000;
+        }
+        else if (argument == "--list")
+            listOnly = true;
+        else
+        {
+            PrintUsage();
+            return argument == "--help" ? 0 : 1;
+        }
+    }
+
+    std::map<std::string, BenchmarkResult> baseline;
+    if (!baselinePath.empty())
+    {
+        std::vector<BenchmarkResult> baselineResults;
+        if (!BenchmarkReport::ReadCSV(baselinePath, baselineResults))
+        {
+            return 1;
+        }
+        for (const BenchmarkResult& result : baselineResults)
+        {
+            baseline[result.GetKey()] = result;
+        }
+    }
+
+    std::vector<BenchmarkResult> results;
+    for (const BenchmarkDefinition& definition : BenchmarkRegistry::GetBenchmarks())
+    {
+        for (int64_t argument : definition.arguments)
+        {
+            std::string key = definition.name + "/" + std::to_string(argument);
+            if (!filter.empty() && key.find(filter) == std::string::npos)
+                continue;
+            if (settings.maxArgument > 0 && argument > settings.maxArgument)
+                continue;
+
+            if (listOnly)
+            {
+                std::cout << key << std::endl;
+                continue;
+            }
+
+            BenchmarkContext context(argument, settings);
+            definition.function(context);
+            if (!context.HasMeasured())
+            {
+                std::cerr << "Benchmarks: " << key << " did not call Measure" << std::endl;
+                continue;
+            }
+
+            BenchmarkResult result = context.GetResult(definition.name);
+            auto found = baseline.find(key);
+            BenchmarkReport::PrintResult(result, found != baseline.end() ? &found->second : nullptr);
+            results.push_back(result);
+        }
+    }
+
+    if (listOnly)
+    {
+        return 0;
+    }
+
+    std::map<std::string, std::string> metadata;
+    metadata["compiler"] = GetCompiler();
+#if defined(NDEBUG)
+    metadata["build"] = "release";
+#else
+    metadata["build"] = "debug";
+#endif
+    metadata["hardware_threads"] = std::to_string(std::thread::hardware_concurrency());
+    metadata["timestamp"] = GetTimestamp();
+    metadata["samples"] = std::to_string(settings.samples);
+    if (!label.empty())
+    {
+        metadata["label"] = label;
+    }
+
+    bool success = true;
+    if (!jsonPath.empty())
+    {
+        success = BenchmarkReport::WriteJSON(jsonPath, results, metadata) && success;
+    }
+    if (!csvPath.empty())
+    {
+        success = BenchmarkReport::WriteCSV(csvPath, results) && success;
+    }
+
+    return success ? 0 : 1;
+}
@@ -21,6 +21,8 @@ Camera::Camera()
     , m_fieldOfView(XM_PIDIV4)
     , m_nearPlane(0.1f)
     , m_farPlane(1000.0f)
+    , m_screenWidth(1.0f)
+    , m_screenHeight(1.0f)
 {
     m_viewMatrix = XMMatrixIdentity();
     m_projectionMatrix = XMMatrixIdentity();
@@ -32,6 +34,9 @@ Camera::~Camera()
 
 void Camera::Initialize(float screenWidth, float screenHeight)
 {
+    m_screenWidth = screenWidth;
+    m_screenHeight = screenHeight;
+
     // Create projection matrix
     float aspectRatio = screenWidth / screenHeight;
     m_projectionMatrix = XMMatrixPerspectiveFovLH(m_fieldOfView, aspectRatio, m_nearPlane, m_farPlane);
@@ -273,3 +278,27 @@ void Camera::UpdateViewMatrix()
         m_viewMatrix = XMMatrixLookAtLH(position, lookAt, up);
     }
 }
+
+void Camera::ScreenPointToRay(float screenX, float screenY, XMFLOAT3& origin, XMFLOAT3& direction) const
+{
+    XMMATRIX world = XMMatrixIdentity();
+
+    XMVECTOR nearPoint = XMVector3Unproject(XMVectorSet(screenX, screenY, 0.0f, 1.0f),
+                                            0.0f, 0.0f, m_screenWidth, m_screenHeight, 0.0f, 1.0f,
+                                            m_projectionMatrix, m_viewMatrix, world);
+    XMVECTOR farPoint = XMVector3Unproject(XMVectorSet(screenX, screenY, 1.0f, 1.0f),
+                                           0.0f, 0.0f, m_screenWidth, m_screenHeight, 0.0f, 1.0f,
+                                           m_projectionMatrix, m_viewMatrix, world);
+
+    XMStoreFloat3(&origin, nearPoint);
+    XMStoreFloat3(&direction, XMVector3Normalize(XMVectorSubtract(farPoint, nearPoint)));
+}
+
+bool Camera::Pick(const BoundingVolumeHierarchy& scene, float screenX, float screenY, BVHRayHit& hit) const
+{
+    XMFLOAT3 origin;
+    XMFLOAT3 direction;
+    ScreenPointToRay(screenX, screenY, origin, direction);
+
+    return scene.RayCast(origin, direction, m_farPlane, hit);
+}
@@ -1,6 +1,8 @@
 #pragma once
 
 #include <DirectXMath.h>
+#include "../Graphics/FrustumCulling.h"
+#include "../Graphics/BoundingVolumeHierarchy.h"
 
 using namespace DirectX;
 
@@ -45,6 +47,13 @@ public:
     XMMATRIX GetViewMatrix() const { return m_viewMatrix; }
     XMMATRIX GetProjectionMatrix() const { return m_projectionMatrix; }
 
+    // World-space frustum planes of the current view and projection
+    Frustum GetFrustum() const { return Frustum::FromViewProjection(XMMatrixMultiply(m_viewMatrix, m_projectionMatrix)); }
+
+    // Picking: world-space ray through a pixel (origin on the near plane, unit direction)
+    void ScreenPointToRay(float screenX, float screenY, XMFLOAT3& origin, XMFLOAT3& direction) const;
+    bool Pick(const BoundingVolumeHierarchy& scene, float screenX, float screenY, BVHRayHit& hit) const;
+
     // Position and rotation getters
     XMFLOAT3 GetPosition() const { return m_position; }
     XMFLOAT3 GetRotation() const { return m_rotation; }
@@ -86,4 +95,6 @@ private:
     float m_fieldOfView;
     float m_nearPlane;
     float m_farPlane;
+    float m_screenWidth;
+    float m_screenHeight;
 };
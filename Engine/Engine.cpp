@@ -2,6 +2,8 @@
 #include "Camera.h"
 #include "Renderer.h"
 #include "GameLoop.h"
+#include "Profiler.h"
+#include "../Graphics/ModelLoader.h"
 #include <iostream>
 #include <cstring>
 #include <chrono>
@@ -13,6 +15,7 @@ Engine::Engine()
     , m_screenWidth(0)
     , m_screenHeight(0)
     , m_isRunning(false)
+    , m_targetUPS(60)
     , m_device(nullptr)
     , m_deviceContext(nullptr)
     , m_swapChain(nullptr)
@@ -26,8 +29,15 @@ Engine::Engine()
     , m_lastMouseX(0)
     , m_lastMouseY(0)
     , m_isMouseCaptured(false)
+    , m_pendingWheelDelta(0)
+    , m_asyncUploadBudgetMs(2.0f)
+    , m_memoryReportInterval(0.0)
+    , m_memoryReportTimer(0.0)
+    , m_simulationTick(0)
     , m_cubeRotationAngle(0.0f)
     , m_triangleRotationAngle(0.0f)
+    , m_triangleNode(INVALID_SCENE_NODE)
+    , m_cubeNode(INVALID_SCENE_NODE)
 {
     g_Engine = this;
 
@@ -72,6 +82,31 @@ bool Engine::Initialize(HINSTANCE hInstance, int width, int height, const std::w
         return false;
     }
 
+#if ENGINE_PROFILER_ENABLED
+    // Zones are kept in per-thread rings, so capture can stay on for the whole run
+    PROFILE_THREAD_NAME("Main");
+    Profiler::StartCapture();
+#endif
+
+    // Worker threads for parallel engine work; the main thread joins in while waiting
+    m_jobSystem = std::make_unique<JobSystem>();
+    m_jobSystem->Initialize();
+
+    // Async model loads run their CPU stages on the job system
+    m_modelLoader = std::make_unique<ModelLoader>();
+    m_modelLoader->SetParallelForFunction(m_jobSystem->GetParallelForFunction());
+
+    // Scene objects (triangle to the left, cube to the right)
+    m_scene = std::make_unique<SceneGraph>();
+    m_scene->SetParallelForFunction(m_jobSystem->GetParallelForFunction());
+    m_triangleNode = m_scene->CreateNode();
+    m_scene->SetLocalPosition(m_triangleNode, XMFLOAT3(-3.0f, 0.0f, 0.0f));
+    m_cubeNode = m_scene->CreateNode();
+    m_scene->SetLocalPosition(m_cubeNode, XMFLOAT3(3.0f, 0.0f, 0.0f));
+
+    m_simulatedNodes = { m_triangleNode, m_cubeNode };
+    m_simulationState.Resize(m_simulatedNodes.size());
+
     m_isRunning = true;
     return true;
 }
@@ -308,10 +343,12 @@ void Engine::Run()
     // Initialize timing for manual game loop
     auto lastTime = std::chrono::high_resolution_clock::now();
     std::chrono::duration<double> accumulator(0.0);
-    const std::chrono::duration<double> fixedTimestep(1.0 / 60.0); // 60 UPS
 
     while (m_isRunning)
     {
+        // Read every frame: starting a replay may change the update rate
+        const std::chrono::duration<double> fixedTimestep(1.0 / m_targetUPS);
+
         // Handle Windows messages (non-blocking)
         while (PeekMessage(&msg, nullptr, 0, 0, PM_REMOVE))
         {
@@ -344,18 +381,31 @@ void Engine::Run()
         // Fixed timestep updates
         while (accumulator >= fixedTimestep)
         {
-            UpdateGame(static_cast<float>(fixedTimestep.count()));
+            UpdateGame(GetFixedDeltaTime());
             accumulator -= fixedTimestep;
         }
 
         // Render with interpolation
         float interpolation = static_cast<float>(accumulator / fixedTimestep);
         RenderFrame(interpolation);
+
+        // Periodic memory dump
+        if (m_memoryReportInterval > 0.0)
+        {
+            m_memoryReportTimer += std::chrono::duration<double>(frameTime).count();
+            if (m_memoryReportTimer >= m_memoryReportInterval)
+            {
+                m_memoryReportTimer = 0.0;
+                Memory::PrintReport();
+            }
+        }
     }
 }
 
 void Engine::ProcessInput()
 {
+    PROFILE_FUNCTION();
+
     // Update key states
     for (int i = 0; i < 256; ++i)
     {
@@ -377,37 +427,58 @@ void Engine::ProcessInput()
 
 void Engine::UpdateGame(float deltaTime)
 {
+    PROFILE_FUNCTION();
+
+    // Everything below reads input only through m_tickInput, so a replayed
+    // log drives the simulation exactly like the live session did
+    m_previousTickInput = m_tickInput;
+    if (m_inputReplayer)
+    {
+        if (!m_inputReplayer->NextTick(m_tickInput))
+        {
+            FinishInputReplay();
+            return;
+        }
+    }
+    else
+    {
+        SampleTickInput(m_tickInput);
+    }
+
+    const InputFrame& input = m_tickInput;
+
     // Update camera based on input state
     if (m_camera)
     {
         m_camera->Update(deltaTime);
 
         // Camera movement
-        if (m_keys['W'])
+        if (input.IsKeyDown('W'))
             m_camera->MoveForward(deltaTime);
-        if (m_keys['S'])
+        if (input.IsKeyDown('S'))
             m_camera->MoveBackward(deltaTime);
-        if (m_keys['A'])
+        if (input.IsKeyDown('A'))
             m_camera->MoveLeft(deltaTime);
-        if (m_keys['D'])
+        if (input.IsKeyDown('D'))
             m_camera->MoveRight(deltaTime);
-        if (m_keys['Q'])
+        if (input.IsKeyDown('Q'))
             m_camera->MoveUp(deltaTime);
-        if (m_keys['E'])
+        if (input.IsKeyDown('E'))
             m_camera->MoveDown(deltaTime);
 
         // Mouse look
-        if (m_isMouseCaptured)
+        if (input.mouseCaptured)
         {
-            int deltaX = m_mouseX - m_lastMouseX;
-            int deltaY = m_mouseY - m_lastMouseY;
-
             // Different sensitivity for different camera modes
             float sensitivity = (m_camera->GetCameraMode() == CameraMode::ThirdPerson) ? 0.01f : 0.005f;
-            m_camera->Rotate(static_cast<float>(deltaX) * sensitivity, static_cast<float>(deltaY) * sensitivity);
+            m_camera->Rotate(static_cast<float>(input.mouseDeltaX) * sensitivity, static_cast<float>(input.mouseDeltaY) * sensitivity);
+        }
 
-            m_lastMouseX = m_mouseX;
-            m_lastMouseY = m_mouseY;
+        // Mouse wheel zooms in third person mode
+        if (input.wheelDelta != 0 && m_camera->GetCameraMode() == CameraMode::ThirdPerson)
+        {
+            float zoomDelta = static_cast<float>(input.wheelDelta) / 120.0f; // Standard wheel delta is 120
+            m_camera->ZoomToTarget(zoomDelta);
         }
     }
 
@@ -421,22 +492,45 @@ void Engine::UpdateGame(float deltaTime)
     if (m_cubeRotationAngle > 6.28318f)
         m_cubeRotationAngle -= 6.28318f;
 
-    // Camera mode switching with C key (simple toggle without debouncing for now)
-    static bool cKeyWasPressed = false;
-    if (m_keys['C'] && !cKeyWasPressed)
+    // Publish this tick's transforms; the renderer interpolates towards them
+    if (m_simulationState.Size() == 2)
+    {
+        XMFLOAT3 unitScale(1.0f, 1.0f, 1.0f);
+        XMFLOAT4 triangleRotation;
+        XMFLOAT4 cubeRotation;
+        XMStoreFloat4(&triangleRotation, XMQuaternionRotationRollPitchYaw(0.0f, m_triangleRotationAngle, 0.0f));
+        XMStoreFloat4(&cubeRotation, XMQuaternionRotationRollPitchYaw(m_cubeRotationAngle, m_cubeRotationAngle, 0.0f));
+
+        m_simulationState.Set(0, XMFLOAT3(-3.0f, 0.0f, 0.0f), triangleRotation, unitScale);
+        m_simulationState.Set(1, XMFLOAT3(3.0f, 0.0f, 0.0f), cubeRotation, unitScale);
+        m_snapshots.Publish(m_simulationState);
+    }
+
+    // Camera mode switching on the tick the C key goes down
+    if (m_camera && input.IsKeyDown('C') && !m_previousTickInput.IsKeyDown('C'))
     {
         if (m_camera->GetCameraMode() == CameraMode::FirstPerson)
             m_camera->SetCameraMode(CameraMode::ThirdPerson);
         else
             m_camera->SetCameraMode(CameraMode::FirstPerson);
-        cKeyWasPressed = true;
     }
-    else if (!m_keys['C'])
+
+    // Checksum after the tick: recorded with the input, compared on replay
+    if (m_inputRecorder || m_inputReplayer)
     {
-        cKeyWasPressed = false;
+        uint64_t checksum = ComputeSimulationChecksum();
+        if (m_inputRecorder)
+        {
+            m_inputRecorder->RecordTick(input, checksum);
+        }
+        if (m_inputReplayer)
+        {
+            m_inputReplayer->VerifyTick(checksum);
+        }
     }
+    m_simulationTick++;
 
-    // Check for exit condition
+    // Check for exit condition (live keyboard, so a replay can be aborted too)
     if (m_keys[VK_ESCAPE])
     {
         m_isRunning = false;
@@ -444,18 +538,170 @@ void Engine::UpdateGame(float deltaTime)
     }
 }
 
+void Engine::SampleTickInput(InputFrame& input)
+{
+    for (int i = 0; i < InputFrame::KEY_COUNT; ++i)
+    {
+        input.SetKey(i, m_keys[i]);
+    }
+
+    for (int i = 0; i < InputFrame::MOUSE_BUTTON_COUNT; ++i)
+    {
+        input.SetMouseButton(i, m_mouseButtons[i]);
+    }
+
+    // Movement since the previous tick, only while the left button holds the cursor
+    input.mouseCaptured = m_isMouseCaptured;
+    input.mouseDeltaX = 0;
+    input.mouseDeltaY = 0;
+    if (m_isMouseCaptured)
+    {
+        input.mouseDeltaX = m_mouseX - m_lastMouseX;
+        input.mouseDeltaY = m_mouseY - m_lastMouseY;
+        m_lastMouseX = m_mouseX;
+        m_lastMouseY = m_mouseY;
+    }
+
+    // Wheel messages arrive between ticks; hand them to the next tick
+    input.wheelDelta = m_pendingWheelDelta;
+    m_pendingWheelDelta = 0;
+}
+
+uint64_t Engine::ComputeSimulationChecksum() const
+{
+    StateChecksum checksum;
+    checksum.Add(m_simulationTick);
+    checksum.Add(m_triangleRotationAngle);
+    checksum.Add(m_cubeRotationAngle);
+
+    if (m_camera)
+    {
+        XMFLOAT3 position = m_camera->GetPosition();
+        XMFLOAT3 rotation = m_camera->GetRotation();
+        checksum.Add(&position, sizeof(position));
+        checksum.Add(&rotation, sizeof(rotation));
+        checksum.Add(static_cast<int32_t>(m_camera->GetCameraMode()));
+    }
+
+    for (size_t i = 0; i < m_simulationState.Size(); ++i)
+    {
+        checksum.Add(&m_simulationState.position[i], sizeof(XMFLOAT3));
+        checksum.Add(&m_simulationState.rotation[i], sizeof(XMFLOAT4));
+        checksum.Add(&m_simulationState.scale[i], sizeof(XMFLOAT3));
+    }
+
+    return checksum.GetValue();
+}
+
+bool Engine::StartInputRecording(const std::string& filepath)
+{
+    m_inputReplayer.reset();
+
+    m_inputRecorder = std::make_unique<InputRecorder>();
+    if (!m_inputRecorder->Open(filepath, GetFixedDeltaTime()))
+    {
+        m_inputRecorder.reset();
+        return false;
+    }
+
+    std::cout << "Engine: Recording input to " << filepath << std::endl;
+    return true;
+}
+
+bool Engine::StartInputReplay(const std::string& filepath)
+{
+    m_inputRecorder.reset();
+
+    m_inputReplayer = std::make_unique<InputReplayer>();
+    if (!m_inputReplayer->Open(filepath))
+    {
+        m_inputReplayer.reset();
+        return false;
+    }
+
+    // Ticks only repeat the recording at the step it was recorded with
+    int recordedUPS = m_inputReplayer->GetUpdatesPerSecond();
+    if (recordedUPS == 0)
+    {
+        std::cerr << "Engine: Input log " << filepath << " has a fixed step of "
+                  << m_inputReplayer->GetFixedDeltaTime() << " s, which no update rate reproduces" << std::endl;
+        m_inputReplayer.reset();
+        return false;
+    }
+    if (recordedUPS != m_targetUPS)
+    {
+        std::cout << "Engine: Switching from " << m_targetUPS << " to " << recordedUPS
+                  << " UPS to match the recording" << std::endl;
+        SetTargetUPS(recordedUPS);
+    }
+
+    // Replays must start from the same state the recording started from
+    if (m_simulationTick != 0)
+    {
+        std::cerr << "Engine: Input replay started after " << m_simulationTick
+                  << " ticks; checksums will not match" << std::endl;
+    }
+
+    std::cout << "Engine: Replaying input from " << filepath << std::endl;
+    return true;
+}
+
+void Engine::FinishInputReplay()
+{
+    if (m_inputReplayer->GetMismatchCount() == 0)
+    {
+        std::cout << "Engine: Replay of " << m_inputReplayer->GetTickCount()
+                  << " ticks matched every checksum" << std::endl;
+    }
+    else
+    {
+        std::cerr << "Engine: Replay diverged on " << m_inputReplayer->GetMismatchCount() << " of "
+                  << m_inputReplayer->GetTickCount() << " ticks, first at tick "
+                  << m_inputReplayer->GetFirstMismatchTick() << std::endl;
+    }
+
+    m_inputReplayer.reset();
+    m_isRunning = false;
+    PostQuitMessage(0);
+}
+
 void Engine::RenderFrame(float interpolation)
 {
+    PROFILE_FUNCTION();
+
+    // Everything allocated from the frame scratch last frame is dropped here
+    m_frameAllocator.BeginFrame();
+
+    // Time-sliced upload of models whose worker stages have finished
+    if (m_modelLoader)
+    {
+        m_modelLoader->UpdateAsyncLoads(m_device, m_asyncUploadBudgetMs);
+    }
+
     // Clear render target and depth buffer
     float clearColor[4] = { 0.2f, 0.3f, 0.4f, 1.0f };
     m_deviceContext->ClearRenderTargetView(m_renderTargetView, clearColor);
     m_deviceContext->ClearDepthStencilView(m_depthStencilView, D3D11_CLEAR_DEPTH, 1.0f, 0);
 
     // Render scene with interpolation
-    if (m_renderer && m_camera)
+    if (m_renderer && m_camera && m_scene)
     {
-        // Pass interpolated rotation angles to renderer
-        m_renderer->SetRotationAngles(m_triangleRotationAngle, m_cubeRotationAngle, interpolation);
+        // Interpolate between the last two fixed updates and apply to the scene
+        const TransformSnapshot* snapshot = m_snapshots.Acquire();
+        if (snapshot)
+        {
+            SnapshotInterpolation::InterpolateState(*snapshot, interpolation, m_renderState);
+            for (size_t i = 0; i < m_renderState.Size() && i < m_simulatedNodes.size(); ++i)
+            {
+                m_scene->SetLocalPosition(m_simulatedNodes[i], m_renderState.position[i]);
+                m_scene->SetLocalRotation(m_simulatedNodes[i], m_renderState.rotation[i]);
+                m_scene->SetLocalScale(m_simulatedNodes[i], m_renderState.scale[i]);
+            }
+        }
+
+        // Recompute world matrices of everything that moved since the last frame
+        m_scene->UpdateTransforms();
+        m_renderer->SetObjectTransforms(m_scene->GetWorldMatrix(m_triangleNode), m_scene->GetWorldMatrix(m_cubeNode));
 
         // Use different render method based on camera mode
         if (m_camera->GetCameraMode() == CameraMode::ThirdPerson)
@@ -474,8 +720,7 @@ void Engine::RenderFrame(float interpolation)
 
 void Engine::SetTargetUPS(int updatesPerSecond)
 {
-    // This would be used if we had the GameLoop class active
-    // For now, the fixed timestep is hardcoded to 60 UPS
+    m_targetUPS = updatesPerSecond > 0 ? updatesPerSecond : 1;
 }
 
 void Engine::SetTargetFPS(int framesPerSecond)
@@ -504,6 +749,17 @@ double Engine::GetFrameTime() const
     return m_gameLoop ? m_gameLoop->GetAverageFrameTime() : 0.0;
 }
 
+std::shared_ptr<ModelLoadRequest> Engine::LoadModelAsync(const std::string& filepath)
+{
+    if (!m_modelLoader || !m_jobSystem)
+    {
+        std::cerr << "Engine: LoadModelAsync called before Initialize" << std::endl;
+        return nullptr;
+    }
+
+    return m_modelLoader->LoadAsync(filepath, *m_jobSystem);
+}
+
 double Engine::GetUpdateTime() const
 {
     return m_gameLoop ? m_gameLoop->GetAverageUpdateTime() : 0.0;
@@ -511,6 +767,41 @@ double Engine::GetUpdateTime() const
 
 void Engine::Shutdown()
 {
+    // Pending loads hold jobs on the job system
+    if (m_modelLoader)
+    {
+        m_modelLoader->CancelAsyncLoads();
+        m_modelLoader.reset();
+    }
+
+    // Stop worker threads before the objects their jobs may touch go away
+    if (m_jobSystem)
+    {
+        m_jobSystem->Shutdown();
+    }
+
+    // Flush the input log; everything up to the last tick stays replayable
+    if (m_inputRecorder)
+    {
+        m_inputRecorder->Close();
+        m_inputRecorder.reset();
+    }
+    m_inputReplayer.reset();
+
+#if ENGINE_PROFILER_ENABLED
+    if (!m_profileTracePath.empty() && Profiler::IsCapturing())
+    {
+        Profiler::StopCapture();
+        Profiler::WriteChromeTrace(m_profileTracePath);
+    }
+#endif
+
+    // Memory summary once per run; Shutdown runs again from the destructor
+    if (m_device)
+    {
+        Memory::PrintReport();
+    }
+
     // Release DirectX objects
     if (m_rasterizerState)
     {
@@ -611,13 +902,8 @@ LRESULT Engine::MessageHandler(HWND hwnd, UINT umsg, WPARAM wparam, LPARAM lpara
         return 0;
 
     case WM_MOUSEWHEEL:
-        // Handle mouse wheel for zoom in third person mode
-        if (m_camera && m_camera->GetCameraMode() == CameraMode::ThirdPerson)
-        {
-            int wheelDelta = GET_WHEEL_DELTA_WPARAM(wparam);
-            float zoomDelta = static_cast<float>(wheelDelta) / 120.0f; // Standard wheel delta is 120
-            m_camera->ZoomToTarget(zoomDelta);
-        }
+        // Accumulated for the next fixed tick, which applies the zoom (see UpdateGame)
+        m_pendingWheelDelta += GET_WHEEL_DELTA_WPARAM(wparam);
         return 0;
 
     default:
@@ -7,6 +7,11 @@
 #include <memory>
 #include <string>
 #include <vector>
+#include "SceneGraph.h"
+#include "JobSystem.h"
+#include "InputReplay.h"
+#include "TransformSnapshot.h"
+#include "Memory.h"
 
 #pragma comment(lib, "d3d11.lib")
 #pragma comment(lib, "d3dcompiler.lib")
@@ -16,6 +21,8 @@ using namespace DirectX;
 class Camera;
 class Renderer;
 class GameLoop;
+class ModelLoader;
+class ModelLoadRequest;
 
 class Engine
 {
@@ -34,6 +41,29 @@ public:
     void SetTargetFPS(int framesPerSecond);
     void SetVSyncEnabled(bool enabled);
 
+    // Deterministic input: record every fixed tick to a binary log, or replay
+    // one instead of live input and verify the per-tick state checksums.
+    // Call after Initialize; a replay stops the engine when the log ends.
+    bool StartInputRecording(const std::string& filepath);
+    bool StartInputReplay(const std::string& filepath);
+
+    // Chrome trace_event JSON of the last profiled frames, written at Shutdown
+    void SetProfileTracePath(const std::string& filepath) { m_profileTracePath = filepath; }
+
+    // Scratch memory valid until the next frame starts; reset at the top of
+    // every RenderFrame
+    FrameAllocator& GetFrameAllocator() { return m_frameAllocator; }
+
+    // Prints Memory::PrintReport every interval while running; 0 disables.
+    // Budgets are set directly through Memory::SetBudget.
+    void SetMemoryReportInterval(double seconds) { m_memoryReportInterval = seconds; }
+
+    // Loads a model on the job system; its device objects are created at the
+    // start of each frame for at most the upload budget (milliseconds)
+    std::shared_ptr<ModelLoadRequest> LoadModelAsync(const std::string& filepath);
+    void SetAsyncUploadBudget(float milliseconds) { m_asyncUploadBudgetMs = milliseconds; }
+    ModelLoader* GetModelLoader() { return m_modelLoader.get(); }
+
     // Performance getters
     int GetCurrentFPS() const;
     int GetCurrentUPS() const;
@@ -49,10 +79,18 @@ private:
     void UpdateGame(float deltaTime);
     void RenderFrame(float interpolation);
 
+    // Per-tick input and state hashing for record/replay
+    void SampleTickInput(InputFrame& input);
+    uint64_t ComputeSimulationChecksum() const;
+    void FinishInputReplay();
+
+    float GetFixedDeltaTime() const { return static_cast<float>(1.0 / m_targetUPS); }
+
     HWND m_hwnd;
     int m_screenWidth;
     int m_screenHeight;
     bool m_isRunning;
+    int m_targetUPS;          // Fixed updates per second of Run
 
     // DirectX 11 components
     ID3D11Device* m_device;
@@ -67,6 +105,14 @@ private:
     std::unique_ptr<Camera> m_camera;
     std::unique_ptr<Renderer> m_renderer;
     std::unique_ptr<GameLoop> m_gameLoop;
+    std::unique_ptr<SceneGraph> m_scene;
+    std::unique_ptr<JobSystem> m_jobSystem;
+    std::unique_ptr<ModelLoader> m_modelLoader;
+    float m_asyncUploadBudgetMs;
+    FrameAllocator m_frameAllocator;
+    double m_memoryReportInterval;
+    double m_memoryReportTimer;
+    std::string m_profileTracePath;
 
     // Input state tracking
     bool m_keys[256];
@@ -74,10 +120,26 @@ private:
     int m_mouseX, m_mouseY;
     int m_lastMouseX, m_lastMouseY;
     bool m_isMouseCaptured;
+    int m_pendingWheelDelta;
+
+    // Input the simulation ran on, this tick and the previous one
+    InputFrame m_tickInput;
+    InputFrame m_previousTickInput;
+    uint64_t m_simulationTick;
+    std::unique_ptr<InputRecorder> m_inputRecorder;
+    std::unique_ptr<InputReplayer> m_inputReplayer;
 
     // Game objects (for interpolation example)
     float m_cubeRotationAngle;
     float m_triangleRotationAngle;
+    SceneNodeHandle m_triangleNode;
+    SceneNodeHandle m_cubeNode;
+
+    // Update -> render handoff; entry i of the states drives m_simulatedNodes[i]
+    std::vector<SceneNodeHandle> m_simulatedNodes;
+    TransformState m_simulationState;
+    TransformState m_renderState;
+    TransformSnapshotBuffer m_snapshots;
 };
 
 // Global engine instance
@@ -0,0 +1,133 @@
+#include "FramePacer.h"
+#include <chrono>
+#include <thread>
+#include <algorithm>
+#include <cmath>
+
+SteadyPacingClock::SteadyPacingClock()
+{
+}
+
+double SteadyPacingClock::Now()
+{
+    return std::chrono::duration<double>(std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+void SteadyPacingClock::SleepFor(double seconds)
+{
+    std::this_thread::sleep_for(std::chrono::duration<double>(seconds));
+}
+
+void SteadyPacingClock::Spin()
+{
+    std::this_thread::yield();
+}
+
+SimulatedPacingClock::SimulatedPacingClock()
+    : m_time(0.0)
+    , m_sleepOvershoot(0.0015)
+    , m_spinStep(0.000002)
+    , m_sleepCount(0)
+    , m_spinCount(0)
+{
+}
+
+void SimulatedPacingClock::SleepFor(double seconds)
+{
+    m_time += std::max(0.0, seconds) + m_sleepOvershoot;
+    m_sleepCount++;
+}
+
+FramePacer::FramePacer(std::shared_ptr<PacingClock> clock)
+    : m_clock(clock ? clock : std::make_shared<SteadyPacingClock>())
+    , m_targetFrameTime(0.0)
+    , m_spinThreshold(0.0005)
+    , m_sleepOvershootEstimate(0.0)
+    , m_nextDeadline(0.0)
+    , m_hasDeadline(false)
+    , m_errorSum(0.0)
+    , m_absErrorSum(0.0)
+{
+}
+
+void FramePacer::SetTargetFrameTime(double seconds)
+{
+    m_targetFrameTime = std::max(0.0, seconds);
+    m_hasDeadline = false;
+}
+
+void FramePacer::Reset()
+{
+    m_nextDeadline = m_clock->Now() + m_targetFrameTime;
+    m_hasDeadline = true;
+}
+
+void FramePacer::WaitForNextFrame()
+{
+    if (m_targetFrameTime <= 0.0)
+    {
+        return;
+    }
+
+    if (!m_hasDeadline)
+    {
+        Reset();
+    }
+
+    // Sleep until the spin window; the OS may wake us late by up to the
+    // recent overshoot, so that much is left for the busy-wait
+    double spinWindow = std::max(m_spinThreshold, m_sleepOvershootEstimate);
+    double now = m_clock->Now();
+    double sleepTime = m_nextDeadline - now - spinWindow;
+    if (sleepTime > 0.0)
+    {
+        m_clock->SleepFor(sleepTime);
+
+        double wakeTime = m_clock->Now();
+        double overshoot = std::max(0.0, wakeTime - (now + sleepTime));
+
+        // Track the recent worst case, forgetting old spikes slowly
+        m_sleepOvershootEstimate = std::max(overshoot, m_sleepOvershootEstimate * 0.95);
+        m_sleepOvershootEstimate = std::min(m_sleepOvershootEstimate, m_targetFrameTime * 0.5);
+        m_stats.maxSleepOvershootUs = std::max(m_stats.maxSleepOvershootUs, overshoot * 1e6);
+    }
+
+    now = m_clock->Now();
+    while (now < m_nextDeadline)
+    {
+        m_clock->Spin();
+        now = m_clock->Now();
+    }
+
+    RecordError(now - m_nextDeadline);
+
+    // Advance by whole periods; if a frame overran by more than one period,
+    // restart the sequence instead of racing to catch up
+    m_nextDeadline += m_targetFrameTime;
+    if (now > m_nextDeadline)
+    {
+        m_stats.missedFrames++;
+        m_nextDeadline = now + m_targetFrameTime;
+    }
+}
+
+void FramePacer::ResetStats()
+{
+    m_stats = FramePacingStats();
+    m_errorSum = 0.0;
+    m_absErrorSum = 0.0;
+}
+
+void FramePacer::RecordError(double errorSeconds)
+{
+    double errorUs = errorSeconds * 1e6;
+
+    m_stats.frameCount++;
+    m_stats.lastErrorUs = errorUs;
+    m_stats.maxErrorUs = m_stats.frameCount == 1 ? errorUs : std::max(m_stats.maxErrorUs, errorUs);
+
+    m_errorSum += errorUs;
+    m_absErrorSum += std::fabs(errorUs);
+    m_stats.meanErrorUs = m_errorSum / static_cast<double>(m_stats.frameCount);
+    m_stats.meanAbsErrorUs = m_absErrorSum / static_cast<double>(m_stats.frameCount);
+}
@@ -0,0 +1,122 @@
+#pragma once
+
+#include <cstdint>
+#include <memory>
+
+// Time source used by FramePacer. Times are seconds on a monotonic clock.
+class PacingClock
+{
+public:
+    virtual ~PacingClock() {}
+
+    virtual double Now() = 0;
+    virtual void SleepFor(double seconds) = 0;
+
+    // One iteration of the final busy-wait
+    virtual void Spin() = 0;
+};
+
+// std::chrono::steady_clock with the OS sleep; the default clock
+class SteadyPacingClock : public PacingClock
+{
+public:
+    SteadyPacingClock();
+
+    double Now() override;
+    void SleepFor(double seconds) override;
+    void Spin() override;
+};
+
+// Deterministic clock: time only moves when the pacer sleeps or spins.
+// Sleeps overshoot by a fixed amount, like a coarse OS scheduler would.
+class SimulatedPacingClock : public PacingClock
+{
+public:
+    SimulatedPacingClock();
+
+    double Now() override { return m_time; }
+    void SleepFor(double seconds) override;
+    void Spin() override { m_time += m_spinStep; }
+
+    // Simulates the work of a frame between two waits
+    void Advance(double seconds) { m_time += seconds; }
+
+    void SetSleepOvershoot(double seconds) { m_sleepOvershoot = seconds; }
+    void SetSpinStep(double seconds) { m_spinStep = seconds; }
+    int GetSleepCount() const { return m_sleepCount; }
+    int GetSpinCount() const { return m_spinCount; }
+
+private:
+    double m_time;
+    double m_sleepOvershoot;
+    double m_spinStep;
+    int m_sleepCount;
+    int m_spinCount;
+};
+
+// Deadline error statistics, in microseconds (positive = late)
+struct FramePacingStats
+{
+    uint64_t frameCount;
+    uint64_t missedFrames;     // Frames that started more than a whole frame late
+    double lastErrorUs;
+    double meanErrorUs;
+    double maxErrorUs;
+    double meanAbsErrorUs;
+    double maxSleepOvershootUs;
+
+    FramePacingStats()
+        : frameCount(0)
+        , missedFrames(0)
+        , lastErrorUs(0.0)
+        , meanErrorUs(0.0)
+        , maxErrorUs(0.0)
+        , meanAbsErrorUs(0.0)
+        , maxSleepOvershootUs(0.0)
+    {
+    }
+};
+
+// Waits for absolute frame deadlines: a coarse OS sleep gets close, then the
+// last stretch (the spin threshold, raised to the sleep overshoot observed
+// recently) is busy-waited. Deadlines advance by the target period, so late
+// frames do not push every later frame back.
+class FramePacer
+{
+public:
+    // A null clock uses SteadyPacingClock
+    explicit FramePacer(std::shared_ptr<PacingClock> clock = nullptr);
+
+    // 0 disables pacing
+    void SetTargetFrameTime(double seconds);
+    double GetTargetFrameTime() const { return m_targetFrameTime; }
+
+    // Minimum busy-wait before each deadline
+    void SetSpinThreshold(double seconds) { m_spinThreshold = seconds; }
+
+    // Starts the deadline sequence one period from now
+    void Reset();
+
+    // Blocks until the current deadline, then schedules the next one
+    void WaitForNextFrame();
+
+    const FramePacingStats& GetStats() const { return m_stats; }
+    void ResetStats();
+
+    PacingClock& GetClock() { return *m_clock; }
+
+private:
+    void RecordError(double errorSeconds);
+
+private:
+    std::shared_ptr<PacingClock> m_clock;
+    double m_targetFrameTime;
+    double m_spinThreshold;
+    double m_sleepOvershootEstimate;
+    double m_nextDeadline;
+    bool m_hasDeadline;
+
+    FramePacingStats m_stats;
+    double m_errorSum;
+    double m_absErrorSum;
+};
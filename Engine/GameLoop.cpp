@@ -1,12 +1,15 @@
 #include "GameLoop.h"
+#include "Profiler.h"
 #include <algorithm>
 #include <thread>
+#include <iostream>
 
 GameLoop::GameLoop()
     : m_targetUPS(60)
     , m_targetFPS(0) // Unlimited by default
     , m_vSyncEnabled(true)
     , m_isRunning(false)
+    , m_mode(GameLoopMode::SingleThreaded)
     , m_deltaTime(0.0f)
     , m_fixedDeltaTime(1.0f / 60.0f)
     , m_interpolation(0.0f)
@@ -14,23 +17,37 @@ GameLoop::GameLoop()
     , m_currentUPS(0)
     , m_frameCount(0)
     , m_updateCount(0)
+    , m_totalUpdates(0)
     , m_frameTime(0.0)
     , m_updateTime(0.0)
     , m_historyIndex(0)
+    , m_updateHistoryIndex(0)
+    , m_frameIntervalHistogram("frame")
+    , m_renderTimeHistogram("render")
+    , m_updateTimeHistogram("update")
+    , m_hasFrameInterval(false)
 {
     SetTargetUPS(60); // This will set m_fixedTimestep
 
+    // Two, three and six missed 60 Hz vblanks
+    SetFrameHitchThresholds({ 33.4, 50.0, 100.0 });
+
     // Initialize performance history
     for (int i = 0; i < STATS_HISTORY_SIZE; ++i)
     {
         m_frameTimeHistory[i] = 0.0;
-        m_updateTimeHistory[i] = 0.0;
+        m_updateTimeHistory[i].store(0.0);
     }
 }
 
 GameLoop::~GameLoop()
 {
     Stop();
+
+    if (m_updateThread.joinable())
+    {
+        m_updateThread.join();
+    }
 }
 
 void GameLoop::SetTargetUPS(int updatesPerSecond)
@@ -43,14 +60,7 @@ void GameLoop::SetTargetUPS(int updatesPerSecond)
 void GameLoop::SetTargetFPS(int framesPerSecond)
 {
     m_targetFPS = std::max(0, framesPerSecond);
-    if (m_targetFPS > 0)
-    {
-        m_frameTimeLimit = std::chrono::duration<double>(1.0 / m_targetFPS);
-    }
-    else
-    {
-        m_frameTimeLimit = std::chrono::duration<double>(0.0); // Unlimited
-    }
+    m_framePacer.SetTargetFrameTime(m_targetFPS > 0 ? 1.0 / m_targetFPS : 0.0); // 0 = unlimited
 }
 
 void GameLoop::SetVSyncEnabled(bool enabled)
@@ -76,68 +86,248 @@ void GameLoop::SetInputFunction(InputFunction inputFunc)
 void GameLoop::Start()
 {
     m_isRunning = true;
-    m_lastTime = std::chrono::high_resolution_clock::now();
+    m_lastTime = std::chrono::steady_clock::now();
     m_currentTime = m_lastTime;
     m_lastStatsUpdate = m_lastTime;
     m_accumulator = std::chrono::duration<double>(0.0);
+    m_framePacer.Reset();
 
     ResetStats();
 }
 
 void GameLoop::Stop()
 {
-    m_isRunning = false;
+    {
+        // Taking the lock orders the flag with the update thread's wait
+        std::lock_guard<std::mutex> lock(m_sleepMutex);
+        m_isRunning = false;
+    }
+    m_sleepCondition.notify_all();
 }
 
 void GameLoop::Run()
 {
     Start();
 
+    if (m_mode == GameLoopMode::Threaded)
+    {
+        RunThreaded();
+    }
+    else
+    {
+        RunSingleThreaded();
+    }
+
+    if (!m_telemetryExportPath.empty())
+    {
+        ExportTelemetry(m_telemetryExportPath);
+    }
+}
+
+uint64_t GameLoop::RunFixedSteps(uint64_t tickCount)
+{
+    Start();
+
+    uint64_t ticks = 0;
+    while (m_isRunning && ticks < tickCount)
+    {
+        UpdateTiming();
+        ProcessInput();
+
+        if (m_updateFunction)
+        {
+            m_updateFunction(m_fixedDeltaTime);
+        }
+
+        m_updateCount++;
+        m_totalUpdates++;
+        ticks++;
+
+        m_interpolation = 1.0f;
+        Render();
+    }
+
+    m_isRunning = false;
+    return ticks;
+}
+
+void GameLoop::SetFrameHitchThresholds(const std::vector<double>& thresholdsMs)
+{
+    m_frameIntervalHistogram.SetHitchThresholds(thresholdsMs);
+}
+
+bool GameLoop::ExportTelemetry(const std::string& basePath) const
+{
+    std::vector<const LatencyHistogram*> histograms = {
+        &m_frameIntervalHistogram, &m_renderTimeHistogram, &m_updateTimeHistogram
+    };
+
+    bool csvWritten = LatencyReport::WriteCSV(basePath + ".csv", histograms);
+    bool jsonWritten = LatencyReport::WriteJSON(basePath + ".json", histograms);
+
+    if (csvWritten && jsonWritten)
+    {
+        LatencySummary frames = m_frameIntervalHistogram.GetSummary();
+        std::cout << "GameLoop: Frame time p50 " << frames.p50Ms << " ms, p99 " << frames.p99Ms
+                  << " ms, max " << frames.maxMs << " ms; telemetry written to " << basePath << std::endl;
+    }
+
+    return csvWritten && jsonWritten;
+}
+
+void GameLoop::RunSingleThreaded()
+{
     while (m_isRunning)
     {
         UpdateTiming();
         ProcessInput();
         UpdateLogic();
         Render();
+        LimitFrameRate();
+    }
+}
+
+void GameLoop::RunThreaded()
+{
+    m_updateThread = std::thread(&GameLoop::UpdateThreadMain, this);
+
+    UpdateTick latestTick = { 0, std::chrono::steady_clock::now() };
+
+    while (m_isRunning)
+    {
+        UpdateTiming();
+        ProcessInput();
+
+        // Interpolate from the latest completed update towards the next one
+        if (m_updateTicks.Update())
+        {
+            latestTick = m_updateTicks.GetReadBuffer();
+        }
+
+        std::chrono::duration<double> sinceTick = std::chrono::steady_clock::now() - latestTick.time;
+        m_interpolation = static_cast<float>(std::min(1.0, std::max(0.0, sinceTick / m_fixedTimestep)));
+
+        Render();
+        LimitFrameRate();
+    }
+
+    // Stop() only signals; the thread is joined here, never from a callback
+    m_sleepCondition.notify_all();
+    if (m_updateThread.joinable())
+    {
+        m_updateThread.join();
+    }
+}
+
+void GameLoop::UpdateThreadMain()
+{
+    PROFILE_THREAD_NAME("Update");
+
+    // Maximum number of late updates to run back to back before dropping time
+    const int maxCatchUpSteps = 5;
+
+    auto stepDuration = std::chrono::duration_cast<std::chrono::steady_clock::duration>(m_fixedTimestep);
+    auto nextUpdate = std::chrono::steady_clock::now() + stepDuration;
+    uint64_t tickIndex = 0;
+
+    while (m_isRunning)
+    {
+        {
+            std::unique_lock<std::mutex> lock(m_sleepMutex);
+            m_sleepCondition.wait_until(lock, nextUpdate, [this]() { return !m_isRunning.load(); });
+        }
 
-        // Frame rate limiting (if not using VSync and target FPS is set)
-        if (!m_vSyncEnabled && m_targetFPS > 0)
+        if (!m_isRunning)
         {
-            auto frameEnd = std::chrono::high_resolution_clock::now();
-            auto frameDuration = frameEnd - m_currentTime;
+            break;
+        }
+
+        auto updateStart = std::chrono::steady_clock::now();
+
+        int steps = 0;
+        while (nextUpdate <= std::chrono::steady_clock::now() && steps < maxCatchUpSteps && m_isRunning)
+        {
+            PROFILE_ZONE("FixedUpdate");
 
-            if (frameDuration < m_frameTimeLimit)
+            if (m_updateFunction)
             {
-                auto sleepTime = m_frameTimeLimit - frameDuration;
-                std::this_thread::sleep_for(sleepTime);
+                m_updateFunction(m_fixedDeltaTime);
             }
+
+            nextUpdate += stepDuration;
+            m_updateCount++;
+            m_totalUpdates++;
+            steps++;
+
+            UpdateTick& tick = m_updateTicks.GetWriteBuffer();
+            tick.index = ++tickIndex;
+            tick.time = std::chrono::steady_clock::now();
+            m_updateTicks.Publish();
+        }
+
+        // Too far behind: drop the backlog instead of spiralling
+        auto now = std::chrono::steady_clock::now();
+        if (nextUpdate < now)
+        {
+            nextUpdate = now + stepDuration;
         }
+
+        auto updateEnd = std::chrono::steady_clock::now();
+        RecordUpdateTime(std::chrono::duration<double>(updateEnd - updateStart).count() * 1000.0);
+    }
+}
+
+void GameLoop::LimitFrameRate()
+{
+    // Frame rate limiting (if not using VSync and target FPS is set)
+    if (!m_vSyncEnabled && m_targetFPS > 0)
+    {
+        m_framePacer.WaitForNextFrame();
     }
 }
 
+void GameLoop::RecordUpdateTime(double milliseconds)
+{
+    m_updateTime = milliseconds;
+    m_updateTimeHistogram.Record(milliseconds);
+    m_updateTimeHistory[m_updateHistoryIndex].store(milliseconds);
+    m_updateHistoryIndex = (m_updateHistoryIndex + 1) % STATS_HISTORY_SIZE;
+}
+
 void GameLoop::UpdateTiming()
 {
-    m_currentTime = std::chrono::high_resolution_clock::now();
+    m_currentTime = std::chrono::steady_clock::now();
     auto frameTime = m_currentTime - m_lastTime;
     m_lastTime = m_currentTime;
 
-    // Convert to seconds
-    m_deltaTime = static_cast<float>(frameTime.count() * 1e-9);
+    // Convert to seconds (the clock's tick period is implementation defined)
+    double frameSeconds = std::chrono::duration<double>(frameTime).count();
+    m_deltaTime = static_cast<float>(frameSeconds);
+
+    // The first interval after Start only measures setup
+    if (m_hasFrameInterval)
+    {
+        m_frameIntervalHistogram.Record(frameSeconds * 1000.0);
+    }
+    m_hasFrameInterval = true;
 
     // Clamp delta time to prevent spiral of death
     m_deltaTime = std::min(m_deltaTime, 0.05f); // Max 50ms per frame
 
-    // Add to accumulator for fixed timestep
-    m_accumulator += frameTime;
+    // Add to accumulator for fixed timestep; in threaded mode the update
+    // thread keeps its own schedule and nothing here would drain it
+    if (m_mode != GameLoopMode::Threaded)
+    {
+        m_accumulator += frameTime;
+    }
 
     // Update performance stats
     auto statsTime = std::chrono::duration<double>(m_currentTime - m_lastStatsUpdate).count();
     if (statsTime >= 1.0) // Update stats every second
     {
         m_currentFPS = m_frameCount;
-        m_currentUPS = m_updateCount;
+        m_currentUPS = m_updateCount.exchange(0);
         m_frameCount = 0;
-        m_updateCount = 0;
         m_lastStatsUpdate = m_currentTime;
     }
 }
@@ -152,7 +342,9 @@ void GameLoop::ProcessInput()
 
 void GameLoop::UpdateLogic()
 {
-    auto updateStart = std::chrono::high_resolution_clock::now();
+    PROFILE_FUNCTION();
+
+    auto updateStart = std::chrono::steady_clock::now();
 
     // Fixed timestep update loop
     while (m_accumulator >= m_fixedTimestep)
@@ -164,21 +356,21 @@ void GameLoop::UpdateLogic()
 
         m_accumulator -= m_fixedTimestep;
         m_updateCount++;
+        m_totalUpdates++;
     }
 
     // Calculate interpolation for smooth rendering
     m_interpolation = static_cast<float>(m_accumulator / m_fixedTimestep);
 
-    auto updateEnd = std::chrono::high_resolution_clock::now();
-    m_updateTime = std::chrono::duration<double>(updateEnd - updateStart).count() * 1000.0; // Convert to milliseconds
-
-    // Store in history for averaging
-    m_updateTimeHistory[m_historyIndex] = m_updateTime;
+    auto updateEnd = std::chrono::steady_clock::now();
+    RecordUpdateTime(std::chrono::duration<double>(updateEnd - updateStart).count() * 1000.0); // Convert to milliseconds
 }
 
 void GameLoop::Render()
 {
-    auto renderStart = std::chrono::high_resolution_clock::now();
+    PROFILE_FUNCTION();
+
+    auto renderStart = std::chrono::steady_clock::now();
 
     if (m_renderFunction)
     {
@@ -187,8 +379,9 @@ void GameLoop::Render()
 
     m_frameCount++;
 
-    auto renderEnd = std::chrono::high_resolution_clock::now();
+    auto renderEnd = std::chrono::steady_clock::now();
     m_frameTime = std::chrono::duration<double>(renderEnd - renderStart).count() * 1000.0; // Convert to milliseconds
+    m_renderTimeHistogram.Record(m_frameTime);
 
     // Store in history for averaging
     m_frameTimeHistory[m_historyIndex] = m_frameTime;
@@ -206,12 +399,19 @@ void GameLoop::ResetStats()
     m_frameTime = 0.0;
     m_updateTime = 0.0;
     m_historyIndex = 0;
+    m_updateHistoryIndex = 0;
 
     for (int i = 0; i < STATS_HISTORY_SIZE; ++i)
     {
         m_frameTimeHistory[i] = 0.0;
-        m_updateTimeHistory[i] = 0.0;
+        m_updateTimeHistory[i].store(0.0);
     }
+
+    m_framePacer.ResetStats();
+    m_frameIntervalHistogram.Reset();
+    m_renderTimeHistogram.Reset();
+    m_updateTimeHistogram.Reset();
+    m_hasFrameInterval = false;
 }
 
 double GameLoop::GetAverageFrameTime() const
@@ -238,9 +438,10 @@ double GameLoop::GetAverageUpdateTime() const
 
     for (int i = 0; i < STATS_HISTORY_SIZE; ++i)
     {
-        if (m_updateTimeHistory[i] > 0.0)
+        double updateTime = m_updateTimeHistory[i].load();
+        if (updateTime > 0.0)
         {
-            total += m_updateTimeHistory[i];
+            total += updateTime;
             count++;
         }
     }
@@ -2,6 +2,21 @@
 
 #include <chrono>
 #include <functional>
+#include <atomic>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <cstdint>
+#include <string>
+#include "TripleBuffer.h"
+#include "FramePacer.h"
+#include "LatencyHistogram.h"
+
+enum class GameLoopMode
+{
+    SingleThreaded,   // Input, fixed updates and rendering in sequence on the calling thread
+    Threaded          // Fixed updates on a dedicated thread, input and rendering on the calling thread
+};
 
 class GameLoop
 {
@@ -18,30 +33,75 @@ public:
     void SetTargetFPS(int framesPerSecond);  // Frames Per Second (rendering), 0 = unlimited
     void SetVSyncEnabled(bool enabled);
 
+    // Threaded mode runs the update callback on its own thread at the target UPS.
+    // The update callback must publish its results through a lock-free channel
+    // (for example TransformSnapshotBuffer); the render callback receives the
+    // interpolation factor relative to the latest completed update.
+    void SetMode(GameLoopMode mode) { m_mode = mode; }
+    GameLoopMode GetMode() const { return m_mode; }
+
     // Callback functions
     void SetUpdateFunction(UpdateFunction updateFunc);
     void SetRenderFunction(RenderFunction renderFunc);
     void SetInputFunction(InputFunction inputFunc);
 
-    // Loop control
+    // Loop control. Stop may be called from any callback or thread.
     void Start();
     void Stop();
     void Run();
+    bool IsRunning() const { return m_isRunning.load(); }
+
+    // Runs up to tickCount fixed updates back to back, each followed by a
+    // render with interpolation 1, without waiting for real time. Simulation
+    // results match Run as long as the update callback takes its input per
+    // tick (see InputReplayer). Returns the number of ticks run.
+    uint64_t RunFixedSteps(uint64_t tickCount);
 
     // Timing information
     float GetDeltaTime() const { return m_deltaTime; }
+    float GetFixedDeltaTime() const { return m_fixedDeltaTime; }
     float GetInterpolation() const { return m_interpolation; }
     int GetCurrentFPS() const { return m_currentFPS; }
     int GetCurrentUPS() const { return m_currentUPS; }
     double GetFrameTime() const { return m_frameTime; }
-    double GetUpdateTime() const { return m_updateTime; }
+    double GetUpdateTime() const { return m_updateTime.load(); }
+    uint64_t GetTotalUpdates() const { return m_totalUpdates.load(); }
+
+    // Frame pacing (used when VSync is off and a target FPS is set)
+    FramePacer& GetFramePacer() { return m_framePacer; }
+    const FramePacingStats& GetPacingStats() const { return m_framePacer.GetStats(); }
 
     // Performance stats
     void ResetStats();
     double GetAverageFrameTime() const;
     double GetAverageUpdateTime() const;
 
+    // Latency histograms over the whole run: "frame" is the time between
+    // frames, "render" and "update" the time spent in each callback
+    const LatencyHistogram& GetFrameIntervalHistogram() const { return m_frameIntervalHistogram; }
+    const LatencyHistogram& GetRenderTimeHistogram() const { return m_renderTimeHistogram; }
+    const LatencyHistogram& GetUpdateTimeHistogram() const { return m_updateTimeHistogram; }
+    LatencyHistogram& GetFrameIntervalHistogram() { return m_frameIntervalHistogram; }
+    void SetFrameHitchThresholds(const std::vector<double>& thresholdsMs);
+
+    // When set, Run writes <basePath>.csv and <basePath>.json once the loop exits
+    void SetTelemetryExportPath(const std::string& basePath) { m_telemetryExportPath = basePath; }
+    bool ExportTelemetry(const std::string& basePath) const;
+
 private:
+    // Published by the update thread after every fixed update
+    struct UpdateTick
+    {
+        uint64_t index;
+        std::chrono::steady_clock::time_point time;
+    };
+
+    void RunSingleThreaded();
+    void RunThreaded();
+    void UpdateThreadMain();
+    void LimitFrameRate();
+    void RecordUpdateTime(double milliseconds);
+
     void UpdateTiming();
     void ProcessInput();
     void UpdateLogic();
@@ -51,15 +111,16 @@ private:
     int m_targetUPS;
     int m_targetFPS;
     bool m_vSyncEnabled;
-    bool m_isRunning;
+    std::atomic<bool> m_isRunning;
+    GameLoopMode m_mode;
 
     // Fixed timestep for game logic
     std::chrono::duration<double> m_fixedTimestep;
-    std::chrono::duration<double> m_frameTimeLimit;
+    FramePacer m_framePacer;
 
     // Timing variables
-    std::chrono::high_resolution_clock::time_point m_lastTime;
-    std::chrono::high_resolution_clock::time_point m_currentTime;
+    std::chrono::steady_clock::time_point m_lastTime;
+    std::chrono::steady_clock::time_point m_currentTime;
     std::chrono::duration<double> m_accumulator;
 
     float m_deltaTime;        // Delta time for rendering (variable)
@@ -70,16 +131,31 @@ private:
     int m_currentFPS;
     int m_currentUPS;
     int m_frameCount;
-    int m_updateCount;
+    std::atomic<int> m_updateCount;
+    std::atomic<uint64_t> m_totalUpdates;
     double m_frameTime;
-    double m_updateTime;
-    std::chrono::high_resolution_clock::time_point m_lastStatsUpdate;
+    std::atomic<double> m_updateTime;
+    std::chrono::steady_clock::time_point m_lastStatsUpdate;
 
     // Performance history for averaging
     static const int STATS_HISTORY_SIZE = 60;
     double m_frameTimeHistory[STATS_HISTORY_SIZE];
-    double m_updateTimeHistory[STATS_HISTORY_SIZE];
+    std::atomic<double> m_updateTimeHistory[STATS_HISTORY_SIZE];
     int m_historyIndex;
+    int m_updateHistoryIndex;
+
+    // Full-run distributions (histograms keep every sample, the ring above only the last 60)
+    LatencyHistogram m_frameIntervalHistogram;
+    LatencyHistogram m_renderTimeHistogram;
+    LatencyHistogram m_updateTimeHistogram;
+    bool m_hasFrameInterval;
+    std::string m_telemetryExportPath;
+
+    // Threaded mode
+    std::thread m_updateThread;
+    std::mutex m_sleepMutex;
+    std::condition_variable m_sleepCondition;
+    TripleBuffer<UpdateTick> m_updateTicks;
 
     // Callback functions
     UpdateFunction m_updateFunction;
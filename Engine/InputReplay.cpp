@@ -0,0 +1,368 @@
+#include "InputReplay.h"
+#include <iostream>
+#include <cstring>
+#include <cmath>
+#include <iterator>
+
+namespace
+{
+    const char INPUT_LOG_MAGIC[4] = { 'E', 'I', 'N', 'P' };
+    const uint32_t INPUT_LOG_VERSION = 1;
+
+    // Per-tick record flags
+    const uint8_t RECORD_KEYS = 1 << 0;
+    const uint8_t RECORD_BUTTONS = 1 << 1;
+    const uint8_t RECORD_MOUSE = 1 << 2;
+    const uint8_t RECORD_WHEEL = 1 << 3;
+    const uint8_t RECORD_CHECKSUM = 1 << 4;
+
+    const uint8_t BUTTON_CAPTURED_BIT = 1 << 7;
+
+    void AppendBytes(std::vector<uint8_t>& out, const void* data, size_t size)
+    {
+        const uint8_t* bytes = static_cast<const uint8_t*>(data);
+        out.insert(out.end(), bytes, bytes + size);
+    }
+
+    // Zig-zag keeps small negative deltas small
+    void AppendVarint(std::vector<uint8_t>& out, int32_t value)
+    {
+        uint32_t encoded = (static_cast<uint32_t>(value) << 1) ^ static_cast<uint32_t>(value >> 31);
+        while (encoded >= 0x80)
+        {
+            out.push_back(static_cast<uint8_t>(encoded | 0x80));
+            encoded >>= 7;
+        }
+        out.push_back(static_cast<uint8_t>(encoded));
+    }
+}
+
+InputFrame::InputFrame()
+    : mouseButtons(0)
+    , mouseCaptured(false)
+    , mouseDeltaX(0)
+    , mouseDeltaY(0)
+    , wheelDelta(0)
+{
+    std::memset(keys, 0, sizeof(keys));
+}
+
+bool InputFrame::IsKeyDown(int key) const
+{
+    if (key < 0 || key >= KEY_COUNT)
+        return false;
+
+    return (keys[key >> 5] & (1u << (key & 31))) != 0;
+}
+
+void InputFrame::SetKey(int key, bool down)
+{
+    if (key < 0 || key >= KEY_COUNT)
+        return;
+
+    if (down)
+        keys[key >> 5] |= 1u << (key & 31);
+    else
+        keys[key >> 5] &= ~(1u << (key & 31));
+}
+
+bool InputFrame::IsMouseButtonDown(int button) const
+{
+    if (button < 0 || button >= MOUSE_BUTTON_COUNT)
+        return false;
+
+    return (mouseButtons & (1u << button)) != 0;
+}
+
+void InputFrame::SetMouseButton(int button, bool down)
+{
+    if (button < 0 || button >= MOUSE_BUTTON_COUNT)
+        return;
+
+    if (down)
+        mouseButtons |= static_cast<uint8_t>(1u << button);
+    else
+        mouseButtons &= static_cast<uint8_t>(~(1u << button));
+}
+
+bool InputFrame::operator==(const InputFrame& other) const
+{
+    return std::memcmp(keys, other.keys, sizeof(keys)) == 0 &&
+           mouseButtons == other.mouseButtons &&
+           mouseCaptured == other.mouseCaptured &&
+           mouseDeltaX == other.mouseDeltaX &&
+           mouseDeltaY == other.mouseDeltaY &&
+           wheelDelta == other.wheelDelta;
+}
+
+void StateChecksum::Add(const void* data, size_t size)
+{
+    const uint8_t* bytes = static_cast<const uint8_t*>(data);
+    for (size_t i = 0; i < size; ++i)
+    {
+        m_hash ^= bytes[i];
+        m_hash *= 1099511628211ull;
+    }
+}
+
+InputRecorder::InputRecorder()
+    : m_tickCount(0)
+{
+    m_record.reserve(64);
+}
+
+InputRecorder::~InputRecorder()
+{
+    Close();
+}
+
+bool InputRecorder::Open(const std::string& filepath, float fixedDeltaTime)
+{
+    Close();
+
+    m_file.open(filepath, std::ios::binary | std::ios::trunc);
+    if (!m_file.is_open())
+    {
+        std::cerr << "InputRecorder: Failed to open " << filepath << std::endl;
+        return false;
+    }
+
+    uint32_t reserved = 0;
+    m_file.write(INPUT_LOG_MAGIC, sizeof(INPUT_LOG_MAGIC));
+    m_file.write(reinterpret_cast<const char*>(&INPUT_LOG_VERSION), sizeof(INPUT_LOG_VERSION));
+    m_file.write(reinterpret_cast<const char*>(&fixedDeltaTime), sizeof(fixedDeltaTime));
+    m_file.write(reinterpret_cast<const char*>(&reserved), sizeof(reserved));
+
+    m_previous = InputFrame();
+    m_tickCount = 0;
+    return m_file.good();
+}
+
+void InputRecorder::Close()
+{
+    if (m_file.is_open())
+    {
+        m_file.close();
+        std::cout << "InputRecorder: Recorded " << m_tickCount << " ticks" << std::endl;
+    }
+}
+
+void InputRecorder::RecordTick(const InputFrame& input, uint64_t stateChecksum)
+{
+    if (!m_file.is_open())
+    {
+        return;
+    }
+
+    uint8_t buttons = input.mouseButtons | (input.mouseCaptured ? BUTTON_CAPTURED_BIT : 0);
+    uint8_t previousButtons = m_previous.mouseButtons | (m_previous.mouseCaptured ? BUTTON_CAPTURED_BIT : 0);
+
+    uint8_t flags = RECORD_CHECKSUM;
+    if (std::memcmp(input.keys, m_previous.keys, sizeof(input.keys)) != 0)
+        flags |= RECORD_KEYS;
+    if (buttons != previousButtons)
+        flags |= RECORD_BUTTONS;
+    if (input.mouseDeltaX != 0 || input.mouseDeltaY != 0)
+        flags |= RECORD_MOUSE;
+    if (input.wheelDelta != 0)
+        flags |= RECORD_WHEEL;
+
+    m_record.clear();
+    m_record.push_back(flags);
+
+    if (flags & RECORD_KEYS)
+    {
+        AppendBytes(m_record, input.keys, sizeof(input.keys));
+    }
+
+    if (flags & RECORD_BUTTONS)
+    {
+        m_record.push_back(buttons);
+    }
+
+    if (flags & RECORD_MOUSE)
+    {
+        AppendVarint(m_record, input.mouseDeltaX);
+        AppendVarint(m_record, input.mouseDeltaY);
+    }
+
+    if (flags & RECORD_WHEEL)
+    {
+        AppendVarint(m_record, input.wheelDelta);
+    }
+
+    AppendBytes(m_record, &stateChecksum, sizeof(stateChecksum));
+
+    m_file.write(reinterpret_cast<const char*>(m_record.data()), static_cast<std::streamsize>(m_record.size()));
+    m_previous = input;
+    m_tickCount++;
+}
+
+InputReplayer::InputReplayer()
+    : m_position(0)
+    , m_fixedDeltaTime(0.0f)
+    , m_tickIndex(0)
+    , m_hasExpectedChecksum(false)
+    , m_expectedChecksum(0)
+    , m_mismatchCount(0)
+    , m_firstMismatchTick(-1)
+{
+}
+
+bool InputReplayer::Open(const std::string& filepath)
+{
+    std::ifstream file(filepath, std::ios::binary);
+    if (!file.is_open())
+    {
+        std::cerr << "InputReplayer: Failed to open " << filepath << std::endl;
+        return false;
+    }
+
+    m_data.assign(std::istreambuf_iterator<char>(file), std::istreambuf_iterator<char>());
+    m_position = 0;
+
+    char magic[4];
+    uint32_t version = 0;
+    uint32_t reserved = 0;
+    if (!ReadBytes(magic, sizeof(magic)) || std::memcmp(magic, INPUT_LOG_MAGIC, sizeof(magic)) != 0 ||
+        !ReadBytes(&version, sizeof(version)) || version != INPUT_LOG_VERSION ||
+        !ReadBytes(&m_fixedDeltaTime, sizeof(m_fixedDeltaTime)) ||
+        !ReadBytes(&reserved, sizeof(reserved)))
+    {
+        std::cerr << "InputReplayer: " << filepath << " is not a version " << INPUT_LOG_VERSION
+                  << " input log" << std::endl;
+        m_data.clear();
+        m_position = 0;
+        return false;
+    }
+
+    m_current = InputFrame();
+    m_tickIndex = 0;
+    m_hasExpectedChecksum = false;
+    m_mismatchCount = 0;
+    m_firstMismatchTick = -1;
+    return true;
+}
+
+bool InputReplayer::NextTick(InputFrame& input)
+{
+    uint8_t flags = 0;
+    if (!ReadBytes(&flags, sizeof(flags)))
+    {
+        return false;
+    }
+
+    // Keys and buttons persist; mouse and wheel deltas only apply to this tick
+    m_current.mouseDeltaX = 0;
+    m_current.mouseDeltaY = 0;
+    m_current.wheelDelta = 0;
+
+    bool valid = true;
+    if (flags & RECORD_KEYS)
+    {
+        valid = valid && ReadBytes(m_current.keys, sizeof(m_current.keys));
+    }
+
+    if (flags & RECORD_BUTTONS)
+    {
+        uint8_t buttons = 0;
+        valid = valid && ReadBytes(&buttons, sizeof(buttons));
+        m_current.mouseButtons = buttons & static_cast<uint8_t>(~BUTTON_CAPTURED_BIT);
+        m_current.mouseCaptured = (buttons & BUTTON_CAPTURED_BIT) != 0;
+    }
+
+    if (flags & RECORD_MOUSE)
+    {
+        valid = valid && ReadVarint(m_current.mouseDeltaX) && ReadVarint(m_current.mouseDeltaY);
+    }
+
+    if (flags & RECORD_WHEEL)
+    {
+        valid = valid && ReadVarint(m_current.wheelDelta);
+    }
+
+    m_hasExpectedChecksum = (flags & RECORD_CHECKSUM) != 0;
+    if (m_hasExpectedChecksum)
+    {
+        valid = valid && ReadBytes(&m_expectedChecksum, sizeof(m_expectedChecksum));
+    }
+
+    if (!valid)
+    {
+        std::cerr << "InputReplayer: Truncated record at tick " << m_tickIndex << std::endl;
+        m_position = m_data.size();
+        return false;
+    }
+
+    input = m_current;
+    m_tickIndex++;
+    return true;
+}
+
+bool InputReplayer::VerifyTick(uint64_t stateChecksum)
+{
+    if (!m_hasExpectedChecksum || stateChecksum == m_expectedChecksum)
+    {
+        return true;
+    }
+
+    // m_tickIndex already counts the tick being verified
+    int64_t tick = static_cast<int64_t>(m_tickIndex) - 1;
+    if (m_mismatchCount == 0)
+    {
+        m_firstMismatchTick = tick;
+        std::cerr << "InputReplayer: Simulation diverged at tick " << tick << std::endl;
+    }
+
+    m_mismatchCount++;
+    return false;
+}
+
+int InputReplayer::GetUpdatesPerSecond() const
+{
+    if (!(m_fixedDeltaTime > 0.0f))
+    {
+        return 0;
+    }
+
+    long updatesPerSecond = std::lround(1.0 / m_fixedDeltaTime);
+    if (updatesPerSecond < 1 || static_cast<float>(1.0 / updatesPerSecond) != m_fixedDeltaTime)
+    {
+        return 0;
+    }
+    return static_cast<int>(updatesPerSecond);
+}
+
+bool InputReplayer::ReadBytes(void* destination, size_t size)
+{
+    if (m_position + size > m_data.size())
+    {
+        return false;
+    }
+
+    std::memcpy(destination, m_data.data() + m_position, size);
+    m_position += size;
+    return true;
+}
+
+bool InputReplayer::ReadVarint(int32_t& value)
+{
+    uint32_t encoded = 0;
+    for (int shift = 0; shift < 35; shift += 7)
+    {
+        uint8_t byte = 0;
+        if (!ReadBytes(&byte, sizeof(byte)))
+        {
+            return false;
+        }
+
+        encoded |= static_cast<uint32_t>(byte & 0x7F) << shift;
+        if ((byte & 0x80) == 0)
+        {
+            value = static_cast<int32_t>((encoded >> 1) ^ (~(encoded & 1) + 1));
+            return true;
+        }
+    }
+
+    return false;
+}
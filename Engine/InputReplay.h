@@ -0,0 +1,117 @@
+#pragma once
+
+#include <string>
+#include <vector>
+#include <fstream>
+#include <cstdint>
+
+// Input consumed by one fixed update. Everything the simulation reads from
+// the player goes through this struct, so recording it per tick is enough to
+// reproduce a session exactly.
+struct InputFrame
+{
+    static const int KEY_COUNT = 256;
+    static const int MOUSE_BUTTON_COUNT = 3;
+
+    uint32_t keys[KEY_COUNT / 32];  // Bit per virtual-key code
+    uint8_t mouseButtons;           // Bit per button (left, right, middle)
+    bool mouseCaptured;
+    int32_t mouseDeltaX;            // Cursor movement since the previous tick while captured
+    int32_t mouseDeltaY;
+    int32_t wheelDelta;             // Accumulated wheel delta (120 per notch)
+
+    InputFrame();
+
+    bool IsKeyDown(int key) const;
+    void SetKey(int key, bool down);
+    bool IsMouseButtonDown(int button) const;
+    void SetMouseButton(int button, bool down);
+
+    bool operator==(const InputFrame& other) const;
+    bool operator!=(const InputFrame& other) const { return !(*this == other); }
+};
+
+// FNV-1a hash of simulation state, fed field by field after every tick
+class StateChecksum
+{
+public:
+    StateChecksum() : m_hash(14695981039346656037ull) {}
+
+    void Add(const void* data, size_t size);
+    void Add(float value) { Add(&value, sizeof(value)); }
+    void Add(int32_t value) { Add(&value, sizeof(value)); }
+    void Add(uint64_t value) { Add(&value, sizeof(value)); }
+
+    uint64_t GetValue() const { return m_hash; }
+
+private:
+    uint64_t m_hash;
+};
+
+// Writes an input log: a small header, then one record per tick holding only
+// what changed since the previous tick (keys, buttons, mouse, wheel as
+// zig-zag varints) plus the state checksum after the tick. An idle tick costs
+// 9 bytes. Records are appended as they happen, so a crashed session still
+// leaves a replayable prefix.
+class InputRecorder
+{
+public:
+    InputRecorder();
+    ~InputRecorder();
+
+    bool Open(const std::string& filepath, float fixedDeltaTime);
+    void Close();
+    bool IsOpen() const { return m_file.is_open(); }
+
+    void RecordTick(const InputFrame& input, uint64_t stateChecksum);
+    uint64_t GetTickCount() const { return m_tickCount; }
+
+private:
+    std::ofstream m_file;
+    InputFrame m_previous;
+    uint64_t m_tickCount;
+    std::vector<uint8_t> m_record;
+};
+
+// Plays an input log back tick by tick and compares the state checksums the
+// simulation produces against the recorded ones.
+class InputReplayer
+{
+public:
+    InputReplayer();
+
+    bool Open(const std::string& filepath);
+
+    // Input for the next tick; false once the log is exhausted or corrupt
+    bool NextTick(InputFrame& input);
+
+    // Compares the checksum after the tick returned by NextTick; returns false on divergence
+    bool VerifyTick(uint64_t stateChecksum);
+
+    float GetFixedDeltaTime() const { return m_fixedDeltaTime; }
+
+    // Whole update rate whose fixed step, 1.0 / rate rounded to float, is the
+    // recorded one; 0 if no rate gives exactly that step
+    int GetUpdatesPerSecond() const;
+
+    uint64_t GetTickCount() const { return m_tickIndex; }
+    uint64_t GetMismatchCount() const { return m_mismatchCount; }
+    int64_t GetFirstMismatchTick() const { return m_firstMismatchTick; }
+    bool IsFinished() const { return m_position >= m_data.size(); }
+
+private:
+    bool ReadBytes(void* destination, size_t size);
+    bool ReadVarint(int32_t& value);
+
+private:
+    std::vector<uint8_t> m_data;
+    size_t m_position;
+    float m_fixedDeltaTime;
+
+    InputFrame m_current;
+    uint64_t m_tickIndex;
+    bool m_hasExpectedChecksum;
+    uint64_t m_expectedChecksum;
+    uint64_t m_mismatchCount;
+    int64_t m_firstMismatchTick;
+};
@@ -0,0 +1,352 @@
+#include "JobSystem.h"
+#include "Profiler.h"
+#include <algorithm>
+
+namespace
+{
+    // Identifies the pool and queue of the current worker thread
+    thread_local const JobSystem* t_ownerSystem = nullptr;
+    thread_local int t_queueIndex = 0;
+}
+
+JobSystem::JobSystem()
+    : m_queuedJobs(0)
+    , m_sleepingWorkers(0)
+    , m_isRunning(false)
+    , m_initialized(false)
+    , m_jobsExecuted(0)
+    , m_jobsStolen(0)
+    , m_jobsRunByWaiters(0)
+{
+}
+
+JobSystem::~JobSystem()
+{
+    Shutdown();
+}
+
+bool JobSystem::Initialize(int workerCount)
+{
+    if (m_initialized)
+    {
+        return true;
+    }
+
+    if (workerCount < 0)
+    {
+        unsigned int hardwareThreads = std::thread::hardware_concurrency();
+        workerCount = hardwareThreads > 1 ? static_cast<int>(hardwareThreads) - 1 : 0;
+    }
+
+    m_queues.clear();
+    for (int i = 0; i < workerCount + 1; ++i)
+    {
+        m_queues.push_back(std::make_unique<WorkQueue>());
+    }
+
+    m_isRunning = true;
+    m_workers.reserve(workerCount);
+    for (int i = 0; i < workerCount; ++i)
+    {
+        m_workers.emplace_back(&JobSystem::WorkerMain, this, i + 1);
+    }
+
+    m_initialized = true;
+    return true;
+}
+
+void JobSystem::Shutdown()
+{
+    if (!m_initialized)
+    {
+        return;
+    }
+
+    {
+        std::lock_guard<std::mutex> lock(m_wakeMutex);
+        m_isRunning = false;
+    }
+    m_wakeCondition.notify_all();
+
+    for (auto& worker : m_workers)
+    {
+        if (worker.joinable())
+        {
+            worker.join();
+        }
+    }
+    m_workers.clear();
+
+    // Run whatever is left so counters held by callers still complete
+    while (TryRunOne(false))
+    {
+    }
+
+    m_queues.clear();
+    m_initialized = false;
+}
+
+void JobSystem::Run(JobFunction function, JobCounter* counter)
+{
+    if (counter)
+    {
+        counter->m_pending.fetch_add(1, std::memory_order_relaxed);
+    }
+
+    Job job = { std::move(function), counter };
+
+    if (!m_initialized)
+    {
+        // No pool: behave as a synchronous call
+        Execute(job);
+        return;
+    }
+
+    Push(std::move(job));
+}
+
+void JobSystem::RunAfter(JobCounter& dependency, JobFunction function, JobCounter* counter)
+{
+    if (counter)
+    {
+        counter->m_pending.fetch_add(1, std::memory_order_relaxed);
+    }
+
+    Job job = { std::move(function), counter };
+
+    {
+        std::lock_guard<std::mutex> lock(dependency.m_continuationMutex);
+        if (!dependency.IsDone())
+        {
+            dependency.m_continuations.push_back(std::move(job));
+            return;
+        }
+    }
+
+    if (!m_initialized)
+    {
+        Execute(job);
+        return;
+    }
+
+    Push(std::move(job));
+}
+
+void JobSystem::Wait(JobCounter& counter)
+{
+    while (!counter.IsDone())
+    {
+        if (!TryRunOne(true))
+        {
+            std::this_thread::yield();
+        }
+    }
+
+    // The finishing thread may still hold the lock; wait for it so the
+    // caller can destroy the counter as soon as this returns
+    std::lock_guard<std::mutex> lock(counter.m_continuationMutex);
+}
+
+void JobSystem::ParallelFor(size_t count, size_t minBatchSize, const std::function<void(size_t begin, size_t end)>& body)
+{
+    if (count == 0)
+    {
+        return;
+    }
+
+    // A few ranges per thread leaves room for stealing to balance uneven work
+    size_t threadCount = m_workers.size() + 1;
+    size_t batchSize = std::max<size_t>(std::max<size_t>(minBatchSize, 1), (count + threadCount * 4 - 1) / (threadCount * 4));
+
+    if (!m_initialized || m_workers.empty() || count <= batchSize)
+    {
+        body(0, count);
+        return;
+    }
+
+    JobCounter counter;
+    for (size_t begin = batchSize; begin < count; begin += batchSize)
+    {
+        size_t end = std::min(begin + batchSize, count);
+        Run([&body, begin, end]() { body(begin, end); }, &counter);
+    }
+
+    // The caller takes the first range itself before helping with the rest
+    body(0, batchSize);
+    Wait(counter);
+}
+
+ParallelForFunction JobSystem::GetParallelForFunction(size_t minBatchSize)
+{
+    return [this, minBatchSize](size_t count, const std::function<void(size_t begin, size_t end)>& body)
+    {
+        ParallelFor(count, minBatchSize, body);
+    };
+}
+
+JobSystemStats JobSystem::GetStats() const
+{
+    JobSystemStats stats;
+    stats.workerCount = static_cast<int>(m_workers.size());
+    stats.jobsExecuted = m_jobsExecuted.load(std::memory_order_relaxed);
+    stats.jobsStolen = m_jobsStolen.load(std::memory_order_relaxed);
+    stats.jobsRunByWaiters = m_jobsRunByWaiters.load(std::memory_order_relaxed);
+    return stats;
+}
+
+void JobSystem::WorkerMain(int workerIndex)
+{
+    t_ownerSystem = this;
+    t_queueIndex = workerIndex;
+    PROFILE_THREAD_NAME("Worker " + std::to_string(workerIndex));
+
+    while (m_isRunning)
+    {
+        if (TryRunOne(false))
+        {
+            continue;
+        }
+
+        // Registering as sleeper before re-checking the queue count pairs with
+        // the check in Push, so a job pushed in between always wakes someone
+        std::unique_lock<std::mutex> lock(m_wakeMutex);
+        m_sleepingWorkers++;
+        m_wakeCondition.wait(lock, [this]() { return m_queuedJobs.load() > 0 || !m_isRunning; });
+        m_sleepingWorkers--;
+    }
+
+    t_ownerSystem = nullptr;
+    t_queueIndex = 0;
+}
+
+void JobSystem::Push(Job job)
+{
+    WorkQueue& queue = *m_queues[GetCurrentQueueIndex()];
+    {
+        std::lock_guard<std::mutex> lock(queue.mutex);
+        queue.jobs.push_back(std::move(job));
+    }
+
+    m_queuedJobs++;
+
+    if (m_sleepingWorkers.load() > 0)
+    {
+        // Empty critical section: a worker between its predicate check and
+        // its wait would otherwise miss this notification
+        {
+            std::lock_guard<std::mutex> lock(m_wakeMutex);
+        }
+        m_wakeCondition.notify_one();
+    }
+}
+
+bool JobSystem::TryPop(int queueIndex, Job& job)
+{
+    WorkQueue& queue = *m_queues[queueIndex];
+    std::lock_guard<std::mutex> lock(queue.mutex);
+    if (queue.jobs.empty())
+    {
+        return false;
+    }
+
+    job = std::move(queue.jobs.back());
+    queue.jobs.pop_back();
+    m_queuedJobs--;
+    return true;
+}
+
+bool JobSystem::TrySteal(int thiefIndex, Job& job)
+{
+    size_t queueCount = m_queues.size();
+    for (size_t offset = 1; offset < queueCount; ++offset)
+    {
+        WorkQueue& queue = *m_queues[(thiefIndex + offset) % queueCount];
+        std::lock_guard<std::mutex> lock(queue.mutex);
+        if (queue.jobs.empty())
+        {
+            continue;
+        }
+
+        // Oldest job first: usually the largest remaining piece of work
+        job = std::move(queue.jobs.front());
+        queue.jobs.pop_front();
+        m_queuedJobs--;
+        m_jobsStolen.fetch_add(1, std::memory_order_relaxed);
+        return true;
+    }
+
+    return false;
+}
+
+bool JobSystem::TryRunOne(bool fromWaiter)
+{
+    if (m_queues.empty() || m_queuedJobs.load() <= 0)
+    {
+        return false;
+    }
+
+    int queueIndex = GetCurrentQueueIndex();
+
+    Job job;
+    if (!TryPop(queueIndex, job) && !TrySteal(queueIndex, job))
+    {
+        return false;
+    }
+
+    if (fromWaiter)
+    {
+        m_jobsRunByWaiters.fetch_add(1, std::memory_order_relaxed);
+    }
+
+    Execute(job);
+    return true;
+}
+
+void JobSystem::Execute(Job& job)
+{
+    if (job.function)
+    {
+        PROFILE_ZONE("Job");
+        job.function();
+    }
+
+    m_jobsExecuted.fetch_add(1, std::memory_order_relaxed);
+    Finish(job.counter);
+}
+
+void JobSystem::Finish(JobCounter* counter)
+{
+    if (!counter)
+    {
+        return;
+    }
+
+    // The counter is only touched under its lock (see Wait); the last job
+    // releases the jobs that were waiting on it
+    std::vector<Job> continuations;
+    {
+        std::lock_guard<std::mutex> lock(counter->m_continuationMutex);
+        if (counter->m_pending.fetch_sub(1, std::memory_order_acq_rel) != 1)
+        {
+            return;
+        }
+        continuations.swap(counter->m_continuations);
+    }
+
+    for (Job& continuation : continuations)
+    {
+        if (m_initialized)
+        {
+            Push(std::move(continuation));
+        }
+        else
+        {
+            Execute(continuation);
+        }
+    }
+}
+
+int JobSystem::GetCurrentQueueIndex() const
+{
+    return t_ownerSystem == this ? t_queueIndex : 0;
+}
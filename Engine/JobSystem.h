@@ -0,0 +1,136 @@
+#pragma once
+
+#include <atomic>
+#include <functional>
+#include <thread>
+#include <vector>
+#include <deque>
+#include <mutex>
+#include <condition_variable>
+#include <memory>
+#include <cstdint>
+
+// Splits [0, count) into ranges and runs the body on them, possibly in parallel
+typedef std::function<void(size_t count, const std::function<void(size_t begin, size_t end)>& body)> ParallelForFunction;
+
+typedef std::function<void()> JobFunction;
+
+class JobCounter;
+
+// Unit of work as stored in the worker queues
+struct Job
+{
+    JobFunction function;
+    JobCounter* counter;
+};
+
+// Tracks outstanding jobs. Jobs scheduled with a dependency on a counter are
+// held here and released once it drops to zero.
+class JobCounter
+{
+public:
+    JobCounter() : m_pending(0) {}
+
+    bool IsDone() const { return m_pending.load(std::memory_order_acquire) == 0; }
+    int GetPending() const { return m_pending.load(std::memory_order_acquire); }
+
+private:
+    friend class JobSystem;
+
+    JobCounter(const JobCounter&) = delete;
+    JobCounter& operator=(const JobCounter&) = delete;
+
+    std::atomic<int> m_pending;
+    std::mutex m_continuationMutex;
+    std::vector<Job> m_continuations;
+};
+
+// Totals since Initialize
+struct JobSystemStats
+{
+    int workerCount;
+    uint64_t jobsExecuted;
+    uint64_t jobsStolen;
+    uint64_t jobsRunByWaiters;
+
+    JobSystemStats()
+        : workerCount(0)
+        , jobsExecuted(0)
+        , jobsStolen(0)
+        , jobsRunByWaiters(0)
+    {
+    }
+};
+
+// Work-stealing task scheduler.
+//
+// Each worker owns a deque: it pushes and pops at the back (LIFO, cache warm)
+// while idle workers steal from the front of other deques. Threads that are
+// not workers (main thread, GameLoop update thread) share an extra queue.
+// Wait() never blocks idly: the waiting thread runs queued jobs until the
+// counter completes, so fork-join from any thread cannot deadlock the pool.
+class JobSystem
+{
+public:
+    JobSystem();
+    ~JobSystem();
+
+    // workerCount < 0 uses one worker per hardware thread minus the caller;
+    // with 0 workers every job runs on the thread that waits for it
+    bool Initialize(int workerCount = -1);
+    void Shutdown();
+
+    // Scheduling; the counter (optional) is incremented now and decremented
+    // when the job finishes
+    void Run(JobFunction function, JobCounter* counter = nullptr);
+
+    // Runs the job only after every job tracked by dependency has finished
+    void RunAfter(JobCounter& dependency, JobFunction function, JobCounter* counter = nullptr);
+
+    // Runs queued jobs on the calling thread until the counter reaches zero
+    void Wait(JobCounter& counter);
+
+    // Fork-join over [0, count); ranges are at least minBatchSize long
+    void ParallelFor(size_t count, size_t minBatchSize, const std::function<void(size_t begin, size_t end)>& body);
+
+    // Adapter for SceneGraph, AnimationController and ModelLoader
+    ParallelForFunction GetParallelForFunction(size_t minBatchSize = 64);
+
+    int GetWorkerCount() const { return static_cast<int>(m_workers.size()); }
+    JobSystemStats GetStats() const;
+    bool IsInitialized() const { return m_initialized; }
+
+private:
+    struct WorkQueue
+    {
+        std::mutex mutex;
+        std::deque<Job> jobs;
+    };
+
+    void WorkerMain(int workerIndex);
+    void Push(Job job);
+    bool TryPop(int queueIndex, Job& job);
+    bool TrySteal(int thiefIndex, Job& job);
+    bool TryRunOne(bool fromWaiter);
+    void Execute(Job& job);
+    void Finish(JobCounter* counter);
+    int GetCurrentQueueIndex() const;
+
+private:
+    std::vector<std::thread> m_workers;
+
+    // Queue 0 is shared by non-worker threads, queue i + 1 belongs to worker i
+    std::vector<std::unique_ptr<WorkQueue>> m_queues;
+
+    std::atomic<int> m_queuedJobs;
+    std::atomic<int> m_sleepingWorkers;
+    std::atomic<bool> m_isRunning;
+    std::mutex m_wakeMutex;
+    std::condition_variable m_wakeCondition;
+    bool m_initialized;
+
+    // Statistics
+    std::atomic<uint64_t> m_jobsExecuted;
+    std::atomic<uint64_t> m_jobsStolen;
+    std::atomic<uint64_t> m_jobsRunByWaiters;
+};
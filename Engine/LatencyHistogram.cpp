@@ -0,0 +1,353 @@
+#include "LatencyHistogram.h"
+#include <iostream>
+#include <fstream>
+#include <algorithm>
+#include <cmath>
+
+namespace
+{
+    const uint64_t MAX_RECORDED_VALUE = (1ull << 32) - 1;
+
+    int HighestBit(uint64_t value)
+    {
+        int bit = 0;
+        while (value >>= 1)
+        {
+            bit++;
+        }
+        return bit;
+    }
+
+    double MicrosecondsToMs(uint64_t microseconds)
+    {
+        return static_cast<double>(microseconds) / 1000.0;
+    }
+
+    void UpdateMin(std::atomic<uint64_t>& target, uint64_t value)
+    {
+        uint64_t current = target.load(std::memory_order_relaxed);
+        while (value < current && !target.compare_exchange_weak(current, value, std::memory_order_relaxed))
+        {
+        }
+    }
+
+    void UpdateMax(std::atomic<uint64_t>& target, uint64_t value)
+    {
+        uint64_t current = target.load(std::memory_order_relaxed);
+        while (value > current && !target.compare_exchange_weak(current, value, std::memory_order_relaxed))
+        {
+        }
+    }
+
+    // Same escaping as the Chrome trace export (Profiler::WriteChromeTrace)
+    void WriteJsonString(std::ofstream& file, const std::string& text)
+    {
+        file << '"';
+        for (char c : text)
+        {
+            if (c == '"' || c == '\\')
+            {
+                file << '\\';
+            }
+            file << c;
+        }
+        file << '"';
+    }
+}
+
+LatencyHistogram::LatencyHistogram(const std::string& name)
+    : m_name(name)
+    , m_count(0)
+    , m_sum(0)
+    , m_min(UINT64_MAX)
+    , m_max(0)
+{
+    for (int i = 0; i < BUCKET_COUNT; ++i)
+    {
+        m_buckets[i].store(0, std::memory_order_relaxed);
+    }
+
+    for (int i = 0; i < MAX_HITCH_THRESHOLDS; ++i)
+    {
+        m_hitchThresholdsUs[i] = UINT64_MAX;
+        m_hitchCounts[i].store(0, std::memory_order_relaxed);
+    }
+}
+
+void LatencyHistogram::Record(double milliseconds)
+{
+    double microseconds = std::max(0.0, milliseconds * 1000.0);
+    uint64_t value = std::min(static_cast<uint64_t>(microseconds + 0.5), MAX_RECORDED_VALUE);
+
+    m_buckets[GetBucketIndex(value)].fetch_add(1, std::memory_order_relaxed);
+    m_count.fetch_add(1, std::memory_order_relaxed);
+    m_sum.fetch_add(value, std::memory_order_relaxed);
+    UpdateMin(m_min, value);
+    UpdateMax(m_max, value);
+
+    // Unused thresholds are UINT64_MAX and never match
+    for (int i = 0; i < MAX_HITCH_THRESHOLDS; ++i)
+    {
+        if (value > m_hitchThresholdsUs[i])
+        {
+            m_hitchCounts[i].fetch_add(1, std::memory_order_relaxed);
+        }
+    }
+}
+
+void LatencyHistogram::SetHitchThresholds(const std::vector<double>& thresholdsMs)
+{
+    m_hitchThresholdsMs.assign(thresholdsMs.begin(),
+                               thresholdsMs.begin() + std::min<size_t>(thresholdsMs.size(), MAX_HITCH_THRESHOLDS));
+    std::sort(m_hitchThresholdsMs.begin(), m_hitchThresholdsMs.end());
+
+    for (int i = 0; i < MAX_HITCH_THRESHOLDS; ++i)
+    {
+        m_hitchThresholdsUs[i] = i < static_cast<int>(m_hitchThresholdsMs.size())
+            ? static_cast<uint64_t>(m_hitchThresholdsMs[i] * 1000.0 + 0.5)
+            : UINT64_MAX;
+        m_hitchCounts[i].store(0, std::memory_order_relaxed);
+    }
+
+    if (thresholdsMs.size() > MAX_HITCH_THRESHOLDS)
+    {
+        std::cerr << "LatencyHistogram: Only the first " << MAX_HITCH_THRESHOLDS
+                  << " hitch thresholds of " << m_name << " are used" << std::endl;
+    }
+}
+
+uint64_t LatencyHistogram::GetHitchCount(size_t thresholdIndex) const
+{
+    if (thresholdIndex >= m_hitchThresholdsMs.size())
+    {
+        return 0;
+    }
+
+    return m_hitchCounts[thresholdIndex].load(std::memory_order_relaxed);
+}
+
+double LatencyHistogram::GetPercentile(double percentile) const
+{
+    uint64_t count = GetCount();
+    if (count == 0)
+    {
+        return 0.0;
+    }
+
+    // Rank of the sample at this percentile (1-based, nearest-rank method)
+    percentile = std::max(0.0, std::min(100.0, percentile));
+    uint64_t rank = static_cast<uint64_t>(std::ceil(percentile / 100.0 * static_cast<double>(count)));
+    rank = std::max<uint64_t>(rank, 1);
+
+    uint64_t maxValue = m_max.load(std::memory_order_relaxed);
+    uint64_t cumulative = 0;
+    for (int i = 0; i < BUCKET_COUNT; ++i)
+    {
+        cumulative += m_buckets[i].load(std::memory_order_relaxed);
+        if (cumulative >= rank)
+        {
+            // Report the top of the bucket so percentiles never under-state
+            return MicrosecondsToMs(std::min(GetBucketHighestValue(i), maxValue));
+        }
+    }
+
+    return MicrosecondsToMs(maxValue);
+}
+
+double LatencyHistogram::GetMin() const
+{
+    return GetCount() > 0 ? MicrosecondsToMs(m_min.load(std::memory_order_relaxed)) : 0.0;
+}
+
+double LatencyHistogram::GetMax() const
+{
+    return MicrosecondsToMs(m_max.load(std::memory_order_relaxed));
+}
+
+double LatencyHistogram::GetMean() const
+{
+    uint64_t count = GetCount();
+    return count > 0 ? MicrosecondsToMs(m_sum.load(std::memory_order_relaxed)) / static_cast<double>(count) : 0.0;
+}
+
+LatencySummary LatencyHistogram::GetSummary() const
+{
+    LatencySummary summary;
+    summary.name = m_name;
+    summary.count = GetCount();
+    summary.minMs = GetMin();
+    summary.meanMs = GetMean();
+    summary.p50Ms = GetPercentile(50.0);
+    summary.p95Ms = GetPercentile(95.0);
+    summary.p99Ms = GetPercentile(99.0);
+    summary.maxMs = GetMax();
+    summary.hitchThresholdsMs = m_hitchThresholdsMs;
+
+    for (size_t i = 0; i < m_hitchThresholdsMs.size(); ++i)
+    {
+        summary.hitchCounts.push_back(GetHitchCount(i));
+    }
+
+    return summary;
+}
+
+void LatencyHistogram::GetBuckets(std::vector<std::pair<double, uint64_t>>& buckets) const
+{
+    buckets.clear();
+    for (int i = 0; i < BUCKET_COUNT; ++i)
+    {
+        uint64_t count = m_buckets[i].load(std::memory_order_relaxed);
+        if (count > 0)
+        {
+            buckets.push_back(std::make_pair(MicrosecondsToMs(GetBucketHighestValue(i)), count));
+        }
+    }
+}
+
+void LatencyHistogram::Reset()
+{
+    for (int i = 0; i < BUCKET_COUNT; ++i)
+    {
+        m_buckets[i].store(0, std::memory_order_relaxed);
+    }
+
+    for (int i = 0; i < MAX_HITCH_THRESHOLDS; ++i)
+    {
+        m_hitchCounts[i].store(0, std::memory_order_relaxed);
+    }
+
+    m_count.store(0, std::memory_order_relaxed);
+    m_sum.store(0, std::memory_order_relaxed);
+    m_min.store(UINT64_MAX, std::memory_order_relaxed);
+    m_max.store(0, std::memory_order_relaxed);
+}
+
+int LatencyHistogram::GetBucketIndex(uint64_t microseconds)
+{
+    microseconds = std::min(microseconds, MAX_RECORDED_VALUE);
+    if (microseconds < SUB_BUCKET_COUNT)
+    {
+        return static_cast<int>(microseconds);
+    }
+
+    // Keep the top SUB_BUCKET_BITS bits; the shift selects the power of two
+    int shift = HighestBit(microseconds) - SUB_BUCKET_BITS + 1;
+    return shift * SUB_BUCKET_HALF + static_cast<int>(microseconds >> shift);
+}
+
+uint64_t LatencyHistogram::GetBucketLowestValue(int bucketIndex)
+{
+    if (bucketIndex < SUB_BUCKET_COUNT)
+    {
+        return static_cast<uint64_t>(bucketIndex);
+    }
+
+    int shift = bucketIndex / SUB_BUCKET_HALF - 1;
+    uint64_t subBucket = static_cast<uint64_t>(bucketIndex - shift * SUB_BUCKET_HALF);
+    return subBucket << shift;
+}
+
+uint64_t LatencyHistogram::GetBucketHighestValue(int bucketIndex)
+{
+    if (bucketIndex < SUB_BUCKET_COUNT)
+    {
+        return static_cast<uint64_t>(bucketIndex);
+    }
+
+    int shift = bucketIndex / SUB_BUCKET_HALF - 1;
+    return GetBucketLowestValue(bucketIndex) + (1ull << shift) - 1;
+}
+
+namespace LatencyReport
+{
+    bool WriteCSV(const std::string& filepath, const std::vector<const LatencyHistogram*>& histograms)
+    {
+        std::ofstream file(filepath);
+        if (!file.is_open())
+        {
+            std::cerr << "LatencyReport: Failed to open " << filepath << std::endl;
+            return false;
+        }
+
+        file << "metric,statistic,value\n";
+        for (const LatencyHistogram* histogram : histograms)
+        {
+            if (!histogram)
+                continue;
+
+            LatencySummary summary = histogram->GetSummary();
+            file << summary.name << ",count," << summary.count << "\n";
+            file << summary.name << ",min_ms," << summary.minMs << "\n";
+            file << summary.name << ",mean_ms," << summary.meanMs << "\n";
+            file << summary.name << ",p50_ms," << summary.p50Ms << "\n";
+            file << summary.name << ",p95_ms," << summary.p95Ms << "\n";
+            file << summary.name << ",p99_ms," << summary.p99Ms << "\n";
+            file << summary.name << ",max_ms," << summary.maxMs << "\n";
+
+            for (size_t i = 0; i < summary.hitchThresholdsMs.size(); ++i)
+            {
+                file << summary.name << ",hitches_over_" << summary.hitchThresholdsMs[i] << "_ms,"
+                     << summary.hitchCounts[i] << "\n";
+            }
+        }
+
+        return file.good();
+    }
+
+    bool WriteJSON(const std::string& filepath, const std::vector<const LatencyHistogram*>& histograms)
+    {
+        std::ofstream file(filepath);
+        if (!file.is_open())
+        {
+            std::cerr << "LatencyReport: Failed to open " << filepath << std::endl;
+            return false;
+        }
+
+        std::vector<std::pair<double, uint64_t>> buckets;
+        bool first = true;
+
+        file << "{\n  \"histograms\": [";
+        for (const LatencyHistogram* histogram : histograms)
+        {
+            if (!histogram)
+                continue;
+
+            LatencySummary summary = histogram->GetSummary();
+            file << (first ? "\n" : ",\n");
+            first = false;
+
+            file << "    {\n";
+            file << "      \"name\": ";
+            WriteJsonString(file, summary.name);
+            file << ",\n";
+            file << "      \"count\": " << summary.count << ",\n";
+            file << "      \"min_ms\": " << summary.minMs << ",\n";
+            file << "      \"mean_ms\": " << summary.meanMs << ",\n";
+            file << "      \"p50_ms\": " << summary.p50Ms << ",\n";
+            file << "      \"p95_ms\": " << summary.p95Ms << ",\n";
+            file << "      \"p99_ms\": " << summary.p99Ms << ",\n";
+            file << "      \"max_ms\": " << summary.maxMs << ",\n";
+
+            file << "      \"hitches\": [";
+            for (size_t i = 0; i < summary.hitchThresholdsMs.size(); ++i)
+            {
+                file << (i > 0 ? ", " : "") << "{ \"threshold_ms\": " << summary.hitchThresholdsMs[i]
+                     << ", \"count\": " << summary.hitchCounts[i] << " }";
+            }
+            file << "],\n";
+
+            // Each bucket as [upper bound in ms, count]
+            histogram->GetBuckets(buckets);
+            file << "      \"buckets\": [";
+            for (size_t i = 0; i < buckets.size(); ++i)
+            {
+                file << (i > 0 ? ", " : "") << "[" << buckets[i].first << ", " << buckets[i].second << "]";
+            }
+            file << "]\n";
+            file << "    }";
+        }
+        file << "\n  ]\n}\n";
+
+        return file.good();
+    }
+}
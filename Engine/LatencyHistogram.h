@@ -0,0 +1,105 @@
+#pragma once
+
+#include <atomic>
+#include <string>
+#include <vector>
+#include <cstdint>
+
+// Summary of a histogram at one point in time; times in milliseconds
+struct LatencySummary
+{
+    std::string name;
+    uint64_t count;
+    double minMs;
+    double meanMs;
+    double p50Ms;
+    double p95Ms;
+    double p99Ms;
+    double maxMs;
+    std::vector<double> hitchThresholdsMs;
+    std::vector<uint64_t> hitchCounts;
+
+    LatencySummary()
+        : count(0)
+        , minMs(0.0)
+        , meanMs(0.0)
+        , p50Ms(0.0)
+        , p95Ms(0.0)
+        , p99Ms(0.0)
+        , maxMs(0.0)
+    {
+    }
+};
+
+// Log-linear (HDR-style) latency histogram.
+//
+// Values are recorded in whole microseconds. Values below 128 us get one
+// bucket each; above that every power of two is split into 64 buckets, so
+// any percentile is reported within 1/64 (about 1.6%) of the true value from
+// 1 us up to over an hour, in a fixed 13 KB of counters.
+//
+// Record() is lock-free and may be called from several threads at once.
+// Configuration (SetHitchThresholds) and Reset() must not race with it.
+class LatencyHistogram
+{
+public:
+    static const int MAX_HITCH_THRESHOLDS = 4;
+
+    explicit LatencyHistogram(const std::string& name = "");
+
+    void Record(double milliseconds);
+
+    // Frames slower than each threshold are counted separately
+    void SetHitchThresholds(const std::vector<double>& thresholdsMs);
+    const std::vector<double>& GetHitchThresholds() const { return m_hitchThresholdsMs; }
+    uint64_t GetHitchCount(size_t thresholdIndex) const;
+
+    // Queries (consistent enough for telemetry while recording continues)
+    uint64_t GetCount() const { return m_count.load(std::memory_order_relaxed); }
+    double GetPercentile(double percentile) const;
+    double GetMin() const;
+    double GetMax() const;
+    double GetMean() const;
+    LatencySummary GetSummary() const;
+
+    // Non-empty buckets as (highest value in bucket in ms, count)
+    void GetBuckets(std::vector<std::pair<double, uint64_t>>& buckets) const;
+
+    const std::string& GetName() const { return m_name; }
+    void Reset();
+
+    // Bucket mapping, exposed for validation
+    static int GetBucketIndex(uint64_t microseconds);
+    static uint64_t GetBucketLowestValue(int bucketIndex);
+    static uint64_t GetBucketHighestValue(int bucketIndex);
+
+private:
+    static const int SUB_BUCKET_BITS = 7;
+    static const int SUB_BUCKET_COUNT = 1 << SUB_BUCKET_BITS;
+    static const int SUB_BUCKET_HALF = SUB_BUCKET_COUNT / 2;
+
+    // Values are clamped to 2^32 us (about 71 minutes)
+    static const int MAX_VALUE_BITS = 32;
+    static const int BUCKET_COUNT = (MAX_VALUE_BITS - SUB_BUCKET_BITS + 2) * SUB_BUCKET_HALF;
+
+    std::string m_name;
+    std::atomic<uint64_t> m_buckets[BUCKET_COUNT];
+    std::atomic<uint64_t> m_count;
+    std::atomic<uint64_t> m_sum;
+    std::atomic<uint64_t> m_min;
+    std::atomic<uint64_t> m_max;
+
+    std::vector<double> m_hitchThresholdsMs;
+    uint64_t m_hitchThresholdsUs[MAX_HITCH_THRESHOLDS];
+    std::atomic<uint64_t> m_hitchCounts[MAX_HITCH_THRESHOLDS];
+};
+
+// Writes histogram summaries for offline analysis
+namespace LatencyReport
+{
+    // One "metric,statistic,value" row per statistic
+    bool WriteCSV(const std::string& filepath, const std::vector<const LatencyHistogram*>& histograms);
+
+    // Summaries plus the non-empty buckets of every histogram
+    bool WriteJSON(const std::string& filepath, const std::vector<const LatencyHistogram*>& histograms);
+}
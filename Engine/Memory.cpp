@@ -0,0 +1,749 @@
+#include "Memory.h"
+#include <iostream>
+#include <iomanip>
+#include <algorithm>
+#include <unordered_map>
+
+namespace
+{
+    const size_t BLOCK_ALIGNMENT = 64;
+    const size_t SUBSYSTEM_COUNT = static_cast<size_t>(MemorySubsystem::Count);
+
+    // Counters of one thread. Only the owning thread writes them, with plain
+    // load/store pairs; other threads read them while summing. Frees may
+    // happen on another thread than the allocation, so values are signed and
+    // only the sum over all threads is meaningful.
+    struct ThreadMemoryCounters
+    {
+        std::atomic<int64_t> allocationCount[SUBSYSTEM_COUNT];
+        std::atomic<int64_t> freeCount[SUBSYSTEM_COUNT];
+        std::atomic<int64_t> bytesInUse[SUBSYSTEM_COUNT];
+
+        ThreadMemoryCounters()
+        {
+            for (size_t i = 0; i < SUBSYSTEM_COUNT; ++i)
+            {
+                allocationCount[i].store(0, std::memory_order_relaxed);
+                freeCount[i].store(0, std::memory_order_relaxed);
+                bytesInUse[i].store(0, std::memory_order_relaxed);
+            }
+        }
+    };
+
+    // Reserved bytes change rarely (blocks, pages), so they stay global and
+    // get an exact high-water mark and budget check
+    std::atomic<int64_t> g_bytesReserved[SUBSYSTEM_COUNT];
+    std::atomic<int64_t> g_peakBytesReserved[SUBSYSTEM_COUNT];
+    std::atomic<int64_t> g_subsystemBudget[SUBSYSTEM_COUNT];
+    std::atomic<bool> g_subsystemOverBudget[SUBSYSTEM_COUNT];
+
+    const size_t CATEGORY_COUNT = static_cast<size_t>(MemoryCategory::Count);
+
+    struct ResourceEntry
+    {
+        std::string asset;
+        uint64_t bytes;
+    };
+
+    struct CategoryState
+    {
+        std::unordered_map<const void*, ResourceEntry> entries;
+        uint64_t bytes;
+        uint64_t peakBytes;
+        uint64_t budgetBytes;
+        bool overBudget;
+
+        CategoryState() : bytes(0), peakBytes(0), budgetBytes(0), overBudget(false) {}
+    };
+
+    // Resource accounting changes only when resources are created, resized
+    // or destroyed, so a single mutex is enough
+    struct AccountingState
+    {
+        std::mutex mutex;
+        CategoryState categories[CATEGORY_COUNT];
+    };
+
+    // Never destroyed, like the counter registry: resources held by statics
+    // untrack themselves during static destruction
+    AccountingState& GetAccounting()
+    {
+        static AccountingState* state = new AccountingState();
+        return *state;
+    }
+
+    void WarnOverBudget(const char* name, uint64_t bytes, uint64_t budget)
+    {
+        std::cerr << "Memory: " << name << " over budget: " << (bytes / 1024) << " KB of "
+                  << (budget / 1024) << " KB" << std::endl;
+    }
+
+    // Counters outlive their threads, and the registry is never destroyed:
+    // pooled objects may be freed during static destruction
+    std::mutex& GetRegistryMutex()
+    {
+        static std::mutex* mutex = new std::mutex();
+        return *mutex;
+    }
+
+    std::vector<ThreadMemoryCounters*>& GetThreadCounterList()
+    {
+        static std::vector<ThreadMemoryCounters*>* counters = new std::vector<ThreadMemoryCounters*>();
+        return *counters;
+    }
+
+    thread_local ThreadMemoryCounters* t_counters = nullptr;
+
+    ThreadMemoryCounters& GetThreadCounters()
+    {
+        if (!t_counters)
+        {
+            ThreadMemoryCounters* counters = new ThreadMemoryCounters();
+            std::lock_guard<std::mutex> lock(GetRegistryMutex());
+            GetThreadCounterList().push_back(counters);
+            t_counters = counters;
+        }
+        return *t_counters;
+    }
+
+    void AddOwned(std::atomic<int64_t>& counter, int64_t value)
+    {
+        counter.store(counter.load(std::memory_order_relaxed) + value, std::memory_order_relaxed);
+    }
+
+    void* AllocateAligned(size_t size, size_t alignment)
+    {
+        return ::operator new(size, std::align_val_t(alignment));
+    }
+
+    void FreeAligned(void* pointer, size_t alignment)
+    {
+        ::operator delete(pointer, std::align_val_t(alignment));
+    }
+}
+
+// ---------------------------------------------------------------------------
+// Statistics
+// ---------------------------------------------------------------------------
+
+const char* Memory::GetSubsystemName(MemorySubsystem subsystem)
+{
+    switch (subsystem)
+    {
+    case MemorySubsystem::General: return "General";
+    case MemorySubsystem::Loading: return "Loading";
+    case MemorySubsystem::Resources: return "Resources";
+    case MemorySubsystem::Animation: return "Animation";
+    case MemorySubsystem::Scene: return "Scene";
+    case MemorySubsystem::Rendering: return "Rendering";
+    case MemorySubsystem::Frame: return "Frame";
+    default: return "Unknown";
+    }
+}
+
+void Memory::RecordAllocation(MemorySubsystem subsystem, size_t bytes)
+{
+    ThreadMemoryCounters& counters = GetThreadCounters();
+    size_t index = static_cast<size_t>(subsystem);
+    AddOwned(counters.allocationCount[index], 1);
+    AddOwned(counters.bytesInUse[index], static_cast<int64_t>(bytes));
+}
+
+void Memory::RecordFree(MemorySubsystem subsystem, size_t bytes, uint64_t count)
+{
+    ThreadMemoryCounters& counters = GetThreadCounters();
+    size_t index = static_cast<size_t>(subsystem);
+    AddOwned(counters.freeCount[index], static_cast<int64_t>(count));
+    AddOwned(counters.bytesInUse[index], -static_cast<int64_t>(bytes));
+}
+
+void Memory::RecordReserve(MemorySubsystem subsystem, size_t bytes)
+{
+    size_t index = static_cast<size_t>(subsystem);
+    int64_t reserved = g_bytesReserved[index].fetch_add(static_cast<int64_t>(bytes), std::memory_order_relaxed) +
+                       static_cast<int64_t>(bytes);
+
+    int64_t peak = g_peakBytesReserved[index].load(std::memory_order_relaxed);
+    while (reserved > peak &&
+           !g_peakBytesReserved[index].compare_exchange_weak(peak, reserved, std::memory_order_relaxed))
+    {
+    }
+
+    int64_t budget = g_subsystemBudget[index].load(std::memory_order_relaxed);
+    if (budget > 0 && reserved > budget && !g_subsystemOverBudget[index].exchange(true, std::memory_order_relaxed))
+    {
+        WarnOverBudget(GetSubsystemName(subsystem), static_cast<uint64_t>(reserved), static_cast<uint64_t>(budget));
+    }
+}
+
+void Memory::RecordUnreserve(MemorySubsystem subsystem, size_t bytes)
+{
+    size_t index = static_cast<size_t>(subsystem);
+    int64_t reserved = g_bytesReserved[index].fetch_sub(static_cast<int64_t>(bytes), std::memory_order_relaxed) -
+                       static_cast<int64_t>(bytes);
+
+    int64_t budget = g_subsystemBudget[index].load(std::memory_order_relaxed);
+    if (reserved <= budget)
+    {
+        g_subsystemOverBudget[index].store(false, std::memory_order_relaxed);
+    }
+}
+
+MemorySubsystemStats Memory::GetStats(MemorySubsystem subsystem)
+{
+    size_t index = static_cast<size_t>(subsystem);
+    int64_t allocationCount = 0;
+    int64_t freeCount = 0;
+    int64_t bytesInUse = 0;
+
+    {
+        std::lock_guard<std::mutex> lock(GetRegistryMutex());
+        for (const ThreadMemoryCounters* counters : GetThreadCounterList())
+        {
+            allocationCount += counters->allocationCount[index].load(std::memory_order_relaxed);
+            freeCount += counters->freeCount[index].load(std::memory_order_relaxed);
+            bytesInUse += counters->bytesInUse[index].load(std::memory_order_relaxed);
+        }
+    }
+
+    // Threads are read one after another, so a sum can be briefly negative
+    MemorySubsystemStats stats;
+    stats.allocationCount = static_cast<uint64_t>(std::max<int64_t>(allocationCount, 0));
+    stats.freeCount = static_cast<uint64_t>(std::max<int64_t>(freeCount, 0));
+    stats.bytesInUse = static_cast<uint64_t>(std::max<int64_t>(bytesInUse, 0));
+    stats.bytesReserved = static_cast<uint64_t>(std::max<int64_t>(g_bytesReserved[index].load(std::memory_order_relaxed), 0));
+    stats.peakBytesReserved = static_cast<uint64_t>(g_peakBytesReserved[index].load(std::memory_order_relaxed));
+    stats.budgetBytes = static_cast<uint64_t>(g_subsystemBudget[index].load(std::memory_order_relaxed));
+    return stats;
+}
+
+void Memory::PrintStats()
+{
+    std::cout << "Memory: " << std::left << std::setw(14) << "subsystem"
+              << std::right << std::setw(14) << "allocations"
+              << std::setw(14) << "frees"
+              << std::setw(14) << "in use (KB)"
+              << std::setw(16) << "reserved (KB)"
+              << std::setw(12) << "peak (KB)" << std::endl;
+
+    for (size_t i = 0; i < SUBSYSTEM_COUNT; ++i)
+    {
+        MemorySubsystem subsystem = static_cast<MemorySubsystem>(i);
+        MemorySubsystemStats stats = GetStats(subsystem);
+
+        std::cout << "Memory: " << std::left << std::setw(14) << GetSubsystemName(subsystem)
+                  << std::right << std::setw(14) << stats.allocationCount
+                  << std::setw(14) << stats.freeCount
+                  << std::setw(14) << (stats.bytesInUse / 1024)
+                  << std::setw(16) << (stats.bytesReserved / 1024)
+                  << std::setw(12) << (stats.peakBytesReserved / 1024) << std::endl;
+    }
+}
+
+// ---------------------------------------------------------------------------
+// Resource accounting
+// ---------------------------------------------------------------------------
+
+const char* Memory::GetCategoryName(MemoryCategory category)
+{
+    switch (category)
+    {
+    case MemoryCategory::MeshCpu: return "MeshCpu";
+    case MemoryCategory::MeshGpu: return "MeshGpu";
+    case MemoryCategory::Textures: return "Textures";
+    case MemoryCategory::RenderTargets: return "RenderTargets";
+    case MemoryCategory::Animation: return "Animation";
+    default: return "Unknown";
+    }
+}
+
+void Memory::TrackResource(MemoryCategory category, const void* owner, const std::string& asset, size_t bytes)
+{
+    if (!owner)
+    {
+        return;
+    }
+
+    if (bytes == 0)
+    {
+        UntrackResource(category, owner);
+        return;
+    }
+
+    AccountingState& accounting = GetAccounting();
+    std::lock_guard<std::mutex> lock(accounting.mutex);
+    CategoryState& state = accounting.categories[static_cast<size_t>(category)];
+
+    ResourceEntry& entry = state.entries[owner];
+    state.bytes = state.bytes - entry.bytes + bytes;
+    entry.bytes = bytes;
+    entry.asset = asset;
+
+    state.peakBytes = std::max(state.peakBytes, state.bytes);
+
+    if (state.budgetBytes > 0 && state.bytes > state.budgetBytes && !state.overBudget)
+    {
+        state.overBudget = true;
+        WarnOverBudget(GetCategoryName(category), state.bytes, state.budgetBytes);
+    }
+}
+
+void Memory::UntrackResource(MemoryCategory category, const void* owner)
+{
+    AccountingState& accounting = GetAccounting();
+    std::lock_guard<std::mutex> lock(accounting.mutex);
+    CategoryState& state = accounting.categories[static_cast<size_t>(category)];
+
+    auto it = state.entries.find(owner);
+    if (it == state.entries.end())
+    {
+        return;
+    }
+
+    state.bytes -= it->second.bytes;
+    state.entries.erase(it);
+
+    if (state.bytes <= state.budgetBytes)
+    {
+        state.overBudget = false;
+    }
+}
+
+void Memory::UntrackResources(const void* owner)
+{
+    for (size_t i = 0; i < CATEGORY_COUNT; ++i)
+    {
+        UntrackResource(static_cast<MemoryCategory>(i), owner);
+    }
+}
+
+MemoryCategoryStats Memory::GetCategoryStats(MemoryCategory category)
+{
+    AccountingState& accounting = GetAccounting();
+    std::lock_guard<std::mutex> lock(accounting.mutex);
+    const CategoryState& state = accounting.categories[static_cast<size_t>(category)];
+
+    MemoryCategoryStats stats;
+    stats.bytes = state.bytes;
+    stats.peakBytes = state.peakBytes;
+    stats.resourceCount = state.entries.size();
+    stats.budgetBytes = state.budgetBytes;
+    return stats;
+}
+
+std::vector<MemoryAssetUsage> Memory::GetAssetUsage()
+{
+    std::unordered_map<std::string, MemoryAssetUsage> assets;
+
+    {
+        AccountingState& accounting = GetAccounting();
+        std::lock_guard<std::mutex> lock(accounting.mutex);
+
+        for (size_t i = 0; i < CATEGORY_COUNT; ++i)
+        {
+            for (const auto& pair : accounting.categories[i].entries)
+            {
+                MemoryAssetUsage& usage = assets[pair.second.asset];
+                usage.bytes[i] += pair.second.bytes;
+                usage.totalBytes += pair.second.bytes;
+            }
+        }
+    }
+
+    std::vector<MemoryAssetUsage> result;
+    result.reserve(assets.size());
+    for (auto& pair : assets)
+    {
+        pair.second.asset = pair.first;
+        result.push_back(pair.second);
+    }
+
+    std::sort(result.begin(), result.end(), [](const MemoryAssetUsage& a, const MemoryAssetUsage& b)
+    {
+        return a.totalBytes != b.totalBytes ? a.totalBytes > b.totalBytes : a.asset < b.asset;
+    });
+    return result;
+}
+
+void Memory::SetBudget(MemoryCategory category, uint64_t bytes)
+{
+    AccountingState& accounting = GetAccounting();
+    std::lock_guard<std::mutex> lock(accounting.mutex);
+    CategoryState& state = accounting.categories[static_cast<size_t>(category)];
+
+    state.budgetBytes = bytes;
+    state.overBudget = bytes > 0 && state.bytes > bytes;
+    if (state.overBudget)
+    {
+        WarnOverBudget(GetCategoryName(category), state.bytes, bytes);
+    }
+}
+
+void Memory::SetBudget(MemorySubsystem subsystem, uint64_t bytes)
+{
+    size_t index = static_cast<size_t>(subsystem);
+    g_subsystemBudget[index].store(static_cast<int64_t>(bytes), std::memory_order_relaxed);
+
+    int64_t reserved = g_bytesReserved[index].load(std::memory_order_relaxed);
+    bool overBudget = bytes > 0 && reserved > static_cast<int64_t>(bytes);
+    g_subsystemOverBudget[index].store(overBudget, std::memory_order_relaxed);
+    if (overBudget)
+    {
+        WarnOverBudget(GetSubsystemName(subsystem), static_cast<uint64_t>(reserved), bytes);
+    }
+}
+
+void Memory::PrintReport(size_t maxAssets)
+{
+    PrintStats();
+
+    std::cout << "Memory: " << std::left << std::setw(14) << "category"
+              << std::right << std::setw(14) << "resources"
+              << std::setw(14) << "bytes (KB)"
+              << std::setw(14) << "peak (KB)"
+              << std::setw(16) << "budget (KB)" << std::endl;
+
+    for (size_t i = 0; i < CATEGORY_COUNT; ++i)
+    {
+        MemoryCategory category = static_cast<MemoryCategory>(i);
+        MemoryCategoryStats stats = GetCategoryStats(category);
+
+        std::cout << "Memory: " << std::left << std::setw(14) << GetCategoryName(category)
+                  << std::right << std::setw(14) << stats.resourceCount
+                  << std::setw(14) << (stats.bytes / 1024)
+                  << std::setw(14) << (stats.peakBytes / 1024);
+        if (stats.budgetBytes > 0)
+        {
+            std::cout << std::setw(16) << (stats.budgetBytes / 1024);
+        }
+        else
+        {
+            std::cout << std::setw(16) << "-";
+        }
+        std::cout << std::endl;
+    }
+
+    std::vector<MemoryAssetUsage> assets = GetAssetUsage();
+    size_t assetCount = std::min(assets.size(), maxAssets);
+    for (size_t i = 0; i < assetCount; ++i)
+    {
+        std::cout << "Memory: asset " << assets[i].asset << ": " << (assets[i].totalBytes / 1024) << " KB (";
+        bool first = true;
+        for (size_t c = 0; c < CATEGORY_COUNT; ++c)
+        {
+            if (assets[i].bytes[c] == 0)
+            {
+                continue;
+            }
+            std::cout << (first ? "" : ", ") << GetCategoryName(static_cast<MemoryCategory>(c))
+                      << " " << (assets[i].bytes[c] / 1024) << " KB";
+            first = false;
+        }
+        std::cout << ")" << std::endl;
+    }
+
+    if (assets.size() > assetCount)
+    {
+        std::cout << "Memory: ... " << (assets.size() - assetCount) << " more assets" << std::endl;
+    }
+}
+
+uint64_t Memory::GetTextureBytes(int width, int height, int bitsPerPixel, int mipLevels)
+{
+    uint64_t bytes = 0;
+    uint64_t levelWidth = static_cast<uint64_t>(std::max(width, 1));
+    uint64_t levelHeight = static_cast<uint64_t>(std::max(height, 1));
+
+    for (int level = 0; level < std::max(mipLevels, 1); ++level)
+    {
+        bytes += (levelWidth * levelHeight * static_cast<uint64_t>(bitsPerPixel) + 7) / 8;
+        if (levelWidth == 1 && levelHeight == 1)
+        {
+            break;
+        }
+        levelWidth = std::max<uint64_t>(levelWidth / 2, 1);
+        levelHeight = std::max<uint64_t>(levelHeight / 2, 1);
+    }
+    return bytes;
+}
+
+uint64_t Memory::GetBlockCompressedTextureBytes(int width, int height, int blockBytes, int mipLevels)
+{
+    uint64_t bytes = 0;
+    uint64_t levelWidth = static_cast<uint64_t>(std::max(width, 1));
+    uint64_t levelHeight = static_cast<uint64_t>(std::max(height, 1));
+
+    for (int level = 0; level < std::max(mipLevels, 1); ++level)
+    {
+        uint64_t blocksWide = std::max<uint64_t>((levelWidth + 3) / 4, 1);
+        uint64_t blocksHigh = std::max<uint64_t>((levelHeight + 3) / 4, 1);
+        bytes += blocksWide * blocksHigh * static_cast<uint64_t>(blockBytes);
+        if (levelWidth == 1 && levelHeight == 1)
+        {
+            break;
+        }
+        levelWidth = std::max<uint64_t>(levelWidth / 2, 1);
+        levelHeight = std::max<uint64_t>(levelHeight / 2, 1);
+    }
+    return bytes;
+}
+
+// ---------------------------------------------------------------------------
+// LinearArena
+// ---------------------------------------------------------------------------
+
+LinearArena::LinearArena(MemorySubsystem subsystem, size_t blockSize)
+    : m_subsystem(subsystem)
+    , m_blockSize(Memory::AlignUp(std::min(std::max<size_t>(blockSize, BLOCK_ALIGNMENT), MAX_BLOCK_SIZE), BLOCK_ALIGNMENT))
+    , m_current(nullptr)
+    , m_blocks(nullptr)
+    , m_reservedBytes(0)
+    , m_blockCount(0)
+{
+}
+
+LinearArena::~LinearArena()
+{
+    Release();
+}
+
+LinearArena::Block* LinearArena::CreateBlock(size_t size)
+{
+    Block* block = new Block();
+    block->data = static_cast<char*>(AllocateAligned(size, BLOCK_ALIGNMENT));
+    block->size = size;
+    block->state.store(0, std::memory_order_relaxed);
+    block->overflow.store(0, std::memory_order_relaxed);
+    block->next = m_blocks;
+
+    m_blocks = block;
+    m_reservedBytes += size;
+    m_blockCount++;
+    Memory::RecordReserve(m_subsystem, size);
+    return block;
+}
+
+void LinearArena::DestroyBlocks()
+{
+    while (m_blocks)
+    {
+        Block* next = m_blocks->next;
+        FreeAligned(m_blocks->data, BLOCK_ALIGNMENT);
+        delete m_blocks;
+        m_blocks = next;
+    }
+
+    Memory::RecordUnreserve(m_subsystem, m_reservedBytes);
+    m_current.store(nullptr, std::memory_order_relaxed);
+    m_reservedBytes = 0;
+    m_blockCount = 0;
+}
+
+void* LinearArena::Allocate(size_t size, size_t alignment)
+{
+    // Sizes are kept multiples of DEFAULT_ALIGNMENT so every offset stays
+    // aligned without a compare-exchange loop; larger alignments pad instead
+    size_t padding = alignment > Memory::DEFAULT_ALIGNMENT ? alignment - Memory::DEFAULT_ALIGNMENT : 0;
+    size_t allocationSize = Memory::AlignUp(std::max<size_t>(size, 1), Memory::DEFAULT_ALIGNMENT) + padding;
+
+    uint64_t increment = static_cast<uint64_t>(allocationSize) | (1ull << COUNT_SHIFT);
+
+    while (true)
+    {
+        Block* block = m_current.load(std::memory_order_acquire);
+        if (block)
+        {
+            size_t offset = static_cast<size_t>(block->state.fetch_add(increment, std::memory_order_relaxed) & OFFSET_MASK);
+            if (offset + allocationSize <= block->size)
+            {
+                Memory::RecordAllocation(m_subsystem, allocationSize);
+
+                uintptr_t address = reinterpret_cast<uintptr_t>(block->data + offset);
+                if (padding > 0)
+                {
+                    address = Memory::AlignUp(address, alignment);
+                }
+                return reinterpret_cast<void*>(address);
+            }
+
+            // Did not fit; it stays counted in the state, so remember it
+            block->overflow.fetch_add(increment, std::memory_order_relaxed);
+        }
+
+        // Current block is full (or there is none); only one thread chains a new one
+        std::lock_guard<std::mutex> lock(m_mutex);
+        if (m_current.load(std::memory_order_relaxed) == block)
+        {
+            // A block larger than MAX_BLOCK_SIZE only ever holds this one allocation
+            Block* newBlock = CreateBlock(std::max(m_blockSize, Memory::AlignUp(allocationSize, BLOCK_ALIGNMENT)));
+            m_current.store(newBlock, std::memory_order_release);
+        }
+    }
+}
+
+size_t LinearArena::GetUsedBytes() const
+{
+    size_t usedBytes = 0;
+    for (const Block* block = m_blocks; block; block = block->next)
+    {
+        uint64_t state = block->state.load(std::memory_order_relaxed) - block->overflow.load(std::memory_order_relaxed);
+        usedBytes += static_cast<size_t>(state & OFFSET_MASK);
+    }
+    return usedBytes;
+}
+
+uint64_t LinearArena::GetAllocationCount() const
+{
+    uint64_t allocationCount = 0;
+    for (const Block* block = m_blocks; block; block = block->next)
+    {
+        uint64_t state = block->state.load(std::memory_order_relaxed) - block->overflow.load(std::memory_order_relaxed);
+        allocationCount += state >> COUNT_SHIFT;
+    }
+    return allocationCount;
+}
+
+void LinearArena::RecordFreeAll()
+{
+    uint64_t allocationCount = GetAllocationCount();
+    if (allocationCount > 0)
+    {
+        Memory::RecordFree(m_subsystem, GetUsedBytes(), allocationCount);
+    }
+}
+
+void LinearArena::Reset()
+{
+    RecordFreeAll();
+
+    // Oversized blocks are replaced too, so reused blocks stay within the cap
+    if (m_blockCount > 1 || m_reservedBytes > MAX_BLOCK_SIZE)
+    {
+        size_t combinedSize = std::min(m_reservedBytes, MAX_BLOCK_SIZE);
+        DestroyBlocks();
+        m_current.store(CreateBlock(combinedSize), std::memory_order_relaxed);
+        return;
+    }
+
+    if (m_blocks)
+    {
+        m_blocks->state.store(0, std::memory_order_relaxed);
+        m_blocks->overflow.store(0, std::memory_order_relaxed);
+    }
+}
+
+void LinearArena::Release()
+{
+    RecordFreeAll();
+    DestroyBlocks();
+}
+
+// ---------------------------------------------------------------------------
+// FrameAllocator
+// ---------------------------------------------------------------------------
+
+FrameAllocator::FrameAllocator(size_t capacity)
+    : m_arena(MemorySubsystem::Frame, capacity)
+    , m_frameIndex(0)
+    , m_lastFrameBytes(0)
+    , m_peakFrameBytes(0)
+{
+}
+
+void FrameAllocator::BeginFrame()
+{
+    m_lastFrameBytes = m_arena.GetUsedBytes();
+    m_peakFrameBytes = std::max(m_peakFrameBytes, m_lastFrameBytes);
+    m_arena.Reset();
+    m_frameIndex++;
+}
+
+// ---------------------------------------------------------------------------
+// PoolAllocator
+// ---------------------------------------------------------------------------
+
+PoolAllocator::PoolAllocator(size_t blockSize, size_t blockAlignment, MemorySubsystem subsystem, size_t blocksPerPage)
+    : m_subsystem(subsystem)
+    , m_blockAlignment(std::max(blockAlignment, alignof(FreeBlock)))
+    , m_blocksPerPage(std::max<size_t>(blocksPerPage, 1))
+    , m_freeList(nullptr)
+    , m_liveCount(0)
+{
+    m_blockSize = Memory::AlignUp(std::max(blockSize, sizeof(FreeBlock)), m_blockAlignment);
+}
+
+PoolAllocator::~PoolAllocator()
+{
+    if (m_liveCount > 0)
+    {
+        std::cerr << "PoolAllocator: " << m_liveCount << " blocks of " << m_blockSize
+                  << " bytes still allocated (" << Memory::GetSubsystemName(m_subsystem) << ")" << std::endl;
+        Memory::RecordFree(m_subsystem, m_liveCount * m_blockSize, m_liveCount);
+    }
+
+    for (void* page : m_pages)
+    {
+        FreeAligned(page, m_blockAlignment);
+    }
+    Memory::RecordUnreserve(m_subsystem, m_pages.size() * m_blockSize * m_blocksPerPage);
+}
+
+void PoolAllocator::AddPage()
+{
+    size_t pageSize = m_blockSize * m_blocksPerPage;
+    char* page = static_cast<char*>(AllocateAligned(pageSize, m_blockAlignment));
+    m_pages.push_back(page);
+    Memory::RecordReserve(m_subsystem, pageSize);
+
+    // Thread the new blocks onto the free list in address order
+    for (size_t i = m_blocksPerPage; i-- > 0;)
+    {
+        FreeBlock* block = reinterpret_cast<FreeBlock*>(page + i * m_blockSize);
+        block->next = m_freeList;
+        m_freeList = block;
+    }
+}
+
+void* PoolAllocator::Allocate()
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+
+    if (!m_freeList)
+    {
+        AddPage();
+    }
+
+    FreeBlock* block = m_freeList;
+    m_freeList = block->next;
+    m_liveCount++;
+    Memory::RecordAllocation(m_subsystem, m_blockSize);
+    return block;
+}
+
+void PoolAllocator::Free(void* pointer)
+{
+    if (!pointer)
+    {
+        return;
+    }
+
+    std::lock_guard<std::mutex> lock(m_mutex);
+
+    FreeBlock* block = static_cast<FreeBlock*>(pointer);
+    block->next = m_freeList;
+    m_freeList = block;
+    m_liveCount--;
+    Memory::RecordFree(m_subsystem, m_blockSize);
+}
+
+size_t PoolAllocator::GetLiveCount() const
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    return m_liveCount;
+}
+
+size_t PoolAllocator::GetPageCount() const
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    return m_pages.size();
+}
@@ -0,0 +1,405 @@
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <mutex>
+#include <new>
+#include <string>
+#include <utility>
+#include <vector>
+
+// Subsystems allocations are attributed to
+enum class MemorySubsystem
+{
+    General = 0,
+    Loading,        // Parser and mesh processing scratch, released after each load
+    Resources,      // Meshes, materials, textures
+    Animation,
+    Scene,
+    Rendering,
+    Frame,          // Per-frame scratch, reset every frame
+    Count
+};
+
+// Counters of one subsystem. Allocations are counted when they are served by
+// an allocator of this file; bytes include alignment padding.
+struct MemorySubsystemStats
+{
+    uint64_t allocationCount;   // Cumulative
+    uint64_t freeCount;         // Cumulative; an arena reset frees all its allocations at once
+    uint64_t bytesInUse;        // Handed out and not yet freed
+    uint64_t bytesReserved;     // Held from the system (arena blocks, pool pages)
+    uint64_t peakBytesReserved;
+    uint64_t budgetBytes;       // On bytesReserved; 0 when unlimited
+
+    MemorySubsystemStats()
+        : allocationCount(0)
+        , freeCount(0)
+        , bytesInUse(0)
+        , bytesReserved(0)
+        , peakBytesReserved(0)
+        , budgetBytes(0)
+    {
+    }
+};
+
+// Categories of resource memory. Unlike subsystems, which count allocator
+// traffic, categories hold the footprint resources report for themselves,
+// GPU memory included, tagged with the asset they came from.
+enum class MemoryCategory
+{
+    MeshCpu = 0,    // Vertex and index copies kept in system memory
+    MeshGpu,        // Vertex and index buffers
+    Textures,
+    RenderTargets,
+    Animation,      // Keyframes
+    Count
+};
+
+struct MemoryCategoryStats
+{
+    uint64_t bytes;
+    uint64_t peakBytes;
+    uint64_t resourceCount;
+    uint64_t budgetBytes;       // 0 when unlimited
+
+    MemoryCategoryStats()
+        : bytes(0)
+        , peakBytes(0)
+        , resourceCount(0)
+        , budgetBytes(0)
+    {
+    }
+};
+
+// Footprint of one asset across categories
+struct MemoryAssetUsage
+{
+    std::string asset;
+    uint64_t bytes[static_cast<size_t>(MemoryCategory::Count)];
+    uint64_t totalBytes;
+
+    MemoryAssetUsage()
+        : totalBytes(0)
+    {
+        for (uint64_t& value : bytes)
+        {
+            value = 0;
+        }
+    }
+};
+
+namespace Memory
+{
+    const size_t DEFAULT_ALIGNMENT = 16;
+
+    const char* GetSubsystemName(MemorySubsystem subsystem);
+
+    // Counters are kept per thread and only written by their thread, so
+    // reporting costs no locked instruction; GetStats sums the threads
+    void RecordAllocation(MemorySubsystem subsystem, size_t bytes);
+    void RecordFree(MemorySubsystem subsystem, size_t bytes, uint64_t count = 1);
+    void RecordReserve(MemorySubsystem subsystem, size_t bytes);
+    void RecordUnreserve(MemorySubsystem subsystem, size_t bytes);
+
+    MemorySubsystemStats GetStats(MemorySubsystem subsystem);
+    void PrintStats();
+
+    // Resource accounting. An owner (usually the resource object itself)
+    // holds at most one entry per category; tracking again replaces its size
+    // and asset, and a size of 0 removes the entry.
+    const char* GetCategoryName(MemoryCategory category);
+    void TrackResource(MemoryCategory category, const void* owner, const std::string& asset, size_t bytes);
+    void UntrackResource(MemoryCategory category, const void* owner);
+    void UntrackResources(const void* owner);
+
+    MemoryCategoryStats GetCategoryStats(MemoryCategory category);
+
+    // Per-asset breakdown, largest first
+    std::vector<MemoryAssetUsage> GetAssetUsage();
+
+    // Budgets print a warning when first exceeded and re-arm once usage falls
+    // back under them; 0 removes the budget
+    void SetBudget(MemoryCategory category, uint64_t bytes);
+    void SetBudget(MemorySubsystem subsystem, uint64_t bytes);
+
+    // Subsystems, categories and the largest assets
+    void PrintReport(size_t maxAssets = 10);
+
+    // Approximate GPU size of a 2D texture with a full or partial mip chain
+    uint64_t GetTextureBytes(int width, int height, int bitsPerPixel, int mipLevels = 1);
+
+    // Same for block-compressed formats, stored as 4x4 blocks of blockBytes
+    // (8 for BC1, 16 for BC3 and BC5); a level smaller than a block still
+    // takes a whole one
+    uint64_t GetBlockCompressedTextureBytes(int width, int height, int blockBytes, int mipLevels = 1);
+
+    inline size_t AlignUp(size_t value, size_t alignment)
+    {
+        return (value + alignment - 1) & ~(alignment - 1);
+    }
+}
+
+// Bump allocator over a list of blocks, freed in bulk by Reset or Release.
+//
+// Allocation is a single atomic add on the current block, so worker threads
+// of a load job can share one arena; the mutex is only taken to chain a new
+// block. Destructors of objects placed in the arena are never run, so it is
+// meant for trivially destructible data (vertices, indices, hash tables).
+class LinearArena
+{
+public:
+    explicit LinearArena(MemorySubsystem subsystem = MemorySubsystem::General, size_t blockSize = 64 * 1024);
+    ~LinearArena();
+
+    void* Allocate(size_t size, size_t alignment = Memory::DEFAULT_ALIGNMENT);
+
+    template<typename T>
+    T* AllocateArray(size_t count)
+    {
+        return static_cast<T*>(Allocate(sizeof(T) * count, alignof(T)));
+    }
+
+    // Frees every allocation. Must not race with Allocate. When the previous
+    // cycle needed several blocks they are replaced by one block of the
+    // combined size, so a steady workload stops chaining after the first cycle.
+    void Reset();
+
+    // Frees every allocation and returns all blocks to the system
+    void Release();
+
+    // Exact once concurrent Allocate calls have returned
+    size_t GetUsedBytes() const;
+    uint64_t GetAllocationCount() const;
+    size_t GetReservedBytes() const { return m_reservedBytes; }
+    size_t GetBlockCount() const { return m_blockCount; }
+    MemorySubsystem GetSubsystem() const { return m_subsystem; }
+
+private:
+    LinearArena(const LinearArena&) = delete;
+    LinearArena& operator=(const LinearArena&) = delete;
+
+    // Offset and allocation count of a block share one word, so an
+    // allocation is a single atomic add: bytes in the low 40 bits, count in
+    // the high 24. Blocks are capped so the count cannot overflow.
+    static constexpr int COUNT_SHIFT = 40;
+    static constexpr uint64_t OFFSET_MASK = (1ull << COUNT_SHIFT) - 1;
+    static constexpr size_t MAX_BLOCK_SIZE = static_cast<size_t>(1) << 28;
+
+    struct Block
+    {
+        char* data;
+        size_t size;
+        std::atomic<uint64_t> state;        // Overshoots size by the allocations that did not fit
+        std::atomic<uint64_t> overflow;     // Those allocations, packed the same way
+        Block* next;
+    };
+
+    Block* CreateBlock(size_t size);
+    void DestroyBlocks();
+    void RecordFreeAll();
+
+    MemorySubsystem m_subsystem;
+    size_t m_blockSize;
+    std::atomic<Block*> m_current;
+    Block* m_blocks;                // All blocks, newest first
+    size_t m_reservedBytes;
+    size_t m_blockCount;
+    std::mutex m_mutex;
+};
+
+// Scratch memory for the current frame. BeginFrame drops everything from the
+// previous frame; pointers must not be kept across frames.
+class FrameAllocator
+{
+public:
+    explicit FrameAllocator(size_t capacity = 256 * 1024);
+
+    void BeginFrame();
+
+    void* Allocate(size_t size, size_t alignment = Memory::DEFAULT_ALIGNMENT) { return m_arena.Allocate(size, alignment); }
+
+    template<typename T>
+    T* AllocateArray(size_t count) { return m_arena.AllocateArray<T>(count); }
+
+    LinearArena& GetArena() { return m_arena; }
+    uint64_t GetFrameIndex() const { return m_frameIndex; }
+    size_t GetLastFrameBytes() const { return m_lastFrameBytes; }
+    size_t GetPeakFrameBytes() const { return m_peakFrameBytes; }
+
+private:
+    LinearArena m_arena;
+    uint64_t m_frameIndex;
+    size_t m_lastFrameBytes;
+    size_t m_peakFrameBytes;
+};
+
+// Fixed-size block allocator. Blocks come from pages of blocksPerPage and are
+// recycled through an intrusive free list; pages are only returned by the
+// destructor. Thread-safe.
+class PoolAllocator
+{
+public:
+    PoolAllocator(size_t blockSize, size_t blockAlignment, MemorySubsystem subsystem, size_t blocksPerPage = 64);
+    ~PoolAllocator();
+
+    void* Allocate();
+    void Free(void* block);
+
+    size_t GetBlockSize() const { return m_blockSize; }
+    size_t GetLiveCount() const;
+    size_t GetPageCount() const;
+
+private:
+    PoolAllocator(const PoolAllocator&) = delete;
+    PoolAllocator& operator=(const PoolAllocator&) = delete;
+
+    struct FreeBlock
+    {
+        FreeBlock* next;
+    };
+
+    void AddPage();
+
+    MemorySubsystem m_subsystem;
+    size_t m_blockSize;
+    size_t m_blockAlignment;
+    size_t m_blocksPerPage;
+    FreeBlock* m_freeList;
+    std::vector<void*> m_pages;
+    size_t m_liveCount;
+    mutable std::mutex m_mutex;
+};
+
+// Typed pool for engine objects that are created and destroyed explicitly
+template<typename T>
+class ObjectPool
+{
+public:
+    explicit ObjectPool(MemorySubsystem subsystem, size_t objectsPerPage = 64)
+        : m_pool(sizeof(T), alignof(T), subsystem, objectsPerPage)
+    {
+    }
+
+    template<typename... Args>
+    T* Create(Args&&... args)
+    {
+        void* memory = m_pool.Allocate();
+        return new (memory) T(std::forward<Args>(args)...);
+    }
+
+    void Destroy(T* object)
+    {
+        if (object)
+        {
+            object->~T();
+            m_pool.Free(object);
+        }
+    }
+
+    size_t GetLiveCount() const { return m_pool.GetLiveCount(); }
+
+private:
+    PoolAllocator m_pool;
+};
+
+// STL allocator over a LinearArena; deallocate is a no-op, the memory goes
+// away with the arena. Without an arena it falls back to the heap, so code can
+// take an optional scratch arena and keep a single container type.
+template<typename T>
+class ArenaAllocator
+{
+public:
+    typedef T value_type;
+
+    ArenaAllocator() : m_arena(nullptr) {}
+    explicit ArenaAllocator(LinearArena* arena) : m_arena(arena) {}
+
+    template<typename U>
+    ArenaAllocator(const ArenaAllocator<U>& other) : m_arena(other.GetArena()) {}
+
+    T* allocate(size_t count)
+    {
+        if (m_arena)
+        {
+            return m_arena->AllocateArray<T>(count);
+        }
+        return static_cast<T*>(::operator new(count * sizeof(T)));
+    }
+
+    void deallocate(T* pointer, size_t)
+    {
+        if (!m_arena)
+        {
+            ::operator delete(pointer);
+        }
+    }
+
+    LinearArena* GetArena() const { return m_arena; }
+
+    template<typename U>
+    bool operator==(const ArenaAllocator<U>& other) const { return m_arena == other.GetArena(); }
+    template<typename U>
+    bool operator!=(const ArenaAllocator<U>& other) const { return m_arena != other.GetArena(); }
+
+private:
+    LinearArena* m_arena;
+};
+
+template<typename T>
+using ArenaVector = std::vector<T, ArenaAllocator<T>>;
+
+// STL allocator drawing single objects from one shared pool per type, so
+// std::allocate_shared puts the object and its control block in a pool slot.
+// The pools are never destroyed: shared_ptrs may be released after static
+// destruction has started.
+template<typename T, MemorySubsystem Subsystem>
+class PooledAllocator
+{
+public:
+    typedef T value_type;
+
+    template<typename U>
+    struct rebind
+    {
+        typedef PooledAllocator<U, Subsystem> other;
+    };
+
+    PooledAllocator() {}
+
+    template<typename U>
+    PooledAllocator(const PooledAllocator<U, Subsystem>&) {}
+
+    T* allocate(size_t count)
+    {
+        if (count == 1)
+        {
+            return static_cast<T*>(GetPool().Allocate());
+        }
+        Memory::RecordAllocation(Subsystem, count * sizeof(T));
+        return static_cast<T*>(::operator new(count * sizeof(T)));
+    }
+
+    void deallocate(T* pointer, size_t count)
+    {
+        if (count == 1)
+        {
+            GetPool().Free(pointer);
+            return;
+        }
+        Memory::RecordFree(Subsystem, count * sizeof(T));
+        ::operator delete(pointer);
+    }
+
+    static PoolAllocator& GetPool()
+    {
+        static PoolAllocator* pool = new PoolAllocator(sizeof(T), alignof(T), Subsystem);
+        return *pool;
+    }
+
+    template<typename U>
+    bool operator==(const PooledAllocator<U, Subsystem>&) const { return true; }
+    template<typename U>
+    bool operator!=(const PooledAllocator<U, Subsystem>&) const { return false; }
+};
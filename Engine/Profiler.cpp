@@ -0,0 +1,196 @@
+#include "Profiler.h"
+#include <iostream>
+#include <fstream>
+#include <mutex>
+#include <vector>
+#include <memory>
+#include <algorithm>
+#include <thread>
+
+std::atomic<bool> Profiler::s_capturing(false);
+
+namespace
+{
+    // Buffers outlive their threads so zones of finished threads still export
+    std::mutex g_registryMutex;
+    std::vector<std::shared_ptr<ProfilerThreadBuffer>> g_threadBuffers;
+    uint32_t g_nextThreadId = 1;
+
+    thread_local ProfilerThreadBuffer* t_threadBuffer = nullptr;
+
+    // Reference pair for converting ticks to time, taken at startup
+    const int64_t g_calibrationTicks = Profiler::Now();
+    const std::chrono::steady_clock::time_point g_calibrationTime = std::chrono::steady_clock::now();
+
+    void WriteJsonString(std::ofstream& file, const char* text)
+    {
+        file << '"';
+        for (const char* c = text; *c; ++c)
+        {
+            if (*c == '"' || *c == '\\')
+            {
+                file << '\\';
+            }
+            file << *c;
+        }
+        file << '"';
+    }
+}
+
+double Profiler::GetTicksPerSecond()
+{
+#if ENGINE_PROFILER_USE_RDTSC
+    // The longer the interval since startup, the better the estimate; make
+    // sure it is at least a few milliseconds
+    std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - g_calibrationTime;
+    if (elapsed.count() < 0.01)
+    {
+        std::this_thread::sleep_for(std::chrono::duration<double>(0.01 - elapsed.count()));
+    }
+
+    int64_t ticks = Now();
+    elapsed = std::chrono::steady_clock::now() - g_calibrationTime;
+    return static_cast<double>(ticks - g_calibrationTicks) / elapsed.count();
+#else
+    return static_cast<double>(std::chrono::steady_clock::period::den) /
+           static_cast<double>(std::chrono::steady_clock::period::num);
+#endif
+}
+
+void Profiler::StartCapture()
+{
+    s_capturing.store(true, std::memory_order_relaxed);
+}
+
+void Profiler::StopCapture()
+{
+    s_capturing.store(false, std::memory_order_relaxed);
+}
+
+ProfilerThreadBuffer* Profiler::GetThreadBuffer()
+{
+    if (!t_threadBuffer)
+    {
+        auto buffer = std::make_shared<ProfilerThreadBuffer>();
+
+        std::lock_guard<std::mutex> lock(g_registryMutex);
+        buffer->threadId = g_nextThreadId++;
+        buffer->threadName = "Thread " + std::to_string(buffer->threadId);
+        g_threadBuffers.push_back(buffer);
+        t_threadBuffer = buffer.get();
+    }
+
+    return t_threadBuffer;
+}
+
+void Profiler::SetThreadName(const std::string& name)
+{
+    ProfilerThreadBuffer* buffer = GetThreadBuffer();
+
+    std::lock_guard<std::mutex> lock(g_registryMutex);
+    buffer->threadName = name;
+}
+
+void Profiler::Clear()
+{
+    std::lock_guard<std::mutex> lock(g_registryMutex);
+    for (auto& buffer : g_threadBuffers)
+    {
+        buffer->writeIndex.store(0, std::memory_order_relaxed);
+    }
+}
+
+bool Profiler::WriteChromeTrace(const std::string& filepath)
+{
+    std::ofstream file(filepath);
+    if (!file.is_open())
+    {
+        std::cerr << "Profiler: Failed to open " << filepath << std::endl;
+        return false;
+    }
+
+    std::lock_guard<std::mutex> lock(g_registryMutex);
+
+    // Oldest surviving event of each ring
+    auto firstIndex = [](uint64_t count)
+    {
+        return count > ProfilerThreadBuffer::CAPACITY ? count - ProfilerThreadBuffer::CAPACITY : 0;
+    };
+
+    // Timestamps are written relative to the earliest zone, in microseconds
+    int64_t origin = INT64_MAX;
+    for (const auto& buffer : g_threadBuffers)
+    {
+        uint64_t count = buffer->writeIndex.load(std::memory_order_acquire);
+        for (uint64_t i = firstIndex(count); i < count; ++i)
+        {
+            origin = std::min(origin, buffer->events[i & (ProfilerThreadBuffer::CAPACITY - 1)].start);
+        }
+    }
+
+    const double ticksToMicroseconds = 1e6 / GetTicksPerSecond();
+
+    size_t eventCount = 0;
+    file << "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[";
+    file.setf(std::ios::fixed);
+    file.precision(3);
+
+    for (const auto& buffer : g_threadBuffers)
+    {
+        file << (eventCount++ > 0 ? ",\n" : "\n");
+        file << "{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":" << buffer->threadId
+             << ",\"args\":{\"name\":";
+        WriteJsonString(file, buffer->threadName.c_str());
+        file << "}}";
+
+        uint64_t count = buffer->writeIndex.load(std::memory_order_acquire);
+        for (uint64_t i = firstIndex(count); i < count; ++i)
+        {
+            const ProfileEvent& event = buffer->events[i & (ProfilerThreadBuffer::CAPACITY - 1)];
+
+            file << ",\n{\"name\":";
+            WriteJsonString(file, event.name);
+            file << ",\"cat\":\"engine\",\"ph\":\"X\",\"pid\":1,\"tid\":" << buffer->threadId
+                 << ",\"ts\":" << static_cast<double>(event.start - origin) * ticksToMicroseconds
+                 << ",\"dur\":" << static_cast<double>(event.end - event.start) * ticksToMicroseconds
+                 << ",\"args\":{\"depth\":" << event.depth << "}}";
+            eventCount++;
+        }
+    }
+
+    file << "\n]}\n";
+
+    std::cout << "Profiler: Wrote " << eventCount << " events to " << filepath << std::endl;
+    return file.good();
+}
+
+double Profiler::MeasureZoneOverhead(int iterations)
+{
+    if (iterations <= 0)
+    {
+        return 0.0;
+    }
+
+    // Measured with capture on, into the calling thread's ring, which is
+    // rewound afterwards so the calibration zones do not show up in traces
+    bool wasCapturing = IsCapturing();
+    StartCapture();
+
+    ProfilerThreadBuffer* buffer = GetThreadBuffer();
+    uint64_t savedIndex = buffer->writeIndex.load(std::memory_order_relaxed);
+
+    auto start = std::chrono::steady_clock::now();
+    for (int i = 0; i < iterations; ++i)
+    {
+        ProfileZone zone("ProfilerOverhead");
+    }
+    auto end = std::chrono::steady_clock::now();
+
+    buffer->writeIndex.store(savedIndex, std::memory_order_relaxed);
+    if (!wasCapturing)
+    {
+        StopCapture();
+    }
+
+    return std::chrono::duration<double, std::nano>(end - start).count() / iterations;
+}
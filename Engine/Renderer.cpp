@@ -1,6 +1,8 @@
 #include "Renderer.h"
+#include "Profiler.h"
 #include <d3dcompiler.h>
 #include <iostream>
+#include <cstring>
 
 Renderer::Renderer()
     : m_device(nullptr)
@@ -19,6 +21,8 @@ Renderer::Renderer()
     , m_cubeIndexCount(0)
     , m_interpolatedTriangleAngle(0.0f)
     , m_interpolatedCubeAngle(0.0f)
+    , m_triangleWorld(XMMatrixTranslation(-3.0f, 0.0f, 0.0f))
+    , m_cubeWorld(XMMatrixTranslation(3.0f, 0.0f, 0.0f))
 {
 }
 
@@ -58,9 +62,7 @@ bool Renderer::InitializeShaders(ID3D11Device* device)
     const char* vsSource = R"(
         cbuffer ConstantBuffer : register(b0)
         {
-            matrix worldMatrix;
-            matrix viewMatrix;
-            matrix projectionMatrix;
+            matrix worldViewProjectionMatrix;
         }
 
         struct VertexInputType
@@ -81,9 +83,7 @@ bool Renderer::InitializeShaders(ID3D11Device* device)
 
             input.position.w = 1.0f;
 
-            output.position = mul(input.position, worldMatrix);
-            output.position = mul(output.position, viewMatrix);
-            output.position = mul(output.position, projectionMatrix);
+            output.position = mul(input.position, worldViewProjectionMatrix);
 
             output.color = input.color;
 
@@ -328,7 +328,7 @@ bool Renderer::InitializeBuffers(ID3D11Device* device)
     // Create constant buffer
     D3D11_BUFFER_DESC constantBufferDesc;
     constantBufferDesc.Usage = D3D11_USAGE_DYNAMIC;
-    constantBufferDesc.ByteWidth = sizeof(ConstantBuffer);
+    constantBufferDesc.ByteWidth = sizeof(XMFLOAT4X4);
     constantBufferDesc.BindFlags = D3D11_BIND_CONSTANT_BUFFER;
     constantBufferDesc.CPUAccessFlags = D3D11_CPU_ACCESS_WRITE;
     constantBufferDesc.MiscFlags = 0;
@@ -351,10 +351,23 @@ void Renderer::SetRotationAngles(float triangleAngle, float cubeAngle, float int
 
     // Note: interpolation factor could be used here for even smoother motion
     // For example: m_interpolatedTriangleAngle = lastAngle + (triangleAngle - lastAngle) * interpolation;
+
+    // Triangle to the left, cube to the right
+    m_triangleWorld = XMMatrixMultiply(XMMatrixRotationY(m_interpolatedTriangleAngle), XMMatrixTranslation(-3.0f, 0.0f, 0.0f));
+    m_cubeWorld = XMMatrixMultiply(XMMatrixRotationRollPitchYaw(m_interpolatedCubeAngle, m_interpolatedCubeAngle, 0.0f),
+                                   XMMatrixTranslation(3.0f, 0.0f, 0.0f));
+}
+
+void Renderer::SetObjectTransforms(const XMMATRIX& triangleWorld, const XMMATRIX& cubeWorld)
+{
+    m_triangleWorld = triangleWorld;
+    m_cubeWorld = cubeWorld;
 }
 
 void Renderer::Render(const XMMATRIX& viewMatrix, const XMMATRIX& projectionMatrix)
 {
+    PROFILE_FUNCTION();
+
     // Set input assembler
     unsigned int stride = sizeof(Vertex);
     unsigned int offset = 0;
@@ -366,15 +379,19 @@ void Renderer::Render(const XMMATRIX& viewMatrix, const XMMATRIX& projectionMatr
     m_deviceContext->VSSetShader(m_vertexShader, nullptr, 0);
     m_deviceContext->PSSetShader(m_pixelShader, nullptr, 0);
 
+    PrepareObjectConstants(viewMatrix, projectionMatrix, RendererObject_Target);
+
     // Render triangle
-    RenderTriangle(viewMatrix, projectionMatrix);
+    RenderTriangle();
 
     // Render cube
-    RenderCube(viewMatrix, projectionMatrix);
+    RenderCube();
 }
 
 void Renderer::RenderWithTarget(const XMMATRIX& viewMatrix, const XMMATRIX& projectionMatrix, const XMFLOAT3& targetPosition)
 {
+    PROFILE_FUNCTION();
+
     // Set common render state
     unsigned int stride = sizeof(Vertex);
     unsigned int offset = 0;
@@ -386,51 +403,64 @@ void Renderer::RenderWithTarget(const XMMATRIX& viewMatrix, const XMMATRIX& proj
     m_deviceContext->VSSetShader(m_vertexShader, nullptr, 0);
     m_deviceContext->PSSetShader(m_pixelShader, nullptr, 0);
 
+    // Target world matrix (small cube at target position), then all constants in one pass
+    XMMATRIX targetWorld = XMMatrixMultiply(XMMatrixScaling(0.3f, 0.3f, 0.3f),
+                                            XMMatrixTranslation(targetPosition.x, targetPosition.y, targetPosition.z));
+    XMStoreFloat4x4(&m_objectWorld[RendererObject_Target], targetWorld);
+    PrepareObjectConstants(viewMatrix, projectionMatrix, RendererObject_Count);
+
     // Render triangle
-    RenderTriangle(viewMatrix, projectionMatrix);
+    RenderTriangle();
 
     // Render cube
-    RenderCube(viewMatrix, projectionMatrix);
+    RenderCube();
 
     // Render target (character representation)
-    RenderTarget(viewMatrix, projectionMatrix, targetPosition);
+    RenderTarget();
 }
 
-void Renderer::RenderTriangle(const XMMATRIX& viewMatrix, const XMMATRIX& projectionMatrix)
+void Renderer::PrepareObjectConstants(const XMMATRIX& viewMatrix, const XMMATRIX& projectionMatrix, int objectCount)
 {
-    // Set triangle buffers
-    unsigned int stride = sizeof(Vertex);
-    unsigned int offset = 0;
-    m_deviceContext->IASetVertexBuffers(0, 1, &m_vertexBuffer, &stride, &offset);
-    m_deviceContext->IASetIndexBuffer(m_indexBuffer, DXGI_FORMAT_R32_UINT, 0);
+    PROFILE_FUNCTION();
 
-    // Create world matrix for triangle (position to the left)
-    XMMATRIX worldMatrix = XMMatrixTranslation(-3.0f, 0.0f, 0.0f);
-    worldMatrix = XMMatrixMultiply(XMMatrixRotationY(m_interpolatedTriangleAngle), worldMatrix);
+    XMStoreFloat4x4(&m_objectWorld[RendererObject_Triangle], m_triangleWorld);
+    XMStoreFloat4x4(&m_objectWorld[RendererObject_Cube], m_cubeWorld);
 
-    // Update constant buffer
-    D3D11_MAPPED_SUBRESOURCE mappedResource;
-    ConstantBuffer* dataPtr;
+    // View * projection once per frame, then the transposed WVP of every
+    // object; the vertex shader reads nothing else
+    XMMATRIX viewProjection = XMMatrixMultiply(viewMatrix, projectionMatrix);
+    TransformKernels::ComputeWorldViewProjection(m_objectWorld, objectCount, viewProjection, m_objectConstants);
+}
 
+void Renderer::UploadObjectConstants(int object)
+{
+    D3D11_MAPPED_SUBRESOURCE mappedResource;
     HRESULT result = m_deviceContext->Map(m_constantBuffer, 0, D3D11_MAP_WRITE_DISCARD, 0, &mappedResource);
     if (SUCCEEDED(result))
     {
-        dataPtr = (ConstantBuffer*)mappedResource.pData;
-        dataPtr->world = XMMatrixTranspose(worldMatrix);
-        dataPtr->view = XMMatrixTranspose(viewMatrix);
-        dataPtr->projection = XMMatrixTranspose(projectionMatrix);
-
+        memcpy(mappedResource.pData, &m_objectConstants[object], sizeof(XMFLOAT4X4));
         m_deviceContext->Unmap(m_constantBuffer, 0);
     }
 
-    // Set constant buffer
     m_deviceContext->VSSetConstantBuffers(0, 1, &m_constantBuffer);
+}
+
+void Renderer::RenderTriangle()
+{
+    // Set triangle buffers
+    unsigned int stride = sizeof(Vertex);
+    unsigned int offset = 0;
+    m_deviceContext->IASetVertexBuffers(0, 1, &m_vertexBuffer, &stride, &offset);
+    m_deviceContext->IASetIndexBuffer(m_indexBuffer, DXGI_FORMAT_R32_UINT, 0);
+
+    // Upload constants computed in PrepareObjectConstants
+    UploadObjectConstants(RendererObject_Triangle);
 
     // Draw triangle
     m_deviceContext->DrawIndexed(m_indexCount, 0, 0);
 }
 
-void Renderer::RenderCube(const XMMATRIX& viewMatrix, const XMMATRIX& projectionMatrix)
+void Renderer::RenderCube()
 {
     // Set cube buffers
     unsigned int stride = sizeof(Vertex);
@@ -438,33 +468,14 @@ void Renderer::RenderCube(const XMMATRIX& viewMatrix, const XMMATRIX& projection
     m_deviceContext->IASetVertexBuffers(0, 1, &m_cubeVertexBuffer, &stride, &offset);
     m_deviceContext->IASetIndexBuffer(m_cubeIndexBuffer, DXGI_FORMAT_R32_UINT, 0);
 
-    // Create world matrix for cube (position to the right)
-    XMMATRIX worldMatrix = XMMatrixTranslation(3.0f, 0.0f, 0.0f);
-    worldMatrix = XMMatrixMultiply(XMMatrixRotationRollPitchYaw(m_interpolatedCubeAngle, m_interpolatedCubeAngle, 0.0f), worldMatrix);
-
-    // Update constant buffer
-    D3D11_MAPPED_SUBRESOURCE mappedResource;
-    ConstantBuffer* dataPtr;
-
-    HRESULT result = m_deviceContext->Map(m_constantBuffer, 0, D3D11_MAP_WRITE_DISCARD, 0, &mappedResource);
-    if (SUCCEEDED(result))
-    {
-        dataPtr = (ConstantBuffer*)mappedResource.pData;
-        dataPtr->world = XMMatrixTranspose(worldMatrix);
-        dataPtr->view = XMMatrixTranspose(viewMatrix);
-        dataPtr->projection = XMMatrixTranspose(projectionMatrix);
-
-        m_deviceContext->Unmap(m_constantBuffer, 0);
-    }
-
-    // Set constant buffer
-    m_deviceContext->VSSetConstantBuffers(0, 1, &m_constantBuffer);
+    // Upload constants computed in PrepareObjectConstants
+    UploadObjectConstants(RendererObject_Cube);
 
     // Draw cube
     m_deviceContext->DrawIndexed(m_cubeIndexCount, 0, 0);
 }
 
-void Renderer::RenderTarget(const XMMATRIX& viewMatrix, const XMMATRIX& projectionMatrix, const XMFLOAT3& position)
+void Renderer::RenderTarget()
 {
     // Set cube buffers (reuse cube geometry for target)
     unsigned int stride = sizeof(Vertex);
@@ -472,28 +483,8 @@ void Renderer::RenderTarget(const XMMATRIX& viewMatrix, const XMMATRIX& projecti
     m_deviceContext->IASetVertexBuffers(0, 1, &m_cubeVertexBuffer, &stride, &offset);
     m_deviceContext->IASetIndexBuffer(m_cubeIndexBuffer, DXGI_FORMAT_R32_UINT, 0);
 
-    // Create world matrix for target (small cube at target position)
-    XMMATRIX scaleMatrix = XMMatrixScaling(0.3f, 0.3f, 0.3f); // Small cube
-    XMMATRIX translationMatrix = XMMatrixTranslation(position.x, position.y, position.z);
-    XMMATRIX worldMatrix = XMMatrixMultiply(scaleMatrix, translationMatrix);
-
-    // Update constant buffer
-    D3D11_MAPPED_SUBRESOURCE mappedResource;
-    ConstantBuffer* dataPtr;
-
-    HRESULT result = m_deviceContext->Map(m_constantBuffer, 0, D3D11_MAP_WRITE_DISCARD, 0, &mappedResource);
-    if (SUCCEEDED(result))
-    {
-        dataPtr = (ConstantBuffer*)mappedResource.pData;
-        dataPtr->world = XMMatrixTranspose(worldMatrix);
-        dataPtr->view = XMMatrixTranspose(viewMatrix);
-        dataPtr->projection = XMMatrixTranspose(projectionMatrix);
-
-        m_deviceContext->Unmap(m_constantBuffer, 0);
-    }
-
-    // Set constant buffer
-    m_deviceContext->VSSetConstantBuffers(0, 1, &m_constantBuffer);
+    // Upload constants computed in PrepareObjectConstants
+    UploadObjectConstants(RendererObject_Target);
 
     // Draw target cube
     m_deviceContext->DrawIndexed(m_cubeIndexCount, 0, 0);
@@ -3,6 +3,7 @@
 #include <d3d11.h>
 #include <DirectXMath.h>
 #include <vector>
+#include "../Graphics/TransformKernels.h"
 
 using namespace DirectX;
 
@@ -12,11 +13,13 @@ struct Vertex
     XMFLOAT4 color;
 };
 
-struct ConstantBuffer
+// Objects drawn by the renderer; their constants are computed in one batch per frame
+enum RendererObject
 {
-    XMMATRIX world;
-    XMMATRIX view;
-    XMMATRIX projection;
+    RendererObject_Triangle = 0,
+    RendererObject_Cube,
+    RendererObject_Target,
+    RendererObject_Count
 };
 
 class Renderer
@@ -29,14 +32,17 @@ public:
     void Render(const XMMATRIX& viewMatrix, const XMMATRIX& projectionMatrix);
     void RenderWithTarget(const XMMATRIX& viewMatrix, const XMMATRIX& projectionMatrix, const XMFLOAT3& targetPosition);
     void SetRotationAngles(float triangleAngle, float cubeAngle, float interpolation);
+    void SetObjectTransforms(const XMMATRIX& triangleWorld, const XMMATRIX& cubeWorld);
     void Shutdown();
 
 private:
     bool InitializeShaders(ID3D11Device* device);
     bool InitializeBuffers(ID3D11Device* device);
-    void RenderTriangle(const XMMATRIX& viewMatrix, const XMMATRIX& projectionMatrix);
-    void RenderCube(const XMMATRIX& viewMatrix, const XMMATRIX& projectionMatrix);
-    void RenderTarget(const XMMATRIX& viewMatrix, const XMMATRIX& projectionMatrix, const XMFLOAT3& position);
+    void PrepareObjectConstants(const XMMATRIX& viewMatrix, const XMMATRIX& projectionMatrix, int objectCount);
+    void UploadObjectConstants(int object);
+    void RenderTriangle();
+    void RenderCube();
+    void RenderTarget();
 
     ID3D11Device* m_device;
     ID3D11DeviceContext* m_deviceContext;
@@ -63,4 +69,13 @@ private:
     // Interpolated rotation angles
     float m_interpolatedTriangleAngle;
     float m_interpolatedCubeAngle;
+
+    // World matrices used by RenderTriangle/RenderCube
+    XMMATRIX m_triangleWorld;
+    XMMATRIX m_cubeWorld;
+
+    // Per-frame object data; the constants are the transposed world * view *
+    // projection, the whole vertex shader constant buffer (64 bytes)
+    XMFLOAT4X4 m_objectWorld[RendererObject_Count];
+    XMFLOAT4X4 m_objectConstants[RendererObject_Count];
 };
@@ -0,0 +1,385 @@
+#include "SceneGraph.h"
+#include "Profiler.h"
+#include <algorithm>
+#include <chrono>
+
+namespace
+{
+    const uint32_t NO_PARENT = 0xFFFFFFFFu;
+}
+
+SceneGraph::SceneGraph()
+    : m_structureDirty(false)
+    , m_parallelThreshold(1024)
+{
+}
+
+SceneGraph::~SceneGraph()
+{
+}
+
+size_t SceneGraph::AppendStorage()
+{
+    m_parent.push_back(NO_PARENT);
+    m_handle.push_back(INVALID_SCENE_NODE);
+    m_position.push_back(XMFLOAT3(0.0f, 0.0f, 0.0f));
+    m_rotation.push_back(XMFLOAT4(0.0f, 0.0f, 0.0f, 1.0f));
+    m_scale.push_back(XMFLOAT3(1.0f, 1.0f, 1.0f));
+    m_localCenter.push_back(XMFLOAT3(0.0f, 0.0f, 0.0f));
+    m_localExtents.push_back(XMFLOAT3(0.0f, 0.0f, 0.0f));
+    m_userData.push_back(nullptr);
+
+    XMFLOAT4X4 identity;
+    XMStoreFloat4x4(&identity, XMMatrixIdentity());
+    m_world.push_back(identity);
+    m_worldBounds.Add(XMFLOAT3(0.0f, 0.0f, 0.0f), XMFLOAT3(0.0f, 0.0f, 0.0f));
+
+    m_dirty.push_back(1);
+    m_changed.push_back(0);
+    return m_handle.size() - 1;
+}
+
+SceneNodeHandle SceneGraph::CreateNode(SceneNodeHandle parent)
+{
+    if (parent != INVALID_SCENE_NODE && !IsValid(parent))
+    {
+        return INVALID_SCENE_NODE;
+    }
+
+    SceneNodeHandle node;
+    if (!m_freeHandles.empty())
+    {
+        node = m_freeHandles.back();
+        m_freeHandles.pop_back();
+    }
+    else
+    {
+        node = static_cast<SceneNodeHandle>(m_handleToIndex.size());
+        m_handleToIndex.push_back(0);
+        m_handleDepth.push_back(0);
+        m_handleParent.push_back(INVALID_SCENE_NODE);
+        m_handleAlive.push_back(0);
+    }
+
+    // New nodes are appended unsorted; the next update moves them to their level
+    size_t index = AppendStorage();
+    m_handle[index] = node;
+    m_handleToIndex[node] = index;
+    m_handleParent[node] = parent;
+    m_handleDepth[node] = (parent == INVALID_SCENE_NODE) ? 0 : m_handleDepth[parent] + 1;
+    m_handleAlive[node] = 1;
+
+    m_structureDirty = true;
+    return node;
+}
+
+void SceneGraph::DestroyNode(SceneNodeHandle node)
+{
+    if (!IsValid(node))
+    {
+        return;
+    }
+
+    // Descendants are found and dropped during the next restructure
+    m_handleAlive[node] = 0;
+    m_structureDirty = true;
+}
+
+void SceneGraph::Clear()
+{
+    m_parent.clear();
+    m_handle.clear();
+    m_position.clear();
+    m_rotation.clear();
+    m_scale.clear();
+    m_localCenter.clear();
+    m_localExtents.clear();
+    m_userData.clear();
+    m_world.clear();
+    m_worldBounds.Clear();
+    m_dirty.clear();
+    m_changed.clear();
+    m_levelStart.clear();
+    m_handleToIndex.clear();
+    m_handleDepth.clear();
+    m_handleParent.clear();
+    m_handleAlive.clear();
+    m_freeHandles.clear();
+    m_structureDirty = false;
+    m_stats = SceneGraphStats();
+}
+
+bool SceneGraph::IsValid(SceneNodeHandle node) const
+{
+    return node < m_handleAlive.size() && m_handleAlive[node] != 0;
+}
+
+SceneNodeHandle SceneGraph::GetParent(SceneNodeHandle node) const
+{
+    return IsValid(node) ? m_handleParent[node] : INVALID_SCENE_NODE;
+}
+
+void SceneGraph::MarkDirty(SceneNodeHandle node)
+{
+    m_dirty[m_handleToIndex[node]] = 1;
+}
+
+void SceneGraph::SetLocalPosition(SceneNodeHandle node, const XMFLOAT3& position)
+{
+    if (!IsValid(node))
+        return;
+
+    m_position[m_handleToIndex[node]] = position;
+    MarkDirty(node);
+}
+
+void SceneGraph::SetLocalRotation(SceneNodeHandle node, const XMFLOAT4& quaternion)
+{
+    if (!IsValid(node))
+        return;
+
+    m_rotation[m_handleToIndex[node]] = quaternion;
+    MarkDirty(node);
+}
+
+void SceneGraph::SetLocalRotation(SceneNodeHandle node, float pitch, float yaw, float roll)
+{
+    XMFLOAT4 quaternion;
+    XMStoreFloat4(&quaternion, XMQuaternionRotationRollPitchYaw(pitch, yaw, roll));
+    SetLocalRotation(node, quaternion);
+}
+
+void SceneGraph::SetLocalScale(SceneNodeHandle node, const XMFLOAT3& scale)
+{
+    if (!IsValid(node))
+        return;
+
+    m_scale[m_handleToIndex[node]] = scale;
+    MarkDirty(node);
+}
+
+void SceneGraph::SetLocalBounds(SceneNodeHandle node, const XMFLOAT3& center, const XMFLOAT3& extents)
+{
+    if (!IsValid(node))
+        return;
+
+    size_t index = m_handleToIndex[node];
+    m_localCenter[index] = center;
+    m_localExtents[index] = extents;
+    MarkDirty(node);
+}
+
+void SceneGraph::SetUserData(SceneNodeHandle node, void* userData)
+{
+    if (!IsValid(node))
+        return;
+
+    m_userData[m_handleToIndex[node]] = userData;
+}
+
+void SceneGraph::Restructure()
+{
+    size_t oldCount = m_handle.size();
+
+    // Counting sort by depth keeps creation order within a level
+    uint32_t maxDepth = 0;
+    for (size_t i = 0; i < oldCount; ++i)
+    {
+        maxDepth = std::max(maxDepth, m_handleDepth[m_handle[i]]);
+    }
+
+    std::vector<size_t> levelCount(maxDepth + 2, 0);
+    for (size_t i = 0; i < oldCount; ++i)
+    {
+        levelCount[m_handleDepth[m_handle[i]] + 1]++;
+    }
+    for (size_t level = 1; level < levelCount.size(); ++level)
+    {
+        levelCount[level] += levelCount[level - 1];
+    }
+
+    std::vector<size_t> order(oldCount);
+    for (size_t i = 0; i < oldCount; ++i)
+    {
+        order[levelCount[m_handleDepth[m_handle[i]]]++] = i;
+    }
+
+    // Drop destroyed nodes and, since parents come first, their descendants
+    std::vector<size_t> kept;
+    kept.reserve(oldCount);
+    for (size_t oldIndex : order)
+    {
+        SceneNodeHandle node = m_handle[oldIndex];
+        SceneNodeHandle parent = m_handleParent[node];
+        if (m_handleAlive[node] && (parent == INVALID_SCENE_NODE || m_handleAlive[parent]))
+        {
+            kept.push_back(oldIndex);
+        }
+        else
+        {
+            m_handleAlive[node] = 0;
+            m_freeHandles.push_back(node);
+        }
+    }
+
+    // Permute every array into depth order
+    size_t newCount = kept.size();
+    std::vector<SceneNodeHandle> handle(newCount);
+    std::vector<XMFLOAT3> position(newCount);
+    std::vector<XMFLOAT4> rotation(newCount);
+    std::vector<XMFLOAT3> scale(newCount);
+    std::vector<XMFLOAT3> localCenter(newCount);
+    std::vector<XMFLOAT3> localExtents(newCount);
+    std::vector<void*> userData(newCount);
+    std::vector<XMFLOAT4X4> world(newCount);
+
+    for (size_t i = 0; i < newCount; ++i)
+    {
+        size_t oldIndex = kept[i];
+        handle[i] = m_handle[oldIndex];
+        position[i] = m_position[oldIndex];
+        rotation[i] = m_rotation[oldIndex];
+        scale[i] = m_scale[oldIndex];
+        localCenter[i] = m_localCenter[oldIndex];
+        localExtents[i] = m_localExtents[oldIndex];
+        userData[i] = m_userData[oldIndex];
+        world[i] = m_world[oldIndex];
+        m_handleToIndex[handle[i]] = i;
+    }
+
+    m_handle.swap(handle);
+    m_position.swap(position);
+    m_rotation.swap(rotation);
+    m_scale.swap(scale);
+    m_localCenter.swap(localCenter);
+    m_localExtents.swap(localExtents);
+    m_userData.swap(userData);
+    m_world.swap(world);
+
+    m_parent.resize(newCount);
+    m_levelStart.clear();
+    uint32_t currentDepth = 0xFFFFFFFFu;
+    for (size_t i = 0; i < newCount; ++i)
+    {
+        SceneNodeHandle parent = m_handleParent[m_handle[i]];
+        m_parent[i] = (parent == INVALID_SCENE_NODE) ? NO_PARENT : static_cast<uint32_t>(m_handleToIndex[parent]);
+
+        uint32_t depth = m_handleDepth[m_handle[i]];
+        if (depth != currentDepth)
+        {
+            m_levelStart.push_back(i);
+            currentDepth = depth;
+        }
+    }
+    m_levelStart.push_back(newCount);
+
+    // Everything is recomputed once after a structural change
+    m_worldBounds.Clear();
+    m_worldBounds.Reserve(newCount);
+    for (size_t i = 0; i < newCount; ++i)
+    {
+        m_worldBounds.Add(XMFLOAT3(0.0f, 0.0f, 0.0f), XMFLOAT3(0.0f, 0.0f, 0.0f));
+    }
+    m_dirty.assign(newCount, 1);
+    m_changed.assign(newCount, 0);
+
+    m_structureDirty = false;
+}
+
+void SceneGraph::UpdateRange(size_t begin, size_t end)
+{
+    for (size_t i = begin; i < end; ++i)
+    {
+        uint32_t parent = m_parent[i];
+        bool parentChanged = (parent != NO_PARENT) && m_changed[parent];
+
+        if (!m_dirty[i] && !parentChanged)
+        {
+            m_changed[i] = 0;
+            continue;
+        }
+
+        XMMATRIX local = XMMatrixMultiply(XMMatrixScaling(m_scale[i].x, m_scale[i].y, m_scale[i].z),
+                                          XMMatrixRotationQuaternion(XMLoadFloat4(&m_rotation[i])));
+        local.r[3] = XMVectorSet(m_position[i].x, m_position[i].y, m_position[i].z, 1.0f);
+
+        XMMATRIX world = (parent != NO_PARENT) ? XMMatrixMultiply(local, XMLoadFloat4x4(&m_world[parent])) : local;
+        XMStoreFloat4x4(&m_world[i], world);
+
+        XMFLOAT3 center;
+        XMFLOAT3 extents;
+        FrustumCulling::TransformBox(m_localCenter[i], m_localExtents[i], world, center, extents);
+        m_worldBounds.centerX[i] = center.x;
+        m_worldBounds.centerY[i] = center.y;
+        m_worldBounds.centerZ[i] = center.z;
+        m_worldBounds.extentX[i] = extents.x;
+        m_worldBounds.extentY[i] = extents.y;
+        m_worldBounds.extentZ[i] = extents.z;
+
+        m_dirty[i] = 0;
+        m_changed[i] = 1;
+    }
+}
+
+void SceneGraph::UpdateTransforms()
+{
+    PROFILE_FUNCTION();
+
+    auto updateStart = std::chrono::high_resolution_clock::now();
+
+    m_stats.restructured = m_structureDirty;
+    if (m_structureDirty)
+    {
+        Restructure();
+    }
+
+    // Levels must run in order; nodes inside a level are independent
+    for (size_t level = 0; level + 1 < m_levelStart.size(); ++level)
+    {
+        size_t begin = m_levelStart[level];
+        size_t count = m_levelStart[level + 1] - begin;
+
+        if (m_parallelFor && count >= m_parallelThreshold)
+        {
+            m_parallelFor(count, [this, begin](size_t rangeBegin, size_t rangeEnd)
+            {
+                UpdateRange(begin + rangeBegin, begin + rangeEnd);
+            });
+        }
+        else
+        {
+            UpdateRange(begin, begin + count);
+        }
+    }
+
+    int updatedNodes = 0;
+    for (uint8_t changed : m_changed)
+    {
+        updatedNodes += changed;
+    }
+
+    auto updateEnd = std::chrono::high_resolution_clock::now();
+    m_stats.nodeCount = static_cast<int>(m_handle.size());
+    m_stats.levelCount = m_levelStart.empty() ? 0 : static_cast<int>(m_levelStart.size() - 1);
+    m_stats.updatedNodes = updatedNodes;
+    m_stats.updateTimeMs = std::chrono::duration<double, std::milli>(updateEnd - updateStart).count();
+}
+
+XMMATRIX SceneGraph::GetWorldMatrix(SceneNodeHandle node) const
+{
+    if (!IsValid(node))
+    {
+        return XMMatrixIdentity();
+    }
+    return XMLoadFloat4x4(&m_world[m_handleToIndex[node]]);
+}
+
+const XMFLOAT4X4& SceneGraph::GetWorldMatrixFloat(SceneNodeHandle node) const
+{
+    return m_world[m_handleToIndex[node]];
+}
+
+void* SceneGraph::GetUserData(SceneNodeHandle node) const
+{
+    return IsValid(node) ? m_userData[m_handleToIndex[node]] : nullptr;
+}
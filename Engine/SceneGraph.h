@@ -0,0 +1,118 @@
+#pragma once
+
+#include <DirectXMath.h>
+#include <vector>
+#include <functional>
+#include <cstdint>
+#include "../Graphics/FrustumCulling.h"
+#include "JobSystem.h"
+
+using namespace DirectX;
+
+// Stable node identifier; dense storage indices change when the hierarchy is re-sorted
+typedef uint32_t SceneNodeHandle;
+const SceneNodeHandle INVALID_SCENE_NODE = 0xFFFFFFFFu;
+
+// Statistics of the last UpdateTransforms call
+struct SceneGraphStats
+{
+    int nodeCount;
+    int levelCount;
+    int updatedNodes;
+    bool restructured;
+    double updateTimeMs;
+
+    SceneGraphStats()
+        : nodeCount(0)
+        , levelCount(0)
+        , updatedNodes(0)
+        , restructured(false)
+        , updateTimeMs(0.0)
+    {
+    }
+};
+
+// Data-oriented transform hierarchy.
+//
+// Local TRS, world matrices and world bounds live in parallel arrays sorted by
+// hierarchy depth, so every parent precedes its children and each depth level
+// is a contiguous range. Setting a local transform marks the node dirty;
+// UpdateTransforms() walks the levels in order and recomputes only nodes that
+// are dirty or whose parent changed, splitting each level across the
+// ParallelForFunction. World bounds are kept in CullingBoxes form so they can
+// be passed straight to FrustumCulling.
+class SceneGraph
+{
+public:
+    SceneGraph();
+    ~SceneGraph();
+
+    // Hierarchy
+    SceneNodeHandle CreateNode(SceneNodeHandle parent = INVALID_SCENE_NODE);
+    void DestroyNode(SceneNodeHandle node);   // Destroys the whole subtree
+    void Clear();
+    bool IsValid(SceneNodeHandle node) const;
+    SceneNodeHandle GetParent(SceneNodeHandle node) const;
+
+    // Local transform (scale, then rotation, then translation relative to the parent)
+    void SetLocalPosition(SceneNodeHandle node, const XMFLOAT3& position);
+    void SetLocalRotation(SceneNodeHandle node, const XMFLOAT4& quaternion);
+    void SetLocalRotation(SceneNodeHandle node, float pitch, float yaw, float roll);
+    void SetLocalScale(SceneNodeHandle node, const XMFLOAT3& scale);
+    void SetLocalBounds(SceneNodeHandle node, const XMFLOAT3& center, const XMFLOAT3& extents);
+    void SetUserData(SceneNodeHandle node, void* userData);
+
+    // Per-frame update
+    void UpdateTransforms();
+    void SetParallelForFunction(ParallelForFunction parallelFor) { m_parallelFor = parallelFor; }
+    void SetParallelThreshold(size_t nodesPerLevel) { m_parallelThreshold = nodesPerLevel; }
+
+    // Results (valid after UpdateTransforms)
+    XMMATRIX GetWorldMatrix(SceneNodeHandle node) const;
+    const XMFLOAT4X4& GetWorldMatrixFloat(SceneNodeHandle node) const;
+    void* GetUserData(SceneNodeHandle node) const;
+
+    // Dense access for bulk consumers such as culling; index order is depth order
+    const CullingBoxes& GetWorldBounds() const { return m_worldBounds; }
+    const std::vector<XMFLOAT4X4>& GetWorldMatrices() const { return m_world; }
+    SceneNodeHandle GetHandle(size_t denseIndex) const { return m_handle[denseIndex]; }
+    size_t GetDenseIndex(SceneNodeHandle node) const { return m_handleToIndex[node]; }
+    size_t GetNodeCount() const { return m_handle.size(); }
+    const SceneGraphStats& GetStats() const { return m_stats; }
+
+private:
+    void Restructure();
+    void UpdateRange(size_t begin, size_t end);
+    size_t AppendStorage();
+    void MarkDirty(SceneNodeHandle node);
+
+private:
+    // Dense arrays, sorted by depth
+    std::vector<uint32_t> m_parent;          // Dense index of parent, or 0xFFFFFFFF for roots
+    std::vector<SceneNodeHandle> m_handle;
+    std::vector<XMFLOAT3> m_position;
+    std::vector<XMFLOAT4> m_rotation;
+    std::vector<XMFLOAT3> m_scale;
+    std::vector<XMFLOAT3> m_localCenter;
+    std::vector<XMFLOAT3> m_localExtents;
+    std::vector<void*> m_userData;
+    std::vector<XMFLOAT4X4> m_world;
+    CullingBoxes m_worldBounds;
+    std::vector<uint8_t> m_dirty;            // Local transform changed
+    std::vector<uint8_t> m_changed;          // World transform recomputed this update
+
+    // Depth levels as [begin, end) ranges into the dense arrays
+    std::vector<size_t> m_levelStart;
+
+    // Handle table
+    std::vector<size_t> m_handleToIndex;
+    std::vector<uint32_t> m_handleDepth;
+    std::vector<SceneNodeHandle> m_handleParent;
+    std::vector<uint8_t> m_handleAlive;
+    std::vector<SceneNodeHandle> m_freeHandles;
+    bool m_structureDirty;
+
+    ParallelForFunction m_parallelFor;
+    size_t m_parallelThreshold;
+    SceneGraphStats m_stats;
+};
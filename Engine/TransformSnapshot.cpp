@@ -0,0 +1,93 @@
+#include "TransformSnapshot.h"
+#include <algorithm>
+
+void TransformState::Resize(size_t count)
+{
+    position.resize(count, XMFLOAT3(0.0f, 0.0f, 0.0f));
+    rotation.resize(count, XMFLOAT4(0.0f, 0.0f, 0.0f, 1.0f));
+    scale.resize(count, XMFLOAT3(1.0f, 1.0f, 1.0f));
+}
+
+void TransformState::Set(size_t index, const XMFLOAT3& newPosition, const XMFLOAT4& newRotation, const XMFLOAT3& newScale)
+{
+    position[index] = newPosition;
+    rotation[index] = newRotation;
+    scale[index] = newScale;
+}
+
+TransformSnapshotBuffer::TransformSnapshotBuffer()
+    : m_publishedTick(0)
+{
+}
+
+TransformSnapshotBuffer::~TransformSnapshotBuffer()
+{
+}
+
+void TransformSnapshotBuffer::Publish(const TransformState& state)
+{
+    TransformSnapshot& slot = m_buffer.GetWriteBuffer();
+
+    // The first publish has no history; interpolate from the state to itself
+    const TransformState& previous = (m_lastPublished.Size() == state.Size()) ? m_lastPublished : state;
+    slot.previous = previous;
+    slot.current = state;
+    slot.tick = m_publishedTick.load(std::memory_order_relaxed) + 1;
+    m_lastPublished = state;
+
+    uint64_t tick = slot.tick;
+    m_buffer.Publish();
+    m_publishedTick.store(tick, std::memory_order_release);
+}
+
+const TransformSnapshot* TransformSnapshotBuffer::Acquire()
+{
+    m_buffer.Update();
+
+    const TransformSnapshot& snapshot = m_buffer.GetReadBuffer();
+    return snapshot.tick > 0 ? &snapshot : nullptr;
+}
+
+namespace SnapshotInterpolation
+{
+    void InterpolateState(const TransformSnapshot& snapshot, float alpha, TransformState& output)
+    {
+        size_t count = std::min(snapshot.previous.Size(), snapshot.current.Size());
+        output.Resize(count);
+
+        XMVECTOR t = XMVectorReplicate(alpha);
+        for (size_t i = 0; i < count; ++i)
+        {
+            XMVECTOR position = XMVectorLerpV(XMLoadFloat3(&snapshot.previous.position[i]),
+                                              XMLoadFloat3(&snapshot.current.position[i]), t);
+            XMVECTOR scale = XMVectorLerpV(XMLoadFloat3(&snapshot.previous.scale[i]),
+                                           XMLoadFloat3(&snapshot.current.scale[i]), t);
+            XMVECTOR rotation = XMQuaternionSlerpV(XMLoadFloat4(&snapshot.previous.rotation[i]),
+                                                   XMLoadFloat4(&snapshot.current.rotation[i]), t);
+
+            XMStoreFloat3(&output.position[i], position);
+            XMStoreFloat3(&output.scale[i], scale);
+            XMStoreFloat4(&output.rotation[i], rotation);
+        }
+    }
+
+    void InterpolateWorldMatrices(const TransformSnapshot& snapshot, float alpha, XMFLOAT4X4* output)
+    {
+        size_t count = std::min(snapshot.previous.Size(), snapshot.current.Size());
+
+        XMVECTOR t = XMVectorReplicate(alpha);
+        for (size_t i = 0; i < count; ++i)
+        {
+            XMVECTOR position = XMVectorLerpV(XMLoadFloat3(&snapshot.previous.position[i]),
+                                              XMLoadFloat3(&snapshot.current.position[i]), t);
+            XMVECTOR scale = XMVectorLerpV(XMLoadFloat3(&snapshot.previous.scale[i]),
+                                           XMLoadFloat3(&snapshot.current.scale[i]), t);
+            XMVECTOR rotation = XMQuaternionSlerpV(XMLoadFloat4(&snapshot.previous.rotation[i]),
+                                                   XMLoadFloat4(&snapshot.current.rotation[i]), t);
+
+            XMMATRIX world = XMMatrixMultiply(XMMatrixScalingFromVector(scale), XMMatrixRotationQuaternion(rotation));
+            world.r[3] = XMVectorSetW(position, 1.0f);
+            XMStoreFloat4x4(&output[i], world);
+        }
+    }
+}
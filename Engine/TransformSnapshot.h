@@ -0,0 +1,69 @@
+#pragma once
+
+#include <DirectXMath.h>
+#include <vector>
+#include <atomic>
+#include <cstdint>
+#include "TripleBuffer.h"
+
+using namespace DirectX;
+
+// Transform state of all simulated objects at one fixed update
+struct TransformState
+{
+    std::vector<XMFLOAT3> position;
+    std::vector<XMFLOAT4> rotation;   // Quaternion
+    std::vector<XMFLOAT3> scale;
+
+    void Resize(size_t count);
+    size_t Size() const { return position.size(); }
+    void Set(size_t index, const XMFLOAT3& newPosition, const XMFLOAT4& newRotation, const XMFLOAT3& newScale);
+};
+
+// Two consecutive fixed updates. The renderer interpolates between them
+// with the loop's interpolation factor.
+struct TransformSnapshot
+{
+    TransformState previous;
+    TransformState current;
+    uint64_t tick;
+
+    TransformSnapshot()
+        : tick(0)
+    {
+    }
+};
+
+// Lock-free exchange of snapshots between the update and render sides.
+// Publish() fills the write slot of a TripleBuffer with the last published
+// state as previous and the new state as current; Acquire() picks up the
+// newest snapshot if there is one. Neither side ever blocks.
+class TransformSnapshotBuffer
+{
+public:
+    TransformSnapshotBuffer();
+    ~TransformSnapshotBuffer();
+
+    // Update side
+    void Publish(const TransformState& state);
+
+    // Render side; returns nullptr until the first publish
+    const TransformSnapshot* Acquire();
+
+    uint64_t GetPublishedTick() const { return m_publishedTick.load(std::memory_order_acquire); }
+
+private:
+    TripleBuffer<TransformSnapshot> m_buffer;
+    TransformState m_lastPublished;
+    std::atomic<uint64_t> m_publishedTick;
+};
+
+// SIMD interpolation between the two states of a snapshot
+namespace SnapshotInterpolation
+{
+    // Lerp positions and scales, slerp rotations
+    void InterpolateState(const TransformSnapshot& snapshot, float alpha, TransformState& output);
+
+    // Same, composed into scale * rotation * translation world matrices
+    void InterpolateWorldMatrices(const TransformSnapshot& snapshot, float alpha, XMFLOAT4X4* output);
+}
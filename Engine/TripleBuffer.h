@@ -0,0 +1,59 @@
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+
+// Single-producer, single-consumer lock-free triple buffer.
+//
+// The writer fills GetWriteBuffer() and calls Publish(), which swaps its
+// buffer with the shared ready buffer in one atomic exchange. The reader calls
+// Update() to swap its buffer with the ready one when something new was
+// published, then reads GetReadBuffer(). Neither side blocks; the reader
+// always sees the latest complete publish and intermediate ones are dropped.
+// After Publish() the write buffer holds stale data and must be fully rewritten.
+template <typename T>
+class TripleBuffer
+{
+public:
+    TripleBuffer()
+        : m_ready(1)
+        , m_writeIndex(0)
+        , m_readIndex(2)
+    {
+    }
+
+    // Writer side
+    T& GetWriteBuffer() { return m_buffers[m_writeIndex]; }
+
+    void Publish()
+    {
+        uint32_t oldReady = m_ready.exchange(m_writeIndex | NEW_DATA_BIT, std::memory_order_acq_rel);
+        m_writeIndex = oldReady & INDEX_MASK;
+    }
+
+    // Reader side
+    bool HasNewData() const { return (m_ready.load(std::memory_order_acquire) & NEW_DATA_BIT) != 0; }
+
+    bool Update()
+    {
+        if (!HasNewData())
+        {
+            return false;
+        }
+
+        uint32_t oldReady = m_ready.exchange(m_readIndex, std::memory_order_acq_rel);
+        m_readIndex = oldReady & INDEX_MASK;
+        return true;
+    }
+
+    const T& GetReadBuffer() const { return m_buffers[m_readIndex]; }
+
+private:
+    static const uint32_t INDEX_MASK = 0x3;
+    static const uint32_t NEW_DATA_BIT = 0x4;
+
+    T m_buffers[3];
+    std::atomic<uint32_t> m_ready;
+    uint32_t m_writeIndex;
+    uint32_t m_readIndex;
+};
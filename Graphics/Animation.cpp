@@ -1,4 +1,6 @@
 #include "Animation.h"
+#include "../Engine/Profiler.h"
+#include "../Engine/Memory.h"
 #include <algorithm>
 #include <iostream>
 
@@ -6,6 +8,7 @@
 Animation::Animation()
     : m_duration(0.0f)
     , m_ticksPerSecond(25.0f)
+    , m_memoryBytes(0)
 {
 }
 
@@ -25,15 +28,51 @@ bool Animation::Initialize(const std::string& name, float duration, float ticksP
 void Animation::Shutdown()
 {
     m_channels.clear();
+    m_memoryBytes = 0;
+    Memory::UntrackResource(MemoryCategory::Animation, this);
 }
 
 void Animation::AddChannel(const AnimationChannel& channel)
 {
     m_channels.push_back(channel);
+
+    const AnimationChannel& added = m_channels.back();
+    m_memoryBytes += sizeof(AnimationChannel) + added.boneName.capacity() +
+                     (added.positionKeys.capacity() + added.rotationKeys.capacity() + added.scaleKeys.capacity()) *
+                     sizeof(AnimationKey<XMVECTOR>);
+    Memory::TrackResource(MemoryCategory::Animation, this, m_name, m_memoryBytes);
 }
 
 void Animation::EvaluateAnimation(float timeInSeconds, const std::vector<Bone>& skeleton,
                                  std::vector<XMMATRIX>& boneTransforms) const
+{
+    PROFILE_FUNCTION();
+
+    EvaluateChannels(GetAnimationTime(timeInSeconds), 0, m_channels.size(), skeleton.size(), boneTransforms);
+}
+
+void Animation::EvaluateAnimation(float timeInSeconds, const std::vector<Bone>& skeleton,
+                                 std::vector<XMMATRIX>& boneTransforms,
+                                 const ParallelForFunction& parallelFor) const
+{
+    PROFILE_FUNCTION();
+
+    if (!parallelFor)
+    {
+        EvaluateAnimation(timeInSeconds, skeleton, boneTransforms);
+        return;
+    }
+
+    // Each channel writes only its own bone, so ranges are independent
+    float animationTime = GetAnimationTime(timeInSeconds);
+    size_t boneCount = skeleton.size();
+    parallelFor(m_channels.size(), [this, animationTime, boneCount, &boneTransforms](size_t begin, size_t end)
+    {
+        EvaluateChannels(animationTime, begin, end, boneCount, boneTransforms);
+    });
+}
+
+float Animation::GetAnimationTime(float timeInSeconds) const
 {
     float animationTime = timeInSeconds * m_ticksPerSecond;
 
@@ -43,9 +82,16 @@ void Animation::EvaluateAnimation(float timeInSeconds, const std::vector<Bone>&
         animationTime = fmod(animationTime, m_duration);
     }
 
-    for (const auto& channel : m_channels)
+    return animationTime;
+}
+
+void Animation::EvaluateChannels(float animationTime, size_t begin, size_t end, size_t boneCount,
+                                 std::vector<XMMATRIX>& boneTransforms) const
+{
+    for (size_t i = begin; i < end; ++i)
     {
-        if (channel.boneIndex < 0 || channel.boneIndex >= skeleton.size())
+        const AnimationChannel& channel = m_channels[i];
+        if (channel.boneIndex < 0 || static_cast<size_t>(channel.boneIndex) >= boneCount)
             continue;
 
         // Interpolate transformations
@@ -62,7 +108,7 @@ void Animation::EvaluateAnimation(float timeInSeconds, const std::vector<Bone>&
         XMMATRIX localTransform = scaleMatrix * rotationMatrix * translationMatrix;
 
         // Store in bone transforms
-        if (channel.boneIndex < boneTransforms.size())
+        if (static_cast<size_t>(channel.boneIndex) < boneTransforms.size())
         {
             boneTransforms[channel.boneIndex] = localTransform;
         }
@@ -84,7 +130,7 @@ XMVECTOR Animation::InterpolatePosition(const AnimationChannel& channel, float a
     int keyIndex = FindPositionKeyIndex(channel, animationTime);
     int nextKeyIndex = keyIndex + 1;
 
-    if (nextKeyIndex >= channel.positionKeys.size())
+    if (nextKeyIndex >= static_cast<int>(channel.positionKeys.size()))
     {
         return channel.positionKeys[keyIndex].value;
     }
@@ -114,7 +160,7 @@ XMVECTOR Animation::InterpolateRotation(const AnimationChannel& channel, float a
     int keyIndex = FindRotationKeyIndex(channel, animationTime);
     int nextKeyIndex = keyIndex + 1;
 
-    if (nextKeyIndex >= channel.rotationKeys.size())
+    if (nextKeyIndex >= static_cast<int>(channel.rotationKeys.size()))
     {
         return channel.rotationKeys[keyIndex].value;
     }
@@ -144,7 +190,7 @@ XMVECTOR Animation::InterpolateScale(const AnimationChannel& channel, float anim
     int keyIndex = FindScaleKeyIndex(channel, animationTime);
     int nextKeyIndex = keyIndex + 1;
 
-    if (nextKeyIndex >= channel.scaleKeys.size())
+    if (nextKeyIndex >= static_cast<int>(channel.scaleKeys.size()))
     {
         return channel.scaleKeys[keyIndex].value;
     }
@@ -161,7 +207,7 @@ XMVECTOR Animation::InterpolateScale(const AnimationChannel& channel, float anim
 
 int Animation::FindPositionKeyIndex(const AnimationChannel& channel, float animationTime) const
 {
-    for (int i = 0; i < channel.positionKeys.size() - 1; ++i)
+    for (int i = 0; i < static_cast<int>(channel.positionKeys.size()) - 1; ++i)
     {
         if (animationTime < channel.positionKeys[i + 1].time)
         {
@@ -173,7 +219,7 @@ int Animation::FindPositionKeyIndex(const AnimationChannel& channel, float anima
 
 int Animation::FindRotationKeyIndex(const AnimationChannel& channel, float animationTime) const
 {
-    for (int i = 0; i < channel.rotationKeys.size() - 1; ++i)
+    for (int i = 0; i < static_cast<int>(channel.rotationKeys.size()) - 1; ++i)
     {
         if (animationTime < channel.rotationKeys[i + 1].time)
         {
@@ -185,7 +231,7 @@ int Animation::FindRotationKeyIndex(const AnimationChannel& channel, float anima
 
 int Animation::FindScaleKeyIndex(const AnimationChannel& channel, float animationTime) const
 {
-    for (int i = 0; i < channel.scaleKeys.size() - 1; ++i)
+    for (int i = 0; i < static_cast<int>(channel.scaleKeys.size()) - 1; ++i)
     {
         if (animationTime < channel.scaleKeys[i + 1].time)
         {
@@ -212,7 +258,7 @@ bool Skeleton::Initialize(const std::vector<Bone>& bones)
 
     // Build name to index mapping
     m_boneNameToIndex.clear();
-    for (int i = 0; i < m_bones.size(); ++i)
+    for (int i = 0; i < static_cast<int>(m_bones.size()); ++i)
     {
         m_boneNameToIndex[m_bones[i].name] = i;
     }
@@ -242,10 +288,12 @@ int Skeleton::FindBoneIndex(const std::string& name) const
 
 void Skeleton::CalculateBoneTransforms(std::vector<XMMATRIX>& boneTransforms) const
 {
+    PROFILE_FUNCTION();
+
     boneTransforms.resize(m_bones.size());
 
     // Find root bones and calculate recursively
-    for (int i = 0; i < m_bones.size(); ++i)
+    for (int i = 0; i < static_cast<int>(m_bones.size()); ++i)
     {
         if (m_bones[i].parentIndex == -1)
         {
@@ -256,7 +304,7 @@ void Skeleton::CalculateBoneTransforms(std::vector<XMMATRIX>& boneTransforms) co
 
 void Skeleton::SetBonePose(int boneIndex, const XMMATRIX& transform)
 {
-    if (boneIndex >= 0 && boneIndex < m_bones.size())
+    if (boneIndex >= 0 && boneIndex < static_cast<int>(m_bones.size()))
     {
         m_bones[boneIndex].currentMatrix = transform;
     }
@@ -265,7 +313,7 @@ void Skeleton::SetBonePose(int boneIndex, const XMMATRIX& transform)
 void Skeleton::CalculateBoneTransformRecursive(int boneIndex, const XMMATRIX& parentTransform,
                                               std::vector<XMMATRIX>& boneTransforms) const
 {
-    if (boneIndex < 0 || boneIndex >= m_bones.size())
+    if (boneIndex < 0 || boneIndex >= static_cast<int>(m_bones.size()))
         return;
 
     const Bone& bone = m_bones[boneIndex];
@@ -379,10 +427,12 @@ void AnimationController::ResumeAnimation()
 
 void AnimationController::Update(float deltaTime)
 {
+    PROFILE_FUNCTION();
+
     if (!m_isPlaying || m_isPaused || m_currentAnimationIndex < 0)
         return;
 
-    if (m_currentAnimationIndex >= m_animations.size())
+    if (m_currentAnimationIndex >= static_cast<int>(m_animations.size()))
         return;
 
     auto currentAnimation = m_animations[m_currentAnimationIndex];
@@ -431,15 +481,8 @@ void AnimationController::UpdateBoneTransforms()
     if (!currentAnimation)
         return;
 
-    // Get bone transforms from skeleton
-    std::vector<Bone> bones(m_skeleton->GetBoneCount());
-    for (int i = 0; i < m_skeleton->GetBoneCount(); ++i)
-    {
-        bones[i] = m_skeleton->GetBone(i);
-    }
-
-    // Evaluate current animation
-    currentAnimation->EvaluateAnimation(m_currentTime, bones, m_boneTransforms);
+    // Evaluate current animation straight from the skeleton's bones
+    currentAnimation->EvaluateAnimation(m_currentTime, m_skeleton->GetBones(), m_boneTransforms, m_parallelFor);
 
     // Apply blending if active
     if (m_enableBlending && m_previousAnimationIndex >= 0 && m_currentBlendTime < m_blendTime)
@@ -453,9 +496,26 @@ void AnimationController::UpdateBoneTransforms()
 }
 
 void AnimationController::BlendAnimations(float blendFactor)
+{
+    PROFILE_FUNCTION();
+
+    if (m_parallelFor)
+    {
+        m_parallelFor(m_boneTransforms.size(), [this, blendFactor](size_t begin, size_t end)
+        {
+            BlendBoneRange(blendFactor, begin, end);
+        });
+    }
+    else
+    {
+        BlendBoneRange(blendFactor, 0, m_boneTransforms.size());
+    }
+}
+
+void AnimationController::BlendBoneRange(float blendFactor, size_t begin, size_t end)
 {
     // Blend between previous and current bone transforms
-    for (int i = 0; i < m_boneTransforms.size(); ++i)
+    for (size_t i = begin; i < end; ++i)
     {
         // Decompose matrices for proper blending
         XMVECTOR scale1, rotation1, translation1;
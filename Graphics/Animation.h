@@ -1,11 +1,12 @@
 #pragma once
 
-#include <d3d11.h>
 #include <DirectXMath.h>
 #include <vector>
 #include <string>
 #include <memory>
 #include <unordered_map>
+#include "../Engine/JobSystem.h"
+#include "../Resources/Vertex.h"   // SkinnedVertex
 
 using namespace DirectX;
 
@@ -75,15 +76,28 @@ public:
     void AddChannel(const AnimationChannel& channel);
     const std::vector<AnimationChannel>& GetChannels() const { return m_channels; }
 
+    // Keyframe storage, as reported to MemoryCategory::Animation
+    size_t GetMemoryBytes() const { return m_memoryBytes; }
+
     // Animation evaluation
     void EvaluateAnimation(float timeInSeconds, const std::vector<Bone>& skeleton,
                           std::vector<XMMATRIX>& boneTransforms) const;
 
+    // Same result; channels are split into ranges through parallelFor
+    void EvaluateAnimation(float timeInSeconds, const std::vector<Bone>& skeleton,
+                          std::vector<XMMATRIX>& boneTransforms,
+                          const ParallelForFunction& parallelFor) const;
+
 private:
+    float GetAnimationTime(float timeInSeconds) const;
+    void EvaluateChannels(float animationTime, size_t begin, size_t end, size_t boneCount,
+                          std::vector<XMMATRIX>& boneTransforms) const;
+
     std::string m_name;
     float m_duration;
     float m_ticksPerSecond;
     std::vector<AnimationChannel> m_channels;
+    size_t m_memoryBytes;
 
     // Helper functions for interpolation
     XMVECTOR InterpolatePosition(const AnimationChannel& channel, float animationTime) const;
@@ -111,6 +125,7 @@ public:
     Bone& GetBone(int index) { return m_bones[index]; }
 
     int GetBoneCount() const { return static_cast<int>(m_bones.size()); }
+    const std::vector<Bone>& GetBones() const { return m_bones; }
     int FindBoneIndex(const std::string& name) const;
 
     // Transformation calculation
@@ -159,6 +174,9 @@ public:
     void SetBlendMode(bool enable) { m_enableBlending = enable; }
     void SetBlendTime(float blendTime) { m_blendTime = blendTime; }
 
+    // Optional parallel evaluation (e.g. JobSystem::GetParallelForFunction)
+    void SetParallelForFunction(ParallelForFunction parallelFor) { m_parallelFor = parallelFor; }
+
     // Get current bone transforms for rendering
     const std::vector<XMMATRIX>& GetBoneTransforms() const { return m_boneTransforms; }
 
@@ -184,35 +202,9 @@ private:
     std::vector<XMMATRIX> m_boneTransforms;
     std::vector<XMMATRIX> m_previousBoneTransforms;
 
+    ParallelForFunction m_parallelFor;
+
     void UpdateBoneTransforms();
     void BlendAnimations(float blendFactor);
-};
-
-// Vertex structure with bone weights
-struct SkinnedVertex
-{
-    XMFLOAT3 position;
-    XMFLOAT3 normal;
-    XMFLOAT2 texCoord;
-    XMFLOAT3 tangent;
-    XMFLOAT3 binormal;
-
-    // Skinning data (max 4 bones per vertex)
-    uint32_t boneIndices[4];
-    float boneWeights[4];
-
-    SkinnedVertex()
-    {
-        position = XMFLOAT3(0.0f, 0.0f, 0.0f);
-        normal = XMFLOAT3(0.0f, 1.0f, 0.0f);
-        texCoord = XMFLOAT2(0.0f, 0.0f);
-        tangent = XMFLOAT3(1.0f, 0.0f, 0.0f);
-        binormal = XMFLOAT3(0.0f, 0.0f, 1.0f);
-
-        for (int i = 0; i < 4; ++i)
-        {
-            boneIndices[i] = 0;
-            boneWeights[i] = 0.0f;
-        }
-    }
+    void BlendBoneRange(float blendFactor, size_t begin, size_t end);
 };
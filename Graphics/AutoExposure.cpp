@@ -0,0 +1,146 @@
+#include "AutoExposure.h"
+#include <algorithm>
+#include <cmath>
+
+namespace
+{
+    // Bins of the measured range; bin 0 is for black
+    const float MEASURED_BINS = static_cast<float>(LUMINANCE_HISTOGRAM_BINS - 2);
+
+    void CountTileRows(const PostProcessImage& image, const PostProcessParams& params,
+                       size_t tileRowBegin, size_t tileRowEnd,
+                       std::vector<LuminanceHistogram>& rowHistograms)
+    {
+        for (size_t tileRow = tileRowBegin; tileRow < tileRowEnd; ++tileRow)
+        {
+            LuminanceHistogram& histogram = rowHistograms[tileRow];
+            int yBegin = static_cast<int>(tileRow) * LUMINANCE_HISTOGRAM_TILE;
+            int yEnd = std::min(yBegin + LUMINANCE_HISTOGRAM_TILE, image.height);
+
+            for (int tileX = 0; tileX < image.width; tileX += LUMINANCE_HISTOGRAM_TILE)
+            {
+                // Local counts of one thread group, added to the row at the end
+                LuminanceHistogram tile;
+                int xEnd = std::min(tileX + LUMINANCE_HISTOGRAM_TILE, image.width);
+
+                for (int y = yBegin; y < yEnd; ++y)
+                {
+                    for (int x = tileX; x < xEnd; ++x)
+                    {
+                        float luminance = AutoExposure::GetLuminance(image.At(x, y));
+                        ++tile.bins[AutoExposure::GetHistogramBin(luminance, params)];
+                    }
+                }
+                tile.pixelCount = static_cast<uint64_t>(xEnd - tileX) * (yEnd - yBegin);
+
+                histogram.Merge(tile);
+            }
+        }
+    }
+}
+
+void LuminanceHistogram::Clear()
+{
+    std::fill(bins, bins + LUMINANCE_HISTOGRAM_BINS, 0u);
+    pixelCount = 0;
+}
+
+void LuminanceHistogram::Merge(const LuminanceHistogram& other)
+{
+    for (int i = 0; i < LUMINANCE_HISTOGRAM_BINS; ++i)
+    {
+        bins[i] += other.bins[i];
+    }
+    pixelCount += other.pixelCount;
+}
+
+namespace AutoExposure
+{
+    float GetLuminance(const XMFLOAT4& color)
+    {
+        return color.x * 0.2126f + color.y * 0.7152f + color.z * 0.0722f;
+    }
+
+    int GetHistogramBin(float luminance, const PostProcessParams& params)
+    {
+        if (luminance < MIN_MEASURED_LUMINANCE)
+        {
+            return 0;
+        }
+
+        float inverseRange = 1.0f / (params.maxLogLuminance - params.minLogLuminance);
+        float position = (std::log2(luminance) - params.minLogLuminance) * inverseRange;
+        position = std::min(std::max(position, 0.0f), 1.0f);
+        return static_cast<int>(position * MEASURED_BINS + 1.0f);
+    }
+
+    void BuildHistogram(const PostProcessImage& image, const PostProcessParams& params,
+                        LuminanceHistogram& histogram)
+    {
+        histogram.Clear();
+        for (const XMFLOAT4& pixel : image.pixels)
+        {
+            ++histogram.bins[GetHistogramBin(GetLuminance(pixel), params)];
+        }
+        histogram.pixelCount = image.pixels.size();
+    }
+
+    void BuildHistogramTiled(const PostProcessImage& image, const PostProcessParams& params,
+                             LuminanceHistogram& histogram, const ParallelForFunction& parallelFor)
+    {
+        histogram.Clear();
+
+        size_t tileRows = (image.height + LUMINANCE_HISTOGRAM_TILE - 1) / LUMINANCE_HISTOGRAM_TILE;
+        std::vector<LuminanceHistogram> rowHistograms(tileRows);
+
+        if (parallelFor)
+        {
+            parallelFor(tileRows, [&](size_t begin, size_t end)
+            {
+                CountTileRows(image, params, begin, end, rowHistograms);
+            });
+        }
+        else
+        {
+            CountTileRows(image, params, 0, tileRows, rowHistograms);
+        }
+
+        for (const LuminanceHistogram& row : rowHistograms)
+        {
+            histogram.Merge(row);
+        }
+    }
+
+    float GetAverageLuminance(const LuminanceHistogram& histogram, const PostProcessParams& params)
+    {
+        // Count-weighted mean bin index; bin 0 weighs nothing and is left
+        // out of the count
+        double weightedSum = 0.0;
+        for (int i = 1; i < LUMINANCE_HISTOGRAM_BINS; ++i)
+        {
+            weightedSum += static_cast<double>(histogram.bins[i]) * i;
+        }
+
+        double measured = static_cast<double>(histogram.pixelCount - histogram.bins[0]);
+        float meanBin = static_cast<float>(weightedSum / std::max(measured, 1.0));
+
+        float range = params.maxLogLuminance - params.minLogLuminance;
+        float logAverage = (meanBin - 1.0f) / MEASURED_BINS * range + params.minLogLuminance;
+        return std::exp2(logAverage);
+    }
+
+    float GetAdaptationRate(float deltaTime, const PostProcessParams& params)
+    {
+        return 1.0f - std::exp(-deltaTime * params.adaptationSpeed);
+    }
+
+    float Adapt(float adaptedLuminance, float averageLuminance, float deltaTime, const PostProcessParams& params)
+    {
+        return adaptedLuminance + (averageLuminance - adaptedLuminance) * GetAdaptationRate(deltaTime, params);
+    }
+
+    float GetExposure(float adaptedLuminance, const PostProcessParams& params)
+    {
+        return params.exposure * params.exposureKey / std::max(adaptedLuminance, MIN_MEASURED_LUMINANCE);
+    }
+}
@@ -0,0 +1,66 @@
+#pragma once
+
+#include <cstdint>
+#include "PostProcessChain.h"
+#include "PostProcessKernels.h"
+#include "../Engine/JobSystem.h"
+
+// Log-luminance histogram of an HDR frame. Bin 0 counts pixels too dark to
+// measure; bins 1..255 split [minLogLuminance, maxLogLuminance] evenly and
+// clamp what falls outside.
+const int LUMINANCE_HISTOGRAM_BINS = 256;
+
+// Side of the tiles counted into one local histogram, the thread group of
+// the histogram compute shader
+const int LUMINANCE_HISTOGRAM_TILE = 16;
+
+// Below this luminance a pixel lands in bin 0; also the floor of the
+// adapted luminance the exposure divides by
+const float MIN_MEASURED_LUMINANCE = 0.0001f;
+
+struct LuminanceHistogram
+{
+    uint32_t bins[LUMINANCE_HISTOGRAM_BINS];
+    uint64_t pixelCount;
+
+    LuminanceHistogram()
+    {
+        Clear();
+    }
+
+    void Clear();
+    void Merge(const LuminanceHistogram& other);
+};
+
+// CPU reference of the GPU auto-exposure (PostProcessManager::SetAutoExposure).
+// The histogram is counted per tile and the tiles are merged, the way the
+// compute shader's thread groups reduce into one buffer; the average and the
+// adaptation repeat the math of the reduction shader.
+namespace AutoExposure
+{
+    float GetLuminance(const XMFLOAT4& color);          // Rec. 709
+    int GetHistogramBin(float luminance, const PostProcessParams& params);
+
+    // One pixel at a time into a single histogram
+    void BuildHistogram(const PostProcessImage& image, const PostProcessParams& params,
+                        LuminanceHistogram& histogram);
+
+    // Rows of tiles counted into their own histograms and merged at the end.
+    // With parallelFor the rows are spread over its workers; the result is
+    // the same as BuildHistogram.
+    void BuildHistogramTiled(const PostProcessImage& image, const PostProcessParams& params,
+                             LuminanceHistogram& histogram,
+                             const ParallelForFunction& parallelFor = ParallelForFunction());
+
+    // Geometric mean of the measured pixels (bins 1..255), at bin resolution
+    float GetAverageLuminance(const LuminanceHistogram& histogram, const PostProcessParams& params);
+
+    // Exponential approach of the adapted luminance to the measured one;
+    // params.adaptationSpeed is the rate per second
+    float GetAdaptationRate(float deltaTime, const PostProcessParams& params);
+    float Adapt(float adaptedLuminance, float averageLuminance, float deltaTime, const PostProcessParams& params);
+
+    // Factor the tone mapping applies: the adapted luminance maps to
+    // params.exposureKey and params.exposure is a compensation on top
+    float GetExposure(float adaptedLuminance, const PostProcessParams& params);
+}
@@ -0,0 +1,706 @@
+#include "BoundingVolumeHierarchy.h"
+#include "FrustumCulling.h"
+#include "../Engine/Profiler.h"
+#include <algorithm>
+#include <cmath>
+
+namespace
+{
+    const int SAH_BIN_COUNT = 16;
+    const size_t TRAVERSAL_STACK_RESERVE = 64;
+
+    inline float SurfaceArea(const XMFLOAT3& min, const XMFLOAT3& max)
+    {
+        float dx = max.x - min.x;
+        float dy = max.y - min.y;
+        float dz = max.z - min.z;
+        return 2.0f * (dx * dy + dy * dz + dz * dx);
+    }
+
+    inline void Grow(XMFLOAT3& min, XMFLOAT3& max, const XMFLOAT3& otherMin, const XMFLOAT3& otherMax)
+    {
+        min.x = std::min(min.x, otherMin.x);
+        min.y = std::min(min.y, otherMin.y);
+        min.z = std::min(min.z, otherMin.z);
+        max.x = std::max(max.x, otherMax.x);
+        max.y = std::max(max.y, otherMax.y);
+        max.z = std::max(max.z, otherMax.z);
+    }
+
+    inline bool Overlaps(const XMFLOAT3& aMin, const XMFLOAT3& aMax, const XMFLOAT3& bMin, const XMFLOAT3& bMax)
+    {
+        return aMin.x <= bMax.x && aMax.x >= bMin.x &&
+               aMin.y <= bMax.y && aMax.y >= bMin.y &&
+               aMin.z <= bMax.z && aMax.z >= bMin.z;
+    }
+
+    inline float Component(const XMFLOAT3& v, int axis)
+    {
+        return axis == 0 ? v.x : (axis == 1 ? v.y : v.z);
+    }
+
+    enum class FrustumResult
+    {
+        Outside,
+        Intersecting,
+        Inside
+    };
+
+    FrustumResult ClassifyBox(const Frustum& frustum, const XMFLOAT3& min, const XMFLOAT3& max)
+    {
+        XMFLOAT3 center((min.x + max.x) * 0.5f, (min.y + max.y) * 0.5f, (min.z + max.z) * 0.5f);
+        XMFLOAT3 extents((max.x - min.x) * 0.5f, (max.y - min.y) * 0.5f, (max.z - min.z) * 0.5f);
+
+        FrustumResult result = FrustumResult::Inside;
+        for (int i = 0; i < Frustum::PlaneCount; ++i)
+        {
+            const XMFLOAT4& p = frustum.planes[i];
+            float distance = p.x * center.x + p.y * center.y + p.z * center.z + p.w;
+            float radius = std::fabs(p.x) * extents.x + std::fabs(p.y) * extents.y + std::fabs(p.z) * extents.z;
+            if (distance + radius < 0.0f)
+            {
+                return FrustumResult::Outside;
+            }
+            if (distance - radius < 0.0f)
+            {
+                result = FrustumResult::Intersecting;
+            }
+        }
+        return result;
+    }
+
+    // Slab test; returns the entry distance or FLT_MAX on a miss
+    inline float RayBoxEntry(const XMFLOAT3& origin, const XMFLOAT3& inverseDirection,
+                             const XMFLOAT3& min, const XMFLOAT3& max, float maxDistance)
+    {
+        float t1 = (min.x - origin.x) * inverseDirection.x;
+        float t2 = (max.x - origin.x) * inverseDirection.x;
+        float tMin = std::min(t1, t2);
+        float tMax = std::max(t1, t2);
+
+        t1 = (min.y - origin.y) * inverseDirection.y;
+        t2 = (max.y - origin.y) * inverseDirection.y;
+        tMin = std::max(tMin, std::min(t1, t2));
+        tMax = std::min(tMax, std::max(t1, t2));
+
+        t1 = (min.z - origin.z) * inverseDirection.z;
+        t2 = (max.z - origin.z) * inverseDirection.z;
+        tMin = std::max(tMin, std::min(t1, t2));
+        tMax = std::min(tMax, std::max(t1, t2));
+
+        tMin = std::max(tMin, 0.0f);
+        if (tMax < tMin || tMin > maxDistance)
+        {
+            return FLT_MAX;
+        }
+        return tMin;
+    }
+}
+
+BoundingVolumeHierarchy::BoundingVolumeHierarchy()
+    : m_aliveCount(0)
+    , m_maxLeafSize(4)
+    , m_rebuildThreshold(0.1f)
+{
+}
+
+BoundingVolumeHierarchy::~BoundingVolumeHierarchy()
+{
+}
+
+int BoundingVolumeHierarchy::AllocateProxy()
+{
+    if (!m_freeProxies.empty())
+    {
+        int proxyId = m_freeProxies.back();
+        m_freeProxies.pop_back();
+        return proxyId;
+    }
+
+    m_proxies.push_back(Proxy());
+    return static_cast<int>(m_proxies.size()) - 1;
+}
+
+int BoundingVolumeHierarchy::CreateProxy(const XMFLOAT3& min, const XMFLOAT3& max, void* userData)
+{
+    int proxyId = AllocateProxy();
+
+    Proxy& proxy = m_proxies[proxyId];
+    proxy.min = min;
+    proxy.max = max;
+    proxy.userData = userData;
+    proxy.leaf = -1;
+    proxy.alive = true;
+
+    m_pendingProxies.push_back(proxyId);
+    m_aliveCount++;
+    return proxyId;
+}
+
+void BoundingVolumeHierarchy::DestroyProxy(int proxyId)
+{
+    if (proxyId < 0 || proxyId >= static_cast<int>(m_proxies.size()) || !m_proxies[proxyId].alive)
+    {
+        return;
+    }
+
+    Proxy& proxy = m_proxies[proxyId];
+    proxy.alive = false;
+    proxy.userData = nullptr;
+    m_aliveCount--;
+
+    if (proxy.leaf < 0)
+    {
+        // Never reached the tree, so the id can be reused right away
+        m_pendingProxies.erase(std::remove(m_pendingProxies.begin(), m_pendingProxies.end(), proxyId),
+                               m_pendingProxies.end());
+        m_freeProxies.push_back(proxyId);
+    }
+    else
+    {
+        m_destroyedProxies.push_back(proxyId);
+    }
+}
+
+void BoundingVolumeHierarchy::UpdateProxy(int proxyId, const XMFLOAT3& min, const XMFLOAT3& max)
+{
+    if (proxyId < 0 || proxyId >= static_cast<int>(m_proxies.size()) || !m_proxies[proxyId].alive)
+    {
+        return;
+    }
+
+    Proxy& proxy = m_proxies[proxyId];
+    proxy.min = min;
+    proxy.max = max;
+
+    if (proxy.leaf >= 0 && !m_nodeDirty[proxy.leaf])
+    {
+        m_nodeDirty[proxy.leaf] = 1;
+        m_dirtyLeaves.push_back(proxy.leaf);
+    }
+}
+
+void BoundingVolumeHierarchy::Clear()
+{
+    m_nodes.clear();
+    m_proxies.clear();
+    m_leafProxies.clear();
+    m_pendingProxies.clear();
+    m_freeProxies.clear();
+    m_destroyedProxies.clear();
+    m_dirtyLeaves.clear();
+    m_nodeDirty.clear();
+    m_aliveCount = 0;
+    m_stats = BVHStats();
+}
+
+void BoundingVolumeHierarchy::Build()
+{
+    PROFILE_FUNCTION();
+
+    m_nodes.clear();
+    m_leafProxies.clear();
+    m_pendingProxies.clear();
+    m_dirtyLeaves.clear();
+
+    // Destroyed ids are no longer referenced once the tree is rebuilt
+    m_freeProxies.insert(m_freeProxies.end(), m_destroyedProxies.begin(), m_destroyedProxies.end());
+    m_destroyedProxies.clear();
+
+    m_leafProxies.reserve(m_aliveCount);
+    for (int i = 0; i < static_cast<int>(m_proxies.size()); ++i)
+    {
+        if (m_proxies[i].alive)
+        {
+            m_leafProxies.push_back(i);
+        }
+    }
+
+    m_stats = BVHStats();
+    m_nodeDirty.clear();
+
+    if (m_leafProxies.empty())
+    {
+        return;
+    }
+
+    // Centroids are used for binning only
+    std::vector<XMFLOAT3> centroids(m_proxies.size());
+    for (int proxyId : m_leafProxies)
+    {
+        const Proxy& proxy = m_proxies[proxyId];
+        centroids[proxyId] = XMFLOAT3((proxy.min.x + proxy.max.x) * 0.5f,
+                                      (proxy.min.y + proxy.max.y) * 0.5f,
+                                      (proxy.min.z + proxy.max.z) * 0.5f);
+    }
+
+    m_nodes.reserve(m_leafProxies.size() * 2);
+
+    Node root = {};
+    root.firstIndex = 0;
+    root.count = static_cast<int>(m_leafProxies.size());
+    root.parent = -1;
+    m_nodes.push_back(root);
+
+    struct BuildTask
+    {
+        int node;
+        int depth;
+    };
+
+    std::vector<BuildTask> stack;
+    stack.push_back({ 0, 0 });
+
+    while (!stack.empty())
+    {
+        BuildTask task = stack.back();
+        stack.pop_back();
+
+        int first = m_nodes[task.node].firstIndex;
+        int count = m_nodes[task.node].count;
+        m_stats.maxDepth = std::max(m_stats.maxDepth, task.depth);
+
+        // Node bounds and centroid bounds
+        XMFLOAT3 nodeMin(FLT_MAX, FLT_MAX, FLT_MAX);
+        XMFLOAT3 nodeMax(-FLT_MAX, -FLT_MAX, -FLT_MAX);
+        XMFLOAT3 centroidMin(FLT_MAX, FLT_MAX, FLT_MAX);
+        XMFLOAT3 centroidMax(-FLT_MAX, -FLT_MAX, -FLT_MAX);
+        for (int i = first; i < first + count; ++i)
+        {
+            int proxyId = m_leafProxies[i];
+            Grow(nodeMin, nodeMax, m_proxies[proxyId].min, m_proxies[proxyId].max);
+            Grow(centroidMin, centroidMax, centroids[proxyId], centroids[proxyId]);
+        }
+        m_nodes[task.node].min = nodeMin;
+        m_nodes[task.node].max = nodeMax;
+
+        if (count <= m_maxLeafSize)
+        {
+            continue;
+        }
+
+        // Evaluate binned SAH on all three axes
+        int bestAxis = -1;
+        int bestSplit = -1;
+        float bestCost = FLT_MAX;
+
+        for (int axis = 0; axis < 3; ++axis)
+        {
+            float axisMin = Component(centroidMin, axis);
+            float axisExtent = Component(centroidMax, axis) - axisMin;
+            if (axisExtent <= 0.0f)
+            {
+                continue;
+            }
+
+            int binCount[SAH_BIN_COUNT] = {};
+            XMFLOAT3 binMin[SAH_BIN_COUNT];
+            XMFLOAT3 binMax[SAH_BIN_COUNT];
+            for (int b = 0; b < SAH_BIN_COUNT; ++b)
+            {
+                binMin[b] = XMFLOAT3(FLT_MAX, FLT_MAX, FLT_MAX);
+                binMax[b] = XMFLOAT3(-FLT_MAX, -FLT_MAX, -FLT_MAX);
+            }
+
+            float binScale = SAH_BIN_COUNT / axisExtent;
+            for (int i = first; i < first + count; ++i)
+            {
+                int proxyId = m_leafProxies[i];
+                int b = std::min(SAH_BIN_COUNT - 1, static_cast<int>((Component(centroids[proxyId], axis) - axisMin) * binScale));
+                binCount[b]++;
+                Grow(binMin[b], binMax[b], m_proxies[proxyId].min, m_proxies[proxyId].max);
+            }
+
+            // Sweep from the right to get suffix areas, then from the left
+            float rightArea[SAH_BIN_COUNT];
+            int rightCount[SAH_BIN_COUNT];
+            XMFLOAT3 sweepMin(FLT_MAX, FLT_MAX, FLT_MAX);
+            XMFLOAT3 sweepMax(-FLT_MAX, -FLT_MAX, -FLT_MAX);
+            int sweepCount = 0;
+            for (int b = SAH_BIN_COUNT - 1; b > 0; --b)
+            {
+                if (binCount[b] > 0)
+                {
+                    Grow(sweepMin, sweepMax, binMin[b], binMax[b]);
+                }
+                sweepCount += binCount[b];
+                rightCount[b] = sweepCount;
+                rightArea[b] = sweepCount > 0 ? SurfaceArea(sweepMin, sweepMax) : 0.0f;
+            }
+
+            sweepMin = XMFLOAT3(FLT_MAX, FLT_MAX, FLT_MAX);
+            sweepMax = XMFLOAT3(-FLT_MAX, -FLT_MAX, -FLT_MAX);
+            sweepCount = 0;
+            for (int b = 0; b < SAH_BIN_COUNT - 1; ++b)
+            {
+                if (binCount[b] > 0)
+                {
+                    Grow(sweepMin, sweepMax, binMin[b], binMax[b]);
+                }
+                sweepCount += binCount[b];
+
+                if (sweepCount == 0 || rightCount[b + 1] == 0)
+                {
+                    continue;
+                }
+
+                float cost = sweepCount * SurfaceArea(sweepMin, sweepMax) + rightCount[b + 1] * rightArea[b + 1];
+                if (cost < bestCost)
+                {
+                    bestCost = cost;
+                    bestAxis = axis;
+                    bestSplit = b;
+                }
+            }
+        }
+
+        int mid = first;
+        if (bestAxis >= 0)
+        {
+            // Stop when splitting is not cheaper than intersecting everything
+            float leafCost = count * SurfaceArea(nodeMin, nodeMax);
+            if (bestCost >= leafCost && count <= m_maxLeafSize * 4)
+            {
+                continue;
+            }
+
+            float axisMin = Component(centroidMin, bestAxis);
+            float binScale = SAH_BIN_COUNT / (Component(centroidMax, bestAxis) - axisMin);
+            auto middle = std::partition(m_leafProxies.begin() + first, m_leafProxies.begin() + first + count,
+                [&](int proxyId)
+                {
+                    int b = std::min(SAH_BIN_COUNT - 1, static_cast<int>((Component(centroids[proxyId], bestAxis) - axisMin) * binScale));
+                    return b <= bestSplit;
+                });
+            mid = static_cast<int>(middle - m_leafProxies.begin());
+        }
+
+        if (mid == first || mid == first + count)
+        {
+            // Coincident centroids: split the range in half
+            mid = first + count / 2;
+        }
+
+        int leftIndex = static_cast<int>(m_nodes.size());
+        Node left = {};
+        left.firstIndex = first;
+        left.count = mid - first;
+        left.parent = task.node;
+        Node right = {};
+        right.firstIndex = mid;
+        right.count = first + count - mid;
+        right.parent = task.node;
+        m_nodes.push_back(left);
+        m_nodes.push_back(right);
+
+        m_nodes[task.node].firstIndex = leftIndex;
+        m_nodes[task.node].count = 0;
+
+        stack.push_back({ leftIndex, task.depth + 1 });
+        stack.push_back({ leftIndex + 1, task.depth + 1 });
+    }
+
+    // Link proxies to their leaves for refitting
+    for (int nodeIndex = 0; nodeIndex < static_cast<int>(m_nodes.size()); ++nodeIndex)
+    {
+        const Node& node = m_nodes[nodeIndex];
+        if (node.count == 0)
+        {
+            continue;
+        }
+
+        m_stats.leafCount++;
+        for (int i = node.firstIndex; i < node.firstIndex + node.count; ++i)
+        {
+            m_proxies[m_leafProxies[i]].leaf = nodeIndex;
+        }
+    }
+
+    m_nodeDirty.assign(m_nodes.size(), 0);
+    m_stats.nodeCount = static_cast<int>(m_nodes.size());
+}
+
+void BoundingVolumeHierarchy::Refit()
+{
+    PROFILE_FUNCTION();
+
+    // Structural changes beyond the threshold are cheaper to rebuild than to carry
+    size_t structuralChanges = m_pendingProxies.size() + m_destroyedProxies.size();
+    if (m_nodes.empty() ? !m_pendingProxies.empty()
+                        : structuralChanges > std::max<size_t>(64, static_cast<size_t>(m_aliveCount * m_rebuildThreshold)))
+    {
+        Build();
+        return;
+    }
+
+    m_stats.refitNodes = 0;
+    if (m_dirtyLeaves.empty())
+    {
+        m_stats.pendingProxies = static_cast<int>(m_pendingProxies.size());
+        return;
+    }
+
+    // Mark ancestors once; children always have larger indices than their parent
+    std::vector<int> dirtyNodes;
+    dirtyNodes.reserve(m_dirtyLeaves.size() * 2);
+    for (int leaf : m_dirtyLeaves)
+    {
+        dirtyNodes.push_back(leaf);
+        int parent = m_nodes[leaf].parent;
+        while (parent >= 0 && !m_nodeDirty[parent])
+        {
+            m_nodeDirty[parent] = 1;
+            dirtyNodes.push_back(parent);
+            parent = m_nodes[parent].parent;
+        }
+    }
+
+    std::sort(dirtyNodes.begin(), dirtyNodes.end(), std::greater<int>());
+    for (int nodeIndex : dirtyNodes)
+    {
+        Node& node = m_nodes[nodeIndex];
+        if (node.count > 0)
+        {
+            RefitLeaf(node);
+        }
+        else
+        {
+            RecomputeInner(node);
+        }
+        m_nodeDirty[nodeIndex] = 0;
+    }
+
+    m_stats.refitNodes = static_cast<int>(dirtyNodes.size());
+    m_stats.pendingProxies = static_cast<int>(m_pendingProxies.size());
+    m_dirtyLeaves.clear();
+}
+
+void BoundingVolumeHierarchy::RefitLeaf(Node& node)
+{
+    node.min = XMFLOAT3(FLT_MAX, FLT_MAX, FLT_MAX);
+    node.max = XMFLOAT3(-FLT_MAX, -FLT_MAX, -FLT_MAX);
+    for (int i = node.firstIndex; i < node.firstIndex + node.count; ++i)
+    {
+        const Proxy& proxy = m_proxies[m_leafProxies[i]];
+        Grow(node.min, node.max, proxy.min, proxy.max);
+    }
+}
+
+void BoundingVolumeHierarchy::RecomputeInner(Node& node)
+{
+    const Node& left = m_nodes[node.firstIndex];
+    const Node& right = m_nodes[node.firstIndex + 1];
+    node.min = left.min;
+    node.max = left.max;
+    Grow(node.min, node.max, right.min, right.max);
+}
+
+void BoundingVolumeHierarchy::QueryFrustum(const Frustum& frustum, std::vector<int>& results) const
+{
+    PROFILE_FUNCTION();
+
+    m_stats.nodesVisited = 0;
+
+    if (!m_nodes.empty())
+    {
+        // Entries are node index * 2 plus a bit telling that the parent was fully inside
+        std::vector<int> stack;
+        stack.reserve(TRAVERSAL_STACK_RESERVE);
+        stack.push_back(0);
+
+        while (!stack.empty())
+        {
+            int entry = stack.back();
+            stack.pop_back();
+
+            const Node& node = m_nodes[entry >> 1];
+            m_stats.nodesVisited++;
+
+            FrustumResult result = (entry & 1) ? FrustumResult::Inside : ClassifyBox(frustum, node.min, node.max);
+            if (result == FrustumResult::Outside)
+            {
+                continue;
+            }
+
+            if (node.count > 0)
+            {
+                for (int i = node.firstIndex; i < node.firstIndex + node.count; ++i)
+                {
+                    int proxyId = m_leafProxies[i];
+                    const Proxy& proxy = m_proxies[proxyId];
+                    if (!proxy.alive)
+                        continue;
+
+                    if (result == FrustumResult::Inside ||
+                        ClassifyBox(frustum, proxy.min, proxy.max) != FrustumResult::Outside)
+                    {
+                        results.push_back(proxyId);
+                    }
+                }
+                continue;
+            }
+
+            // Subtrees of a fully contained node skip all further plane tests
+            int insideBit = (result == FrustumResult::Inside) ? 1 : 0;
+            stack.push_back((node.firstIndex << 1) | insideBit);
+            stack.push_back(((node.firstIndex + 1) << 1) | insideBit);
+        }
+    }
+
+    for (int proxyId : m_pendingProxies)
+    {
+        const Proxy& proxy = m_proxies[proxyId];
+        if (ClassifyBox(frustum, proxy.min, proxy.max) != FrustumResult::Outside)
+        {
+            results.push_back(proxyId);
+        }
+    }
+}
+
+void BoundingVolumeHierarchy::QueryOverlap(const XMFLOAT3& min, const XMFLOAT3& max, std::vector<int>& results) const
+{
+    PROFILE_FUNCTION();
+
+    m_stats.nodesVisited = 0;
+
+    if (!m_nodes.empty())
+    {
+        std::vector<int> stack;
+        stack.reserve(TRAVERSAL_STACK_RESERVE);
+        stack.push_back(0);
+
+        while (!stack.empty())
+        {
+            const Node& node = m_nodes[stack.back()];
+            stack.pop_back();
+            m_stats.nodesVisited++;
+
+            if (!Overlaps(node.min, node.max, min, max))
+            {
+                continue;
+            }
+
+            if (node.count > 0)
+            {
+                for (int i = node.firstIndex; i < node.firstIndex + node.count; ++i)
+                {
+                    const Proxy& proxy = m_proxies[m_leafProxies[i]];
+                    if (proxy.alive && Overlaps(proxy.min, proxy.max, min, max))
+                    {
+                        results.push_back(m_leafProxies[i]);
+                    }
+                }
+                continue;
+            }
+
+            stack.push_back(node.firstIndex);
+            stack.push_back(node.firstIndex + 1);
+        }
+    }
+
+    for (int proxyId : m_pendingProxies)
+    {
+        const Proxy& proxy = m_proxies[proxyId];
+        if (Overlaps(proxy.min, proxy.max, min, max))
+        {
+            results.push_back(proxyId);
+        }
+    }
+}
+
+bool BoundingVolumeHierarchy::RayCast(const XMFLOAT3& origin, const XMFLOAT3& direction, float maxDistance, BVHRayHit& hit) const
+{
+    PROFILE_FUNCTION();
+
+    m_stats.nodesVisited = 0;
+    hit = BVHRayHit();
+
+    // Division by zero yields infinities, which the slab test handles
+    XMFLOAT3 inverseDirection(1.0f / direction.x, 1.0f / direction.y, 1.0f / direction.z);
+    float closest = maxDistance;
+
+    auto testProxy = [&](int proxyId)
+    {
+        const Proxy& proxy = m_proxies[proxyId];
+        if (!proxy.alive)
+            return;
+
+        float t = RayBoxEntry(origin, inverseDirection, proxy.min, proxy.max, closest);
+        if (t != FLT_MAX && (hit.proxyId < 0 || t < closest))
+        {
+            closest = t;
+            hit.proxyId = proxyId;
+            hit.distance = t;
+            hit.userData = proxy.userData;
+        }
+    };
+
+    if (!m_nodes.empty() && RayBoxEntry(origin, inverseDirection, m_nodes[0].min, m_nodes[0].max, closest) != FLT_MAX)
+    {
+        std::vector<int> stack;
+        stack.reserve(TRAVERSAL_STACK_RESERVE);
+        stack.push_back(0);
+
+        while (!stack.empty())
+        {
+            const Node& node = m_nodes[stack.back()];
+            stack.pop_back();
+            m_stats.nodesVisited++;
+
+            if (node.count > 0)
+            {
+                for (int i = node.firstIndex; i < node.firstIndex + node.count; ++i)
+                {
+                    testProxy(m_leafProxies[i]);
+                }
+                continue;
+            }
+
+            // Visit the nearer child first so the far one is usually pruned
+            int nearIndex = node.firstIndex;
+            int farIndex = node.firstIndex + 1;
+            float nearEntry = RayBoxEntry(origin, inverseDirection, m_nodes[nearIndex].min, m_nodes[nearIndex].max, closest);
+            float farEntry = RayBoxEntry(origin, inverseDirection, m_nodes[farIndex].min, m_nodes[farIndex].max, closest);
+
+            if (nearEntry > farEntry)
+            {
+                std::swap(nearEntry, farEntry);
+                std::swap(nearIndex, farIndex);
+            }
+
+            if (farEntry != FLT_MAX)
+            {
+                stack.push_back(farIndex);
+            }
+            if (nearEntry != FLT_MAX)
+            {
+                stack.push_back(nearIndex);
+            }
+        }
+    }
+
+    for (int proxyId : m_pendingProxies)
+    {
+        testProxy(proxyId);
+    }
+
+    return hit.proxyId >= 0;
+}
+
+float BoundingVolumeHierarchy::ComputeSAHCost() const
+{
+    if (m_nodes.empty())
+    {
+        return 0.0f;
+    }
+
+    // Expected cost of a random ray: inner nodes cost 1, leaves cost their proxy count
+    float rootArea = std::max(SurfaceArea(m_nodes[0].min, m_nodes[0].max), FLT_MIN);
+    float cost = 0.0f;
+    for (const Node& node : m_nodes)
+    {
+        float relativeArea = SurfaceArea(node.min, node.max) / rootArea;
+        cost += relativeArea * (node.count > 0 ? static_cast<float>(node.count) : 1.0f);
+    }
+    return cost;
+}
@@ -0,0 +1,124 @@
+#pragma once
+
+#include <DirectXMath.h>
+#include <vector>
+#include <cstdint>
+#include <cfloat>
+
+using namespace DirectX;
+
+struct Frustum;
+
+// Nearest ray hit returned by BoundingVolumeHierarchy::RayCast
+struct BVHRayHit
+{
+    int proxyId;
+    float distance;
+    void* userData;
+
+    BVHRayHit()
+        : proxyId(-1)
+        , distance(FLT_MAX)
+        , userData(nullptr)
+    {
+    }
+};
+
+// Build and query counters for the last operations
+struct BVHStats
+{
+    int nodeCount;
+    int leafCount;
+    int maxDepth;
+    int pendingProxies;
+    int refitNodes;
+    int nodesVisited;    // Last query
+
+    BVHStats()
+        : nodeCount(0)
+        , leafCount(0)
+        , maxDepth(0)
+        , pendingProxies(0)
+        , refitNodes(0)
+        , nodesVisited(0)
+    {
+    }
+};
+
+// Dynamic bounding volume hierarchy over world-space boxes (for example
+// Model::GetWorldBoundingBox() with the Model* as user data).
+//
+// Build() creates the tree with a binned surface area heuristic. Moving
+// objects call UpdateProxy() and the next Refit() only refits the touched
+// leaves and their ancestors. Proxies inserted after the last build are kept
+// in a pending list that queries test linearly until Refit() decides the list
+// is large enough to warrant a rebuild.
+class BoundingVolumeHierarchy
+{
+public:
+    BoundingVolumeHierarchy();
+    ~BoundingVolumeHierarchy();
+
+    // Proxy management
+    int CreateProxy(const XMFLOAT3& min, const XMFLOAT3& max, void* userData);
+    void DestroyProxy(int proxyId);
+    void UpdateProxy(int proxyId, const XMFLOAT3& min, const XMFLOAT3& max);
+    void Clear();
+
+    // Tree maintenance
+    void Build();
+    void Refit();
+
+    // Queries. Results are proxy ids.
+    void QueryFrustum(const Frustum& frustum, std::vector<int>& results) const;
+    void QueryOverlap(const XMFLOAT3& min, const XMFLOAT3& max, std::vector<int>& results) const;
+    bool RayCast(const XMFLOAT3& origin, const XMFLOAT3& direction, float maxDistance, BVHRayHit& hit) const;
+
+    // Configuration
+    void SetMaxLeafSize(int maxLeafSize) { m_maxLeafSize = maxLeafSize > 0 ? maxLeafSize : 1; }
+    void SetRebuildThreshold(float fraction) { m_rebuildThreshold = fraction; }
+
+    // Information
+    void* GetUserData(int proxyId) const { return m_proxies[proxyId].userData; }
+    int GetProxyCount() const { return m_aliveCount; }
+    const BVHStats& GetStats() const { return m_stats; }
+    float ComputeSAHCost() const;
+
+private:
+    struct Node
+    {
+        XMFLOAT3 min;
+        int firstIndex;      // Leaf: first entry in m_leafProxies; inner: left child (right = left + 1)
+        XMFLOAT3 max;
+        int count;           // Leaf: number of proxies; inner: 0
+        int parent;
+    };
+
+    struct Proxy
+    {
+        XMFLOAT3 min;
+        XMFLOAT3 max;
+        void* userData;
+        int leaf;            // -1 while pending or destroyed
+        bool alive;
+    };
+
+    void RefitLeaf(Node& node);
+    void RecomputeInner(Node& node);
+    int AllocateProxy();
+
+private:
+    std::vector<Node> m_nodes;
+    std::vector<Proxy> m_proxies;
+    std::vector<int> m_leafProxies;
+    std::vector<int> m_pendingProxies;
+    std::vector<int> m_freeProxies;
+    std::vector<int> m_destroyedProxies;   // Still referenced by leaves until the next build
+    std::vector<int> m_dirtyLeaves;
+    std::vector<uint8_t> m_nodeDirty;
+
+    int m_aliveCount;
+    int m_maxLeafSize;
+    float m_rebuildThreshold;
+    mutable BVHStats m_stats;
+};
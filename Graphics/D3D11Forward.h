@@ -0,0 +1,13 @@
+#pragma once
+
+// Opaque Direct3D 11 handles. Headers that only store or pass these
+// pointers include this instead of <d3d11.h>, so they (and the CPU code
+// built on them) compile without the Windows SDK. Translation units that
+// call into Direct3D include <d3d11.h> themselves.
+struct ID3D11Device;
+struct ID3D11DeviceContext;
+struct ID3D11Buffer;
+struct ID3D11Texture2D;
+struct ID3D11ShaderResourceView;
+struct ID3D11RenderTargetView;
+struct ID3D11DepthStencilView;
@@ -0,0 +1,85 @@
+#include "DrawBatching.h"
+#include "../Engine/Profiler.h"
+#include "../Engine/Memory.h"
+#include <algorithm>
+
+void DrawBatcher::Build(const std::vector<DrawItem>& items, std::vector<DrawBatch>& batches,
+                        std::vector<InstanceData>& instanceData, FrameAllocator* frameAllocator)
+{
+    PROFILE_FUNCTION();
+
+    batches.clear();
+    m_batchLookup.clear();
+    m_itemBatch.resize(items.size());
+
+    // Pass 1: assign every item to a batch and count instances per batch
+    for (size_t i = 0; i < items.size(); ++i)
+    {
+        const DrawItem& item = items[i];
+        BatchKey key = { item.mesh, item.material };
+
+        auto it = m_batchLookup.find(key);
+        if (it == m_batchLookup.end())
+        {
+            uint32_t batchIndex = static_cast<uint32_t>(batches.size());
+            m_batchLookup.emplace(key, batchIndex);
+            batches.push_back({ item.mesh, item.material, 0, 0 });
+            m_itemBatch[i] = batchIndex;
+        }
+        else
+        {
+            m_itemBatch[i] = it->second;
+        }
+
+        batches[m_itemBatch[i]].instanceCount++;
+    }
+
+    // Temporaries come from the frame allocator when there is one
+    ArenaAllocator<uint32_t> scratch(frameAllocator ? &frameAllocator->GetArena() : nullptr);
+
+    // Order batches by material first so state changes are minimized
+    ArenaVector<uint32_t> order(batches.size(), 0, scratch);
+    for (uint32_t i = 0; i < order.size(); ++i)
+    {
+        order[i] = i;
+    }
+
+    std::stable_sort(order.begin(), order.end(), [&batches](uint32_t a, uint32_t b)
+    {
+        return std::less<Material*>()(batches[a].material, batches[b].material);
+    });
+
+    // Prefix sum over the sorted order gives each batch its instance range
+    uint32_t firstInstance = 0;
+    for (uint32_t batchIndex : order)
+    {
+        batches[batchIndex].firstInstance = firstInstance;
+        firstInstance += batches[batchIndex].instanceCount;
+    }
+
+    // Pass 2: scatter world matrices into their batch ranges
+    ArenaVector<uint32_t> cursor(batches.size(), 0, scratch);
+    for (size_t i = 0; i < batches.size(); ++i)
+    {
+        cursor[i] = batches[i].firstInstance;
+    }
+
+    instanceData.resize(items.size());
+    for (size_t i = 0; i < items.size(); ++i)
+    {
+        instanceData[cursor[m_itemBatch[i]]++].world = items[i].world;
+    }
+
+    // Store batches in execution order
+    ArenaVector<DrawBatch> unsortedBatches(batches.begin(), batches.end(), ArenaAllocator<DrawBatch>(scratch));
+    for (size_t i = 0; i < order.size(); ++i)
+    {
+        batches[i] = unsortedBatches[order[i]];
+    }
+}
+
+void DrawBatcher::Clear()
+{
+    m_itemBatch.clear();
+    m_batchLookup.clear();
+}
@@ -0,0 +1,79 @@
+#pragma once
+
+#include <DirectXMath.h>
+#include <vector>
+#include <unordered_map>
+#include <functional>
+#include <cstdint>
+
+using namespace DirectX;
+
+// Forward declarations
+class Mesh;
+class Material;
+class FrameAllocator;
+
+// Per-instance data streamed to INSTANCED_VERTEX_SHADER through slot 1
+struct InstanceData
+{
+    XMFLOAT4X4 world;
+};
+
+// A single draw as submitted by the scene
+struct DrawItem
+{
+    Mesh* mesh;
+    Material* material;
+    XMFLOAT4X4 world;
+};
+
+// Contiguous range of instances sharing mesh and material
+struct DrawBatch
+{
+    Mesh* mesh;
+    Material* material;
+    uint32_t firstInstance;
+    uint32_t instanceCount;
+};
+
+// Merges draws sharing a mesh and material into batches, ordered by material
+// so state changes are minimized, and scatters their world matrices into one
+// contiguous instance range per batch. CPU only: RenderQueue uploads the
+// result and issues one instanced draw per batch. The lookup tables keep
+// their capacity between frames.
+class DrawBatcher
+{
+public:
+    // Replaces batches and instanceData. Temporaries come from frameAllocator
+    // when there is one, the heap otherwise.
+    void Build(const std::vector<DrawItem>& items, std::vector<DrawBatch>& batches,
+               std::vector<InstanceData>& instanceData, FrameAllocator* frameAllocator = nullptr);
+
+    void Reserve(size_t itemCount) { m_itemBatch.reserve(itemCount); }
+    void Clear();
+
+private:
+    struct BatchKey
+    {
+        Mesh* mesh;
+        Material* material;
+
+        bool operator==(const BatchKey& other) const
+        {
+            return mesh == other.mesh && material == other.material;
+        }
+    };
+
+    struct BatchKeyHash
+    {
+        size_t operator()(const BatchKey& key) const
+        {
+            size_t hash = std::hash<const void*>{}(key.mesh);
+            hash ^= std::hash<const void*>{}(key.material) + 0x9e3779b9 + (hash << 6) + (hash >> 2);
+            return hash;
+        }
+    };
+
+    std::vector<uint32_t> m_itemBatch;
+    std::unordered_map<BatchKey, uint32_t, BatchKeyHash> m_batchLookup;
+};
@@ -0,0 +1,279 @@
+#include "FrustumCulling.h"
+#include "../Engine/Profiler.h"
+#include <cmath>
+
+Frustum Frustum::FromViewProjection(const XMMATRIX& viewProjection)
+{
+    // Gribb/Hartmann: planes are sums/differences of the matrix columns
+    XMFLOAT4X4 m;
+    XMStoreFloat4x4(&m, viewProjection);
+
+    Frustum frustum;
+    frustum.planes[Left]   = XMFLOAT4(m._14 + m._11, m._24 + m._21, m._34 + m._31, m._44 + m._41);
+    frustum.planes[Right]  = XMFLOAT4(m._14 - m._11, m._24 - m._21, m._34 - m._31, m._44 - m._41);
+    frustum.planes[Bottom] = XMFLOAT4(m._14 + m._12, m._24 + m._22, m._34 + m._32, m._44 + m._42);
+    frustum.planes[Top]    = XMFLOAT4(m._14 - m._12, m._24 - m._22, m._34 - m._32, m._44 - m._42);
+    frustum.planes[Near]   = XMFLOAT4(m._13, m._23, m._33, m._43);
+    frustum.planes[Far]    = XMFLOAT4(m._14 - m._13, m._24 - m._23, m._34 - m._33, m._44 - m._43);
+
+    for (int i = 0; i < PlaneCount; ++i)
+    {
+        XMVECTOR plane = XMPlaneNormalize(XMLoadFloat4(&frustum.planes[i]));
+        XMStoreFloat4(&frustum.planes[i], plane);
+    }
+
+    return frustum;
+}
+
+bool Frustum::IntersectsBox(const XMFLOAT3& center, const XMFLOAT3& extents) const
+{
+    for (int i = 0; i < PlaneCount; ++i)
+    {
+        const XMFLOAT4& p = planes[i];
+        float distance = p.x * center.x + p.y * center.y + p.z * center.z + p.w;
+        float radius = std::fabs(p.x) * extents.x + std::fabs(p.y) * extents.y + std::fabs(p.z) * extents.z;
+        if (distance + radius < 0.0f)
+        {
+            return false;
+        }
+    }
+    return true;
+}
+
+bool Frustum::IntersectsSphere(const XMFLOAT3& center, float radius) const
+{
+    for (int i = 0; i < PlaneCount; ++i)
+    {
+        const XMFLOAT4& p = planes[i];
+        float distance = p.x * center.x + p.y * center.y + p.z * center.z + p.w;
+        if (distance < -radius)
+        {
+            return false;
+        }
+    }
+    return true;
+}
+
+void CullingBoxes::Clear()
+{
+    centerX.clear();
+    centerY.clear();
+    centerZ.clear();
+    extentX.clear();
+    extentY.clear();
+    extentZ.clear();
+}
+
+void CullingBoxes::Reserve(size_t count)
+{
+    centerX.reserve(count);
+    centerY.reserve(count);
+    centerZ.reserve(count);
+    extentX.reserve(count);
+    extentY.reserve(count);
+    extentZ.reserve(count);
+}
+
+void CullingBoxes::Add(const XMFLOAT3& center, const XMFLOAT3& extents)
+{
+    centerX.push_back(center.x);
+    centerY.push_back(center.y);
+    centerZ.push_back(center.z);
+    extentX.push_back(extents.x);
+    extentY.push_back(extents.y);
+    extentZ.push_back(extents.z);
+}
+
+void CullingBoxes::AddMinMax(const XMFLOAT3& min, const XMFLOAT3& max)
+{
+    Add(XMFLOAT3((min.x + max.x) * 0.5f, (min.y + max.y) * 0.5f, (min.z + max.z) * 0.5f),
+        XMFLOAT3((max.x - min.x) * 0.5f, (max.y - min.y) * 0.5f, (max.z - min.z) * 0.5f));
+}
+
+void CullingSpheres::Clear()
+{
+    centerX.clear();
+    centerY.clear();
+    centerZ.clear();
+    radius.clear();
+}
+
+void CullingSpheres::Reserve(size_t count)
+{
+    centerX.reserve(count);
+    centerY.reserve(count);
+    centerZ.reserve(count);
+    radius.reserve(count);
+}
+
+void CullingSpheres::Add(const XMFLOAT3& center, float sphereRadius)
+{
+    centerX.push_back(center.x);
+    centerY.push_back(center.y);
+    centerZ.push_back(center.z);
+    radius.push_back(sphereRadius);
+}
+
+namespace FrustumCulling
+{
+    namespace
+    {
+        inline XMVECTOR LoadFour(const std::vector<float>& values, size_t index)
+        {
+            return XMLoadFloat4(reinterpret_cast<const XMFLOAT4*>(&values[index]));
+        }
+
+        inline void AppendVisible(XMVECTOR outsideMask, size_t baseIndex, std::vector<uint32_t>& visible)
+        {
+            uint32_t lanes[4];
+            XMStoreInt4(lanes, outsideMask);
+            for (uint32_t lane = 0; lane < 4; ++lane)
+            {
+                if (lanes[lane] == 0)
+                {
+                    visible.push_back(static_cast<uint32_t>(baseIndex + lane));
+                }
+            }
+        }
+    }
+
+    size_t CullBoxes(const Frustum& frustum, const CullingBoxes& boxes, std::vector<uint32_t>& visible)
+    {
+        PROFILE_FUNCTION();
+
+        size_t count = boxes.Size();
+        size_t startSize = visible.size();
+        size_t batchEnd = count & ~static_cast<size_t>(3);
+
+        // Splat each plane once per call rather than once per batch
+        XMVECTOR planeX[Frustum::PlaneCount];
+        XMVECTOR planeY[Frustum::PlaneCount];
+        XMVECTOR planeZ[Frustum::PlaneCount];
+        XMVECTOR planeW[Frustum::PlaneCount];
+        XMVECTOR absX[Frustum::PlaneCount];
+        XMVECTOR absY[Frustum::PlaneCount];
+        XMVECTOR absZ[Frustum::PlaneCount];
+        for (int p = 0; p < Frustum::PlaneCount; ++p)
+        {
+            XMVECTOR plane = XMLoadFloat4(&frustum.planes[p]);
+            planeX[p] = XMVectorSplatX(plane);
+            planeY[p] = XMVectorSplatY(plane);
+            planeZ[p] = XMVectorSplatZ(plane);
+            planeW[p] = XMVectorSplatW(plane);
+            absX[p] = XMVectorAbs(planeX[p]);
+            absY[p] = XMVectorAbs(planeY[p]);
+            absZ[p] = XMVectorAbs(planeZ[p]);
+        }
+
+        XMVECTOR zero = XMVectorZero();
+
+        // Four boxes per iteration: a box is outside if center distance plus
+        // projected extent radius is negative for any plane
+        for (size_t i = 0; i < batchEnd; i += 4)
+        {
+            XMVECTOR cx = LoadFour(boxes.centerX, i);
+            XMVECTOR cy = LoadFour(boxes.centerY, i);
+            XMVECTOR cz = LoadFour(boxes.centerZ, i);
+            XMVECTOR ex = LoadFour(boxes.extentX, i);
+            XMVECTOR ey = LoadFour(boxes.extentY, i);
+            XMVECTOR ez = LoadFour(boxes.extentZ, i);
+
+            XMVECTOR outside = XMVectorFalseInt();
+            for (int p = 0; p < Frustum::PlaneCount; ++p)
+            {
+                XMVECTOR distance = XMVectorMultiplyAdd(planeX[p], cx, planeW[p]);
+                distance = XMVectorMultiplyAdd(planeY[p], cy, distance);
+                distance = XMVectorMultiplyAdd(planeZ[p], cz, distance);
+
+                XMVECTOR radius = XMVectorMultiply(absX[p], ex);
+                radius = XMVectorMultiplyAdd(absY[p], ey, radius);
+                radius = XMVectorMultiplyAdd(absZ[p], ez, radius);
+
+                outside = XMVectorOrInt(outside, XMVectorLess(XMVectorAdd(distance, radius), zero));
+            }
+
+            AppendVisible(outside, i, visible);
+        }
+
+        // Remaining boxes
+        for (size_t i = batchEnd; i < count; ++i)
+        {
+            XMFLOAT3 center(boxes.centerX[i], boxes.centerY[i], boxes.centerZ[i]);
+            XMFLOAT3 extents(boxes.extentX[i], boxes.extentY[i], boxes.extentZ[i]);
+            if (frustum.IntersectsBox(center, extents))
+            {
+                visible.push_back(static_cast<uint32_t>(i));
+            }
+        }
+
+        return visible.size() - startSize;
+    }
+
+    size_t CullSpheres(const Frustum& frustum, const CullingSpheres& spheres, std::vector<uint32_t>& visible)
+    {
+        PROFILE_FUNCTION();
+
+        size_t count = spheres.Size();
+        size_t startSize = visible.size();
+        size_t batchEnd = count & ~static_cast<size_t>(3);
+
+        XMVECTOR planeX[Frustum::PlaneCount];
+        XMVECTOR planeY[Frustum::PlaneCount];
+        XMVECTOR planeZ[Frustum::PlaneCount];
+        XMVECTOR planeW[Frustum::PlaneCount];
+        for (int p = 0; p < Frustum::PlaneCount; ++p)
+        {
+            XMVECTOR plane = XMLoadFloat4(&frustum.planes[p]);
+            planeX[p] = XMVectorSplatX(plane);
+            planeY[p] = XMVectorSplatY(plane);
+            planeZ[p] = XMVectorSplatZ(plane);
+            planeW[p] = XMVectorSplatW(plane);
+        }
+
+        for (size_t i = 0; i < batchEnd; i += 4)
+        {
+            XMVECTOR cx = LoadFour(spheres.centerX, i);
+            XMVECTOR cy = LoadFour(spheres.centerY, i);
+            XMVECTOR cz = LoadFour(spheres.centerZ, i);
+            XMVECTOR negRadius = XMVectorNegate(LoadFour(spheres.radius, i));
+
+            XMVECTOR outside = XMVectorFalseInt();
+            for (int p = 0; p < Frustum::PlaneCount; ++p)
+            {
+                XMVECTOR distance = XMVectorMultiplyAdd(planeX[p], cx, planeW[p]);
+                distance = XMVectorMultiplyAdd(planeY[p], cy, distance);
+                distance = XMVectorMultiplyAdd(planeZ[p], cz, distance);
+
+                outside = XMVectorOrInt(outside, XMVectorLess(distance, negRadius));
+            }
+
+            AppendVisible(outside, i, visible);
+        }
+
+        for (size_t i = batchEnd; i < count; ++i)
+        {
+            XMFLOAT3 center(spheres.centerX[i], spheres.centerY[i], spheres.centerZ[i]);
+            if (frustum.IntersectsSphere(center, spheres.radius[i]))
+            {
+                visible.push_back(static_cast<uint32_t>(i));
+            }
+        }
+
+        return visible.size() - startSize;
+    }
+
+    void TransformBox(const XMFLOAT3& center, const XMFLOAT3& extents, const XMMATRIX& transform,
+                      XMFLOAT3& outCenter, XMFLOAT3& outExtents)
+    {
+        // Arvo: new extents are the extents projected through |M|
+        XMVECTOR c = XMVector3TransformCoord(XMLoadFloat3(&center), transform);
+        XMVECTOR e = XMLoadFloat3(&extents);
+
+        XMVECTOR worldExtents = XMVectorMultiply(XMVectorSplatX(e), XMVectorAbs(transform.r[0]));
+        worldExtents = XMVectorMultiplyAdd(XMVectorSplatY(e), XMVectorAbs(transform.r[1]), worldExtents);
+        worldExtents = XMVectorMultiplyAdd(XMVectorSplatZ(e), XMVectorAbs(transform.r[2]), worldExtents);
+
+        XMStoreFloat3(&outCenter, c);
+        XMStoreFloat3(&outExtents, worldExtents);
+    }
+}
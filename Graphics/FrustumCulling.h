@@ -0,0 +1,76 @@
+#pragma once
+
+#include <DirectXMath.h>
+#include <vector>
+#include <cstdint>
+#include <cstddef>
+
+using namespace DirectX;
+
+// View frustum as six inward-facing planes (ax + by + cz + d >= 0 is inside)
+struct Frustum
+{
+    enum PlaneIndex
+    {
+        Left = 0,
+        Right,
+        Bottom,
+        Top,
+        Near,
+        Far,
+        PlaneCount
+    };
+
+    XMFLOAT4 planes[PlaneCount];
+
+    // Extracts planes from a row-vector view * projection matrix with D3D clip depth [0, w]
+    static Frustum FromViewProjection(const XMMATRIX& viewProjection);
+
+    bool IntersectsBox(const XMFLOAT3& center, const XMFLOAT3& extents) const;
+    bool IntersectsSphere(const XMFLOAT3& center, float radius) const;
+};
+
+// Structure-of-arrays box storage so the culler can test four boxes per instruction
+struct CullingBoxes
+{
+    std::vector<float> centerX;
+    std::vector<float> centerY;
+    std::vector<float> centerZ;
+    std::vector<float> extentX;
+    std::vector<float> extentY;
+    std::vector<float> extentZ;
+
+    void Clear();
+    void Reserve(size_t count);
+    size_t Size() const { return centerX.size(); }
+
+    void Add(const XMFLOAT3& center, const XMFLOAT3& extents);
+    void AddMinMax(const XMFLOAT3& min, const XMFLOAT3& max);
+};
+
+// Structure-of-arrays sphere storage
+struct CullingSpheres
+{
+    std::vector<float> centerX;
+    std::vector<float> centerY;
+    std::vector<float> centerZ;
+    std::vector<float> radius;
+
+    void Clear();
+    void Reserve(size_t count);
+    size_t Size() const { return centerX.size(); }
+
+    void Add(const XMFLOAT3& center, float sphereRadius);
+};
+
+// Batch frustum tests. Visible indices are appended to the output list in
+// ascending order; the return value is the number of visible entries.
+namespace FrustumCulling
+{
+    size_t CullBoxes(const Frustum& frustum, const CullingBoxes& boxes, std::vector<uint32_t>& visible);
+    size_t CullSpheres(const Frustum& frustum, const CullingSpheres& spheres, std::vector<uint32_t>& visible);
+
+    // Conservative world-space box of a transformed local box (center/extents form)
+    void TransformBox(const XMFLOAT3& center, const XMFLOAT3& extents, const XMMATRIX& transform,
+                      XMFLOAT3& outCenter, XMFLOAT3& outExtents);
+}
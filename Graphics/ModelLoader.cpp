@@ -4,12 +4,57 @@
 #include "../Resources/Mesh.h"
 #include "../Resources/Material.h"
 #include "../Resources/Texture.h"
+#include "../Resources/MeshProcessing.h"
+#include "../Engine/Profiler.h"
 #include <iostream>
 #include <fstream>
-#include <sstream>
-#include <algorithm>
-#include <cctype>
-#include <cstring>
+#include <chrono>
+
+ModelLoadRequest::ModelLoadRequest(const std::string& filepath)
+    : m_filepath(filepath)
+    , m_state(ModelLoadState::Queued)
+    , m_progress(0.0f)
+    , m_cancelRequested(false)
+    , m_scratch(MemorySubsystem::Loading, 256 * 1024)
+    , m_meshResidency(MeshResidency::KeepCpu)
+    , m_nextMesh(0)
+    , m_nextMaterial(0)
+    , m_jobSystem(nullptr)
+{
+}
+
+bool ModelLoadRequest::IsDone() const
+{
+    ModelLoadState state = GetState();
+    return state == ModelLoadState::Completed || state == ModelLoadState::Failed || state == ModelLoadState::Cancelled;
+}
+
+std::shared_ptr<Model> ModelLoadRequest::GetModel() const
+{
+    return GetState() == ModelLoadState::Completed ? m_model : nullptr;
+}
+
+const std::string& ModelLoadRequest::GetError() const
+{
+    static const std::string noError;
+    return GetState() == ModelLoadState::Failed ? m_error : noError;
+}
+
+void ModelLoadRequest::SetStage(ModelLoadState state, float progress)
+{
+    m_progress.store(progress, std::memory_order_relaxed);
+    m_state.store(state, std::memory_order_release);
+}
+
+void ModelLoadRequest::Fail(const std::string& error)
+{
+    std::cerr << "ModelLoader: " << error << ": " << m_filepath << std::endl;
+    m_error = error;
+    m_scene = XFileScene();
+    m_scratch.Release();
+    m_model.reset();
+    SetStage(ModelLoadState::Failed, GetProgress());
+}
 
 ModelLoader::ModelLoader()
     : m_generateNormals(true)
@@ -18,43 +63,35 @@ ModelLoader::ModelLoader()
     , m_generateTangents(false)
     , m_flipWindingOrder(false)
     , m_scaleFactor(1.0f)
+    , m_meshResidency(MeshResidency::KeepCpu)
+    , m_loadArena(MemorySubsystem::Loading, 1024 * 1024)
 {
 }
 
 ModelLoader::~ModelLoader()
 {
+    CancelAsyncLoads();
 }
 
 std::shared_ptr<Model> ModelLoader::LoadFromFile(ID3D11Device* device, const std::string& filepath)
 {
+    PROFILE_FUNCTION();
+
     if (!device || filepath.empty())
     {
         std::cerr << "ModelLoader: Invalid parameters" << std::endl;
         return nullptr;
     }
 
-    // Read file content
-    std::ifstream file(filepath, std::ios::binary);
-    if (!file.is_open())
+    // Read the entire file straight into the parse context
+    XFileContext context;
+    if (!ReadFileContent(filepath, context.content))
     {
         std::cerr << "ModelLoader: Failed to open file: " << filepath << std::endl;
         return nullptr;
     }
 
-    // Read entire file
-    file.seekg(0, std::ios::end);
-    size_t fileSize = file.tellg();
-    file.seekg(0, std::ios::beg);
-
-    std::vector<char> buffer(fileSize);
-    file.read(buffer.data(), fileSize);
-    file.close();
-
-    std::string content(buffer.begin(), buffer.end());
-
     // Parse .X file
-    XFileContext context;
-    context.content = content;
     context.position = 0;
     context.isBinary = false;
     context.isCompressed = false;
@@ -69,10 +106,8 @@ std::shared_ptr<Model> ModelLoader::LoadFromMemory(ID3D11Device* device, const v
         return nullptr;
     }
 
-    std::string content(static_cast<const char*>(data), size);
-
     XFileContext context;
-    context.content = content;
+    context.content.assign(static_cast<const char*>(data), size);
     context.position = 0;
     context.isBinary = false;
     context.isCompressed = false;
@@ -80,1128 +115,489 @@ std::shared_ptr<Model> ModelLoader::LoadFromMemory(ID3D11Device* device, const v
     return ParseXFile(device, context, "memory");
 }
 
-void ModelLoader::SetGenerateNormals(bool generate)
+ModelLoadHandle ModelLoader::LoadAsync(const std::string& filepath, JobSystem& jobSystem)
 {
-    m_generateNormals = generate;
-}
+    PROFILE_FUNCTION();
 
-void ModelLoader::SetOptimizeMeshes(bool optimize)
-{
-    m_optimizeMeshes = optimize;
-}
+    auto request = std::make_shared<ModelLoadRequest>(filepath);
+    if (filepath.empty() || !jobSystem.IsInitialized())
+    {
+        request->Fail("Invalid parameters");
+        return request;
+    }
 
-void ModelLoader::SetLoadAnimations(bool load)
-{
-    m_loadAnimations = load;
-}
+    request->m_meshResidency = m_meshResidency;
+    request->m_startTime = std::chrono::steady_clock::now();
+    request->m_jobSystem = &jobSystem;
 
-void ModelLoader::SetGenerateTangents(bool generate)
-{
-    m_generateTangents = generate;
-}
+    // Model cannot hold the animations built from parsed sets yet, so the
+    // async path does not parse them only to drop them
+    ProcessingOptions options = GetProcessingOptions();
+    options.loadAnimations = false;
 
-void ModelLoader::SetFlipWindingOrder(bool flip)
-{
-    m_flipWindingOrder = flip;
-}
+    // The job holds its own reference, so the caller may drop the handle
+    jobSystem.Run([request, options]()
+    {
+        RunAsyncWorkerStages(*request, options);
+    }, &request->m_workerJob);
 
-void ModelLoader::SetScaleFactor(float scale)
-{
-    m_scaleFactor = scale;
+    m_asyncLoads.push_back(request);
+    return request;
 }
 
-std::shared_ptr<Model> ModelLoader::ParseXFile(ID3D11Device* device, XFileContext& context, const std::string& basePath)
+size_t ModelLoader::UpdateAsyncLoads(ID3D11Device* device, float timeBudgetMs)
 {
-    // Parse header
-    if (!ParseXFileHeader(context))
-    {
-        std::cerr << "ModelLoader: Invalid .X file header" << std::endl;
-        return nullptr;
-    }
-
-    auto model = std::make_shared<Model>();
-    if (!model->Initialize(device))
-    {
-        std::cerr << "ModelLoader: Failed to initialize model" << std::endl;
-        return nullptr;
-    }
+    PROFILE_FUNCTION();
 
-    // Skip templates section (we use hardcoded knowledge of templates)
-    SkipTemplates(context);
+    auto startTime = std::chrono::steady_clock::now();
+    bool outOfTime = false;
 
-    // Parse main data
-    while (context.position < context.content.length())
+    for (size_t i = 0; i < m_asyncLoads.size() && !outOfTime;)
     {
-        SkipWhitespace(context);
-        if (context.position >= context.content.length())
-            break;
+        ModelLoadRequest& request = *m_asyncLoads[i];
+        ModelLoadState state = request.GetState();
 
-        std::string token = ReadToken(context);
-        if (token.empty())
-            break;
-
-        if (token == "Mesh")
+        if (state == ModelLoadState::WaitingForUpload || state == ModelLoadState::Uploading)
         {
-            auto mesh = ParseMesh(device, context, basePath);
-            if (mesh)
+            if (request.IsCancelRequested() || !device)
             {
-                model->AddMesh(mesh);
+                // Objects already created go away with the partial model
+                request.m_model.reset();
+                request.m_scene = XFileScene();
+                request.m_scratch.Release();
+                request.SetStage(ModelLoadState::Cancelled, request.GetProgress());
             }
-        }
-        else if (token == "Frame")
-        {
-            ParseFrame(device, context, model, basePath);
-        }
-        else if (token == "Material")
-        {
-            auto material = ParseMaterial(device, context, basePath);
-            if (material)
+            else
             {
-                model->AddMaterial(material);
+                if (state == ModelLoadState::WaitingForUpload)
+                {
+                    request.m_model = std::make_shared<Model>();
+                    request.SetStage(ModelLoadState::Uploading, request.GetProgress());
+                }
+
+                while (!outOfTime)
+                {
+                    if (!UploadNextObject(device, request))
+                    {
+                        FinishAsyncLoad(request);
+                        break;
+                    }
+
+                    float elapsedMs = std::chrono::duration<float, std::milli>(std::chrono::steady_clock::now() - startTime).count();
+                    outOfTime = elapsedMs >= timeBudgetMs;
+                }
             }
         }
-        else if (token == "AnimationSet" && m_loadAnimations)
+
+        // The worker job may still hold a reference; it only touches the request
+        if (request.IsDone())
         {
-            ParseAnimationSet(context, model);
+            m_asyncLoads.erase(m_asyncLoads.begin() + i);
         }
         else
         {
-            // Skip unknown objects
-            SkipObject(context);
+            ++i;
         }
     }
 
-    // Post-processing
-    if (m_generateNormals)
-    {
-        GenerateNormals(model);
-    }
+    return m_asyncLoads.size();
+}
 
-    if (m_generateTangents)
+void ModelLoader::CancelAsyncLoads()
+{
+    for (const auto& request : m_asyncLoads)
     {
-        GenerateTangents(model);
+        request->Cancel();
     }
 
-    if (m_optimizeMeshes)
+    for (const auto& request : m_asyncLoads)
     {
-        OptimizeMeshes(model);
-    }
+        // Runs the job here if no worker has picked it up yet
+        request->m_jobSystem->Wait(request->m_workerJob);
 
-    std::cout << "ModelLoader: Loaded model with " << model->GetMeshCount()
-              << " meshes and " << model->GetMaterialCount() << " materials" << std::endl;
+        if (!request->IsDone())
+        {
+            request->m_model.reset();
+            request->m_scene = XFileScene();
+            request->m_scratch.Release();
+            request->SetStage(ModelLoadState::Cancelled, request->GetProgress());
+        }
+    }
 
-    return model;
+    m_asyncLoads.clear();
 }
 
-bool ModelLoader::ParseXFileHeader(XFileContext& context)
+void ModelLoader::SetGenerateNormals(bool generate)
 {
-    if (context.content.length() < 16)
-        return false;
-
-    // Check magic number
-    if (context.content.substr(0, 4) != "xof ")
-        return false;
-
-    // Parse version
-    std::string majorVersion = context.content.substr(4, 2);
-    std::string minorVersion = context.content.substr(6, 2);
-
-    // Parse format
-    std::string format = context.content.substr(8, 4);
-    context.isBinary = (format == "bin " || format == "bzip");
-    context.isCompressed = (format == "tzip" || format == "bzip");
-
-    if (context.isCompressed)
-    {
-        std::cerr << "ModelLoader: Compressed .X files not supported yet" << std::endl;
-        return false;
-    }
-
-    std::cout << "ModelLoader: File format - " << (context.isBinary ? "Binary" : "Text") << std::endl;
+    m_generateNormals = generate;
+}
 
-    // Parse float size
-    std::string floatSize = context.content.substr(12, 4);
+void ModelLoader::SetOptimizeMeshes(bool optimize)
+{
+    m_optimizeMeshes = optimize;
+}
 
-    context.position = 16;
-    return true;
+void ModelLoader::SetLoadAnimations(bool load)
+{
+    m_loadAnimations = load;
 }
 
-void ModelLoader::SkipTemplates(XFileContext& context)
+void ModelLoader::SetGenerateTangents(bool generate)
 {
-    // Templates are usually at the beginning, skip them
-    // This is a simplified approach - in a full implementation,
-    // you would parse templates to understand the data structure
+    m_generateTangents = generate;
+}
 
-    while (context.position < context.content.length())
-    {
-        SkipWhitespace(context);
-        std::string token = ReadToken(context);
+void ModelLoader::SetFlipWindingOrder(bool flip)
+{
+    m_flipWindingOrder = flip;
+}
 
-        if (token == "template")
-        {
-            SkipObject(context);
-        }
-        else
-        {
-            // Put the token back by moving position back
-            context.position -= token.length();
-            break;
-        }
-    }
+void ModelLoader::SetScaleFactor(float scale)
+{
+    m_scaleFactor = scale;
 }
 
-std::shared_ptr<Mesh> ModelLoader::ParseMesh(ID3D11Device* device, XFileContext& context, const std::string& basePath)
+ModelLoader::ProcessingOptions ModelLoader::GetProcessingOptions() const
 {
-    std::string meshName;
+    ProcessingOptions options;
+    options.generateNormals = m_generateNormals;
+    options.optimizeMeshes = m_optimizeMeshes;
+    options.loadAnimations = m_loadAnimations;
+    options.generateTangents = m_generateTangents;
+    options.flipWindingOrder = m_flipWindingOrder;
+    options.scaleFactor = m_scaleFactor;
+    options.parallelFor = m_parallelFor;
+    return options;
+}
 
-    if (context.isBinary)
+bool ModelLoader::ReadFileContent(const std::string& filepath, std::string& content)
+{
+    std::ifstream file(filepath, std::ios::binary);
+    if (!file.is_open())
     {
-        meshName = ReadStringBinary(context);
-        // Binary format doesn't use braces, data follows directly
+        return false;
     }
-    else
-    {
-        // Expect: Mesh meshName {
-        meshName = ReadToken(context);
-        SkipWhitespace(context);
 
-        if (ReadChar(context) != '{')
-        {
-            std::cerr << "ModelLoader: Expected '{' after Mesh name" << std::endl;
-            return nullptr;
-        }
-    }
+    file.seekg(0, std::ios::end);
+    size_t fileSize = static_cast<size_t>(file.tellg());
+    file.seekg(0, std::ios::beg);
 
-    auto mesh = std::make_shared<Mesh>();
-    if (!mesh->Initialize(device))
+    content.resize(fileSize);
+    if (fileSize > 0)
     {
-        return nullptr;
+        file.read(&content[0], static_cast<std::streamsize>(fileSize));
     }
+    return static_cast<bool>(file);
+}
 
-    mesh->SetName(meshName);
+bool ModelLoader::ProcessScene(XFileContext& context, XFileScene& scene, const ProcessingOptions& options,
+                               LinearArena& scratch, ModelLoadRequest* request)
+{
+    PROFILE_FUNCTION();
 
-    // Parse vertex count
-    int vertexCount;
-    if (context.isBinary)
-    {
-        vertexCount = static_cast<int>(ReadUInt32Binary(context));
-    }
-    else
-    {
-        SkipWhitespace(context);
-        vertexCount = ReadInt(context);
-    }
+    XFileParser parser;
+    parser.SetScaleFactor(options.scaleFactor);
+    parser.SetFlipWindingOrder(options.flipWindingOrder);
+    parser.SetLoadAnimations(options.loadAnimations);
 
-    if (vertexCount <= 0)
+    if (!parser.Parse(context, scene))
     {
-        std::cerr << "ModelLoader: Invalid vertex count: " << vertexCount << std::endl;
-        return nullptr;
+        std::cerr << "ModelLoader: Invalid .X file header" << std::endl;
+        return false;
     }
 
-    // Parse vertices
-    std::vector<XMFLOAT3> positions;
-    positions.reserve(vertexCount);
-
-    for (int i = 0; i < vertexCount; ++i)
+    if (request)
     {
-        float x, y, z;
-
-        if (context.isBinary)
-        {
-            x = ReadFloatBinary(context) * m_scaleFactor;
-            y = ReadFloatBinary(context) * m_scaleFactor;
-            z = ReadFloatBinary(context) * m_scaleFactor;
-        }
-        else
+        if (request->IsCancelRequested())
         {
-            SkipWhitespace(context);
-            x = ReadFloat(context) * m_scaleFactor;
-            SkipChar(context, ';');
-            y = ReadFloat(context) * m_scaleFactor;
-            SkipChar(context, ';');
-            z = ReadFloat(context) * m_scaleFactor;
-
-            if (i < vertexCount - 1)
-            {
-                SkipChar(context, ',');
-            }
-            SkipChar(context, ';');
+            return false;
         }
-
-        positions.push_back(XMFLOAT3(x, y, z));
+        request->SetStage(ModelLoadState::Processing, 0.5f);
     }
 
-    // Parse face count
-    int faceCount;
-    if (context.isBinary)
+    // Post-processing
+    if (options.generateNormals)
     {
-        faceCount = static_cast<int>(ReadUInt32Binary(context));
+        GenerateNormals(scene, options.parallelFor);
     }
-    else
+
+    if (options.generateTangents)
     {
-        SkipWhitespace(context);
-        faceCount = ReadInt(context);
+        GenerateTangents(scene);
     }
 
-    // Parse faces (indices)
-    std::vector<uint32_t> indices;
-
-    for (int i = 0; i < faceCount; ++i)
+    if (options.optimizeMeshes)
     {
-        SkipWhitespace(context);
-        int verticesPerFace = ReadInt(context);
-        SkipChar(context, ';');
-
-        if (verticesPerFace == 3) // Triangle
-        {
-            for (int j = 0; j < 3; ++j)
-            {
-                uint32_t index = ReadInt(context);
-                indices.push_back(index);
-
-                if (j < 2)
-                    SkipChar(context, ',');
-            }
-        }
-        else if (verticesPerFace == 4) // Quad - split into two triangles
-        {
-            uint32_t idx[4];
-            for (int j = 0; j < 4; ++j)
-            {
-                idx[j] = ReadInt(context);
-                if (j < 3)
-                    SkipChar(context, ',');
-            }
+        OptimizeMeshes(scene, options.parallelFor, scratch);
+    }
 
-            // First triangle
-            indices.push_back(idx[0]);
-            indices.push_back(idx[1]);
-            indices.push_back(idx[2]);
+    return true;
+}
 
-            // Second triangle
-            indices.push_back(idx[0]);
-            indices.push_back(idx[2]);
-            indices.push_back(idx[3]);
-        }
+void ModelLoader::RunAsyncWorkerStages(ModelLoadRequest& request, const ProcessingOptions& options)
+{
+    PROFILE_FUNCTION();
 
-        if (i < faceCount - 1)
-        {
-            SkipChar(context, ',');
-        }
-        SkipChar(context, ';');
+    // Progress: reading up to 10%, parsing up to 50%, processing up to 60%,
+    // the upload stage takes the rest
+    if (request.IsCancelRequested())
+    {
+        request.SetStage(ModelLoadState::Cancelled, 0.0f);
+        return;
     }
 
-    // Create vertices with positions
-    std::vector<Vertex> vertices;
-    vertices.reserve(positions.size());
-
-    for (const auto& pos : positions)
+    request.SetStage(ModelLoadState::Reading, 0.0f);
+    XFileContext context;
+    if (!ReadFileContent(request.m_filepath, context.content))
     {
-        Vertex vertex;
-        vertex.position = pos;
-        vertex.normal = XMFLOAT3(0.0f, 1.0f, 0.0f); // Default normal
-        vertex.texCoord = XMFLOAT2(0.0f, 0.0f); // Default UV
-        vertex.tangent = XMFLOAT3(1.0f, 0.0f, 0.0f); // Default tangent
-        vertex.binormal = XMFLOAT3(0.0f, 0.0f, 1.0f); // Default binormal
-        vertices.push_back(vertex);
+        request.Fail("Failed to open file");
+        return;
     }
 
-    // Apply winding order flip if requested
-    if (m_flipWindingOrder)
+    if (request.IsCancelRequested())
     {
-        for (size_t i = 0; i < indices.size(); i += 3)
-        {
-            std::swap(indices[i + 1], indices[i + 2]);
-        }
+        request.SetStage(ModelLoadState::Cancelled, 0.1f);
+        return;
     }
 
-    // Set mesh data
-    mesh->SetVertices(vertices);
-    mesh->SetIndices(indices);
-
-    // Parse optional data (normals, texture coordinates, materials)
-    while (context.position < context.content.length())
+    request.SetStage(ModelLoadState::Parsing, 0.1f);
+    if (!ProcessScene(context, request.m_scene, options, request.m_scratch, &request))
     {
-        SkipWhitespace(context);
-        if (context.position >= context.content.length())
-            break;
-
-        char nextChar = PeekChar(context);
-        if (nextChar == '}')
-        {
-            ReadChar(context); // consume '}'
-            break;
-        }
-
-        std::string token = ReadToken(context);
-        if (token == "MeshNormals")
+        if (request.IsCancelRequested())
         {
-            ParseMeshNormals(context, mesh);
-        }
-        else if (token == "MeshTextureCoords")
-        {
-            ParseMeshTextureCoords(context, mesh);
-        }
-        else if (token == "MeshMaterialList")
-        {
-            ParseMeshMaterialList(device, context, mesh, basePath);
+            request.m_scene = XFileScene();
+            request.SetStage(ModelLoadState::Cancelled, request.GetProgress());
         }
         else
         {
-            SkipObject(context);
+            request.Fail("Failed to parse file");
         }
+        return;
     }
 
-    return mesh;
+    // Weld tables are not needed past this point
+    request.m_scratch.Release();
+    request.SetStage(ModelLoadState::WaitingForUpload, 0.6f);
 }
 
-void ModelLoader::ParseMeshNormals(XFileContext& context, std::shared_ptr<Mesh> mesh)
+bool ModelLoader::UploadNextObject(ID3D11Device* device, ModelLoadRequest& request)
 {
-    SkipWhitespace(context);
-    SkipChar(context, '{');
+    const XFileScene& scene = request.m_scene;
+    Model& model = *request.m_model;
 
-    // Read normal count
-    int normalCount = ReadInt(context);
-    std::vector<XMFLOAT3> normals;
-    normals.reserve(normalCount);
-
-    // Read normals
-    for (int i = 0; i < normalCount; ++i)
-    {
-        SkipWhitespace(context);
-        float x = ReadFloat(context);
-        SkipChar(context, ';');
-        float y = ReadFloat(context);
-        SkipChar(context, ';');
-        float z = ReadFloat(context);
-
-        normals.push_back(XMFLOAT3(x, y, z));
-
-        if (i < normalCount - 1)
-            SkipChar(context, ',');
-        SkipChar(context, ';');
-    }
-
-    // Read face normal indices (usually we just use per-vertex normals)
-    int faceCount = ReadInt(context);
-    for (int i = 0; i < faceCount; ++i)
+    if (request.m_nextMesh < scene.meshes.size())
     {
-        SkipWhitespace(context);
-        int verticesPerFace = ReadInt(context);
-        SkipChar(context, ';');
-
-        for (int j = 0; j < verticesPerFace; ++j)
+        auto mesh = CreateMesh(device, scene.meshes[request.m_nextMesh++], request.m_filepath, request.m_meshResidency);
+        if (mesh)
         {
-            ReadInt(context); // Skip face normal indices
-            if (j < verticesPerFace - 1)
-                SkipChar(context, ',');
+            model.AddMesh(mesh);
         }
-
-        if (i < faceCount - 1)
-            SkipChar(context, ',');
-        SkipChar(context, ';');
     }
-
-    // Apply normals to mesh vertices
-    auto vertices = mesh->GetVertices();
-    if (normals.size() == vertices.size())
+    else if (request.m_nextMaterial < scene.materials.size())
     {
-        for (size_t i = 0; i < vertices.size(); ++i)
+        auto material = CreateMaterial(device, scene.materials[request.m_nextMaterial++], request.m_filepath);
+        if (material)
         {
-            vertices[i].normal = normals[i];
+            model.AddMaterial(material);
         }
-        mesh->SetVertices(vertices);
     }
-
-    SkipChar(context, '}');
-}
-
-void ModelLoader::ParseMeshTextureCoords(XFileContext& context, std::shared_ptr<Mesh> mesh)
-{
-    SkipWhitespace(context);
-    SkipChar(context, '{');
-
-    // Read texture coordinate count
-    int texCoordCount = ReadInt(context);
-
-    // Read texture coordinates
-    std::vector<XMFLOAT2> texCoords;
-    texCoords.reserve(texCoordCount);
-
-    for (int i = 0; i < texCoordCount; ++i)
-    {
-        SkipWhitespace(context);
-        float u = ReadFloat(context);
-        SkipChar(context, ';');
-        float v = ReadFloat(context);
-
-        texCoords.push_back(XMFLOAT2(u, v));
-
-        if (i < texCoordCount - 1)
-            SkipChar(context, ',');
-        SkipChar(context, ';');
-    }
-
-    // Apply texture coordinates to mesh vertices
-    auto vertices = mesh->GetVertices();
-    if (texCoords.size() == vertices.size())
+    else
     {
-        for (size_t i = 0; i < vertices.size(); ++i)
-        {
-            vertices[i].texCoord = texCoords[i];
-        }
-        mesh->SetVertices(vertices);
+        return false;
     }
 
-    SkipChar(context, '}');
-}
-
-// Utility functions for parsing
-void ModelLoader::SkipWhitespace(XFileContext& context)
-{
-    while (context.position < context.content.length() &&
-           std::isspace(context.content[context.position]))
-    {
-        context.position++;
-    }
+    size_t objectCount = scene.meshes.size() + scene.materials.size() + 1;
+    size_t uploadedCount = request.m_nextMesh + request.m_nextMaterial;
+    request.m_progress.store(0.6f + 0.4f * static_cast<float>(uploadedCount) / static_cast<float>(objectCount), std::memory_order_relaxed);
+    return true;
 }
 
-std::string ModelLoader::ReadToken(XFileContext& context)
+void ModelLoader::FinishAsyncLoad(ModelLoadRequest& request)
 {
-    SkipWhitespace(context);
+    m_lastStats.meshCount = request.m_model->GetMeshCount();
+    m_lastStats.materialCount = request.m_model->GetMaterialCount();
+    m_lastStats.animationCount = request.m_model->GetAnimationCount();
+    m_lastStats.loadingTime = std::chrono::duration<float>(std::chrono::steady_clock::now() - request.m_startTime).count();
 
-    std::string token;
-    while (context.position < context.content.length())
-    {
-        char c = context.content[context.position];
-        if (std::isalnum(c) || c == '_')
-        {
-            token += c;
-            context.position++;
-        }
-        else
-        {
-            break;
-        }
-    }
+    request.m_scene = XFileScene();
+    request.SetStage(ModelLoadState::Completed, 1.0f);
 
-    return token;
+    std::cout << "ModelLoader: Loaded model " << request.m_filepath << " asynchronously with "
+              << m_lastStats.meshCount << " meshes and " << m_lastStats.materialCount
+              << " materials in " << m_lastStats.loadingTime << "s" << std::endl;
 }
 
-char ModelLoader::ReadChar(XFileContext& context)
+std::shared_ptr<Model> ModelLoader::ParseXFile(ID3D11Device* device, XFileContext& context, const std::string& basePath)
 {
-    if (context.position < context.content.length())
-    {
-        return context.content[context.position++];
-    }
-    return 0;
-}
+    PROFILE_FUNCTION();
 
-char ModelLoader::PeekChar(XFileContext& context)
-{
-    if (context.position < context.content.length())
-    {
-        return context.content[context.position];
-    }
-    return 0;
-}
+    auto startTime = std::chrono::steady_clock::now();
 
-void ModelLoader::SkipChar(XFileContext& context, char expected)
-{
-    SkipWhitespace(context);
-    if (context.position < context.content.length() &&
-        context.content[context.position] == expected)
+    XFileScene scene;
+    if (!ProcessScene(context, scene, GetProcessingOptions(), m_loadArena))
     {
-        context.position++;
+        m_loadArena.Reset();
+        return nullptr;
     }
-}
 
-int ModelLoader::ReadInt(XFileContext& context)
-{
-    SkipWhitespace(context);
+    // Device objects are created on the calling thread
+    auto model = std::make_shared<Model>();
 
-    std::string numberStr;
-    while (context.position < context.content.length())
+    for (const auto& meshData : scene.meshes)
     {
-        char c = context.content[context.position];
-        if (std::isdigit(c) || c == '-')
-        {
-            numberStr += c;
-            context.position++;
-        }
-        else
+        auto mesh = CreateMesh(device, meshData, basePath, m_meshResidency);
+        if (mesh)
         {
-            break;
+            model->AddMesh(mesh);
         }
     }
 
-    return numberStr.empty() ? 0 : std::stoi(numberStr);
-}
-
-float ModelLoader::ReadFloat(XFileContext& context)
-{
-    SkipWhitespace(context);
-
-    std::string numberStr;
-    while (context.position < context.content.length())
+    for (const auto& materialData : scene.materials)
     {
-        char c = context.content[context.position];
-        if (std::isdigit(c) || c == '.' || c == '-' || c == 'e' || c == 'E' || c == '+')
+        auto material = CreateMaterial(device, materialData, basePath);
+        if (material)
         {
-            numberStr += c;
-            context.position++;
-        }
-        else
-        {
-            break;
+            model->AddMaterial(material);
         }
     }
 
-    return numberStr.empty() ? 0.0f : std::stof(numberStr);
-}
-
-void ModelLoader::SkipObject(XFileContext& context)
-{
-    SkipWhitespace(context);
-
-    // Skip until we find opening brace
-    while (context.position < context.content.length() &&
-           context.content[context.position] != '{')
+    for (const auto& animationData : scene.animationSets)
     {
-        context.position++;
+        CreateAnimation(animationData, model);
     }
 
-    if (context.position >= context.content.length())
-        return;
+    m_lastStats.meshCount = model->GetMeshCount();
+    m_lastStats.materialCount = model->GetMaterialCount();
+    m_lastStats.animationCount = static_cast<int>(scene.animationSets.size());
+    m_lastStats.loadingTime = std::chrono::duration<float>(std::chrono::steady_clock::now() - startTime).count();
 
-    context.position++; // Skip '{'
+    // Everything the load put in the scratch arena goes away at once
+    m_loadArena.Reset();
 
-    int braceLevel = 1;
-    while (context.position < context.content.length() && braceLevel > 0)
-    {
-        char c = context.content[context.position++];
-        if (c == '{')
-            braceLevel++;
-        else if (c == '}')
-            braceLevel--;
-    }
+    std::cout << "ModelLoader: Loaded model with " << model->GetMeshCount()
+              << " meshes and " << model->GetMaterialCount() << " materials" << std::endl;
+
+    return model;
 }
 
-std::shared_ptr<Material> ModelLoader::ParseMaterial(ID3D11Device* device, XFileContext& context, const std::string& basePath)
+std::shared_ptr<Mesh> ModelLoader::CreateMesh(ID3D11Device* device, const XMeshData& meshData, const std::string& basePath, MeshResidency residency)
 {
-    std::string materialName = ReadToken(context);
-    SkipWhitespace(context);
-    SkipChar(context, '{');
-
-    auto material = std::make_shared<Material>(materialName);
-    if (!material->Initialize(device))
+    // Object and control block share one slot of the Resources pool
+    auto mesh = std::allocate_shared<Mesh>(PooledAllocator<Mesh, MemorySubsystem::Resources>());
+    mesh->SetResidency(residency);
+    if (!mesh->InitializeFromVertices(device, meshData.vertices, meshData.indices))
     {
-        SkipObject(context);
+        std::cerr << "ModelLoader: Failed to create mesh " << meshData.name << std::endl;
         return nullptr;
     }
 
-    // Default material properties
-    XMFLOAT4 diffuseColor(0.8f, 0.8f, 0.8f, 1.0f);
-    XMFLOAT4 specularColor(1.0f, 1.0f, 1.0f, 1.0f);
-    XMFLOAT4 emissiveColor(0.0f, 0.0f, 0.0f, 1.0f);
-    float shininess = 32.0f;
+    mesh->SetName(meshData.name);
+    mesh->SetAssetName(basePath);
 
-    // Parse material properties
-    while (context.position < context.content.length())
+    // Use first material for now
+    if (!meshData.materials.empty())
     {
-        SkipWhitespace(context);
-        if (PeekChar(context) == '}')
-        {
-            ReadChar(context); // consume '}'
-            break;
-        }
-
-        // Read diffuse color (first 4 floats)
-        diffuseColor.x = ReadFloat(context); SkipChar(context, ';');
-        diffuseColor.y = ReadFloat(context); SkipChar(context, ';');
-        diffuseColor.z = ReadFloat(context); SkipChar(context, ';');
-        diffuseColor.w = ReadFloat(context); SkipChar(context, ';');
-
-        // Read power (shininess)
-        shininess = ReadFloat(context); SkipChar(context, ';');
-
-        // Read specular color
-        specularColor.x = ReadFloat(context); SkipChar(context, ';');
-        specularColor.y = ReadFloat(context); SkipChar(context, ';');
-        specularColor.z = ReadFloat(context); SkipChar(context, ';');
-
-        // Read emissive color
-        emissiveColor.x = ReadFloat(context); SkipChar(context, ';');
-        emissiveColor.y = ReadFloat(context); SkipChar(context, ';');
-        emissiveColor.z = ReadFloat(context); SkipChar(context, ';');
-
-        // Skip any additional data or TextureFilename objects
-        while (context.position < context.content.length())
-        {
-            SkipWhitespace(context);
-            char nextChar = PeekChar(context);
-            if (nextChar == '}')
-                break;
-
-            std::string token = ReadToken(context);
-            if (token == "TextureFilename")
-            {
-                // Parse texture filename
-                SkipWhitespace(context);
-                SkipChar(context, '{');
-
-                // Read string (texture path)
-                SkipWhitespace(context);
-                if (PeekChar(context) == '"')
-                {
-                    ReadChar(context); // skip opening quote
-                    std::string texturePath;
-                    while (context.position < context.content.length() &&
-                           context.content[context.position] != '"')
-                    {
-                        texturePath += context.content[context.position++];
-                    }
-                    ReadChar(context); // skip closing quote
-
-                    // Try to load texture
-                    std::string fullPath = basePath + "/" + texturePath;
-                    // Note: Actual texture loading would require TextureManager integration
-                }
-
-                SkipChar(context, '}');
-            }
-            else
-            {
-                SkipObject(context);
-            }
-        }
-        break; // Exit after parsing material data
+        mesh->SetMaterial(CreateMaterial(device, meshData.materials[0], basePath));
     }
 
-    // Apply parsed properties to material
-    material->SetDiffuseColor(diffuseColor);
-    material->SetSpecularColor(specularColor);
-    material->SetEmissiveColor(emissiveColor);
-    material->SetShininess(shininess);
-
-    return material;
+    return mesh;
 }
 
-void ModelLoader::ParseFrame(ID3D11Device* device, XFileContext& context, std::shared_ptr<Model> model, const std::string& basePath)
+std::shared_ptr<Material> ModelLoader::CreateMaterial(ID3D11Device* device, const XMaterialData& materialData, const std::string& basePath)
 {
-    std::string frameName = ReadToken(context);
-    SkipWhitespace(context);
-    SkipChar(context, '{');
-
-    // Parse frame contents
-    while (context.position < context.content.length())
+    auto material = std::allocate_shared<Material>(PooledAllocator<Material, MemorySubsystem::Resources>(), materialData.name);
+    if (!material->Initialize(device))
     {
-        SkipWhitespace(context);
-        if (PeekChar(context) == '}')
-        {
-            ReadChar(context); // consume '}'
-            break;
-        }
-
-        std::string token = ReadToken(context);
-
-        if (token == "FrameTransformMatrix")
-        {
-            // Parse transformation matrix
-            SkipWhitespace(context);
-            SkipChar(context, '{');
-
-            // Read 16 matrix elements (4x4 matrix)
-            for (int i = 0; i < 16; ++i)
-            {
-                float value = ReadFloat(context);
-                if (i < 15)
-                    SkipChar(context, ',');
-                SkipChar(context, ';');
-            }
-
-            SkipChar(context, '}');
-        }
-        else if (token == "Mesh")
-        {
-            // Parse mesh within this frame
-            auto mesh = ParseMesh(device, context, basePath);
-            if (mesh)
-            {
-                mesh->SetName(frameName + "_Mesh");
-                model->AddMesh(mesh);
-            }
-        }
-        else if (token == "Frame")
-        {
-            // Recursive frame parsing (child frames)
-            ParseFrame(device, context, model, basePath);
-        }
-        else
-        {
-            SkipObject(context);
-        }
+        return nullptr;
     }
-}
-
-void ModelLoader::ParseMeshMaterialList(ID3D11Device* device, XFileContext& context, std::shared_ptr<Mesh> mesh, const std::string& basePath)
-{
-    SkipWhitespace(context);
-    SkipChar(context, '{');
-
-    // Read material count
-    int materialCount = ReadInt(context);
 
-    // Read face count
-    int faceCount = ReadInt(context);
+    material->SetDiffuseColor(materialData.diffuseColor);
+    material->SetSpecularColor(materialData.specularColor);
+    material->SetEmissiveColor(materialData.emissiveColor);
+    material->SetShininess(materialData.shininess);
 
-    // Read material indices per face
-    std::vector<int> faceMatIndices;
-    faceMatIndices.reserve(faceCount);
-
-    for (int i = 0; i < faceCount; ++i)
+    if (!materialData.textureFilename.empty())
     {
-        SkipWhitespace(context);
-        int materialIndex = ReadInt(context);
-        faceMatIndices.push_back(materialIndex);
-
-        if (i < faceCount - 1)
-            SkipChar(context, ',');
-        SkipChar(context, ';');
+        std::string fullPath = basePath + "/" + materialData.textureFilename;
+        // Note: Actual texture loading would require TextureManager integration
     }
 
-    // Parse material definitions or references
-    for (int i = 0; i < materialCount; ++i)
-    {
-        SkipWhitespace(context);
-        std::string token = ReadToken(context);
-
-        if (token == "Material")
-        {
-            auto material = ParseMaterial(device, context, basePath);
-            if (material && i == 0) // Use first material for now
-            {
-                mesh->SetMaterial(material);
-            }
-        }
-        else if (token == "{")
-        {
-            // Reference to existing material by name
-            std::string materialName = ReadToken(context);
-            SkipChar(context, '}');
-            // Would need material database lookup here
-        }
-        else
-        {
-            SkipObject(context);
-        }
-    }
-
-    SkipChar(context, '}');
+    return material;
 }
 
-void ModelLoader::ParseAnimationSet(XFileContext& context, std::shared_ptr<Model> model)
+void ModelLoader::CreateAnimation(const XAnimationSetData& animationData, std::shared_ptr<Model> model)
 {
-    std::string animationName = ReadToken(context);
-    SkipWhitespace(context);
-    SkipChar(context, '{');
-
-    // Create animation
-    auto animation = std::make_shared<Animation>();
-    animation->Initialize(animationName, 0.0f, 25.0f); // Default values, will be updated
-
-    std::vector<AnimationChannel> channels;
-
-    // Parse animation content
-    while (context.position < context.content.length())
+    if (animationData.duration <= 0.0f)
     {
-        SkipWhitespace(context);
-        if (PeekChar(context) == '}')
-        {
-            ReadChar(context); // consume '}'
-            break;
-        }
-
-        std::string token = ReadToken(context);
-
-        if (token == "Animation")
-        {
-            // Parse individual animation for a bone
-            std::string boneName = ReadToken(context);
-            SkipWhitespace(context);
-            SkipChar(context, '{');
-
-            AnimationChannel channel;
-            channel.boneName = boneName;
-
-            // Parse animation keys
-            while (context.position < context.content.length())
-            {
-                SkipWhitespace(context);
-                if (PeekChar(context) == '}')
-                {
-                    ReadChar(context); // consume '}'
-                    break;
-                }
-
-                std::string keyToken = ReadToken(context);
-
-                if (keyToken == "AnimationKey")
-                {
-                    SkipWhitespace(context);
-                    SkipChar(context, '{');
-
-                    // Read key type (0=rotation, 1=scale, 2=position)
-                    int keyType = ReadInt(context);
-
-                    // Read number of keys
-                    int numKeys = ReadInt(context);
-
-                    for (int i = 0; i < numKeys; ++i)
-                    {
-                        // Read time
-                        float time = ReadFloat(context);
-                        SkipChar(context, ';');
-
-                        // Read number of values
-                        int numValues = ReadInt(context);
-                        SkipChar(context, ';');
-
-                        if (keyType == 2) // Position
-                        {
-                            if (numValues >= 3)
-                            {
-                                float x = ReadFloat(context); SkipChar(context, ',');
-                                float y = ReadFloat(context); SkipChar(context, ',');
-                                float z = ReadFloat(context);
-
-                                AnimationKey<XMVECTOR> key(time, XMVectorSet(x, y, z, 0.0f));
-                                channel.positionKeys.push_back(key);
-                            }
-                        }
-                        else if (keyType == 0) // Rotation (quaternion)
-                        {
-                            if (numValues >= 4)
-                            {
-                                float w = ReadFloat(context); SkipChar(context, ',');
-                                float x = ReadFloat(context); SkipChar(context, ',');
-                                float y = ReadFloat(context); SkipChar(context, ',');
-                                float z = ReadFloat(context);
-
-                                AnimationKey<XMVECTOR> key(time, XMVectorSet(x, y, z, w));
-                                channel.rotationKeys.push_back(key);
-                            }
-                        }
-                        else if (keyType == 1) // Scale
-                        {
-                            if (numValues >= 3)
-                            {
-                                float x = ReadFloat(context); SkipChar(context, ',');
-                                float y = ReadFloat(context); SkipChar(context, ',');
-                                float z = ReadFloat(context);
-
-                                AnimationKey<XMVECTOR> key(time, XMVectorSet(x, y, z, 0.0f));
-                                channel.scaleKeys.push_back(key);
-                            }
-                        }
-
-                        // Skip remaining values and separators
-                        for (int j = 3; j < numValues; ++j)
-                        {
-                            ReadFloat(context);
-                            if (j < numValues - 1) SkipChar(context, ',');
-                        }
-
-                        if (i < numKeys - 1) SkipChar(context, ',');
-                        SkipChar(context, ';');
-                    }
-
-                    SkipChar(context, '}');
-                }
-                else
-                {
-                    SkipObject(context);
-                }
-            }
-
-            if (!channel.positionKeys.empty() || !channel.rotationKeys.empty() || !channel.scaleKeys.empty())
-            {
-                channels.push_back(channel);
-            }
-        }
-        else
-        {
-            SkipObject(context);
-        }
+        return;
     }
 
-    // Add channels to animation
-    for (const auto& channel : channels)
-    {
-        animation->AddChannel(channel);
-    }
+    auto animation = std::make_shared<Animation>();
+    animation->Initialize(animationData.name, animationData.duration, 25.0f);
 
-    // Calculate animation duration
-    float maxTime = 0.0f;
-    for (const auto& channel : channels)
+    for (const auto& channel : animationData.channels)
     {
-        for (const auto& key : channel.positionKeys)
-        {
-            maxTime = std::max(maxTime, key.time);
-        }
-        for (const auto& key : channel.rotationKeys)
-        {
-            maxTime = std::max(maxTime, key.time);
-        }
-        for (const auto& key : channel.scaleKeys)
-        {
-            maxTime = std::max(maxTime, key.time);
-        }
+        animation->AddChannel(channel);
     }
 
-    if (maxTime > 0.0f)
-    {
-        animation->Initialize(animationName, maxTime, 25.0f);
-        // Note: Would need to add animation to model here
-        // model->AddAnimation(animation);
+    // Note: Would need to add animation to model here
+    // model->AddAnimation(animation);
 
-        std::cout << "ModelLoader: Loaded animation '" << animationName
-                  << "' with duration " << maxTime << " and "
-                  << channels.size() << " channels" << std::endl;
-    }
+    std::cout << "ModelLoader: Loaded animation '" << animationData.name
+              << "' with duration " << animationData.duration << " and "
+              << animationData.channels.size() << " channels" << std::endl;
 }
 
 // Post-processing functions
-void ModelLoader::GenerateNormals(std::shared_ptr<Model> model)
+void ModelLoader::GenerateNormals(XFileScene& scene, const ParallelForFunction& parallelFor)
 {
-    // Generate smooth normals for meshes that don't have them
-    // This is a simplified implementation
-    for (size_t i = 0; i < model->GetMeshCount(); ++i)
-    {
-        auto mesh = model->GetMesh(i);
-        auto vertices = mesh->GetVertices();
-        auto indices = mesh->GetIndices();
+    PROFILE_FUNCTION();
 
-        // Reset normals
-        for (auto& vertex : vertices)
-        {
-            vertex.normal = XMFLOAT3(0.0f, 0.0f, 0.0f);
-        }
-
-        // Calculate face normals and accumulate
-        for (size_t j = 0; j < indices.size(); j += 3)
-        {
-            uint32_t i0 = indices[j];
-            uint32_t i1 = indices[j + 1];
-            uint32_t i2 = indices[j + 2];
-
-            XMVECTOR v0 = XMLoadFloat3(&vertices[i0].position);
-            XMVECTOR v1 = XMLoadFloat3(&vertices[i1].position);
-            XMVECTOR v2 = XMLoadFloat3(&vertices[i2].position);
-
-            XMVECTOR edge1 = XMVectorSubtract(v1, v0);
-            XMVECTOR edge2 = XMVectorSubtract(v2, v0);
-            XMVECTOR normal = XMVector3Cross(edge1, edge2);
-            normal = XMVector3Normalize(normal);
-
-            XMFLOAT3 normalFloat;
-            XMStoreFloat3(&normalFloat, normal);
-
-            // Add to each vertex
-            vertices[i0].normal.x += normalFloat.x;
-            vertices[i0].normal.y += normalFloat.y;
-            vertices[i0].normal.z += normalFloat.z;
-
-            vertices[i1].normal.x += normalFloat.x;
-            vertices[i1].normal.y += normalFloat.y;
-            vertices[i1].normal.z += normalFloat.z;
-
-            vertices[i2].normal.x += normalFloat.x;
-            vertices[i2].normal.y += normalFloat.y;
-            vertices[i2].normal.z += normalFloat.z;
-        }
-
-        // Normalize accumulated normals
-        for (auto& vertex : vertices)
+    // Smooth normals per mesh; meshes are independent, so they can be processed in parallel
+    auto computeRange = [&scene](size_t begin, size_t end)
+    {
+        for (size_t i = begin; i < end; ++i)
         {
-            XMVECTOR normal = XMLoadFloat3(&vertex.normal);
-            normal = XMVector3Normalize(normal);
-            XMStoreFloat3(&vertex.normal, normal);
+            MeshProcessing::CalculateNormals(scene.meshes[i].vertices, scene.meshes[i].indices);
         }
+    };
 
-        mesh->SetVertices(vertices);
+    if (parallelFor && scene.meshes.size() > 1)
+    {
+        parallelFor(scene.meshes.size(), computeRange);
+    }
+    else
+    {
+        computeRange(0, scene.meshes.size());
     }
 }
 
-void ModelLoader::GenerateTangents(std::shared_ptr<Model> model)
+void ModelLoader::GenerateTangents(XFileScene& scene)
 {
     // Generate tangents for normal mapping - simplified implementation
     // In a full implementation, this would calculate proper tangent space
 }
 
-void ModelLoader::OptimizeMeshes(std::shared_ptr<Model> model)
+void ModelLoader::OptimizeMeshes(XFileScene& scene, const ParallelForFunction& parallelFor, LinearArena& scratch)
 {
-    // Optimize meshes by removing duplicate vertices, etc.
-    // This is a placeholder for optimization algorithms
-}
+    PROFILE_FUNCTION();
 
-// Binary file reading implementations
-template<typename T>
-T ModelLoader::ReadBinary(XFileContext& context)
-{
-    if (context.position + sizeof(T) > context.content.length())
+    // Weld duplicate vertices per mesh; the lookup tables come from the load arena
+    LinearArena* scratchArena = &scratch;
+    auto weldRange = [&scene, scratchArena](size_t begin, size_t end)
     {
-        throw std::runtime_error("ModelLoader: Unexpected end of binary data");
-    }
-
-    T value;
-    std::memcpy(&value, context.content.data() + context.position, sizeof(T));
-    context.position += sizeof(T);
-    return value;
-}
-
-uint16_t ModelLoader::ReadUInt16Binary(XFileContext& context)
-{
-    return ReadBinary<uint16_t>(context);
-}
-
-uint32_t ModelLoader::ReadUInt32Binary(XFileContext& context)
-{
-    return ReadBinary<uint32_t>(context);
-}
-
-float ModelLoader::ReadFloatBinary(XFileContext& context)
-{
-    return ReadBinary<float>(context);
-}
-
-std::string ModelLoader::ReadStringBinary(XFileContext& context)
-{
-    uint32_t length = ReadUInt32Binary(context);
-    if (length == 0) return "";
+        for (size_t i = begin; i < end; ++i)
+        {
+            MeshProcessing::WeldVertices(scene.meshes[i].vertices, scene.meshes[i].indices, scratchArena);
+        }
+    };
 
-    if (context.position + length > context.content.length())
+    if (parallelFor && scene.meshes.size() > 1)
     {
-        throw std::runtime_error("ModelLoader: String length exceeds available data");
+        parallelFor(scene.meshes.size(), weldRange);
     }
-
-    std::string result(context.content.data() + context.position, length);
-    context.position += length;
-
-    // Skip null terminator if present
-    if (context.position < context.content.length() &&
-        context.content[context.position] == '\0')
+    else
     {
-        context.position++;
+        weldRange(0, scene.meshes.size());
     }
-
-    return result;
-}
-
-ModelLoader::BinaryToken ModelLoader::ReadBinaryToken(XFileContext& context)
-{
-    BinaryToken token;
-    token.type = ReadUInt16Binary(context);
-    token.size = ReadUInt16Binary(context);
-    return token;
 }
@@ -2,174 +2,140 @@
 
 #include <d3d11.h>
 #include <DirectXMath.h>
+#include <atomic>
+#include <chrono>
 #include <string>
 #include <vector>
 #include <memory>
-#include <unordered_map>
+#include "XFileParser.h"
+#include "../Engine/JobSystem.h"
+#include "../Engine/Memory.h"
 
 // Forward declarations
 class Model;
 class Mesh;
 class Material;
 class Texture;
+enum class MeshResidency;
 
-// DirectX .x file format structures
-namespace XFileFormat
+// Stages of an asynchronous load, in order
+enum class ModelLoadState
 {
-    // Header structure for .x files
-    struct XFileHeader
-    {
-        char magic[4];        // "xof "
-        char majorVersion[2]; // "03"
-        char minorVersion[2]; // "02" or "03"
-        char format[4];       // "txt " or "bin " or "tzip" or "bzip"
-        char floatSize[4];    // "0032" or "0064"
-    };
-
-    // Template definitions used in .x files
-    enum class TemplateType
-    {
-        Header,
-        Vector,
-        Coords2d,
-        Matrix4x4,
-        ColorRGBA,
-        ColorRGB,
-        IndexedColor,
-        Boolean,
-        Boolean2d,
-        MaterialWrap,
-        TextureFilename,
-        Material,
-        MeshFace,
-        MeshFaceWraps,
-        MeshTextureCoords,
-        MeshNormals,
-        MeshVertexColors,
-        MeshMaterialList,
-        Mesh,
-        FrameTransformMatrix,
-        Frame,
-        FloatKeys,
-        TimedFloatKeys,
-        AnimationKey,
-        AnimationOptions,
-        Animation,
-        AnimationSet,
-        SkinMeshHeader,
-        SkinWeights,
-        XSkinMeshHeader,
-        VertexDuplicationIndices,
-        FaceAdjacency,
-        DeclData,
-        VertexElement,
-        VertexElementType,
-        VertexElementMethod,
-        VertexElementUsage,
-        DeclType
-    };
-}
+    Queued = 0,
+    Reading,            // File I/O on a worker
+    Parsing,            // Worker
+    Processing,         // Normals, tangents and welding on a worker
+    WaitingForUpload,   // Parsed; waiting for UpdateAsyncLoads on the main thread
+    Uploading,          // Device objects being created, a few per frame
+    Completed,
+    Failed,
+    Cancelled
+};
 
-// .X file parsing context
-struct XFileContext
+// Handle of one ModelLoader::LoadAsync call. Shared by the caller, the worker
+// job and the loader; any of them may drop it first.
+class ModelLoadRequest
 {
-    std::string content;
-    size_t position;
-    bool isBinary;
-    bool isCompressed;
+public:
+    explicit ModelLoadRequest(const std::string& filepath);
 
-    XFileContext() : position(0), isBinary(false), isCompressed(false) {}
-};
+    const std::string& GetFilepath() const { return m_filepath; }
+    ModelLoadState GetState() const { return m_state.load(std::memory_order_acquire); }
 
-// Parsed material data from .x file
-struct XMaterialData
-{
-    std::string name;
-    DirectX::XMFLOAT4 diffuseColor;
-    float specularPower;
-    DirectX::XMFLOAT3 specularColor;
-    DirectX::XMFLOAT3 emissiveColor;
-    std::string textureFilename;
-
-    XMaterialData()
-        : diffuseColor(0.8f, 0.8f, 0.8f, 1.0f)
-        , specularPower(1.0f)
-        , specularColor(1.0f, 1.0f, 1.0f)
-        , emissiveColor(0.0f, 0.0f, 0.0f)
-    {
-    }
-};
+    // 0 to 1 across all stages
+    float GetProgress() const { return m_progress.load(std::memory_order_relaxed); }
 
-// Parsed mesh data from .x file
-struct XMeshData
-{
-    std::string name;
-    std::vector<DirectX::XMFLOAT3> vertices;
-    std::vector<DirectX::XMFLOAT3> normals;
-    std::vector<DirectX::XMFLOAT2> textureCoords;
-    std::vector<DirectX::XMFLOAT4> vertexColors;
-    std::vector<unsigned int> indices;
-    std::vector<int> materialIndices; // Per-face material assignment
-
-    // Skinning data
-    std::vector<std::vector<int>> boneIndices;    // Per-vertex bone indices
-    std::vector<std::vector<float>> boneWeights;  // Per-vertex bone weights
-};
+    // Completed, Failed or Cancelled
+    bool IsDone() const;
 
-// Parsed bone/frame data from .x file
-struct XFrameData
-{
-    std::string name;
-    DirectX::XMMATRIX transformMatrix;
-    std::vector<std::unique_ptr<XFrameData>> children;
-    std::unique_ptr<XMeshData> mesh;
+    // Stops the load at the next stage boundary (or the next uploaded
+    // object); a completed load is left alone
+    void Cancel() { m_cancelRequested.store(true, std::memory_order_relaxed); }
+    bool IsCancelRequested() const { return m_cancelRequested.load(std::memory_order_relaxed); }
 
-    XFrameData() : transformMatrix(DirectX::XMMatrixIdentity()) {}
-};
+    // Valid once Completed
+    std::shared_ptr<Model> GetModel() const;
 
-// Animation data structures
-struct XAnimationKey
-{
-    enum Type
-    {
-        Rotation = 0,
-        Scale = 1,
-        Position = 2,
-        Matrix = 4
-    };
+    // Why the load failed; valid once Failed
+    const std::string& GetError() const;
 
-    Type keyType;
-    std::vector<float> times;
-    std::vector<std::vector<float>> values;
+private:
+    friend class ModelLoader;
+
+    ModelLoadRequest(const ModelLoadRequest&) = delete;
+    ModelLoadRequest& operator=(const ModelLoadRequest&) = delete;
+
+    void SetStage(ModelLoadState state, float progress);
+    void Fail(const std::string& error);
+
+    std::string m_filepath;
+    std::atomic<ModelLoadState> m_state;
+    std::atomic<float> m_progress;
+    std::atomic<bool> m_cancelRequested;
+    std::string m_error;
+
+    // Worker stages; handed to the main thread by WaitingForUpload
+    XFileScene m_scene;
+    LinearArena m_scratch;
+
+    // Upload stage (main thread only); meshes, then materials
+    MeshResidency m_meshResidency;
+    std::shared_ptr<Model> m_model;
+    size_t m_nextMesh;
+    size_t m_nextMaterial;
+    std::chrono::steady_clock::time_point m_startTime;
+
+    // Done when the worker job has finished
+    JobSystem* m_jobSystem;
+    JobCounter m_workerJob;
 };
 
-struct XAnimationData
-{
-    std::string name;
-    std::string targetFrame;
-    std::vector<XAnimationKey> keys;
-};
+typedef std::shared_ptr<ModelLoadRequest> ModelLoadHandle;
 
-// ModelLoader class for loading DirectX .x files
+// ModelLoader class for loading DirectX .x files. Parsing is done by
+// XFileParser; the loader creates meshes and materials on the device and runs
+// the optional post-processing.
 class ModelLoader
 {
 public:
     ModelLoader();
     ~ModelLoader();
 
-    // Main loading function
+    // Main loading functions
     std::shared_ptr<Model> LoadFromFile(ID3D11Device* device, const std::string& filepath);
+    std::shared_ptr<Model> LoadFromMemory(ID3D11Device* device, const void* data, size_t size);
+
+    // Asynchronous loading. Reading, parsing and post-processing run as one
+    // job on the job system; the device objects are created by
+    // UpdateAsyncLoads, which the main thread calls once per frame. The
+    // current configuration is captured when the load starts, except that
+    // animation sets are not loaded. Returns immediately; the handle reports
+    // progress and can cancel.
+    ModelLoadHandle LoadAsync(const std::string& filepath, JobSystem& jobSystem);
+
+    // Creates device objects of loads that finished their worker stage, for
+    // at most timeBudgetMs (at least one object per call so loads always
+    // progress). Returns the number of loads still in flight.
+    size_t UpdateAsyncLoads(ID3D11Device* device, float timeBudgetMs = 2.0f);
+
+    // Cancels every load in flight and waits for their worker jobs
+    void CancelAsyncLoads();
+    size_t GetAsyncLoadCount() const { return m_asyncLoads.size(); }
 
     // Configuration
-    void SetFlipTextureCoordinates(bool flip) { m_flipTextureCoords = flip; }
-    void SetGenerateNormals(bool generate) { m_generateNormals = generate; }
-    void SetOptimizeMeshes(bool optimize) { m_optimizeMeshes = optimize; }
-    void SetLoadAnimations(bool loadAnims) { m_loadAnimations = loadAnims; }
+    void SetGenerateNormals(bool generate);
+    void SetOptimizeMeshes(bool optimize);
+    void SetLoadAnimations(bool load);
+    void SetGenerateTangents(bool generate);
+    void SetFlipWindingOrder(bool flip);
+    void SetScaleFactor(float scale);
+
+    // CPU geometry kept by the created meshes (see Mesh::SetResidency)
+    void SetMeshResidency(MeshResidency residency) { m_meshResidency = residency; }
 
-    // Error handling
-    bool HasErrors() const { return !m_errorMessages.empty(); }
-    const std::vector<std::string>& GetErrorMessages() const { return m_errorMessages; }
-    void ClearErrors() { m_errorMessages.clear(); }
+    // Optional parallel post-processing across meshes (CPU work only; GPU
+    // buffers are still created on the loading thread)
+    void SetParallelForFunction(ParallelForFunction parallelFor) { m_parallelFor = parallelFor; }
 
     // Statistics
     struct LoadingStats
@@ -177,96 +143,74 @@ public:
         int meshCount;
         int materialCount;
         int animationCount;
-        int boneCount;
         float loadingTime;
 
-        LoadingStats() : meshCount(0), materialCount(0), animationCount(0), boneCount(0), loadingTime(0.0f) {}
+        LoadingStats() : meshCount(0), materialCount(0), animationCount(0), loadingTime(0.0f) {}
     };
 
     const LoadingStats& GetLastLoadingStats() const { return m_lastStats; }
 
+    // Scratch used while a model loads; reset in bulk after every load
+    const LinearArena& GetLoadArena() const { return m_loadArena; }
+
 private:
-    // File parsing
-    bool ParseHeader(XFileContext& context);
-    bool ParseContent(XFileContext& context, std::shared_ptr<Model> model, ID3D11Device* device);
-
-    // Binary file reading helpers
-    template<typename T> T ReadBinary(XFileContext& context);
-    uint16_t ReadUInt16Binary(XFileContext& context);
-    uint32_t ReadUInt32Binary(XFileContext& context);
-    float ReadFloatBinary(XFileContext& context);
-    std::string ReadStringBinary(XFileContext& context);
-
-    // Binary token reading
-    struct BinaryToken {
-        uint16_t type;
-        uint16_t size;
+    // Configuration of the CPU stages, captured per load
+    struct ProcessingOptions
+    {
+        bool generateNormals;
+        bool optimizeMeshes;
+        bool loadAnimations;
+        bool generateTangents;
+        bool flipWindingOrder;
+        float scaleFactor;
+        ParallelForFunction parallelFor;
     };
-    BinaryToken ReadBinaryToken(XFileContext& context);
-
-    // Template parsing
-    std::unique_ptr<XFrameData> ParseFrame(XFileContext& context);
-    std::unique_ptr<XMeshData> ParseMesh(XFileContext& context);
-    XMaterialData ParseMaterial(XFileContext& context);
-    std::vector<XAnimationData> ParseAnimationSet(XFileContext& context);
-
-    // Mesh processing
-    void ProcessMeshData(const XMeshData& meshData,
-                        const std::vector<XMaterialData>& materials,
-                        std::shared_ptr<Model> model,
-                        ID3D11Device* device);
-
-    void ProcessFrameHierarchy(const XFrameData& frameData,
-                              const DirectX::XMMATRIX& parentTransform,
-                              std::shared_ptr<Model> model,
-                              ID3D11Device* device);
-
-    // Material processing
-    std::shared_ptr<Material> CreateMaterialFromData(const XMaterialData& materialData,
-                                                     ID3D11Device* device,
-                                                     const std::string& modelDirectory);
-
-    // Animation processing
-    void ProcessAnimations(const std::vector<XAnimationData>& animData, std::shared_ptr<Model> model);
-
-    // Utility functions
-    bool IsTextFormat(const std::string& content) const;
-    std::string ReadString(XFileContext& context);
-    int ReadInt(XFileContext& context);
-    float ReadFloat(XFileContext& context);
-    DirectX::XMFLOAT3 ReadVector3(XFileContext& context);
-    DirectX::XMFLOAT4 ReadVector4(XFileContext& context);
-    DirectX::XMMATRIX ReadMatrix(XFileContext& context);
-    void SkipWhitespace(XFileContext& context);
-    void SkipToNext(XFileContext& context, char delimiter);
-
-    // Validation and error handling
-    bool ValidateXFile(const std::string& content) const;
-    void AddError(const std::string& message);
-    void AddWarning(const std::string& message);
-
-    // Post-processing
-    void GenerateNormalsForMesh(XMeshData& meshData);
-    void OptimizeMeshData(XMeshData& meshData);
-    void FlipTextureCoordinates(XMeshData& meshData);
+
+    ProcessingOptions GetProcessingOptions() const;
+
+    static bool ReadFileContent(const std::string& filepath, std::string& content);
+
+    std::shared_ptr<Model> ParseXFile(ID3D11Device* device, XFileContext& context, const std::string& basePath);
+
+    // Parse and post-process; no device access, safe on any thread
+    static bool ProcessScene(XFileContext& context, XFileScene& scene, const ProcessingOptions& options,
+                             LinearArena& scratch, ModelLoadRequest* request = nullptr);
+    static void RunAsyncWorkerStages(ModelLoadRequest& request, const ProcessingOptions& options);
+
+    // Advances one object of a load's upload stage; false once it is done
+    bool UploadNextObject(ID3D11Device* device, ModelLoadRequest& request);
+    void FinishAsyncLoad(ModelLoadRequest& request);
+
+    // Device objects from parsed data
+    std::shared_ptr<Mesh> CreateMesh(ID3D11Device* device, const XMeshData& meshData, const std::string& basePath, MeshResidency residency);
+    std::shared_ptr<Material> CreateMaterial(ID3D11Device* device, const XMaterialData& materialData, const std::string& basePath);
+    void CreateAnimation(const XAnimationSetData& animationData, std::shared_ptr<Model> model);
+
+    // Post-processing on parsed data, before any buffer is created
+    static void GenerateNormals(XFileScene& scene, const ParallelForFunction& parallelFor);
+    static void GenerateTangents(XFileScene& scene);
+    static void OptimizeMeshes(XFileScene& scene, const ParallelForFunction& parallelFor, LinearArena& scratch);
 
 private:
     // Configuration flags
-    bool m_flipTextureCoords;
     bool m_generateNormals;
     bool m_optimizeMeshes;
     bool m_loadAnimations;
+    bool m_generateTangents;
+    bool m_flipWindingOrder;
+    float m_scaleFactor;
+    MeshResidency m_meshResidency;
+    ParallelForFunction m_parallelFor;
 
-    // Error tracking
-    std::vector<std::string> m_errorMessages;
-    std::vector<std::string> m_warningMessages;
+    // Load-time scratch (weld tables); shared by the post-processing jobs.
+    // Async loads have their own arena each.
+    LinearArena m_loadArena;
+
+    // Async loads in flight, oldest first
+    std::vector<ModelLoadHandle> m_asyncLoads;
 
     // Statistics
     LoadingStats m_lastStats;
-
-    // Parsing state
-    std::string m_currentDirectory;
-    std::unordered_map<std::string, int> m_frameNameToIndex;
 };
 
 // Utility functions for .x file processing
@@ -0,0 +1,348 @@
+#include "OcclusionCulling.h"
+#include "FrustumCulling.h"
+#include "../Engine/Profiler.h"
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cfloat>
+
+namespace
+{
+    // Vertices closer than this in clip w are treated as crossing the near plane
+    const float MIN_CLIP_W = 1e-4f;
+}
+
+OcclusionCuller::OcclusionCuller()
+    : m_width(0)
+    , m_height(0)
+    , m_tilesX(0)
+    , m_tilesY(0)
+    , m_viewProjection(XMMatrixIdentity())
+{
+}
+
+OcclusionCuller::~OcclusionCuller()
+{
+}
+
+bool OcclusionCuller::Initialize(int width, int height)
+{
+    if (width <= 0 || height <= 0)
+    {
+        return false;
+    }
+
+    m_tilesX = (width + TILE_WIDTH - 1) / TILE_WIDTH;
+    m_tilesY = (height + TILE_HEIGHT - 1) / TILE_HEIGHT;
+    m_width = m_tilesX * TILE_WIDTH;
+    m_height = m_tilesY * TILE_HEIGHT;
+
+    m_depth.assign(static_cast<size_t>(m_width) * m_height, 1.0f);
+    m_tileMaxDepth.assign(static_cast<size_t>(m_tilesX) * m_tilesY, 1.0f);
+    return true;
+}
+
+int OcclusionCuller::PixelIndex(int x, int y) const
+{
+    int tile = (y / TILE_HEIGHT) * m_tilesX + (x / TILE_WIDTH);
+    return tile * (TILE_WIDTH * TILE_HEIGHT) + (y % TILE_HEIGHT) * TILE_WIDTH + (x % TILE_WIDTH);
+}
+
+void OcclusionCuller::BeginFrame(const XMMATRIX& viewProjection)
+{
+    PROFILE_FUNCTION();
+
+    m_viewProjection = viewProjection;
+    std::fill(m_depth.begin(), m_depth.end(), 1.0f);
+    std::fill(m_tileMaxDepth.begin(), m_tileMaxDepth.end(), 1.0f);
+    m_stats = OcclusionStats();
+}
+
+void OcclusionCuller::RenderOccluder(const OccluderMesh& occluder, const XMMATRIX& worldMatrix)
+{
+    PROFILE_FUNCTION();
+
+    if (m_depth.empty() || occluder.indices.size() < 3)
+    {
+        return;
+    }
+
+    auto rasterStart = std::chrono::high_resolution_clock::now();
+
+    // Transform all vertices once to screen space (x, y in pixels, z/w, w)
+    XMMATRIX worldViewProjection = XMMatrixMultiply(worldMatrix, m_viewProjection);
+    float halfWidth = m_width * 0.5f;
+    float halfHeight = m_height * 0.5f;
+
+    m_screenVertices.resize(occluder.positions.size());
+    for (size_t i = 0; i < occluder.positions.size(); ++i)
+    {
+        XMVECTOR clip = XMVector3Transform(XMLoadFloat3(&occluder.positions[i]), worldViewProjection);
+        XMFLOAT4 c;
+        XMStoreFloat4(&c, clip);
+
+        if (c.w < MIN_CLIP_W)
+        {
+            // Marked invalid; triangles using it are skipped
+            m_screenVertices[i] = XMFLOAT4(0.0f, 0.0f, 0.0f, -1.0f);
+            continue;
+        }
+
+        float invW = 1.0f / c.w;
+        m_screenVertices[i] = XMFLOAT4((c.x * invW + 1.0f) * halfWidth,
+                                       (1.0f - c.y * invW) * halfHeight,
+                                       c.z * invW,
+                                       c.w);
+    }
+
+    size_t triangleCount = occluder.indices.size() / 3;
+    m_stats.occluderTriangles += static_cast<int>(triangleCount);
+
+    for (size_t t = 0; t < triangleCount; ++t)
+    {
+        const XMFLOAT4& v0 = m_screenVertices[occluder.indices[t * 3 + 0]];
+        const XMFLOAT4& v1 = m_screenVertices[occluder.indices[t * 3 + 1]];
+        const XMFLOAT4& v2 = m_screenVertices[occluder.indices[t * 3 + 2]];
+
+        if (v0.w < 0.0f || v1.w < 0.0f || v2.w < 0.0f)
+        {
+            continue;
+        }
+
+        RasterizeTriangle(v0, v1, v2);
+    }
+
+    auto rasterEnd = std::chrono::high_resolution_clock::now();
+    m_stats.rasterTimeMs += std::chrono::duration<double, std::milli>(rasterEnd - rasterStart).count();
+}
+
+void OcclusionCuller::RasterizeTriangle(const XMFLOAT4& v0, const XMFLOAT4& v1, const XMFLOAT4& v2)
+{
+    float area = (v1.x - v0.x) * (v2.y - v0.y) - (v2.x - v0.x) * (v1.y - v0.y);
+    if (std::fabs(area) < 1e-8f)
+    {
+        return;
+    }
+
+    // Pixel bounds, clipped to the buffer; x starts on a 4-pixel boundary
+    int minX = std::max(0, static_cast<int>(std::floor(std::min(v0.x, std::min(v1.x, v2.x)))));
+    int maxX = std::min(m_width - 1, static_cast<int>(std::ceil(std::max(v0.x, std::max(v1.x, v2.x)))));
+    int minY = std::max(0, static_cast<int>(std::floor(std::min(v0.y, std::min(v1.y, v2.y)))));
+    int maxY = std::min(m_height - 1, static_cast<int>(std::ceil(std::max(v0.y, std::max(v1.y, v2.y)))));
+    if (minX > maxX || minY > maxY)
+    {
+        return;
+    }
+    minX &= ~3;
+
+    m_stats.rasterizedTriangles++;
+
+    // Edge functions oriented so the interior is positive for either winding
+    float sign = area > 0.0f ? 1.0f : -1.0f;
+    float a0 = (v1.y - v2.y) * sign, b0 = (v2.x - v1.x) * sign, c0 = (v1.x * v2.y - v1.y * v2.x) * sign;
+    float a1 = (v2.y - v0.y) * sign, b1 = (v0.x - v2.x) * sign, c1 = (v2.x * v0.y - v2.y * v0.x) * sign;
+    float a2 = (v0.y - v1.y) * sign, b2 = (v1.x - v0.x) * sign, c2 = (v0.x * v1.y - v0.y * v1.x) * sign;
+
+    // Depth is affine in screen space: z = zA * x + zB * y + zC
+    float invArea = 1.0f / area;
+    float zA = ((v1.y - v2.y) * v0.z + (v2.y - v0.y) * v1.z + (v0.y - v1.y) * v2.z) * invArea;
+    float zB = ((v2.x - v1.x) * v0.z + (v0.x - v2.x) * v1.z + (v1.x - v0.x) * v2.z) * invArea;
+    float zC = v0.z - zA * v0.x - zB * v0.y;
+
+    XMVECTOR laneOffsets = XMVectorSet(0.5f, 1.5f, 2.5f, 3.5f);
+    XMVECTOR edgeA0 = XMVectorReplicate(a0);
+    XMVECTOR edgeA1 = XMVectorReplicate(a1);
+    XMVECTOR edgeA2 = XMVectorReplicate(a2);
+    XMVECTOR depthA = XMVectorReplicate(zA);
+    XMVECTOR zero = XMVectorZero();
+    XMVECTOR one = XMVectorSplatOne();
+
+    for (int y = minY; y <= maxY; ++y)
+    {
+        float py = y + 0.5f;
+        XMVECTOR rowE0 = XMVectorReplicate(b0 * py + c0);
+        XMVECTOR rowE1 = XMVectorReplicate(b1 * py + c1);
+        XMVECTOR rowE2 = XMVectorReplicate(b2 * py + c2);
+        XMVECTOR rowZ = XMVectorReplicate(zB * py + zC);
+
+        for (int x = minX; x <= maxX; x += 4)
+        {
+            XMVECTOR px = XMVectorAdd(XMVectorReplicate(static_cast<float>(x)), laneOffsets);
+
+            XMVECTOR e0 = XMVectorMultiplyAdd(edgeA0, px, rowE0);
+            XMVECTOR e1 = XMVectorMultiplyAdd(edgeA1, px, rowE1);
+            XMVECTOR e2 = XMVectorMultiplyAdd(edgeA2, px, rowE2);
+
+            XMVECTOR inside = XMVectorAndInt(XMVectorGreaterOrEqual(e0, zero),
+                              XMVectorAndInt(XMVectorGreaterOrEqual(e1, zero),
+                                             XMVectorGreaterOrEqual(e2, zero)));
+
+            uint32_t laneMask[4];
+            XMStoreInt4(laneMask, inside);
+            if ((laneMask[0] | laneMask[1] | laneMask[2] | laneMask[3]) == 0)
+            {
+                continue;
+            }
+
+            XMVECTOR depth = XMVectorClamp(XMVectorMultiplyAdd(depthA, px, rowZ), zero, one);
+
+            // Four lanes starting at a multiple of 4 are contiguous within a tile row
+            XMFLOAT4* target = reinterpret_cast<XMFLOAT4*>(&m_depth[PixelIndex(x, y)]);
+            XMVECTOR current = XMLoadFloat4(target);
+            XMStoreFloat4(target, XMVectorSelect(current, XMVectorMin(current, depth), inside));
+        }
+    }
+}
+
+void OcclusionCuller::FinalizeOccluders()
+{
+    PROFILE_FUNCTION();
+
+    // Farthest depth per tile: a box nearer than this everywhere is not hidden by the tile
+    const int tileSize = TILE_WIDTH * TILE_HEIGHT;
+    for (size_t tile = 0; tile < m_tileMaxDepth.size(); ++tile)
+    {
+        const float* pixels = &m_depth[tile * tileSize];
+        XMVECTOR tileMax = XMLoadFloat4(reinterpret_cast<const XMFLOAT4*>(pixels));
+        for (int i = 4; i < tileSize; i += 4)
+        {
+            tileMax = XMVectorMax(tileMax, XMLoadFloat4(reinterpret_cast<const XMFLOAT4*>(pixels + i)));
+        }
+
+        XMFLOAT4 lanes;
+        XMStoreFloat4(&lanes, tileMax);
+        m_tileMaxDepth[tile] = std::max(std::max(lanes.x, lanes.y), std::max(lanes.z, lanes.w));
+    }
+}
+
+bool OcclusionCuller::TestBox(const XMFLOAT3& min, const XMFLOAT3& max) const
+{
+    // Project the eight corners and take the screen rectangle and nearest depth
+    float rectMinX = FLT_MAX, rectMinY = FLT_MAX, rectMaxX = -FLT_MAX, rectMaxY = -FLT_MAX;
+    float nearestDepth = FLT_MAX;
+
+    for (int corner = 0; corner < 8; ++corner)
+    {
+        XMVECTOR position = XMVectorSet((corner & 1) ? max.x : min.x,
+                                        (corner & 2) ? max.y : min.y,
+                                        (corner & 4) ? max.z : min.z, 1.0f);
+        XMFLOAT4 c;
+        XMStoreFloat4(&c, XMVector4Transform(position, m_viewProjection));
+
+        if (c.w < MIN_CLIP_W)
+        {
+            return true;
+        }
+
+        float invW = 1.0f / c.w;
+        float sx = (c.x * invW + 1.0f) * m_width * 0.5f;
+        float sy = (1.0f - c.y * invW) * m_height * 0.5f;
+        rectMinX = std::min(rectMinX, sx);
+        rectMaxX = std::max(rectMaxX, sx);
+        rectMinY = std::min(rectMinY, sy);
+        rectMaxY = std::max(rectMaxY, sy);
+        nearestDepth = std::min(nearestDepth, c.z * invW);
+    }
+
+    int x0 = std::max(0, static_cast<int>(std::floor(rectMinX)));
+    int x1 = std::min(m_width - 1, static_cast<int>(std::ceil(rectMaxX)));
+    int y0 = std::max(0, static_cast<int>(std::floor(rectMinY)));
+    int y1 = std::min(m_height - 1, static_cast<int>(std::ceil(rectMaxY)));
+    if (x0 > x1 || y0 > y1)
+    {
+        // Off screen: leave the decision to frustum culling
+        return true;
+    }
+
+    for (int ty = y0 / TILE_HEIGHT; ty <= y1 / TILE_HEIGHT; ++ty)
+    {
+        for (int tx = x0 / TILE_WIDTH; tx <= x1 / TILE_WIDTH; ++tx)
+        {
+            if (nearestDepth > m_tileMaxDepth[ty * m_tilesX + tx])
+            {
+                continue;
+            }
+
+            // Tile inconclusive: check the covered pixels of this tile
+            int px0 = std::max(x0, tx * TILE_WIDTH);
+            int px1 = std::min(x1, tx * TILE_WIDTH + TILE_WIDTH - 1);
+            int py0 = std::max(y0, ty * TILE_HEIGHT);
+            int py1 = std::min(y1, ty * TILE_HEIGHT + TILE_HEIGHT - 1);
+            for (int py = py0; py <= py1; ++py)
+            {
+                for (int px = px0; px <= px1; ++px)
+                {
+                    if (nearestDepth <= m_depth[PixelIndex(px, py)])
+                    {
+                        return true;
+                    }
+                }
+            }
+        }
+    }
+
+    return false;
+}
+
+bool OcclusionCuller::IsVisible(const XMFLOAT3& min, const XMFLOAT3& max)
+{
+    bool visible = TestBox(min, max);
+    m_stats.testedBoxes++;
+    if (!visible)
+    {
+        m_stats.occludedBoxes++;
+    }
+    return visible;
+}
+
+size_t OcclusionCuller::FilterVisible(const CullingBoxes& boxes, const std::vector<uint32_t>& candidates,
+                                      std::vector<uint32_t>& visible)
+{
+    PROFILE_FUNCTION();
+
+    auto testStart = std::chrono::high_resolution_clock::now();
+    size_t startSize = visible.size();
+
+    for (uint32_t index : candidates)
+    {
+        XMFLOAT3 min(boxes.centerX[index] - boxes.extentX[index],
+                     boxes.centerY[index] - boxes.extentY[index],
+                     boxes.centerZ[index] - boxes.extentZ[index]);
+        XMFLOAT3 max(boxes.centerX[index] + boxes.extentX[index],
+                     boxes.centerY[index] + boxes.extentY[index],
+                     boxes.centerZ[index] + boxes.extentZ[index]);
+
+        if (IsVisible(min, max))
+        {
+            visible.push_back(index);
+        }
+    }
+
+    auto testEnd = std::chrono::high_resolution_clock::now();
+    m_stats.testTimeMs += std::chrono::duration<double, std::milli>(testEnd - testStart).count();
+    return visible.size() - startSize;
+}
+
+OccluderMesh OcclusionCuller::CreateBoxOccluder(const XMFLOAT3& min, const XMFLOAT3& max)
+{
+    OccluderMesh box;
+    for (int corner = 0; corner < 8; ++corner)
+    {
+        box.positions.push_back(XMFLOAT3((corner & 1) ? max.x : min.x,
+                                         (corner & 2) ? max.y : min.y,
+                                         (corner & 4) ? max.z : min.z));
+    }
+
+    // Two triangles per face; winding does not matter to the rasterizer
+    const uint32_t faces[36] =
+    {
+        0, 2, 3,  0, 3, 1,   // -Z
+        4, 5, 7,  4, 7, 6,   // +Z
+        0, 4, 6,  0, 6, 2,   // -X
+        1, 3, 7,  1, 7, 5,   // +X
+        0, 1, 5,  0, 5, 4,   // -Y
+        2, 6, 7,  2, 7, 3    // +Y
+    };
+    box.indices.assign(faces, faces + 36);
+    return box;
+}
@@ -0,0 +1,102 @@
+#pragma once
+
+#include <DirectXMath.h>
+#include <vector>
+#include <cstdint>
+
+using namespace DirectX;
+
+struct CullingBoxes;
+
+// Simplified geometry rendered into the occlusion buffer. Built from
+// Mesh::CreateOccluder() or from a proxy such as CreateBoxOccluder().
+struct OccluderMesh
+{
+    std::vector<XMFLOAT3> positions;
+    std::vector<uint32_t> indices;
+
+    size_t GetTriangleCount() const { return indices.size() / 3; }
+};
+
+// Per-frame occlusion statistics
+struct OcclusionStats
+{
+    int occluderTriangles;
+    int rasterizedTriangles;
+    int testedBoxes;
+    int occludedBoxes;
+    double rasterTimeMs;
+    double testTimeMs;
+
+    OcclusionStats()
+        : occluderTriangles(0)
+        , rasterizedTriangles(0)
+        , testedBoxes(0)
+        , occludedBoxes(0)
+        , rasterTimeMs(0.0)
+        , testTimeMs(0.0)
+    {
+    }
+
+    float GetOccludedFraction() const { return testedBoxes > 0 ? static_cast<float>(occludedBoxes) / testedBoxes : 0.0f; }
+};
+
+// CPU software occlusion culling.
+//
+// Occluders are rasterized four pixels at a time into a low resolution depth
+// buffer stored in 8x4 pixel tiles. FinalizeOccluders() then keeps the
+// farthest depth of each tile, and occludee boxes are tested against those
+// tile values first and against individual pixels only where a tile is
+// inconclusive. Depth follows the D3D convention (0 near, 1 far).
+//
+// The test is conservative: triangles crossing the near plane are skipped and
+// boxes crossing it are reported visible.
+class OcclusionCuller
+{
+public:
+    static const int TILE_WIDTH = 8;
+    static const int TILE_HEIGHT = 4;
+
+    OcclusionCuller();
+    ~OcclusionCuller();
+
+    // Width and height are rounded up to whole tiles
+    bool Initialize(int width = 256, int height = 128);
+
+    // Frame
+    void BeginFrame(const XMMATRIX& viewProjection);
+    void RenderOccluder(const OccluderMesh& occluder, const XMMATRIX& worldMatrix);
+    void FinalizeOccluders();
+
+    // Occludee tests on world-space boxes
+    bool IsVisible(const XMFLOAT3& min, const XMFLOAT3& max);
+    size_t FilterVisible(const CullingBoxes& boxes, const std::vector<uint32_t>& candidates,
+                         std::vector<uint32_t>& visible);
+
+    // Occluder helpers
+    static OccluderMesh CreateBoxOccluder(const XMFLOAT3& min, const XMFLOAT3& max);
+
+    // Information
+    int GetWidth() const { return m_width; }
+    int GetHeight() const { return m_height; }
+    float GetDepth(int x, int y) const { return m_depth[PixelIndex(x, y)]; }
+    const OcclusionStats& GetStats() const { return m_stats; }
+
+private:
+    int PixelIndex(int x, int y) const;
+    void RasterizeTriangle(const XMFLOAT4& v0, const XMFLOAT4& v1, const XMFLOAT4& v2);
+    bool TestBox(const XMFLOAT3& min, const XMFLOAT3& max) const;
+
+private:
+    int m_width;
+    int m_height;
+    int m_tilesX;
+    int m_tilesY;
+
+    std::vector<float> m_depth;       // Tile-major, TILE_WIDTH * TILE_HEIGHT floats per tile
+    std::vector<float> m_tileMaxDepth;
+    std::vector<XMFLOAT4> m_screenVertices;
+
+    XMMATRIX m_viewProjection;
+    OcclusionStats m_stats;
+};
@@ -0,0 +1,214 @@
+#include "ParallelCommandRecorder.h"
+#include "../Resources/Mesh.h"
+#include "../Resources/Material.h"
+#include "../Engine/Profiler.h"
+#include <iostream>
+#include <algorithm>
+#include <chrono>
+
+ParallelCommandRecorder::ParallelCommandRecorder()
+    : m_device(nullptr)
+    , m_mode(RecordingMode::CommandLists)
+    , m_batches(nullptr)
+    , m_instanceBuffer(nullptr)
+    , m_instanceStride(0)
+    , m_frameBuffer(nullptr)
+    , m_activeSlices(0)
+{
+    m_recordFunction = [this](int sliceIndex, size_t firstBatch, size_t batchCount)
+    {
+        RecordSlice(sliceIndex, firstBatch, batchCount);
+    };
+}
+
+ParallelCommandRecorder::~ParallelCommandRecorder()
+{
+    Shutdown();
+}
+
+bool ParallelCommandRecorder::Initialize(ID3D11Device* device, int workerCount, RecordingMode mode)
+{
+    if (!device)
+    {
+        return false;
+    }
+
+    m_device = device;
+    m_mode = mode;
+
+    if (workerCount <= 0)
+    {
+        int hardwareThreads = static_cast<int>(std::thread::hardware_concurrency());
+        workerCount = std::max(1, hardwareThreads - 1);
+    }
+
+    m_slices.resize(workerCount + 1);
+
+    if (m_mode == RecordingMode::DeferredContexts)
+    {
+        for (Slice& slice : m_slices)
+        {
+            HRESULT hr = device->CreateDeferredContext(0, &slice.deferredContext);
+            if (FAILED(hr))
+            {
+                // Single-threaded devices cannot create deferred contexts
+                std::cerr << "ParallelCommandRecorder: Deferred contexts unavailable, using CPU command lists" << std::endl;
+                for (Slice& created : m_slices)
+                {
+                    if (created.deferredContext)
+                    {
+                        created.deferredContext->Release();
+                        created.deferredContext = nullptr;
+                    }
+                }
+                m_mode = RecordingMode::CommandLists;
+                break;
+            }
+        }
+    }
+
+    m_sliceRecorder.Initialize(workerCount);
+
+    std::cout << "ParallelCommandRecorder initialized with " << m_slices.size() << " recording threads ("
+              << (m_mode == RecordingMode::DeferredContexts ? "deferred contexts" : "command lists") << ")" << std::endl;
+    return true;
+}
+
+void ParallelCommandRecorder::Shutdown()
+{
+    m_sliceRecorder.Shutdown();
+
+    for (Slice& slice : m_slices)
+    {
+        if (slice.recordedList)
+        {
+            slice.recordedList->Release();
+            slice.recordedList = nullptr;
+        }
+
+        if (slice.deferredContext)
+        {
+            slice.deferredContext->Release();
+            slice.deferredContext = nullptr;
+        }
+    }
+    m_slices.clear();
+
+    m_device = nullptr;
+}
+
+void ParallelCommandRecorder::Record(const std::vector<DrawBatch>& batches, ID3D11Buffer* instanceBuffer,
+                                     UINT instanceStride, ID3D11Buffer* frameBuffer)
+{
+    PROFILE_FUNCTION();
+
+    if (m_slices.empty())
+    {
+        return;
+    }
+
+    auto recordStart = std::chrono::high_resolution_clock::now();
+
+    m_batches = &batches;
+    m_instanceBuffer = instanceBuffer;
+    m_instanceStride = instanceStride;
+    m_frameBuffer = frameBuffer;
+
+    // Sized for every thread until the recorder has picked the slice count
+    m_stats.sliceTimeMs.assign(m_slices.size(), 0.0);
+    m_activeSlices = m_sliceRecorder.Record(batches.size(), m_recordFunction);
+    m_stats.sliceCount = m_activeSlices;
+    m_stats.sliceTimeMs.resize(m_activeSlices);
+
+    auto recordEnd = std::chrono::high_resolution_clock::now();
+    m_stats.recordTimeMs = std::chrono::duration<double, std::milli>(recordEnd - recordStart).count();
+}
+
+void ParallelCommandRecorder::Submit(ID3D11DeviceContext* immediateContext)
+{
+    PROFILE_FUNCTION();
+
+    if (!immediateContext)
+    {
+        return;
+    }
+
+    auto submitStart = std::chrono::high_resolution_clock::now();
+
+    // Submission order equals slice order, which equals the sorted batch order
+    for (int i = 0; i < m_activeSlices; ++i)
+    {
+        Slice& slice = m_slices[i];
+
+        if (m_mode == RecordingMode::DeferredContexts)
+        {
+            if (slice.recordedList)
+            {
+                // TRUE restores the immediate context's state after the list, so
+                // passes drawn after Submit keep their targets and shaders. The
+                // save and restore is paid once per slice, not per draw.
+                immediateContext->ExecuteCommandList(slice.recordedList, TRUE);
+                slice.recordedList->Release();
+                slice.recordedList = nullptr;
+            }
+        }
+        else
+        {
+            slice.commandList.Execute(immediateContext);
+        }
+    }
+
+    auto submitEnd = std::chrono::high_resolution_clock::now();
+    m_stats.submitTimeMs = std::chrono::duration<double, std::milli>(submitEnd - submitStart).count();
+}
+
+void ParallelCommandRecorder::RecordSlice(int sliceIndex, size_t firstBatch, size_t batchCount)
+{
+    PROFILE_FUNCTION();
+
+    auto sliceStart = std::chrono::high_resolution_clock::now();
+
+    Slice& slice = m_slices[sliceIndex];
+    const std::vector<DrawBatch>& batches = *m_batches;
+    size_t endBatch = firstBatch + batchCount;
+
+    if (m_mode == RecordingMode::DeferredContexts)
+    {
+        ID3D11DeviceContext* context = slice.deferredContext;
+
+        if (m_stateSetupFunction)
+        {
+            m_stateSetupFunction(context);
+        }
+        context->VSSetConstantBuffers(0, 1, &m_frameBuffer);
+
+        Material* currentMaterial = nullptr;
+        for (size_t i = firstBatch; i < endBatch; ++i)
+        {
+            const DrawBatch& batch = batches[i];
+            if (batch.material && batch.material != currentMaterial)
+            {
+                batch.material->Bind(context);
+                currentMaterial = batch.material;
+            }
+
+            batch.mesh->RenderInstanced(context, m_instanceBuffer, m_instanceStride,
+                                        static_cast<int>(batch.instanceCount),
+                                        static_cast<int>(batch.firstInstance));
+        }
+
+        HRESULT hr = context->FinishCommandList(FALSE, &slice.recordedList);
+        if (FAILED(hr))
+        {
+            std::cerr << "ParallelCommandRecorder: FinishCommandList failed for slice " << sliceIndex << std::endl;
+            slice.recordedList = nullptr;
+        }
+    }
+    else
+    {
+        slice.commandList.RecordBatches(batches, firstBatch, endBatch, m_instanceBuffer, m_instanceStride, m_frameBuffer);
+    }
+
+    auto sliceEnd = std::chrono::high_resolution_clock::now();
+    m_stats.sliceTimeMs[sliceIndex] = std::chrono::duration<double, std::milli>(sliceEnd - sliceStart).count();
+}
@@ -0,0 +1,102 @@
+#pragma once
+
+#include <d3d11.h>
+#include <vector>
+#include <functional>
+#include "RenderCommandList.h"
+#include "RenderQueue.h"
+#include "SliceRecorder.h"
+
+// How worker threads record their slice of the frame
+enum class RecordingMode
+{
+    CommandLists,       // CPU RenderCommandList per thread, replayed on the immediate context
+    DeferredContexts    // ID3D11DeviceContext per thread, FinishCommandList/ExecuteCommandList
+};
+
+// Timing of the last recorded frame
+struct RecordingStats
+{
+    int sliceCount;
+    double recordTimeMs;                 // Wall time of Record()
+    double submitTimeMs;                 // Wall time of Submit()
+    std::vector<double> sliceTimeMs;     // Recording time of each slice
+
+    RecordingStats()
+        : sliceCount(0)
+        , recordTimeMs(0.0)
+        , submitTimeMs(0.0)
+    {
+    }
+};
+
+// Splits the sorted batch list produced by RenderQueue into contiguous slices,
+// records each slice on its own thread and submits the results on the main
+// thread in slice order, so the GPU sees exactly the single-threaded sequence.
+// The threads are a SliceRecorder: the main thread records slice 0 itself
+// while the workers record the rest.
+class ParallelCommandRecorder
+{
+public:
+    ParallelCommandRecorder();
+    ~ParallelCommandRecorder();
+
+    // Initialization. workerCount <= 0 uses hardware_concurrency - 1.
+    // Falls back to CommandLists if deferred contexts cannot be created.
+    bool Initialize(ID3D11Device* device, int workerCount = 0,
+                    RecordingMode mode = RecordingMode::DeferredContexts);
+    void Shutdown();
+
+    // Deferred contexts start every command list with default state, so the
+    // caller must re-bind shaders, input layout, render targets and viewport here
+    void SetStateSetupFunction(std::function<void(ID3D11DeviceContext*)> stateSetupFunction) { m_stateSetupFunction = stateSetupFunction; }
+
+    // Slices smaller than this are not worth a thread hand-off
+    void SetMinBatchesPerSlice(int minBatches) { m_sliceRecorder.SetMinBatchesPerSlice(minBatches); }
+
+    // Frame recording. Materials must already be prepared on the immediate context.
+    void Record(const std::vector<DrawBatch>& batches, ID3D11Buffer* instanceBuffer,
+                UINT instanceStride, ID3D11Buffer* frameBuffer);
+    void Submit(ID3D11DeviceContext* immediateContext);
+
+    // Information
+    RecordingMode GetMode() const { return m_mode; }
+    int GetThreadCount() const { return static_cast<int>(m_slices.size()); }
+    const RecordingStats& GetStats() const { return m_stats; }
+    const RenderCommandList& GetCommandList(int slice) const { return m_slices[slice].commandList; }
+
+private:
+    struct Slice
+    {
+        RenderCommandList commandList;
+        ID3D11DeviceContext* deferredContext;
+        ID3D11CommandList* recordedList;
+
+        Slice()
+            : deferredContext(nullptr)
+            , recordedList(nullptr)
+        {
+        }
+    };
+
+    void RecordSlice(int sliceIndex, size_t firstBatch, size_t batchCount);
+
+private:
+    ID3D11Device* m_device;
+    RecordingMode m_mode;
+    std::function<void(ID3D11DeviceContext*)> m_stateSetupFunction;
+
+    // One slice per thread, indexed like the SliceRecorder slices
+    std::vector<Slice> m_slices;
+    SliceRecorder m_sliceRecorder;
+    SliceRecorder::RecordFunction m_recordFunction;
+
+    // Frame inputs shared with the workers
+    const std::vector<DrawBatch>* m_batches;
+    ID3D11Buffer* m_instanceBuffer;
+    UINT m_instanceStride;
+    ID3D11Buffer* m_frameBuffer;
+    int m_activeSlices;
+
+    RecordingStats m_stats;
+};
@@ -1,102 +1,137 @@
 #include "PostProcess.h"
+#include "PostProcessFusion.h"
+#include "AutoExposure.h"
 #include "Shader.h"
-#include "../Resources/Texture.h"
+#include "../Engine/Profiler.h"
+#include "../Engine/Memory.h"
 #include <iostream>
 #include <algorithm>
+#include <cstring>
 
 // Post-process effect shaders as strings
 namespace PostProcessShaders
 {
-    const char* FULLSCREEN_QUAD_VS = R"(
-struct VSInput
+    const char* COMMON = R"(
+Texture2D inputTexture : register(t0);
+Texture2D secondTexture : register(t1);
+SamplerState linearSampler : register(s0);
+
+cbuffer PostProcessConstants : register(b0)
 {
-    float4 position : POSITION;
-    float2 texCoord : TEXCOORD0;
+    float2 texelSize;
+    float intensity;
+    float threshold;
+
+    float bloomThreshold;
+    float bloomIntensity;
+    float exposure;
+    float whitePoint;
+
+    float vignetteRadius;
+    float vignetteSoftness;
+    float blurRadius;
+    float exposureKey;
+
+    float3 vignetteColor;
+    float padding1;
+
+    float3 colorTint;
+    float contrast;
+
+    float brightness;
+    float saturation;
+    float gamma;
+    float padding2;
 };
 
-struct VSOutput
+struct PSInput
 {
     float4 position : SV_POSITION;
     float2 texCoord : TEXCOORD0;
 };
 
-VSOutput main(VSInput input)
+// 13 taps of the input: a 3x3 grid two texels apart and a 2x2 box one
+// texel apart, weighted so each 4x4 block counts once (bloom pyramid)
+float4 Downsample13(float2 uv)
 {
-    VSOutput output;
-    output.position = input.position;
-    output.texCoord = input.texCoord;
-    return output;
+    float2 t = texelSize;
+
+    float4 corners = inputTexture.Sample(linearSampler, uv + t * float2(-2, -2)) +
+                     inputTexture.Sample(linearSampler, uv + t * float2(2, -2)) +
+                     inputTexture.Sample(linearSampler, uv + t * float2(-2, 2)) +
+                     inputTexture.Sample(linearSampler, uv + t * float2(2, 2));
+    float4 edges = inputTexture.Sample(linearSampler, uv + t * float2(0, -2)) +
+                   inputTexture.Sample(linearSampler, uv + t * float2(-2, 0)) +
+                   inputTexture.Sample(linearSampler, uv + t * float2(2, 0)) +
+                   inputTexture.Sample(linearSampler, uv + t * float2(0, 2));
+    float4 inner = inputTexture.Sample(linearSampler, uv + t * float2(-1, -1)) +
+                   inputTexture.Sample(linearSampler, uv + t * float2(1, -1)) +
+                   inputTexture.Sample(linearSampler, uv + t * float2(-1, 1)) +
+                   inputTexture.Sample(linearSampler, uv + t * float2(1, 1));
+    float4 center = inputTexture.Sample(linearSampler, uv);
+
+    return center * 0.125 + corners * 0.03125 + edges * 0.0625 + inner * 0.125;
 }
 )";
 
-    const char* COPY_PS = R"(
-Texture2D inputTexture : register(t0);
-SamplerState linearSampler : register(s0);
-
-struct PSInput
+    // One triangle covering the screen, generated from the vertex index:
+    // (-1, 1), (3, 1), (-1, -3) with texture coordinates (0, 0), (2, 0), (0, 2)
+    const char* FULLSCREEN_TRIANGLE_VS = R"(
+struct VSOutput
 {
     float4 position : SV_POSITION;
     float2 texCoord : TEXCOORD0;
 };
 
-float4 main(PSInput input) : SV_TARGET
+VSOutput main(uint vertexID : SV_VertexID)
 {
-    return inputTexture.Sample(linearSampler, input.texCoord);
+    VSOutput output;
+    output.texCoord = float2((vertexID << 1) & 2, vertexID & 2);
+    output.position = float4(output.texCoord * float2(2.0, -2.0) + float2(-1.0, 1.0), 0.0, 1.0);
+    return output;
 }
 )";
 
-    const char* GRAYSCALE_PS = R"(
-Texture2D inputTexture : register(t0);
-SamplerState linearSampler : register(s0);
-
-cbuffer PostProcessParams : register(b0)
+    const char* COPY_PS = R"(
+float4 main(PSInput input) : SV_TARGET
 {
-    float intensity;
-    float3 padding;
-};
+    return inputTexture.Sample(linearSampler, input.texCoord);
+}
+)";
 
-struct PSInput
+    // Separable pass with linearly merged taps (see PostProcessKernels);
+    // the tap array size must match MAX_BLUR_TAPS
+    const char* BLUR_PS = R"(
+cbuffer BlurConstants : register(b1)
 {
-    float4 position : SV_POSITION;
-    float2 texCoord : TEXCOORD0;
+    float4 blurTaps[9];     // x: offset in steps, y: weight
+    float2 blurStep;
+    int blurTapCount;
+    float blurPadding;
 };
 
 float4 main(PSInput input) : SV_TARGET
 {
-    float4 color = inputTexture.Sample(linearSampler, input.texCoord);
-    float gray = dot(color.rgb, float3(0.299, 0.587, 0.114));
-    color.rgb = lerp(color.rgb, float3(gray, gray, gray), intensity);
+    float4 color = inputTexture.Sample(linearSampler, input.texCoord) * blurTaps[0].y;
+
+    for (int i = 1; i < blurTapCount; ++i)
+    {
+        float2 offset = blurStep * blurTaps[i].x;
+        color += (inputTexture.Sample(linearSampler, input.texCoord + offset) +
+                  inputTexture.Sample(linearSampler, input.texCoord - offset)) * blurTaps[i].y;
+    }
+
     return color;
 }
 )";
 
-    const char* BLOOM_PS = R"(
-Texture2D inputTexture : register(t0);
-SamplerState linearSampler : register(s0);
-
-cbuffer BloomParams : register(b0)
-{
-    float bloomThreshold;
-    float bloomIntensity;
-    float2 padding;
-};
-
-struct PSInput
-{
-    float4 position : SV_POSITION;
-    float2 texCoord : TEXCOORD0;
-};
-
+    const char* BLOOM_BRIGHT_PASS_PS = R"(
 float4 main(PSInput input) : SV_TARGET
 {
-    float4 color = inputTexture.Sample(linearSampler, input.texCoord);
+    float4 color = Downsample13(input.texCoord);
     float brightness = dot(color.rgb, float3(0.2126, 0.7152, 0.0722));
 
-    if (brightness > bloomThreshold)
-    {
-        color.rgb *= bloomIntensity;
-    }
-    else
+    if (brightness <= bloomThreshold)
     {
         color.rgb = float3(0, 0, 0);
     }
@@ -105,117 +140,211 @@ float4 main(PSInput input) : SV_TARGET
 }
 )";
 
-    const char* GAUSSIAN_BLUR_PS = R"(
-Texture2D inputTexture : register(t0);
-SamplerState linearSampler : register(s0);
-
-cbuffer BlurParams : register(b0)
+    const char* BLOOM_DOWNSAMPLE_PS = R"(
+float4 main(PSInput input) : SV_TARGET
 {
-    float2 texelSize;
-    float blurRadius;
-    float padding;
-};
+    return Downsample13(input.texCoord);
+}
+)";
 
-struct PSInput
+    // Tent filter of the lower level (t0) added to this level's mip (t1)
+    const char* BLOOM_UPSAMPLE_PS = R"(
+float4 main(PSInput input) : SV_TARGET
 {
-    float4 position : SV_POSITION;
-    float2 texCoord : TEXCOORD0;
-};
+    float2 step = texelSize * blurRadius;
+
+    float4 color = inputTexture.Sample(linearSampler, input.texCoord) * 4.0;
+    color += (inputTexture.Sample(linearSampler, input.texCoord + float2(0, -step.y)) +
+              inputTexture.Sample(linearSampler, input.texCoord + float2(-step.x, 0)) +
+              inputTexture.Sample(linearSampler, input.texCoord + float2(step.x, 0)) +
+              inputTexture.Sample(linearSampler, input.texCoord + float2(0, step.y))) * 2.0;
+    color += inputTexture.Sample(linearSampler, input.texCoord + float2(-step.x, -step.y)) +
+             inputTexture.Sample(linearSampler, input.texCoord + float2(step.x, -step.y)) +
+             inputTexture.Sample(linearSampler, input.texCoord + float2(-step.x, step.y)) +
+             inputTexture.Sample(linearSampler, input.texCoord + float2(step.x, step.y));
+
+    return secondTexture.Sample(linearSampler, input.texCoord) + color / 16.0;
+}
+)";
 
+    const char* BLOOM_COMBINE_PS = R"(
 float4 main(PSInput input) : SV_TARGET
 {
-    float4 color = float4(0, 0, 0, 0);
-    float totalWeight = 0;
-
-    for (int i = -4; i <= 4; ++i)
-    {
-        for (int j = -4; j <= 4; ++j)
-        {
-            float2 offset = float2(i, j) * texelSize * blurRadius;
-            float weight = exp(-(i*i + j*j) / (2.0 * 2.0 * 2.0));
-
-            color += inputTexture.Sample(linearSampler, input.texCoord + offset) * weight;
-            totalWeight += weight;
-        }
-    }
+    float4 scene = inputTexture.Sample(linearSampler, input.texCoord);
+    float3 bloom = secondTexture.Sample(linearSampler, input.texCoord).rgb;
 
-    return color / totalWeight;
+    scene.rgb += bloom * bloomIntensity;
+    return scene;
 }
 )";
 
-    const char* TONE_MAPPING_PS = R"(
-Texture2D inputTexture : register(t0);
-SamplerState linearSampler : register(s0);
+    const char* AUTO_EXPOSURE_COMMON = R"(
+RWStructuredBuffer<uint> histogram : register(u0);
 
-cbuffer ToneMappingParams : register(b0)
+cbuffer AutoExposureConstants : register(b0)
 {
-    float exposure;
-    float whitePoint;
-    float2 padding;
+    uint inputWidth;
+    uint inputHeight;
+    float minLogLuminance;
+    float inverseLogLuminanceRange;
+
+    float logLuminanceRange;
+    float adaptationRate;
+    float pixelCount;
+    float padding;
 };
+)";
 
-struct PSInput
-{
-    float4 position : SV_POSITION;
-    float2 texCoord : TEXCOORD0;
-};
+    // One 256-bin histogram per 16x16 group in groupshared memory, then one
+    // global atomic per bin and group; must match AutoExposure::GetHistogramBin
+    const char* LUMINANCE_HISTOGRAM_CS = R"(
+Texture2D inputTexture : register(t0);
 
-float4 main(PSInput input) : SV_TARGET
+groupshared uint localBins[256];
+
+uint GetHistogramBin(float3 color)
 {
-    float4 color = inputTexture.Sample(linearSampler, input.texCoord);
+    float luminance = dot(color, float3(0.2126, 0.7152, 0.0722));
+    if (luminance < 0.0001)
+    {
+        return 0;
+    }
 
-    // Apply exposure
-    color.rgb *= exposure;
+    float position = saturate((log2(luminance) - minLogLuminance) * inverseLogLuminanceRange);
+    return (uint)(position * 254.0 + 1.0);
+}
 
-    // Reinhard tone mapping
-    color.rgb = color.rgb / (color.rgb + whitePoint);
+[numthreads(16, 16, 1)]
+void main(uint groupIndex : SV_GroupIndex, uint3 pixel : SV_DispatchThreadID)
+{
+    localBins[groupIndex] = 0;
+    GroupMemoryBarrierWithGroupSync();
 
-    // Gamma correction
-    color.rgb = pow(color.rgb, 1.0 / 2.2);
+    if (pixel.x < inputWidth && pixel.y < inputHeight)
+    {
+        uint bin = GetHistogramBin(inputTexture.Load(int3(pixel.xy, 0)).rgb);
+        InterlockedAdd(localBins[bin], 1);
+    }
+    GroupMemoryBarrierWithGroupSync();
 
-    return color;
+    if (localBins[groupIndex] > 0)
+    {
+        InterlockedAdd(histogram[groupIndex], localBins[groupIndex]);
+    }
 }
 )";
 
-    const char* VIGNETTE_PS = R"(
-Texture2D inputTexture : register(t0);
-SamplerState linearSampler : register(s0);
-
-cbuffer VignetteParams : register(b0)
-{
-    float vignetteRadius;
-    float vignetteSoftness;
-    float2 padding;
-};
+    // Tree reduction of the count-weighted bins to the mean bin, converted
+    // back to luminance and blended into the adapted value; must match
+    // AutoExposure::GetAverageLuminance and AutoExposure::Adapt
+    const char* LUMINANCE_AVERAGE_CS = R"(
+RWTexture2D<float> adaptedLuminance : register(u1);
 
-struct PSInput
-{
-    float4 position : SV_POSITION;
-    float2 texCoord : TEXCOORD0;
-};
+groupshared float weightedBins[256];
 
-float4 main(PSInput input) : SV_TARGET
+[numthreads(256, 1, 1)]
+void main(uint groupIndex : SV_GroupIndex)
 {
-    float4 color = inputTexture.Sample(linearSampler, input.texCoord);
+    uint count = histogram[groupIndex];
+    weightedBins[groupIndex] = count * (float)groupIndex;
+    histogram[groupIndex] = 0;
+    GroupMemoryBarrierWithGroupSync();
 
-    float2 center = float2(0.5, 0.5);
-    float dist = distance(input.texCoord, center);
+    [unroll]
+    for (uint stride = 128; stride > 0; stride >>= 1)
+    {
+        if (groupIndex < stride)
+        {
+            weightedBins[groupIndex] += weightedBins[groupIndex + stride];
+        }
+        GroupMemoryBarrierWithGroupSync();
+    }
 
-    float vignette = 1.0 - smoothstep(vignetteRadius, vignetteRadius + vignetteSoftness, dist);
-    color.rgb *= vignette;
+    if (groupIndex == 0)
+    {
+        // count is bin 0 here: pixels too dark to measure
+        float meanBin = weightedBins[0] / max(pixelCount - (float)count, 1.0);
+        float logAverage = (meanBin - 1.0) / 254.0 * logLuminanceRange + minLogLuminance;
 
-    return color;
+        float adapted = adaptedLuminance[uint2(0, 0)];
+        adaptedLuminance[uint2(0, 0)] = adapted + (exp2(logAverage) - adapted) * adaptationRate;
+    }
 }
 )";
 }
 
+static_assert(MAX_BLUR_TAPS == 9, "PostProcessShaders::BLUR_PS declares 9 taps");
+static_assert(sizeof(BlurConstants) % 16 == 0, "Constant buffers are a multiple of 16 bytes");
+static_assert(LUMINANCE_HISTOGRAM_BINS == 256, "The auto-exposure shaders declare 256 bins");
+static_assert(LUMINANCE_HISTOGRAM_TILE == 16, "PostProcessShaders::LUMINANCE_HISTOGRAM_CS runs 16x16 groups");
+static_assert(sizeof(AutoExposureConstants) % 16 == 0, "Constant buffers are a multiple of 16 bytes");
+
+namespace
+{
+    // Every device object created in this file is counted here;
+    // PostProcessManager::Process checks that a frame which does not rebuild
+    // the graph creates none
+    uint64_t s_createdDeviceObjects = 0;
+
+    HRESULT CountCreated(HRESULT hr)
+    {
+        if (SUCCEEDED(hr))
+        {
+            s_createdDeviceObjects++;
+        }
+        return hr;
+    }
+
+    std::shared_ptr<Shader> CountCreated(std::shared_ptr<Shader> shader)
+    {
+        if (shader)
+        {
+            s_createdDeviceObjects++;
+        }
+        return shader;
+    }
+
+    bool HasBlurPasses(PostProcessEffect effect)
+    {
+        return effect == PostProcessEffect::Blur || effect == PostProcessEffect::GaussianBlur;
+    }
+
+    DXGI_FORMAT GetDxgiFormat(RenderGraphFormat format)
+    {
+        switch (format)
+        {
+            case RenderGraphFormat::RGBA16F:    return DXGI_FORMAT_R16G16B16A16_FLOAT;
+            case RenderGraphFormat::R11G11B10F: return DXGI_FORMAT_R11G11B10_FLOAT;
+            case RenderGraphFormat::R16F:       return DXGI_FORMAT_R16_FLOAT;
+            case RenderGraphFormat::R32F:       return DXGI_FORMAT_R32_FLOAT;
+            default:                            return DXGI_FORMAT_R8G8B8A8_UNORM;
+        }
+    }
+}
+
 // PostProcessEffect_Base implementation
 PostProcessEffect_Base::PostProcessEffect_Base(PostProcessEffect type)
     : m_type(type)
+    , m_autoExposure(false)
+    , m_enabled(true)
+    , m_initialized(false)
+    , m_vertexShader(nullptr)
+    , m_parameterBuffer(nullptr)
+    , m_blurBuffer(nullptr)
+    , m_blurSigma(-1.0f)
+{
+}
+
+PostProcessEffect_Base::PostProcessEffect_Base(const std::vector<PostProcessEffect>& fusedEffects, bool autoExposure)
+    : m_type(PostProcessEffect::None)
+    , m_fusedEffects(fusedEffects)
+    , m_autoExposure(autoExposure)
     , m_enabled(true)
+    , m_initialized(false)
     , m_vertexShader(nullptr)
-    , m_pixelShader(nullptr)
     , m_parameterBuffer(nullptr)
+    , m_blurBuffer(nullptr)
+    , m_blurSigma(-1.0f)
 {
 }
 
@@ -224,53 +353,78 @@ PostProcessEffect_Base::~PostProcessEffect_Base()
     Shutdown();
 }
 
-bool PostProcessEffect_Base::Initialize(ID3D11Device* device, int width, int height)
+bool PostProcessEffect_Base::Initialize(ID3D11Device* device, const std::shared_ptr<Shader>& vertexShader)
 {
-    if (!device)
+    if (!device || !vertexShader)
         return false;
 
-    m_width = width;
-    m_height = height;
-
-    // Create fullscreen quad vertex shader (shared by all effects)
-    auto vsLayout = ShaderUtils::CreatePositionColorLayout();
-    m_vertexShader = ShaderUtils::CreateVertexShaderFromString(device, PostProcessShaders::FULLSCREEN_QUAD_VS, vsLayout);
+    m_vertexShader = vertexShader;
 
-    if (!m_vertexShader)
+    // Create one pixel shader per pass of the effect; PerPixel shaders
+    // belong to the fused instances
+    std::vector<PostProcessPass> passes = PostProcessChain::GetEffectPasses(m_type);
+    if (!m_fusedEffects.empty())
     {
-        std::cerr << "PostProcess: Failed to create vertex shader" << std::endl;
-        return false;
+        passes = { PostProcessPass::PerPixel };
+    }
+    else if (PostProcessFusion::IsPerPixelEffect(m_type))
+    {
+        passes.clear();
     }
 
-    // Create effect-specific pixel shader
-    std::string pixelShaderCode = GetPixelShaderCode();
-    m_pixelShader = ShaderUtils::CreatePixelShaderFromString(device, pixelShaderCode);
-
-    if (!m_pixelShader)
+    for (PostProcessPass pass : passes)
     {
-        std::cerr << "PostProcess: Failed to create pixel shader for effect " << (int)m_type << std::endl;
-        return false;
+        auto pixelShader = CountCreated(ShaderUtils::CreatePixelShaderFromString(device, GetPixelShaderCode(pass)));
+        if (!pixelShader)
+        {
+            std::cerr << "PostProcess: Failed to create pixel shader for pass "
+                      << PostProcessChain::GetPassName(pass) << std::endl;
+            Shutdown();
+            return false;
+        }
+        m_pixelShaders[static_cast<int>(pass)] = pixelShader;
     }
 
     // Create parameter constant buffer
     D3D11_BUFFER_DESC bufferDesc = {};
     bufferDesc.Usage = D3D11_USAGE_DYNAMIC;
-    bufferDesc.ByteWidth = GetParameterBufferSize();
+    bufferDesc.ByteWidth = sizeof(PostProcessConstants);
     bufferDesc.BindFlags = D3D11_BIND_CONSTANT_BUFFER;
     bufferDesc.CPUAccessFlags = D3D11_CPU_ACCESS_WRITE;
 
-    HRESULT hr = device->CreateBuffer(&bufferDesc, nullptr, &m_parameterBuffer);
+    HRESULT hr = CountCreated(device->CreateBuffer(&bufferDesc, nullptr, &m_parameterBuffer));
     if (FAILED(hr))
     {
         std::cerr << "PostProcess: Failed to create parameter buffer" << std::endl;
+        Shutdown();
         return false;
     }
 
+    if (HasBlurPasses(m_type))
+    {
+        bufferDesc.ByteWidth = sizeof(BlurConstants);
+        hr = CountCreated(device->CreateBuffer(&bufferDesc, nullptr, &m_blurBuffer));
+        if (FAILED(hr))
+        {
+            std::cerr << "PostProcess: Failed to create blur buffer" << std::endl;
+            Shutdown();
+            return false;
+        }
+    }
+
+    m_initialized = true;
     return true;
 }
 
 void PostProcessEffect_Base::Shutdown()
 {
+    if (m_blurBuffer)
+    {
+        m_blurBuffer->Release();
+        m_blurBuffer = nullptr;
+    }
+    m_blurSigma = -1.0f;
+
     if (m_parameterBuffer)
     {
         m_parameterBuffer->Release();
@@ -278,246 +432,560 @@ void PostProcessEffect_Base::Shutdown()
     }
 
     m_vertexShader.reset();
-    m_pixelShader.reset();
+    m_pixelShaders.clear();
+    m_initialized = false;
 }
 
-void PostProcessEffect_Base::Apply(ID3D11DeviceContext* context,
-                                  ID3D11ShaderResourceView* inputTexture,
-                                  ID3D11RenderTargetView* outputTarget,
-                                  const PostProcessParams& params)
+void PostProcessEffect_Base::ApplyPass(ID3D11DeviceContext* context,
+                                       PostProcessPass pass,
+                                       ID3D11ShaderResourceView* const* inputs,
+                                       UINT inputCount,
+                                       const RenderGraphTextureDesc& inputDesc,
+                                       ID3D11RenderTargetView* outputTarget,
+                                       const RenderGraphTextureDesc& outputDesc,
+                                       const PostProcessParams& params)
 {
-    if (!context || !inputTexture || !outputTarget || !m_enabled)
+    PROFILE_FUNCTION();
+
+    if (!context || !inputs || inputCount == 0 || inputCount > 2 || !outputTarget || !m_initialized)
+        return;
+
+    auto it = m_pixelShaders.find(static_cast<int>(pass));
+    if (it == m_pixelShaders.end())
         return;
 
     // Update parameter buffer
-    UpdateParameterBuffer(context, params);
+    UpdateParameterBuffer(context, params, inputDesc);
 
     // Set render target
     context->OMSetRenderTargets(1, &outputTarget, nullptr);
 
     // Set viewport
     D3D11_VIEWPORT viewport = {};
-    viewport.Width = (FLOAT)m_width;
-    viewport.Height = (FLOAT)m_height;
+    viewport.Width = (FLOAT)outputDesc.width;
+    viewport.Height = (FLOAT)outputDesc.height;
     viewport.MinDepth = 0.0f;
     viewport.MaxDepth = 1.0f;
     context->RSSetViewports(1, &viewport);
 
     // Bind shaders
     m_vertexShader->Bind(context);
-    m_pixelShader->Bind(context);
-
-    // Bind input texture
-    context->PSSetShaderResources(0, 1, &inputTexture);
+    it->second->Bind(context);
 
-    // Bind parameter buffer
+    // Bind inputs and parameters
+    context->PSSetShaderResources(0, inputCount, inputs);
     context->PSSetConstantBuffers(0, 1, &m_parameterBuffer);
 
-    // Draw fullscreen quad
-    DrawFullscreenQuad(context);
+    if (pass == PostProcessPass::BlurHorizontal || pass == PostProcessPass::BlurVertical)
+    {
+        UpdateBlurBuffer(context, pass, params, inputDesc, outputDesc);
+        context->PSSetConstantBuffers(1, 1, &m_blurBuffer);
+    }
 
-    // Clear bindings
-    ID3D11ShaderResourceView* nullSRV = nullptr;
-    context->PSSetShaderResources(0, 1, &nullSRV);
+    DrawFullscreenTriangle(context);
+
+    // Clear bindings so the next pass can read this target or write an input
+    ID3D11ShaderResourceView* nullSRVs[2] = { nullptr, nullptr };
+    context->PSSetShaderResources(0, inputCount, nullSRVs);
+    ID3D11RenderTargetView* nullRTV = nullptr;
+    context->OMSetRenderTargets(1, &nullRTV, nullptr);
 }
 
-std::string PostProcessEffect_Base::GetPixelShaderCode() const
+std::string PostProcessEffect_Base::GetPixelShaderCode(PostProcessPass pass) const
 {
-    switch (m_type)
+    std::string code = PostProcessShaders::COMMON;
+
+    switch (pass)
     {
-        case PostProcessEffect::Grayscale:
-            return PostProcessShaders::GRAYSCALE_PS;
-        case PostProcessEffect::Bloom:
-            return PostProcessShaders::BLOOM_PS;
-        case PostProcessEffect::GaussianBlur:
-            return PostProcessShaders::GAUSSIAN_BLUR_PS;
-        case PostProcessEffect::ToneMapping:
-            return PostProcessShaders::TONE_MAPPING_PS;
-        case PostProcessEffect::Vignette:
-            return PostProcessShaders::VIGNETTE_PS;
+        case PostProcessPass::PerPixel:
+            return code + PostProcessFusion::GenerateShader(m_fusedEffects, m_autoExposure);
+        case PostProcessPass::BlurHorizontal:
+        case PostProcessPass::BlurVertical:
+            return code + PostProcessShaders::BLUR_PS;
+        case PostProcessPass::BloomBrightPass:
+            return code + PostProcessShaders::BLOOM_BRIGHT_PASS_PS;
+        case PostProcessPass::BloomDownsample:
+            return code + PostProcessShaders::BLOOM_DOWNSAMPLE_PS;
+        case PostProcessPass::BloomUpsample:
+            return code + PostProcessShaders::BLOOM_UPSAMPLE_PS;
+        case PostProcessPass::BloomCombine:
+            return code + PostProcessShaders::BLOOM_COMBINE_PS;
         default:
-            return PostProcessShaders::COPY_PS;
+            return code + PostProcessShaders::COPY_PS;
     }
 }
 
-UINT PostProcessEffect_Base::GetParameterBufferSize() const
-{
-    // Align to 16 bytes for constant buffer requirements
-    return ((sizeof(PostProcessParams) + 15) / 16) * 16;
-}
-
-void PostProcessEffect_Base::UpdateParameterBuffer(ID3D11DeviceContext* context, const PostProcessParams& params)
+void PostProcessEffect_Base::UpdateParameterBuffer(ID3D11DeviceContext* context, const PostProcessParams& params,
+                                                   const RenderGraphTextureDesc& inputDesc)
 {
     if (!m_parameterBuffer)
         return;
 
+    PostProcessConstants constants = {};
+    constants.texelSize = XMFLOAT2(1.0f / std::max(inputDesc.width, 1), 1.0f / std::max(inputDesc.height, 1));
+    constants.intensity = params.intensity;
+    constants.threshold = params.threshold;
+    constants.bloomThreshold = params.bloomThreshold;
+    constants.bloomIntensity = params.bloomIntensity;
+    constants.exposure = params.exposure;
+    constants.whitePoint = params.whitePoint;
+    constants.vignetteRadius = params.vignetteRadius;
+    constants.vignetteSoftness = params.vignetteSoftness;
+    constants.blurRadius = params.radius;
+    constants.exposureKey = params.exposureKey;
+    constants.vignetteColor = params.vignetteColor;
+    constants.colorTint = params.colorTint;
+    constants.contrast = params.contrast;
+    constants.brightness = params.brightness;
+    constants.saturation = params.saturation;
+    constants.gamma = params.gamma;
+
     D3D11_MAPPED_SUBRESOURCE mappedResource;
     HRESULT hr = context->Map(m_parameterBuffer, 0, D3D11_MAP_WRITE_DISCARD, 0, &mappedResource);
 
     if (SUCCEEDED(hr))
     {
-        memcpy(mappedResource.pData, &params, sizeof(PostProcessParams));
+        memcpy(mappedResource.pData, &constants, sizeof(PostProcessConstants));
         context->Unmap(m_parameterBuffer, 0);
     }
 }
 
-void PostProcessEffect_Base::DrawFullscreenQuad(ID3D11DeviceContext* context)
+void PostProcessEffect_Base::UpdateBlurBuffer(ID3D11DeviceContext* context, PostProcessPass pass,
+                                              const PostProcessParams& params,
+                                              const RenderGraphTextureDesc& inputDesc,
+                                              const RenderGraphTextureDesc& outputDesc)
 {
-    // Note: In a production implementation, this vertex buffer should be cached
-    // and created once during initialization for better performance
+    if (!m_blurBuffer)
+        return;
 
-    struct QuadVertex
+    if (params.sigma != m_blurSigma)
     {
-        XMFLOAT3 position;
-        XMFLOAT2 texCoord;
-    };
-
-    QuadVertex vertices[] = {
-        { XMFLOAT3(-1.0f, -1.0f, 0.0f), XMFLOAT2(0.0f, 1.0f) },
-        { XMFLOAT3(-1.0f,  1.0f, 0.0f), XMFLOAT2(0.0f, 0.0f) },
-        { XMFLOAT3( 1.0f, -1.0f, 0.0f), XMFLOAT2(1.0f, 1.0f) },
-        { XMFLOAT3( 1.0f,  1.0f, 0.0f), XMFLOAT2(1.0f, 0.0f) }
-    };
+        m_blurKernel = PostProcessKernels::ComputeBlurKernel(params);
+        m_blurSigma = params.sigma;
+    }
 
-    // Create temporary vertex buffer (should be cached in production)
-    D3D11_BUFFER_DESC bufferDesc = {};
-    bufferDesc.Usage = D3D11_USAGE_IMMUTABLE;
-    bufferDesc.ByteWidth = sizeof(vertices);
-    bufferDesc.BindFlags = D3D11_BIND_VERTEX_BUFFER;
+    BlurConstants constants = {};
+    constants.tapCount = static_cast<int>(m_blurKernel.offsets.size());
+    for (int i = 0; i < constants.tapCount; ++i)
+    {
+        constants.taps[i] = XMFLOAT4(m_blurKernel.offsets[i], m_blurKernel.weights[i], 0.0f, 0.0f);
+    }
 
-    D3D11_SUBRESOURCE_DATA initData = {};
-    initData.pSysMem = vertices;
+    if (pass == PostProcessPass::BlurHorizontal)
+    {
+        constants.step = XMFLOAT2(PostProcessKernels::GetBlurStep(inputDesc.width, outputDesc.width, params.radius), 0.0f);
+    }
+    else
+    {
+        constants.step = XMFLOAT2(0.0f, PostProcessKernels::GetBlurStep(inputDesc.height, outputDesc.height, params.radius));
+    }
 
-    ID3D11Buffer* vertexBuffer = nullptr;
-    ID3D11Device* device = nullptr;
-    context->GetDevice(&device);
+    D3D11_MAPPED_SUBRESOURCE mappedResource;
+    HRESULT hr = context->Map(m_blurBuffer, 0, D3D11_MAP_WRITE_DISCARD, 0, &mappedResource);
 
-    if (device && SUCCEEDED(device->CreateBuffer(&bufferDesc, &initData, &vertexBuffer)))
+    if (SUCCEEDED(hr))
     {
-        UINT stride = sizeof(QuadVertex);
-        UINT offset = 0;
-        context->IASetVertexBuffers(0, 1, &vertexBuffer, &stride, &offset);
-        context->IASetPrimitiveTopology(D3D11_PRIMITIVE_TOPOLOGY_TRIANGLESTRIP);
-        context->Draw(4, 0);
-
-        vertexBuffer->Release();
+        memcpy(mappedResource.pData, &constants, sizeof(BlurConstants));
+        context->Unmap(m_blurBuffer, 0);
     }
+}
 
-    if (device) device->Release();
+void PostProcessEffect_Base::DrawFullscreenTriangle(ID3D11DeviceContext* context)
+{
+    // Positions come from SV_VertexID; no vertex buffer or input layout
+    context->IASetInputLayout(nullptr);
+    context->IASetPrimitiveTopology(D3D11_PRIMITIVE_TOPOLOGY_TRIANGLELIST);
+    context->Draw(3, 0);
 }
 
-// PostProcessManager implementation
-PostProcessManager::PostProcessManager()
-    : m_device(nullptr)
-    , m_width(0)
-    , m_height(0)
-    , m_renderTarget1(nullptr)
-    , m_renderTarget2(nullptr)
-    , m_renderTargetView1(nullptr)
-    , m_renderTargetView2(nullptr)
-    , m_shaderResourceView1(nullptr)
-    , m_shaderResourceView2(nullptr)
-    , m_samplerState(nullptr)
+// AutoExposurePass implementation
+AutoExposurePass::AutoExposurePass()
+    : m_constantBuffer(nullptr)
+    , m_histogramBuffer(nullptr)
+    , m_histogramAccess(nullptr)
+    , m_luminanceTexture(nullptr)
+    , m_luminanceAccess(nullptr)
+    , m_luminanceView(nullptr)
+    , m_adapted(false)
 {
 }
 
-PostProcessManager::~PostProcessManager()
+AutoExposurePass::~AutoExposurePass()
 {
     Shutdown();
 }
 
-bool PostProcessManager::Initialize(ID3D11Device* device, int width, int height)
+bool AutoExposurePass::Initialize(ID3D11Device* device)
 {
     if (!device)
         return false;
 
-    m_device = device;
-    m_width = width;
-    m_height = height;
-
-    // Create render targets for ping-pong rendering
-    if (!CreateRenderTargets())
+    std::string common = PostProcessShaders::AUTO_EXPOSURE_COMMON;
+    m_histogramShader = CountCreated(ShaderUtils::CreateComputeShaderFromString(device, common + PostProcessShaders::LUMINANCE_HISTOGRAM_CS));
+    m_averageShader = CountCreated(ShaderUtils::CreateComputeShaderFromString(device, common + PostProcessShaders::LUMINANCE_AVERAGE_CS));
+    if (!m_histogramShader || !m_averageShader)
     {
-        std::cerr << "PostProcessManager: Failed to create render targets" << std::endl;
+        std::cerr << "AutoExposurePass: Failed to create compute shaders" << std::endl;
+        Shutdown();
         return false;
     }
 
-    // Create sampler state
-    D3D11_SAMPLER_DESC samplerDesc = {};
-    samplerDesc.Filter = D3D11_FILTER_MIN_MAG_MIP_LINEAR;
-    samplerDesc.AddressU = D3D11_TEXTURE_ADDRESS_CLAMP;
-    samplerDesc.AddressV = D3D11_TEXTURE_ADDRESS_CLAMP;
-    samplerDesc.AddressW = D3D11_TEXTURE_ADDRESS_CLAMP;
-    samplerDesc.MipLODBias = 0.0f;
-    samplerDesc.MaxAnisotropy = 1;
-    samplerDesc.ComparisonFunc = D3D11_COMPARISON_ALWAYS;
-    samplerDesc.MinLOD = 0;
-    samplerDesc.MaxLOD = D3D11_FLOAT32_MAX;
+    D3D11_BUFFER_DESC bufferDesc = {};
+    bufferDesc.Usage = D3D11_USAGE_DYNAMIC;
+    bufferDesc.ByteWidth = sizeof(AutoExposureConstants);
+    bufferDesc.BindFlags = D3D11_BIND_CONSTANT_BUFFER;
+    bufferDesc.CPUAccessFlags = D3D11_CPU_ACCESS_WRITE;
 
-    HRESULT hr = device->CreateSamplerState(&samplerDesc, &m_samplerState);
+    HRESULT hr = CountCreated(device->CreateBuffer(&bufferDesc, nullptr, &m_constantBuffer));
     if (FAILED(hr))
     {
-        std::cerr << "PostProcessManager: Failed to create sampler state" << std::endl;
+        std::cerr << "AutoExposurePass: Failed to create constant buffer" << std::endl;
+        Shutdown();
         return false;
     }
 
-    std::cout << "PostProcessManager: Initialized for " << width << "x" << height << std::endl;
-    return true;
-}
+    // Histogram, zeroed once; the average pass clears it after reading
+    UINT zeroBins[LUMINANCE_HISTOGRAM_BINS] = {};
+    D3D11_SUBRESOURCE_DATA histogramData = {};
+    histogramData.pSysMem = zeroBins;
 
-void PostProcessManager::Shutdown()
-{
-    for (auto& effect : m_effects)
+    D3D11_BUFFER_DESC histogramDesc = {};
+    histogramDesc.Usage = D3D11_USAGE_DEFAULT;
+    histogramDesc.ByteWidth = sizeof(zeroBins);
+    histogramDesc.BindFlags = D3D11_BIND_UNORDERED_ACCESS;
+    histogramDesc.MiscFlags = D3D11_RESOURCE_MISC_BUFFER_STRUCTURED;
+    histogramDesc.StructureByteStride = sizeof(UINT);
+
+    hr = CountCreated(device->CreateBuffer(&histogramDesc, &histogramData, &m_histogramBuffer));
+    if (SUCCEEDED(hr))
     {
-        if (effect.second)
-        {
-            effect.second->Shutdown();
-        }
+        D3D11_UNORDERED_ACCESS_VIEW_DESC accessDesc = {};
+        accessDesc.Format = DXGI_FORMAT_UNKNOWN;
+        accessDesc.ViewDimension = D3D11_UAV_DIMENSION_BUFFER;
+        accessDesc.Buffer.NumElements = LUMINANCE_HISTOGRAM_BINS;
+        hr = CountCreated(device->CreateUnorderedAccessView(m_histogramBuffer, &accessDesc, &m_histogramAccess));
     }
-    m_effects.clear();
 
-    if (m_samplerState)
+    if (FAILED(hr))
     {
-        m_samplerState->Release();
-        m_samplerState = nullptr;
+        std::cerr << "AutoExposurePass: Failed to create histogram buffer" << std::endl;
+        Shutdown();
+        return false;
+    }
+
+    // Adapted luminance, starting at 1 until the first measurement replaces it
+    float initialLuminance = 1.0f;
+    D3D11_SUBRESOURCE_DATA luminanceData = {};
+    luminanceData.pSysMem = &initialLuminance;
+    luminanceData.SysMemPitch = sizeof(float);
+
+    D3D11_TEXTURE2D_DESC textureDesc = {};
+    textureDesc.Width = 1;
+    textureDesc.Height = 1;
+    textureDesc.MipLevels = 1;
+    textureDesc.ArraySize = 1;
+    textureDesc.Format = DXGI_FORMAT_R32_FLOAT;
+    textureDesc.SampleDesc.Count = 1;
+    textureDesc.Usage = D3D11_USAGE_DEFAULT;
+    textureDesc.BindFlags = D3D11_BIND_UNORDERED_ACCESS | D3D11_BIND_SHADER_RESOURCE;
+
+    hr = CountCreated(device->CreateTexture2D(&textureDesc, &luminanceData, &m_luminanceTexture));
+    if (SUCCEEDED(hr))
+    {
+        hr = CountCreated(device->CreateUnorderedAccessView(m_luminanceTexture, nullptr, &m_luminanceAccess));
+    }
+    if (SUCCEEDED(hr))
+    {
+        hr = CountCreated(device->CreateShaderResourceView(m_luminanceTexture, nullptr, &m_luminanceView));
+    }
+
+    if (FAILED(hr))
+    {
+        std::cerr << "AutoExposurePass: Failed to create luminance texture" << std::endl;
+        Shutdown();
+        return false;
+    }
+
+    m_adapted = false;
+    return true;
+}
+
+void AutoExposurePass::Shutdown()
+{
+    if (m_luminanceView)
+    {
+        m_luminanceView->Release();
+        m_luminanceView = nullptr;
+    }
+
+    if (m_luminanceAccess)
+    {
+        m_luminanceAccess->Release();
+        m_luminanceAccess = nullptr;
+    }
+
+    if (m_luminanceTexture)
+    {
+        m_luminanceTexture->Release();
+        m_luminanceTexture = nullptr;
+    }
+
+    if (m_histogramAccess)
+    {
+        m_histogramAccess->Release();
+        m_histogramAccess = nullptr;
+    }
+
+    if (m_histogramBuffer)
+    {
+        m_histogramBuffer->Release();
+        m_histogramBuffer = nullptr;
+    }
+
+    if (m_constantBuffer)
+    {
+        m_constantBuffer->Release();
+        m_constantBuffer = nullptr;
+    }
+
+    m_histogramShader.reset();
+    m_averageShader.reset();
+}
+
+void AutoExposurePass::Dispatch(ID3D11DeviceContext* context,
+                                ID3D11ShaderResourceView* input,
+                                const RenderGraphTextureDesc& inputDesc,
+                                const PostProcessParams& params,
+                                float deltaTime)
+{
+    PROFILE_FUNCTION();
+
+    if (!context || !input || !m_histogramShader || !m_averageShader)
+        return;
+
+    UpdateConstantBuffer(context, inputDesc, params, deltaTime);
+
+    ID3D11UnorderedAccessView* views[2] = { m_histogramAccess, m_luminanceAccess };
+    context->CSSetConstantBuffers(0, 1, &m_constantBuffer);
+    context->CSSetShaderResources(0, 1, &input);
+    context->CSSetUnorderedAccessViews(0, 2, views, nullptr);
+
+    m_histogramShader->Bind(context);
+    context->Dispatch((inputDesc.width + LUMINANCE_HISTOGRAM_TILE - 1) / LUMINANCE_HISTOGRAM_TILE,
+                      (inputDesc.height + LUMINANCE_HISTOGRAM_TILE - 1) / LUMINANCE_HISTOGRAM_TILE, 1);
+
+    m_averageShader->Bind(context);
+    context->Dispatch(1, 1, 1);
+    m_averageShader->Unbind(context);
+
+    // Clear bindings so the luminance texture can be read by the tone mapping
+    ID3D11ShaderResourceView* nullView = nullptr;
+    ID3D11UnorderedAccessView* nullViews[2] = { nullptr, nullptr };
+    context->CSSetShaderResources(0, 1, &nullView);
+    context->CSSetUnorderedAccessViews(0, 2, nullViews, nullptr);
+
+    m_adapted = true;
+}
+
+void AutoExposurePass::UpdateConstantBuffer(ID3D11DeviceContext* context, const RenderGraphTextureDesc& inputDesc,
+                                            const PostProcessParams& params, float deltaTime)
+{
+    float range = params.maxLogLuminance - params.minLogLuminance;
+
+    AutoExposureConstants constants = {};
+    constants.inputWidth = static_cast<UINT>(inputDesc.width);
+    constants.inputHeight = static_cast<UINT>(inputDesc.height);
+    constants.minLogLuminance = params.minLogLuminance;
+    constants.inverseLogLuminanceRange = 1.0f / range;
+    constants.logLuminanceRange = range;
+    constants.adaptationRate = m_adapted ? AutoExposure::GetAdaptationRate(deltaTime, params) : 1.0f;
+    constants.pixelCount = static_cast<float>(inputDesc.width) * inputDesc.height;
+
+    D3D11_MAPPED_SUBRESOURCE mappedResource;
+    HRESULT hr = context->Map(m_constantBuffer, 0, D3D11_MAP_WRITE_DISCARD, 0, &mappedResource);
+
+    if (SUCCEEDED(hr))
+    {
+        memcpy(mappedResource.pData, &constants, sizeof(AutoExposureConstants));
+        context->Unmap(m_constantBuffer, 0);
+    }
+}
+
+// PostProcessManager implementation
+PostProcessManager::PostProcessManager()
+    : m_device(nullptr)
+    , m_width(0)
+    , m_height(0)
+    , m_passFusion(true)
+    , m_intermediateFormat(RenderGraphFormat::R11G11B10F)
+    , m_autoExposure(false)
+    , m_frameTime(0.0f)
+    , m_sceneResource(INVALID_RENDER_GRAPH_HANDLE)
+    , m_outputResource(INVALID_RENDER_GRAPH_HANDLE)
+    , m_exposureResource(INVALID_RENDER_GRAPH_HANDLE)
+    , m_graphDirty(true)
+    , m_context(nullptr)
+    , m_sceneInput(nullptr)
+    , m_finalOutput(nullptr)
+    , m_initialized(false)
+    , m_debugMode(false)
+    , m_vertexShader(nullptr)
+    , m_samplerState(nullptr)
+    , m_rasterizerState(nullptr)
+    , m_depthStencilState(nullptr)
+{
+}
+
+PostProcessManager::~PostProcessManager()
+{
+    Shutdown();
+}
+
+bool PostProcessManager::Initialize(ID3D11Device* device, int width, int height)
+{
+    if (!device)
+        return false;
+
+    m_device = device;
+    m_width = width;
+    m_height = height;
+
+    if (!CreatePipelineStates())
+    {
+        std::cerr << "PostProcessManager: Failed to create pipeline states" << std::endl;
+        Shutdown();
+        return false;
+    }
+
+    // Render targets are created with the graph, on the first Process
+    m_graphDirty = true;
+    m_initialized = true;
+
+    std::cout << "PostProcessManager: Initialized for " << width << "x" << height << std::endl;
+    return true;
+}
+
+bool PostProcessManager::CreatePipelineStates()
+{
+    // Fullscreen triangle vertex shader, shared by every effect
+    m_vertexShader = CountCreated(ShaderUtils::CreateVertexShaderFromString(m_device, PostProcessShaders::FULLSCREEN_TRIANGLE_VS, {}));
+    if (!m_vertexShader)
+    {
+        std::cerr << "PostProcessManager: Failed to create vertex shader" << std::endl;
+        return false;
+    }
+
+    m_copyEffect = std::make_unique<PostProcessEffect_Base>(PostProcessEffect::None);
+    if (!m_copyEffect->Initialize(m_device, m_vertexShader))
+    {
+        std::cerr << "PostProcessManager: Failed to create copy effect" << std::endl;
+        return false;
+    }
+
+    // Create sampler state
+    D3D11_SAMPLER_DESC samplerDesc = {};
+    samplerDesc.Filter = D3D11_FILTER_MIN_MAG_MIP_LINEAR;
+    samplerDesc.AddressU = D3D11_TEXTURE_ADDRESS_CLAMP;
+    samplerDesc.AddressV = D3D11_TEXTURE_ADDRESS_CLAMP;
+    samplerDesc.AddressW = D3D11_TEXTURE_ADDRESS_CLAMP;
+    samplerDesc.MipLODBias = 0.0f;
+    samplerDesc.MaxAnisotropy = 1;
+    samplerDesc.ComparisonFunc = D3D11_COMPARISON_ALWAYS;
+    samplerDesc.MinLOD = 0;
+    samplerDesc.MaxLOD = D3D11_FLOAT32_MAX;
+
+    HRESULT hr = CountCreated(m_device->CreateSamplerState(&samplerDesc, &m_samplerState));
+    if (FAILED(hr))
+    {
+        std::cerr << "PostProcessManager: Failed to create sampler state" << std::endl;
+        return false;
     }
 
-    if (m_shaderResourceView2)
+    // Fullscreen passes never cull or depth test
+    D3D11_RASTERIZER_DESC rasterizerDesc = {};
+    rasterizerDesc.FillMode = D3D11_FILL_SOLID;
+    rasterizerDesc.CullMode = D3D11_CULL_NONE;
+    rasterizerDesc.DepthClipEnable = TRUE;
+
+    hr = CountCreated(m_device->CreateRasterizerState(&rasterizerDesc, &m_rasterizerState));
+    if (FAILED(hr))
     {
-        m_shaderResourceView2->Release();
-        m_shaderResourceView2 = nullptr;
+        std::cerr << "PostProcessManager: Failed to create rasterizer state" << std::endl;
+        return false;
     }
 
-    if (m_shaderResourceView1)
+    D3D11_DEPTH_STENCIL_DESC depthStencilDesc = {};
+    depthStencilDesc.DepthEnable = FALSE;
+    depthStencilDesc.DepthWriteMask = D3D11_DEPTH_WRITE_MASK_ZERO;
+    depthStencilDesc.DepthFunc = D3D11_COMPARISON_ALWAYS;
+    depthStencilDesc.StencilEnable = FALSE;
+
+    hr = CountCreated(m_device->CreateDepthStencilState(&depthStencilDesc, &m_depthStencilState));
+    if (FAILED(hr))
     {
-        m_shaderResourceView1->Release();
-        m_shaderResourceView1 = nullptr;
+        std::cerr << "PostProcessManager: Failed to create depth stencil state" << std::endl;
+        return false;
     }
 
-    if (m_renderTargetView2)
+    return true;
+}
+
+void PostProcessManager::BindPipelineStates(ID3D11DeviceContext* context)
+{
+    context->PSSetSamplers(0, 1, &m_samplerState);
+    context->RSSetState(m_rasterizerState);
+    context->OMSetDepthStencilState(m_depthStencilState, 0);
+    context->OMSetBlendState(nullptr, nullptr, 0xFFFFFFFF);
+}
+
+void PostProcessManager::UnbindPipelineStates(ID3D11DeviceContext* context)
+{
+    ID3D11SamplerState* nullSampler = nullptr;
+    context->PSSetSamplers(0, 1, &nullSampler);
+    context->RSSetState(nullptr);
+    context->OMSetDepthStencilState(nullptr, 0);
+}
+
+void PostProcessManager::Shutdown()
+{
+    for (auto& effect : m_effects)
     {
-        m_renderTargetView2->Release();
-        m_renderTargetView2 = nullptr;
+        if (effect.second)
+        {
+            effect.second->Shutdown();
+        }
     }
+    m_effects.clear();
+    m_effectOrder.clear();
+
+    ReleaseRenderTargets();
+    m_graph.Clear();
+    m_graphDirty = true;
+
+    m_fusedPasses.clear();
+    m_autoExposurePass.reset();
+    m_copyEffect.reset();
+    m_vertexShader.reset();
 
-    if (m_renderTargetView1)
+    if (m_depthStencilState)
     {
-        m_renderTargetView1->Release();
-        m_renderTargetView1 = nullptr;
+        m_depthStencilState->Release();
+        m_depthStencilState = nullptr;
     }
 
-    if (m_renderTarget2)
+    if (m_rasterizerState)
     {
-        m_renderTarget2->Release();
-        m_renderTarget2 = nullptr;
+        m_rasterizerState->Release();
+        m_rasterizerState = nullptr;
     }
 
-    if (m_renderTarget1)
+    if (m_samplerState)
     {
-        m_renderTarget1->Release();
-        m_renderTarget1 = nullptr;
+        m_samplerState->Release();
+        m_samplerState = nullptr;
     }
 
+    m_initialized = false;
     m_device = nullptr;
 }
 
@@ -526,17 +994,25 @@ void PostProcessManager::AddEffect(PostProcessEffect effectType)
     if (m_effects.find(effectType) != m_effects.end())
         return; // Effect already exists
 
+    if (!PostProcessChain::IsEffectSupported(effectType))
+    {
+        std::cerr << "PostProcessManager: Effect " << PostProcessChain::GetEffectName(effectType)
+                  << " is not implemented" << std::endl;
+        return;
+    }
+
     auto effect = std::make_unique<PostProcessEffect_Base>(effectType);
-    if (effect->Initialize(m_device, m_width, m_height))
+    if (effect->Initialize(m_device, m_vertexShader))
     {
         m_effectOrder.push_back(effectType);
         m_effects[effectType] = std::move(effect);
+        m_graphDirty = true;
 
-        std::cout << "PostProcessManager: Added effect " << (int)effectType << std::endl;
+        std::cout << "PostProcessManager: Added effect " << PostProcessChain::GetEffectName(effectType) << std::endl;
     }
     else
     {
-        std::cerr << "PostProcessManager: Failed to add effect " << (int)effectType << std::endl;
+        std::cerr << "PostProcessManager: Failed to add effect " << PostProcessChain::GetEffectName(effectType) << std::endl;
     }
 }
 
@@ -553,72 +1029,226 @@ void PostProcessManager::RemoveEffect(PostProcessEffect effectType)
         {
             m_effectOrder.erase(orderIt);
         }
+        m_graphDirty = true;
+    }
+}
+
+void PostProcessManager::ClearEffects()
+{
+    for (auto& effect : m_effects)
+    {
+        effect.second->Shutdown();
+    }
+    m_effects.clear();
+    m_effectOrder.clear();
+    m_graphDirty = true;
+}
+
+void PostProcessManager::SetPassFusion(bool enabled)
+{
+    if (m_passFusion != enabled)
+    {
+        m_passFusion = enabled;
+        m_graphDirty = true;
+    }
+}
+
+void PostProcessManager::SetIntermediateFormat(RenderGraphFormat format)
+{
+    if (m_intermediateFormat != format)
+    {
+        m_intermediateFormat = format;
+        m_graphDirty = true;
+    }
+}
+
+void PostProcessManager::SetAutoExposure(bool enabled)
+{
+    if (m_autoExposure != enabled)
+    {
+        m_autoExposure = enabled;
+        m_graphDirty = true;
+
+        // Start from the next measurement instead of a stale value
+        if (m_autoExposurePass)
+        {
+            m_autoExposurePass->Reset();
+        }
     }
 }
 
 void PostProcessManager::SetEffectEnabled(PostProcessEffect effectType, bool enabled)
 {
     auto it = m_effects.find(effectType);
-    if (it != m_effects.end())
+    if (it != m_effects.end() && it->second->IsEnabled() != enabled)
     {
         it->second->SetEnabled(enabled);
+        m_graphDirty = true;
     }
 }
 
-void PostProcessManager::Process(ID3D11DeviceContext* context,
-                                ID3D11ShaderResourceView* inputTexture,
-                                ID3D11RenderTargetView* outputTarget)
+bool PostProcessManager::IsEffectEnabled(PostProcessEffect effectType) const
 {
-    if (!context || !inputTexture || !outputTarget || m_effectOrder.empty())
+    auto it = m_effects.find(effectType);
+    return it != m_effects.end() && it->second->IsEnabled();
+}
+
+int PostProcessManager::GetActiveEffectCount() const
+{
+    int count = 0;
+    for (const auto& effect : m_effects)
     {
-        // No effects, just copy input to output
-        CopyTexture(context, inputTexture, outputTarget);
+        if (effect.second->IsEnabled())
+            count++;
+    }
+    return count;
+}
+
+void PostProcessManager::Process(ID3D11DeviceContext* context,
+                                 ID3D11ShaderResourceView* inputTexture,
+                                 ID3D11RenderTargetView* finalOutput)
+{
+    PROFILE_FUNCTION();
+
+    if (!m_initialized || !context || !inputTexture || !finalOutput)
         return;
+
+    // Frame time for the exposure adaptation
+    auto now = std::chrono::steady_clock::now();
+    if (m_lastProcessTime != std::chrono::steady_clock::time_point())
+    {
+        m_frameTime = std::chrono::duration<float>(now - m_lastProcessTime).count();
     }
+    m_lastProcessTime = now;
 
-    // Set sampler state
-    context->PSSetSamplers(0, 1, &m_samplerState);
+    // Device objects are only created while the graph is rebuilt
+    bool rebuildGraph = m_graphDirty;
+    uint64_t createdBefore = s_createdDeviceObjects;
+
+    if (rebuildGraph)
+    {
+        BuildGraph();
+    }
+
+    BindPipelineStates(context);
+
+    if (m_graph.IsCompiled())
+    {
+        m_context = context;
+        m_sceneInput = inputTexture;
+        m_finalOutput = finalOutput;
+
+        m_graph.Execute();
 
-    ID3D11ShaderResourceView* currentInput = inputTexture;
-    ID3D11RenderTargetView* currentOutput = nullptr;
+        m_context = nullptr;
+        m_sceneInput = nullptr;
+        m_finalOutput = nullptr;
+    }
+    else
+    {
+        // The chain could not be built; keep the image on screen
+        CopyTexture(context, inputTexture, finalOutput);
+    }
+
+    UnbindPipelineStates(context);
 
-    bool useRT1 = true;
+    if (!rebuildGraph && s_createdDeviceObjects != createdBefore)
+    {
+        std::cerr << "PostProcessManager: Created " << (s_createdDeviceObjects - createdBefore)
+                  << " device objects in a frame that did not rebuild the graph" << std::endl;
+    }
+}
+
+uint64_t PostProcessManager::GetCreatedDeviceObjectCount()
+{
+    return s_createdDeviceObjects;
+}
 
-    // Apply effects in order
-    for (size_t i = 0; i < m_effectOrder.size(); ++i)
+void PostProcessManager::ResizeRenderTargets(ID3D11Device* device, int width, int height)
+{
+    if (device)
     {
-        PostProcessEffect effectType = m_effectOrder[i];
-        auto it = m_effects.find(effectType);
+        m_device = device;
+    }
+
+    if (width == m_width && height == m_height)
+        return;
+
+    m_width = width;
+    m_height = height;
+    m_graphDirty = true;
+}
+
+bool PostProcessManager::BuildGraph()
+{
+    PROFILE_FUNCTION();
 
-        if (it == m_effects.end() || !it->second->IsEnabled())
-            continue;
+    ReleaseRenderTargets();
+    m_graph.Clear();
+    m_graphDirty = false;
 
-        // Determine output target
-        if (i == m_effectOrder.size() - 1)
+    std::vector<PostProcessEffect> enabledEffects;
+    for (PostProcessEffect effectType : m_effectOrder)
+    {
+        if (IsEffectEnabled(effectType))
         {
-            // Last effect, render to final output
-            currentOutput = outputTarget;
+            enabledEffects.push_back(effectType);
         }
-        else
+    }
+
+    RenderGraphTextureDesc desc(m_width, m_height, m_intermediateFormat);
+    m_sceneResource = m_graph.ImportTexture("Scene", desc);
+    m_outputResource = m_graph.ImportTexture("Output", RenderGraphTextureDesc(m_width, m_height, RenderGraphFormat::RGBA8));
+    m_graph.MarkOutput(m_outputResource);
+
+    PostProcessChainOptions options;
+    options.fusePerPixel = m_passFusion;
+
+    m_exposureResource = INVALID_RENDER_GRAPH_HANDLE;
+    if (m_autoExposure)
+    {
+        if (!m_autoExposurePass)
         {
-            // Render to ping-pong buffer
-            currentOutput = useRT1 ? m_renderTargetView1 : m_renderTargetView2;
+            m_autoExposurePass = std::make_unique<AutoExposurePass>();
+            if (!m_autoExposurePass->Initialize(m_device))
+            {
+                std::cerr << "PostProcessManager: Auto-exposure unavailable, using the manual exposure" << std::endl;
+                m_autoExposurePass.reset();
+                m_autoExposure = false;
+            }
         }
 
-        // Apply effect
-        it->second->Apply(context, currentInput, currentOutput, m_parameters);
-
-        // Setup for next effect
-        if (i < m_effectOrder.size() - 1)
+        if (m_autoExposurePass)
         {
-            currentInput = useRT1 ? m_shaderResourceView1 : m_shaderResourceView2;
-            useRT1 = !useRT1;
+            m_exposureResource = m_graph.ImportTexture("Adapted Luminance", RenderGraphTextureDesc(1, 1, RenderGraphFormat::R32F));
+            options.exposure = m_exposureResource;
         }
     }
 
-    // Clear sampler binding
-    ID3D11SamplerState* nullSampler = nullptr;
-    context->PSSetSamplers(0, 1, &nullSampler);
+    PostProcessChain::Build(m_graph, enabledEffects, m_sceneResource, m_outputResource, desc, options,
+        [this](const PostProcessPassInfo& info) { return BindPass(info); });
+
+    if (!m_graph.Compile())
+    {
+        std::cerr << "PostProcessManager: Failed to compile the effect graph" << std::endl;
+        m_graph.Clear();
+        return false;
+    }
+
+    if (!CreateRenderTargets())
+    {
+        std::cerr << "PostProcessManager: Failed to create render targets" << std::endl;
+        ReleaseRenderTargets();
+        m_graph.Clear();
+        return false;
+    }
+
+    if (m_debugMode)
+    {
+        m_graph.PrintSummary();
+    }
+
+    return true;
 }
 
 bool PostProcessManager::CreateRenderTargets()
@@ -626,65 +1256,159 @@ bool PostProcessManager::CreateRenderTargets()
     if (!m_device)
         return false;
 
-    // Create texture description
-    D3D11_TEXTURE2D_DESC textureDesc = {};
-    textureDesc.Width = m_width;
-    textureDesc.Height = m_height;
-    textureDesc.MipLevels = 1;
-    textureDesc.ArraySize = 1;
-    textureDesc.Format = DXGI_FORMAT_R8G8B8A8_UNORM;
-    textureDesc.SampleDesc.Count = 1;
-    textureDesc.SampleDesc.Quality = 0;
-    textureDesc.Usage = D3D11_USAGE_DEFAULT;
-    textureDesc.BindFlags = D3D11_BIND_RENDER_TARGET | D3D11_BIND_SHADER_RESOURCE;
-    textureDesc.CPUAccessFlags = 0;
-    textureDesc.MiscFlags = 0;
+    for (const RenderGraphTextureDesc& desc : m_graph.GetPhysicalTextures())
+    {
+        // Create texture description
+        D3D11_TEXTURE2D_DESC textureDesc = {};
+        textureDesc.Width = desc.width;
+        textureDesc.Height = desc.height;
+        textureDesc.MipLevels = 1;
+        textureDesc.ArraySize = 1;
+        textureDesc.Format = GetDxgiFormat(desc.format);
+        textureDesc.SampleDesc.Count = 1;
+        textureDesc.SampleDesc.Quality = 0;
+        textureDesc.Usage = D3D11_USAGE_DEFAULT;
+        textureDesc.BindFlags = D3D11_BIND_RENDER_TARGET | D3D11_BIND_SHADER_RESOURCE;
+        textureDesc.CPUAccessFlags = 0;
+        textureDesc.MiscFlags = 0;
+
+        RenderTarget target = {};
+        m_renderTargets.push_back(target);
+        RenderTarget& created = m_renderTargets.back();
+
+        HRESULT hr = CountCreated(m_device->CreateTexture2D(&textureDesc, nullptr, &created.texture));
+        if (FAILED(hr))
+            return false;
+
+        hr = CountCreated(m_device->CreateRenderTargetView(created.texture, nullptr, &created.renderTargetView));
+        if (FAILED(hr))
+            return false;
+
+        hr = CountCreated(m_device->CreateShaderResourceView(created.texture, nullptr, &created.shaderResourceView));
+        if (FAILED(hr))
+            return false;
+    }
 
-    // Create first render target
-    HRESULT hr = m_device->CreateTexture2D(&textureDesc, nullptr, &m_renderTarget1);
-    if (FAILED(hr))
-        return false;
+    Memory::TrackResource(MemoryCategory::RenderTargets, this, "PostProcess",
+                          static_cast<size_t>(m_graph.GetStats().peakTransientBytes));
+    return true;
+}
 
-    hr = m_device->CreateRenderTargetView(m_renderTarget1, nullptr, &m_renderTargetView1);
-    if (FAILED(hr))
-        return false;
+void PostProcessManager::ReleaseRenderTargets()
+{
+    for (RenderTarget& target : m_renderTargets)
+    {
+        if (target.shaderResourceView)
+            target.shaderResourceView->Release();
+        if (target.renderTargetView)
+            target.renderTargetView->Release();
+        if (target.texture)
+            target.texture->Release();
+    }
+    m_renderTargets.clear();
 
-    hr = m_device->CreateShaderResourceView(m_renderTarget1, nullptr, &m_shaderResourceView1);
-    if (FAILED(hr))
-        return false;
+    Memory::UntrackResource(MemoryCategory::RenderTargets, this);
+}
 
-    // Create second render target
-    hr = m_device->CreateTexture2D(&textureDesc, nullptr, &m_renderTarget2);
-    if (FAILED(hr))
-        return false;
+RenderGraph::ExecuteFunction PostProcessManager::BindPass(const PostProcessPassInfo& info)
+{
+    if (info.pass == PostProcessPass::LuminanceHistogram)
+    {
+        return [this, info]()
+        {
+            m_autoExposurePass->Dispatch(m_context, GetShaderResourceView(info.inputs[0]), info.inputDesc,
+                                         m_parameters, m_frameTime);
+        };
+    }
 
-    hr = m_device->CreateRenderTargetView(m_renderTarget2, nullptr, &m_renderTargetView2);
-    if (FAILED(hr))
-        return false;
+    PostProcessEffect_Base* effect = nullptr;
+    if (info.pass == PostProcessPass::PerPixel)
+    {
+        effect = GetFusedPass(info.effects, info.autoExposure);
+    }
+    else
+    {
+        auto it = m_effects.find(info.effect);
+        effect = it != m_effects.end() ? it->second.get() : nullptr;
+    }
 
-    hr = m_device->CreateShaderResourceView(m_renderTarget2, nullptr, &m_shaderResourceView2);
-    if (FAILED(hr))
-        return false;
+    return [this, effect, info]()
+    {
+        ID3D11ShaderResourceView* inputs[2] = { nullptr, nullptr };
+        for (int i = 0; i < info.inputCount; ++i)
+        {
+            inputs[i] = GetShaderResourceView(info.inputs[i]);
+        }
+        ID3D11RenderTargetView* output = GetRenderTargetView(info.output);
 
-    return true;
+        if (!effect)
+        {
+            CopyTexture(m_context, inputs[0], output);
+            return;
+        }
+
+        effect->ApplyPass(m_context, info.pass, inputs, static_cast<UINT>(info.inputCount), info.inputDesc,
+                          output, info.outputDesc, m_parameters);
+    };
 }
 
-void PostProcessManager::CopyTexture(ID3D11DeviceContext* context,
-                                    ID3D11ShaderResourceView* input,
-                                    ID3D11RenderTargetView* output)
+PostProcessEffect_Base* PostProcessManager::GetFusedPass(const std::vector<PostProcessEffect>& effects, bool autoExposure)
 {
-    if (!context || !input || !output)
-        return;
+    std::string name = PostProcessFusion::GetFusionName(effects) + (autoExposure ? " (auto-exposure)" : "");
+    auto it = m_fusedPasses.find(name);
+    if (it != m_fusedPasses.end())
+    {
+        return it->second.get();
+    }
 
-    // Create a simple copy effect if needed
-    static std::unique_ptr<PostProcessEffect_Base> copyEffect = nullptr;
-    if (!copyEffect)
+    // Compiled while the graph is built, never during Process
+    auto fused = std::make_unique<PostProcessEffect_Base>(effects, autoExposure);
+    if (!fused->Initialize(m_device, m_vertexShader))
     {
-        copyEffect = std::make_unique<PostProcessEffect_Base>(PostProcessEffect::None);
-        copyEffect->Initialize(m_device, m_width, m_height);
+        std::cerr << "PostProcessManager: Failed to create per-pixel pass " << name << std::endl;
+        return nullptr;
     }
 
-    // Use the copy effect to transfer the texture
+    if (m_debugMode)
+    {
+        std::cout << "PostProcessManager: Generated per-pixel pass " << name << std::endl;
+    }
+
+    PostProcessEffect_Base* result = fused.get();
+    m_fusedPasses[name] = std::move(fused);
+    return result;
+}
+
+ID3D11ShaderResourceView* PostProcessManager::GetShaderResourceView(RenderGraphResource resource) const
+{
+    if (resource == m_sceneResource)
+        return m_sceneInput;
+    if (resource == m_exposureResource)
+        return m_autoExposurePass->GetLuminanceView();
+
+    int physical = m_graph.GetPhysicalIndex(resource);
+    return physical >= 0 ? m_renderTargets[physical].shaderResourceView : nullptr;
+}
+
+ID3D11RenderTargetView* PostProcessManager::GetRenderTargetView(RenderGraphResource resource) const
+{
+    if (resource == m_outputResource)
+        return m_finalOutput;
+
+    int physical = m_graph.GetPhysicalIndex(resource);
+    return physical >= 0 ? m_renderTargets[physical].renderTargetView : nullptr;
+}
+
+void PostProcessManager::CopyTexture(ID3D11DeviceContext* context,
+                                     ID3D11ShaderResourceView* input,
+                                     ID3D11RenderTargetView* output)
+{
+    PROFILE_FUNCTION();
+
+    if (!context || !input || !output || !m_copyEffect)
+        return;
+
     PostProcessParams emptyParams; // Default parameters
-    copyEffect->Apply(context, input, output, emptyParams);
+    RenderGraphTextureDesc desc(m_width, m_height, RenderGraphFormat::RGBA8);
+    m_copyEffect->ApplyPass(context, PostProcessPass::Copy, &input, 1, desc, output, desc, emptyParams);
 }
@@ -2,110 +2,98 @@
 
 #include <d3d11.h>
 #include <DirectXMath.h>
+#include <chrono>
 #include <string>
 #include <vector>
 #include <memory>
 #include <unordered_map>
+#include "PostProcessChain.h"
+#include "PostProcessKernels.h"
+#include "RenderGraph.h"
 
 using namespace DirectX;
 
 // Forward declarations
 class Shader;
-class Texture;
 
-// Post-process effect types
-enum class PostProcessEffect
+// Layout of the constant buffer (b0) every post-process shader declares
+struct PostProcessConstants
 {
-    None = 0,
-    Grayscale,
-    Sepia,
-    Invert,
-    Blur,
-    GaussianBlur,
-    Bloom,
-    ToneMapping,
-    FXAA,
-    Vignette,
-    ColorCorrection,
-    DepthOfField,
-    MotionBlur,
-    Count
-};
-
-// Post-process parameters structure
-struct PostProcessParams
-{
-    // General parameters
+    XMFLOAT2 texelSize;     // Of the pass's first input
     float intensity;
     float threshold;
-    float radius;
-    float sigma;
-
-    // Color parameters
-    XMFLOAT3 colorTint;
-    float contrast;
-    float brightness;
-    float saturation;
-    float gamma;
 
-    // Bloom parameters
     float bloomThreshold;
     float bloomIntensity;
-    int bloomBlurPasses;
-
-    // Tone mapping parameters
     float exposure;
     float whitePoint;
 
-    // FXAA parameters
-    float fxaaSpanMax;
-    float fxaaReduceMin;
-    float fxaaReduceMul;
-
-    // Vignette parameters
     float vignetteRadius;
     float vignetteSoftness;
+    float blurRadius;
+    float exposureKey;
+
     XMFLOAT3 vignetteColor;
+    float padding1;
 
-    PostProcessParams()
-        : intensity(1.0f)
-        , threshold(0.5f)
-        , radius(1.0f)
-        , sigma(1.0f)
-        , colorTint(1.0f, 1.0f, 1.0f)
-        , contrast(1.0f)
-        , brightness(0.0f)
-        , saturation(1.0f)
-        , gamma(2.2f)
-        , bloomThreshold(1.0f)
-        , bloomIntensity(1.0f)
-        , bloomBlurPasses(3)
-        , exposure(1.0f)
-        , whitePoint(1.0f)
-        , fxaaSpanMax(8.0f)
-        , fxaaReduceMin(1.0f/128.0f)
-        , fxaaReduceMul(1.0f/8.0f)
-        , vignetteRadius(0.8f)
-        , vignetteSoftness(0.2f)
-        , vignetteColor(0.0f, 0.0f, 0.0f)
-    {
-    }
+    XMFLOAT3 colorTint;
+    float contrast;
+
+    float brightness;
+    float saturation;
+    float gamma;
+    float padding2;
+};
+
+// Layout of the blur constant buffer (b1): merged Gaussian taps, the center
+// first; the others are fetched on both sides
+struct BlurConstants
+{
+    XMFLOAT4 taps[MAX_BLUR_TAPS];   // x: offset in steps, y: weight
+    XMFLOAT2 step;                  // UV distance of one step along the blur direction
+    int tapCount;
+    float padding;
+};
+
+// Layout of the auto-exposure constant buffer (b0 of its compute shaders)
+struct AutoExposureConstants
+{
+    UINT inputWidth;
+    UINT inputHeight;
+    float minLogLuminance;
+    float inverseLogLuminanceRange;
+
+    float logLuminanceRange;
+    float adaptationRate;       // AutoExposure::GetAdaptationRate of the frame time
+    float pixelCount;
+    float padding;
 };
 
-// Individual post-process effect
+// Shaders and parameter buffer of one effect. The effect runs as one or more
+// fullscreen passes (see PostProcessChain), applied by PostProcessManager.
+// The fullscreen vertex shader is created once by the manager and shared.
+// Per-pixel effects have no shaders of their own: their PerPixel pass is run
+// by an instance built from the list of effects it fuses.
 class PostProcessEffect_Base
 {
 public:
-    PostProcessEffect_Base(PostProcessEffect type);
+    explicit PostProcessEffect_Base(PostProcessEffect type);
+    explicit PostProcessEffect_Base(const std::vector<PostProcessEffect>& fusedEffects, bool autoExposure = false);
     virtual ~PostProcessEffect_Base();
 
-    // Effect application
-    virtual bool Initialize(ID3D11Device* device) = 0;
-    virtual void Apply(ID3D11DeviceContext* context,
-                      ID3D11ShaderResourceView* inputTexture,
-                      ID3D11RenderTargetView* outputTarget,
-                      const PostProcessParams& params) = 0;
-    virtual void Shutdown() = 0;
+    bool Initialize(ID3D11Device* device, const std::shared_ptr<Shader>& vertexShader);
+    void Shutdown();
+
+    // One pass of the effect; inputs are bound to t0, t1, ... and inputDesc
+    // describes the first of them
+    void ApplyPass(ID3D11DeviceContext* context,
+                   PostProcessPass pass,
+                   ID3D11ShaderResourceView* const* inputs,
+                   UINT inputCount,
+                   const RenderGraphTextureDesc& inputDesc,
+                   ID3D11RenderTargetView* outputTarget,
+                   const RenderGraphTextureDesc& outputDesc,
+                   const PostProcessParams& params);
 
     // Properties
     PostProcessEffect GetType() const { return m_type; }
@@ -113,87 +101,82 @@ public:
     bool IsEnabled() const { return m_enabled; }
     bool IsInitialized() const { return m_initialized; }
 
+protected:
+    std::string GetPixelShaderCode(PostProcessPass pass) const;
+    void UpdateParameterBuffer(ID3D11DeviceContext* context, const PostProcessParams& params,
+                               const RenderGraphTextureDesc& inputDesc);
+    void UpdateBlurBuffer(ID3D11DeviceContext* context, PostProcessPass pass, const PostProcessParams& params,
+                          const RenderGraphTextureDesc& inputDesc, const RenderGraphTextureDesc& outputDesc);
+    void DrawFullscreenTriangle(ID3D11DeviceContext* context);
+
 protected:
     PostProcessEffect m_type;
+    std::vector<PostProcessEffect> m_fusedEffects;
+    bool m_autoExposure;        // Fused tone mapping reads the adapted luminance
     bool m_enabled;
     bool m_initialized;
-};
 
-// Grayscale effect
-class GrayscaleEffect : public PostProcessEffect_Base
-{
-public:
-    GrayscaleEffect();
-    bool Initialize(ID3D11Device* device) override;
-    void Apply(ID3D11DeviceContext* context,
-              ID3D11ShaderResourceView* inputTexture,
-              ID3D11RenderTargetView* outputTarget,
-              const PostProcessParams& params) override;
-    void Shutdown() override;
+    std::shared_ptr<Shader> m_vertexShader;
+    std::unordered_map<int, std::shared_ptr<Shader>> m_pixelShaders;    // By PostProcessPass
+    ID3D11Buffer* m_parameterBuffer;
 
-private:
-    std::shared_ptr<Shader> m_shader;
-    ID3D11Buffer* m_constantBuffer;
+    // Blur effects only; the kernel is recomputed when the sigma changes
+    ID3D11Buffer* m_blurBuffer;
+    LinearGaussianKernel m_blurKernel;
+    float m_blurSigma;
 };
 
-// Blur effect
-class BlurEffect : public PostProcessEffect_Base
+// GPU side of auto-exposure (AutoExposure has the CPU reference). A compute
+// pass counts the input into a luminance histogram, one groupshared
+// histogram per 16x16 tile added to the buffer; a second one reduces the bins
+// to the average luminance, moves the adapted luminance toward it and clears
+// the histogram for the next frame. The adapted luminance stays on the GPU in
+// a 1x1 R32F texture the tone mapping reads.
+class AutoExposurePass
 {
 public:
-    BlurEffect();
-    bool Initialize(ID3D11Device* device) override;
-    void Apply(ID3D11DeviceContext* context,
-              ID3D11ShaderResourceView* inputTexture,
-              ID3D11RenderTargetView* outputTarget,
-              const PostProcessParams& params) override;
-    void Shutdown() override;
+    AutoExposurePass();
+    ~AutoExposurePass();
 
-private:
-    std::shared_ptr<Shader> m_horizontalBlurShader;
-    std::shared_ptr<Shader> m_verticalBlurShader;
-    ID3D11Buffer* m_constantBuffer;
-    std::shared_ptr<Texture> m_tempTexture;
-};
+    bool Initialize(ID3D11Device* device);
+    void Shutdown();
 
-// Bloom effect
-class BloomEffect : public PostProcessEffect_Base
-{
-public:
-    BloomEffect();
-    bool Initialize(ID3D11Device* device) override;
-    void Apply(ID3D11DeviceContext* context,
-              ID3D11ShaderResourceView* inputTexture,
-              ID3D11RenderTargetView* outputTarget,
-              const PostProcessParams& params) override;
-    void Shutdown() override;
+    void Dispatch(ID3D11DeviceContext* context,
+                  ID3D11ShaderResourceView* input,
+                  const RenderGraphTextureDesc& inputDesc,
+                  const PostProcessParams& params,
+                  float deltaTime);
 
-private:
-    std::shared_ptr<Shader> m_brightPassShader;
-    std::shared_ptr<Shader> m_combineShader;
-    std::shared_ptr<BlurEffect> m_blurEffect;
-    std::shared_ptr<Texture> m_brightPassTexture;
-    std::shared_ptr<Texture> m_blurTexture;
-    ID3D11Buffer* m_constantBuffer;
-};
+    // The first Dispatch after a reset takes the measured luminance as is
+    void Reset() { m_adapted = false; }
 
-// Tone mapping effect
-class ToneMappingEffect : public PostProcessEffect_Base
-{
-public:
-    ToneMappingEffect();
-    bool Initialize(ID3D11Device* device) override;
-    void Apply(ID3D11DeviceContext* context,
-              ID3D11ShaderResourceView* inputTexture,
-              ID3D11RenderTargetView* outputTarget,
-              const PostProcessParams& params) override;
-    void Shutdown() override;
+    ID3D11ShaderResourceView* GetLuminanceView() const { return m_luminanceView; }
+
+private:
+    void UpdateConstantBuffer(ID3D11DeviceContext* context, const RenderGraphTextureDesc& inputDesc,
+                              const PostProcessParams& params, float deltaTime);
 
 private:
-    std::shared_ptr<Shader> m_shader;
+    std::shared_ptr<Shader> m_histogramShader;
+    std::shared_ptr<Shader> m_averageShader;
     ID3D11Buffer* m_constantBuffer;
+
+    ID3D11Buffer* m_histogramBuffer;            // LUMINANCE_HISTOGRAM_BINS counts
+    ID3D11UnorderedAccessView* m_histogramAccess;
+
+    ID3D11Texture2D* m_luminanceTexture;        // Adapted luminance, kept across frames
+    ID3D11UnorderedAccessView* m_luminanceAccess;
+    ID3D11ShaderResourceView* m_luminanceView;
+
+    bool m_adapted;
 };
 
-// Main post-processing manager
+// Main post-processing manager. The enabled effects are turned into a render
+// graph (PostProcessChain::Build) whenever the chain or the size changes;
+// intermediates are transient graph textures, so targets whose lifetimes do
+// not overlap share one texture. They are HDR (R11G11B10F by default) so
+// tone mapping and the bloom threshold see values above 1; the scene input
+// should be HDR as well, the final output is the LDR back buffer.
 class PostProcessManager
 {
 public:
@@ -218,8 +201,8 @@ public:
 
     // Main processing function
     void Process(ID3D11DeviceContext* context,
-                ID3D11ShaderResourceView* inputTexture,
-                ID3D11RenderTargetView* finalOutput);
+                 ID3D11ShaderResourceView* inputTexture,
+                 ID3D11RenderTargetView* finalOutput);
 
     // Render target management
     void ResizeRenderTargets(ID3D11Device* device, int width, int height);
@@ -228,61 +211,120 @@ public:
     bool IsInitialized() const { return m_initialized; }
     int GetActiveEffectCount() const;
 
-    // Debug
+    // Graph of the current chain; compiled on the next Process after a change
+    const RenderGraph& GetRenderGraph() const { return m_graph; }
+
+    // Adjacent per-pixel effects run as one generated pass (default on)
+    void SetPassFusion(bool enabled);
+    bool IsPassFusionEnabled() const { return m_passFusion; }
+
+    // Format of the intermediate targets; RGBA16F keeps alpha and precision
+    // at twice the memory of R11G11B10F
+    void SetIntermediateFormat(RenderGraphFormat format);
+    RenderGraphFormat GetIntermediateFormat() const { return m_intermediateFormat; }
+
+    // Tone mapping exposure from a luminance histogram of its input, adapted
+    // over time (default off); params.exposure then compensates it
+    void SetAutoExposure(bool enabled);
+    bool IsAutoExposureEnabled() const { return m_autoExposure; }
+
+    // Device objects created by the post-process passes so far, across all
+    // managers; a Process that does not rebuild the graph adds none
+    static uint64_t GetCreatedDeviceObjectCount();
+
+    // Debug; prints the graph every time it is rebuilt
     void SetDebugMode(bool debug) { m_debugMode = debug; }
     bool IsDebugMode() const { return m_debugMode; }
 
 private:
-    void CreateRenderTargets(ID3D11Device* device, int width, int height);
-    void CreateFullscreenQuad(ID3D11Device* device);
-    void RenderFullscreenQuad(ID3D11DeviceContext* context);
-    std::shared_ptr<PostProcessEffect_Base> CreateEffect(PostProcessEffect effectType);
+    struct RenderTarget
+    {
+        ID3D11Texture2D* texture;
+        ID3D11RenderTargetView* renderTargetView;
+        ID3D11ShaderResourceView* shaderResourceView;
+    };
+
+    bool CreatePipelineStates();
+    void BindPipelineStates(ID3D11DeviceContext* context);
+    void UnbindPipelineStates(ID3D11DeviceContext* context);
+    bool BuildGraph();
+    bool CreateRenderTargets();
+    void ReleaseRenderTargets();
+    RenderGraph::ExecuteFunction BindPass(const PostProcessPassInfo& info);
+    PostProcessEffect_Base* GetFusedPass(const std::vector<PostProcessEffect>& effects, bool autoExposure);
+    ID3D11ShaderResourceView* GetShaderResourceView(RenderGraphResource resource) const;
+    ID3D11RenderTargetView* GetRenderTargetView(RenderGraphResource resource) const;
+    void CopyTexture(ID3D11DeviceContext* context,
+                     ID3D11ShaderResourceView* input,
+                     ID3D11RenderTargetView* output);
 
 private:
+    ID3D11Device* m_device;
+    int m_width;
+    int m_height;
+
     // Effects chain
-    std::vector<std::shared_ptr<PostProcessEffect_Base>> m_effects;
-    std::unordered_map<PostProcessEffect, std::shared_ptr<PostProcessEffect_Base>> m_effectMap;
+    std::unordered_map<PostProcessEffect, std::unique_ptr<PostProcessEffect_Base>> m_effects;
+    std::vector<PostProcessEffect> m_effectOrder;
+
+    // Generated per-pixel passes by fusion name; kept across graph rebuilds
+    std::unordered_map<std::string, std::unique_ptr<PostProcessEffect_Base>> m_fusedPasses;
+    bool m_passFusion;
+
+    RenderGraphFormat m_intermediateFormat;
+
+    // Auto-exposure; the pass is created when first enabled
+    bool m_autoExposure;
+    std::unique_ptr<AutoExposurePass> m_autoExposurePass;
+    std::chrono::steady_clock::time_point m_lastProcessTime;
+    float m_frameTime;
 
     // Parameters
     PostProcessParams m_parameters;
 
-    // Render targets for ping-pong rendering
-    std::shared_ptr<Texture> m_renderTarget1;
-    std::shared_ptr<Texture> m_renderTarget2;
+    // Render graph of the enabled effects and the physical textures behind
+    // its transient resources
+    RenderGraph m_graph;
+    RenderGraphResource m_sceneResource;
+    RenderGraphResource m_outputResource;
+    RenderGraphResource m_exposureResource;     // Adapted luminance, with auto-exposure
+    bool m_graphDirty;
+    std::vector<RenderTarget> m_renderTargets;
 
-    // Fullscreen quad for rendering
-    ID3D11Buffer* m_fullscreenQuadVB;
-    ID3D11Buffer* m_fullscreenQuadIB;
-    std::shared_ptr<Shader> m_fullscreenQuadShader;
+    // Bindings of the imported graph resources, valid during Process
+    ID3D11DeviceContext* m_context;
+    ID3D11ShaderResourceView* m_sceneInput;
+    ID3D11RenderTargetView* m_finalOutput;
 
     // State
     bool m_initialized;
     bool m_debugMode;
-    int m_width;
-    int m_height;
 
-    // Sampler states
-    ID3D11SamplerState* m_linearSampler;
-    ID3D11SamplerState* m_pointSampler;
+    // Objects shared by every pass, created once in Initialize
+    std::shared_ptr<Shader> m_vertexShader;
+    std::unique_ptr<PostProcessEffect_Base> m_copyEffect;
+    ID3D11SamplerState* m_samplerState;
+    ID3D11RasterizerState* m_rasterizerState;
+    ID3D11DepthStencilState* m_depthStencilState;
 };
 
-// Utility functions and shader code
+// Shader code
 namespace PostProcessShaders
 {
-    // Shader source code strings
-    extern const char* FULLSCREEN_QUAD_VS;
-    extern const char* GRAYSCALE_PS;
-    extern const char* BLUR_HORIZONTAL_PS;
-    extern const char* BLUR_VERTICAL_PS;
+    // Declarations shared by every pixel shader: inputs, sampler, constants
+    extern const char* COMMON;
+
+    extern const char* FULLSCREEN_TRIANGLE_VS;
+    extern const char* COPY_PS;
+    extern const char* BLUR_PS;
     extern const char* BLOOM_BRIGHT_PASS_PS;
+    extern const char* BLOOM_DOWNSAMPLE_PS;
+    extern const char* BLOOM_UPSAMPLE_PS;
     extern const char* BLOOM_COMBINE_PS;
-    extern const char* TONE_MAPPING_PS;
-    extern const char* SEPIA_PS;
-    extern const char* INVERT_PS;
-    extern const char* VIGNETTE_PS;
-    extern const char* COLOR_CORRECTION_PS;
-
-    // Utility functions
-    const char* GetEffectName(PostProcessEffect effect);
-    PostProcessEffect GetEffectFromName(const std::string& name);
+
+    // Auto-exposure compute shaders (AutoExposurePass); both follow
+    // AUTO_EXPOSURE_COMMON, the histogram buffer and constants
+    extern const char* AUTO_EXPOSURE_COMMON;
+    extern const char* LUMINANCE_HISTOGRAM_CS;
+    extern const char* LUMINANCE_AVERAGE_CS;
 }
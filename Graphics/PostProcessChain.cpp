@@ -0,0 +1,273 @@
+#include "PostProcessChain.h"
+#include "PostProcessKernels.h"
+#include "PostProcessFusion.h"
+#include <algorithm>
+
+namespace
+{
+    RenderGraphTextureDesc GetHalfDesc(const RenderGraphTextureDesc& desc)
+    {
+        return RenderGraphTextureDesc((desc.width + 1) / 2, (desc.height + 1) / 2, desc.format);
+    }
+
+    void DeclarePass(RenderGraph& graph,
+                     PostProcessEffect effect,
+                     PostProcessPass pass,
+                     std::initializer_list<RenderGraphResource> inputs,
+                     RenderGraphResource output,
+                     const PostProcessPassBinder& binder,
+                     const std::vector<PostProcessEffect>& fusedEffects = std::vector<PostProcessEffect>(),
+                     bool autoExposure = false)
+    {
+        PostProcessPassInfo info;
+        info.effect = effect;
+        info.pass = pass;
+        info.effects = fusedEffects;
+        info.autoExposure = autoExposure;
+
+        std::string name = PostProcessChain::GetPassName(pass);
+        if (!fusedEffects.empty())
+        {
+            name += " (" + PostProcessFusion::GetFusionName(fusedEffects) + ")";
+        }
+        info.graphPass = graph.AddPass(name);
+        for (RenderGraphResource input : inputs)
+        {
+            graph.Read(info.graphPass, input);
+            info.inputs[info.inputCount++] = input;
+        }
+        info.inputDesc = graph.GetResourceDesc(info.inputs[0]);
+        graph.Write(info.graphPass, output);
+        info.output = output;
+        info.outputDesc = graph.GetResourceDesc(output);
+
+        if (binder)
+        {
+            graph.SetPassFunction(info.graphPass, binder(info));
+        }
+    }
+
+    // One stage of the chain: a single effect, or a run of per-pixel effects
+    void DeclareStage(RenderGraph& graph,
+                      const std::vector<PostProcessEffect>& stage,
+                      RenderGraphResource input,
+                      RenderGraphResource output,
+                      const RenderGraphTextureDesc& desc,
+                      RenderGraphResource exposure,
+                      bool& exposureMeasured,
+                      const PostProcessPassBinder& binder)
+    {
+        PostProcessEffect effect = stage.front();
+        if (PostProcessFusion::IsPerPixelEffect(effect))
+        {
+            // Tone mapping leads its stage when auto-exposure is on, so the
+            // histogram measures exactly what it maps. The adapted luminance
+            // has one writer; a later tone mapping reuses the first measurement.
+            if (effect == PostProcessEffect::ToneMapping && exposure != INVALID_RENDER_GRAPH_HANDLE)
+            {
+                if (!exposureMeasured)
+                {
+                    DeclarePass(graph, effect, PostProcessPass::LuminanceHistogram, { input }, exposure, binder);
+                    exposureMeasured = true;
+                }
+                DeclarePass(graph, effect, PostProcessPass::PerPixel, { input, exposure }, output, binder, stage, true);
+                return;
+            }
+
+            DeclarePass(graph, effect, PostProcessPass::PerPixel, { input }, output, binder, stage);
+            return;
+        }
+
+        switch (effect)
+        {
+            case PostProcessEffect::Blur:
+            case PostProcessEffect::GaussianBlur:
+            {
+                RenderGraphResource horizontal = graph.CreateTexture("Blur Horizontal", GetHalfDesc(desc));
+
+                DeclarePass(graph, effect, PostProcessPass::BlurHorizontal, { input }, horizontal, binder);
+                DeclarePass(graph, effect, PostProcessPass::BlurVertical, { horizontal }, output, binder);
+                break;
+            }
+
+            case PostProcessEffect::Bloom:
+            {
+                // Highlights go down a pyramid starting at half resolution and
+                // come back up level by level; the combine reads the untouched
+                // scene as well
+                int mipCount = PostProcessKernels::GetBloomMipCount(desc.width, desc.height);
+
+                std::vector<RenderGraphResource> mips;
+                RenderGraphTextureDesc mipDesc = GetHalfDesc(desc);
+                mips.push_back(graph.CreateTexture("Bloom Mip 1", mipDesc));
+                DeclarePass(graph, effect, PostProcessPass::BloomBrightPass, { input }, mips[0], binder);
+
+                for (int level = 1; level < mipCount; ++level)
+                {
+                    mipDesc = GetHalfDesc(mipDesc);
+                    mips.push_back(graph.CreateTexture("Bloom Mip " + std::to_string(level + 1), mipDesc));
+                    DeclarePass(graph, effect, PostProcessPass::BloomDownsample, { mips[level - 1] }, mips[level], binder);
+                }
+
+                RenderGraphResource upsampled = mips[mipCount - 1];
+                for (int level = mipCount - 2; level >= 0; --level)
+                {
+                    RenderGraphResource next = graph.CreateTexture("Bloom Up " + std::to_string(level + 1),
+                                                                   graph.GetResourceDesc(mips[level]));
+                    DeclarePass(graph, effect, PostProcessPass::BloomUpsample, { upsampled, mips[level] }, next, binder);
+                    upsampled = next;
+                }
+
+                DeclarePass(graph, effect, PostProcessPass::BloomCombine, { input, upsampled }, output, binder);
+                break;
+            }
+
+            default:
+                DeclarePass(graph, effect, PostProcessPass::Copy, { input }, output, binder);
+                break;
+        }
+    }
+}
+
+namespace PostProcessChain
+{
+    const char* GetEffectName(PostProcessEffect effect)
+    {
+        switch (effect)
+        {
+            case PostProcessEffect::None:               return "None";
+            case PostProcessEffect::Grayscale:          return "Grayscale";
+            case PostProcessEffect::Sepia:              return "Sepia";
+            case PostProcessEffect::Invert:             return "Invert";
+            case PostProcessEffect::Blur:               return "Blur";
+            case PostProcessEffect::GaussianBlur:       return "GaussianBlur";
+            case PostProcessEffect::Bloom:              return "Bloom";
+            case PostProcessEffect::ToneMapping:        return "ToneMapping";
+            case PostProcessEffect::FXAA:               return "FXAA";
+            case PostProcessEffect::Vignette:           return "Vignette";
+            case PostProcessEffect::ColorCorrection:    return "ColorCorrection";
+            case PostProcessEffect::DepthOfField:       return "DepthOfField";
+            case PostProcessEffect::MotionBlur:         return "MotionBlur";
+            default:                                    return "Unknown";
+        }
+    }
+
+    PostProcessEffect GetEffectFromName(const std::string& name)
+    {
+        for (int i = 0; i < static_cast<int>(PostProcessEffect::Count); ++i)
+        {
+            PostProcessEffect effect = static_cast<PostProcessEffect>(i);
+            if (name == GetEffectName(effect))
+            {
+                return effect;
+            }
+        }
+        return PostProcessEffect::None;
+    }
+
+    const char* GetPassName(PostProcessPass pass)
+    {
+        switch (pass)
+        {
+            case PostProcessPass::Copy:             return "Copy";
+            case PostProcessPass::PerPixel:         return "PerPixel";
+            case PostProcessPass::BlurHorizontal:   return "BlurHorizontal";
+            case PostProcessPass::BlurVertical:     return "BlurVertical";
+            case PostProcessPass::BloomBrightPass:  return "BloomBrightPass";
+            case PostProcessPass::BloomDownsample:  return "BloomDownsample";
+            case PostProcessPass::BloomUpsample:    return "BloomUpsample";
+            case PostProcessPass::BloomCombine:     return "BloomCombine";
+            case PostProcessPass::LuminanceHistogram: return "LuminanceHistogram";
+            default:                                return "Unknown";
+        }
+    }
+
+    bool IsEffectSupported(PostProcessEffect effect)
+    {
+        switch (effect)
+        {
+            case PostProcessEffect::Grayscale:
+            case PostProcessEffect::Sepia:
+            case PostProcessEffect::Blur:
+            case PostProcessEffect::GaussianBlur:
+            case PostProcessEffect::Bloom:
+            case PostProcessEffect::ToneMapping:
+            case PostProcessEffect::Vignette:
+            case PostProcessEffect::ColorCorrection:
+                return true;
+            default:
+                return false;
+        }
+    }
+
+    std::vector<PostProcessPass> GetEffectPasses(PostProcessEffect effect)
+    {
+        if (PostProcessFusion::IsPerPixelEffect(effect))
+        {
+            return { PostProcessPass::PerPixel };
+        }
+
+        switch (effect)
+        {
+            case PostProcessEffect::Blur:
+            case PostProcessEffect::GaussianBlur:
+                return { PostProcessPass::BlurHorizontal, PostProcessPass::BlurVertical };
+            case PostProcessEffect::Bloom:
+                return { PostProcessPass::BloomBrightPass, PostProcessPass::BloomDownsample,
+                         PostProcessPass::BloomUpsample, PostProcessPass::BloomCombine };
+            default:
+                return { PostProcessPass::Copy };
+        }
+    }
+
+    void Build(RenderGraph& graph,
+               const std::vector<PostProcessEffect>& effects,
+               RenderGraphResource input,
+               RenderGraphResource output,
+               const RenderGraphTextureDesc& desc,
+               const PostProcessChainOptions& options,
+               const PostProcessPassBinder& binder)
+    {
+        bool autoExposure = options.exposure != INVALID_RENDER_GRAPH_HANDLE;
+
+        std::vector<std::vector<PostProcessEffect>> stages;
+        for (PostProcessEffect effect : effects)
+        {
+            if (!IsEffectSupported(effect))
+            {
+                continue;
+            }
+
+            bool fuse = options.fusePerPixel && !stages.empty() &&
+                        PostProcessFusion::IsPerPixelEffect(effect) &&
+                        PostProcessFusion::IsPerPixelEffect(stages.back().front()) &&
+                        !(autoExposure && effect == PostProcessEffect::ToneMapping);
+            if (fuse)
+            {
+                stages.back().push_back(effect);
+            }
+            else
+            {
+                stages.push_back({ effect });
+            }
+        }
+
+        if (stages.empty())
+        {
+            DeclarePass(graph, PostProcessEffect::None, PostProcessPass::Copy, { input }, output, binder);
+            return;
+        }
+
+        bool exposureMeasured = false;
+        RenderGraphResource current = input;
+        for (size_t i = 0; i < stages.size(); ++i)
+        {
+            bool last = i + 1 == stages.size();
+            RenderGraphResource target = last ? output :
+                graph.CreateTexture(PostProcessFusion::GetFusionName(stages[i]) + " Output", desc);
+
+            DeclareStage(graph, stages[i], current, target, desc, options.exposure, exposureMeasured, binder);
+            current = target;
+        }
+    }
+}
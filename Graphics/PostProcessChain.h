@@ -0,0 +1,189 @@
+#pragma once
+
+#include <DirectXMath.h>
+#include <functional>
+#include <string>
+#include <vector>
+#include "RenderGraph.h"
+
+using namespace DirectX;
+
+// Post-process effect types
+enum class PostProcessEffect
+{
+    None = 0,
+    Grayscale,
+    Sepia,
+    Invert,
+    Blur,
+    GaussianBlur,
+    Bloom,
+    ToneMapping,
+    FXAA,
+    Vignette,
+    ColorCorrection,
+    DepthOfField,
+    MotionBlur,
+    Count
+};
+
+// Post-process parameters structure
+struct PostProcessParams
+{
+    // General parameters
+    float intensity;
+    float threshold;
+    float radius;
+    float sigma;
+
+    // Color parameters
+    XMFLOAT3 colorTint;
+    float contrast;
+    float brightness;
+    float saturation;
+    float gamma;
+
+    // Bloom parameters
+    float bloomThreshold;
+    float bloomIntensity;
+    int bloomBlurPasses;
+
+    // Tone mapping parameters; with auto-exposure, exposure compensates the
+    // measured value
+    float exposure;
+    float whitePoint;
+
+    // Auto-exposure parameters (see AutoExposure)
+    float minLogLuminance;      // log2 range of the luminance histogram
+    float maxLogLuminance;
+    float adaptationSpeed;      // Per second
+    float exposureKey;          // Value the average luminance is mapped to
+
+    // FXAA parameters
+    float fxaaSpanMax;
+    float fxaaReduceMin;
+    float fxaaReduceMul;
+
+    // Vignette parameters
+    float vignetteRadius;
+    float vignetteSoftness;
+    XMFLOAT3 vignetteColor;
+
+    PostProcessParams()
+        : intensity(1.0f)
+        , threshold(0.5f)
+        , radius(1.0f)
+        , sigma(1.0f)
+        , colorTint(1.0f, 1.0f, 1.0f)
+        , contrast(1.0f)
+        , brightness(0.0f)
+        , saturation(1.0f)
+        , gamma(2.2f)
+        , bloomThreshold(1.0f)
+        , bloomIntensity(1.0f)
+        , bloomBlurPasses(3)
+        , exposure(1.0f)
+        , whitePoint(1.0f)
+        , minLogLuminance(-10.0f)
+        , maxLogLuminance(2.0f)
+        , adaptationSpeed(1.5f)
+        , exposureKey(0.18f)
+        , fxaaSpanMax(8.0f)
+        , fxaaReduceMin(1.0f/128.0f)
+        , fxaaReduceMul(1.0f/8.0f)
+        , vignetteRadius(0.8f)
+        , vignetteSoftness(0.2f)
+        , vignetteColor(0.0f, 0.0f, 0.0f)
+    {
+    }
+};
+
+// Fullscreen passes the effects are made of; each maps to one pixel shader
+enum class PostProcessPass
+{
+    Copy = 0,
+    PerPixel,           // Generated from one or more per-pixel effects (PostProcessFusion)
+    BlurHorizontal,     // To half resolution
+    BlurVertical,       // Back to full resolution
+    BloomBrightPass,    // Scene to half resolution (13-tap), dark pixels removed
+    BloomDownsample,    // 13-tap filter to the next pyramid level
+    BloomUpsample,      // Tent filter of the level below plus this level
+    BloomCombine,       // Scene plus the upsampled pyramid
+    LuminanceHistogram, // Histogram and adapted luminance of the tone mapping input (compute)
+    Count
+};
+
+// A pass declared by PostProcessChain::Build, handed to the binder so the
+// caller can attach what executes it
+struct PostProcessPassInfo
+{
+    PostProcessEffect effect;
+    PostProcessPass pass;
+    RenderGraphPass graphPass;
+    RenderGraphResource inputs[2];
+    int inputCount;
+    RenderGraphTextureDesc inputDesc;   // Of inputs[0]
+    RenderGraphResource output;
+    RenderGraphTextureDesc outputDesc;
+    std::vector<PostProcessEffect> effects;    // PerPixel: the effects applied, in order
+    bool autoExposure;                          // PerPixel: tone mapping reads the adapted luminance in inputs[1]
+
+    PostProcessPassInfo()
+        : effect(PostProcessEffect::None)
+        , pass(PostProcessPass::Copy)
+        , graphPass(INVALID_RENDER_GRAPH_HANDLE)
+        , inputCount(0)
+        , output(INVALID_RENDER_GRAPH_HANDLE)
+        , autoExposure(false)
+    {
+        inputs[0] = inputs[1] = INVALID_RENDER_GRAPH_HANDLE;
+    }
+};
+
+typedef std::function<RenderGraph::ExecuteFunction(const PostProcessPassInfo& info)> PostProcessPassBinder;
+
+// How PostProcessChain::Build lays out the passes
+struct PostProcessChainOptions
+{
+    // Adjacent per-pixel effects share one PerPixel pass
+    bool fusePerPixel;
+
+    // 1x1 R32F texture holding the adapted luminance across frames, imported
+    // by the caller. When valid, tone mapping starts a stage of its own and a
+    // LuminanceHistogram pass writing it runs on the stage's input.
+    RenderGraphResource exposure;
+
+    PostProcessChainOptions()
+        : fusePerPixel(true)
+        , exposure(INVALID_RENDER_GRAPH_HANDLE)
+    {
+    }
+};
+
+// Translation of an effect chain into render graph passes. Kept free of
+// Direct3D so the graph a chain produces can be inspected on any platform.
+namespace PostProcessChain
+{
+    const char* GetEffectName(PostProcessEffect effect);
+    PostProcessEffect GetEffectFromName(const std::string& name);
+    const char* GetPassName(PostProcessPass pass);
+
+    // False for effects without an implementation; Build skips them
+    bool IsEffectSupported(PostProcessEffect effect);
+
+    // Passes Build declares for the effect, in order (Copy for None)
+    std::vector<PostProcessPass> GetEffectPasses(PostProcessEffect effect);
+
+    // Declares the passes applying effects in order from input to output.
+    // Results between effects are transient textures of desc; blur adds a
+    // half-resolution intermediate and bloom a pyramid of GetBloomMipCount
+    // levels. With no supported effect a copy pass is declared. The binder
+    // (optional) gives each pass its function.
+    void Build(RenderGraph& graph,
+               const std::vector<PostProcessEffect>& effects,
+               RenderGraphResource input,
+               RenderGraphResource output,
+               const RenderGraphTextureDesc& desc,
+               const PostProcessChainOptions& options = PostProcessChainOptions(),
+               const PostProcessPassBinder& binder = PostProcessPassBinder());
+}
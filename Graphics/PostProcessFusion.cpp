@@ -0,0 +1,276 @@
+#include "PostProcessFusion.h"
+#include "AutoExposure.h"
+#include <algorithm>
+#include <cmath>
+
+namespace
+{
+    // HLSL of each per-pixel effect; every function maps the color of the
+    // pixel at uv and must match ApplyEffect below
+    const char* GRAYSCALE_FUNCTION = R"(
+float4 ApplyGrayscale(float4 color, float2 uv)
+{
+    float gray = dot(color.rgb, float3(0.299, 0.587, 0.114));
+    color.rgb = lerp(color.rgb, float3(gray, gray, gray), intensity);
+    return color;
+}
+)";
+
+    const char* SEPIA_FUNCTION = R"(
+float4 ApplySepia(float4 color, float2 uv)
+{
+    float3 sepia = float3(dot(color.rgb, float3(0.393, 0.769, 0.189)),
+                          dot(color.rgb, float3(0.349, 0.686, 0.168)),
+                          dot(color.rgb, float3(0.272, 0.534, 0.131)));
+    color.rgb = lerp(color.rgb, sepia, intensity);
+    return color;
+}
+)";
+
+    const char* COLOR_CORRECTION_FUNCTION = R"(
+float4 ApplyColorCorrection(float4 color, float2 uv)
+{
+    color.rgb = (color.rgb - 0.5) * contrast + 0.5 + brightness;
+    float luma = dot(color.rgb, float3(0.2126, 0.7152, 0.0722));
+    color.rgb = lerp(float3(luma, luma, luma), color.rgb, saturation) * colorTint;
+    return color;
+}
+)";
+
+    const char* TONE_MAPPING_FUNCTION = R"(
+float4 ApplyToneMapping(float4 color, float2 uv)
+{
+    // Exposure, Reinhard and gamma correction
+    color.rgb *= GetExposure();
+    color.rgb = color.rgb / (color.rgb + whitePoint);
+    color.rgb = pow(max(color.rgb, 0.0), 1.0 / gamma);
+    return color;
+}
+)";
+
+    // Exposure of the tone mapping: the constant, or the constant scaling
+    // the adapted luminance bound to t1 (AutoExposure::GetExposure)
+    const char* MANUAL_EXPOSURE_FUNCTION = R"(
+float GetExposure()
+{
+    return exposure;
+}
+)";
+
+    const char* AUTO_EXPOSURE_FUNCTION = R"(
+float GetExposure()
+{
+    return exposure * exposureKey / max(secondTexture.Load(int3(0, 0, 0)).r, 0.0001);
+}
+)";
+
+    const char* VIGNETTE_FUNCTION = R"(
+float4 ApplyVignette(float4 color, float2 uv)
+{
+    float dist = distance(uv, float2(0.5, 0.5));
+    float vignette = 1.0 - smoothstep(vignetteRadius, vignetteRadius + vignetteSoftness, dist);
+    color.rgb = lerp(vignetteColor, color.rgb, vignette);
+    return color;
+}
+)";
+
+    const char* GetFunctionCode(PostProcessEffect effect)
+    {
+        switch (effect)
+        {
+            case PostProcessEffect::Grayscale:          return GRAYSCALE_FUNCTION;
+            case PostProcessEffect::Sepia:              return SEPIA_FUNCTION;
+            case PostProcessEffect::ColorCorrection:    return COLOR_CORRECTION_FUNCTION;
+            case PostProcessEffect::ToneMapping:        return TONE_MAPPING_FUNCTION;
+            case PostProcessEffect::Vignette:           return VIGNETTE_FUNCTION;
+            default:                                    return nullptr;
+        }
+    }
+
+    float Lerp(float a, float b, float t)
+    {
+        return a + (b - a) * t;
+    }
+
+    float SmoothStep(float edge0, float edge1, float x)
+    {
+        float t = std::min(std::max((x - edge0) / (edge1 - edge0), 0.0f), 1.0f);
+        return t * t * (3.0f - 2.0f * t);
+    }
+
+    float Dot(const XMFLOAT4& color, float r, float g, float b)
+    {
+        return color.x * r + color.y * g + color.z * b;
+    }
+
+    // ApplyEffect with the exposure tone mapping scales by, the one
+    // GetExposure of the generated code returns
+    XMFLOAT4 ApplyEffectWithExposure(PostProcessEffect effect, const XMFLOAT4& color, float u, float v,
+                                     const PostProcessParams& params, float exposure)
+    {
+        XMFLOAT4 result = color;
+
+        switch (effect)
+        {
+            case PostProcessEffect::Grayscale:
+            {
+                float gray = Dot(color, 0.299f, 0.587f, 0.114f);
+                result.x = Lerp(color.x, gray, params.intensity);
+                result.y = Lerp(color.y, gray, params.intensity);
+                result.z = Lerp(color.z, gray, params.intensity);
+                break;
+            }
+
+            case PostProcessEffect::Sepia:
+            {
+                result.x = Lerp(color.x, Dot(color, 0.393f, 0.769f, 0.189f), params.intensity);
+                result.y = Lerp(color.y, Dot(color, 0.349f, 0.686f, 0.168f), params.intensity);
+                result.z = Lerp(color.z, Dot(color, 0.272f, 0.534f, 0.131f), params.intensity);
+                break;
+            }
+
+            case PostProcessEffect::ColorCorrection:
+            {
+                result.x = (color.x - 0.5f) * params.contrast + 0.5f + params.brightness;
+                result.y = (color.y - 0.5f) * params.contrast + 0.5f + params.brightness;
+                result.z = (color.z - 0.5f) * params.contrast + 0.5f + params.brightness;
+
+                float luma = Dot(result, 0.2126f, 0.7152f, 0.0722f);
+                result.x = Lerp(luma, result.x, params.saturation) * params.colorTint.x;
+                result.y = Lerp(luma, result.y, params.saturation) * params.colorTint.y;
+                result.z = Lerp(luma, result.z, params.saturation) * params.colorTint.z;
+                break;
+            }
+
+            case PostProcessEffect::ToneMapping:
+            {
+                float* channels[3] = { &result.x, &result.y, &result.z };
+                for (float* channel : channels)
+                {
+                    float exposed = *channel * exposure;
+                    exposed = exposed / (exposed + params.whitePoint);
+                    *channel = std::pow(std::max(exposed, 0.0f), 1.0f / params.gamma);
+                }
+                break;
+            }
+
+            case PostProcessEffect::Vignette:
+            {
+                float dist = std::sqrt((u - 0.5f) * (u - 0.5f) + (v - 0.5f) * (v - 0.5f));
+                float vignette = 1.0f - SmoothStep(params.vignetteRadius,
+                                                   params.vignetteRadius + params.vignetteSoftness, dist);
+                result.x = Lerp(params.vignetteColor.x, color.x, vignette);
+                result.y = Lerp(params.vignetteColor.y, color.y, vignette);
+                result.z = Lerp(params.vignetteColor.z, color.z, vignette);
+                break;
+            }
+
+            default:
+                break;
+        }
+
+        return result;
+    }
+
+    void ApplyReferenceWithExposure(const PostProcessImage& source, PostProcessImage& destination,
+                                    const std::vector<PostProcessEffect>& effects, const PostProcessParams& params,
+                                    float exposure)
+    {
+        for (int y = 0; y < destination.height; ++y)
+        {
+            float v = (y + 0.5f) / destination.height;
+            for (int x = 0; x < destination.width; ++x)
+            {
+                float u = (x + 0.5f) / destination.width;
+
+                XMFLOAT4 color = source.At(x, y);
+                for (PostProcessEffect effect : effects)
+                {
+                    color = ApplyEffectWithExposure(effect, color, u, v, params, exposure);
+                }
+                destination.At(x, y) = color;
+            }
+        }
+    }
+}
+
+namespace PostProcessFusion
+{
+    bool IsPerPixelEffect(PostProcessEffect effect)
+    {
+        return GetFunctionCode(effect) != nullptr;
+    }
+
+    std::string GetFusionName(const std::vector<PostProcessEffect>& effects)
+    {
+        std::string name;
+        for (PostProcessEffect effect : effects)
+        {
+            if (!name.empty())
+            {
+                name += "+";
+            }
+            name += PostProcessChain::GetEffectName(effect);
+        }
+        return name;
+    }
+
+    std::string GenerateShader(const std::vector<PostProcessEffect>& effects, bool autoExposure)
+    {
+        std::string functions = autoExposure ? AUTO_EXPOSURE_FUNCTION : MANUAL_EXPOSURE_FUNCTION;
+        std::string calls;
+        std::vector<PostProcessEffect> declared;
+
+        for (PostProcessEffect effect : effects)
+        {
+            const char* code = GetFunctionCode(effect);
+            if (!code)
+            {
+                continue;
+            }
+
+            if (std::find(declared.begin(), declared.end(), effect) == declared.end())
+            {
+                functions += code;
+                declared.push_back(effect);
+            }
+            calls += std::string("    color = Apply") + PostProcessChain::GetEffectName(effect) + "(color, input.texCoord);\n";
+        }
+
+        return functions +
+            "\n// Fused: " + GetFusionName(effects) + (autoExposure ? " (auto-exposure)" : "") + "\n"
+            "float4 main(PSInput input) : SV_TARGET\n"
+            "{\n"
+            "    float4 color = inputTexture.Sample(linearSampler, input.texCoord);\n" +
+            calls +
+            "    return color;\n"
+            "}\n";
+    }
+
+    XMFLOAT4 ApplyEffect(PostProcessEffect effect, const XMFLOAT4& color, float u, float v,
+                         const PostProcessParams& params)
+    {
+        return ApplyEffectWithExposure(effect, color, u, v, params, params.exposure);
+    }
+
+    XMFLOAT4 ApplyEffect(PostProcessEffect effect, const XMFLOAT4& color, float u, float v,
+                         const PostProcessParams& params, float adaptedLuminance)
+    {
+        return ApplyEffectWithExposure(effect, color, u, v, params,
+                                       AutoExposure::GetExposure(adaptedLuminance, params));
+    }
+
+    void ApplyReference(const PostProcessImage& source, PostProcessImage& destination,
+                        const std::vector<PostProcessEffect>& effects, const PostProcessParams& params)
+    {
+        ApplyReferenceWithExposure(source, destination, effects, params, params.exposure);
+    }
+
+    void ApplyReference(const PostProcessImage& source, PostProcessImage& destination,
+                        const std::vector<PostProcessEffect>& effects, const PostProcessParams& params,
+                        float adaptedLuminance)
+    {
+        ApplyReferenceWithExposure(source, destination, effects, params,
+                                   AutoExposure::GetExposure(adaptedLuminance, params));
+    }
+}
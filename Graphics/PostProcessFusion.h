@@ -0,0 +1,44 @@
+#pragma once
+
+#include <string>
+#include <vector>
+#include "PostProcessChain.h"
+#include "PostProcessKernels.h"
+
+// Fusion of per-pixel effects. Effects that only read the pixel they write
+// (grayscale, sepia, color correction, tone mapping, vignette) are chained in
+// a single generated pixel shader, so a run of them costs one read and one
+// write of the frame instead of one of each per effect. Unfused effects use
+// the same generated code with a single effect.
+namespace PostProcessFusion
+{
+    bool IsPerPixelEffect(PostProcessEffect effect);
+
+    // "Grayscale+Vignette"; also names the fused pass and its output
+    std::string GetFusionName(const std::vector<PostProcessEffect>& effects);
+
+    // Pixel shader body applying effects in order. It relies on the inputs,
+    // sampler and constant buffer of PostProcessShaders::COMMON, which the
+    // caller prepends. With autoExposure the tone mapping exposure comes from
+    // the adapted luminance in the second input.
+    std::string GenerateShader(const std::vector<PostProcessEffect>& effects, bool autoExposure = false);
+
+    // CPU reference of the generated code: one effect on one pixel at (u, v).
+    // Tone mapping uses params.exposure, as the shader generated without
+    // auto-exposure does.
+    XMFLOAT4 ApplyEffect(PostProcessEffect effect, const XMFLOAT4& color, float u, float v,
+                         const PostProcessParams& params);
+
+    // Reference of the auto-exposure shader: tone mapping scales by the
+    // exposure of the adapted luminance (AutoExposure::GetExposure)
+    XMFLOAT4 ApplyEffect(PostProcessEffect effect, const XMFLOAT4& color, float u, float v,
+                         const PostProcessParams& params, float adaptedLuminance);
+
+    // Whole fused pass over an image of the same size, without and with
+    // auto-exposure
+    void ApplyReference(const PostProcessImage& source, PostProcessImage& destination,
+                        const std::vector<PostProcessEffect>& effects, const PostProcessParams& params);
+    void ApplyReference(const PostProcessImage& source, PostProcessImage& destination,
+                        const std::vector<PostProcessEffect>& effects, const PostProcessParams& params,
+                        float adaptedLuminance);
+}
@@ -0,0 +1,315 @@
+#include "PostProcessKernels.h"
+#include <algorithm>
+#include <cmath>
+
+namespace
+{
+    XMFLOAT4 Add(const XMFLOAT4& a, const XMFLOAT4& b)
+    {
+        return XMFLOAT4(a.x + b.x, a.y + b.y, a.z + b.z, a.w + b.w);
+    }
+
+    XMFLOAT4 Scale(const XMFLOAT4& a, float s)
+    {
+        return XMFLOAT4(a.x * s, a.y * s, a.z * s, a.w * s);
+    }
+
+    // Halved size of a pyramid level, as the render graph declares it
+    int HalfSize(int size)
+    {
+        return (size + 1) / 2;
+    }
+
+    PostProcessImage CreateHalfImage(int width, int height)
+    {
+        return PostProcessImage(HalfSize(width), HalfSize(height));
+    }
+
+    // Runs a per-pixel function over destination with the UV of each texel center
+    template<typename Function>
+    void ForEachPixel(PostProcessImage& destination, Function function)
+    {
+        float invWidth = 1.0f / destination.width;
+        float invHeight = 1.0f / destination.height;
+
+        for (int y = 0; y < destination.height; ++y)
+        {
+            float v = (y + 0.5f) * invHeight;
+            for (int x = 0; x < destination.width; ++x)
+            {
+                float u = (x + 0.5f) * invWidth;
+                destination.At(x, y) = function(u, v);
+            }
+        }
+    }
+}
+
+XMFLOAT4 PostProcessImage::Sample(float u, float v) const
+{
+    float x = u * width - 0.5f;
+    float y = v * height - 0.5f;
+    float x0 = std::floor(x);
+    float y0 = std::floor(y);
+    float fx = x - x0;
+    float fy = y - y0;
+
+    int left = std::min(std::max(static_cast<int>(x0), 0), width - 1);
+    int right = std::min(std::max(static_cast<int>(x0) + 1, 0), width - 1);
+    int top = std::min(std::max(static_cast<int>(y0), 0), height - 1);
+    int bottom = std::min(std::max(static_cast<int>(y0) + 1, 0), height - 1);
+
+    XMFLOAT4 upper = Add(Scale(At(left, top), 1.0f - fx), Scale(At(right, top), fx));
+    XMFLOAT4 lower = Add(Scale(At(left, bottom), 1.0f - fx), Scale(At(right, bottom), fx));
+    return Add(Scale(upper, 1.0f - fy), Scale(lower, fy));
+}
+
+namespace PostProcessKernels
+{
+    GaussianKernel ComputeGaussianKernel(float sigma, int radius)
+    {
+        GaussianKernel kernel;
+        radius = std::min(std::max(radius, 0), MAX_BLUR_RADIUS);
+        sigma = std::max(sigma, 0.01f);
+
+        kernel.weights.resize(radius + 1);
+        float total = 0.0f;
+        for (int i = 0; i <= radius; ++i)
+        {
+            kernel.weights[i] = std::exp(-(i * i) / (2.0f * sigma * sigma));
+            total += i == 0 ? kernel.weights[i] : 2.0f * kernel.weights[i];
+        }
+
+        for (float& weight : kernel.weights)
+        {
+            weight /= total;
+        }
+        return kernel;
+    }
+
+    LinearGaussianKernel ComputeLinearKernel(const GaussianKernel& kernel)
+    {
+        LinearGaussianKernel linear;
+        if (kernel.weights.empty())
+        {
+            return linear;
+        }
+
+        linear.offsets.push_back(0.0f);
+        linear.weights.push_back(kernel.weights[0]);
+
+        // Texels 1-2, 3-4, ...; an odd radius leaves the last texel alone
+        for (size_t i = 1; i < kernel.weights.size(); i += 2)
+        {
+            float weight1 = kernel.weights[i];
+            float weight2 = i + 1 < kernel.weights.size() ? kernel.weights[i + 1] : 0.0f;
+            float weight = weight1 + weight2;
+
+            linear.offsets.push_back((i * weight1 + (i + 1) * weight2) / weight);
+            linear.weights.push_back(weight);
+        }
+        return linear;
+    }
+
+    int GetBlurRadius(float sigma)
+    {
+        int radius = static_cast<int>(std::ceil(2.0f * sigma));
+        return std::min(std::max(radius, 1), MAX_BLUR_RADIUS);
+    }
+
+    float GetBlurSigma(const PostProcessParams& params)
+    {
+        // The default sigma of 1 gives the footprint of the former 9x9 kernel
+        return 2.0f * params.sigma;
+    }
+
+    LinearGaussianKernel ComputeBlurKernel(const PostProcessParams& params)
+    {
+        float sigma = GetBlurSigma(params);
+        return ComputeLinearKernel(ComputeGaussianKernel(sigma, GetBlurRadius(sigma)));
+    }
+
+    float GetBlurStep(int inputSize, int outputSize, float radius)
+    {
+        return radius / static_cast<float>(std::max(std::min(inputSize, outputSize), 1));
+    }
+
+    int GetBloomMipCount(int width, int height)
+    {
+        int count = 1;
+        int size = std::min(HalfSize(width), HalfSize(height));
+        while (count < MAX_BLOOM_MIPS && HalfSize(size) >= MIN_BLOOM_MIP_SIZE)
+        {
+            size = HalfSize(size);
+            count++;
+        }
+        return count;
+    }
+
+    void BlurPass(const PostProcessImage& source, PostProcessImage& destination,
+                  const LinearGaussianKernel& kernel, float stepU, float stepV)
+    {
+        ForEachPixel(destination, [&](float u, float v)
+        {
+            XMFLOAT4 color = Scale(source.Sample(u, v), kernel.weights[0]);
+            for (size_t i = 1; i < kernel.offsets.size(); ++i)
+            {
+                float offsetU = stepU * kernel.offsets[i];
+                float offsetV = stepV * kernel.offsets[i];
+                XMFLOAT4 pair = Add(source.Sample(u + offsetU, v + offsetV), source.Sample(u - offsetU, v - offsetV));
+                color = Add(color, Scale(pair, kernel.weights[i]));
+            }
+            return color;
+        });
+    }
+
+    void BlurPassDiscrete(const PostProcessImage& source, PostProcessImage& destination,
+                          const GaussianKernel& kernel, bool horizontal)
+    {
+        int radius = static_cast<int>(kernel.weights.size()) - 1;
+
+        for (int y = 0; y < destination.height; ++y)
+        {
+            for (int x = 0; x < destination.width; ++x)
+            {
+                XMFLOAT4 color(0.0f, 0.0f, 0.0f, 0.0f);
+                for (int i = -radius; i <= radius; ++i)
+                {
+                    int sampleX = horizontal ? std::min(std::max(x + i, 0), source.width - 1) : x;
+                    int sampleY = horizontal ? y : std::min(std::max(y + i, 0), source.height - 1);
+                    color = Add(color, Scale(source.At(sampleX, sampleY), kernel.weights[std::abs(i)]));
+                }
+                destination.At(x, y) = color;
+            }
+        }
+    }
+
+    void Downsample13(const PostProcessImage& source, PostProcessImage& destination)
+    {
+        float texelU = 1.0f / source.width;
+        float texelV = 1.0f / source.height;
+
+        ForEachPixel(destination, [&](float u, float v)
+        {
+            auto tap = [&](float x, float y) { return source.Sample(u + x * texelU, v + y * texelV); };
+
+            // Outer 3x3 grid two texels apart, inner 2x2 box one texel apart
+            XMFLOAT4 corners = Add(Add(tap(-2.0f, -2.0f), tap(2.0f, -2.0f)), Add(tap(-2.0f, 2.0f), tap(2.0f, 2.0f)));
+            XMFLOAT4 edges = Add(Add(tap(0.0f, -2.0f), tap(-2.0f, 0.0f)), Add(tap(2.0f, 0.0f), tap(0.0f, 2.0f)));
+            XMFLOAT4 inner = Add(Add(tap(-1.0f, -1.0f), tap(1.0f, -1.0f)), Add(tap(-1.0f, 1.0f), tap(1.0f, 1.0f)));
+            XMFLOAT4 center = tap(0.0f, 0.0f);
+
+            XMFLOAT4 color = Scale(center, 0.125f);
+            color = Add(color, Scale(corners, 0.03125f));
+            color = Add(color, Scale(edges, 0.0625f));
+            color = Add(color, Scale(inner, 0.125f));
+            return color;
+        });
+    }
+
+    void BrightPass(const PostProcessImage& source, PostProcessImage& destination, float threshold)
+    {
+        Downsample13(source, destination);
+
+        for (XMFLOAT4& color : destination.pixels)
+        {
+            float brightness = color.x * 0.2126f + color.y * 0.7152f + color.z * 0.0722f;
+            if (brightness <= threshold)
+            {
+                color.x = color.y = color.z = 0.0f;
+            }
+        }
+    }
+
+    void UpsampleTent(const PostProcessImage& lower, const PostProcessImage& current,
+                      PostProcessImage& destination, float radius)
+    {
+        float texelU = radius / lower.width;
+        float texelV = radius / lower.height;
+
+        ForEachPixel(destination, [&](float u, float v)
+        {
+            auto tap = [&](float x, float y) { return lower.Sample(u + x * texelU, v + y * texelV); };
+
+            // 3x3 tent: 1 2 1 / 2 4 2 / 1 2 1, over 16
+            XMFLOAT4 corners = Add(Add(tap(-1.0f, -1.0f), tap(1.0f, -1.0f)), Add(tap(-1.0f, 1.0f), tap(1.0f, 1.0f)));
+            XMFLOAT4 edges = Add(Add(tap(0.0f, -1.0f), tap(-1.0f, 0.0f)), Add(tap(1.0f, 0.0f), tap(0.0f, 1.0f)));
+            XMFLOAT4 center = tap(0.0f, 0.0f);
+
+            XMFLOAT4 color = Add(Add(Scale(center, 4.0f), Scale(edges, 2.0f)), corners);
+            return Add(current.Sample(u, v), Scale(color, 1.0f / 16.0f));
+        });
+    }
+
+    void GaussianBlur(const PostProcessImage& source, PostProcessImage& destination, const PostProcessParams& params)
+    {
+        LinearGaussianKernel kernel = ComputeBlurKernel(params);
+
+        // Horizontal at half resolution, vertical back to the destination size
+        PostProcessImage horizontal = CreateHalfImage(destination.width, destination.height);
+        BlurPass(source, horizontal, kernel, GetBlurStep(source.width, horizontal.width, params.radius), 0.0f);
+        BlurPass(horizontal, destination, kernel, 0.0f, GetBlurStep(horizontal.height, destination.height, params.radius));
+    }
+
+    void Bloom(const PostProcessImage& source, PostProcessImage& destination, const PostProcessParams& params)
+    {
+        int mipCount = GetBloomMipCount(destination.width, destination.height);
+
+        std::vector<PostProcessImage> mips;
+        mips.push_back(CreateHalfImage(destination.width, destination.height));
+        BrightPass(source, mips[0], params.bloomThreshold);
+
+        for (int level = 1; level < mipCount; ++level)
+        {
+            mips.push_back(CreateHalfImage(mips[level - 1].width, mips[level - 1].height));
+            Downsample13(mips[level - 1], mips[level]);
+        }
+
+        PostProcessImage upsampled = mips[mipCount - 1];
+        for (int level = mipCount - 2; level >= 0; --level)
+        {
+            PostProcessImage next(mips[level].width, mips[level].height);
+            UpsampleTent(upsampled, mips[level], next, params.radius);
+            upsampled = std::move(next);
+        }
+
+        ForEachPixel(destination, [&](float u, float v)
+        {
+            XMFLOAT4 scene = source.Sample(u, v);
+            XMFLOAT4 bloom = upsampled.Sample(u, v);
+            return XMFLOAT4(scene.x + bloom.x * params.bloomIntensity,
+                            scene.y + bloom.y * params.bloomIntensity,
+                            scene.z + bloom.z * params.bloomIntensity,
+                            scene.w);
+        });
+    }
+
+    uint64_t GetGaussianBlurFetches(int width, int height, const PostProcessParams& params)
+    {
+        uint64_t fetchesPerPixel = 2 * ComputeBlurKernel(params).offsets.size() - 1;
+        uint64_t halfPixels = static_cast<uint64_t>(HalfSize(width)) * HalfSize(height);
+        uint64_t fullPixels = static_cast<uint64_t>(width) * height;
+        return fetchesPerPixel * (halfPixels + fullPixels);
+    }
+
+    uint64_t GetBloomFetches(int width, int height)
+    {
+        int mipCount = GetBloomMipCount(width, height);
+        uint64_t fetches = 2 * static_cast<uint64_t>(width) * height;      // Combine
+
+        int mipWidth = width;
+        int mipHeight = height;
+        for (int level = 0; level < mipCount; ++level)
+        {
+            mipWidth = HalfSize(mipWidth);
+            mipHeight = HalfSize(mipHeight);
+            uint64_t pixels = static_cast<uint64_t>(mipWidth) * mipHeight;
+
+            fetches += 13 * pixels;             // Bright pass or downsample into this level
+            if (level + 1 < mipCount)
+            {
+                fetches += 10 * pixels;         // Tent upsample into this level plus its own mip
+            }
+        }
+        return fetches;
+    }
+}
@@ -0,0 +1,101 @@
+#pragma once
+
+#include <DirectXMath.h>
+#include <cstdint>
+#include <vector>
+#include "PostProcessChain.h"
+
+using namespace DirectX;
+
+// Largest discrete blur radius in texels; the blur constant buffer (b1)
+// holds the merged taps of a kernel this wide
+const int MAX_BLUR_RADIUS = 16;
+const int MAX_BLUR_TAPS = 1 + MAX_BLUR_RADIUS / 2;
+
+// Bloom pyramid: level 1 is half resolution, each further level halves
+// again while the smaller side stays at least MIN_BLOOM_MIP_SIZE
+const int MAX_BLOOM_MIPS = 6;
+const int MIN_BLOOM_MIP_SIZE = 8;
+
+// One side of a normalized discrete Gaussian; weights[0] is the center
+struct GaussianKernel
+{
+    std::vector<float> weights;
+};
+
+// The same kernel for bilinear sampling: each pair of neighbouring texels is
+// fetched once at the point between them that reproduces both weights.
+// offsets[0] is the center (0); the other taps are applied on both sides.
+struct LinearGaussianKernel
+{
+    std::vector<float> offsets;     // In texels
+    std::vector<float> weights;
+};
+
+// RGBA float image for the reference passes. Sample filters bilinearly with
+// clamp addressing, like the post-process sampler.
+struct PostProcessImage
+{
+    int width;
+    int height;
+    std::vector<XMFLOAT4> pixels;
+
+    PostProcessImage()
+        : width(0)
+        , height(0)
+    {
+    }
+
+    PostProcessImage(int imageWidth, int imageHeight)
+        : width(imageWidth)
+        , height(imageHeight)
+        , pixels(static_cast<size_t>(imageWidth) * imageHeight, XMFLOAT4(0.0f, 0.0f, 0.0f, 0.0f))
+    {
+    }
+
+    XMFLOAT4& At(int x, int y) { return pixels[static_cast<size_t>(y) * width + x]; }
+    const XMFLOAT4& At(int x, int y) const { return pixels[static_cast<size_t>(y) * width + x]; }
+
+    XMFLOAT4 Sample(float u, float v) const;
+};
+
+// Blur and bloom kernels. The weights are computed here and uploaded by the
+// Direct3D passes; the reference passes run the shaders' math on the CPU, so
+// their output can serve as golden images and their fetch counts as a cost
+// model on any platform.
+namespace PostProcessKernels
+{
+    // Kernel construction
+    GaussianKernel ComputeGaussianKernel(float sigma, int radius);
+    LinearGaussianKernel ComputeLinearKernel(const GaussianKernel& kernel);
+    int GetBlurRadius(float sigma);                     // ceil(2 sigma), clamped to MAX_BLUR_RADIUS
+
+    // Kernel of the Blur effect: params.sigma scaled to half-resolution
+    // texels, params.radius spreads the taps
+    float GetBlurSigma(const PostProcessParams& params);
+    LinearGaussianKernel ComputeBlurKernel(const PostProcessParams& params);
+
+    // UV distance of one tap step for a pass from inputSize to outputSize
+    // texels along the blur direction; steps are in the smaller image's texels
+    float GetBlurStep(int inputSize, int outputSize, float radius);
+
+    int GetBloomMipCount(int width, int height);
+
+    // Reference passes; destination must be sized by the caller
+    void BlurPass(const PostProcessImage& source, PostProcessImage& destination,
+                  const LinearGaussianKernel& kernel, float stepU, float stepV);
+    void BlurPassDiscrete(const PostProcessImage& source, PostProcessImage& destination,
+                          const GaussianKernel& kernel, bool horizontal);   // Same size, one fetch per texel
+    void Downsample13(const PostProcessImage& source, PostProcessImage& destination);
+    void BrightPass(const PostProcessImage& source, PostProcessImage& destination, float threshold);
+    void UpsampleTent(const PostProcessImage& lower, const PostProcessImage& current,
+                      PostProcessImage& destination, float radius);
+
+    // Whole effects as PostProcessChain declares them
+    void GaussianBlur(const PostProcessImage& source, PostProcessImage& destination, const PostProcessParams& params);
+    void Bloom(const PostProcessImage& source, PostProcessImage& destination, const PostProcessParams& params);
+
+    // Texture fetches of one application at the given output size
+    uint64_t GetGaussianBlurFetches(int width, int height, const PostProcessParams& params);
+    uint64_t GetBloomFetches(int width, int height);
+}
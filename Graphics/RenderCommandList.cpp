@@ -0,0 +1,68 @@
+#include "RenderCommandList.h"
+#include "DrawBatching.h"
+
+RenderCommandList::RenderCommandList()
+    : m_drawCount(0)
+{
+}
+
+RenderCommandList::~RenderCommandList()
+{
+}
+
+void RenderCommandList::Reset()
+{
+    // Keep capacity so steady-state frames do not allocate
+    m_commands.clear();
+    m_drawCount = 0;
+}
+
+void RenderCommandList::SetFrameBuffer(ID3D11Buffer* frameBuffer)
+{
+    RenderCommand command = {};
+    command.type = RenderCommandType::SetFrameBuffer;
+    command.buffer = frameBuffer;
+    m_commands.push_back(command);
+}
+
+void RenderCommandList::SetMaterial(Material* material)
+{
+    RenderCommand command = {};
+    command.type = RenderCommandType::SetMaterial;
+    command.material = material;
+    m_commands.push_back(command);
+}
+
+void RenderCommandList::DrawInstanced(Mesh* mesh, ID3D11Buffer* instanceBuffer, unsigned int instanceStride,
+                                      uint32_t firstInstance, uint32_t instanceCount)
+{
+    RenderCommand command = {};
+    command.type = RenderCommandType::DrawInstanced;
+    command.mesh = mesh;
+    command.buffer = instanceBuffer;
+    command.stride = instanceStride;
+    command.firstInstance = firstInstance;
+    command.instanceCount = instanceCount;
+    m_commands.push_back(command);
+    m_drawCount++;
+}
+
+void RenderCommandList::RecordBatches(const std::vector<DrawBatch>& batches, size_t firstBatch, size_t endBatch,
+                                      ID3D11Buffer* instanceBuffer, unsigned int instanceStride, ID3D11Buffer* frameBuffer)
+{
+    Reset();
+    SetFrameBuffer(frameBuffer);
+
+    Material* currentMaterial = nullptr;
+    for (size_t i = firstBatch; i < endBatch; ++i)
+    {
+        const DrawBatch& batch = batches[i];
+        if (batch.material && batch.material != currentMaterial)
+        {
+            SetMaterial(batch.material);
+            currentMaterial = batch.material;
+        }
+
+        DrawInstanced(batch.mesh, instanceBuffer, instanceStride, batch.firstInstance, batch.instanceCount);
+    }
+}
@@ -0,0 +1,68 @@
+#pragma once
+
+#include <vector>
+#include <cstddef>
+#include <cstdint>
+#include "D3D11Forward.h"
+
+// Forward declarations
+class Mesh;
+class Material;
+struct DrawBatch;
+
+// Commands understood by the CPU recording backend
+enum class RenderCommandType
+{
+    SetFrameBuffer,
+    SetMaterial,
+    DrawInstanced
+};
+
+// A single recorded command. Only the fields used by its type are meaningful.
+struct RenderCommand
+{
+    RenderCommandType type;
+    Mesh* mesh;
+    Material* material;
+    ID3D11Buffer* buffer;
+    unsigned int stride;
+    uint32_t firstInstance;
+    uint32_t instanceCount;
+};
+
+// CPU-side command list. Worker threads record into their own list without
+// touching any D3D11 context; the main thread replays the lists in order on
+// the immediate context. Used where deferred contexts are unavailable and as
+// a device-free backend for measuring recording cost.
+class RenderCommandList
+{
+public:
+    RenderCommandList();
+    ~RenderCommandList();
+
+    // Recording
+    void Reset();
+    void SetFrameBuffer(ID3D11Buffer* frameBuffer);
+    void SetMaterial(Material* material);
+    void DrawInstanced(Mesh* mesh, ID3D11Buffer* instanceBuffer, unsigned int instanceStride,
+                       uint32_t firstInstance, uint32_t instanceCount);
+
+    // Resets the list and records batches [firstBatch, endBatch) of a sorted
+    // batch list, binding each material once per run of batches using it.
+    // The CommandLists mode of ParallelCommandRecorder records its slices here.
+    void RecordBatches(const std::vector<DrawBatch>& batches, size_t firstBatch, size_t endBatch,
+                       ID3D11Buffer* instanceBuffer, unsigned int instanceStride, ID3D11Buffer* frameBuffer);
+
+    // Playback (main thread); defined with the Direct3D frontend in
+    // RenderCommandListExecute.cpp, recording builds without it
+    void Execute(ID3D11DeviceContext* context) const;
+
+    // Data access
+    const std::vector<RenderCommand>& GetCommands() const { return m_commands; }
+    int GetCommandCount() const { return static_cast<int>(m_commands.size()); }
+    int GetDrawCount() const { return m_drawCount; }
+
+private:
+    std::vector<RenderCommand> m_commands;
+    int m_drawCount;
+};
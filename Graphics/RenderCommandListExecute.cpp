@@ -0,0 +1,35 @@
+#include "RenderCommandList.h"
+#include <d3d11.h>
+#include "../Resources/Mesh.h"
+#include "../Resources/Material.h"
+
+void RenderCommandList::Execute(ID3D11DeviceContext* context) const
+{
+    if (!context)
+    {
+        return;
+    }
+
+    for (const RenderCommand& command : m_commands)
+    {
+        switch (command.type)
+        {
+        case RenderCommandType::SetFrameBuffer:
+            context->VSSetConstantBuffers(0, 1, &command.buffer);
+            break;
+
+        case RenderCommandType::SetMaterial:
+            if (command.material)
+            {
+                command.material->Bind(context);
+            }
+            break;
+
+        case RenderCommandType::DrawInstanced:
+            command.mesh->RenderInstanced(context, command.buffer, command.stride,
+                                          static_cast<int>(command.instanceCount),
+                                          static_cast<int>(command.firstInstance));
+            break;
+        }
+    }
+}
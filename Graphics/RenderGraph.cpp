@@ -0,0 +1,487 @@
+#include "RenderGraph.h"
+#include "../Engine/Profiler.h"
+#include <algorithm>
+#include <iostream>
+
+uint64_t RenderGraphTextureDesc::GetBytes() const
+{
+    return static_cast<uint64_t>(width) * static_cast<uint64_t>(height) *
+           static_cast<uint64_t>(RenderGraphUtils::GetBitsPerPixel(format)) / 8;
+}
+
+RenderGraph::RenderGraph()
+    : m_compiled(false)
+    , m_declarationError(false)
+{
+}
+
+RenderGraphResource RenderGraph::ImportTexture(const std::string& name, const RenderGraphTextureDesc& desc)
+{
+    RenderGraphResource resource = CreateTexture(name, desc);
+    m_resources[resource].imported = true;
+    return resource;
+}
+
+RenderGraphResource RenderGraph::CreateTexture(const std::string& name, const RenderGraphTextureDesc& desc)
+{
+    ResourceNode node;
+    node.name = name;
+    node.desc = desc;
+    node.imported = false;
+    node.output = false;
+    node.writer = INVALID_RENDER_GRAPH_HANDLE;
+    node.firstUse = -1;
+    node.lastUse = -1;
+    node.physicalIndex = -1;
+
+    m_resources.push_back(node);
+    m_compiled = false;
+    return static_cast<RenderGraphResource>(m_resources.size() - 1);
+}
+
+RenderGraphPass RenderGraph::AddPass(const std::string& name, ExecuteFunction execute)
+{
+    PassNode node;
+    node.name = name;
+    node.execute = std::move(execute);
+    node.culled = false;
+
+    m_passes.push_back(std::move(node));
+    m_compiled = false;
+    return static_cast<RenderGraphPass>(m_passes.size() - 1);
+}
+
+void RenderGraph::SetPassFunction(RenderGraphPass pass, ExecuteFunction execute)
+{
+    if (pass < m_passes.size())
+    {
+        m_passes[pass].execute = std::move(execute);
+    }
+}
+
+void RenderGraph::Read(RenderGraphPass pass, RenderGraphResource resource)
+{
+    if (pass >= m_passes.size() || resource >= m_resources.size())
+    {
+        std::cerr << "RenderGraph: Invalid read declaration" << std::endl;
+        m_declarationError = true;
+        return;
+    }
+
+    PassNode& node = m_passes[pass];
+    if (std::find(node.writes.begin(), node.writes.end(), resource) != node.writes.end())
+    {
+        std::cerr << "RenderGraph: Pass " << node.name << " reads and writes " << m_resources[resource].name << std::endl;
+        m_declarationError = true;
+        return;
+    }
+
+    if (std::find(node.reads.begin(), node.reads.end(), resource) == node.reads.end())
+    {
+        node.reads.push_back(resource);
+    }
+    m_compiled = false;
+}
+
+void RenderGraph::Write(RenderGraphPass pass, RenderGraphResource resource)
+{
+    if (pass >= m_passes.size() || resource >= m_resources.size())
+    {
+        std::cerr << "RenderGraph: Invalid write declaration" << std::endl;
+        m_declarationError = true;
+        return;
+    }
+
+    ResourceNode& target = m_resources[resource];
+    PassNode& node = m_passes[pass];
+    if (target.writer != INVALID_RENDER_GRAPH_HANDLE && target.writer != pass)
+    {
+        std::cerr << "RenderGraph: " << target.name << " written by both " << m_passes[target.writer].name
+                  << " and " << node.name << std::endl;
+        m_declarationError = true;
+        return;
+    }
+
+    if (std::find(node.reads.begin(), node.reads.end(), resource) != node.reads.end())
+    {
+        std::cerr << "RenderGraph: Pass " << node.name << " reads and writes " << target.name << std::endl;
+        m_declarationError = true;
+        return;
+    }
+
+    if (target.writer == INVALID_RENDER_GRAPH_HANDLE)
+    {
+        target.writer = pass;
+        node.writes.push_back(resource);
+    }
+    m_compiled = false;
+}
+
+void RenderGraph::MarkOutput(RenderGraphResource resource)
+{
+    if (resource < m_resources.size())
+    {
+        m_resources[resource].output = true;
+        m_compiled = false;
+    }
+}
+
+bool RenderGraph::Compile()
+{
+    PROFILE_FUNCTION();
+
+    m_compiled = false;
+    m_schedule.clear();
+    m_physicalTextures.clear();
+    m_stats = RenderGraphStats();
+
+    if (!Validate())
+    {
+        return false;
+    }
+
+    CullPasses();
+    if (!Schedule())
+    {
+        return false;
+    }
+
+    ComputeLifetimes();
+    AssignPhysicalTextures();
+
+    m_compiled = true;
+    return true;
+}
+
+void RenderGraph::Execute() const
+{
+    PROFILE_FUNCTION();
+
+    if (!m_compiled)
+    {
+        std::cerr << "RenderGraph: Execute called before Compile" << std::endl;
+        return;
+    }
+
+    for (RenderGraphPass pass : m_schedule)
+    {
+        if (m_passes[pass].execute)
+        {
+            m_passes[pass].execute();
+        }
+    }
+}
+
+void RenderGraph::Clear()
+{
+    m_resources.clear();
+    m_passes.clear();
+    m_schedule.clear();
+    m_physicalTextures.clear();
+    m_stats = RenderGraphStats();
+    m_compiled = false;
+    m_declarationError = false;
+}
+
+bool RenderGraph::IsPassCulled(RenderGraphPass pass) const
+{
+    return pass < m_passes.size() && m_passes[pass].culled;
+}
+
+int RenderGraph::GetPhysicalIndex(RenderGraphResource resource) const
+{
+    return resource < m_resources.size() ? m_resources[resource].physicalIndex : -1;
+}
+
+bool RenderGraph::Validate() const
+{
+    if (m_declarationError)
+    {
+        return false;
+    }
+
+    for (const auto& pass : m_passes)
+    {
+        for (RenderGraphResource resource : pass.reads)
+        {
+            const ResourceNode& node = m_resources[resource];
+            if (!node.imported && node.writer == INVALID_RENDER_GRAPH_HANDLE)
+            {
+                std::cerr << "RenderGraph: Pass " << pass.name << " reads " << node.name
+                          << ", which no pass writes" << std::endl;
+                return false;
+            }
+        }
+    }
+
+    return true;
+}
+
+void RenderGraph::CullPasses()
+{
+    // Walk back from the outputs; passes never reached are culled
+    std::vector<RenderGraphPass> pending;
+    for (auto& pass : m_passes)
+    {
+        pass.culled = true;
+    }
+
+    for (const auto& resource : m_resources)
+    {
+        if (resource.output && resource.writer != INVALID_RENDER_GRAPH_HANDLE && m_passes[resource.writer].culled)
+        {
+            m_passes[resource.writer].culled = false;
+            pending.push_back(resource.writer);
+        }
+    }
+
+    while (!pending.empty())
+    {
+        RenderGraphPass pass = pending.back();
+        pending.pop_back();
+
+        for (RenderGraphResource resource : m_passes[pass].reads)
+        {
+            RenderGraphPass writer = m_resources[resource].writer;
+            if (writer != INVALID_RENDER_GRAPH_HANDLE && m_passes[writer].culled)
+            {
+                m_passes[writer].culled = false;
+                pending.push_back(writer);
+            }
+        }
+    }
+
+    m_stats.passCount = static_cast<int>(m_passes.size());
+    for (const auto& pass : m_passes)
+    {
+        if (pass.culled)
+        {
+            m_stats.culledPassCount++;
+        }
+    }
+}
+
+bool RenderGraph::Schedule()
+{
+    // Kahn's algorithm, always taking the earliest declared ready pass so
+    // independent passes keep the order they were added in
+    std::vector<int> pendingInputs(m_passes.size(), 0);
+    std::vector<std::vector<RenderGraphPass>> dependents(m_passes.size());
+    size_t keptCount = 0;
+
+    for (RenderGraphPass pass = 0; pass < m_passes.size(); ++pass)
+    {
+        if (m_passes[pass].culled)
+        {
+            continue;
+        }
+
+        keptCount++;
+        for (RenderGraphResource resource : m_passes[pass].reads)
+        {
+            RenderGraphPass writer = m_resources[resource].writer;
+            if (writer != INVALID_RENDER_GRAPH_HANDLE)
+            {
+                pendingInputs[pass]++;
+                dependents[writer].push_back(pass);
+            }
+        }
+    }
+
+    std::vector<bool> scheduled(m_passes.size(), false);
+    m_schedule.reserve(keptCount);
+    while (m_schedule.size() < keptCount)
+    {
+        RenderGraphPass next = INVALID_RENDER_GRAPH_HANDLE;
+        for (RenderGraphPass pass = 0; pass < m_passes.size(); ++pass)
+        {
+            if (!m_passes[pass].culled && !scheduled[pass] && pendingInputs[pass] == 0)
+            {
+                next = pass;
+                break;
+            }
+        }
+
+        if (next == INVALID_RENDER_GRAPH_HANDLE)
+        {
+            std::cerr << "RenderGraph: Dependency cycle between passes" << std::endl;
+            m_schedule.clear();
+            return false;
+        }
+
+        scheduled[next] = true;
+        m_schedule.push_back(next);
+        for (RenderGraphPass dependent : dependents[next])
+        {
+            pendingInputs[dependent]--;
+        }
+    }
+
+    return true;
+}
+
+void RenderGraph::ComputeLifetimes()
+{
+    for (auto& resource : m_resources)
+    {
+        resource.firstUse = -1;
+        resource.lastUse = -1;
+        resource.physicalIndex = -1;
+    }
+
+    for (int position = 0; position < static_cast<int>(m_schedule.size()); ++position)
+    {
+        const PassNode& pass = m_passes[m_schedule[position]];
+        auto touch = [this, position](RenderGraphResource resource)
+        {
+            ResourceNode& node = m_resources[resource];
+            if (node.firstUse < 0)
+            {
+                node.firstUse = position;
+            }
+            node.lastUse = position;
+        };
+
+        for (RenderGraphResource resource : pass.reads)
+        {
+            touch(resource);
+        }
+        for (RenderGraphResource resource : pass.writes)
+        {
+            touch(resource);
+        }
+    }
+
+    // Outputs are read after the graph runs, so a transient output stays
+    // live to the end and no later transient can alias it
+    int lastPosition = static_cast<int>(m_schedule.size()) - 1;
+    for (auto& resource : m_resources)
+    {
+        if (resource.output && resource.firstUse >= 0)
+        {
+            resource.lastUse = lastPosition;
+        }
+    }
+}
+
+void RenderGraph::AssignPhysicalTextures()
+{
+    // Transients in order of first use; each takes a free physical texture of
+    // the same description or adds one
+    std::vector<RenderGraphResource> transients;
+    for (RenderGraphResource resource = 0; resource < m_resources.size(); ++resource)
+    {
+        if (!m_resources[resource].imported && m_resources[resource].firstUse >= 0)
+        {
+            transients.push_back(resource);
+        }
+    }
+
+    std::stable_sort(transients.begin(), transients.end(), [this](RenderGraphResource a, RenderGraphResource b)
+    {
+        return m_resources[a].firstUse < m_resources[b].firstUse;
+    });
+
+    std::vector<int> physicalLastUse;
+    for (RenderGraphResource resource : transients)
+    {
+        ResourceNode& node = m_resources[resource];
+
+        int chosen = -1;
+        for (size_t physical = 0; physical < m_physicalTextures.size(); ++physical)
+        {
+            if (physicalLastUse[physical] < node.firstUse && m_physicalTextures[physical] == node.desc)
+            {
+                chosen = static_cast<int>(physical);
+                break;
+            }
+        }
+
+        if (chosen < 0)
+        {
+            chosen = static_cast<int>(m_physicalTextures.size());
+            m_physicalTextures.push_back(node.desc);
+            physicalLastUse.push_back(-1);
+        }
+
+        node.physicalIndex = chosen;
+        physicalLastUse[chosen] = node.lastUse;
+
+        m_stats.transientCount++;
+        m_stats.transientBytes += node.desc.GetBytes();
+    }
+
+    m_stats.physicalCount = static_cast<int>(m_physicalTextures.size());
+    for (const auto& desc : m_physicalTextures)
+    {
+        m_stats.peakTransientBytes += desc.GetBytes();
+    }
+
+    for (int position = 0; position < static_cast<int>(m_schedule.size()); ++position)
+    {
+        uint64_t liveBytes = 0;
+        for (RenderGraphResource resource : transients)
+        {
+            const ResourceNode& node = m_resources[resource];
+            if (node.firstUse <= position && position <= node.lastUse)
+            {
+                liveBytes += node.desc.GetBytes();
+            }
+        }
+        m_stats.peakLiveBytes = std::max(m_stats.peakLiveBytes, liveBytes);
+    }
+}
+
+void RenderGraph::PrintSummary() const
+{
+    std::cout << "RenderGraph: " << m_schedule.size() << " passes scheduled, " << m_stats.culledPassCount
+              << " culled; " << m_stats.transientCount << " transient textures in " << m_stats.physicalCount
+              << " physical, " << m_stats.peakTransientBytes / 1024 << " KB ("
+              << m_stats.transientBytes / 1024 << " KB without aliasing)" << std::endl;
+
+    for (RenderGraphPass pass : m_schedule)
+    {
+        const PassNode& node = m_passes[pass];
+        std::cout << "  " << node.name << ":";
+        for (RenderGraphResource resource : node.reads)
+        {
+            std::cout << " <" << m_resources[resource].name;
+        }
+        for (RenderGraphResource resource : node.writes)
+        {
+            const ResourceNode& target = m_resources[resource];
+            std::cout << " >" << target.name;
+            if (target.physicalIndex >= 0)
+            {
+                std::cout << "#" << target.physicalIndex;
+            }
+        }
+        std::cout << std::endl;
+    }
+}
+
+namespace RenderGraphUtils
+{
+    const char* GetFormatName(RenderGraphFormat format)
+    {
+        switch (format)
+        {
+            case RenderGraphFormat::RGBA8:      return "RGBA8";
+            case RenderGraphFormat::RGBA16F:    return "RGBA16F";
+            case RenderGraphFormat::R11G11B10F: return "R11G11B10F";
+            case RenderGraphFormat::R16F:       return "R16F";
+            case RenderGraphFormat::R32F:       return "R32F";
+            default:                            return "Unknown";
+        }
+    }
+
+    int GetBitsPerPixel(RenderGraphFormat format)
+    {
+        switch (format)
+        {
+            case RenderGraphFormat::RGBA16F:    return 64;
+            case RenderGraphFormat::R16F:       return 16;
+            default:                            return 32;
+        }
+    }
+}
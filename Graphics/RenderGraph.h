@@ -0,0 +1,182 @@
+#pragma once
+
+#include <cstdint>
+#include <functional>
+#include <string>
+#include <vector>
+
+// Pixel formats of graph textures; only what the size computation and the
+// aliasing compatibility check need to know
+enum class RenderGraphFormat
+{
+    RGBA8 = 0,
+    RGBA16F,
+    R11G11B10F,
+    R16F,
+    R32F,
+    Count
+};
+
+struct RenderGraphTextureDesc
+{
+    int width;
+    int height;
+    RenderGraphFormat format;
+
+    RenderGraphTextureDesc()
+        : width(0)
+        , height(0)
+        , format(RenderGraphFormat::RGBA8)
+    {
+    }
+
+    RenderGraphTextureDesc(int textureWidth, int textureHeight, RenderGraphFormat textureFormat)
+        : width(textureWidth)
+        , height(textureHeight)
+        , format(textureFormat)
+    {
+    }
+
+    bool operator==(const RenderGraphTextureDesc& other) const
+    {
+        return width == other.width && height == other.height && format == other.format;
+    }
+    bool operator!=(const RenderGraphTextureDesc& other) const { return !(*this == other); }
+
+    uint64_t GetBytes() const;
+};
+
+typedef uint32_t RenderGraphResource;
+typedef uint32_t RenderGraphPass;
+const uint32_t INVALID_RENDER_GRAPH_HANDLE = 0xFFFFFFFFu;
+
+struct RenderGraphStats
+{
+    int passCount;              // Declared
+    int culledPassCount;        // Not contributing to any output
+    int transientCount;         // Transient textures used by scheduled passes
+    int physicalCount;          // Textures actually needed after aliasing
+    uint64_t transientBytes;    // Footprint without aliasing
+    uint64_t peakTransientBytes;// Footprint of the physical textures
+    uint64_t peakLiveBytes;     // Largest sum of simultaneously live transients
+
+    RenderGraphStats()
+        : passCount(0)
+        , culledPassCount(0)
+        , transientCount(0)
+        , physicalCount(0)
+        , transientBytes(0)
+        , peakTransientBytes(0)
+        , peakLiveBytes(0)
+    {
+    }
+};
+
+// Frame graph over 2D textures.
+//
+// Passes declare the textures they read and write; Compile orders them by
+// dependency (declaration order among independent passes), drops passes
+// whose results never reach an output, and maps transient textures to
+// physical ones so textures whose lifetimes do not overlap share storage.
+// Textures are reused only between identical descriptions, since Direct3D 11
+// cannot place resources in shared memory.
+//
+// The compiler does not touch any graphics API; passes carry a callback that
+// Execute runs in schedule order, and the owner maps GetPhysicalIndex to its
+// own render targets.
+class RenderGraph
+{
+public:
+    typedef std::function<void()> ExecuteFunction;
+
+    RenderGraph();
+
+    // Textures owned outside the graph (scene color, back buffer). They are
+    // never aliased; marking one as output keeps the passes writing it.
+    RenderGraphResource ImportTexture(const std::string& name, const RenderGraphTextureDesc& desc);
+
+    // Textures that only live inside one execution of the graph
+    RenderGraphResource CreateTexture(const std::string& name, const RenderGraphTextureDesc& desc);
+
+    RenderGraphPass AddPass(const std::string& name, ExecuteFunction execute = ExecuteFunction());
+    void SetPassFunction(RenderGraphPass pass, ExecuteFunction execute);
+
+    // A texture has one writer; a pass may not read what it writes
+    void Read(RenderGraphPass pass, RenderGraphResource resource);
+    void Write(RenderGraphPass pass, RenderGraphResource resource);
+
+    void MarkOutput(RenderGraphResource resource);
+
+    // False on invalid declarations (second writer, read of a transient no
+    // pass writes, cycle); the reason is printed
+    bool Compile();
+    bool IsCompiled() const { return m_compiled; }
+
+    // Runs the scheduled passes; requires Compile
+    void Execute() const;
+
+    // Forgets every pass and texture
+    void Clear();
+
+    // Compiled results
+    const std::vector<RenderGraphPass>& GetSchedule() const { return m_schedule; }
+    bool IsPassCulled(RenderGraphPass pass) const;
+    int GetPhysicalIndex(RenderGraphResource resource) const;   // -1 for imported or unused
+    const std::vector<RenderGraphTextureDesc>& GetPhysicalTextures() const { return m_physicalTextures; }
+    const RenderGraphStats& GetStats() const { return m_stats; }
+
+    // Declarations
+    size_t GetPassCount() const { return m_passes.size(); }
+    size_t GetResourceCount() const { return m_resources.size(); }
+    const std::string& GetPassName(RenderGraphPass pass) const { return m_passes[pass].name; }
+    const std::string& GetResourceName(RenderGraphResource resource) const { return m_resources[resource].name; }
+    const RenderGraphTextureDesc& GetResourceDesc(RenderGraphResource resource) const { return m_resources[resource].desc; }
+    bool IsImported(RenderGraphResource resource) const { return m_resources[resource].imported; }
+
+    // Schedule, lifetimes and memory to stdout
+    void PrintSummary() const;
+
+private:
+    struct ResourceNode
+    {
+        std::string name;
+        RenderGraphTextureDesc desc;
+        bool imported;
+        bool output;
+        RenderGraphPass writer;
+
+        // Compiled: positions in the schedule
+        int firstUse;
+        int lastUse;
+        int physicalIndex;
+    };
+
+    struct PassNode
+    {
+        std::string name;
+        ExecuteFunction execute;
+        std::vector<RenderGraphResource> reads;
+        std::vector<RenderGraphResource> writes;
+        bool culled;
+    };
+
+    bool Validate() const;
+    bool Schedule();
+    void CullPasses();
+    void ComputeLifetimes();
+    void AssignPhysicalTextures();
+
+    std::vector<ResourceNode> m_resources;
+    std::vector<PassNode> m_passes;
+    std::vector<RenderGraphPass> m_schedule;
+    std::vector<RenderGraphTextureDesc> m_physicalTextures;
+    RenderGraphStats m_stats;
+    bool m_compiled;
+    bool m_declarationError;
+};
+
+namespace RenderGraphUtils
+{
+    const char* GetFormatName(RenderGraphFormat format);
+    int GetBitsPerPixel(RenderGraphFormat format);
+}
@@ -0,0 +1,349 @@
+#include "RenderQueue.h"
+#include "ParallelCommandRecorder.h"
+#include "FrustumCulling.h"
+#include "../Resources/Mesh.h"
+#include "../Resources/Material.h"
+#include "../Resources/Model.h"
+#include "../Engine/Profiler.h"
+#include <iostream>
+#include <algorithm>
+#include <cstring>
+
+// Frame-constant data for the instanced vertex shader (register b0)
+struct FrameConstants
+{
+    XMMATRIX viewProjection;
+};
+
+RenderQueue::RenderQueue()
+    : m_device(nullptr)
+    , m_instanceBuffer(nullptr)
+    , m_frameBuffer(nullptr)
+    , m_instanceCapacity(0)
+    , m_viewProjection(XMMatrixIdentity())
+    , m_frameAllocator(nullptr)
+    , m_batchesDirty(false)
+{
+}
+
+RenderQueue::~RenderQueue()
+{
+    Shutdown();
+}
+
+bool RenderQueue::Initialize(ID3D11Device* device, int initialInstanceCapacity)
+{
+    if (!device)
+    {
+        return false;
+    }
+
+    m_device = device;
+
+    // Create frame constant buffer
+    D3D11_BUFFER_DESC frameBufferDesc = {};
+    frameBufferDesc.Usage = D3D11_USAGE_DYNAMIC;
+    frameBufferDesc.ByteWidth = sizeof(FrameConstants);
+    frameBufferDesc.BindFlags = D3D11_BIND_CONSTANT_BUFFER;
+    frameBufferDesc.CPUAccessFlags = D3D11_CPU_ACCESS_WRITE;
+
+    HRESULT hr = device->CreateBuffer(&frameBufferDesc, nullptr, &m_frameBuffer);
+    if (FAILED(hr))
+    {
+        std::cerr << "RenderQueue: Failed to create frame constant buffer" << std::endl;
+        return false;
+    }
+
+    if (!EnsureInstanceCapacity(static_cast<size_t>(std::max(1, initialInstanceCapacity))))
+    {
+        std::cerr << "RenderQueue: Failed to create instance buffer" << std::endl;
+        return false;
+    }
+
+    m_items.reserve(m_instanceCapacity);
+    m_instanceData.reserve(m_instanceCapacity);
+    m_batcher.Reserve(m_instanceCapacity);
+    return true;
+}
+
+void RenderQueue::Shutdown()
+{
+    if (m_instanceBuffer)
+    {
+        m_instanceBuffer->Release();
+        m_instanceBuffer = nullptr;
+    }
+
+    if (m_frameBuffer)
+    {
+        m_frameBuffer->Release();
+        m_frameBuffer = nullptr;
+    }
+
+    m_instanceCapacity = 0;
+    m_device = nullptr;
+    Clear();
+}
+
+void RenderQueue::Begin(const XMMATRIX& viewMatrix, const XMMATRIX& projectionMatrix)
+{
+    Clear();
+    m_viewProjection = XMMatrixMultiply(viewMatrix, projectionMatrix);
+}
+
+void RenderQueue::Clear()
+{
+    // Keep capacity so steady-state frames do not allocate
+    m_items.clear();
+    m_batches.clear();
+    m_instanceData.clear();
+    m_batcher.Clear();
+    m_batchesDirty = false;
+    m_stats = RenderQueueStats();
+}
+
+void RenderQueue::Submit(Mesh* mesh, Material* material, const XMMATRIX& worldMatrix)
+{
+    if (!mesh)
+    {
+        return;
+    }
+
+    DrawItem item;
+    item.mesh = mesh;
+    item.material = material;
+    XMStoreFloat4x4(&item.world, worldMatrix);
+
+    m_items.push_back(item);
+    m_batchesDirty = true;
+}
+
+void RenderQueue::Submit(Mesh* mesh, const XMMATRIX& worldMatrix)
+{
+    if (!mesh)
+    {
+        return;
+    }
+
+    Submit(mesh, mesh->GetMaterial().get(), worldMatrix);
+}
+
+void RenderQueue::SubmitModel(const Model& model)
+{
+    const XMMATRIX& worldMatrix = model.GetTransform();
+
+    for (const auto& mesh : model.GetMeshes())
+    {
+        if (!mesh)
+            continue;
+
+        // Same material resolution as Model::RenderWithMaterials
+        Material* material = mesh->GetMaterial().get();
+        if (!material)
+        {
+            material = model.GetMaterial(mesh->GetMaterialIndex()).get();
+        }
+
+        Submit(mesh.get(), material, worldMatrix);
+    }
+}
+
+void RenderQueue::SubmitModel(const Model& model, const Frustum& frustum)
+{
+    const XMMATRIX& worldMatrix = model.GetTransform();
+
+    BoundingBox modelBounds = model.GetWorldBoundingBox();
+    if (!frustum.IntersectsBox(modelBounds.center, modelBounds.extents))
+    {
+        m_stats.culledDraws += model.GetMeshCount();
+        return;
+    }
+
+    for (const auto& mesh : model.GetMeshes())
+    {
+        if (!mesh)
+            continue;
+
+        BoundingBox meshBounds = mesh->GetBoundingBox().Transform(worldMatrix);
+        if (!frustum.IntersectsBox(meshBounds.center, meshBounds.extents))
+        {
+            m_stats.culledDraws++;
+            continue;
+        }
+
+        Material* material = mesh->GetMaterial().get();
+        if (!material)
+        {
+            material = model.GetMaterial(mesh->GetMaterialIndex()).get();
+        }
+
+        Submit(mesh.get(), material, worldMatrix);
+    }
+}
+
+void RenderQueue::BuildBatches()
+{
+    PROFILE_FUNCTION();
+
+    if (!m_batchesDirty)
+    {
+        return;
+    }
+
+    m_batcher.Build(m_items, m_batches, m_instanceData, m_frameAllocator);
+
+    m_stats.submittedDraws = static_cast<int>(m_items.size());
+    m_stats.batchCount = static_cast<int>(m_batches.size());
+    m_batchesDirty = false;
+}
+
+void RenderQueue::Flush(ID3D11DeviceContext* context, Shader* shader)
+{
+    PROFILE_FUNCTION();
+
+    if (!context || m_items.empty())
+    {
+        return;
+    }
+
+    BuildBatches();
+
+    if (!UploadFrameData(context))
+    {
+        return;
+    }
+
+    context->VSSetConstantBuffers(0, 1, &m_frameBuffer);
+
+    Material* currentMaterial = nullptr;
+    for (const DrawBatch& batch : m_batches)
+    {
+        if (batch.material && batch.material != currentMaterial && shader)
+        {
+            batch.material->Apply(context, shader);
+            currentMaterial = batch.material;
+            m_stats.materialChanges++;
+        }
+
+        batch.mesh->RenderInstanced(context, m_instanceBuffer, sizeof(InstanceData),
+                                    static_cast<int>(batch.instanceCount),
+                                    static_cast<int>(batch.firstInstance));
+        m_stats.drawCalls++;
+    }
+}
+
+void RenderQueue::FlushParallel(ID3D11DeviceContext* context, ParallelCommandRecorder& recorder)
+{
+    PROFILE_FUNCTION();
+
+    if (!context || m_items.empty())
+    {
+        return;
+    }
+
+    BuildBatches();
+
+    if (!UploadFrameData(context))
+    {
+        return;
+    }
+
+    // Constant buffer updates must happen on the immediate context before
+    // recording; the recording threads only bind
+    Material* currentMaterial = nullptr;
+    for (const DrawBatch& batch : m_batches)
+    {
+        if (batch.material && batch.material != currentMaterial)
+        {
+            batch.material->PrepareForRender(context);
+            currentMaterial = batch.material;
+            m_stats.materialChanges++;
+        }
+    }
+
+    recorder.Record(m_batches, m_instanceBuffer, sizeof(InstanceData), m_frameBuffer);
+    recorder.Submit(context);
+    m_stats.drawCalls += static_cast<int>(m_batches.size());
+}
+
+bool RenderQueue::UploadFrameData(ID3D11DeviceContext* context)
+{
+    PROFILE_FUNCTION();
+
+    if (!EnsureInstanceCapacity(m_instanceData.size()))
+    {
+        std::cerr << "RenderQueue: Failed to grow instance buffer to "
+                  << m_instanceData.size() << " instances" << std::endl;
+        return false;
+    }
+
+    UpdateFrameBuffer(context);
+
+    // Upload all instances for the frame in a single map
+    D3D11_MAPPED_SUBRESOURCE mappedResource;
+    HRESULT hr = context->Map(m_instanceBuffer, 0, D3D11_MAP_WRITE_DISCARD, 0, &mappedResource);
+    if (FAILED(hr))
+    {
+        return false;
+    }
+
+    size_t uploadSize = m_instanceData.size() * sizeof(InstanceData);
+    memcpy(mappedResource.pData, m_instanceData.data(), uploadSize);
+    context->Unmap(m_instanceBuffer, 0);
+    m_stats.instanceBytesUploaded += uploadSize;
+    return true;
+}
+
+bool RenderQueue::EnsureInstanceCapacity(size_t instanceCount)
+{
+    if (m_instanceBuffer && instanceCount <= m_instanceCapacity)
+    {
+        return true;
+    }
+
+    if (!m_device)
+    {
+        return false;
+    }
+
+    // Grow geometrically so capacity settles after a few frames
+    size_t newCapacity = std::max<size_t>(m_instanceCapacity, 1);
+    while (newCapacity < instanceCount)
+    {
+        newCapacity *= 2;
+    }
+
+    D3D11_BUFFER_DESC instanceBufferDesc = {};
+    instanceBufferDesc.Usage = D3D11_USAGE_DYNAMIC;
+    instanceBufferDesc.ByteWidth = static_cast<UINT>(sizeof(InstanceData) * newCapacity);
+    instanceBufferDesc.BindFlags = D3D11_BIND_VERTEX_BUFFER;
+    instanceBufferDesc.CPUAccessFlags = D3D11_CPU_ACCESS_WRITE;
+
+    ID3D11Buffer* newBuffer = nullptr;
+    HRESULT hr = m_device->CreateBuffer(&instanceBufferDesc, nullptr, &newBuffer);
+    if (FAILED(hr))
+    {
+        return false;
+    }
+
+    if (m_instanceBuffer)
+    {
+        m_instanceBuffer->Release();
+    }
+
+    m_instanceBuffer = newBuffer;
+    m_instanceCapacity = newCapacity;
+    return true;
+}
+
+void RenderQueue::UpdateFrameBuffer(ID3D11DeviceContext* context)
+{
+    D3D11_MAPPED_SUBRESOURCE mappedResource;
+    HRESULT hr = context->Map(m_frameBuffer, 0, D3D11_MAP_WRITE_DISCARD, 0, &mappedResource);
+    if (SUCCEEDED(hr))
+    {
+        FrameConstants* dataPtr = (FrameConstants*)mappedResource.pData;
+        dataPtr->viewProjection = XMMatrixTranspose(m_viewProjection);
+        context->Unmap(m_frameBuffer, 0);
+    }
+}
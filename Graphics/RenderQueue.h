@@ -0,0 +1,109 @@
+#pragma once
+
+#include <d3d11.h>
+#include <DirectXMath.h>
+#include <vector>
+#include <cstdint>
+#include "DrawBatching.h"
+
+using namespace DirectX;
+
+// Forward declarations
+class Mesh;
+class Material;
+class Model;
+class Shader;
+class ParallelCommandRecorder;
+class FrameAllocator;
+struct Frustum;
+
+// Per-frame submission statistics
+struct RenderQueueStats
+{
+    int submittedDraws;
+    int culledDraws;
+    int batchCount;
+    int drawCalls;
+    int materialChanges;
+    size_t instanceBytesUploaded;
+
+    RenderQueueStats()
+        : submittedDraws(0)
+        , culledDraws(0)
+        , batchCount(0)
+        , drawCalls(0)
+        , materialChanges(0)
+        , instanceBytesUploaded(0)
+    {
+    }
+};
+
+// Collects draws for a frame, merges those sharing a mesh and material,
+// and issues one instanced draw per batch from a single instance buffer.
+// The caller binds a vertex shader built from ShaderUtils::INSTANCED_VERTEX_SHADER
+// with ShaderUtils::CreateInstancedInputLayout() before calling Flush.
+class RenderQueue
+{
+public:
+    RenderQueue();
+    ~RenderQueue();
+
+    // Initialization
+    bool Initialize(ID3D11Device* device, int initialInstanceCapacity = 1024);
+    void Shutdown();
+
+    // Frame control
+    void Begin(const XMMATRIX& viewMatrix, const XMMATRIX& projectionMatrix);
+    void Clear();
+
+    // Submission
+    void Submit(Mesh* mesh, Material* material, const XMMATRIX& worldMatrix);
+    void Submit(Mesh* mesh, const XMMATRIX& worldMatrix);
+    void SubmitModel(const Model& model);
+    void SubmitModel(const Model& model, const Frustum& frustum);
+
+    // Batching through DrawBatcher (CPU only, called by Flush if needed)
+    void BuildBatches();
+
+    // Optional per-frame scratch for the temporaries of BuildBatches; the
+    // heap is used without one
+    void SetFrameAllocator(FrameAllocator* frameAllocator) { m_frameAllocator = frameAllocator; }
+
+    // Execution
+    void Flush(ID3D11DeviceContext* context, Shader* shader);
+
+    // Multithreaded execution: uploads on the immediate context, records the
+    // sorted batches in slices on the recorder's threads and submits in order
+    void FlushParallel(ID3D11DeviceContext* context, ParallelCommandRecorder& recorder);
+
+    // Data access
+    const std::vector<DrawBatch>& GetBatches() const { return m_batches; }
+    const std::vector<InstanceData>& GetInstanceData() const { return m_instanceData; }
+    const RenderQueueStats& GetStats() const { return m_stats; }
+    int GetSubmittedCount() const { return static_cast<int>(m_items.size()); }
+
+private:
+    bool EnsureInstanceCapacity(size_t instanceCount);
+    void UpdateFrameBuffer(ID3D11DeviceContext* context);
+    bool UploadFrameData(ID3D11DeviceContext* context);
+
+private:
+    ID3D11Device* m_device;
+
+    // GPU resources
+    ID3D11Buffer* m_instanceBuffer;
+    ID3D11Buffer* m_frameBuffer;
+    size_t m_instanceCapacity;
+
+    // Frame data
+    std::vector<DrawItem> m_items;
+    std::vector<DrawBatch> m_batches;
+    std::vector<InstanceData> m_instanceData;
+    DrawBatcher m_batcher;
+    XMMATRIX m_viewProjection;
+
+    // State
+    FrameAllocator* m_frameAllocator;
+    bool m_batchesDirty;
+    RenderQueueStats m_stats;
+};
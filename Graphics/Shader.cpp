@@ -102,6 +102,15 @@ bool Shader::CompileFromString(ID3D11Device* device,
         );
         break;
 
+    case ShaderType::Compute:
+        hr = device->CreateComputeShader(
+            m_shaderBlob->GetBufferPointer(),
+            m_shaderBlob->GetBufferSize(),
+            nullptr,
+            &m_computeShader
+        );
+        break;
+
     // Add other shader types as needed
     default:
         std::cout << "Unsupported shader type" << std::endl;
@@ -161,6 +170,10 @@ void Shader::Bind(ID3D11DeviceContext* context)
         context->PSSetShader(m_pixelShader, nullptr, 0);
         break;
 
+    case ShaderType::Compute:
+        context->CSSetShader(m_computeShader, nullptr, 0);
+        break;
+
     // Add other shader types as needed
     }
 }
@@ -183,6 +196,10 @@ void Shader::Unbind(ID3D11DeviceContext* context)
         context->PSSetShader(nullptr, nullptr, 0);
         break;
 
+    case ShaderType::Compute:
+        context->CSSetShader(nullptr, nullptr, 0);
+        break;
+
     // Add other shader types as needed
     }
 }
@@ -447,6 +464,22 @@ namespace ShaderUtils
         return layout;
     }
 
+    std::vector<InputLayoutElement> CreateInstancedInputLayout()
+    {
+        std::vector<InputLayoutElement> layout = CreateBasicInputLayout();
+
+        // Per-instance world matrix, one row per element
+        for (UINT row = 0; row < 4; ++row)
+        {
+            layout.push_back({
+                "WORLD", row, DXGI_FORMAT_R32G32B32A32_FLOAT, 1, row * 16,
+                D3D11_INPUT_PER_INSTANCE_DATA, 1
+            });
+        }
+
+        return layout;
+    }
+
     std::shared_ptr<Shader> CreateVertexShaderFromString(ID3D11Device* device,
                                                         const std::string& shaderCode,
                                                         const std::vector<InputLayoutElement>& layout)
@@ -470,6 +503,17 @@ namespace ShaderUtils
         return nullptr;
     }
 
+    std::shared_ptr<Shader> CreateComputeShaderFromString(ID3D11Device* device,
+                                                         const std::string& shaderCode)
+    {
+        auto shader = std::make_shared<Shader>();
+        if (shader->CompileFromString(device, shaderCode, "main", ShaderType::Compute))
+        {
+            return shader;
+        }
+        return nullptr;
+    }
+
     // Default shader source code
     const char* DEFAULT_VERTEX_SHADER = R"(
         cbuffer MatrixBuffer : register(b0)
@@ -613,4 +657,49 @@ namespace ShaderUtils
             return finalColor;
         }
     )";
+
+    const char* INSTANCED_VERTEX_SHADER = R"(
+        cbuffer FrameBuffer : register(b0)
+        {
+            matrix viewProjectionMatrix;
+        };
+
+        struct VertexInput
+        {
+            float4 position : POSITION;
+            float3 normal : NORMAL;
+            float2 texCoord : TEXCOORD0;
+            float4 world0 : WORLD0;
+            float4 world1 : WORLD1;
+            float4 world2 : WORLD2;
+            float4 world3 : WORLD3;
+        };
+
+        struct PixelInput
+        {
+            float4 position : SV_POSITION;
+            float3 normal : NORMAL;
+            float2 texCoord : TEXCOORD0;
+            float3 worldPos : TEXCOORD1;
+        };
+
+        PixelInput main(VertexInput input)
+        {
+            PixelInput output;
+
+            // Vertex inputs are not subject to cbuffer packing, so rows arrive as stored
+            float4x4 worldMatrix = float4x4(input.world0, input.world1, input.world2, input.world3);
+
+            input.position.w = 1.0f;
+
+            float4 worldPosition = mul(input.position, worldMatrix);
+            output.worldPos = worldPosition.xyz;
+            output.position = mul(worldPosition, viewProjectionMatrix);
+
+            output.normal = mul(input.normal, (float3x3)worldMatrix);
+            output.texCoord = input.texCoord;
+
+            return output;
+        }
+    )";
 }
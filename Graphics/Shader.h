@@ -65,6 +65,7 @@ public:
     ShaderType GetType() const { return m_type; }
     ID3D11VertexShader* GetVertexShader() const { return m_vertexShader; }
     ID3D11PixelShader* GetPixelShader() const { return m_pixelShader; }
+    ID3D11ComputeShader* GetComputeShader() const { return m_computeShader; }
     ID3D11InputLayout* GetInputLayout() const { return m_inputLayout; }
     ID3DBlob* GetShaderBlob() const { return m_shaderBlob; }
 
@@ -142,6 +143,9 @@ namespace ShaderUtils
     // Create input layout for position + color
     std::vector<InputLayoutElement> CreatePositionColorLayout();
 
+    // Create basic layout plus a per-instance world matrix stream in slot 1
+    std::vector<InputLayoutElement> CreateInstancedInputLayout();
+
     // Load shader from embedded string
     std::shared_ptr<Shader> CreateVertexShaderFromString(ID3D11Device* device,
                                                         const std::string& shaderCode,
@@ -150,9 +154,13 @@ namespace ShaderUtils
     std::shared_ptr<Shader> CreatePixelShaderFromString(ID3D11Device* device,
                                                        const std::string& shaderCode);
 
+    std::shared_ptr<Shader> CreateComputeShaderFromString(ID3D11Device* device,
+                                                         const std::string& shaderCode);
+
     // Default shaders
     extern const char* DEFAULT_VERTEX_SHADER;
     extern const char* DEFAULT_PIXEL_SHADER;
     extern const char* MATERIAL_VERTEX_SHADER;
     extern const char* MATERIAL_PIXEL_SHADER;
+    extern const char* INSTANCED_VERTEX_SHADER;
 }
@@ -0,0 +1,151 @@
+#include "SliceRecorder.h"
+#include "../Engine/Profiler.h"
+#include <algorithm>
+#include <string>
+
+SliceRecorder::SliceRecorder()
+    : m_minBatchesPerSlice(16)
+    , m_recordFunction(nullptr)
+    , m_activeSlices(0)
+    , m_frameIndex(0)
+    , m_pendingSlices(0)
+    , m_shuttingDown(false)
+{
+}
+
+SliceRecorder::~SliceRecorder()
+{
+    Shutdown();
+}
+
+void SliceRecorder::Initialize(int workerCount)
+{
+    Shutdown();
+
+    if (workerCount < 0)
+    {
+        int hardwareThreads = static_cast<int>(std::thread::hardware_concurrency());
+        workerCount = std::max(1, hardwareThreads - 1);
+    }
+
+    m_slices.resize(workerCount + 1);
+
+    m_shuttingDown = false;
+    for (int i = 1; i <= workerCount; ++i)
+    {
+        m_workers.emplace_back(&SliceRecorder::WorkerMain, this, i);
+    }
+}
+
+void SliceRecorder::Shutdown()
+{
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_shuttingDown = true;
+    }
+    m_startCondition.notify_all();
+
+    for (std::thread& worker : m_workers)
+    {
+        if (worker.joinable())
+        {
+            worker.join();
+        }
+    }
+    m_workers.clear();
+    m_slices.clear();
+    m_activeSlices = 0;
+}
+
+int SliceRecorder::Record(size_t batchCount, const RecordFunction& recordFunction)
+{
+    if (m_slices.empty())
+    {
+        return 0;
+    }
+
+    m_recordFunction = &recordFunction;
+
+    // Contiguous slices keep the sorted material order intact across threads
+    size_t maxSlices = (batchCount + m_minBatchesPerSlice - 1) / m_minBatchesPerSlice;
+    m_activeSlices = static_cast<int>(std::max<size_t>(1, std::min(m_slices.size(), maxSlices)));
+
+    size_t batchesPerSlice = batchCount / m_activeSlices;
+    size_t remainder = batchCount % m_activeSlices;
+    size_t firstBatch = 0;
+    for (int i = 0; i < static_cast<int>(m_slices.size()); ++i)
+    {
+        Slice& slice = m_slices[i];
+        slice.firstBatch = firstBatch;
+        slice.batchCount = 0;
+        if (i < m_activeSlices)
+        {
+            slice.batchCount = batchesPerSlice + (static_cast<size_t>(i) < remainder ? 1 : 0);
+        }
+        firstBatch += slice.batchCount;
+    }
+
+    // Wake workers, record slice 0 here, then wait for the rest
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_pendingSlices = m_activeSlices - 1;
+        m_frameIndex++;
+    }
+    if (m_activeSlices > 1)
+    {
+        m_startCondition.notify_all();
+    }
+
+    RecordSlice(0);
+
+    {
+        std::unique_lock<std::mutex> lock(m_mutex);
+        m_doneCondition.wait(lock, [this]() { return m_pendingSlices == 0; });
+    }
+
+    m_recordFunction = nullptr;
+    return m_activeSlices;
+}
+
+void SliceRecorder::WorkerMain(int sliceIndex)
+{
+    PROFILE_THREAD_NAME("Recorder " + std::to_string(sliceIndex));
+    uint64_t lastFrame = 0;
+
+    while (true)
+    {
+        int activeSlices = 0;
+        {
+            std::unique_lock<std::mutex> lock(m_mutex);
+            m_startCondition.wait(lock, [this, lastFrame]() { return m_shuttingDown || m_frameIndex != lastFrame; });
+
+            if (m_shuttingDown)
+            {
+                return;
+            }
+
+            lastFrame = m_frameIndex;
+            activeSlices = m_activeSlices;
+        }
+
+        // Threads beyond the active slice count sit this frame out
+        if (sliceIndex >= activeSlices)
+        {
+            continue;
+        }
+
+        RecordSlice(sliceIndex);
+
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            m_pendingSlices--;
+        }
+        m_doneCondition.notify_one();
+    }
+}
+
+void SliceRecorder::RecordSlice(int sliceIndex)
+{
+    const Slice& slice = m_slices[sliceIndex];
+    (*m_recordFunction)(sliceIndex, slice.firstBatch, slice.batchCount);
+}
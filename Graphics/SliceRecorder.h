@@ -0,0 +1,73 @@
+#pragma once
+
+#include <vector>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <functional>
+#include <cstdint>
+
+// The threading of ParallelCommandRecorder, without a device. Splits a
+// sorted batch list into contiguous slices, one per thread; the calling
+// thread records slice 0 while the workers record the rest, and Record
+// returns once every slice is done. What recording a slice means is up to
+// the caller, so the CPU command list path can be measured headless.
+class SliceRecorder
+{
+public:
+    // Records batches [firstBatch, firstBatch + batchCount) into slice sliceIndex
+    using RecordFunction = std::function<void(int sliceIndex, size_t firstBatch, size_t batchCount)>;
+
+    SliceRecorder();
+    ~SliceRecorder();
+
+    // workerCount < 0 uses hardware_concurrency - 1; 0 records every slice
+    // on the calling thread
+    void Initialize(int workerCount = -1);
+    void Shutdown();
+
+    // Slices smaller than this are not worth a thread hand-off
+    void SetMinBatchesPerSlice(int minBatches) { m_minBatchesPerSlice = minBatches > 0 ? minBatches : 1; }
+
+    // Returns the number of slices recorded this frame
+    int Record(size_t batchCount, const RecordFunction& recordFunction);
+
+    // Information
+    int GetThreadCount() const { return static_cast<int>(m_slices.size()); }
+    int GetActiveSliceCount() const { return m_activeSlices; }
+
+private:
+    struct Slice
+    {
+        size_t firstBatch;
+        size_t batchCount;
+
+        Slice()
+            : firstBatch(0)
+            , batchCount(0)
+        {
+        }
+    };
+
+    void WorkerMain(int sliceIndex);
+    void RecordSlice(int sliceIndex);
+
+private:
+    int m_minBatchesPerSlice;
+
+    // One slice per thread; slice 0 belongs to the calling thread
+    std::vector<Slice> m_slices;
+    std::vector<std::thread> m_workers;
+
+    // Frame inputs shared with the workers
+    const RecordFunction* m_recordFunction;
+    int m_activeSlices;
+
+    // Worker synchronization
+    std::mutex m_mutex;
+    std::condition_variable m_startCondition;
+    std::condition_variable m_doneCondition;
+    uint64_t m_frameIndex;
+    int m_pendingSlices;
+    bool m_shuttingDown;
+};
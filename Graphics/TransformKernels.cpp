@@ -0,0 +1,26 @@
+#include "TransformKernels.h"
+#include "../Engine/Profiler.h"
+
+namespace TransformKernels
+{
+    void ComputeWorldViewProjection(const XMFLOAT4X4* worldMatrices, size_t count,
+                                    const XMMATRIX& viewProjection, XMFLOAT4X4* output)
+    {
+        PROFILE_FUNCTION();
+
+        // Two objects per iteration give the CPU independent multiply chains to overlap
+        size_t i = 0;
+        for (; i + 1 < count; i += 2)
+        {
+            XMMATRIX wvp0 = XMMatrixMultiplyTranspose(XMLoadFloat4x4(&worldMatrices[i]), viewProjection);
+            XMMATRIX wvp1 = XMMatrixMultiplyTranspose(XMLoadFloat4x4(&worldMatrices[i + 1]), viewProjection);
+            XMStoreFloat4x4(&output[i], wvp0);
+            XMStoreFloat4x4(&output[i + 1], wvp1);
+        }
+
+        for (; i < count; ++i)
+        {
+            XMStoreFloat4x4(&output[i], XMMatrixMultiplyTranspose(XMLoadFloat4x4(&worldMatrices[i]), viewProjection));
+        }
+    }
+}
@@ -0,0 +1,17 @@
+#pragma once
+
+#include <DirectXMath.h>
+#include <cstddef>
+
+using namespace DirectX;
+
+// Batched matrix kernels. View * projection is passed in once per frame and
+// results are written sequentially, so the output may be a mapped
+// WRITE_DISCARD upload area.
+namespace TransformKernels
+{
+    // Transposed world * viewProjection for count objects, the per-object
+    // vertex shader constants of the renderer
+    void ComputeWorldViewProjection(const XMFLOAT4X4* worldMatrices, size_t count,
+                                    const XMMATRIX& viewProjection, XMFLOAT4X4* output);
+}
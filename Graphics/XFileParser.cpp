@@ -0,0 +1,921 @@
+#include "XFileParser.h"
+#include "../Engine/Profiler.h"
+#include <iostream>
+#include <algorithm>
+#include <stdexcept>
+#include <cctype>
+#include <cstring>
+#include <cstdlib>
+
+void XFileScene::Clear()
+{
+    meshes.clear();
+    materials.clear();
+    animationSets.clear();
+}
+
+XFileParser::XFileParser()
+    : m_scaleFactor(1.0f)
+    , m_flipWindingOrder(false)
+    , m_loadAnimations(false)
+{
+}
+
+bool XFileParser::Parse(const std::string& content, XFileScene& scene)
+{
+    XFileContext context;
+    context.content = content;
+    return Parse(context, scene);
+}
+
+bool XFileParser::Parse(XFileContext& context, XFileScene& scene)
+{
+    PROFILE_FUNCTION();
+
+    scene.Clear();
+
+    // Parse header
+    if (!ParseHeader(context))
+    {
+        return false;
+    }
+
+    // Skip templates section (we use hardcoded knowledge of templates)
+    SkipTemplates(context);
+
+    // Parse main data
+    while (context.position < context.content.length())
+    {
+        SkipWhitespace(context);
+        if (context.position >= context.content.length())
+            break;
+
+        std::string_view token = ReadKeyword(context);
+        if (token.empty())
+            break;
+
+        if (token == "Mesh")
+        {
+            XMeshData mesh;
+            if (ParseMesh(context, mesh))
+            {
+                scene.meshes.push_back(std::move(mesh));
+            }
+        }
+        else if (token == "Frame")
+        {
+            ParseFrame(context, scene);
+        }
+        else if (token == "Material")
+        {
+            XMaterialData material;
+            ParseMaterial(context, material);
+            scene.materials.push_back(std::move(material));
+        }
+        else if (token == "AnimationSet" && m_loadAnimations)
+        {
+            ParseAnimationSet(context, scene);
+        }
+        else
+        {
+            // Skip unknown objects
+            SkipObject(context);
+        }
+    }
+
+    return true;
+}
+
+bool XFileParser::ParseHeader(XFileContext& context)
+{
+    if (context.content.length() < 16)
+        return false;
+
+    // Check magic number
+    if (context.content.compare(0, 4, "xof ") != 0)
+        return false;
+
+    // Parse format
+    std::string format = context.content.substr(8, 4);
+    context.isBinary = (format == "bin " || format == "bzip");
+    context.isCompressed = (format == "tzip" || format == "bzip");
+
+    if (context.isCompressed)
+    {
+        std::cerr << "XFileParser: Compressed .X files not supported yet" << std::endl;
+        return false;
+    }
+
+    context.position = 16;
+    return true;
+}
+
+void XFileParser::SkipTemplates(XFileContext& context)
+{
+    // Templates are usually at the beginning, skip them
+    // This is a simplified approach - in a full implementation,
+    // you would parse templates to understand the data structure
+
+    while (context.position < context.content.length())
+    {
+        SkipWhitespace(context);
+        std::string_view token = ReadKeyword(context);
+
+        if (token == "template")
+        {
+            SkipObject(context);
+        }
+        else
+        {
+            // Put the token back by moving position back
+            context.position -= token.length();
+            break;
+        }
+    }
+}
+
+bool XFileParser::ParseMesh(XFileContext& context, XMeshData& mesh)
+{
+    PROFILE_FUNCTION();
+
+    if (context.isBinary)
+    {
+        mesh.name = ReadStringBinary(context);
+        // Binary format doesn't use braces, data follows directly
+    }
+    else
+    {
+        // Expect: Mesh meshName {
+        mesh.name = ReadToken(context);
+        SkipWhitespace(context);
+
+        if (ReadChar(context) != '{')
+        {
+            std::cerr << "XFileParser: Expected '{' after Mesh name" << std::endl;
+            return false;
+        }
+    }
+
+    // Parse vertex count
+    int vertexCount;
+    if (context.isBinary)
+    {
+        vertexCount = static_cast<int>(ReadUInt32Binary(context));
+    }
+    else
+    {
+        SkipWhitespace(context);
+        vertexCount = ReadInt(context);
+    }
+
+    if (vertexCount <= 0)
+    {
+        std::cerr << "XFileParser: Invalid vertex count: " << vertexCount << std::endl;
+        return false;
+    }
+
+    // Parse vertices; normals, texture coordinates and tangent frame keep
+    // their defaults until the optional sections below override them
+    mesh.vertices.resize(vertexCount);
+
+    for (int i = 0; i < vertexCount; ++i)
+    {
+        float x, y, z;
+
+        if (context.isBinary)
+        {
+            x = ReadFloatBinary(context) * m_scaleFactor;
+            y = ReadFloatBinary(context) * m_scaleFactor;
+            z = ReadFloatBinary(context) * m_scaleFactor;
+        }
+        else
+        {
+            SkipWhitespace(context);
+            x = ReadFloat(context) * m_scaleFactor;
+            SkipChar(context, ';');
+            y = ReadFloat(context) * m_scaleFactor;
+            SkipChar(context, ';');
+            z = ReadFloat(context) * m_scaleFactor;
+
+            if (i < vertexCount - 1)
+            {
+                SkipChar(context, ',');
+            }
+            SkipChar(context, ';');
+        }
+
+        mesh.vertices[i].position = XMFLOAT3(x, y, z);
+    }
+
+    // Parse face count
+    int faceCount;
+    if (context.isBinary)
+    {
+        faceCount = static_cast<int>(ReadUInt32Binary(context));
+    }
+    else
+    {
+        SkipWhitespace(context);
+        faceCount = ReadInt(context);
+    }
+
+    // Parse faces (indices)
+    mesh.indices.reserve(static_cast<size_t>(std::max(faceCount, 0)) * 3);
+
+    std::vector<uint32_t> face;
+    for (int i = 0; i < faceCount; ++i)
+    {
+        int verticesPerFace = ReadInt(context);
+
+        face.clear();
+        for (int j = 0; j < verticesPerFace; ++j)
+        {
+            face.push_back(static_cast<uint32_t>(ReadInt(context)));
+        }
+
+        // Triangles and quads are the common case; larger polygons are
+        // split as a fan like quads are
+        for (int j = 2; j < verticesPerFace; ++j)
+        {
+            mesh.indices.push_back(face[0]);
+            mesh.indices.push_back(face[j - 1]);
+            mesh.indices.push_back(face[j]);
+        }
+    }
+
+    // Apply winding order flip if requested
+    if (m_flipWindingOrder)
+    {
+        for (size_t i = 0; i + 2 < mesh.indices.size(); i += 3)
+        {
+            std::swap(mesh.indices[i + 1], mesh.indices[i + 2]);
+        }
+    }
+
+    // Parse optional data (normals, texture coordinates, materials)
+    while (context.position < context.content.length())
+    {
+        SkipWhitespace(context);
+        if (context.position >= context.content.length())
+            break;
+
+        char nextChar = PeekChar(context);
+        if (nextChar == '}')
+        {
+            ReadChar(context); // consume '}'
+            break;
+        }
+
+        std::string_view token = ReadKeyword(context);
+        if (token == "MeshNormals")
+        {
+            ParseMeshNormals(context, mesh);
+        }
+        else if (token == "MeshTextureCoords")
+        {
+            ParseMeshTextureCoords(context, mesh);
+        }
+        else if (token == "MeshMaterialList")
+        {
+            ParseMeshMaterialList(context, mesh);
+        }
+        else
+        {
+            SkipObject(context);
+        }
+    }
+
+    return true;
+}
+
+void XFileParser::ParseMeshNormals(XFileContext& context, XMeshData& mesh)
+{
+    SkipWhitespace(context);
+    SkipChar(context, '{');
+
+    // Read normal count
+    int normalCount = ReadInt(context);
+
+    // Normals are only used when there is one per vertex; they are written
+    // straight into the vertices instead of going through a temporary array
+    bool applyNormals = static_cast<size_t>(std::max(normalCount, 0)) == mesh.vertices.size();
+
+    // Read normals
+    for (int i = 0; i < normalCount; ++i)
+    {
+        SkipWhitespace(context);
+        float x = ReadFloat(context);
+        SkipChar(context, ';');
+        float y = ReadFloat(context);
+        SkipChar(context, ';');
+        float z = ReadFloat(context);
+
+        if (applyNormals)
+        {
+            mesh.vertices[i].normal = XMFLOAT3(x, y, z);
+        }
+
+        if (i < normalCount - 1)
+            SkipChar(context, ',');
+        SkipChar(context, ';');
+    }
+
+    // Read face normal indices (usually we just use per-vertex normals)
+    int faceCount = ReadInt(context);
+    for (int i = 0; i < faceCount; ++i)
+    {
+        SkipWhitespace(context);
+        int verticesPerFace = ReadInt(context);
+        SkipChar(context, ';');
+
+        for (int j = 0; j < verticesPerFace; ++j)
+        {
+            ReadInt(context); // Skip face normal indices
+            if (j < verticesPerFace - 1)
+                SkipChar(context, ',');
+        }
+
+        if (i < faceCount - 1)
+            SkipChar(context, ',');
+        SkipChar(context, ';');
+    }
+
+    SkipChar(context, '}');
+}
+
+void XFileParser::ParseMeshTextureCoords(XFileContext& context, XMeshData& mesh)
+{
+    SkipWhitespace(context);
+    SkipChar(context, '{');
+
+    // Read texture coordinate count
+    int texCoordCount = ReadInt(context);
+
+    // Read texture coordinates; like normals, only applied with one per vertex
+    bool applyTexCoords = static_cast<size_t>(std::max(texCoordCount, 0)) == mesh.vertices.size();
+
+    for (int i = 0; i < texCoordCount; ++i)
+    {
+        SkipWhitespace(context);
+        float u = ReadFloat(context);
+        SkipChar(context, ';');
+        float v = ReadFloat(context);
+
+        if (applyTexCoords)
+        {
+            mesh.vertices[i].texCoord = XMFLOAT2(u, v);
+        }
+
+        if (i < texCoordCount - 1)
+            SkipChar(context, ',');
+        SkipChar(context, ';');
+    }
+
+    SkipChar(context, '}');
+}
+
+void XFileParser::ParseMeshMaterialList(XFileContext& context, XMeshData& mesh)
+{
+    SkipWhitespace(context);
+    SkipChar(context, '{');
+
+    // Read material count
+    int materialCount = ReadInt(context);
+
+    // Read face count
+    int faceCount = ReadInt(context);
+
+    // Per-face material indices are read but not used yet (one material per mesh)
+    for (int i = 0; i < faceCount; ++i)
+    {
+        SkipWhitespace(context);
+        ReadInt(context);
+
+        if (i < faceCount - 1)
+            SkipChar(context, ',');
+        SkipChar(context, ';');
+    }
+
+    // Parse material definitions or references
+    for (int i = 0; i < materialCount; ++i)
+    {
+        SkipWhitespace(context);
+        std::string_view token = ReadKeyword(context);
+
+        if (token == "Material")
+        {
+            XMaterialData material;
+            ParseMaterial(context, material);
+            mesh.materials.push_back(std::move(material));
+        }
+        else if (token.empty() && PeekChar(context) == '{')
+        {
+            // Reference to existing material by name; would need a material database lookup
+            ReadChar(context);
+            ReadToken(context);
+            SkipChar(context, '}');
+        }
+        else
+        {
+            SkipObject(context);
+        }
+    }
+
+    SkipChar(context, '}');
+}
+
+void XFileParser::ParseMaterial(XFileContext& context, XMaterialData& material)
+{
+    PROFILE_FUNCTION();
+
+    material.name = ReadToken(context);
+    SkipWhitespace(context);
+    SkipChar(context, '{');
+
+    // Parse material properties
+    while (context.position < context.content.length())
+    {
+        SkipWhitespace(context);
+        if (PeekChar(context) == '}')
+        {
+            ReadChar(context); // consume '}'
+            break;
+        }
+
+        // Read diffuse color (first 4 floats)
+        material.diffuseColor.x = ReadFloat(context); SkipChar(context, ';');
+        material.diffuseColor.y = ReadFloat(context); SkipChar(context, ';');
+        material.diffuseColor.z = ReadFloat(context); SkipChar(context, ';');
+        material.diffuseColor.w = ReadFloat(context); SkipChar(context, ';');
+
+        // Read power (shininess)
+        material.shininess = ReadFloat(context); SkipChar(context, ';');
+
+        // Read specular color
+        material.specularColor.x = ReadFloat(context); SkipChar(context, ';');
+        material.specularColor.y = ReadFloat(context); SkipChar(context, ';');
+        material.specularColor.z = ReadFloat(context); SkipChar(context, ';');
+
+        // Read emissive color
+        material.emissiveColor.x = ReadFloat(context); SkipChar(context, ';');
+        material.emissiveColor.y = ReadFloat(context); SkipChar(context, ';');
+        material.emissiveColor.z = ReadFloat(context); SkipChar(context, ';');
+
+        // Skip any additional data or TextureFilename objects
+        while (context.position < context.content.length())
+        {
+            SkipWhitespace(context);
+            char nextChar = PeekChar(context);
+            if (nextChar == '}')
+                break;
+
+            std::string_view token = ReadKeyword(context);
+            if (token == "TextureFilename")
+            {
+                // Parse texture filename
+                SkipWhitespace(context);
+                SkipChar(context, '{');
+
+                // Read string (texture path)
+                SkipWhitespace(context);
+                if (PeekChar(context) == '"')
+                {
+                    ReadChar(context); // skip opening quote
+                    while (context.position < context.content.length() &&
+                           context.content[context.position] != '"')
+                    {
+                        material.textureFilename += context.content[context.position++];
+                    }
+                    ReadChar(context); // skip closing quote
+                }
+
+                SkipChar(context, ';');
+                SkipChar(context, '}');
+            }
+            else
+            {
+                SkipObject(context);
+            }
+        }
+    }
+}
+
+void XFileParser::ParseFrame(XFileContext& context, XFileScene& scene)
+{
+    PROFILE_FUNCTION();
+
+    std::string frameName = ReadToken(context);
+    SkipWhitespace(context);
+    SkipChar(context, '{');
+
+    // Parse frame contents
+    while (context.position < context.content.length())
+    {
+        SkipWhitespace(context);
+        if (PeekChar(context) == '}')
+        {
+            ReadChar(context); // consume '}'
+            break;
+        }
+
+        std::string_view token = ReadKeyword(context);
+
+        if (token == "FrameTransformMatrix")
+        {
+            // Transformation matrix; frames are flattened, so it is skipped
+            SkipWhitespace(context);
+            SkipChar(context, '{');
+
+            for (int i = 0; i < 16; ++i)
+            {
+                ReadFloat(context);
+                if (i < 15)
+                    SkipChar(context, ',');
+                SkipChar(context, ';');
+            }
+
+            SkipChar(context, '}');
+        }
+        else if (token == "Mesh")
+        {
+            // Parse mesh within this frame
+            XMeshData mesh;
+            if (ParseMesh(context, mesh))
+            {
+                mesh.name = frameName + "_Mesh";
+                scene.meshes.push_back(std::move(mesh));
+            }
+        }
+        else if (token == "Frame")
+        {
+            // Recursive frame parsing (child frames)
+            ParseFrame(context, scene);
+        }
+        else
+        {
+            SkipObject(context);
+        }
+    }
+}
+
+void XFileParser::ParseAnimationSet(XFileContext& context, XFileScene& scene)
+{
+    PROFILE_FUNCTION();
+
+    XAnimationSetData animationSet;
+    animationSet.name = ReadToken(context);
+    SkipWhitespace(context);
+    SkipChar(context, '{');
+
+    // Parse animation content
+    while (context.position < context.content.length())
+    {
+        SkipWhitespace(context);
+        if (PeekChar(context) == '}')
+        {
+            ReadChar(context); // consume '}'
+            break;
+        }
+
+        std::string_view token = ReadKeyword(context);
+
+        if (token == "Animation")
+        {
+            // Parse individual animation for a bone
+            std::string boneName = ReadToken(context);
+            SkipWhitespace(context);
+            SkipChar(context, '{');
+
+            AnimationChannel channel;
+            channel.boneName = boneName;
+
+            // Parse animation keys
+            while (context.position < context.content.length())
+            {
+                SkipWhitespace(context);
+                if (PeekChar(context) == '}')
+                {
+                    ReadChar(context); // consume '}'
+                    break;
+                }
+
+                std::string_view keyToken = ReadKeyword(context);
+
+                if (keyToken == "AnimationKey")
+                {
+                    SkipWhitespace(context);
+                    SkipChar(context, '{');
+
+                    // Read key type (0=rotation, 1=scale, 2=position)
+                    int keyType = ReadInt(context);
+
+                    // Read number of keys
+                    int numKeys = ReadInt(context);
+
+                    // Reserve the channel's key array once instead of growing it per key
+                    std::vector<AnimationKey<XMVECTOR>>* keys = nullptr;
+                    if (keyType == 0)
+                        keys = &channel.rotationKeys;
+                    else if (keyType == 1)
+                        keys = &channel.scaleKeys;
+                    else if (keyType == 2)
+                        keys = &channel.positionKeys;
+
+                    if (keys && numKeys > 0)
+                    {
+                        keys->reserve(keys->size() + static_cast<size_t>(numKeys));
+                    }
+
+                    for (int i = 0; i < numKeys; ++i)
+                    {
+                        // Read time
+                        float time = ReadFloat(context);
+                        SkipChar(context, ';');
+
+                        // Read number of values
+                        int numValues = ReadInt(context);
+                        SkipChar(context, ';');
+
+                        // Values consumed by the key itself
+                        int valuesRead = 0;
+
+                        if (keyType == 2) // Position
+                        {
+                            if (numValues >= 3)
+                            {
+                                float x = ReadFloat(context); SkipChar(context, ',');
+                                float y = ReadFloat(context); SkipChar(context, ',');
+                                float z = ReadFloat(context);
+
+                                AnimationKey<XMVECTOR> key(time, XMVectorSet(x, y, z, 0.0f));
+                                channel.positionKeys.push_back(key);
+                                valuesRead = 3;
+                            }
+                        }
+                        else if (keyType == 0) // Rotation (quaternion)
+                        {
+                            if (numValues >= 4)
+                            {
+                                float w = ReadFloat(context); SkipChar(context, ',');
+                                float x = ReadFloat(context); SkipChar(context, ',');
+                                float y = ReadFloat(context); SkipChar(context, ',');
+                                float z = ReadFloat(context);
+
+                                AnimationKey<XMVECTOR> key(time, XMVectorSet(x, y, z, w));
+                                channel.rotationKeys.push_back(key);
+                                valuesRead = 4;
+                            }
+                        }
+                        else if (keyType == 1) // Scale
+                        {
+                            if (numValues >= 3)
+                            {
+                                float x = ReadFloat(context); SkipChar(context, ',');
+                                float y = ReadFloat(context); SkipChar(context, ',');
+                                float z = ReadFloat(context);
+
+                                AnimationKey<XMVECTOR> key(time, XMVectorSet(x, y, z, 0.0f));
+                                channel.scaleKeys.push_back(key);
+                                valuesRead = 3;
+                            }
+                        }
+
+                        // Skip remaining values
+                        for (int j = valuesRead; j < numValues; ++j)
+                        {
+                            ReadFloat(context);
+                        }
+                    }
+
+                    SkipChar(context, '}');
+                }
+                else
+                {
+                    SkipObject(context);
+                }
+            }
+
+            if (!channel.positionKeys.empty() || !channel.rotationKeys.empty() || !channel.scaleKeys.empty())
+            {
+                animationSet.channels.push_back(std::move(channel));
+            }
+        }
+        else
+        {
+            SkipObject(context);
+        }
+    }
+
+    // Calculate animation duration
+    for (const auto& channel : animationSet.channels)
+    {
+        for (const auto& key : channel.positionKeys)
+        {
+            animationSet.duration = std::max(animationSet.duration, key.time);
+        }
+        for (const auto& key : channel.rotationKeys)
+        {
+            animationSet.duration = std::max(animationSet.duration, key.time);
+        }
+        for (const auto& key : channel.scaleKeys)
+        {
+            animationSet.duration = std::max(animationSet.duration, key.time);
+        }
+    }
+
+    scene.animationSets.push_back(std::move(animationSet));
+}
+
+// Utility functions for parsing
+void XFileParser::SkipWhitespace(XFileContext& context)
+{
+    // In text .x files ',' and ';' only separate list elements. Parsing is
+    // driven by the element counts, so they are skipped like whitespace;
+    // otherwise the ';' after a count would be read as the next number.
+    while (context.position < context.content.length())
+    {
+        char c = context.content[context.position];
+        if (!std::isspace(static_cast<unsigned char>(c)) && c != ',' && c != ';')
+            break;
+
+        context.position++;
+    }
+}
+
+std::string_view XFileParser::ReadKeyword(XFileContext& context)
+{
+    SkipWhitespace(context);
+
+    size_t start = context.position;
+    while (context.position < context.content.length())
+    {
+        char c = context.content[context.position];
+        if (std::isalnum(static_cast<unsigned char>(c)) || c == '_')
+        {
+            context.position++;
+        }
+        else
+        {
+            break;
+        }
+    }
+
+    return std::string_view(context.content).substr(start, context.position - start);
+}
+
+std::string XFileParser::ReadToken(XFileContext& context)
+{
+    return std::string(ReadKeyword(context));
+}
+
+char XFileParser::ReadChar(XFileContext& context)
+{
+    if (context.position < context.content.length())
+    {
+        return context.content[context.position++];
+    }
+    return 0;
+}
+
+char XFileParser::PeekChar(XFileContext& context)
+{
+    if (context.position < context.content.length())
+    {
+        return context.content[context.position];
+    }
+    return 0;
+}
+
+void XFileParser::SkipChar(XFileContext& context, char expected)
+{
+    SkipWhitespace(context);
+    if (context.position < context.content.length() &&
+        context.content[context.position] == expected)
+    {
+        context.position++;
+    }
+}
+
+int XFileParser::ReadInt(XFileContext& context)
+{
+    SkipWhitespace(context);
+
+    char buffer[NUMBER_BUFFER_SIZE];
+    size_t length = ReadNumber(context, false, buffer);
+    return length == 0 ? 0 : static_cast<int>(std::strtol(buffer, nullptr, 10));
+}
+
+float XFileParser::ReadFloat(XFileContext& context)
+{
+    SkipWhitespace(context);
+
+    char buffer[NUMBER_BUFFER_SIZE];
+    size_t length = ReadNumber(context, true, buffer);
+    return length == 0 ? 0.0f : std::strtof(buffer, nullptr);
+}
+
+size_t XFileParser::ReadNumber(XFileContext& context, bool allowFraction, char (&buffer)[NUMBER_BUFFER_SIZE])
+{
+    // Numbers are copied into a stack buffer for the C conversion functions;
+    // digits beyond its size are consumed but ignored
+    size_t length = 0;
+    while (context.position < context.content.length())
+    {
+        char c = context.content[context.position];
+        bool accepted = std::isdigit(static_cast<unsigned char>(c)) || c == '-' ||
+                        (allowFraction && (c == '.' || c == 'e' || c == 'E' || c == '+'));
+        if (!accepted)
+        {
+            break;
+        }
+
+        if (length + 1 < NUMBER_BUFFER_SIZE)
+        {
+            buffer[length++] = c;
+        }
+        context.position++;
+    }
+
+    buffer[length] = '\0';
+    return length;
+}
+
+void XFileParser::SkipObject(XFileContext& context)
+{
+    SkipWhitespace(context);
+
+    // Skip until we find opening brace
+    while (context.position < context.content.length() &&
+           context.content[context.position] != '{')
+    {
+        context.position++;
+    }
+
+    if (context.position >= context.content.length())
+        return;
+
+    context.position++; // Skip '{'
+
+    int braceLevel = 1;
+    while (context.position < context.content.length() && braceLevel > 0)
+    {
+        char c = context.content[context.position++];
+        if (c == '{')
+            braceLevel++;
+        else if (c == '}')
+            braceLevel--;
+    }
+}
+
+// Binary file reading implementations
+template<typename T>
+T XFileParser::ReadBinary(XFileContext& context)
+{
+    if (context.position + sizeof(T) > context.content.length())
+    {
+        throw std::runtime_error("XFileParser: Unexpected end of binary data");
+    }
+
+    T value;
+    std::memcpy(&value, context.content.data() + context.position, sizeof(T));
+    context.position += sizeof(T);
+    return value;
+}
+
+uint16_t XFileParser::ReadUInt16Binary(XFileContext& context)
+{
+    return ReadBinary<uint16_t>(context);
+}
+
+uint32_t XFileParser::ReadUInt32Binary(XFileContext& context)
+{
+    return ReadBinary<uint32_t>(context);
+}
+
+float XFileParser::ReadFloatBinary(XFileContext& context)
+{
+    return ReadBinary<float>(context);
+}
+
+std::string XFileParser::ReadStringBinary(XFileContext& context)
+{
+    uint32_t length = ReadUInt32Binary(context);
+    if (length == 0) return "";
+
+    if (context.position + length > context.content.length())
+    {
+        throw std::runtime_error("XFileParser: String length exceeds available data");
+    }
+
+    std::string result(context.content.data() + context.position, length);
+    context.position += length;
+
+    // Skip null terminator if present
+    if (context.position < context.content.length() &&
+        context.content[context.position] == '\0')
+    {
+        context.position++;
+    }
+
+    return result;
+}
@@ -0,0 +1,125 @@
+#pragma once
+
+#include <DirectXMath.h>
+#include <string>
+#include <string_view>
+#include <vector>
+#include <cstdint>
+#include "Animation.h"
+#include "../Resources/Vertex.h"
+
+// .X file parsing context
+struct XFileContext
+{
+    std::string content;
+    size_t position;
+    bool isBinary;
+    bool isCompressed;
+
+    XFileContext() : position(0), isBinary(false), isCompressed(false) {}
+};
+
+// Parsed material data from .x file
+struct XMaterialData
+{
+    std::string name;
+    DirectX::XMFLOAT4 diffuseColor;
+    DirectX::XMFLOAT4 specularColor;
+    DirectX::XMFLOAT4 emissiveColor;
+    float shininess;
+    std::string textureFilename;
+
+    XMaterialData()
+        : diffuseColor(0.8f, 0.8f, 0.8f, 1.0f)
+        , specularColor(1.0f, 1.0f, 1.0f, 1.0f)
+        , emissiveColor(0.0f, 0.0f, 0.0f, 1.0f)
+        , shininess(32.0f)
+    {
+    }
+};
+
+// Parsed mesh data from .x file, already expanded to render vertices
+struct XMeshData
+{
+    std::string name;
+    std::vector<Vertex> vertices;
+    std::vector<unsigned int> indices;
+    std::vector<XMaterialData> materials; // From the mesh's MeshMaterialList
+};
+
+// Parsed animation set; channels are keyed by bone name
+struct XAnimationSetData
+{
+    std::string name;
+    float duration;
+    std::vector<AnimationChannel> channels;
+
+    XAnimationSetData() : duration(0.0f) {}
+};
+
+// Everything read from one file. Meshes nested in frames are flattened and
+// named after their frame.
+struct XFileScene
+{
+    std::vector<XMeshData> meshes;
+    std::vector<XMaterialData> materials;
+    std::vector<XAnimationSetData> animationSets;
+
+    void Clear();
+};
+
+// Text .x parser. Produces plain CPU data only; ModelLoader turns it into
+// meshes and materials on a device, which keeps parsing usable (and
+// measurable) without Direct3D.
+class XFileParser
+{
+public:
+    XFileParser();
+
+    void SetScaleFactor(float scale) { m_scaleFactor = scale; }
+    void SetFlipWindingOrder(bool flip) { m_flipWindingOrder = flip; }
+    void SetLoadAnimations(bool load) { m_loadAnimations = load; }
+
+    // False if the header is invalid or the format is unsupported
+    bool Parse(XFileContext& context, XFileScene& scene);
+    bool Parse(const std::string& content, XFileScene& scene);
+
+private:
+    // File structure
+    bool ParseHeader(XFileContext& context);
+    void SkipTemplates(XFileContext& context);
+
+    // Template parsing
+    bool ParseMesh(XFileContext& context, XMeshData& mesh);
+    void ParseMeshNormals(XFileContext& context, XMeshData& mesh);
+    void ParseMeshTextureCoords(XFileContext& context, XMeshData& mesh);
+    void ParseMeshMaterialList(XFileContext& context, XMeshData& mesh);
+    void ParseMaterial(XFileContext& context, XMaterialData& material);
+    void ParseFrame(XFileContext& context, XFileScene& scene);
+    void ParseAnimationSet(XFileContext& context, XFileScene& scene);
+
+    // Text tokens
+    void SkipWhitespace(XFileContext& context);
+    std::string ReadToken(XFileContext& context);
+    std::string_view ReadKeyword(XFileContext& context);   // View into the content; for comparisons
+    char ReadChar(XFileContext& context);
+    char PeekChar(XFileContext& context);
+    void SkipChar(XFileContext& context, char expected);
+    int ReadInt(XFileContext& context);
+    float ReadFloat(XFileContext& context);
+    static const size_t NUMBER_BUFFER_SIZE = 64;
+    size_t ReadNumber(XFileContext& context, bool allowFraction, char (&buffer)[NUMBER_BUFFER_SIZE]);
+    void SkipObject(XFileContext& context);
+
+    // Binary file reading helpers
+    template<typename T> T ReadBinary(XFileContext& context);
+    uint16_t ReadUInt16Binary(XFileContext& context);
+    uint32_t ReadUInt32Binary(XFileContext& context);
+    float ReadFloatBinary(XFileContext& context);
+    std::string ReadStringBinary(XFileContext& context);
+
+private:
+    float m_scaleFactor;
+    bool m_flipWindingOrder;
+    bool m_loadAnimations;
+};
@@ -1,6 +1,8 @@
 #include "Material.h"
+#include <d3d11.h>
 #include "Texture.h"
 #include "../Graphics/Shader.h"
+#include "../Engine/Profiler.h"
 #include <fstream>
 #include <sstream>
 #include <iostream>
@@ -114,17 +116,42 @@ void Material::RemoveTexture(TextureType type)
 
 void Material::Apply(ID3D11DeviceContext* context, Shader* shader)
 {
+    PROFILE_FUNCTION();
+
     if (!context || !shader || !m_isInitialized)
     {
         return;
     }
 
+    PrepareForRender(context);
+    Bind(context);
+}
+
+void Material::PrepareForRender(ID3D11DeviceContext* context)
+{
+    PROFILE_FUNCTION();
+
+    if (!context || !m_isInitialized)
+    {
+        return;
+    }
+
     // Update constant buffer if properties have changed
     if (m_isDirty)
     {
         UpdateConstantBuffer(context);
         m_isDirty = false;
     }
+}
+
+void Material::Bind(ID3D11DeviceContext* context)
+{
+    PROFILE_FUNCTION();
+
+    if (!context || !m_isInitialized)
+    {
+        return;
+    }
 
     // Bind material constant buffer to shader
     context->VSSetConstantBuffers(1, 1, &m_constantBuffer);  // Slot 1 for vertex shader
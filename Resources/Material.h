@@ -1,10 +1,10 @@
 #pragma once
 
 #include <DirectXMath.h>
-#include <d3d11.h>
 #include <string>
 #include <memory>
 #include <vector>
+#include "../Graphics/D3D11Forward.h"
 
 using namespace DirectX;
 
@@ -70,6 +70,12 @@ public:
     void Apply(ID3D11DeviceContext* context, Shader* shader);
     void UpdateConstantBuffer(ID3D11DeviceContext* context);
 
+    // Split form of Apply for multithreaded recording: PrepareForRender runs on
+    // the immediate context before recording, Bind only sets slots and may be
+    // called from any deferred context
+    void PrepareForRender(ID3D11DeviceContext* context);
+    void Bind(ID3D11DeviceContext* context);
+
     // Utility functions
     bool IsTransparent() const { return m_properties.transparency < 1.0f; }
     void SetDefaultValues();
@@ -1,8 +1,13 @@
 #include "Mesh.h"
+#include <d3d11.h>
+#include "MeshProcessing.h"
 #include "Material.h"
+#include "../Graphics/FrustumCulling.h"
+#include "../Graphics/OcclusionCulling.h"
+#include "../Engine/Profiler.h"
+#include "../Engine/Memory.h"
 #include <iostream>
 #include <algorithm>
-#include <unordered_map>
 
 // BoundingBox implementation
 void BoundingBox::UpdateFromVertices(const std::vector<Vertex>& vertices)
@@ -79,10 +84,29 @@ bool BoundingBox::IntersectsBox(const BoundingBox& other) const
             min.z <= other.max.z && max.z >= other.min.z);
 }
 
+BoundingBox BoundingBox::Transform(const XMMATRIX& transform) const
+{
+    BoundingBox result;
+    FrustumCulling::TransformBox(center, extents, transform, result.center, result.extents);
+
+    result.min = XMFLOAT3(result.center.x - result.extents.x,
+                          result.center.y - result.extents.y,
+                          result.center.z - result.extents.z);
+    result.max = XMFLOAT3(result.center.x + result.extents.x,
+                          result.center.y + result.extents.y,
+                          result.center.z + result.extents.z);
+    return result;
+}
+
 // Mesh implementation
 Mesh::Mesh()
-    : m_vertexBuffer(nullptr)
+    : m_vertexCount(0)
+    , m_indexCount(0)
+    , m_residency(MeshResidency::KeepCpu)
+    , m_cpuGeometryDiscarded(false)
+    , m_vertexBuffer(nullptr)
     , m_indexBuffer(nullptr)
+    , m_gpuMemoryBytes(0)
     , m_materialIndex(-1)
     , m_isInitialized(false)
     , m_isSkinnedMesh(false)
@@ -130,6 +154,9 @@ bool Mesh::InitializeFromVertices(ID3D11Device* device,
     }
 
     UpdateBoundingBox();
+    UpdateGeometryCounts();
+    ApplyResidency();
+    UpdateMemoryTracking();
     m_isInitialized = true;
     return true;
 }
@@ -156,6 +183,9 @@ bool Mesh::InitializeFromSkinnedVertices(ID3D11Device* device,
     }
 
     UpdateBoundingBox();
+    UpdateGeometryCounts();
+    ApplyResidency();
+    UpdateMemoryTracking();
     m_isInitialized = true;
     return true;
 }
@@ -174,13 +204,125 @@ void Mesh::Shutdown()
         m_vertexBuffer = nullptr;
     }
 
-    m_vertices.clear();
-    m_skinnedVertices.clear();
-    m_indices.clear();
+    // Swap instead of clear so the capacity is released as well
+    std::vector<Vertex>().swap(m_vertices);
+    std::vector<SkinnedVertex>().swap(m_skinnedVertices);
+    std::vector<unsigned int>().swap(m_indices);
+    std::vector<XMFLOAT3>().swap(m_positions);
     m_material.reset();
 
+    m_gpuMemoryBytes = 0;
+    m_vertexCount = 0;
+    m_indexCount = 0;
+    m_cpuGeometryDiscarded = false;
     m_isInitialized = false;
     m_isSkinnedMesh = false;
+
+    Memory::UntrackResource(MemoryCategory::MeshCpu, this);
+    Memory::UntrackResource(MemoryCategory::MeshGpu, this);
+}
+
+void Mesh::SetName(const std::string& name)
+{
+    m_name = name;
+    UpdateMemoryTracking();
+}
+
+void Mesh::SetAssetName(const std::string& assetName)
+{
+    m_assetName = assetName;
+    UpdateMemoryTracking();
+}
+
+size_t Mesh::GetCpuMemoryBytes() const
+{
+    return m_vertices.capacity() * sizeof(Vertex) +
+           m_skinnedVertices.capacity() * sizeof(SkinnedVertex) +
+           m_indices.capacity() * sizeof(unsigned int) +
+           m_positions.capacity() * sizeof(XMFLOAT3);
+}
+
+void Mesh::SetResidency(MeshResidency residency)
+{
+    if (m_cpuGeometryDiscarded && residency != m_residency)
+    {
+        std::cerr << "Mesh: " << m_name << ": CPU geometry already discarded, residency unchanged" << std::endl;
+        return;
+    }
+
+    m_residency = residency;
+
+    // Before the first upload the policy waits for CreateBuffers
+    if (m_vertexBuffer)
+    {
+        ApplyResidency();
+        UpdateMemoryTracking();
+    }
+}
+
+void Mesh::UpdateGeometryCounts()
+{
+    m_vertexCount = m_isSkinnedMesh ? m_skinnedVertices.size() : m_vertices.size();
+    m_indexCount = m_indices.size();
+}
+
+void Mesh::ApplyResidency()
+{
+    if (m_residency == MeshResidency::KeepCpu || m_cpuGeometryDiscarded)
+    {
+        return;
+    }
+
+    if (m_residency == MeshResidency::PositionsOnly)
+    {
+        m_positions.clear();
+        m_positions.reserve(m_vertexCount);
+        if (m_isSkinnedMesh)
+        {
+            for (const auto& vertex : m_skinnedVertices)
+            {
+                m_positions.push_back(vertex.position);
+            }
+        }
+        else
+        {
+            for (const auto& vertex : m_vertices)
+            {
+                m_positions.push_back(vertex.position);
+            }
+        }
+    }
+    else
+    {
+        std::vector<unsigned int>().swap(m_indices);
+    }
+
+    // Swap instead of clear so the capacity is released as well
+    std::vector<Vertex>().swap(m_vertices);
+    std::vector<SkinnedVertex>().swap(m_skinnedVertices);
+    m_cpuGeometryDiscarded = true;
+}
+
+bool Mesh::RequireCpuVertices(const char* operation) const
+{
+    if (m_cpuGeometryDiscarded)
+    {
+        std::cerr << "Mesh: " << m_name << ": " << operation << " needs the CPU vertices, which were discarded after upload" << std::endl;
+        return false;
+    }
+    return true;
+}
+
+void Mesh::UpdateMemoryTracking()
+{
+    // Nothing to report before the first upload; Shutdown untracks
+    if (!m_vertexBuffer)
+    {
+        return;
+    }
+
+    Memory::TrackResource(MemoryCategory::MeshCpu, this, GetAssetName(), GetCpuMemoryBytes());
+    Memory::TrackResource(MemoryCategory::MeshGpu, this, GetAssetName(), m_gpuMemoryBytes);
 }
 
 void Mesh::Render(ID3D11DeviceContext* context)
@@ -207,12 +349,12 @@ void Mesh::Render(ID3D11DeviceContext* context)
     }
 
     // Set primitive topology
-    context->IASetPrimitiveTopology(m_primitiveTopology);
+    context->IASetPrimitiveTopology(static_cast<D3D11_PRIMITIVE_TOPOLOGY>(m_primitiveTopology));
 
     // Draw
-    if (m_indexBuffer && !m_indices.empty())
+    if (m_indexBuffer && m_indexCount > 0)
     {
-        context->DrawIndexed(static_cast<UINT>(m_indices.size()), 0, 0);
+        context->DrawIndexed(static_cast<UINT>(m_indexCount), 0, 0);
     }
     else
     {
@@ -244,12 +386,12 @@ void Mesh::RenderInstanced(ID3D11DeviceContext* context, int instanceCount)
     }
 
     // Set primitive topology
-    context->IASetPrimitiveTopology(m_primitiveTopology);
+    context->IASetPrimitiveTopology(static_cast<D3D11_PRIMITIVE_TOPOLOGY>(m_primitiveTopology));
 
     // Draw instanced
-    if (m_indexBuffer && !m_indices.empty())
+    if (m_indexBuffer && m_indexCount > 0)
     {
-        context->DrawIndexedInstanced(static_cast<UINT>(m_indices.size()), instanceCount, 0, 0, 0);
+        context->DrawIndexedInstanced(static_cast<UINT>(m_indexCount), instanceCount, 0, 0, 0);
     }
     else
     {
@@ -257,135 +399,67 @@ void Mesh::RenderInstanced(ID3D11DeviceContext* context, int instanceCount)
     }
 }
 
-int Mesh::GetVertexCount() const
+void Mesh::RenderInstanced(ID3D11DeviceContext* context,
+                          ID3D11Buffer* instanceBuffer,
+                          UINT instanceStride,
+                          int instanceCount,
+                          int startInstance)
 {
-    if (m_isSkinnedMesh)
+    if (!context || !IsValid() || !instanceBuffer || instanceCount <= 0)
     {
-        return static_cast<int>(m_skinnedVertices.size());
+        return;
     }
-    return static_cast<int>(m_vertices.size());
-}
 
-void Mesh::CalculateNormals()
-{
-    if (m_isSkinnedMesh)
-    {
-        if (m_skinnedVertices.empty() || m_indices.empty())
-            return;
-
-        // Reset all normals to zero
-        for (auto& vertex : m_skinnedVertices)
-        {
-            vertex.normal = XMFLOAT3(0.0f, 0.0f, 0.0f);
-        }
+    // Slot 0 carries the mesh geometry, slot 1 the per-instance stream
+    ID3D11Buffer* buffers[2] = { m_vertexBuffer, instanceBuffer };
+    UINT strides[2] = { m_stride, instanceStride };
+    UINT offsets[2] = { m_offset, 0 };
+    context->IASetVertexBuffers(0, 2, buffers, strides, offsets);
 
-        // Calculate face normals and accumulate
-        for (size_t i = 0; i < m_indices.size(); i += 3)
-        {
-            if (i + 2 >= m_indices.size())
-                break;
-
-            UINT i0 = m_indices[i];
-            UINT i1 = m_indices[i + 1];
-            UINT i2 = m_indices[i + 2];
-
-            if (i0 >= m_skinnedVertices.size() || i1 >= m_skinnedVertices.size() || i2 >= m_skinnedVertices.size())
-                continue;
-
-            XMVECTOR v0 = XMLoadFloat3(&m_skinnedVertices[i0].position);
-            XMVECTOR v1 = XMLoadFloat3(&m_skinnedVertices[i1].position);
-            XMVECTOR v2 = XMLoadFloat3(&m_skinnedVertices[i2].position);
-
-            XMVECTOR edge1 = XMVectorSubtract(v1, v0);
-            XMVECTOR edge2 = XMVectorSubtract(v2, v0);
-            XMVECTOR normal = XMVector3Cross(edge1, edge2);
-            normal = XMVector3Normalize(normal);
-
-            XMFLOAT3 normalFloat;
-            XMStoreFloat3(&normalFloat, normal);
-
-            m_skinnedVertices[i0].normal.x += normalFloat.x;
-            m_skinnedVertices[i0].normal.y += normalFloat.y;
-            m_skinnedVertices[i0].normal.z += normalFloat.z;
-
-            m_skinnedVertices[i1].normal.x += normalFloat.x;
-            m_skinnedVertices[i1].normal.y += normalFloat.y;
-            m_skinnedVertices[i1].normal.z += normalFloat.z;
+    // Set index buffer
+    if (m_indexBuffer)
+    {
+        context->IASetIndexBuffer(m_indexBuffer, DXGI_FORMAT_R32_UINT, 0);
+    }
 
-            m_skinnedVertices[i2].normal.x += normalFloat.x;
-            m_skinnedVertices[i2].normal.y += normalFloat.y;
-            m_skinnedVertices[i2].normal.z += normalFloat.z;
-        }
+    // Set primitive topology
+    context->IASetPrimitiveTopology(static_cast<D3D11_PRIMITIVE_TOPOLOGY>(m_primitiveTopology));
 
-        // Normalize all normals
-        for (auto& vertex : m_skinnedVertices)
-        {
-            XMVECTOR normal = XMLoadFloat3(&vertex.normal);
-            normal = XMVector3Normalize(normal);
-            XMStoreFloat3(&vertex.normal, normal);
-        }
+    // Draw instanced, starting at the batch's first instance in the shared stream
+    if (m_indexBuffer && m_indexCount > 0)
+    {
+        context->DrawIndexedInstanced(static_cast<UINT>(m_indexCount), instanceCount, 0, 0, startInstance);
     }
     else
     {
-        if (m_vertices.empty() || m_indices.empty())
-            return;
-
-        // Reset all normals to zero
-        for (auto& vertex : m_vertices)
-        {
-            vertex.normal = XMFLOAT3(0.0f, 0.0f, 0.0f);
-        }
-
-        // Calculate face normals and accumulate
-        for (size_t i = 0; i < m_indices.size(); i += 3)
-        {
-            if (i + 2 >= m_indices.size())
-                break;
-
-            UINT i0 = m_indices[i];
-            UINT i1 = m_indices[i + 1];
-            UINT i2 = m_indices[i + 2];
-
-            if (i0 >= m_vertices.size() || i1 >= m_vertices.size() || i2 >= m_vertices.size())
-                continue;
-
-            XMVECTOR v0 = XMLoadFloat3(&m_vertices[i0].position);
-            XMVECTOR v1 = XMLoadFloat3(&m_vertices[i1].position);
-            XMVECTOR v2 = XMLoadFloat3(&m_vertices[i2].position);
-
-            XMVECTOR edge1 = XMVectorSubtract(v1, v0);
-            XMVECTOR edge2 = XMVectorSubtract(v2, v0);
-            XMVECTOR normal = XMVector3Cross(edge1, edge2);
-            normal = XMVector3Normalize(normal);
-
-            XMFLOAT3 normalFloat;
-            XMStoreFloat3(&normalFloat, normal);
-
-            m_vertices[i0].normal.x += normalFloat.x;
-            m_vertices[i0].normal.y += normalFloat.y;
-            m_vertices[i0].normal.z += normalFloat.z;
-
-            m_vertices[i1].normal.x += normalFloat.x;
-            m_vertices[i1].normal.y += normalFloat.y;
-            m_vertices[i1].normal.z += normalFloat.z;
+        context->DrawInstanced(GetVertexCount(), instanceCount, 0, startInstance);
+    }
+}
 
-            m_vertices[i2].normal.x += normalFloat.x;
-            m_vertices[i2].normal.y += normalFloat.y;
-            m_vertices[i2].normal.z += normalFloat.z;
-        }
+void Mesh::CalculateNormals()
+{
+    if (!RequireCpuVertices("CalculateNormals"))
+    {
+        return;
+    }
 
-        // Normalize all normals
-        for (auto& vertex : m_vertices)
-        {
-            XMVECTOR normal = XMLoadFloat3(&vertex.normal);
-            normal = XMVector3Normalize(normal);
-            XMStoreFloat3(&vertex.normal, normal);
-        }
+    if (m_isSkinnedMesh)
+    {
+        MeshProcessing::CalculateNormals(m_skinnedVertices, m_indices);
+    }
+    else
+    {
+        MeshProcessing::CalculateNormals(m_vertices, m_indices);
     }
 }
 
 void Mesh::CalculateTangentsAndBinormals()
 {
+    if (!RequireCpuVertices("CalculateTangentsAndBinormals"))
+    {
+        return;
+    }
+
     if (m_isSkinnedMesh)
     {
         if (m_skinnedVertices.empty() || m_indices.empty())
@@ -561,96 +635,30 @@ void Mesh::CalculateTangentsAndBinormals()
 
 void Mesh::OptimizeVertices()
 {
-    if (m_isSkinnedMesh)
+    if (!RequireCpuVertices("OptimizeVertices"))
     {
-        // Create a map to track unique vertices
-        std::unordered_map<size_t, size_t> vertexMap;
-        std::vector<SkinnedVertex> optimizedVertices;
-        std::vector<unsigned int> optimizedIndices;
-
-        for (unsigned int index : m_indices)
-        {
-            if (index >= m_skinnedVertices.size())
-                continue;
-
-            const auto& vertex = m_skinnedVertices[index];
-
-            // Create a simple hash for the vertex (position + normal + texcoord)
-            size_t hash = 0;
-            hash ^= std::hash<float>{}(vertex.position.x) + 0x9e3779b9 + (hash << 6) + (hash >> 2);
-            hash ^= std::hash<float>{}(vertex.position.y) + 0x9e3779b9 + (hash << 6) + (hash >> 2);
-            hash ^= std::hash<float>{}(vertex.position.z) + 0x9e3779b9 + (hash << 6) + (hash >> 2);
-            hash ^= std::hash<float>{}(vertex.normal.x) + 0x9e3779b9 + (hash << 6) + (hash >> 2);
-            hash ^= std::hash<float>{}(vertex.normal.y) + 0x9e3779b9 + (hash << 6) + (hash >> 2);
-            hash ^= std::hash<float>{}(vertex.normal.z) + 0x9e3779b9 + (hash << 6) + (hash >> 2);
-            hash ^= std::hash<float>{}(vertex.texCoord.x) + 0x9e3779b9 + (hash << 6) + (hash >> 2);
-            hash ^= std::hash<float>{}(vertex.texCoord.y) + 0x9e3779b9 + (hash << 6) + (hash >> 2);
-
-            auto it = vertexMap.find(hash);
-            if (it != vertexMap.end())
-            {
-                // Vertex already exists, reuse index
-                optimizedIndices.push_back(static_cast<unsigned int>(it->second));
-            }
-            else
-            {
-                // New vertex, add to optimized list
-                size_t newIndex = optimizedVertices.size();
-                optimizedVertices.push_back(vertex);
-                vertexMap[hash] = newIndex;
-                optimizedIndices.push_back(static_cast<unsigned int>(newIndex));
-            }
-        }
+        return;
+    }
 
-        m_skinnedVertices = std::move(optimizedVertices);
-        m_indices = std::move(optimizedIndices);
+    if (m_isSkinnedMesh)
+    {
+        MeshProcessing::WeldVertices(m_skinnedVertices, m_indices);
     }
     else
     {
-        // Similar implementation for regular vertices
-        std::unordered_map<size_t, size_t> vertexMap;
-        std::vector<Vertex> optimizedVertices;
-        std::vector<unsigned int> optimizedIndices;
-
-        for (unsigned int index : m_indices)
-        {
-            if (index >= m_vertices.size())
-                continue;
-
-            const auto& vertex = m_vertices[index];
-
-            // Create a simple hash for the vertex
-            size_t hash = 0;
-            hash ^= std::hash<float>{}(vertex.position.x) + 0x9e3779b9 + (hash << 6) + (hash >> 2);
-            hash ^= std::hash<float>{}(vertex.position.y) + 0x9e3779b9 + (hash << 6) + (hash >> 2);
-            hash ^= std::hash<float>{}(vertex.position.z) + 0x9e3779b9 + (hash << 6) + (hash >> 2);
-            hash ^= std::hash<float>{}(vertex.normal.x) + 0x9e3779b9 + (hash << 6) + (hash >> 2);
-            hash ^= std::hash<float>{}(vertex.normal.y) + 0x9e3779b9 + (hash << 6) + (hash >> 2);
-            hash ^= std::hash<float>{}(vertex.normal.z) + 0x9e3779b9 + (hash << 6) + (hash >> 2);
-            hash ^= std::hash<float>{}(vertex.texCoord.x) + 0x9e3779b9 + (hash << 6) + (hash >> 2);
-            hash ^= std::hash<float>{}(vertex.texCoord.y) + 0x9e3779b9 + (hash << 6) + (hash >> 2);
-
-            auto it = vertexMap.find(hash);
-            if (it != vertexMap.end())
-            {
-                optimizedIndices.push_back(static_cast<unsigned int>(it->second));
-            }
-            else
-            {
-                size_t newIndex = optimizedVertices.size();
-                optimizedVertices.push_back(vertex);
-                vertexMap[hash] = newIndex;
-                optimizedIndices.push_back(static_cast<unsigned int>(newIndex));
-            }
-        }
-
-        m_vertices = std::move(optimizedVertices);
-        m_indices = std::move(optimizedIndices);
+        MeshProcessing::WeldVertices(m_vertices, m_indices);
     }
+
+    UpdateMemoryTracking();
 }
 
 void Mesh::FlipNormals()
 {
+    if (!RequireCpuVertices("FlipNormals"))
+    {
+        return;
+    }
+
     if (m_isSkinnedMesh)
     {
         for (auto& vertex : m_skinnedVertices)
@@ -682,6 +690,11 @@ void Mesh::FlipNormals()
 
 void Mesh::ScaleMesh(float scale)
 {
+    if (!RequireCpuVertices("ScaleMesh"))
+    {
+        return;
+    }
+
     if (m_isSkinnedMesh)
     {
         for (auto& vertex : m_skinnedVertices)
@@ -706,6 +719,11 @@ void Mesh::ScaleMesh(float scale)
 
 void Mesh::TransformMesh(const XMMATRIX& transform)
 {
+    if (!RequireCpuVertices("TransformMesh"))
+    {
+        return;
+    }
+
     XMMATRIX normalTransform = XMMatrixTranspose(XMMatrixInverse(nullptr, transform));
 
     if (m_isSkinnedMesh)
@@ -760,6 +778,40 @@ void Mesh::TransformMesh(const XMMATRIX& transform)
     UpdateBoundingBox();
 }
 
+void Mesh::CreateOccluder(OccluderMesh& occluder) const
+{
+    occluder.positions.clear();
+    occluder.indices.assign(m_indices.begin(), m_indices.end());
+
+    if (m_cpuGeometryDiscarded)
+    {
+        // PositionsOnly keeps what the rasterizer needs; otherwise nothing is left
+        occluder.positions = m_positions;
+        if (m_positions.empty())
+        {
+            occluder.indices.clear();
+        }
+        return;
+    }
+
+    if (m_isSkinnedMesh)
+    {
+        occluder.positions.reserve(m_skinnedVertices.size());
+        for (const auto& vertex : m_skinnedVertices)
+        {
+            occluder.positions.push_back(vertex.position);
+        }
+    }
+    else
+    {
+        occluder.positions.reserve(m_vertices.size());
+        for (const auto& vertex : m_vertices)
+        {
+            occluder.positions.push_back(vertex.position);
+        }
+    }
+}
+
 // Static utility functions for creating primitive meshes
 std::shared_ptr<Mesh> Mesh::CreateCube(ID3D11Device* device, float size)
 {
@@ -1006,6 +1058,7 @@ void Mesh::CreateBuffers(ID3D11Device* device)
         std::cout << "Failed to create vertex buffer" << std::endl;
         return;
     }
+    m_gpuMemoryBytes = vertexBufferDesc.ByteWidth;
 
     // Create index buffer if indices exist
     if (!m_indices.empty())
@@ -1025,6 +1078,10 @@ void Mesh::CreateBuffers(ID3D11Device* device)
         {
             std::cout << "Failed to create index buffer" << std::endl;
         }
+        else
+        {
+            m_gpuMemoryBytes += indexBufferDesc.ByteWidth;
+        }
     }
 }
 
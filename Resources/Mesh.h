@@ -1,91 +1,17 @@
 #pragma once
 
-#include <d3d11.h>
 #include <DirectXMath.h>
 #include <vector>
 #include <string>
 #include <memory>
+#include "Vertex.h"
+#include "../Graphics/D3D11Forward.h"
 
 using namespace DirectX;
 
 // Forward declarations
 class Material;
-
-// Vertex structure for standard mesh rendering
-struct Vertex
-{
-    XMFLOAT3 position;
-    XMFLOAT3 normal;
-    XMFLOAT2 texCoord;
-    XMFLOAT3 tangent;    // For normal mapping
-    XMFLOAT3 binormal;   // For normal mapping
-
-    Vertex()
-        : position(0.0f, 0.0f, 0.0f)
-        , normal(0.0f, 1.0f, 0.0f)
-        , texCoord(0.0f, 0.0f)
-        , tangent(1.0f, 0.0f, 0.0f)
-        , binormal(0.0f, 0.0f, 1.0f)
-    {
-    }
-
-    Vertex(const XMFLOAT3& pos, const XMFLOAT3& norm, const XMFLOAT2& tex)
-        : position(pos)
-        , normal(norm)
-        , texCoord(tex)
-        , tangent(1.0f, 0.0f, 0.0f)
-        , binormal(0.0f, 0.0f, 1.0f)
-    {
-    }
-};
-
-// Vertex structure for skinned mesh rendering (with bone weights)
-struct SkinnedVertex : public Vertex
-{
-    static const int MAX_BONE_INFLUENCES = 4;
-
-    int boneIndices[MAX_BONE_INFLUENCES];
-    float boneWeights[MAX_BONE_INFLUENCES];
-
-    SkinnedVertex() : Vertex()
-    {
-        for (int i = 0; i < MAX_BONE_INFLUENCES; ++i)
-        {
-            boneIndices[i] = 0;
-            boneWeights[i] = 0.0f;
-        }
-    }
-
-    void AddBoneInfluence(int boneIndex, float weight)
-    {
-        for (int i = 0; i < MAX_BONE_INFLUENCES; ++i)
-        {
-            if (boneWeights[i] == 0.0f)
-            {
-                boneIndices[i] = boneIndex;
-                boneWeights[i] = weight;
-                break;
-            }
-        }
-    }
-
-    void NormalizeBoneWeights()
-    {
-        float totalWeight = 0.0f;
-        for (int i = 0; i < MAX_BONE_INFLUENCES; ++i)
-        {
-            totalWeight += boneWeights[i];
-        }
-
-        if (totalWeight > 0.0f)
-        {
-            for (int i = 0; i < MAX_BONE_INFLUENCES; ++i)
-            {
-                boneWeights[i] /= totalWeight;
-            }
-        }
-    }
-};
+struct OccluderMesh;
 
 // Bounding box structure
 struct BoundingBox
@@ -107,6 +33,17 @@ struct BoundingBox
     void UpdateFromVertices(const std::vector<SkinnedVertex>& vertices);
     bool ContainsPoint(const XMFLOAT3& point) const;
     bool IntersectsBox(const BoundingBox& other) const;
+
+    // Conservative axis-aligned box enclosing this box after transformation
+    BoundingBox Transform(const XMMATRIX& transform) const;
+};
+
+// What a mesh keeps in system memory once its buffers are uploaded
+enum class MeshResidency
+{
+    KeepCpu = 0,            // Full vertex and index copies (default)
+    DiscardAfterUpload,     // Nothing; the mesh can only be rendered
+    PositionsOnly           // Positions and indices, for collision, picking and occluders
 };
 
 // Mesh class for storing and rendering 3D geometry
@@ -131,13 +68,28 @@ public:
     // Rendering
     void Render(ID3D11DeviceContext* context);
     void RenderInstanced(ID3D11DeviceContext* context, int instanceCount);
-
-    // Data access
+    void RenderInstanced(ID3D11DeviceContext* context,
+                        ID3D11Buffer* instanceBuffer,
+                        unsigned int instanceStride,
+                        int instanceCount,
+                        int startInstance = 0);
+
+    // Data access. Vertex arrays are empty once the CPU copy has been
+    // discarded (see SetResidency); indices survive with PositionsOnly.
     const std::vector<Vertex>& GetVertices() const { return m_vertices; }
     const std::vector<SkinnedVertex>& GetSkinnedVertices() const { return m_skinnedVertices; }
     const std::vector<unsigned int>& GetIndices() const { return m_indices; }
+    const std::vector<XMFLOAT3>& GetPositions() const { return m_positions; }
     const BoundingBox& GetBoundingBox() const { return m_boundingBox; }
 
+    // CPU geometry policy. Applied at the end of the next upload, or right
+    // away when the buffers already exist; discarded data cannot be brought
+    // back without initializing the mesh again.
+    void SetResidency(MeshResidency residency);
+    MeshResidency GetResidency() const { return m_residency; }
+    bool HasCpuVertices() const { return !m_cpuGeometryDiscarded; }
+    bool HasCpuPositions() const { return !m_cpuGeometryDiscarded || !m_positions.empty(); }
+
     // Material
     void SetMaterial(std::shared_ptr<Material> material) { m_material = material; }
     std::shared_ptr<Material> GetMaterial() const { return m_material; }
@@ -145,17 +97,28 @@ public:
     int GetMaterialIndex() const { return m_materialIndex; }
 
     // Properties
-    void SetName(const std::string& name) { m_name = name; }
+    void SetName(const std::string& name);
     const std::string& GetName() const { return m_name; }
 
-    int GetVertexCount() const;
-    int GetIndexCount() const { return static_cast<int>(m_indices.size()); }
+    // Asset the mesh is accounted to in the memory report (usually the model
+    // file); the mesh name is used when empty
+    void SetAssetName(const std::string& assetName);
+    const std::string& GetAssetName() const { return m_assetName.empty() ? m_name : m_assetName; }
+
+    // Footprint reported to MemoryCategory::MeshCpu and MeshGpu
+    size_t GetCpuMemoryBytes() const;
+    size_t GetGpuMemoryBytes() const { return m_gpuMemoryBytes; }
+
+    // Counts of the uploaded geometry; valid after the CPU copy is discarded
+    int GetVertexCount() const { return static_cast<int>(m_vertexCount); }
+    int GetIndexCount() const { return static_cast<int>(m_indexCount); }
     int GetTriangleCount() const { return GetIndexCount() / 3; }
 
     bool IsSkinnedMesh() const { return m_isSkinnedMesh; }
     bool IsValid() const { return m_isInitialized && m_vertexBuffer && m_indexBuffer; }
 
-    // Utility functions
+    // Utility functions. They edit the CPU copy only and are refused, with a
+    // message, once it has been discarded.
     void CalculateNormals();
     void CalculateTangentsAndBinormals();
     void OptimizeVertices(); // Remove duplicate vertices
@@ -163,6 +126,10 @@ public:
     void ScaleMesh(float scale);
     void TransformMesh(const XMMATRIX& transform);
 
+    // Positions and indices for the software occlusion rasterizer; works
+    // with PositionsOnly, leaves the occluder empty when nothing is kept
+    void CreateOccluder(OccluderMesh& occluder) const;
+
     // Static utility functions
     static std::shared_ptr<Mesh> CreateCube(ID3D11Device* device, float size = 1.0f);
     static std::shared_ptr<Mesh> CreateSphere(ID3D11Device* device, float radius = 1.0f, int segments = 16);
@@ -172,18 +139,29 @@ public:
 private:
     void CreateBuffers(ID3D11Device* device);
     void UpdateBoundingBox();
+    void UpdateMemoryTracking();
+    void UpdateGeometryCounts();
+    void ApplyResidency();
+    bool RequireCpuVertices(const char* operation) const;
 
 private:
     std::string m_name;
+    std::string m_assetName;
 
     // Vertex data
     std::vector<Vertex> m_vertices;
     std::vector<SkinnedVertex> m_skinnedVertices;
     std::vector<unsigned int> m_indices;
+    std::vector<XMFLOAT3> m_positions;  // PositionsOnly copy
+    size_t m_vertexCount;
+    size_t m_indexCount;
+    MeshResidency m_residency;
+    bool m_cpuGeometryDiscarded;
 
     // DirectX buffers
     ID3D11Buffer* m_vertexBuffer;
     ID3D11Buffer* m_indexBuffer;
+    size_t m_gpuMemoryBytes;
 
     // Bounding volume
     BoundingBox m_boundingBox;
@@ -197,7 +175,7 @@ private:
     bool m_isSkinnedMesh;
 
     // Rendering properties
-    D3D11_PRIMITIVE_TOPOLOGY m_primitiveTopology;
-    UINT m_stride;
-    UINT m_offset;
+    unsigned int m_primitiveTopology;   // D3D11_PRIMITIVE_TOPOLOGY
+    unsigned int m_stride;
+    unsigned int m_offset;
 };
@@ -0,0 +1,176 @@
+#include "MeshProcessing.h"
+#include "../Engine/Profiler.h"
+#include <functional>
+#include <cstdint>
+
+namespace
+{
+    size_t HashVertexKey(const Vertex& vertex)
+    {
+        size_t hash = 0;
+        hash ^= std::hash<float>{}(vertex.position.x) + 0x9e3779b9 + (hash << 6) + (hash >> 2);
+        hash ^= std::hash<float>{}(vertex.position.y) + 0x9e3779b9 + (hash << 6) + (hash >> 2);
+        hash ^= std::hash<float>{}(vertex.position.z) + 0x9e3779b9 + (hash << 6) + (hash >> 2);
+        hash ^= std::hash<float>{}(vertex.normal.x) + 0x9e3779b9 + (hash << 6) + (hash >> 2);
+        hash ^= std::hash<float>{}(vertex.normal.y) + 0x9e3779b9 + (hash << 6) + (hash >> 2);
+        hash ^= std::hash<float>{}(vertex.normal.z) + 0x9e3779b9 + (hash << 6) + (hash >> 2);
+        hash ^= std::hash<float>{}(vertex.texCoord.x) + 0x9e3779b9 + (hash << 6) + (hash >> 2);
+        hash ^= std::hash<float>{}(vertex.texCoord.y) + 0x9e3779b9 + (hash << 6) + (hash >> 2);
+        return hash;
+    }
+
+    bool SameVertexKey(const Vertex& a, const Vertex& b)
+    {
+        return a.position.x == b.position.x && a.position.y == b.position.y && a.position.z == b.position.z &&
+               a.normal.x == b.normal.x && a.normal.y == b.normal.y && a.normal.z == b.normal.z &&
+               a.texCoord.x == b.texCoord.x && a.texCoord.y == b.texCoord.y;
+    }
+
+    template<typename VertexType>
+    void CalculateNormalsImpl(std::vector<VertexType>& vertices, const std::vector<unsigned int>& indices)
+    {
+        if (vertices.empty() || indices.empty())
+            return;
+
+        // Reset all normals to zero
+        for (auto& vertex : vertices)
+        {
+            vertex.normal = XMFLOAT3(0.0f, 0.0f, 0.0f);
+        }
+
+        // Calculate face normals and accumulate
+        for (size_t i = 0; i + 2 < indices.size(); i += 3)
+        {
+            unsigned int i0 = indices[i];
+            unsigned int i1 = indices[i + 1];
+            unsigned int i2 = indices[i + 2];
+
+            if (i0 >= vertices.size() || i1 >= vertices.size() || i2 >= vertices.size())
+                continue;
+
+            XMVECTOR v0 = XMLoadFloat3(&vertices[i0].position);
+            XMVECTOR v1 = XMLoadFloat3(&vertices[i1].position);
+            XMVECTOR v2 = XMLoadFloat3(&vertices[i2].position);
+
+            XMVECTOR edge1 = XMVectorSubtract(v1, v0);
+            XMVECTOR edge2 = XMVectorSubtract(v2, v0);
+            XMVECTOR normal = XMVector3Normalize(XMVector3Cross(edge1, edge2));
+
+            XMFLOAT3 normalFloat;
+            XMStoreFloat3(&normalFloat, normal);
+
+            vertices[i0].normal.x += normalFloat.x;
+            vertices[i0].normal.y += normalFloat.y;
+            vertices[i0].normal.z += normalFloat.z;
+
+            vertices[i1].normal.x += normalFloat.x;
+            vertices[i1].normal.y += normalFloat.y;
+            vertices[i1].normal.z += normalFloat.z;
+
+            vertices[i2].normal.x += normalFloat.x;
+            vertices[i2].normal.y += normalFloat.y;
+            vertices[i2].normal.z += normalFloat.z;
+        }
+
+        // Normalize all normals
+        for (auto& vertex : vertices)
+        {
+            XMVECTOR normal = XMLoadFloat3(&vertex.normal);
+            normal = XMVector3Normalize(normal);
+            XMStoreFloat3(&vertex.normal, normal);
+        }
+    }
+
+    const unsigned int EMPTY_SLOT = 0xFFFFFFFFu;
+
+    template<typename VertexType>
+    void WeldVerticesImpl(std::vector<VertexType>& vertices, std::vector<unsigned int>& indices, LinearArena* scratch)
+    {
+        // Open-addressing table of welded vertex indices, at most half full.
+        // It lives in the scratch arena when one is given, so welding a mesh
+        // costs no per-vertex node allocations.
+        size_t capacity = 16;
+        while (capacity < vertices.size() * 2)
+        {
+            capacity <<= 1;
+        }
+        size_t mask = capacity - 1;
+        int shift = 0;
+        while ((static_cast<size_t>(1) << shift) < capacity)
+        {
+            shift++;
+        }
+
+        ArenaVector<unsigned int> table(capacity, EMPTY_SLOT, ArenaAllocator<unsigned int>(scratch));
+
+        std::vector<VertexType> weldedVertices;
+        weldedVertices.reserve(vertices.size());
+
+        // Indices are rewritten in place; dropped ones only make the write
+        // cursor fall behind the read cursor
+        size_t writeIndex = 0;
+        for (size_t readIndex = 0; readIndex < indices.size(); ++readIndex)
+        {
+            unsigned int index = indices[readIndex];
+            if (index >= vertices.size())
+                continue;
+
+            const VertexType& vertex = vertices[index];
+
+            // Fibonacci hashing spreads the combined hash over the table
+            uint64_t mixed = static_cast<uint64_t>(HashVertexKey(vertex)) * 0x9E3779B97F4A7C15ull;
+            size_t slot = shift > 0 ? static_cast<size_t>(mixed >> (64 - shift)) : 0;
+
+            while (true)
+            {
+                unsigned int weldedIndex = table[slot];
+                if (weldedIndex == EMPTY_SLOT)
+                {
+                    weldedIndex = static_cast<unsigned int>(weldedVertices.size());
+                    weldedVertices.push_back(vertex);
+                    table[slot] = weldedIndex;
+                    indices[writeIndex++] = weldedIndex;
+                    break;
+                }
+
+                if (SameVertexKey(weldedVertices[weldedIndex], vertex))
+                {
+                    indices[writeIndex++] = weldedIndex;
+                    break;
+                }
+
+                slot = (slot + 1) & mask;
+            }
+        }
+
+        indices.resize(writeIndex);
+        vertices = std::move(weldedVertices);
+    }
+}
+
+namespace MeshProcessing
+{
+    void CalculateNormals(std::vector<Vertex>& vertices, const std::vector<unsigned int>& indices)
+    {
+        PROFILE_FUNCTION();
+        CalculateNormalsImpl(vertices, indices);
+    }
+
+    void CalculateNormals(std::vector<SkinnedVertex>& vertices, const std::vector<unsigned int>& indices)
+    {
+        PROFILE_FUNCTION();
+        CalculateNormalsImpl(vertices, indices);
+    }
+
+    void WeldVertices(std::vector<Vertex>& vertices, std::vector<unsigned int>& indices, LinearArena* scratch)
+    {
+        PROFILE_FUNCTION();
+        WeldVerticesImpl(vertices, indices, scratch);
+    }
+
+    void WeldVertices(std::vector<SkinnedVertex>& vertices, std::vector<unsigned int>& indices, LinearArena* scratch)
+    {
+        PROFILE_FUNCTION();
+        WeldVerticesImpl(vertices, indices, scratch);
+    }
+}
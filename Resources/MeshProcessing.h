@@ -0,0 +1,23 @@
+#pragma once
+
+#include <vector>
+#include "Vertex.h"
+#include "../Engine/Memory.h"
+
+// CPU geometry processing shared by Mesh and ModelLoader. Works on plain
+// vertex/index arrays, so it has no dependency on the graphics device.
+namespace MeshProcessing
+{
+    // Smooth normals: unit face normals summed per vertex, then normalized.
+    // Triangles referencing out-of-range vertices are skipped.
+    void CalculateNormals(std::vector<Vertex>& vertices, const std::vector<unsigned int>& indices);
+    void CalculateNormals(std::vector<SkinnedVertex>& vertices, const std::vector<unsigned int>& indices);
+
+    // Merges vertices with identical position, normal and texture coordinate
+    // and re-indexes the triangles. Unreferenced vertices and out-of-range
+    // indices are dropped. Skinned vertices are keyed the same way, so bone
+    // data of merged vertices must already agree. The lookup table comes from
+    // scratch when given (the caller resets it), otherwise from the heap.
+    void WeldVertices(std::vector<Vertex>& vertices, std::vector<unsigned int>& indices, LinearArena* scratch = nullptr);
+    void WeldVertices(std::vector<SkinnedVertex>& vertices, std::vector<unsigned int>& indices, LinearArena* scratch = nullptr);
+}
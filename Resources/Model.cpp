@@ -2,8 +2,10 @@
 #include "Mesh.h"
 #include "Material.h"
 #include "../Graphics/ModelLoader.h"
+#include "../Graphics/FrustumCulling.h"
 #include <iostream>
 #include <algorithm>
+#include <unordered_set>
 
 // Animation implementation
 XMMATRIX Animation::GetBoneTransform(int boneIndex, float timeInSeconds) const
@@ -316,6 +318,51 @@ void Model::RenderWithMaterials(ID3D11DeviceContext* context, Shader* shader)
     }
 }
 
+int Model::RenderWithMaterials(ID3D11DeviceContext* context, Shader* shader, const Frustum& frustum)
+{
+    if (!context || !shader || !IsValid())
+    {
+        return 0;
+    }
+
+    // Reject the whole model first, then individual meshes
+    BoundingBox modelBounds = GetWorldBoundingBox();
+    if (!frustum.IntersectsBox(modelBounds.center, modelBounds.extents))
+    {
+        return 0;
+    }
+
+    int drawnMeshes = 0;
+    for (auto& mesh : m_meshes)
+    {
+        if (!mesh)
+            continue;
+
+        if (m_meshes.size() > 1)
+        {
+            BoundingBox meshBounds = mesh->GetBoundingBox().Transform(m_worldTransform);
+            if (!frustum.IntersectsBox(meshBounds.center, meshBounds.extents))
+                continue;
+        }
+
+        auto material = mesh->GetMaterial();
+        if (material)
+        {
+            material->Apply(context, shader);
+        }
+        else if (mesh->GetMaterialIndex() >= 0 &&
+                 mesh->GetMaterialIndex() < static_cast<int>(m_materials.size()))
+        {
+            m_materials[mesh->GetMaterialIndex()]->Apply(context, shader);
+        }
+
+        mesh->Render(context);
+        drawnMeshes++;
+    }
+
+    return drawnMeshes;
+}
+
 void Model::UpdateAnimation(float deltaTime)
 {
     if (!IsAnimated() || m_isAnimationPaused || m_currentAnimationIndex < 0 ||
@@ -525,6 +572,39 @@ const BoundingBox& Model::GetBoundingBox() const
     return m_boundingBox;
 }
 
+BoundingBox Model::GetWorldBoundingBox() const
+{
+    return GetBoundingBox().Transform(m_worldTransform);
+}
+
+size_t Model::GetCpuMemoryBytes() const
+{
+    size_t bytes = 0;
+    std::unordered_set<const Mesh*> counted;
+    for (const auto& mesh : m_meshes)
+    {
+        if (mesh && counted.insert(mesh.get()).second)
+        {
+            bytes += mesh->GetCpuMemoryBytes();
+        }
+    }
+    return bytes;
+}
+
+size_t Model::GetGpuMemoryBytes() const
+{
+    size_t bytes = 0;
+    std::unordered_set<const Mesh*> counted;
+    for (const auto& mesh : m_meshes)
+    {
+        if (mesh && counted.insert(mesh.get()).second)
+        {
+            bytes += mesh->GetGpuMemoryBytes();
+        }
+    }
+    return bytes;
+}
+
 void Model::AddMesh(std::shared_ptr<Mesh> mesh)
 {
     if (mesh)
@@ -5,6 +5,7 @@
 #include <string>
 #include <memory>
 #include <unordered_map>
+#include "../Graphics/D3D11Forward.h"
 
 using namespace DirectX;
 
@@ -12,6 +13,7 @@ using namespace DirectX;
 class Mesh;
 class Material;
 class Texture;
+struct Frustum;
 
 // Bone structure for skeletal animation
 struct Bone
@@ -117,6 +119,10 @@ public:
     void Render(ID3D11DeviceContext* context);
     void RenderWithMaterials(ID3D11DeviceContext* context, class Shader* shader);
 
+    // Skips meshes whose world-space bounds lie outside the frustum.
+    // Returns the number of meshes drawn.
+    int RenderWithMaterials(ID3D11DeviceContext* context, class Shader* shader, const Frustum& frustum);
+
     // Animation
     void UpdateAnimation(float deltaTime);
     void SetAnimation(const std::string& animationName);
@@ -144,6 +150,10 @@ public:
     int GetMaterialCount() const { return static_cast<int>(m_materials.size()); }
     int GetAnimationCount() const { return static_cast<int>(m_animations.size()); }
 
+    // Geometry footprint of the meshes (shared meshes counted once)
+    size_t GetCpuMemoryBytes() const;
+    size_t GetGpuMemoryBytes() const;
+
     bool IsAnimated() const { return !m_animations.empty() && m_skinInfo.IsValid(); }
     bool IsValid() const { return !m_meshes.empty(); }
 
@@ -157,6 +167,7 @@ public:
     // Bounding volume
     void CalculateBoundingBox();
     const BoundingBox& GetBoundingBox() const;
+    BoundingBox GetWorldBoundingBox() const;
 
     // Resource management
     void AddMesh(std::shared_ptr<Mesh> mesh);
@@ -1,4 +1,5 @@
 #include "Texture.h"
+#include "../Engine/Memory.h"
 #include <iostream>
 #include <fstream>
 #include <unordered_map>
@@ -17,6 +18,7 @@ Texture::Texture()
     , m_height(0)
     , m_format(TextureFormat::Unknown)
     , m_usage(TextureUsage::Default)
+    , m_gpuMemoryBytes(0)
     , m_isInitialized(false)
 {
 }
@@ -170,7 +172,10 @@ bool Texture::Create(ID3D11Device* device,
         return false;
     }
 
-    Shutdown(); // Clean up existing resources
+    // Clean up existing resources; the file path set by the loaders is kept
+    std::string filepath = m_filepath;
+    Shutdown();
+    m_filepath = filepath;
 
     m_width = width;
     m_height = height;
@@ -266,6 +271,25 @@ bool Texture::Create(ID3D11Device* device,
         }
     }
 
+    // Render targets and depth buffers are accounted apart from asset textures
+    bool isTarget = (textureDesc.BindFlags & (D3D11_BIND_RENDER_TARGET | D3D11_BIND_DEPTH_STENCIL)) != 0;
+    // Mip count from the created texture: a requested MipLevels of 0 means the full chain
+    D3D11_TEXTURE2D_DESC createdDesc;
+    m_texture->GetDesc(&createdDesc);
+    int mipLevels = static_cast<int>(createdDesc.MipLevels);
+    int blockBytes = (textureDesc.BindFlags & D3D11_BIND_DEPTH_STENCIL) ? 0 : GetBlockBytes(format);
+    if (blockBytes > 0)
+    {
+        m_gpuMemoryBytes = static_cast<size_t>(Memory::GetBlockCompressedTextureBytes(width, height, blockBytes, mipLevels));
+    }
+    else
+    {
+        int bitsPerPixel = (textureDesc.BindFlags & D3D11_BIND_DEPTH_STENCIL) ? 32 : GetBitsPerPixel(format);
+        m_gpuMemoryBytes = static_cast<size_t>(Memory::GetTextureBytes(width, height, bitsPerPixel, mipLevels));
+    }
+    Memory::TrackResource(isTarget ? MemoryCategory::RenderTargets : MemoryCategory::Textures, this,
+                          m_filepath.empty() ? "(unnamed texture)" : m_filepath, m_gpuMemoryBytes);
+
     m_isInitialized = true;
     return true;
 }
@@ -300,7 +324,11 @@ void Texture::Shutdown()
     m_height = 0;
     m_format = TextureFormat::Unknown;
     m_filepath.clear();
+    m_gpuMemoryBytes = 0;
     m_isInitialized = false;
+
+    Memory::UntrackResource(MemoryCategory::Textures, this);
+    Memory::UntrackResource(MemoryCategory::RenderTargets, this);
 }
 
 void Texture::GenerateMipmaps(ID3D11DeviceContext* context)
@@ -332,6 +360,30 @@ DXGI_FORMAT Texture::GetDXGIFormat(TextureFormat format)
     }
 }
 
+int Texture::GetBitsPerPixel(TextureFormat format)
+{
+    switch (format)
+    {
+    case TextureFormat::BC1_UNORM:          return 4;
+    case TextureFormat::BC3_UNORM:          return 8;
+    case TextureFormat::BC5_UNORM:          return 8;
+    case TextureFormat::R32G32B32A32_FLOAT: return 128;
+    case TextureFormat::R16G16B16A16_FLOAT: return 64;
+    default:                                return 32;
+    }
+}
+
+int Texture::GetBlockBytes(TextureFormat format)
+{
+    switch (format)
+    {
+    case TextureFormat::BC1_UNORM:          return 8;
+    case TextureFormat::BC3_UNORM:          return 16;
+    case TextureFormat::BC5_UNORM:          return 16;
+    default:                                return 0;
+    }
+}
+
 TextureFormat Texture::GetTextureFormat(DXGI_FORMAT dxgiFormat)
 {
     switch (dxgiFormat)
@@ -64,6 +64,9 @@ public:
     TextureFormat GetFormat() const { return m_format; }
     const std::string& GetFilePath() const { return m_filepath; }
 
+    // GPU footprint reported to MemoryCategory::Textures (or RenderTargets)
+    size_t GetGpuMemoryBytes() const { return m_gpuMemoryBytes; }
+
     bool IsValid() const { return m_texture != nullptr; }
     bool HasRenderTarget() const { return m_renderTargetView != nullptr; }
     bool HasDepthStencil() const { return m_depthStencilView != nullptr; }
@@ -74,6 +77,8 @@ public:
 
     // Static utility functions
     static DXGI_FORMAT GetDXGIFormat(TextureFormat format);
+    static int GetBitsPerPixel(TextureFormat format);
+    static int GetBlockBytes(TextureFormat format);     // 0 when not block-compressed
     static TextureFormat GetTextureFormat(DXGI_FORMAT dxgiFormat);
     static std::shared_ptr<Texture> CreateRenderTarget(ID3D11Device* device, int width, int height, TextureFormat format = TextureFormat::R8G8B8A8_UNORM);
     static std::shared_ptr<Texture> CreateDepthStencil(ID3D11Device* device, int width, int height);
@@ -98,6 +103,7 @@ private:
     TextureFormat m_format;
     TextureUsage m_usage;
     std::string m_filepath;
+    size_t m_gpuMemoryBytes;
 
     bool m_isInitialized;
 };
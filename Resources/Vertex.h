@@ -0,0 +1,81 @@
+#pragma once
+
+#include <DirectXMath.h>
+
+using namespace DirectX;
+
+// Vertex structure for standard mesh rendering
+struct Vertex
+{
+    XMFLOAT3 position;
+    XMFLOAT3 normal;
+    XMFLOAT2 texCoord;
+    XMFLOAT3 tangent;    // For normal mapping
+    XMFLOAT3 binormal;   // For normal mapping
+
+    Vertex()
+        : position(0.0f, 0.0f, 0.0f)
+        , normal(0.0f, 1.0f, 0.0f)
+        , texCoord(0.0f, 0.0f)
+        , tangent(1.0f, 0.0f, 0.0f)
+        , binormal(0.0f, 0.0f, 1.0f)
+    {
+    }
+
+    Vertex(const XMFLOAT3& pos, const XMFLOAT3& norm, const XMFLOAT2& tex)
+        : position(pos)
+        , normal(norm)
+        , texCoord(tex)
+        , tangent(1.0f, 0.0f, 0.0f)
+        , binormal(0.0f, 0.0f, 1.0f)
+    {
+    }
+};
+
+// Vertex structure for skinned mesh rendering (with bone weights)
+struct SkinnedVertex : public Vertex
+{
+    static const int MAX_BONE_INFLUENCES = 4;
+
+    int boneIndices[MAX_BONE_INFLUENCES];
+    float boneWeights[MAX_BONE_INFLUENCES];
+
+    SkinnedVertex() : Vertex()
+    {
+        for (int i = 0; i < MAX_BONE_INFLUENCES; ++i)
+        {
+            boneIndices[i] = 0;
+            boneWeights[i] = 0.0f;
+        }
+    }
+
+    void AddBoneInfluence(int boneIndex, float weight)
+    {
+        for (int i = 0; i < MAX_BONE_INFLUENCES; ++i)
+        {
+            if (boneWeights[i] == 0.0f)
+            {
+                boneIndices[i] = boneIndex;
+                boneWeights[i] = weight;
+                break;
+            }
+        }
+    }
+
+    void NormalizeBoneWeights()
+    {
+        float totalWeight = 0.0f;
+        for (int i = 0; i < MAX_BONE_INFLUENCES; ++i)
+        {
+            totalWeight += boneWeights[i];
+        }
+
+        if (totalWeight > 0.0f)
+        {
+            for (int i = 0; i < MAX_BONE_INFLUENCES; ++i)
+            {
+                boneWeights[i] /= totalWeight;
+            }
+        }
+    }
+};
@@ -0,0 +1,271 @@
+#include "Test.h"
+#include "../Graphics/BoundingVolumeHierarchy.h"
+#include "../Graphics/FrustumCulling.h"
+#include <algorithm>
+#include <cmath>
+
+// BVH queries against a linear scan of the same boxes, after a build and
+// after moving, adding and destroying proxies and refitting
+
+namespace
+{
+    const int BOX_COUNT = 3000;
+    const float WORLD_HALF_SIZE = 200.0f;
+    const float RAY_LENGTH = 1000.0f;
+
+    // Small xorshift generator, so the scene is the same on every platform
+    class Random
+    {
+    public:
+        explicit Random(uint32_t seed) : m_state(seed) {}
+
+        float NextFloat(float minValue, float maxValue)
+        {
+            m_state ^= m_state << 13;
+            m_state ^= m_state >> 17;
+            m_state ^= m_state << 5;
+            return minValue + (maxValue - minValue) * static_cast<float>(m_state >> 8) / 16777216.0f;
+        }
+
+    private:
+        uint32_t m_state;
+    };
+
+    // The boxes the tree was given, mirrored by proxy id; destroyed ones are not alive
+    struct Scene
+    {
+        BoundingVolumeHierarchy bvh;
+        std::vector<XMFLOAT3> mins;
+        std::vector<XMFLOAT3> maxs;
+        std::vector<bool> alive;
+        Random random;
+
+        Scene() : random(54) {}
+
+        void RandomBox(XMFLOAT3& min, XMFLOAT3& max)
+        {
+            XMFLOAT3 center(random.NextFloat(-WORLD_HALF_SIZE, WORLD_HALF_SIZE),
+                            random.NextFloat(-WORLD_HALF_SIZE, WORLD_HALF_SIZE),
+                            random.NextFloat(-WORLD_HALF_SIZE, WORLD_HALF_SIZE));
+            XMFLOAT3 extents(random.NextFloat(0.5f, 4.0f), random.NextFloat(0.5f, 4.0f), random.NextFloat(0.5f, 4.0f));
+            min = XMFLOAT3(center.x - extents.x, center.y - extents.y, center.z - extents.z);
+            max = XMFLOAT3(center.x + extents.x, center.y + extents.y, center.z + extents.z);
+        }
+
+        void Add()
+        {
+            XMFLOAT3 min;
+            XMFLOAT3 max;
+            RandomBox(min, max);
+            size_t id = static_cast<size_t>(bvh.CreateProxy(min, max, nullptr));
+            if (id >= mins.size())
+            {
+                mins.resize(id + 1);
+                maxs.resize(id + 1);
+                alive.resize(id + 1, false);
+            }
+            mins[id] = min;
+            maxs[id] = max;
+            alive[id] = true;
+        }
+
+        void Move(int id)
+        {
+            RandomBox(mins[id], maxs[id]);
+            bvh.UpdateProxy(id, mins[id], maxs[id]);
+        }
+
+        void Destroy(int id)
+        {
+            bvh.DestroyProxy(id);
+            alive[id] = false;
+        }
+    };
+
+    std::vector<int> ScanFrustum(const Scene& scene, const Frustum& frustum)
+    {
+        std::vector<int> results;
+        for (size_t i = 0; i < scene.mins.size(); ++i)
+        {
+            if (!scene.alive[i])
+                continue;
+
+            const XMFLOAT3& min = scene.mins[i];
+            const XMFLOAT3& max = scene.maxs[i];
+            XMFLOAT3 center((min.x + max.x) * 0.5f, (min.y + max.y) * 0.5f, (min.z + max.z) * 0.5f);
+            XMFLOAT3 extents((max.x - min.x) * 0.5f, (max.y - min.y) * 0.5f, (max.z - min.z) * 0.5f);
+            if (frustum.IntersectsBox(center, extents))
+            {
+                results.push_back(static_cast<int>(i));
+            }
+        }
+        return results;
+    }
+
+    std::vector<int> ScanOverlap(const Scene& scene, const XMFLOAT3& min, const XMFLOAT3& max)
+    {
+        std::vector<int> results;
+        for (size_t i = 0; i < scene.mins.size(); ++i)
+        {
+            const XMFLOAT3& a = scene.mins[i];
+            const XMFLOAT3& b = scene.maxs[i];
+            if (scene.alive[i] &&
+                a.x <= max.x && b.x >= min.x && a.y <= max.y && b.y >= min.y && a.z <= max.z && b.z >= min.z)
+            {
+                results.push_back(static_cast<int>(i));
+            }
+        }
+        return results;
+    }
+
+    // Entry distance of the ray into the box, or -1 on a miss
+    float RayEntry(const XMFLOAT3& origin, const XMFLOAT3& direction, const XMFLOAT3& min, const XMFLOAT3& max)
+    {
+        const float o[3] = { origin.x, origin.y, origin.z };
+        const float d[3] = { direction.x, direction.y, direction.z };
+        const float lo[3] = { min.x, min.y, min.z };
+        const float hi[3] = { max.x, max.y, max.z };
+
+        float tMin = 0.0f;
+        float tMax = RAY_LENGTH;
+        for (int axis = 0; axis < 3; ++axis)
+        {
+            if (d[axis] == 0.0f)
+            {
+                if (o[axis] < lo[axis] || o[axis] > hi[axis])
+                    return -1.0f;
+                continue;
+            }
+            float t1 = (lo[axis] - o[axis]) / d[axis];
+            float t2 = (hi[axis] - o[axis]) / d[axis];
+            tMin = std::max(tMin, std::min(t1, t2));
+            tMax = std::min(tMax, std::max(t1, t2));
+        }
+        return tMax >= tMin ? tMin : -1.0f;
+    }
+
+    std::vector<int> Sorted(std::vector<int> ids)
+    {
+        std::sort(ids.begin(), ids.end());
+        return ids;
+    }
+
+    void CheckQueries(TestContext& context, Scene& scene, const char* stage)
+    {
+        // A frustum per axis direction from the center, and one from outside the world
+        const XMVECTOR eyes[] = { XMVectorZero(), XMVectorZero(), XMVectorZero(), XMVectorSet(0.0f, 50.0f, -400.0f, 1.0f) };
+        const XMVECTOR targets[] = { XMVectorSet(0.0f, 0.0f, 1.0f, 1.0f), XMVectorSet(1.0f, 0.2f, 0.0f, 1.0f),
+                                     XMVectorSet(-0.3f, -1.0f, 0.1f, 1.0f), XMVectorZero() };
+        XMMATRIX projection = XMMatrixPerspectiveFovLH(XM_PIDIV4, 16.0f / 9.0f, 0.1f, 300.0f);
+        for (int i = 0; i < 4; ++i)
+        {
+            XMMATRIX view = XMMatrixLookAtLH(eyes[i], targets[i], XMVectorSet(0.0f, 1.0f, 0.0f, 0.0f));
+            Frustum frustum = Frustum::FromViewProjection(XMMatrixMultiply(view, projection));
+
+            std::vector<int> found;
+            scene.bvh.QueryFrustum(frustum, found);
+            std::vector<int> expected = ScanFrustum(scene, frustum);
+            TEST_CHECK(context, !expected.empty());
+            if (Sorted(found) != expected)
+            {
+                context.Fail(std::string(stage) + ": QueryFrustum differs from the linear scan", __FILE__, __LINE__);
+            }
+        }
+
+        for (int i = 0; i < 50; ++i)
+        {
+            float size = scene.random.NextFloat(2.0f, 60.0f);
+            XMFLOAT3 min(scene.random.NextFloat(-WORLD_HALF_SIZE, WORLD_HALF_SIZE),
+                         scene.random.NextFloat(-WORLD_HALF_SIZE, WORLD_HALF_SIZE),
+                         scene.random.NextFloat(-WORLD_HALF_SIZE, WORLD_HALF_SIZE));
+            XMFLOAT3 max(min.x + size, min.y + size, min.z + size);
+
+            std::vector<int> found;
+            scene.bvh.QueryOverlap(min, max, found);
+            if (Sorted(found) != ScanOverlap(scene, min, max))
+            {
+                context.Fail(std::string(stage) + ": QueryOverlap differs from the linear scan", __FILE__, __LINE__);
+            }
+        }
+
+        int hits = 0;
+        for (int i = 0; i < 200; ++i)
+        {
+            XMFLOAT3 origin(scene.random.NextFloat(-WORLD_HALF_SIZE, WORLD_HALF_SIZE),
+                            scene.random.NextFloat(-WORLD_HALF_SIZE, WORLD_HALF_SIZE),
+                            scene.random.NextFloat(-WORLD_HALF_SIZE, WORLD_HALF_SIZE));
+            XMFLOAT3 direction;
+            XMStoreFloat3(&direction, XMVector3Normalize(XMVectorSet(scene.random.NextFloat(-1.0f, 1.0f),
+                                                                     scene.random.NextFloat(-1.0f, 1.0f),
+                                                                     scene.random.NextFloat(-1.0f, 1.0f), 0.0f)));
+            // Axis-aligned rays exercise the infinite inverse direction
+            if (i % 10 == 0)
+            {
+                direction = XMFLOAT3(0.0f, 0.0f, 1.0f);
+            }
+
+            float nearest = -1.0f;
+            for (size_t id = 0; id < scene.mins.size(); ++id)
+            {
+                float t = scene.alive[id] ? RayEntry(origin, direction, scene.mins[id], scene.maxs[id]) : -1.0f;
+                if (t >= 0.0f && (nearest < 0.0f || t < nearest))
+                {
+                    nearest = t;
+                }
+            }
+
+            BVHRayHit hit;
+            bool found = scene.bvh.RayCast(origin, direction, RAY_LENGTH, hit);
+            if (found != (nearest >= 0.0f))
+            {
+                context.Fail(std::string(stage) + ": RayCast hit differs from the linear scan", __FILE__, __LINE__);
+                continue;
+            }
+            if (found)
+            {
+                hits++;
+                TEST_CHECK(context, scene.alive[hit.proxyId]);
+                TEST_CHECK_NEAR(context, hit.distance, nearest, 1e-3f * std::max(1.0f, nearest));
+            }
+        }
+        TEST_CHECK(context, hits > 0);
+    }
+
+    TestRegistration s_queriesMatchLinearScan("BVH/QueriesMatchLinearScan", [](TestContext& context)
+    {
+        Scene scene;
+        for (int i = 0; i < BOX_COUNT; ++i)
+        {
+            scene.Add();
+        }
+        scene.bvh.Build();
+        TEST_CHECK_EQUAL(context, scene.bvh.GetProxyCount(), BOX_COUNT);
+        CheckQueries(context, scene, "after Build");
+
+        // Move a tenth of the boxes anywhere, add a few pending proxies and
+        // destroy some: the refit tree plus the pending list must still
+        // match, whether or not Refit decides to rebuild
+        for (int i = 0; i < BOX_COUNT; i += 10)
+        {
+            scene.Move(i);
+        }
+        for (int i = 0; i < 40; ++i)
+        {
+            scene.Add();
+        }
+        for (int i = 5; i < BOX_COUNT; i += 97)
+        {
+            scene.Destroy(i);
+        }
+        scene.bvh.Refit();
+        CheckQueries(context, scene, "after Refit");
+
+        // Pending proxies past the rebuild threshold
+        for (int i = 0; i < BOX_COUNT / 5; ++i)
+        {
+            scene.Add();
+        }
+        scene.bvh.Refit();
+        CheckQueries(context, scene, "after rebuilding Refit");
+    });
+}
@@ -0,0 +1,199 @@
+#include "Test.h"
+#include "../Engine/FramePacer.h"
+#include <cmath>
+#include <memory>
+
+// FramePacer on SimulatedPacingClock: time only moves through the frame work
+// the test advances and the pacer's own sleeps and spins, so every frame
+// start is reproducible
+
+namespace
+{
+    // Spin step of the simulated clock; a frame that reaches its deadline
+    // by spinning starts less than this late
+    const double SPIN_STEP = 0.000002;
+
+    struct PacedRun
+    {
+        std::shared_ptr<SimulatedPacingClock> clock;
+        FramePacer pacer;
+
+        explicit PacedRun(double targetFrameTime, double sleepOvershoot = 0.0015)
+            : clock(std::make_shared<SimulatedPacingClock>())
+            , pacer(clock)
+        {
+            clock->SetSleepOvershoot(sleepOvershoot);
+            clock->SetSpinStep(SPIN_STEP);
+            pacer.SetTargetFrameTime(targetFrameTime);
+            pacer.Reset();
+        }
+
+        // Does workSeconds of frame work, waits, returns the frame start
+        double Frame(double workSeconds)
+        {
+            clock->Advance(workSeconds);
+            pacer.WaitForNextFrame();
+            return clock->Now();
+        }
+    };
+
+    // Work between 1 and 12 ms, varying frame to frame
+    double GetJitteredWork(int frame)
+    {
+        uint32_t hash = static_cast<uint32_t>(frame) * 2654435761u;
+        return 0.001 + 0.011 * ((hash >> 8) % 1000) / 1000.0;
+    }
+
+    // Refresh periods a vsync'd swap chain would present at, and rates that
+    // only a frame limiter gives
+    TestRegistration s_hitsTargets("FramePacer/HitsTargetPeriods", [](TestContext& context)
+    {
+        struct Target { double hz; double work; };
+        const Target targets[] =
+        {
+            { 60.0, 0.005 }, { 120.0, 0.003 }, { 144.0, 0.002 },    // Refresh rates
+            { 75.0, 0.008 }, { 90.5, 0.004 }, { 240.0, 0.002 },     // Limiter
+            { 500.0, 0.001 }
+        };
+
+        for (const Target& target : targets)
+        {
+            double period = 1.0 / target.hz;
+            PacedRun run(period);
+            double start = run.clock->Now();
+
+            // The first sleep has no overshoot estimate yet: it wakes 1.5 ms
+            // late into a 0.5 ms spin window
+            double previous = run.Frame(target.work);
+            TEST_CHECK_NEAR(context, previous - (start + period), 0.001, 1e-9);
+
+            double worstError = 0.0;
+            double worstInterval = 0.0;
+            for (int frame = 2; frame <= 600; ++frame)
+            {
+                double frameStart = run.Frame(target.work);
+                worstError = std::max(worstError, std::fabs(frameStart - (start + frame * period)));
+                if (frame > 2)
+                {
+                    worstInterval = std::max(worstInterval, std::fabs(frameStart - previous - period));
+                }
+                previous = frameStart;
+            }
+
+            const FramePacingStats& stats = run.pacer.GetStats();
+            TEST_CHECK_EQUAL(context, stats.frameCount, 600u);
+            TEST_CHECK_EQUAL(context, stats.missedFrames, 0u);
+            TEST_CHECK(context, worstError < SPIN_STEP + 1e-9);
+            TEST_CHECK(context, worstInterval < SPIN_STEP + 1e-9);
+            TEST_CHECK_NEAR(context, stats.lastErrorUs, 0.0, SPIN_STEP * 1e6);
+        }
+    });
+
+    // Sleeping covers most of the wait; the spin only covers the window the
+    // sleep may overshoot into
+    TestRegistration s_sleepsThenSpins("FramePacer/SleepsThenSpins", [](TestContext& context)
+    {
+        PacedRun run(1.0 / 60.0);
+        for (int frame = 0; frame < 100; ++frame)
+        {
+            run.Frame(0.004);
+        }
+
+        TEST_CHECK_EQUAL(context, run.clock->GetSleepCount(), 100);
+        TEST_CHECK_NEAR(context, run.pacer.GetStats().maxSleepOvershootUs, 1500.0, 1e-3);
+
+        // Each frame spins through at most the overshoot window
+        double spinsPerFrame = static_cast<double>(run.clock->GetSpinCount()) / 100.0;
+        TEST_CHECK(context, spinsPerFrame * SPIN_STEP <= 0.0015 + SPIN_STEP);
+    });
+
+    // A frame that overruns by more than a period restarts the deadline
+    // sequence from the late frame instead of rushing to catch up
+    TestRegistration s_missedDeadline("FramePacer/MissedDeadlineRestartsSequence", [](TestContext& context)
+    {
+        double period = 1.0 / 60.0;
+        PacedRun run(period);
+        for (int frame = 0; frame < 10; ++frame)
+        {
+            run.Frame(0.005);
+        }
+
+        double lateStart = run.Frame(0.040);
+        TEST_CHECK_EQUAL(context, run.pacer.GetStats().missedFrames, 1u);
+
+        // The following frames keep a whole period apart, phased from the late one
+        double previous = lateStart;
+        double worstInterval = 0.0;
+        for (int frame = 0; frame < 20; ++frame)
+        {
+            double frameStart = run.Frame(0.005);
+            worstInterval = std::max(worstInterval, std::fabs(frameStart - previous - period));
+            previous = frameStart;
+        }
+        TEST_CHECK(context, worstInterval < SPIN_STEP + 1e-9);
+        TEST_CHECK_EQUAL(context, run.pacer.GetStats().missedFrames, 1u);
+    });
+
+    // A frame late by less than a period keeps the original phase: the next
+    // one starts on its own deadline, so the two average out to the target
+    TestRegistration s_lateFrameKeepsPhase("FramePacer/LateFrameKeepsPhase", [](TestContext& context)
+    {
+        double period = 1.0 / 60.0;
+        PacedRun run(period);
+        double start = run.clock->Now();
+        for (int frame = 1; frame <= 10; ++frame)
+        {
+            run.Frame(0.005);
+        }
+
+        double lateStart = run.Frame(0.020);
+        TEST_CHECK_NEAR(context, lateStart - (start + 11 * period), 0.020 - period, 1e-9);
+        TEST_CHECK_EQUAL(context, run.pacer.GetStats().missedFrames, 0u);
+
+        double nextStart = run.Frame(0.005);
+        TEST_CHECK(context, std::fabs(nextStart - (start + 12 * period)) < SPIN_STEP + 1e-9);
+    });
+
+    // Absolute deadlines: thousands of frames of varying work do not
+    // accumulate error, and a scheduler that starts overshooting more is
+    // absorbed once the estimate has seen it
+    TestRegistration s_driftRecovery("FramePacer/DriftRecovery", [](TestContext& context)
+    {
+        double period = 1.0 / 60.0;
+        PacedRun run(period, 0.0005);
+        double start = run.clock->Now();
+
+        double frameStart = start;
+        for (int frame = 1; frame <= 10000; ++frame)
+        {
+            frameStart = run.Frame(GetJitteredWork(frame));
+        }
+        TEST_CHECK(context, std::fabs(frameStart - (start + 10000 * period)) < SPIN_STEP + 1e-7);
+        TEST_CHECK_EQUAL(context, run.pacer.GetStats().missedFrames, 0u);
+
+        // Sleeps now wake 3 ms late: the first frame after the change is late
+        // by the part of the overshoot the spin window did not cover
+        run.clock->SetSleepOvershoot(0.003);
+        double firstError = run.Frame(0.005) - (start + 10001 * period);
+        TEST_CHECK(context, firstError > 0.002);
+
+        // From the next frame on the spin window covers it again
+        double worstError = 0.0;
+        for (int frame = 10002; frame <= 10100; ++frame)
+        {
+            worstError = std::max(worstError, std::fabs(run.Frame(0.005) - (start + frame * period)));
+        }
+        TEST_CHECK(context, worstError < SPIN_STEP + 1e-7);
+        TEST_CHECK_EQUAL(context, run.pacer.GetStats().missedFrames, 0u);
+    });
+
+    TestRegistration s_disabledDoesNotWait("FramePacer/DisabledDoesNotWait", [](TestContext& context)
+    {
+        PacedRun run(0.0);
+        double start = run.clock->Now();
+        run.Frame(0.005);
+        TEST_CHECK_NEAR(context, run.clock->Now() - start, 0.005, 1e-12);
+        TEST_CHECK_EQUAL(context, run.clock->GetSleepCount(), 0);
+        TEST_CHECK_EQUAL(context, run.pacer.GetStats().frameCount, 0u);
+    });
+}
@@ -0,0 +1,62 @@
+#include "Test.h"
+#include "../Engine/GameLoop.h"
+#include <atomic>
+#include <chrono>
+#include <thread>
+
+// Threaded mode: the update thread keeps its fixed rate while the render
+// callback is slow
+
+namespace
+{
+    TestRegistration s_threadedSlowRender("GameLoop/ThreadedUpdatesKeepRateWithSlowRender", [](TestContext& context)
+    {
+        const int updatesPerSecond = 100;
+        const auto renderTime = std::chrono::milliseconds(50);    // Five update steps per frame
+        const auto runTime = std::chrono::milliseconds(600);
+
+        GameLoop loop;
+        loop.SetMode(GameLoopMode::Threaded);
+        loop.SetTargetUPS(updatesPerSecond);
+        loop.SetTargetFPS(0);
+
+        std::atomic<uint64_t> updates(0);
+        loop.SetUpdateFunction([&](float deltaTime)
+        {
+            (void)deltaTime;
+            updates++;
+        });
+
+        // Updates that land while a frame is being drawn
+        uint64_t updatesDuringRender = 0;
+        int frames = 0;
+        auto start = std::chrono::steady_clock::now();
+        loop.SetRenderFunction([&](float interpolation)
+        {
+            (void)interpolation;
+            uint64_t before = updates.load();
+            std::this_thread::sleep_for(renderTime);
+            updatesDuringRender += updates.load() - before;
+            frames++;
+
+            if (std::chrono::steady_clock::now() - start >= runTime)
+            {
+                loop.Stop();
+            }
+        });
+
+        loop.Run();
+        double elapsed = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+        // The update thread follows its own schedule: one tick per step
+        // since Start, never more, and the slow frames do not hold it back
+        double scheduledTicks = elapsed * updatesPerSecond;
+        TEST_CHECK(context, static_cast<double>(updates.load()) <= scheduledTicks + 1.0);
+        TEST_CHECK(context, static_cast<double>(updates.load()) >= scheduledTicks * 0.8);
+        TEST_CHECK_EQUAL(context, loop.GetTotalUpdates(), updates.load());
+
+        // Frames ran at the render rate, far below the update rate
+        TEST_CHECK(context, frames <= static_cast<int>(elapsed / 0.05) + 1);
+        TEST_CHECK(context, updatesDuringRender >= updates.load() * 8 / 10);
+    });
+}
@@ -0,0 +1,194 @@
+#include "Test.h"
+#include "../Engine/GameLoop.h"
+#include "../Engine/InputReplay.h"
+#include <filesystem>
+#include <cstdio>
+
+// Record/replay through GameLoop::RunFixedSteps: the ticks of a replay see
+// the recorded input and reproduce the recorded state checksums
+
+namespace
+{
+    const uint64_t TICK_COUNT = 300;
+
+    std::string GetLogPath(const char* name)
+    {
+        return (std::filesystem::temp_directory_path() / name).string();
+    }
+
+    // Deterministic input for a tick: held keys that change every few ticks,
+    // mouse movement while the right button is down and an occasional notch
+    void GenerateInput(uint64_t tick, InputFrame& input)
+    {
+        input.SetKey('W', (tick / 20) % 2 == 0);
+        input.SetKey('D', (tick / 45) % 3 == 1);
+        input.SetMouseButton(1, (tick / 30) % 2 == 1);
+        input.mouseCaptured = input.IsMouseButtonDown(1);
+        input.mouseDeltaX = input.mouseCaptured ? static_cast<int32_t>(tick % 7) - 3 : 0;
+        input.mouseDeltaY = input.mouseCaptured ? static_cast<int32_t>(tick % 5) - 2 : 0;
+        input.wheelDelta = (tick % 50 == 49) ? 120 : 0;
+    }
+
+    // Stand-in for the engine's simulation: reads input only through the
+    // frame it is given and integrates with the fixed step
+    struct Simulation
+    {
+        uint64_t tick = 0;
+        float position[2] = { 0.0f, 0.0f };
+        float yaw = 0.0f;
+        float zoom = 5.0f;
+
+        void Update(const InputFrame& input, float deltaTime)
+        {
+            if (input.IsKeyDown('W'))
+            {
+                position[1] += 3.0f * deltaTime;
+            }
+            if (input.IsKeyDown('D'))
+            {
+                position[0] += 2.0f * deltaTime;
+            }
+            yaw += input.mouseDeltaX * 0.01f;
+            zoom -= input.wheelDelta / 120.0f * 0.5f;
+            tick++;
+        }
+
+        uint64_t GetChecksum() const
+        {
+            StateChecksum checksum;
+            checksum.Add(tick);
+            checksum.Add(position[0]);
+            checksum.Add(position[1]);
+            checksum.Add(yaw);
+            checksum.Add(zoom);
+            return checksum.GetValue();
+        }
+    };
+
+    // Runs TICK_COUNT live ticks at updatesPerSecond and records them
+    bool Record(const std::string& path, int updatesPerSecond, Simulation& simulation)
+    {
+        InputRecorder recorder;
+        GameLoop loop;
+        loop.SetTargetUPS(updatesPerSecond);
+        if (!recorder.Open(path, loop.GetFixedDeltaTime()))
+        {
+            return false;
+        }
+
+        InputFrame input;
+        loop.SetUpdateFunction([&](float deltaTime)
+        {
+            GenerateInput(simulation.tick, input);
+            simulation.Update(input, deltaTime);
+            recorder.RecordTick(input, simulation.GetChecksum());
+        });
+
+        uint64_t ticks = loop.RunFixedSteps(TICK_COUNT);
+        recorder.Close();
+        return ticks == TICK_COUNT;
+    }
+
+    // Replays a log at the update rate it was recorded with. divergeAtTick
+    // nudges the state once, the way a nondeterministic system would.
+    uint64_t Replay(InputReplayer& replayer, Simulation& simulation, uint64_t divergeAtTick = UINT64_MAX)
+    {
+        GameLoop loop;
+        loop.SetTargetUPS(replayer.GetUpdatesPerSecond());
+
+        InputFrame input;
+        loop.SetUpdateFunction([&](float deltaTime)
+        {
+            if (!replayer.NextTick(input))
+            {
+                loop.Stop();
+                return;
+            }
+
+            simulation.Update(input, deltaTime);
+            if (simulation.tick - 1 == divergeAtTick)
+            {
+                simulation.yaw += 0.001f;
+            }
+            replayer.VerifyTick(simulation.GetChecksum());
+        });
+
+        return loop.RunFixedSteps(TICK_COUNT);
+    }
+
+    TestRegistration s_replayMatchesRecording("InputReplay/ReplayMatchesRecording", [](TestContext& context)
+    {
+        std::string path = GetLogPath("engine_tests_replay_match.einp");
+
+        Simulation recorded;
+        TEST_CHECK(context, Record(path, 50, recorded));
+
+        InputReplayer replayer;
+        TEST_CHECK(context, replayer.Open(path));
+        TEST_CHECK_EQUAL(context, replayer.GetUpdatesPerSecond(), 50);
+
+        Simulation replayed;
+        TEST_CHECK_EQUAL(context, Replay(replayer, replayed), TICK_COUNT);
+        TEST_CHECK(context, replayer.IsFinished());
+        TEST_CHECK_EQUAL(context, replayer.GetTickCount(), TICK_COUNT);
+        TEST_CHECK_EQUAL(context, replayer.GetMismatchCount(), 0u);
+        TEST_CHECK_EQUAL(context, replayed.GetChecksum(), recorded.GetChecksum());
+
+        std::remove(path.c_str());
+    });
+
+    TestRegistration s_replayReportsDivergence("InputReplay/ReplayReportsDivergence", [](TestContext& context)
+    {
+        std::string path = GetLogPath("engine_tests_replay_diverge.einp");
+
+        Simulation recorded;
+        TEST_CHECK(context, Record(path, 60, recorded));
+
+        InputReplayer replayer;
+        TEST_CHECK(context, replayer.Open(path));
+
+        // Every tick from the nudge on carries the difference
+        Simulation replayed;
+        Replay(replayer, replayed, 120);
+        TEST_CHECK_EQUAL(context, replayer.GetFirstMismatchTick(), 120);
+        TEST_CHECK_EQUAL(context, replayer.GetMismatchCount(), TICK_COUNT - 120);
+
+        std::remove(path.c_str());
+    });
+
+    TestRegistration s_fixedStepMapsToUpdateRate("InputReplay/FixedStepMapsToUpdateRate", [](TestContext& context)
+    {
+        std::string path = GetLogPath("engine_tests_replay_step.einp");
+
+        // The step GameLoop uses for each rate comes back as that rate
+        const int rates[] = { 1, 24, 30, 50, 60, 90, 120, 144, 240, 1000 };
+        for (int rate : rates)
+        {
+            GameLoop loop;
+            loop.SetTargetUPS(rate);
+
+            InputRecorder recorder;
+            TEST_CHECK(context, recorder.Open(path, loop.GetFixedDeltaTime()));
+            recorder.Close();
+
+            InputReplayer replayer;
+            TEST_CHECK(context, replayer.Open(path));
+            TEST_CHECK_EQUAL(context, replayer.GetUpdatesPerSecond(), rate);
+        }
+
+        // Steps no whole rate gives are rejected
+        const float oddSteps[] = { 0.0123f, 1.0f / 60.0f + 1e-6f, 0.0f, -0.016f };
+        for (float step : oddSteps)
+        {
+            InputRecorder recorder;
+            TEST_CHECK(context, recorder.Open(path, step));
+            recorder.Close();
+
+            InputReplayer replayer;
+            TEST_CHECK(context, replayer.Open(path));
+            TEST_CHECK_EQUAL(context, replayer.GetUpdatesPerSecond(), 0);
+        }
+
+        std::remove(path.c_str());
+    });
+}
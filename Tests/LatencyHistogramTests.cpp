@@ -0,0 +1,147 @@
+#include "Test.h"
+#include "../Engine/LatencyHistogram.h"
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <filesystem>
+#include <fstream>
+#include <random>
+
+// Bucket mapping accuracy, percentiles against a sorted reference and the
+// report export
+
+namespace
+{
+    const uint64_t LINEAR_RANGE_US = 128;
+    const uint64_t MAX_VALUE_US = (1ull << 32) - 1;
+
+    uint64_t ToMicroseconds(double milliseconds)
+    {
+        return static_cast<uint64_t>(std::llround(milliseconds * 1000.0));
+    }
+
+    TestRegistration s_exactBelowLinearRange("LatencyHistogram/ExactBelowLinearRange", [](TestContext& context)
+    {
+        LatencyHistogram histogram;
+        for (uint64_t value = 0; value < LINEAR_RANGE_US; ++value)
+        {
+            int bucket = LatencyHistogram::GetBucketIndex(value);
+            TEST_CHECK_EQUAL(context, bucket, static_cast<int>(value));
+            TEST_CHECK_EQUAL(context, LatencyHistogram::GetBucketLowestValue(bucket), value);
+            TEST_CHECK_EQUAL(context, LatencyHistogram::GetBucketHighestValue(bucket), value);
+
+            if (value > 0)
+            {
+                histogram.Record(value / 1000.0);
+            }
+        }
+
+        // One sample per microsecond: every rank reports its own value
+        uint64_t count = histogram.GetCount();
+        for (uint64_t rank = 1; rank <= count; ++rank)
+        {
+            double percentile = (rank - 0.5) * 100.0 / count;
+            TEST_CHECK_EQUAL(context, ToMicroseconds(histogram.GetPercentile(percentile)), rank);
+        }
+        TEST_CHECK_EQUAL(context, ToMicroseconds(histogram.GetMin()), 1u);
+        TEST_CHECK_EQUAL(context, ToMicroseconds(histogram.GetMax()), LINEAR_RANGE_US - 1);
+    });
+
+    TestRegistration s_relativeErrorInLogBuckets("LatencyHistogram/RelativeErrorInLogBuckets", [](TestContext& context)
+    {
+        // Buckets tile the value range without gaps or overlaps
+        int lastBucket = LatencyHistogram::GetBucketIndex(MAX_VALUE_US);
+        TEST_CHECK_EQUAL(context, LatencyHistogram::GetBucketHighestValue(lastBucket), MAX_VALUE_US);
+        int gaps = 0;
+        for (int bucket = 0; bucket < lastBucket; ++bucket)
+        {
+            if (LatencyHistogram::GetBucketLowestValue(bucket + 1) != LatencyHistogram::GetBucketHighestValue(bucket) + 1)
+            {
+                gaps++;
+            }
+        }
+        TEST_CHECK_EQUAL(context, gaps, 0);
+
+        // Every value from the end of the linear range, then a sweep up to
+        // the clamp, lands in a bucket whose top is within 1/64 above it
+        std::vector<uint64_t> values;
+        for (uint64_t value = LINEAR_RANGE_US; value < 65536; ++value)
+        {
+            values.push_back(value);
+        }
+        std::mt19937 random(42);
+        for (int i = 0; i < 100000; ++i)
+        {
+            // Random value with its highest bit at 16..31
+            int bits = 17 + static_cast<int>(random() % 16);
+            values.push_back((random() >> (32 - bits)) | (1ull << (bits - 1)));
+        }
+
+        double worstError = 0.0;
+        int outside = 0;
+        for (uint64_t value : values)
+        {
+            int bucket = LatencyHistogram::GetBucketIndex(value);
+            uint64_t lowest = LatencyHistogram::GetBucketLowestValue(bucket);
+            uint64_t highest = LatencyHistogram::GetBucketHighestValue(bucket);
+            if (value < lowest || value > highest)
+            {
+                outside++;
+            }
+            worstError = std::max(worstError, static_cast<double>(highest - value) / value);
+        }
+        TEST_CHECK_EQUAL(context, outside, 0);
+        TEST_CHECK(context, worstError <= 1.0 / 64.0);
+    });
+
+    TestRegistration s_percentilesMatchReference("LatencyHistogram/PercentilesMatchSortedReference", [](TestContext& context)
+    {
+        // Frame-time-like samples: mostly 5-20 ms with a long tail, in whole
+        // microseconds so the reference sees exactly what is recorded
+        std::mt19937 random(7);
+        std::vector<uint64_t> samples;
+        LatencyHistogram histogram;
+        for (int i = 0; i < 20000; ++i)
+        {
+            uint64_t value = 5000 + random() % 15000;
+            if (i % 100 == 0)
+            {
+                value += random() % 200000;
+            }
+            samples.push_back(value);
+            histogram.Record(value / 1000.0);
+        }
+        std::sort(samples.begin(), samples.end());
+
+        const double percentiles[] = { 0.0, 1.0, 10.0, 25.0, 50.0, 75.0, 90.0, 95.0, 99.0, 99.9, 100.0 };
+        for (double percentile : percentiles)
+        {
+            // Nearest rank: the smallest sample with at least p% of the samples at or below it
+            size_t rank = static_cast<size_t>(std::ceil(percentile / 100.0 * samples.size()));
+            uint64_t reference = samples[std::max<size_t>(rank, 1) - 1];
+
+            uint64_t reported = ToMicroseconds(histogram.GetPercentile(percentile));
+            TEST_CHECK(context, reported >= reference);
+            TEST_CHECK(context, reported - reference <= reference / 64);
+        }
+
+        TEST_CHECK_EQUAL(context, ToMicroseconds(histogram.GetMin()), samples.front());
+        TEST_CHECK_EQUAL(context, ToMicroseconds(histogram.GetMax()), samples.back());
+    });
+
+    TestRegistration s_jsonEscapesNames("LatencyHistogram/JsonEscapesNames", [](TestContext& context)
+    {
+        std::string path = (std::filesystem::temp_directory_path() / "engine_tests_latency.json").string();
+
+        LatencyHistogram histogram("Frame \"main\" C:\\game");
+        histogram.Record(16.6);
+        TEST_CHECK(context, LatencyReport::WriteJSON(path, { &histogram }));
+
+        std::ifstream file(path);
+        std::string text((std::istreambuf_iterator<char>(file)), std::istreambuf_iterator<char>());
+        TEST_CHECK(context, text.find("\"name\": \"Frame \\\"main\\\" C:\\\\game\",") != std::string::npos);
+
+        file.close();
+        std::remove(path.c_str());
+    });
+}
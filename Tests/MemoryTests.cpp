@@ -0,0 +1,274 @@
+#include "Test.h"
+#include "../Engine/Memory.h"
+#include "../Graphics/Animation.h"
+#include <algorithm>
+#include <iostream>
+
+// Resource accounting: category totals, per-asset breakdown, peaks and
+// budget warnings. The accounting is process-wide, so every check is made
+// relative to the state before the test.
+
+namespace
+{
+    // Collects what is written to std::cerr while alive
+    class ErrorCapture
+    {
+    public:
+        ErrorCapture()
+            : m_previous(std::cerr.rdbuf(m_text.rdbuf()))
+        {
+        }
+
+        ~ErrorCapture()
+        {
+            std::cerr.rdbuf(m_previous);
+        }
+
+        int Count(const std::string& text) const
+        {
+            std::string captured = m_text.str();
+            int count = 0;
+            for (size_t position = captured.find(text); position != std::string::npos;
+                 position = captured.find(text, position + text.size()))
+            {
+                count++;
+            }
+            return count;
+        }
+
+    private:
+        std::ostringstream m_text;
+        std::streambuf* m_previous;
+    };
+
+    const MemoryAssetUsage* FindAsset(const std::vector<MemoryAssetUsage>& usage, const std::string& asset)
+    {
+        auto it = std::find_if(usage.begin(), usage.end(), [&](const MemoryAssetUsage& entry) { return entry.asset == asset; });
+        return it != usage.end() ? &*it : nullptr;
+    }
+
+    TestRegistration s_categoryTotals("Memory/CategoryTotals", [](TestContext& context)
+    {
+        int meshA = 0;
+        int meshB = 0;
+        MemoryCategoryStats cpuBefore = Memory::GetCategoryStats(MemoryCategory::MeshCpu);
+        MemoryCategoryStats gpuBefore = Memory::GetCategoryStats(MemoryCategory::MeshGpu);
+
+        Memory::TrackResource(MemoryCategory::MeshCpu, &meshA, "tests/a.obj", 1000);
+        Memory::TrackResource(MemoryCategory::MeshGpu, &meshA, "tests/a.obj", 4000);
+        Memory::TrackResource(MemoryCategory::MeshCpu, &meshB, "tests/b.obj", 500);
+
+        MemoryCategoryStats cpu = Memory::GetCategoryStats(MemoryCategory::MeshCpu);
+        TEST_CHECK_EQUAL(context, cpu.bytes - cpuBefore.bytes, 1500u);
+        TEST_CHECK_EQUAL(context, cpu.resourceCount - cpuBefore.resourceCount, 2u);
+        TEST_CHECK_EQUAL(context, Memory::GetCategoryStats(MemoryCategory::MeshGpu).bytes - gpuBefore.bytes, 4000u);
+
+        // Tracking an owner again replaces its entry
+        Memory::TrackResource(MemoryCategory::MeshCpu, &meshA, "tests/a.obj", 1200);
+        cpu = Memory::GetCategoryStats(MemoryCategory::MeshCpu);
+        TEST_CHECK_EQUAL(context, cpu.bytes - cpuBefore.bytes, 1700u);
+        TEST_CHECK_EQUAL(context, cpu.resourceCount - cpuBefore.resourceCount, 2u);
+
+        std::vector<MemoryAssetUsage> usage = Memory::GetAssetUsage();
+        const MemoryAssetUsage* assetA = FindAsset(usage, "tests/a.obj");
+        const MemoryAssetUsage* assetB = FindAsset(usage, "tests/b.obj");
+        TEST_CHECK(context, assetA != nullptr && assetB != nullptr);
+        if (assetA && assetB)
+        {
+            TEST_CHECK_EQUAL(context, assetA->totalBytes, 5200u);
+            TEST_CHECK_EQUAL(context, assetA->bytes[static_cast<size_t>(MemoryCategory::MeshCpu)], 1200u);
+            TEST_CHECK_EQUAL(context, assetA->bytes[static_cast<size_t>(MemoryCategory::MeshGpu)], 4000u);
+            TEST_CHECK_EQUAL(context, assetB->totalBytes, 500u);
+            TEST_CHECK(context, assetA < assetB);   // Largest first
+        }
+
+        // A size of 0 removes the entry; UntrackResources clears every category
+        Memory::TrackResource(MemoryCategory::MeshCpu, &meshB, "tests/b.obj", 0);
+        Memory::UntrackResources(&meshA);
+        cpu = Memory::GetCategoryStats(MemoryCategory::MeshCpu);
+        TEST_CHECK_EQUAL(context, cpu.bytes, cpuBefore.bytes);
+        TEST_CHECK_EQUAL(context, cpu.resourceCount, cpuBefore.resourceCount);
+        TEST_CHECK_EQUAL(context, Memory::GetCategoryStats(MemoryCategory::MeshGpu).bytes, gpuBefore.bytes);
+        TEST_CHECK(context, FindAsset(Memory::GetAssetUsage(), "tests/a.obj") == nullptr);
+    });
+
+    TestRegistration s_peakTracking("Memory/PeakTracking", [](TestContext& context)
+    {
+        int clipA = 0;
+        int clipB = 0;
+        MemoryCategoryStats before = Memory::GetCategoryStats(MemoryCategory::Animation);
+
+        Memory::TrackResource(MemoryCategory::Animation, &clipA, "tests/walk.anim", 3000);
+        Memory::TrackResource(MemoryCategory::Animation, &clipB, "tests/run.anim", 7000);
+        Memory::UntrackResource(MemoryCategory::Animation, &clipB);
+        Memory::TrackResource(MemoryCategory::Animation, &clipA, "tests/walk.anim", 2000);
+
+        // The peak keeps the high-water mark after the usage drops
+        MemoryCategoryStats after = Memory::GetCategoryStats(MemoryCategory::Animation);
+        TEST_CHECK_EQUAL(context, after.bytes - before.bytes, 2000u);
+        TEST_CHECK_EQUAL(context, after.peakBytes, std::max<uint64_t>(before.peakBytes, before.bytes + 10000));
+
+        Memory::UntrackResource(MemoryCategory::Animation, &clipA);
+        TEST_CHECK_EQUAL(context, Memory::GetCategoryStats(MemoryCategory::Animation).bytes, before.bytes);
+    });
+
+    TestRegistration s_categoryBudgetWarnings("Memory/CategoryBudgetWarnings", [](TestContext& context)
+    {
+        int textureA = 0;
+        int textureB = 0;
+        const char* warning = "Memory: Textures over budget";
+        uint64_t baseline = Memory::GetCategoryStats(MemoryCategory::Textures).bytes;
+
+        ErrorCapture errors;
+        Memory::SetBudget(MemoryCategory::Textures, baseline + 10000);
+        TEST_CHECK_EQUAL(context, Memory::GetCategoryStats(MemoryCategory::Textures).budgetBytes, baseline + 10000);
+
+        Memory::TrackResource(MemoryCategory::Textures, &textureA, "tests/a.dds", 6000);
+        TEST_CHECK_EQUAL(context, errors.Count(warning), 0);
+
+        // Warned once when first exceeded, not again while still over
+        Memory::TrackResource(MemoryCategory::Textures, &textureB, "tests/b.dds", 6000);
+        TEST_CHECK_EQUAL(context, errors.Count(warning), 1);
+        Memory::TrackResource(MemoryCategory::Textures, &textureB, "tests/b.dds", 8000);
+        TEST_CHECK_EQUAL(context, errors.Count(warning), 1);
+
+        // Re-armed once usage falls back under the budget
+        Memory::UntrackResource(MemoryCategory::Textures, &textureB);
+        Memory::TrackResource(MemoryCategory::Textures, &textureB, "tests/b.dds", 5000);
+        TEST_CHECK_EQUAL(context, errors.Count(warning), 2);
+
+        // Lowering the budget under the current usage warns immediately
+        Memory::UntrackResource(MemoryCategory::Textures, &textureB);
+        Memory::SetBudget(MemoryCategory::Textures, baseline + 1000);
+        TEST_CHECK_EQUAL(context, errors.Count(warning), 3);
+
+        Memory::SetBudget(MemoryCategory::Textures, 0);
+        Memory::UntrackResources(&textureA);
+        TEST_CHECK_EQUAL(context, Memory::GetCategoryStats(MemoryCategory::Textures).bytes, baseline);
+    });
+
+    TestRegistration s_subsystemBudgetWarnings("Memory/SubsystemBudgetWarnings", [](TestContext& context)
+    {
+        const char* warning = "Memory: Rendering over budget";
+        uint64_t baseline = Memory::GetStats(MemorySubsystem::Rendering).bytesReserved;
+
+        ErrorCapture errors;
+        Memory::SetBudget(MemorySubsystem::Rendering, baseline + 64 * 1024);
+
+        Memory::RecordReserve(MemorySubsystem::Rendering, 48 * 1024);
+        TEST_CHECK_EQUAL(context, errors.Count(warning), 0);
+        Memory::RecordReserve(MemorySubsystem::Rendering, 32 * 1024);
+        TEST_CHECK_EQUAL(context, errors.Count(warning), 1);
+        Memory::RecordReserve(MemorySubsystem::Rendering, 32 * 1024);
+        TEST_CHECK_EQUAL(context, errors.Count(warning), 1);
+
+        MemorySubsystemStats stats = Memory::GetStats(MemorySubsystem::Rendering);
+        TEST_CHECK_EQUAL(context, stats.bytesReserved - baseline, 112u * 1024);
+        TEST_CHECK(context, stats.peakBytesReserved >= baseline + 112 * 1024);
+
+        Memory::RecordUnreserve(MemorySubsystem::Rendering, 112 * 1024);
+        Memory::SetBudget(MemorySubsystem::Rendering, 0);
+        TEST_CHECK_EQUAL(context, Memory::GetStats(MemorySubsystem::Rendering).bytesReserved, baseline);
+    });
+
+    TestRegistration s_textureBytesCountMips("Memory/TextureBytesCountMips", [](TestContext& context)
+    {
+        TEST_CHECK_EQUAL(context, Memory::GetTextureBytes(256, 256, 32), 256u * 256 * 4);
+
+        // Full chain of 256x64: 9 levels down to 1x1
+        uint64_t fullChain = 0;
+        const int widths[] = { 256, 128, 64, 32, 16, 8, 4, 2, 1 };
+        const int heights[] = { 64, 32, 16, 8, 4, 2, 1, 1, 1 };
+        for (int level = 0; level < 9; ++level)
+        {
+            fullChain += static_cast<uint64_t>(widths[level]) * heights[level] * 4;
+        }
+        TEST_CHECK_EQUAL(context, Memory::GetTextureBytes(256, 64, 32, 9), fullChain);
+
+        // More levels than the chain has stop at 1x1
+        TEST_CHECK_EQUAL(context, Memory::GetTextureBytes(256, 64, 32, 16), fullChain);
+
+    });
+
+    TestRegistration s_compressedTextureBytesCountBlocks("Memory/CompressedTextureBytesCountBlocks", [](TestContext& context)
+    {
+        // Levels smaller than a 4x4 block still take a whole block
+        TEST_CHECK_EQUAL(context, Memory::GetBlockCompressedTextureBytes(1, 1, 8), 8u);
+        TEST_CHECK_EQUAL(context, Memory::GetBlockCompressedTextureBytes(2, 2, 16), 16u);
+        TEST_CHECK_EQUAL(context, Memory::GetBlockCompressedTextureBytes(5, 3, 8), 2u * 8);
+        TEST_CHECK_EQUAL(context, Memory::GetBlockCompressedTextureBytes(256, 256, 8), 64u * 64 * 8);
+
+        // Full BC1 chain of 256x64: the last three levels are one block each
+        uint64_t fullChain = 0;
+        const int widths[] = { 256, 128, 64, 32, 16, 8, 4, 2, 1 };
+        const int heights[] = { 64, 32, 16, 8, 4, 2, 1, 1, 1 };
+        for (int level = 0; level < 9; ++level)
+        {
+            uint64_t blocks = static_cast<uint64_t>(std::max((widths[level] + 3) / 4, 1)) * std::max((heights[level] + 3) / 4, 1);
+            fullChain += blocks * 8;
+        }
+        TEST_CHECK_EQUAL(context, Memory::GetBlockCompressedTextureBytes(256, 64, 8, 9), fullChain);
+        TEST_CHECK_EQUAL(context, Memory::GetBlockCompressedTextureBytes(256, 64, 8, 16), fullChain);
+        TEST_CHECK(context, fullChain > Memory::GetTextureBytes(256, 64, 4, 9));
+    });
+
+    AnimationChannel CreateChannel(const std::string& boneName, int keyCount)
+    {
+        AnimationChannel channel;
+        channel.boneName = boneName;
+        for (int i = 0; i < keyCount; ++i)
+        {
+            float time = static_cast<float>(i);
+            channel.positionKeys.emplace_back(time, XMVectorSet(time, 0.0f, 0.0f, 1.0f));
+            channel.rotationKeys.emplace_back(time, XMQuaternionIdentity());
+            channel.scaleKeys.emplace_back(time, XMVectorSplatOne());
+        }
+        return channel;
+    }
+
+    // A real owner: the keyframes an Animation reports while it holds
+    // channels, and nothing once it is shut down or destroyed
+    TestRegistration s_animationRoundTrip("Memory/AnimationRoundTrip", [](TestContext& context)
+    {
+        MemoryCategoryStats before = Memory::GetCategoryStats(MemoryCategory::Animation);
+
+        Animation animation;
+        animation.Initialize("tests/walk.anim", 30.0f, 30.0f);
+        TEST_CHECK_EQUAL(context, Memory::GetCategoryStats(MemoryCategory::Animation).bytes, before.bytes);
+
+        animation.AddChannel(CreateChannel("hips", 31));
+        animation.AddChannel(CreateChannel("spine", 17));
+        TEST_CHECK(context, animation.GetMemoryBytes() >= (31 + 17) * 3 * sizeof(AnimationKey<XMVECTOR>));
+
+        MemoryCategoryStats tracked = Memory::GetCategoryStats(MemoryCategory::Animation);
+        TEST_CHECK_EQUAL(context, tracked.bytes - before.bytes, static_cast<uint64_t>(animation.GetMemoryBytes()));
+        TEST_CHECK_EQUAL(context, tracked.resourceCount - before.resourceCount, 1u);
+
+        std::vector<MemoryAssetUsage> usage = Memory::GetAssetUsage();
+        const MemoryAssetUsage* asset = FindAsset(usage, "tests/walk.anim");
+        TEST_CHECK(context, asset != nullptr);
+        if (asset)
+        {
+            TEST_CHECK_EQUAL(context, asset->bytes[static_cast<size_t>(MemoryCategory::Animation)],
+                             static_cast<uint64_t>(animation.GetMemoryBytes()));
+        }
+
+        animation.Shutdown();
+        MemoryCategoryStats released = Memory::GetCategoryStats(MemoryCategory::Animation);
+        TEST_CHECK_EQUAL(context, animation.GetMemoryBytes(), 0u);
+        TEST_CHECK_EQUAL(context, released.bytes, before.bytes);
+        TEST_CHECK_EQUAL(context, released.resourceCount, before.resourceCount);
+        usage = Memory::GetAssetUsage();
+        TEST_CHECK(context, FindAsset(usage, "tests/walk.anim") == nullptr);
+
+        // The destructor releases an animation that was never shut down
+        {
+            Animation scoped;
+            scoped.Initialize("tests/run.anim", 20.0f, 30.0f);
+            scoped.AddChannel(CreateChannel("hips", 21));
+            TEST_CHECK(context, Memory::GetCategoryStats(MemoryCategory::Animation).bytes > before.bytes);
+        }
+        TEST_CHECK_EQUAL(context, Memory::GetCategoryStats(MemoryCategory::Animation).bytes, before.bytes);
+        TEST_CHECK_EQUAL(context, Memory::GetCategoryStats(MemoryCategory::Animation).resourceCount, before.resourceCount);
+    });
+}
@@ -0,0 +1,301 @@
+#include "Test.h"
+#include "WarpDevice.h"
+#include "../Graphics/ModelLoader.h"
+#include "../Benchmarks/Datasets.h"
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <filesystem>
+#include <fstream>
+#include <thread>
+
+// Asynchronous loads on a WARP device. Built on Windows only, with the
+// Direct3D frontend.
+
+namespace
+{
+    // Large enough that parsing takes a while and the upload spans many calls
+    const int MESH_COUNT = 48;
+    const int GRID_SIZE = 48;
+    const float TIME_BUDGET_MS = 2.0f;
+
+    // Slack for the object that crosses the budget and for the scheduler
+    const float OVERRUN_MS = 8.0f;
+
+    // Writes the test model once per run
+    const std::string& GetModelPath()
+    {
+        static const std::string path = []()
+        {
+            std::string filepath = (std::filesystem::temp_directory_path() / "ModelLoaderTests.x").string();
+            std::ofstream file(filepath, std::ios::binary);
+            file << Datasets::CreateXFile(MESH_COUNT, GRID_SIZE, 0, 0);
+            return filepath;
+        }();
+        return path;
+    }
+
+    // Holds the only worker of a job system until opened, so a load queued
+    // after it starts exactly when the test wants
+    class WorkerGate
+    {
+    public:
+        explicit WorkerGate(JobSystem& jobSystem)
+            : m_jobSystem(jobSystem)
+            , m_held(false)
+            , m_open(false)
+        {
+            m_jobSystem.Run([this]()
+            {
+                m_held.store(true);
+                while (!m_open.load())
+                {
+                    std::this_thread::yield();
+                }
+            }, &m_job);
+
+            while (!m_held.load())
+            {
+                std::this_thread::yield();
+            }
+        }
+
+        ~WorkerGate()
+        {
+            Open();
+            m_jobSystem.Wait(m_job);
+        }
+
+        void Open() { m_open.store(true); }
+
+    private:
+        WorkerGate(const WorkerGate&) = delete;
+        WorkerGate& operator=(const WorkerGate&) = delete;
+
+        JobSystem& m_jobSystem;
+        std::atomic<bool> m_held;
+        std::atomic<bool> m_open;
+        JobCounter m_job;
+    };
+
+    bool IsWorkerStage(ModelLoadState state)
+    {
+        return state == ModelLoadState::Queued || state == ModelLoadState::Reading ||
+               state == ModelLoadState::Parsing || state == ModelLoadState::Processing;
+    }
+
+    float GetElapsedMs(std::chrono::steady_clock::time_point start)
+    {
+        return std::chrono::duration<float, std::milli>(std::chrono::steady_clock::now() - start).count();
+    }
+
+    // Frames of the main thread until the loader has nothing in flight
+    void UpdateUntilIdle(ModelLoader& loader, ID3D11Device* device)
+    {
+        while (loader.UpdateAsyncLoads(device, TIME_BUDGET_MS) > 0)
+        {
+            std::this_thread::sleep_for(std::chrono::milliseconds(1));
+        }
+    }
+
+    // The caller's thread never waits on the worker, and the upload stage
+    // stays within the budget per call; progress only moves forward
+    TestRegistration s_timeSliced("ModelLoader/UpdateAsyncLoadsIsTimeSliced", [](TestContext& context)
+    {
+        WarpDevice device;
+        TEST_CHECK(context, device.Get() != nullptr);
+        if (!device.Get())
+        {
+            return;
+        }
+
+        JobSystem jobSystem;
+        jobSystem.Initialize(1);
+        ModelLoader loader;
+        const std::string& path = GetModelPath();
+
+        auto start = std::chrono::steady_clock::now();
+        ModelLoadHandle request = loader.LoadAsync(path, jobSystem);
+        TEST_CHECK(context, GetElapsedMs(start) < 1.0f);
+        TEST_CHECK(context, !request->IsDone());
+
+        float progress = request->GetProgress();
+        bool monotonic = true;
+        int workerStageCalls = 0;
+        int uploadCalls = 0;
+        float slowestWorkerStageCallMs = 0.0f;
+        float slowestUploadCallMs = 0.0f;
+
+        while (!request->IsDone())
+        {
+            ModelLoadState before = request->GetState();
+            auto callStart = std::chrono::steady_clock::now();
+            loader.UpdateAsyncLoads(device.Get(), TIME_BUDGET_MS);
+            float callMs = GetElapsedMs(callStart);
+
+            if (IsWorkerStage(before) && IsWorkerStage(request->GetState()))
+            {
+                // Nothing to upload yet: the call only looks at the state
+                workerStageCalls++;
+                slowestWorkerStageCallMs = std::max(slowestWorkerStageCallMs, callMs);
+            }
+            else if (!IsWorkerStage(before))
+            {
+                uploadCalls++;
+                slowestUploadCallMs = std::max(slowestUploadCallMs, callMs);
+            }
+
+            float current = request->GetProgress();
+            monotonic = monotonic && current >= progress;
+            progress = current;
+
+            std::this_thread::sleep_for(std::chrono::milliseconds(1));
+        }
+
+        TEST_CHECK(context, monotonic);
+        TEST_CHECK(context, request->GetState() == ModelLoadState::Completed);
+        TEST_CHECK_EQUAL(context, request->GetProgress(), 1.0f);
+        TEST_CHECK(context, workerStageCalls > 0);
+        TEST_CHECK(context, slowestWorkerStageCallMs < TIME_BUDGET_MS);
+        TEST_CHECK(context, uploadCalls > 1);
+        TEST_CHECK(context, slowestUploadCallMs < TIME_BUDGET_MS + OVERRUN_MS);
+        TEST_CHECK_EQUAL(context, loader.GetAsyncLoadCount(), 0u);
+
+        TEST_CHECK(context, request->GetModel() != nullptr);
+        TEST_CHECK_EQUAL(context, loader.GetLastLoadingStats().meshCount, MESH_COUNT);
+        jobSystem.Shutdown();
+    });
+
+    // Cancelling in any stage ends the load as Cancelled with no model.
+    // Queued, Processing and the main-thread stages are hit exactly; Reading
+    // and Parsing are caught by polling, so a cancel meant for Reading may
+    // land in a later worker stage.
+    TestRegistration s_cancelEachStage("ModelLoader/CancelDuringEachStage", [](TestContext& context)
+    {
+        WarpDevice device;
+        TEST_CHECK(context, device.Get() != nullptr);
+        if (!device.Get())
+        {
+            return;
+        }
+
+        JobSystem jobSystem;
+        jobSystem.Initialize(1);
+        const std::string& path = GetModelPath();
+
+        auto checkCancelled = [&](const ModelLoadHandle& request, float progressAtCancel, const char* stage)
+        {
+            if (request->GetState() != ModelLoadState::Cancelled || request->GetModel() != nullptr)
+            {
+                context.Fail(std::string("Load cancelled while ") + stage + " did not end Cancelled", __FILE__, __LINE__);
+            }
+            TEST_CHECK(context, request->GetProgress() >= progressAtCancel && request->GetProgress() < 1.0f);
+        };
+
+        // Queued behind another job
+        {
+            ModelLoader loader;
+            WorkerGate gate(jobSystem);
+            ModelLoadHandle request = loader.LoadAsync(path, jobSystem);
+            TEST_CHECK(context, request->GetState() == ModelLoadState::Queued);
+            request->Cancel();
+            gate.Open();
+            UpdateUntilIdle(loader, device.Get());
+            checkCancelled(request, 0.0f, "queued");
+            TEST_CHECK_EQUAL(context, request->GetProgress(), 0.0f);
+        }
+
+        // Reading and Parsing
+        for (ModelLoadState stage : { ModelLoadState::Reading, ModelLoadState::Parsing })
+        {
+            ModelLoader loader;
+            ModelLoadHandle request = loader.LoadAsync(path, jobSystem);
+            while (request->GetState() < stage)
+            {
+                std::this_thread::yield();
+            }
+            float progress = request->GetProgress();
+            request->Cancel();
+            UpdateUntilIdle(loader, device.Get());
+            checkCancelled(request, progress, stage == ModelLoadState::Reading ? "reading" : "parsing");
+        }
+
+        // Processing: cancelled from inside the post-processing
+        {
+            ModelLoader loader;
+            WorkerGate gate(jobSystem);
+            ModelLoadHandle request;
+            std::atomic<bool> cancelledInProcessing(false);
+            loader.SetParallelForFunction([&](size_t count, const std::function<void(size_t, size_t)>& body)
+            {
+                cancelledInProcessing = request->GetState() == ModelLoadState::Processing;
+                request->Cancel();
+                body(0, count);
+            });
+            request = loader.LoadAsync(path, jobSystem);
+            gate.Open();
+            UpdateUntilIdle(loader, device.Get());
+            TEST_CHECK(context, cancelledInProcessing.load());
+            checkCancelled(request, 0.5f, "processing");
+        }
+
+        // Waiting for upload: the worker is done, no object was created yet
+        {
+            ModelLoader loader;
+            ModelLoadHandle request = loader.LoadAsync(path, jobSystem);
+            while (request->GetState() != ModelLoadState::WaitingForUpload)
+            {
+                std::this_thread::yield();
+            }
+            request->Cancel();
+            TEST_CHECK_EQUAL(context, loader.UpdateAsyncLoads(device.Get(), TIME_BUDGET_MS), 0u);
+            checkCancelled(request, 0.6f, "waiting for upload");
+        }
+
+        // Uploading: a zero budget creates one object per call
+        {
+            ModelLoader loader;
+            ModelLoadHandle request = loader.LoadAsync(path, jobSystem);
+            while (request->GetState() != ModelLoadState::WaitingForUpload)
+            {
+                std::this_thread::yield();
+            }
+            loader.UpdateAsyncLoads(device.Get(), 0.0f);
+            TEST_CHECK(context, request->GetState() == ModelLoadState::Uploading);
+            float progress = request->GetProgress();
+            request->Cancel();
+            TEST_CHECK_EQUAL(context, loader.UpdateAsyncLoads(device.Get(), TIME_BUDGET_MS), 0u);
+            checkCancelled(request, progress, "uploading");
+        }
+
+        // A completed load is left alone
+        {
+            ModelLoader loader;
+            ModelLoadHandle request = loader.LoadAsync(path, jobSystem);
+            UpdateUntilIdle(loader, device.Get());
+            request->Cancel();
+            TEST_CHECK(context, request->GetState() == ModelLoadState::Completed);
+            TEST_CHECK(context, request->GetModel() != nullptr);
+        }
+
+        // CancelAsyncLoads stops every load in flight, whatever its stage
+        {
+            ModelLoader loader;
+            std::vector<ModelLoadHandle> requests;
+            for (int i = 0; i < 4; ++i)
+            {
+                requests.push_back(loader.LoadAsync(path, jobSystem));
+            }
+            loader.UpdateAsyncLoads(device.Get(), 0.0f);
+            loader.CancelAsyncLoads();
+            TEST_CHECK_EQUAL(context, loader.GetAsyncLoadCount(), 0u);
+            for (const ModelLoadHandle& request : requests)
+            {
+                TEST_CHECK(context, request->GetState() == ModelLoadState::Cancelled ||
+                                    request->GetState() == ModelLoadState::Completed);
+            }
+        }
+
+        jobSystem.Shutdown();
+    });
+}
@@ -0,0 +1,184 @@
+#include "Test.h"
+#include "../Graphics/OcclusionCulling.h"
+#include <algorithm>
+#include <cfloat>
+#include <cmath>
+
+// Software occlusion: boxes behind, around and in front of a wall, each
+// checked against the conservative rule on the rasterized depth buffer. A
+// box is hidden only if its nearest depth is farther than every pixel its
+// screen rectangle covers.
+
+namespace
+{
+    const int WIDTH = 256;
+    const int HEIGHT = 128;
+
+    // Camera at the origin looking down +Z; a 10x10 wall at z = 10
+    XMMATRIX CreateViewProjection()
+    {
+        XMMATRIX view = XMMatrixLookAtLH(XMVectorSet(0.0f, 0.0f, 0.0f, 1.0f),
+                                         XMVectorSet(0.0f, 0.0f, 1.0f, 1.0f),
+                                         XMVectorSet(0.0f, 1.0f, 0.0f, 0.0f));
+        XMMATRIX projection = XMMatrixPerspectiveFovLH(XM_PIDIV2, static_cast<float>(WIDTH) / HEIGHT, 0.5f, 200.0f);
+        return XMMatrixMultiply(view, projection);
+    }
+
+    void RenderWall(OcclusionCuller& culler, const XMMATRIX& viewProjection)
+    {
+        culler.BeginFrame(viewProjection);
+        culler.RenderOccluder(OcclusionCuller::CreateBoxOccluder(XMFLOAT3(-5.0f, -5.0f, 10.0f),
+                                                                 XMFLOAT3(5.0f, 5.0f, 11.0f)),
+                              XMMatrixIdentity());
+        culler.FinalizeOccluders();
+    }
+
+    // The rule applied pixel by pixel, without the tile shortcut; boxes that
+    // reach behind the camera or leave the screen count as visible
+    bool ExpectedVisible(const OcclusionCuller& culler, const XMMATRIX& viewProjection,
+                         const XMFLOAT3& min, const XMFLOAT3& max)
+    {
+        float rectMinX = FLT_MAX, rectMinY = FLT_MAX, rectMaxX = -FLT_MAX, rectMaxY = -FLT_MAX;
+        float nearestDepth = FLT_MAX;
+        for (int corner = 0; corner < 8; ++corner)
+        {
+            XMVECTOR position = XMVectorSet((corner & 1) ? max.x : min.x,
+                                            (corner & 2) ? max.y : min.y,
+                                            (corner & 4) ? max.z : min.z, 1.0f);
+            XMFLOAT4 clip;
+            XMStoreFloat4(&clip, XMVector4Transform(position, viewProjection));
+            if (clip.w <= 0.0f)
+            {
+                return true;
+            }
+
+            float sx = (clip.x / clip.w + 1.0f) * culler.GetWidth() * 0.5f;
+            float sy = (1.0f - clip.y / clip.w) * culler.GetHeight() * 0.5f;
+            rectMinX = std::min(rectMinX, sx);
+            rectMaxX = std::max(rectMaxX, sx);
+            rectMinY = std::min(rectMinY, sy);
+            rectMaxY = std::max(rectMaxY, sy);
+            nearestDepth = std::min(nearestDepth, clip.z / clip.w);
+        }
+
+        int x0 = std::max(0, static_cast<int>(std::floor(rectMinX)));
+        int x1 = std::min(culler.GetWidth() - 1, static_cast<int>(std::ceil(rectMaxX)));
+        int y0 = std::max(0, static_cast<int>(std::floor(rectMinY)));
+        int y1 = std::min(culler.GetHeight() - 1, static_cast<int>(std::ceil(rectMaxY)));
+        if (x0 > x1 || y0 > y1)
+        {
+            return true;
+        }
+
+        for (int y = y0; y <= y1; ++y)
+        {
+            for (int x = x0; x <= x1; ++x)
+            {
+                if (nearestDepth <= culler.GetDepth(x, y))
+                {
+                    return true;
+                }
+            }
+        }
+        return false;
+    }
+
+    TestRegistration s_fullyHidden("Occlusion/FullyHiddenBox", [](TestContext& context)
+    {
+        XMMATRIX viewProjection = CreateViewProjection();
+        OcclusionCuller culler;
+        TEST_CHECK(context, culler.Initialize(WIDTH, HEIGHT));
+        RenderWall(culler, viewProjection);
+
+        // Well inside the wall's silhouette, from just behind it to far away
+        const XMFLOAT3 mins[] = { XMFLOAT3(-1.0f, -1.0f, 12.0f), XMFLOAT3(-6.0f, -6.0f, 40.0f), XMFLOAT3(2.0f, -3.0f, 150.0f) };
+        const XMFLOAT3 maxs[] = { XMFLOAT3(1.0f, 1.0f, 14.0f), XMFLOAT3(6.0f, 6.0f, 60.0f), XMFLOAT3(4.0f, -1.0f, 160.0f) };
+        for (int i = 0; i < 3; ++i)
+        {
+            TEST_CHECK(context, !ExpectedVisible(culler, viewProjection, mins[i], maxs[i]));
+            TEST_CHECK(context, !culler.IsVisible(mins[i], maxs[i]));
+        }
+
+        TEST_CHECK_EQUAL(context, culler.GetStats().testedBoxes, 3);
+        TEST_CHECK_EQUAL(context, culler.GetStats().occludedBoxes, 3);
+        TEST_CHECK_NEAR(context, culler.GetStats().GetOccludedFraction(), 1.0f, 1e-6f);
+    });
+
+    TestRegistration s_partlyVisible("Occlusion/PartlyVisibleBox", [](TestContext& context)
+    {
+        XMMATRIX viewProjection = CreateViewProjection();
+        OcclusionCuller culler;
+        TEST_CHECK(context, culler.Initialize(WIDTH, HEIGHT));
+        RenderWall(culler, viewProjection);
+
+        // Reaching past the wall's right edge, above its top, in front of it,
+        // and a wall-sized box right behind it that pokes out around the edges
+        const XMFLOAT3 mins[] = { XMFLOAT3(5.0f, -1.0f, 20.0f), XMFLOAT3(-1.0f, 5.0f, 20.0f),
+                                  XMFLOAT3(-1.0f, -1.0f, 5.0f), XMFLOAT3(-8.0f, -8.0f, 12.0f) };
+        const XMFLOAT3 maxs[] = { XMFLOAT3(30.0f, 1.0f, 22.0f), XMFLOAT3(1.0f, 30.0f, 22.0f),
+                                  XMFLOAT3(1.0f, 1.0f, 6.0f), XMFLOAT3(8.0f, 8.0f, 13.0f) };
+        for (int i = 0; i < 4; ++i)
+        {
+            TEST_CHECK(context, ExpectedVisible(culler, viewProjection, mins[i], maxs[i]));
+            TEST_CHECK(context, culler.IsVisible(mins[i], maxs[i]));
+        }
+
+        // A box hidden by the wall next to them
+        TEST_CHECK(context, !culler.IsVisible(XMFLOAT3(-1.0f, -1.0f, 20.0f), XMFLOAT3(1.0f, 1.0f, 22.0f)));
+        TEST_CHECK_EQUAL(context, culler.GetStats().testedBoxes, 5);
+        TEST_CHECK_EQUAL(context, culler.GetStats().occludedBoxes, 1);
+        TEST_CHECK_NEAR(context, culler.GetStats().GetOccludedFraction(), 0.2f, 1e-6f);
+    });
+
+    TestRegistration s_behindNearPlane("Occlusion/BoxBehindNearPlane", [](TestContext& context)
+    {
+        XMMATRIX viewProjection = CreateViewProjection();
+        OcclusionCuller culler;
+        TEST_CHECK(context, culler.Initialize(WIDTH, HEIGHT));
+        RenderWall(culler, viewProjection);
+
+        // Around the camera, entirely behind it, and between the camera and
+        // the near plane: none has all corners past the near plane, so all
+        // are reported visible
+        const XMFLOAT3 mins[] = { XMFLOAT3(-1.0f, -1.0f, -1.0f), XMFLOAT3(-1.0f, -1.0f, -6.0f), XMFLOAT3(-0.1f, -0.1f, 0.1f) };
+        const XMFLOAT3 maxs[] = { XMFLOAT3(1.0f, 1.0f, 1.0f), XMFLOAT3(1.0f, 1.0f, -4.0f), XMFLOAT3(0.1f, 0.1f, 0.4f) };
+        for (int i = 0; i < 3; ++i)
+        {
+            TEST_CHECK(context, ExpectedVisible(culler, viewProjection, mins[i], maxs[i]));
+            TEST_CHECK(context, culler.IsVisible(mins[i], maxs[i]));
+        }
+        TEST_CHECK_EQUAL(context, culler.GetStats().testedBoxes, 3);
+        TEST_CHECK_EQUAL(context, culler.GetStats().occludedBoxes, 0);
+    });
+
+    // The tile shortcut must agree with the per-pixel rule everywhere: a
+    // sweep of boxes across the wall's edges and depths
+    TestRegistration s_matchesPixelRule("Occlusion/MatchesPixelRule", [](TestContext& context)
+    {
+        XMMATRIX viewProjection = CreateViewProjection();
+        OcclusionCuller culler;
+        TEST_CHECK(context, culler.Initialize(WIDTH, HEIGHT));
+        RenderWall(culler, viewProjection);
+
+        int mismatches = 0;
+        int hidden = 0;
+        for (float z = 2.0f; z < 60.0f; z += 3.7f)
+        {
+            for (float x = -25.0f; x < 25.0f; x += 1.3f)
+            {
+                for (float y = -25.0f; y < 25.0f; y += 2.9f)
+                {
+                    XMFLOAT3 min(x, y, z);
+                    XMFLOAT3 max(x + 1.5f, y + 1.0f, z + 0.5f);
+                    bool expected = ExpectedVisible(culler, viewProjection, min, max);
+                    mismatches += (culler.IsVisible(min, max) != expected) ? 1 : 0;
+                    hidden += expected ? 0 : 1;
+                }
+            }
+        }
+
+        TEST_CHECK_EQUAL(context, mismatches, 0);
+        TEST_CHECK(context, hidden > 0);
+        TEST_CHECK_EQUAL(context, culler.GetStats().occludedBoxes, hidden);
+    });
+}
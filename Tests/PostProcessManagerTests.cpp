@@ -0,0 +1,104 @@
+#include "Test.h"
+#include "WarpDevice.h"
+#include "../Graphics/PostProcess.h"
+
+// PostProcessManager on a WARP device. Built on Windows only, with the
+// Direct3D frontend.
+
+namespace
+{
+    const int WIDTH = 320;
+    const int HEIGHT = 180;
+
+    // Scene input and back buffer stand-in for Process
+    struct FrameTargets
+    {
+        ID3D11Texture2D* sceneTexture;
+        ID3D11ShaderResourceView* sceneView;
+        ID3D11Texture2D* outputTexture;
+        ID3D11RenderTargetView* outputView;
+
+        explicit FrameTargets(ID3D11Device* device)
+            : sceneTexture(nullptr)
+            , sceneView(nullptr)
+            , outputTexture(nullptr)
+            , outputView(nullptr)
+        {
+            D3D11_TEXTURE2D_DESC textureDesc = {};
+            textureDesc.Width = WIDTH;
+            textureDesc.Height = HEIGHT;
+            textureDesc.MipLevels = 1;
+            textureDesc.ArraySize = 1;
+            textureDesc.Format = DXGI_FORMAT_R16G16B16A16_FLOAT;
+            textureDesc.SampleDesc.Count = 1;
+            textureDesc.Usage = D3D11_USAGE_DEFAULT;
+            textureDesc.BindFlags = D3D11_BIND_SHADER_RESOURCE;
+            if (SUCCEEDED(device->CreateTexture2D(&textureDesc, nullptr, &sceneTexture)))
+            {
+                device->CreateShaderResourceView(sceneTexture, nullptr, &sceneView);
+            }
+
+            textureDesc.Format = DXGI_FORMAT_R8G8B8A8_UNORM;
+            textureDesc.BindFlags = D3D11_BIND_RENDER_TARGET;
+            if (SUCCEEDED(device->CreateTexture2D(&textureDesc, nullptr, &outputTexture)))
+            {
+                device->CreateRenderTargetView(outputTexture, nullptr, &outputView);
+            }
+        }
+
+        ~FrameTargets()
+        {
+            if (outputView) outputView->Release();
+            if (outputTexture) outputTexture->Release();
+            if (sceneView) sceneView->Release();
+            if (sceneTexture) sceneTexture->Release();
+        }
+
+        bool IsValid() const { return sceneView && outputView; }
+    };
+
+    // Device objects are created when the graph is (re)built, never by a
+    // frame that runs the compiled graph
+    TestRegistration s_noCreationsPerFrame("PostProcessManager/NoDeviceObjectsPerFrame", [](TestContext& context)
+    {
+        WarpDevice device;
+        TEST_CHECK(context, device.Get() != nullptr);
+        if (!device.Get())
+        {
+            return;
+        }
+
+        FrameTargets targets(device.Get());
+        TEST_CHECK(context, targets.IsValid());
+
+        PostProcessManager manager;
+        TEST_CHECK(context, manager.Initialize(device.Get(), WIDTH, HEIGHT));
+        manager.AddEffect(PostProcessEffect::Bloom);
+        manager.AddEffect(PostProcessEffect::GaussianBlur);
+        manager.AddEffect(PostProcessEffect::ColorCorrection);
+        manager.AddEffect(PostProcessEffect::ToneMapping);
+        manager.AddEffect(PostProcessEffect::Vignette);
+        manager.SetAutoExposure(true);
+
+        // The first frame builds the graph: targets, fused pass, auto-exposure
+        uint64_t beforeBuild = PostProcessManager::GetCreatedDeviceObjectCount();
+        manager.Process(device.GetContext(), targets.sceneView, targets.outputView);
+        uint64_t afterBuild = PostProcessManager::GetCreatedDeviceObjectCount();
+        TEST_CHECK(context, manager.GetRenderGraph().IsCompiled());
+        TEST_CHECK(context, afterBuild > beforeBuild);
+
+        manager.Process(device.GetContext(), targets.sceneView, targets.outputView);
+        manager.Process(device.GetContext(), targets.sceneView, targets.outputView);
+        TEST_CHECK_EQUAL(context, PostProcessManager::GetCreatedDeviceObjectCount(), afterBuild);
+
+        // A chain change rebuilds once; the frames after it create nothing
+        manager.SetEffectEnabled(PostProcessEffect::Vignette, false);
+        manager.Process(device.GetContext(), targets.sceneView, targets.outputView);
+        uint64_t afterRebuild = PostProcessManager::GetCreatedDeviceObjectCount();
+        manager.Process(device.GetContext(), targets.sceneView, targets.outputView);
+        manager.Process(device.GetContext(), targets.sceneView, targets.outputView);
+        TEST_CHECK_EQUAL(context, PostProcessManager::GetCreatedDeviceObjectCount(), afterRebuild);
+
+        manager.Shutdown();
+    });
+}
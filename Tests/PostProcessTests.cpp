@@ -0,0 +1,346 @@
+#include "Test.h"
+#include "../Graphics/PostProcessFusion.h"
+#include "../Graphics/AutoExposure.h"
+#include "../Graphics/PostProcessKernels.h"
+#include <algorithm>
+#include <cmath>
+
+// CPU references of the post-process passes and their kernels
+
+namespace
+{
+    const std::vector<PostProcessEffect> PER_PIXEL_EFFECTS =
+    {
+        PostProcessEffect::ColorCorrection, PostProcessEffect::Sepia, PostProcessEffect::Grayscale,
+        PostProcessEffect::ToneMapping, PostProcessEffect::Vignette
+    };
+
+    // HDR test frame: a gradient up to 4 with a few bright spots up to 40
+    PostProcessImage CreateImage(int width, int height)
+    {
+        PostProcessImage image(width, height);
+        for (int y = 0; y < height; ++y)
+        {
+            for (int x = 0; x < width; ++x)
+            {
+                float u = (x + 0.5f) / width;
+                float v = (y + 0.5f) / height;
+                XMFLOAT4 color(4.0f * u * v, 2.0f * u, 1.0f - v, 1.0f);
+                if ((x * 7 + y * 13) % 29 == 0)
+                {
+                    color.x *= 10.0f;
+                    color.y *= 10.0f;
+                    color.z *= 10.0f;
+                }
+                image.At(x, y) = color;
+            }
+        }
+        return image;
+    }
+
+    PostProcessParams CreatePerPixelParams()
+    {
+        PostProcessParams params;
+        params.intensity = 0.5f;
+        params.contrast = 1.1f;
+        params.saturation = 0.8f;
+        params.colorTint = XMFLOAT3(1.0f, 0.95f, 0.9f);
+        params.exposure = 1.5f;
+        return params;
+    }
+
+    float GetMaxDifference(const PostProcessImage& a, const PostProcessImage& b)
+    {
+        float difference = 0.0f;
+        for (size_t i = 0; i < a.pixels.size(); ++i)
+        {
+            difference = std::max(difference, std::fabs(a.pixels[i].x - b.pixels[i].x));
+            difference = std::max(difference, std::fabs(a.pixels[i].y - b.pixels[i].y));
+            difference = std::max(difference, std::fabs(a.pixels[i].z - b.pixels[i].z));
+        }
+        return difference;
+    }
+
+    size_t CountOccurrences(const std::string& text, const std::string& pattern)
+    {
+        size_t count = 0;
+        for (size_t position = text.find(pattern); position != std::string::npos;
+             position = text.find(pattern, position + pattern.size()))
+        {
+            count++;
+        }
+        return count;
+    }
+
+    // Every subset of the per-pixel effects, in chain order and reversed, as
+    // one fused pass and as one pass per effect, with and without auto-exposure
+    TestRegistration s_fusedMatchesSeparate("PostProcessFusion/FusedMatchesSeparatePasses", [](TestContext& context)
+    {
+        PostProcessImage source = CreateImage(64, 36);
+        PostProcessParams params = CreatePerPixelParams();
+        const float adaptedLuminance = 0.6f;
+
+        int combinations = 0;
+        int mismatches = 0;
+        for (unsigned mask = 1; mask < (1u << PER_PIXEL_EFFECTS.size()); ++mask)
+        {
+            std::vector<PostProcessEffect> effects;
+            for (size_t i = 0; i < PER_PIXEL_EFFECTS.size(); ++i)
+            {
+                if (mask & (1u << i))
+                {
+                    effects.push_back(PER_PIXEL_EFFECTS[i]);
+                }
+            }
+
+            std::vector<PostProcessEffect> reversed(effects.rbegin(), effects.rend());
+            for (const std::vector<PostProcessEffect>& order : { effects, reversed })
+            {
+                for (bool autoExposure : { false, true })
+                {
+                    PostProcessImage fused(source.width, source.height);
+                    PostProcessImage separate = source;
+                    PostProcessImage next(source.width, source.height);
+
+                    if (autoExposure)
+                    {
+                        PostProcessFusion::ApplyReference(source, fused, order, params, adaptedLuminance);
+                        for (PostProcessEffect effect : order)
+                        {
+                            PostProcessFusion::ApplyReference(separate, next, { effect }, params, adaptedLuminance);
+                            std::swap(separate, next);
+                        }
+                    }
+                    else
+                    {
+                        PostProcessFusion::ApplyReference(source, fused, order, params);
+                        for (PostProcessEffect effect : order)
+                        {
+                            PostProcessFusion::ApplyReference(separate, next, { effect }, params);
+                            std::swap(separate, next);
+                        }
+                    }
+
+                    combinations++;
+                    if (GetMaxDifference(fused, separate) != 0.0f)
+                    {
+                        mismatches++;
+                        context.Fail("Fused " + PostProcessFusion::GetFusionName(order) +
+                                     (autoExposure ? " (auto-exposure)" : "") + " differs from separate passes",
+                                     __FILE__, __LINE__);
+                    }
+
+                    // The generated shader calls each effect once, in order
+                    std::string shader = PostProcessFusion::GenerateShader(order, autoExposure);
+                    size_t lastCall = 0;
+                    for (PostProcessEffect effect : order)
+                    {
+                        std::string call = std::string("color = Apply") + PostProcessChain::GetEffectName(effect) + "(";
+                        size_t position = shader.find(call);
+                        TEST_CHECK(context, position != std::string::npos && position >= lastCall);
+                        TEST_CHECK_EQUAL(context, CountOccurrences(shader, call), 1u);
+                        lastCall = position;
+                    }
+                    TEST_CHECK_EQUAL(context, shader.find("secondTexture.Load") != std::string::npos, autoExposure);
+                }
+            }
+        }
+
+        TEST_CHECK_EQUAL(context, combinations, 31 * 2 * 2);
+        TEST_CHECK_EQUAL(context, mismatches, 0);
+    });
+
+    // The auto-exposure path scales by exposure * exposureKey / max(luminance, 0.0001),
+    // the GetExposure of the generated shader
+    TestRegistration s_autoExposureToneMapping("PostProcessFusion/AutoExposureToneMapping", [](TestContext& context)
+    {
+        PostProcessParams params = CreatePerPixelParams();
+        const XMFLOAT4 color(0.8f, 0.3f, 2.5f, 1.0f);
+        const float luminances[] = { 0.0f, 0.00005f, 0.05f, 0.18f, 1.0f, 20.0f };
+
+        for (float luminance : luminances)
+        {
+            PostProcessParams manual = params;
+            manual.exposure = params.exposure * params.exposureKey / std::max(luminance, 0.0001f);
+
+            XMFLOAT4 expected = PostProcessFusion::ApplyEffect(PostProcessEffect::ToneMapping, color, 0.5f, 0.5f, manual);
+            XMFLOAT4 actual = PostProcessFusion::ApplyEffect(PostProcessEffect::ToneMapping, color, 0.5f, 0.5f,
+                                                             params, luminance);
+            TEST_CHECK_EQUAL(context, actual.x, expected.x);
+            TEST_CHECK_EQUAL(context, actual.y, expected.y);
+            TEST_CHECK_EQUAL(context, actual.z, expected.z);
+            TEST_CHECK_EQUAL(context, actual.w, color.w);
+        }
+
+        // An adapted luminance at the key leaves the manual exposure as is;
+        // a brighter scene is exposed down
+        XMFLOAT4 atKey = PostProcessFusion::ApplyEffect(PostProcessEffect::ToneMapping, color, 0.5f, 0.5f,
+                                                        params, params.exposureKey);
+        XMFLOAT4 unadapted = PostProcessFusion::ApplyEffect(PostProcessEffect::ToneMapping, color, 0.5f, 0.5f, params);
+        XMFLOAT4 bright = PostProcessFusion::ApplyEffect(PostProcessEffect::ToneMapping, color, 0.5f, 0.5f, params, 2.0f);
+        TEST_CHECK_NEAR(context, atKey.x, unadapted.x, 1e-6);
+        TEST_CHECK_NEAR(context, atKey.z, unadapted.z, 1e-6);
+        TEST_CHECK(context, bright.x < atKey.x && bright.z < atKey.z);
+
+        // Effects without tone mapping ignore the luminance
+        XMFLOAT4 sepia = PostProcessFusion::ApplyEffect(PostProcessEffect::Sepia, color, 0.5f, 0.5f, params);
+        XMFLOAT4 sepiaAuto = PostProcessFusion::ApplyEffect(PostProcessEffect::Sepia, color, 0.5f, 0.5f, params, 2.0f);
+        TEST_CHECK_EQUAL(context, sepiaAuto.x, sepia.x);
+    });
+
+    // Merged taps sample between texel pairs; with the step of one texel the
+    // bilinear fetches reproduce the discrete kernel, edges included, since
+    // both clamp to the border texel
+    TestRegistration s_mergedTapsMatchDiscrete("PostProcessKernels/MergedTapsMatchDiscrete", [](TestContext& context)
+    {
+        PostProcessImage source = CreateImage(67, 41);
+        const float sigmas[] = { 0.3f, 0.75f, 1.0f, 2.0f, 3.5f, 6.0f, 8.0f, 20.0f };
+
+        for (float sigma : sigmas)
+        {
+            int radius = PostProcessKernels::GetBlurRadius(sigma);
+            GaussianKernel kernel = PostProcessKernels::ComputeGaussianKernel(sigma, radius);
+            LinearGaussianKernel linear = PostProcessKernels::ComputeLinearKernel(kernel);
+
+            // Normalized, and half the taps (plus the center) of the discrete kernel
+            float discreteTotal = kernel.weights[0];
+            for (size_t i = 1; i < kernel.weights.size(); ++i)
+            {
+                discreteTotal += 2.0f * kernel.weights[i];
+            }
+            float linearTotal = linear.weights[0];
+            for (size_t i = 1; i < linear.weights.size(); ++i)
+            {
+                linearTotal += 2.0f * linear.weights[i];
+            }
+            TEST_CHECK_NEAR(context, discreteTotal, 1.0, 1e-5);
+            TEST_CHECK_NEAR(context, linearTotal, 1.0, 1e-5);
+            TEST_CHECK_EQUAL(context, static_cast<int>(linear.offsets.size()), 1 + (radius + 1) / 2);
+            TEST_CHECK(context, radius <= MAX_BLUR_RADIUS && static_cast<int>(linear.offsets.size()) <= MAX_BLUR_TAPS);
+
+            for (bool horizontal : { true, false })
+            {
+                PostProcessImage discrete(source.width, source.height);
+                PostProcessImage merged(source.width, source.height);
+                PostProcessKernels::BlurPassDiscrete(source, discrete, kernel, horizontal);
+                PostProcessKernels::BlurPass(source, merged, linear,
+                                             horizontal ? 1.0f / source.width : 0.0f,
+                                             horizontal ? 0.0f : 1.0f / source.height);
+
+                // Float rounding of the bilinear weights only: relative to
+                // the source's peak of 40
+                float difference = GetMaxDifference(merged, discrete);
+                if (difference > 40.0f * 1e-5f)
+                {
+                    context.Fail("Merged taps differ from the discrete kernel by " + std::to_string(difference) +
+                                 " at sigma " + std::to_string(sigma) + (horizontal ? " (horizontal)" : " (vertical)"),
+                                 __FILE__, __LINE__);
+                }
+            }
+        }
+    });
+
+    // Downsample and tent weights sum to 1, so a flat image above the
+    // threshold comes back from each pyramid level unchanged and every
+    // upsample adds it once more; below the threshold nothing is added
+    TestRegistration s_bloomPyramid("PostProcessKernels/BloomPyramid", [](TestContext& context)
+    {
+        PostProcessParams params;
+        params.bloomThreshold = 1.0f;
+        params.bloomIntensity = 0.5f;
+
+        const int sizes[][2] = { { 160, 90 }, { 33, 17 }, { 16, 16 }, { 1, 1 } };
+        for (const auto& size : sizes)
+        {
+            int mipCount = PostProcessKernels::GetBloomMipCount(size[0], size[1]);
+
+            for (float level : { 0.5f, 2.0f })
+            {
+                PostProcessImage source(size[0], size[1]);
+                for (XMFLOAT4& color : source.pixels)
+                {
+                    color = XMFLOAT4(level, level, level, 1.0f);
+                }
+
+                PostProcessImage destination(size[0], size[1]);
+                PostProcessKernels::Bloom(source, destination, params);
+
+                float expected = level > params.bloomThreshold
+                    ? level + params.bloomIntensity * static_cast<float>(mipCount) * level
+                    : level;
+                float worst = 0.0f;
+                for (const XMFLOAT4& color : destination.pixels)
+                {
+                    worst = std::max(worst, std::fabs(color.x - expected));
+                    worst = std::max(worst, std::fabs(color.w - 1.0f));
+                }
+                TEST_CHECK(context, worst < 1e-4f);
+            }
+        }
+
+        // A bright spot in the middle spreads into a halo that only adds
+        // light, falls off with distance and mirrors like the image does
+        PostProcessImage source(96, 96);
+        for (XMFLOAT4& color : source.pixels)
+        {
+            color = XMFLOAT4(0.1f, 0.1f, 0.1f, 1.0f);
+        }
+        for (int y = 47; y <= 48; ++y)
+        {
+            for (int x = 47; x <= 48; ++x)
+            {
+                source.At(x, y) = XMFLOAT4(100.0f, 100.0f, 100.0f, 1.0f);
+            }
+        }
+
+        PostProcessImage destination(96, 96);
+        PostProcessKernels::Bloom(source, destination, params);
+
+        bool onlyAdds = true;
+        for (size_t i = 0; i < source.pixels.size(); ++i)
+        {
+            onlyAdds = onlyAdds && destination.pixels[i].x >= source.pixels[i].x;
+        }
+        TEST_CHECK(context, onlyAdds);
+
+        float near = destination.At(52, 48).x - source.At(52, 48).x;
+        float far = destination.At(64, 48).x - source.At(64, 48).x;
+        TEST_CHECK(context, near > far && far > 0.0f);
+        TEST_CHECK_NEAR(context, destination.At(95 - 52, 95 - 48).x, destination.At(52, 48).x, 1e-4 * near);
+    });
+
+    // Level 1 is half size; each further level halves again while the
+    // smaller side stays at least MIN_BLOOM_MIP_SIZE, up to MAX_BLOOM_MIPS.
+    // Odd sizes round up, like the render graph's pyramid
+    TestRegistration s_bloomMipCount("PostProcessKernels/BloomMipCount", [](TestContext& context)
+    {
+        TEST_CHECK_EQUAL(context, PostProcessKernels::GetBloomMipCount(1, 1), 1);
+        TEST_CHECK_EQUAL(context, PostProcessKernels::GetBloomMipCount(16, 16), 1);    // 8 -> 4
+        TEST_CHECK_EQUAL(context, PostProcessKernels::GetBloomMipCount(31, 31), 2);    // 16 -> 8
+        TEST_CHECK_EQUAL(context, PostProcessKernels::GetBloomMipCount(32, 32), 2);
+        TEST_CHECK_EQUAL(context, PostProcessKernels::GetBloomMipCount(29, 4096), 2);  // 15 -> 8
+        TEST_CHECK_EQUAL(context, PostProcessKernels::GetBloomMipCount(4096, 8), 1);
+        TEST_CHECK_EQUAL(context, PostProcessKernels::GetBloomMipCount(8192, 64), 3);  // 32 -> 16 -> 8
+        TEST_CHECK_EQUAL(context, PostProcessKernels::GetBloomMipCount(1920, 1080), MAX_BLOOM_MIPS);
+        TEST_CHECK_EQUAL(context, PostProcessKernels::GetBloomMipCount(16384, 16384), MAX_BLOOM_MIPS);
+
+        // Every size up to 600: the smallest level is at least the minimum
+        // unless there is only one, and one more would fall under it
+        int mismatches = 0;
+        for (int size = 1; size <= 600; ++size)
+        {
+            int count = PostProcessKernels::GetBloomMipCount(size, size + 7);
+            int smallest = (size + 1) / 2;
+            for (int level = 1; level < count; ++level)
+            {
+                smallest = (smallest + 1) / 2;
+            }
+
+            bool valid = count >= 1 && count <= MAX_BLOOM_MIPS;
+            valid = valid && (count == 1 || smallest >= MIN_BLOOM_MIP_SIZE);
+            valid = valid && (count == MAX_BLOOM_MIPS || (smallest + 1) / 2 < MIN_BLOOM_MIP_SIZE);
+            mismatches += valid ? 0 : 1;
+        }
+        TEST_CHECK_EQUAL(context, mismatches, 0);
+    });
+}
@@ -0,0 +1,290 @@
+#include "Test.h"
+#include "../Graphics/PostProcessChain.h"
+
+// Graph compiler: culling, validation, scheduling and transient aliasing
+
+namespace
+{
+    const RenderGraphTextureDesc FULL_DESC(1920, 1080, RenderGraphFormat::RGBA8);
+    const RenderGraphTextureDesc HALF_DESC(960, 540, RenderGraphFormat::RGBA8);
+
+    // Scene -> a -> b -> c -> Output, one pass per arrow; transient a and c
+    // do not overlap (a dies at position 1, c is born at 2) while b overlaps
+    // both
+    struct LinearGraph
+    {
+        RenderGraph graph;
+        RenderGraphResource scene;
+        RenderGraphResource output;
+        RenderGraphResource transients[3];
+
+        explicit LinearGraph(const RenderGraphTextureDesc& lastDesc)
+        {
+            scene = graph.ImportTexture("Scene", FULL_DESC);
+            output = graph.ImportTexture("Output", FULL_DESC);
+            graph.MarkOutput(output);
+
+            transients[0] = graph.CreateTexture("A", FULL_DESC);
+            transients[1] = graph.CreateTexture("B", FULL_DESC);
+            transients[2] = graph.CreateTexture("C", lastDesc);
+
+            RenderGraphResource inputs[4] = { scene, transients[0], transients[1], transients[2] };
+            RenderGraphResource outputs[4] = { transients[0], transients[1], transients[2], output };
+            for (int i = 0; i < 4; ++i)
+            {
+                RenderGraphPass pass = graph.AddPass("Pass " + std::to_string(i));
+                graph.Read(pass, inputs[i]);
+                graph.Write(pass, outputs[i]);
+            }
+        }
+    };
+
+    TestRegistration s_cullsUnreadPasses("RenderGraph/CullsUnreadPasses", [](TestContext& context)
+    {
+        RenderGraph graph;
+        RenderGraphResource scene = graph.ImportTexture("Scene", FULL_DESC);
+        RenderGraphResource output = graph.ImportTexture("Output", FULL_DESC);
+        RenderGraphResource unused = graph.CreateTexture("Unused", FULL_DESC);
+        graph.MarkOutput(output);
+
+        int executed[2] = { 0, 0 };
+        RenderGraphPass kept = graph.AddPass("Kept", [&]() { executed[0]++; });
+        graph.Read(kept, scene);
+        graph.Write(kept, output);
+
+        RenderGraphPass dead = graph.AddPass("Dead", [&]() { executed[1]++; });
+        graph.Read(dead, scene);
+        graph.Write(dead, unused);
+
+        TEST_CHECK(context, graph.Compile());
+        TEST_CHECK(context, !graph.IsPassCulled(kept));
+        TEST_CHECK(context, graph.IsPassCulled(dead));
+        TEST_CHECK_EQUAL(context, graph.GetSchedule().size(), 1u);
+        TEST_CHECK_EQUAL(context, graph.GetStats().culledPassCount, 1);
+
+        // The culled pass's texture is never allocated
+        TEST_CHECK_EQUAL(context, graph.GetPhysicalIndex(unused), -1);
+        TEST_CHECK_EQUAL(context, graph.GetStats().physicalCount, 0);
+
+        graph.Execute();
+        TEST_CHECK_EQUAL(context, executed[0], 1);
+        TEST_CHECK_EQUAL(context, executed[1], 0);
+    });
+
+    TestRegistration s_culledChain("RenderGraph/CullsChainsNotReachingOutput", [](TestContext& context)
+    {
+        // Producer feeds only a culled consumer, so both go
+        RenderGraph graph;
+        RenderGraphResource scene = graph.ImportTexture("Scene", FULL_DESC);
+        RenderGraphResource output = graph.ImportTexture("Output", FULL_DESC);
+        RenderGraphResource first = graph.CreateTexture("First", FULL_DESC);
+        RenderGraphResource second = graph.CreateTexture("Second", FULL_DESC);
+        graph.MarkOutput(output);
+
+        RenderGraphPass producer = graph.AddPass("Producer");
+        graph.Read(producer, scene);
+        graph.Write(producer, first);
+
+        RenderGraphPass consumer = graph.AddPass("Consumer");
+        graph.Read(consumer, first);
+        graph.Write(consumer, second);
+
+        RenderGraphPass copy = graph.AddPass("Copy");
+        graph.Read(copy, scene);
+        graph.Write(copy, output);
+
+        TEST_CHECK(context, graph.Compile());
+        TEST_CHECK(context, graph.IsPassCulled(producer));
+        TEST_CHECK(context, graph.IsPassCulled(consumer));
+        TEST_CHECK_EQUAL(context, graph.GetSchedule().size(), 1u);
+        TEST_CHECK_EQUAL(context, graph.GetSchedule()[0], copy);
+    });
+
+    TestRegistration s_detectsCycle("RenderGraph/DetectsCycle", [](TestContext& context)
+    {
+        RenderGraph graph;
+        RenderGraphResource output = graph.ImportTexture("Output", FULL_DESC);
+        RenderGraphResource x = graph.CreateTexture("X", FULL_DESC);
+        RenderGraphResource y = graph.CreateTexture("Y", FULL_DESC);
+        graph.MarkOutput(output);
+
+        // A reads X and writes Y, B reads Y and writes X
+        RenderGraphPass a = graph.AddPass("A");
+        graph.Read(a, x);
+        graph.Write(a, y);
+
+        RenderGraphPass b = graph.AddPass("B");
+        graph.Read(b, y);
+        graph.Write(b, x);
+
+        RenderGraphPass present = graph.AddPass("Present");
+        graph.Read(present, y);
+        graph.Write(present, output);
+
+        TEST_CHECK(context, !graph.Compile());
+        TEST_CHECK(context, !graph.IsCompiled());
+        TEST_CHECK(context, graph.GetSchedule().empty());
+    });
+
+    TestRegistration s_rejectsSecondWriter("RenderGraph/RejectsSecondWriter", [](TestContext& context)
+    {
+        RenderGraph graph;
+        RenderGraphResource scene = graph.ImportTexture("Scene", FULL_DESC);
+        RenderGraphResource output = graph.ImportTexture("Output", FULL_DESC);
+        graph.MarkOutput(output);
+
+        RenderGraphPass first = graph.AddPass("First");
+        graph.Read(first, scene);
+        graph.Write(first, output);
+
+        RenderGraphPass second = graph.AddPass("Second");
+        graph.Read(second, scene);
+        graph.Write(second, output);
+
+        TEST_CHECK(context, !graph.Compile());
+
+        // Clear forgets the error
+        graph.Clear();
+        scene = graph.ImportTexture("Scene", FULL_DESC);
+        output = graph.ImportTexture("Output", FULL_DESC);
+        graph.MarkOutput(output);
+        first = graph.AddPass("First");
+        graph.Read(first, scene);
+        graph.Write(first, output);
+        TEST_CHECK(context, graph.Compile());
+    });
+
+    TestRegistration s_rejectsReadOfUnwritten("RenderGraph/RejectsReadOfUnwrittenTransient", [](TestContext& context)
+    {
+        RenderGraph graph;
+        RenderGraphResource output = graph.ImportTexture("Output", FULL_DESC);
+        RenderGraphResource never = graph.CreateTexture("Never Written", FULL_DESC);
+        graph.MarkOutput(output);
+
+        RenderGraphPass pass = graph.AddPass("Pass");
+        graph.Read(pass, never);
+        graph.Write(pass, output);
+
+        TEST_CHECK(context, !graph.Compile());
+    });
+
+    TestRegistration s_aliasesDisjointLifetimes("RenderGraph/AliasesDisjointIdenticalTextures", [](TestContext& context)
+    {
+        LinearGraph linear(FULL_DESC);
+        TEST_CHECK(context, linear.graph.Compile());
+
+        const RenderGraph& graph = linear.graph;
+        int a = graph.GetPhysicalIndex(linear.transients[0]);
+        int b = graph.GetPhysicalIndex(linear.transients[1]);
+        int c = graph.GetPhysicalIndex(linear.transients[2]);
+
+        // a ends at position 1 where b starts: not strictly before, so no
+        // sharing; a ends before c starts at 2, so they share
+        TEST_CHECK(context, a >= 0 && b >= 0 && c >= 0);
+        TEST_CHECK(context, a != b);
+        TEST_CHECK(context, b != c);
+        TEST_CHECK_EQUAL(context, a, c);
+
+        TEST_CHECK_EQUAL(context, graph.GetStats().transientCount, 3);
+        TEST_CHECK_EQUAL(context, graph.GetStats().physicalCount, 2);
+        TEST_CHECK_EQUAL(context, graph.GetStats().peakTransientBytes, 2 * FULL_DESC.GetBytes());
+        TEST_CHECK_EQUAL(context, graph.GetStats().transientBytes, 3 * FULL_DESC.GetBytes());
+
+        // Imported textures are never aliased
+        TEST_CHECK_EQUAL(context, graph.GetPhysicalIndex(linear.scene), -1);
+        TEST_CHECK_EQUAL(context, graph.GetPhysicalIndex(linear.output), -1);
+    });
+
+    TestRegistration s_noAliasAcrossDescs("RenderGraph/DoesNotAliasDifferentDescs", [](TestContext& context)
+    {
+        // Same lifetimes as above, but c differs from a in size, then in format
+        RenderGraphTextureDesc otherFormat(FULL_DESC.width, FULL_DESC.height, RenderGraphFormat::RGBA16F);
+        const RenderGraphTextureDesc lastDescs[2] = { HALF_DESC, otherFormat };
+
+        for (const RenderGraphTextureDesc& lastDesc : lastDescs)
+        {
+            LinearGraph linear(lastDesc);
+            TEST_CHECK(context, linear.graph.Compile());
+
+            const RenderGraph& graph = linear.graph;
+            TEST_CHECK(context, graph.GetPhysicalIndex(linear.transients[0]) != graph.GetPhysicalIndex(linear.transients[2]));
+            TEST_CHECK_EQUAL(context, graph.GetStats().physicalCount, 3);
+            TEST_CHECK_EQUAL(context, graph.GetStats().peakTransientBytes,
+                             2 * FULL_DESC.GetBytes() + lastDesc.GetBytes());
+        }
+    });
+
+    TestRegistration s_transientOutputNotAliased("RenderGraph/DoesNotAliasTransientOutput", [](TestContext& context)
+    {
+        // A transient output is last touched by its writer, but read after
+        // the graph runs; a later transient of the same description must not
+        // take its texture
+        RenderGraph graph;
+        RenderGraphResource scene = graph.ImportTexture("Scene", FULL_DESC);
+        RenderGraphResource output = graph.ImportTexture("Output", FULL_DESC);
+        RenderGraphResource luminance = graph.CreateTexture("Luminance", FULL_DESC);
+        RenderGraphResource later = graph.CreateTexture("Later", FULL_DESC);
+        graph.MarkOutput(luminance);
+        graph.MarkOutput(output);
+
+        RenderGraphPass measure = graph.AddPass("Measure");
+        graph.Read(measure, scene);
+        graph.Write(measure, luminance);
+
+        RenderGraphPass produce = graph.AddPass("Produce");
+        graph.Read(produce, scene);
+        graph.Write(produce, later);
+
+        RenderGraphPass present = graph.AddPass("Present");
+        graph.Read(present, later);
+        graph.Write(present, output);
+
+        TEST_CHECK(context, graph.Compile());
+        TEST_CHECK_EQUAL(context, graph.GetSchedule().size(), 3u);
+        TEST_CHECK(context, !graph.IsPassCulled(measure));
+        TEST_CHECK(context, graph.GetSchedule()[0] == measure);
+
+        int luminanceIndex = graph.GetPhysicalIndex(luminance);
+        int laterIndex = graph.GetPhysicalIndex(later);
+        TEST_CHECK(context, luminanceIndex >= 0 && laterIndex >= 0);
+        TEST_CHECK(context, luminanceIndex != laterIndex);
+        TEST_CHECK_EQUAL(context, graph.GetStats().physicalCount, 2);
+        TEST_CHECK_EQUAL(context, graph.GetStats().peakLiveBytes, 2 * FULL_DESC.GetBytes());
+    });
+
+    TestRegistration s_defaultChainMemory("RenderGraph/DefaultChainPeakTransientBytes", [](TestContext& context)
+    {
+        // PostProcessManager's default chain at 1080p with R11G11B10F
+        // intermediates (4 bytes per pixel)
+        RenderGraphTextureDesc desc(1920, 1080, RenderGraphFormat::R11G11B10F);
+
+        RenderGraph graph;
+        RenderGraphResource scene = graph.ImportTexture("Scene", desc);
+        RenderGraphResource output = graph.ImportTexture("Output", RenderGraphTextureDesc(1920, 1080, RenderGraphFormat::RGBA8));
+        graph.MarkOutput(output);
+
+        PostProcessChain::Build(graph, { PostProcessEffect::Bloom, PostProcessEffect::ToneMapping, PostProcessEffect::Vignette },
+                                scene, output, desc);
+        TEST_CHECK(context, graph.Compile());
+
+        // Bloom writes a full-resolution target read by the fused tone
+        // mapping and vignette pass. Its pyramid has six levels; each level
+        // but the smallest also has an upsample target, and none of them can
+        // alias: every size appears at most twice and the two are live
+        // together during that level's upsample.
+        const uint64_t mipPixels[6] = { 960 * 540, 480 * 270, 240 * 135, 120 * 68, 60 * 34, 30 * 17 };
+        uint64_t expectedPixels = 1920 * 1080;
+        for (int level = 0; level < 6; ++level)
+        {
+            expectedPixels += mipPixels[level] * (level < 5 ? 2 : 1);
+        }
+
+        const RenderGraphStats& stats = graph.GetStats();
+        TEST_CHECK_EQUAL(context, stats.passCount, 13);
+        TEST_CHECK_EQUAL(context, stats.culledPassCount, 0);
+        TEST_CHECK_EQUAL(context, stats.transientCount, 12);
+        TEST_CHECK_EQUAL(context, stats.physicalCount, 12);
+        TEST_CHECK_EQUAL(context, stats.peakTransientBytes, expectedPixels * 4);
+        TEST_CHECK_EQUAL(context, stats.peakTransientBytes, 13821240u);
+    });
+}
@@ -0,0 +1,125 @@
+#include "Test.h"
+#include "WarpDevice.h"
+#include "../Engine/Memory.h"
+#include "../Resources/Mesh.h"
+#include "../Resources/Texture.h"
+#include "../Benchmarks/Datasets.h"
+
+// Resource accounting of meshes and textures created on a WARP device: what
+// they report while alive, and nothing once released. Built on Windows only,
+// with the Direct3D frontend. Checks are relative to the state before the
+// test, as in MemoryTests.
+
+namespace
+{
+    const int GRID_SIZE = 32;
+    const int TEXTURE_SIZE = 64;
+
+    TestRegistration s_meshRoundTrip("ResourceMemory/MeshRoundTrip", [](TestContext& context)
+    {
+        WarpDevice device;
+        TEST_CHECK(context, device.Get() != nullptr);
+        if (!device.Get())
+        {
+            return;
+        }
+
+        std::vector<Vertex> vertices;
+        std::vector<unsigned int> indices;
+        Datasets::CreateGridMesh(GRID_SIZE, false, vertices, indices);
+        uint64_t bufferBytes = vertices.size() * sizeof(Vertex) + indices.size() * sizeof(unsigned int);
+
+        MemoryCategoryStats cpuBefore = Memory::GetCategoryStats(MemoryCategory::MeshCpu);
+        MemoryCategoryStats gpuBefore = Memory::GetCategoryStats(MemoryCategory::MeshGpu);
+
+        Mesh mesh;
+        mesh.SetAssetName("tests/grid.mesh");
+        TEST_CHECK(context, mesh.InitializeFromVertices(device.Get(), vertices, indices));
+
+        // GPU bytes are the two buffers; CPU bytes the copies the mesh keeps
+        MemoryCategoryStats gpu = Memory::GetCategoryStats(MemoryCategory::MeshGpu);
+        MemoryCategoryStats cpu = Memory::GetCategoryStats(MemoryCategory::MeshCpu);
+        TEST_CHECK_EQUAL(context, static_cast<uint64_t>(mesh.GetGpuMemoryBytes()), bufferBytes);
+        TEST_CHECK_EQUAL(context, gpu.bytes - gpuBefore.bytes, bufferBytes);
+        TEST_CHECK_EQUAL(context, gpu.resourceCount - gpuBefore.resourceCount, 1u);
+        TEST_CHECK(context, mesh.GetCpuMemoryBytes() >= bufferBytes);
+        TEST_CHECK_EQUAL(context, cpu.bytes - cpuBefore.bytes, static_cast<uint64_t>(mesh.GetCpuMemoryBytes()));
+
+        // Discarding the CPU copy leaves only the GPU buffers
+        mesh.SetResidency(MeshResidency::DiscardAfterUpload);
+        TEST_CHECK_EQUAL(context, Memory::GetCategoryStats(MemoryCategory::MeshCpu).bytes, cpuBefore.bytes);
+        TEST_CHECK_EQUAL(context, Memory::GetCategoryStats(MemoryCategory::MeshGpu).bytes - gpuBefore.bytes, bufferBytes);
+
+        mesh.Shutdown();
+        TEST_CHECK_EQUAL(context, Memory::GetCategoryStats(MemoryCategory::MeshCpu).bytes, cpuBefore.bytes);
+        TEST_CHECK_EQUAL(context, Memory::GetCategoryStats(MemoryCategory::MeshGpu).bytes, gpuBefore.bytes);
+        TEST_CHECK_EQUAL(context, Memory::GetCategoryStats(MemoryCategory::MeshCpu).resourceCount, cpuBefore.resourceCount);
+        TEST_CHECK_EQUAL(context, Memory::GetCategoryStats(MemoryCategory::MeshGpu).resourceCount, gpuBefore.resourceCount);
+
+        // The destructor releases a mesh that was never shut down
+        {
+            Mesh scoped;
+            TEST_CHECK(context, scoped.InitializeFromVertices(device.Get(), vertices, indices));
+            TEST_CHECK(context, Memory::GetCategoryStats(MemoryCategory::MeshGpu).bytes > gpuBefore.bytes);
+        }
+        TEST_CHECK_EQUAL(context, Memory::GetCategoryStats(MemoryCategory::MeshCpu).bytes, cpuBefore.bytes);
+        TEST_CHECK_EQUAL(context, Memory::GetCategoryStats(MemoryCategory::MeshGpu).bytes, gpuBefore.bytes);
+    });
+
+    TestRegistration s_textureRoundTrip("ResourceMemory/TextureRoundTrip", [](TestContext& context)
+    {
+        WarpDevice device;
+        TEST_CHECK(context, device.Get() != nullptr);
+        if (!device.Get())
+        {
+            return;
+        }
+
+        MemoryCategoryStats texturesBefore = Memory::GetCategoryStats(MemoryCategory::Textures);
+        MemoryCategoryStats targetsBefore = Memory::GetCategoryStats(MemoryCategory::RenderTargets);
+
+        // Asset textures, uncompressed and block-compressed
+        Texture color;
+        Texture compressed;
+        TEST_CHECK(context, color.Create(device.Get(), TEXTURE_SIZE, TEXTURE_SIZE, TextureFormat::R8G8B8A8_UNORM));
+        TEST_CHECK(context, compressed.Create(device.Get(), TEXTURE_SIZE, TEXTURE_SIZE, TextureFormat::BC1_UNORM));
+
+        uint64_t colorBytes = static_cast<uint64_t>(TEXTURE_SIZE) * TEXTURE_SIZE * 4;
+        uint64_t compressedBytes = static_cast<uint64_t>(TEXTURE_SIZE / 4) * (TEXTURE_SIZE / 4) * 8;
+        TEST_CHECK_EQUAL(context, static_cast<uint64_t>(color.GetGpuMemoryBytes()), colorBytes);
+        TEST_CHECK_EQUAL(context, static_cast<uint64_t>(compressed.GetGpuMemoryBytes()), compressedBytes);
+
+        MemoryCategoryStats textures = Memory::GetCategoryStats(MemoryCategory::Textures);
+        TEST_CHECK_EQUAL(context, textures.bytes - texturesBefore.bytes, colorBytes + compressedBytes);
+        TEST_CHECK_EQUAL(context, textures.resourceCount - texturesBefore.resourceCount, 2u);
+
+        // Render targets and depth buffers are accounted apart
+        Texture target;
+        Texture depth;
+        TEST_CHECK(context, target.Create(device.Get(), TEXTURE_SIZE, TEXTURE_SIZE, TextureFormat::R8G8B8A8_UNORM,
+                                          TextureUsage::RenderTarget));
+        TEST_CHECK(context, depth.Create(device.Get(), TEXTURE_SIZE, TEXTURE_SIZE, TextureFormat::R8G8B8A8_UNORM,
+                                         TextureUsage::DepthStencil));
+        MemoryCategoryStats targets = Memory::GetCategoryStats(MemoryCategory::RenderTargets);
+        TEST_CHECK_EQUAL(context, targets.bytes - targetsBefore.bytes, 2 * colorBytes);
+        TEST_CHECK_EQUAL(context, targets.resourceCount - targetsBefore.resourceCount, 2u);
+        TEST_CHECK_EQUAL(context, Memory::GetCategoryStats(MemoryCategory::Textures).bytes - texturesBefore.bytes,
+                         colorBytes + compressedBytes);
+
+        color.Shutdown();
+        target.Shutdown();
+        TEST_CHECK_EQUAL(context, Memory::GetCategoryStats(MemoryCategory::Textures).bytes - texturesBefore.bytes, compressedBytes);
+        TEST_CHECK_EQUAL(context, Memory::GetCategoryStats(MemoryCategory::RenderTargets).bytes - targetsBefore.bytes, colorBytes);
+
+        compressed.Shutdown();
+        depth.Shutdown();
+        TEST_CHECK_EQUAL(context, Memory::GetCategoryStats(MemoryCategory::Textures).bytes, texturesBefore.bytes);
+        TEST_CHECK_EQUAL(context, Memory::GetCategoryStats(MemoryCategory::RenderTargets).bytes, targetsBefore.bytes);
+        TEST_CHECK_EQUAL(context, Memory::GetCategoryStats(MemoryCategory::Textures).resourceCount, texturesBefore.resourceCount);
+        TEST_CHECK_EQUAL(context, Memory::GetCategoryStats(MemoryCategory::RenderTargets).resourceCount, targetsBefore.resourceCount);
+
+        // Shutting down twice releases nothing more
+        color.Shutdown();
+        TEST_CHECK_EQUAL(context, Memory::GetCategoryStats(MemoryCategory::Textures).bytes, texturesBefore.bytes);
+    });
+}
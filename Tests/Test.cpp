@@ -0,0 +1,64 @@
+#include "Test.h"
+#include <cmath>
+
+namespace
+{
+    std::vector<TestDefinition>& GetDefinitions()
+    {
+        // Function-local so registration from any translation unit's statics is safe
+        static std::vector<TestDefinition> definitions;
+        return definitions;
+    }
+}
+
+TestContext::TestContext()
+    : m_checkCount(0)
+{
+}
+
+void TestContext::Check(bool passed, const char* expression, const char* file, int line)
+{
+    if (!passed)
+    {
+        Fail(expression, file, line);
+        return;
+    }
+    m_checkCount++;
+}
+
+void TestContext::CheckNear(double actual, double expected, double tolerance,
+                            const char* expression, const char* file, int line)
+{
+    if (!(std::fabs(actual - expected) <= tolerance))
+    {
+        std::ostringstream values;
+        values << expression << " (" << actual << " vs " << expected << ", tolerance " << tolerance << ")";
+        Fail(values.str(), file, line);
+        return;
+    }
+    m_checkCount++;
+}
+
+void TestContext::Fail(const std::string& message, const char* file, int line)
+{
+    std::ostringstream failure;
+    failure << file << ":" << line << ": " << message;
+    m_failures.push_back(failure.str());
+    m_checkCount++;
+}
+
+namespace TestRegistry
+{
+    void Register(const std::string& name, TestFunction function)
+    {
+        TestDefinition definition;
+        definition.name = name;
+        definition.function = function;
+        GetDefinitions().push_back(definition);
+    }
+
+    const std::vector<TestDefinition>& GetTests()
+    {
+        return GetDefinitions();
+    }
+}
@@ -0,0 +1,77 @@
+#pragma once
+
+#include <string>
+#include <vector>
+#include <sstream>
+#include <functional>
+
+// Small self-contained test harness for engine_core, in the manner of the
+// benchmark harness (Benchmarks/Benchmark.h).
+//
+// Tests register themselves at static initialization; the runner executes
+// the ones matching a filter. A failed check records the expression and its
+// location and the test carries on, so one run reports every failure. The
+// runner exits with 1 if any check failed, which is what ctest looks at.
+
+class TestContext
+{
+public:
+    TestContext();
+
+    void Check(bool passed, const char* expression, const char* file, int line);
+    void CheckNear(double actual, double expected, double tolerance, const char* expression, const char* file, int line);
+
+    template<typename A, typename B>
+    void CheckEqual(const A& actual, const B& expected, const char* expression, const char* file, int line)
+    {
+        bool passed = actual == expected;
+        if (!passed)
+        {
+            std::ostringstream values;
+            values << expression << " (" << actual << " vs " << expected << ")";
+            Fail(values.str(), file, line);
+            return;
+        }
+        m_checkCount++;
+    }
+
+    void Fail(const std::string& message, const char* file, int line);
+
+    int GetCheckCount() const { return m_checkCount; }
+    const std::vector<std::string>& GetFailures() const { return m_failures; }
+
+private:
+    int m_checkCount;
+    std::vector<std::string> m_failures;
+};
+
+#define TEST_CHECK(context, condition) \
+    (context).Check((condition), #condition, __FILE__, __LINE__)
+#define TEST_CHECK_EQUAL(context, actual, expected) \
+    (context).CheckEqual((actual), (expected), #actual " == " #expected, __FILE__, __LINE__)
+#define TEST_CHECK_NEAR(context, actual, expected, tolerance) \
+    (context).CheckNear((actual), (expected), (tolerance), #actual " ~ " #expected, __FILE__, __LINE__)
+
+typedef std::function<void(TestContext& context)> TestFunction;
+
+struct TestDefinition
+{
+    std::string name;
+    TestFunction function;
+};
+
+namespace TestRegistry
+{
+    void Register(const std::string& name, TestFunction function);
+    const std::vector<TestDefinition>& GetTests();
+}
+
+// Registers a test from a namespace-scope static:
+//   static TestRegistration s_cullsUnread("RenderGraph/CullsUnreadPasses", [](TestContext& context) { ... });
+struct TestRegistration
+{
+    TestRegistration(const std::string& name, TestFunction function)
+    {
+        TestRegistry::Register(name, function);
+    }
+};
@@ -0,0 +1,39 @@
+#pragma once
+
+#include <d3d11.h>
+
+// Direct3D 11 device on WARP, the software rasterizer: needs no window or
+// adapter, so the frontend tests run headless. Windows only.
+class WarpDevice
+{
+public:
+    WarpDevice()
+        : m_device(nullptr)
+        , m_context(nullptr)
+    {
+        D3D11CreateDevice(nullptr, D3D_DRIVER_TYPE_WARP, nullptr, 0, nullptr, 0, D3D11_SDK_VERSION,
+                          &m_device, nullptr, &m_context);
+    }
+
+    ~WarpDevice()
+    {
+        if (m_context)
+        {
+            m_context->Release();
+        }
+        if (m_device)
+        {
+            m_device->Release();
+        }
+    }
+
+    ID3D11Device* Get() const { return m_device; }
+    ID3D11DeviceContext* GetContext() const { return m_context; }
+
+private:
+    WarpDevice(const WarpDevice&) = delete;
+    WarpDevice& operator=(const WarpDevice&) = delete;
+
+    ID3D11Device* m_device;
+    ID3D11DeviceContext* m_context;
+};
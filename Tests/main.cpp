@@ -0,0 +1,69 @@
+#include "Test.h"
+#include <iostream>
+#include <string>
+
+// Test runner.
+//
+//   tests [--filter text] [--list]
+//
+// --filter keeps tests whose name contains the text.
+
+int main(int argc, char* argv[])
+{
+    std::string filter;
+    bool listOnly = false;
+
+    for (int i = 1; i < argc; ++i)
+    {
+        std::string argument = argv[i];
+        if (argument == "--filter" && i + 1 < argc)
+            filter = argv[++i];
+        else if (argument == "--list")
+            listOnly = true;
+        else
+        {
+            std::cout << "Usage: tests [--filter text] [--list]" << std::endl;
+            return argument == "--help" ? 0 : 1;
+        }
+    }
+
+    int testCount = 0;
+    int failedCount = 0;
+    for (const TestDefinition& definition : TestRegistry::GetTests())
+    {
+        if (!filter.empty() && definition.name.find(filter) == std::string::npos)
+            continue;
+
+        if (listOnly)
+        {
+            std::cout << definition.name << std::endl;
+            continue;
+        }
+
+        TestContext context;
+        definition.function(context);
+        testCount++;
+
+        if (context.GetFailures().empty())
+        {
+            std::cout << "[  OK  ] " << definition.name << " (" << context.GetCheckCount() << " checks)" << std::endl;
+        }
+        else
+        {
+            failedCount++;
+            std::cout << "[ FAIL ] " << definition.name << std::endl;
+            for (const std::string& failure : context.GetFailures())
+            {
+                std::cout << "         " << failure << std::endl;
+            }
+        }
+    }
+
+    if (listOnly)
+    {
+        return 0;
+    }
+
+    std::cout << testCount - failedCount << "/" << testCount << " tests passed" << std::endl;
+    return failedCount == 0 ? 0 : 1;
+}
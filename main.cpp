@@ -13,6 +13,9 @@ int WINAPI WinMain(HINSTANCE hInstance, HINSTANCE hPrevInstance, PSTR pScmdline,
         return -1;
     }
 
+    // Open in chrome://tracing or ui.perfetto.dev
+    engine.SetProfileTracePath("profile_trace.json");
+
     // Run main loop
     engine.Run();
 